@@ -9,6 +9,8 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/util/string_util.cpp
 	${ROOT_PATH}/src/ds/util/idle_timer.cpp
 	${ROOT_PATH}/src/ds/util/exif.cpp
+	${ROOT_PATH}/src/ds/util/exif_parser.cpp
+	${ROOT_PATH}/src/ds/util/image_probe.cpp
 	${ROOT_PATH}/src/ds/util/bit_mask.cpp
 	${ROOT_PATH}/src/ds/arc/arc_input.cpp
 	${ROOT_PATH}/src/ds/arc/arc.cpp
@@ -42,6 +44,7 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/query/sql_query_result_builder.cpp
 	${ROOT_PATH}/src/ds/query/query_result_builder.cpp
 	${ROOT_PATH}/src/ds/query/sql_database.cpp
+	${ROOT_PATH}/src/ds/query/sql_connection_pool.cpp
 	${ROOT_PATH}/src/ds/query/query_client.cpp			# error: invalid initialization of non-const reference of type ‘std::unique_ptr<ds::WorkRequest>&’ from an rvalue of type ‘std::unique_ptr<ds::WorkRequest>’
 	${ROOT_PATH}/src/ds/query/query_result_editor.cpp
 	${ROOT_PATH}/src/ds/app/event_client.cpp
@@ -85,7 +88,9 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/ui/touch/touch_translator.cpp
 	${ROOT_PATH}/src/ds/ui/touch/touch_mode.cpp
 	${ROOT_PATH}/src/ds/ui/tween/tweenline.cpp
+	${ROOT_PATH}/src/ds/ui/tween/batch_tweener.cpp
 	${ROOT_PATH}/src/ds/ui/tween/sprite_anim.cpp
+	${ROOT_PATH}/src/ds/ui/tween/animation_script.cpp
 	${ROOT_PATH}/src/ds/ui/service/glsl_image_service.cpp
 	${ROOT_PATH}/src/ds/ui/service/pango_font_service.cpp
 	${ROOT_PATH}/src/ds/ui/service/load_image_service.cpp
@@ -130,6 +135,7 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/params/update_params.cpp
 	${ROOT_PATH}/src/ds/debug/computer_info.cpp
 	${ROOT_PATH}/src/ds/debug/debug_defines.cpp
+	${ROOT_PATH}/src/ds/debug/frame_profiler.cpp
 	${ROOT_PATH}/src/ds/debug/logger.cpp
 	${ROOT_PATH}/src/ds/math/math_func.cpp
 	${ROOT_PATH}/src/ds/cfg/cfg_nine_patch.cpp
@@ -137,6 +143,7 @@ list( APPEND DS_CINDER_SRC_FILES
 	${ROOT_PATH}/src/ds/cfg/cfg_text.cpp
 	${ROOT_PATH}/src/ds/data/tuio_object.cpp
 	${ROOT_PATH}/src/ds/data/resource_list.cpp
+	${ROOT_PATH}/src/ds/data/resource_resolver.cpp
 	${ROOT_PATH}/src/ds/data/key_value_store.cpp
 	${ROOT_PATH}/src/ds/data/data_buffer.cpp
 	${ROOT_PATH}/src/ds/data/read_write_buffer.cpp
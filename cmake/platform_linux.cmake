@@ -40,6 +40,13 @@ endif()
 #list( APPEND CINDER_LIBS_DEPENDS ${CINDER_PATH}/lib/linux/x86_64/ogl/${CMAKE_BUILD_TYPE}/libcinder.a )
 #list( APPEND DS_CINDER_LIBS_DEPENDS ${CINDER_LIBRARIES} )
 #list( APPEND DS_CINDER_INCLUDE_SYSTEM_PUBLIC ${CINDER_INCLUDE_DIRS} )
+# Headless builds use Cinder's offscreen GL, which needs no display. osmesa renders in software, so it
+# also runs without a GPU, e.g. on CI. Cinder has to be built with the same CINDER_HEADLESS_GL.
+set( DS_CINDER_HEADLESS_GL "" CACHE STRING "Build headless against Cinder's offscreen GL: egl or osmesa. Empty for a windowed build." )
+if( DS_CINDER_HEADLESS_GL )
+	set( CINDER_HEADLESS_GL "${DS_CINDER_HEADLESS_GL}" CACHE STRING "" FORCE )
+	list( APPEND DS_CINDER_DEFINES "-DDS_CINDER_HEADLESS" )
+endif()
 # pull in cinder's exported configuration
 include( "${CINDER_PATH}/proj/cmake/configure.cmake" )
 if( NOT TARGET cinder )
@@ -23,6 +23,7 @@ if( NOT TARGET essentials )
 		${ESSENTIALS_SRC_PATH}/ds/ui/button/sprite_button.cpp
 		${ESSENTIALS_SRC_PATH}/ds/ui/control/control_slider.cpp
 		${ESSENTIALS_SRC_PATH}/ds/ui/drawing/drawing_canvas.cpp
+		${ESSENTIALS_SRC_PATH}/ds/ui/drawing/stroke_tessellator.cpp
 		${ESSENTIALS_SRC_PATH}/ds/ui/interface_xml/interface_xml_importer.cpp
 		${ESSENTIALS_SRC_PATH}/ds/ui/interface_xml/stylesheet_parser.cpp
 		${ESSENTIALS_SRC_PATH}/ds/ui/layout/smart_layout.cpp
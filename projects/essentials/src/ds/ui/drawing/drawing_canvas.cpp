@@ -24,6 +24,7 @@
 
 #include <cinder/Rand.h>
 
+#include <algorithm>
 #include <thread>
 
 namespace {
@@ -98,6 +99,25 @@ const std::string vertShader =
 "}\n";
 
 std::string shaderNameOpaccy = "opaccy_shader";
+
+// Copies a stamp mesh into a VBO that's kept between frames. The VBO is only recreated when the mesh
+// outgrows it, at double the size so a long stroke doesn't reallocate every frame.
+void uploadStampMesh(const ci::TriMesh& mesh, const bool texCoords, ci::gl::VboMeshRef& vbo) {
+	const uint32_t numVertices = static_cast<uint32_t>(mesh.getNumVertices());
+	const uint32_t numIndices = static_cast<uint32_t>(mesh.getNumIndices());
+	if(!vbo || vbo->getNumVertices() < numVertices || vbo->getNumIndices() < numIndices) {
+		ci::gl::VboMesh::Layout layout;
+		layout.usage(GL_DYNAMIC_DRAW).attrib(ci::geom::POSITION, 2);
+		if(texCoords) layout.attrib(ci::geom::TEX_COORD_0, 2);
+		const uint32_t vertexCapacity = std::max(numVertices, vbo ? vbo->getNumVertices() * 2 : 1024u);
+		const uint32_t indexCapacity = std::max(numIndices, vbo ? vbo->getNumIndices() * 2 : 1536u);
+		vbo = ci::gl::VboMesh::create(vertexCapacity, GL_TRIANGLES, {layout}, indexCapacity, GL_UNSIGNED_INT);
+	}
+
+	vbo->bufferAttrib(ci::geom::POSITION, numVertices * sizeof(ci::vec2), mesh.getPositions<2>());
+	if(texCoords) vbo->bufferAttrib(ci::geom::TEX_COORD_0, numVertices * sizeof(ci::vec2), mesh.getTexCoords0<2>());
+	vbo->bufferIndices(numIndices * sizeof(uint32_t), mesh.getIndices().data());
+}
 }
 
 namespace ds {
@@ -123,14 +143,17 @@ const char			BRUSH_SIZE_ATT			= 84;
 const char			CANVAS_IMAGE_PATH_ATT	= 85;
 const char			CLEAR_CANVAS_ATT		= 86;
 const char			ERASE_MODE_ATT			= 87;
+const char			BRUSH_SPACING_ATT		= 88;
 const DirtyState&	sPointsQueueDirty	 	= newUniqueDirtyState();
 const DirtyState&	sBrushColorDirty		= newUniqueDirtyState();
 const DirtyState&	sBrushSizeDirty			= newUniqueDirtyState();
 const DirtyState&	sCanvasImagePathDirty	= newUniqueDirtyState();
 const DirtyState&	sClearCanvasDirty		= newUniqueDirtyState();
 const DirtyState&	sEraseModeDirty			= newUniqueDirtyState();
+const DirtyState&	sBrushSpacingDirty		= newUniqueDirtyState();
 
-const int			MAX_SERIALIZED_POINTS	= 100;
+const int			MAX_SERIALIZED_POINTS	= 500;
+const int			CIRCLE_BRUSH_SEGMENTS	= 24;
 } // anonymous namespace
 
 void DrawingCanvas::installAsServer(ds::BlobRegistry& registry) {
@@ -152,7 +175,10 @@ DrawingCanvas::DrawingCanvas(ds::ui::SpriteEngine& eng, const std::string& brush
 	, mEraseMode(false)
 	, mCanvasFileLoaderClient(eng)
 	, mBrushImage(nullptr)
+	, mQuadMesh(ci::TriMesh::Format().positions(2).texCoords0(2))
+	, mCircleMesh(ci::TriMesh::Format().positions(2))
 {
+	setNeedsUpdate(true);
 	mBlobType = BLOB_TYPE;
 	setBaseShader(vertShader, opacityFrag, shaderNameOpaccy);
 
@@ -180,9 +206,7 @@ DrawingCanvas::DrawingCanvas(ds::ui::SpriteEngine& eng, const std::string& brush
 		auto prevPoint = globalToLocal(ti.mCurrentGlobalPoint - ti.mDeltaPoint);
 		
 		if(ti.mPhase == ds::ui::TouchInfo::Added){
-			mSerializedPointsQueue.push_back( std::make_pair(ci::vec2(localPoint), ci::vec2(localPoint)));
-			renderLine(localPoint, localPoint);
-			markAsDirty(sPointsQueueDirty);
+			addStrokeSample(StrokeSample(ti.mFingerId, ci::vec2(localPoint), StrokeSample::kBegin), true);
 			mCurrentLine.push_back(std::make_pair(ci::vec2(localPoint), ci::vec2(localPoint)));
 
 			if(ti.mNumberFingers == 1) {
@@ -194,15 +218,16 @@ DrawingCanvas::DrawingCanvas(ds::ui::SpriteEngine& eng, const std::string& brush
 			}
 		}
 		if(ti.mPhase == ds::ui::TouchInfo::Moved){
-			mSerializedPointsQueue.push_back( std::make_pair(ci::vec2(prevPoint), ci::vec2(localPoint)) );
-			renderLine(prevPoint, localPoint);
-			markAsDirty(sPointsQueueDirty);
+			addStrokeSample(StrokeSample(ti.mFingerId, ci::vec2(localPoint), StrokeSample::kNone), true);
 			mCurrentLine.push_back(std::make_pair(ci::vec2(prevPoint), ci::vec2(localPoint)));
 
 			if(glm::distance(ti.mCurrentGlobalPoint, mTouchHoldStartPos) > mEngine.getMinTapDistance()) {
 				mTouchHolding = false;
 			}
 		}
+		if(ti.mPhase == ds::ui::TouchInfo::Removed){
+			addStrokeSample(StrokeSample(ti.mFingerId, ci::vec2(localPoint), StrokeSample::kEnd), true);
+		}
 		if (ti.mNumberFingers <= 0) {
 			if (mTouchHolding
 				&& glm::distance(ti.mCurrentGlobalPoint, mTouchHoldStartPos) <= mEngine.getMinTapDistance()
@@ -215,14 +240,17 @@ DrawingCanvas::DrawingCanvas(ds::ui::SpriteEngine& eng, const std::string& brush
 			}
 		}
 		// Don't let the queue get too large if there are no clients connected
-		while(mSerializedPointsQueue.size() > MAX_SERIALIZED_POINTS) {
-			mSerializedPointsQueue.pop_front();
+		if(mSerializedSamples.size() > MAX_SERIALIZED_POINTS) {
+			mSerializedSamples.erase(mSerializedSamples.begin(), mSerializedSamples.end() - MAX_SERIALIZED_POINTS);
 		}
 	});
 }
 
 
 void DrawingCanvas::onUpdateServer(const ds::UpdateParams& updateParams) {
+	// Draw this frame's touches into the canvas now, so it's up to date even if this instance never draws
+	drawStampBatches();
+
 	if (!isEnabled()) mTouchHolding = false;
 	if(mTouchHolding
 	   && mTouchHoldCallback
@@ -263,6 +291,15 @@ const float DrawingCanvas::getBrushSize(){
 	return mBrushSize;
 }
 
+void DrawingCanvas::setBrushSpacing(const float spacingRatio){
+	mTessellator.setSpacing(spacingRatio);
+	markAsDirty(sBrushSpacingDirty);
+}
+
+float DrawingCanvas::getBrushSpacing(){
+	return mTessellator.getSpacing();
+}
+
 void DrawingCanvas::setBrushImage(const std::string& imagePath) {
 	if(!mBrushImage) return;
 	DS_LOG_VERBOSE(3, "DrawingCanvas: setBrushImage " << imagePath);
@@ -293,6 +330,9 @@ void DrawingCanvas::clearCanvas() {
 
 	DS_LOG_VERBOSE(3, "DrawingCanvas: clearCanvas");
 
+	// Anything not drawn yet would have been cleared anyways
+	mStampBatches.clear();
+
 	auto w = getWidth();
 	auto h = getHeight();
 
@@ -328,12 +368,8 @@ void DrawingCanvas::drawLocalClient(){
 		mCanvasFileLoaderClient.clearImage();
 	}
 
-	// If any serialized points have been received from the server, draw them
-	while (!mSerializedPointsQueue.empty()) {
-		auto points = mSerializedPointsQueue.front();
-		renderLine( ci::vec3( points.first,0 ), ci::vec3( points.second,0 ) );
-		mSerializedPointsQueue.pop_front();
-	}
+	// Draw everything stamped since the last frame, from local touches or from the server
+	drawStampBatches();
 
 	if(mFbo) {
 
@@ -387,44 +423,65 @@ void DrawingCanvas::createFbo() {
 }
 
 void DrawingCanvas::renderLine(const ci::vec3& start, const ci::vec3& end) {
-
-	if(!mBrushImage) {
-		DS_LOG_WARNING("No brush image sprite in drawing canvas");
-		return;
-	}
-
 	if(mRenderLineCallback) {
 		mRenderLineCallback(std::make_pair(ci::vec2(start), ci::vec2(end)));
 	}
 
 	DS_LOG_VERBOSE(5, "DrawingCanvas: renderLine start=" << start << " end=" << end);
 
-	ci::gl::Texture2dRef brushTexture = mBrushImage->getImageTexture();
+	mTessellator.setBrushSize(mBrushSize);
+	mTessellator.addLine(ci::vec2(start), ci::vec2(end), getStampBatch());
+}
 
-	bool brushTexMode = true;
-	float widdy = mBrushSize;
-	float hiddy = mBrushSize;
-	
-	if(brushTexture){
-		brushTexture->setTopDown(true);
-		hiddy = mBrushSize / ((float)brushTexture->getWidth() / (float)brushTexture->getHeight());
+void DrawingCanvas::addStrokeSample(const StrokeSample& sample, const bool replicate) {
+	if(replicate) {
+		mSerializedSamples.push_back(sample);
+		markAsDirty(sPointsQueueDirty);
+	}
+
+	if(sample.mFlags & StrokeSample::kEnd) {
+		mLastStrokePoints.erase(sample.mStrokeId);
 	} else {
-		brushTexMode = false;
+		auto findy = mLastStrokePoints.find(sample.mStrokeId);
+		if(mRenderLineCallback) {
+			const bool isStart = (sample.mFlags & StrokeSample::kBegin) || findy == mLastStrokePoints.end();
+			mRenderLineCallback(std::make_pair(isStart ? sample.mPoint : findy->second, sample.mPoint));
+		}
+		mLastStrokePoints[sample.mStrokeId] = sample.mPoint;
 	}
 
-	float brushPixelStep = 3.0f;
-	int vertexCount = 0;
+	mTessellator.setBrushSize(mBrushSize);
+	mTessellator.addSample(sample, getStampBatch());
+}
+
+std::vector<ci::vec2>& DrawingCanvas::getStampBatch() {
+	if(mStampBatches.empty()
+	   || !(mStampBatches.back().mColor == mBrushColor)
+	   || mStampBatches.back().mBrushSize != mBrushSize
+	   || mStampBatches.back().mEraseMode != mEraseMode) {
+		StampBatch batch;
+		batch.mColor = mBrushColor;
+		batch.mBrushSize = mBrushSize;
+		batch.mEraseMode = mEraseMode;
+		mStampBatches.push_back(batch);
+	}
 
-	std::vector<ci::vec2> drawPoints;
+	return mStampBatches.back().mStamps;
+}
+
+void DrawingCanvas::drawStampBatches() {
+	if(mStampBatches.empty()) return;
 
-	// Create a point for every pixel between start and end for smoothness
-	int count = std::max<int>((int)ceilf(sqrtf((end.x - start.x) * (end.x - start.x) + (end.y - start.y) * (end.y - start.y)) / (float)brushPixelStep), 1);
-	for(int i = 0; i < count; ++i) {
-		drawPoints.push_back(ci::vec2(start.x + (end.x - start.x) * ((float)i / (float)count), start.y + (end.y - start.y) * ((float)i / (float)count)));
+	if(!mBrushImage) {
+		DS_LOG_WARNING("No brush image sprite in drawing canvas");
+		mStampBatches.clear();
+		return;
 	}
 
-	int w = (int)floorf(getWidth());
-	int h = (int)floorf(getHeight());
+	ci::gl::Texture2dRef brushTexture = mBrushImage->getImageTexture();
+	if(brushTexture) {
+		brushTexture->setTopDown(true);
+	}
 
 	createFbo();
 
@@ -436,38 +493,41 @@ void DrawingCanvas::renderLine(const ci::vec3& start, const ci::vec3& end) {
 		ci::CameraOrtho camera = ci::CameraOrtho(0.0f, static_cast<float>(mFbo->getWidth()), static_cast<float>(mFbo->getHeight()), 0.0f, -1000.0f, 1000.0f);
 		ci::gl::setMatrices(camera);
 
-		int blendSfactor = 0;
-		auto drawColor = mBrushColor;
-
-		if(mEraseMode){
-			blendSfactor = GL_ZERO;
-		} else {
-			blendSfactor = GL_ONE;
-		}
-
 		ci::gl::ScopedBlend enableBlend(true);
-		ci::gl::ScopedBlend enableFunc(blendSfactor, GL_ONE_MINUS_SRC_ALPHA);
 
+		// One draw per batch, no matter how many stamps are in it
+		for(auto& batch : mStampBatches) {
+			if(batch.mStamps.empty()) continue;
 
-		for(auto it : drawPoints){
-			ci::Rectf destRect = ci::Rectf(it.x - widdy / 2.0f, it.y - hiddy / 2.0f, it.x + widdy / 2.0f, it.y + hiddy / 2.0f);
+			ci::gl::ScopedBlend enableFunc(batch.mEraseMode ? GL_ZERO : GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+			if(brushTexture) {
+				const float hiddy = batch.mBrushSize / ((float)brushTexture->getWidth() / (float)brushTexture->getHeight());
+				mQuadMesh.clear();
+				StrokeTessellator::buildQuadMesh(batch.mStamps, ci::vec2(batch.mBrushSize, hiddy), mQuadMesh);
 
-			if(brushTexMode){
-				mPointShader.getShader()->uniform("tex0", 0);
-				mPointShader.getShader()->uniform("vertexColor", drawColor);
 				ci::gl::ScopedGlslProg shaderScp(mPointShader.getShader());
-				brushTexture->bind(0);
-				ci::gl::drawSolidRect(destRect);
+				mPointShader.getShader()->uniform("tex0", 0);
+				mPointShader.getShader()->uniform("vertexColor", batch.mColor);
+				ci::gl::ScopedTextureBind texScp(brushTexture, 0);
+				uploadStampMesh(mQuadMesh, true, mQuadVbo);
+				ci::gl::draw(mQuadVbo, 0, static_cast<GLsizei>(mQuadMesh.getNumIndices()));
 			} else {
+				mCircleMesh.clear();
+				StrokeTessellator::buildCircleMesh(batch.mStamps, batch.mBrushSize / 2.0f, CIRCLE_BRUSH_SEGMENTS, mCircleMesh);
+
 				ci::gl::ScopedGlslProg shaderScp(ci::gl::getStockShader(ci::gl::ShaderDef().color()));
-				ci::gl::color(mBrushColor);
-				ci::gl::drawSolidCircle(it, mBrushSize/2.0f);
+				ci::gl::color(batch.mColor);
+				uploadStampMesh(mCircleMesh, false, mCircleVbo);
+				ci::gl::draw(mCircleVbo, 0, static_cast<GLsizei>(mCircleMesh.getNumIndices()));
 			}
 		}
 
 		ci::gl::popMatrices();
 	}
 
+	mStampBatches.clear();
+
 	DS_REPORT_GL_ERRORS();
 }
 
@@ -485,16 +545,16 @@ void DrawingCanvas::writeAttributesTo(DataBuffer& buf) {
 		buf.add(BRUSH_SIZE_ATT);
 		buf.add<float>(mBrushSize);
 	}
+	if (mDirty.has(sBrushSpacingDirty)){
+		buf.add(BRUSH_SPACING_ATT);
+		buf.add<float>(mTessellator.getSpacing());
+	}
 	if (mDirty.has(sPointsQueueDirty)){
 		buf.add(DRAW_POINTS_QUEUE_ATT);
-		buf.add<uint32_t>((uint32_t)mSerializedPointsQueue.size());
-		for( auto &pair : mSerializedPointsQueue ) {
-			buf.add<float>(pair.first.x);
-			buf.add<float>(pair.first.y);
-			buf.add<float>(pair.second.x);
-			buf.add<float>(pair.second.y);
-		}
-		mSerializedPointsQueue.clear();
+		std::string encoded;
+		StrokeCodec::encode(mSerializedSamples, encoded);
+		buf.add(encoded);
+		mSerializedSamples.clear();
 	}
 	if (mDirty.has(sCanvasImagePathDirty)){
 		//buf.add(CANVAS_IMAGE_PATH_ATT);
@@ -519,15 +579,16 @@ void DrawingCanvas::readAttributeFrom(const char attrid, DataBuffer& buf){
 	else if (attrid == BRUSH_SIZE_ATT) {
 		mBrushSize = buf.read<float>();
 	}
+	else if (attrid == BRUSH_SPACING_ATT) {
+		mTessellator.setSpacing(buf.read<float>());
+	}
 	else if (attrid == DRAW_POINTS_QUEUE_ATT) {
-		uint32_t count = buf.read<uint32_t>();
-		ci::vec2 p1, p2;
-		for (uint32_t i = 0; i<count; i++) {
-			p1.x = buf.read<float>();
-			p1.y = buf.read<float>();
-			p2.x = buf.read<float>();
-			p2.y = buf.read<float>();
-			mSerializedPointsQueue.push_back( std::make_pair(p1, p2) );
+		std::vector<StrokeSample> samples;
+		if(!StrokeCodec::decode(buf.read<std::string>(), samples)) {
+			DS_LOG_WARNING("DrawingCanvas: received a malformed stroke packet");
+		}
+		for(auto& it : samples) {
+			addStrokeSample(it, false);
 		}
 	}
 	else if (attrid == CANVAS_IMAGE_PATH_ATT) {
@@ -2,7 +2,7 @@
 #ifndef DS_UI_DRAWING_DRAWING_CANVAS
 #define DS_UI_DRAWING_DRAWING_CANVAS
 
-#include <deque>
+#include <unordered_map>
 #include <utility>
 
 #include <ds/ui/sprite/sprite.h>
@@ -10,13 +10,18 @@
 #include "cinder/gl/Texture.h"
 #include "ds/ui/sprite/shader/sprite_shader.h"
 #include "cinder/gl/Fbo.h"
+#include "cinder/gl/VboMesh.h"
+#include "ds/ui/drawing/stroke_tessellator.h"
 
 namespace ds {
 namespace ui {
 
 /**
 * \class DrawingCanvas
-*			A view that you can touch to draw on
+*			A view that you can touch to draw on.
+*			Touches are smoothed into strokes and stamped with the brush by a StrokeTessellator. Stamps pile up
+*			during the frame and get drawn into the canvas with one mesh per brush setting when the canvas draws.
+*			Clients get the touch samples (compactly encoded) and tessellate them the same way.
 */
 class DrawingCanvas
 	: public ds::ui::Sprite
@@ -39,7 +44,12 @@ public:
 	void								setBrushSize(const float brushSize);
 	const float							getBrushSize();
 
-	/// Draws a line from start to end with an instance of the brush texture at every pixel
+	/// Distance between brush stamps as a fraction of the brush size. Lower is smoother and slower. Defaults to 0.125
+	void								setBrushSpacing(const float spacingRatio);
+	float								getBrushSpacing();
+
+	/// Draws a straight line from start to end with evenly spaced instances of the brush texture.
+	/// The line is queued, and drawn into the canvas the next time the canvas draws.
 	void								renderLine(const ci::vec3& start, const ci::vec3& end);
 
 	/// Loads an image file to use for the brush
@@ -69,9 +79,8 @@ public:
 	ds::ui::SpriteShader&				getPointShader() { return mPointShader; }
 
 protected:
-	// Queue to store points as they're drawn.  This gets serialized to clients.
-	typedef std::deque< std::pair<ci::vec2, ci::vec2> > PointsQueue;
-	PointsQueue							mSerializedPointsQueue;
+	// Touch samples as they're drawn.  This gets serialized to clients.
+	std::vector<StrokeSample>			mSerializedSamples;
 
 	std::vector<std::pair<ci::vec2, ci::vec2>>							 mCurrentLine;
 	std::function<void(std::pair<ci::vec2, ci::vec2>line)>				 mRenderLineCallback;
@@ -85,6 +94,10 @@ protected:
 
 	virtual void						drawLocalClient() override;
 	void								createFbo();
+	/// Runs a sample through the tessellator, and queues it for clients if replicate is set
+	void								addStrokeSample(const StrokeSample& sample, const bool replicate);
+	/// Draws every queued brush stamp into the fbo
+	void								drawStampBatches();
 	virtual void						writeAttributesTo(DataBuffer&) override;
 	virtual void						readAttributeFrom(const char, DataBuffer&) override;
 
@@ -105,6 +118,25 @@ private:
 	ci::ColorA							mBrushColor;
 	bool								mEraseMode;
 
+	/// Stamps waiting to be drawn, split up wherever the brush settings changed
+	struct StampBatch {
+		ci::ColorA						mColor;
+		float							mBrushSize;
+		bool							mEraseMode;
+		std::vector<ci::vec2>			mStamps;
+	};
+	std::vector<ci::vec2>&				getStampBatch();
+
+	StrokeTessellator					mTessellator;
+	std::vector<StampBatch>				mStampBatches;
+	/// Reused between frames to avoid reallocating. The VBOs only grow.
+	ci::TriMesh							mQuadMesh;
+	ci::TriMesh							mCircleMesh;
+	ci::gl::VboMeshRef					mQuadVbo;
+	ci::gl::VboMeshRef					mCircleVbo;
+	/// The previous point of each stroke in progress, for the render line callback
+	std::unordered_map<int, ci::vec2>	mLastStrokePoints;
+
 };
 
 } // namespace ui
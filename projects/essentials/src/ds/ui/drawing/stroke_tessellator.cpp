@@ -0,0 +1,350 @@
+#include "stdafx.h"
+
+#include "stroke_tessellator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+/// Samples closer than this to the previous one are skipped, they only add noise to the curve
+const float			MIN_SAMPLE_DISTANCE		= 0.5f;
+
+const uint8_t		CODEC_SLOT_MASK			= 0x0f;
+const uint8_t		CODEC_BEGIN				= 0x10;
+const uint8_t		CODEC_END				= 0x20;
+const uint8_t		CODEC_ABSOLUTE			= 0x40;
+const uint8_t		CODEC_NEW_SLOT			= 0x80;
+const int			CODEC_NUM_SLOTS			= 16;
+const float			CODEC_FIXED_SCALE		= 4.0f;
+
+const float			TWO_PI					= 6.28318530718f;
+
+template<typename T>
+void appendRaw(std::string& bytes, const T& value) {
+	bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readRaw(const std::string& bytes, size_t& pos, T& outValue) {
+	if(pos + sizeof(T) > bytes.size()) return false;
+	std::memcpy(&outValue, bytes.data() + pos, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+/// Knot spacing for centripetal Catmull-Rom, guarded so coincident points don't divide by zero
+float knotInterval(const ci::vec2& a, const ci::vec2& b) {
+	const ci::vec2 delta = b - a;
+	return std::max(std::pow(glm::dot(delta, delta), 0.25f), 1e-4f);
+}
+
+}
+
+namespace ds {
+namespace ui {
+
+/**
+* \class StrokeSample
+*/
+StrokeSample::StrokeSample()
+	: mStrokeId(0)
+	, mFlags(kNone)
+{
+}
+
+StrokeSample::StrokeSample(const int strokeId, const ci::vec2& point, const int flags)
+	: mStrokeId(strokeId)
+	, mPoint(point)
+	, mFlags(flags)
+{
+}
+
+/**
+* \class StrokeTessellator
+*/
+StrokeTessellator::Stroke::Stroke()
+	: mCount(0)
+	, mCarry(0.0f)
+{
+}
+
+StrokeTessellator::StrokeTessellator()
+	: mSpacingRatio(0.125f)
+	, mBrushSize(24.0f)
+{
+}
+
+void StrokeTessellator::setSpacing(const float spacingRatio) {
+	mSpacingRatio = std::max(spacingRatio, 0.01f);
+}
+
+void StrokeTessellator::setBrushSize(const float brushSize) {
+	mBrushSize = brushSize;
+}
+
+float StrokeTessellator::getStampSpacing() const {
+	return std::max(1.0f, mBrushSize * mSpacingRatio);
+}
+
+void StrokeTessellator::addSample(const StrokeSample& sample, std::vector<ci::vec2>& outStamps) {
+	auto findy = mStrokes.find(sample.mStrokeId);
+
+	if((sample.mFlags & StrokeSample::kBegin) || findy == mStrokes.end()) {
+		Stroke& stroke = mStrokes[sample.mStrokeId];
+		stroke = Stroke();
+		pushPoint(stroke, sample.mPoint);
+
+		// A single stamp right away, so a tap leaves a dot
+		outStamps.push_back(sample.mPoint);
+
+		if(sample.mFlags & StrokeSample::kEnd) {
+			mStrokes.erase(sample.mStrokeId);
+		}
+		return;
+	}
+
+	Stroke& stroke = findy->second;
+	if(glm::distance(stroke.mPoints[stroke.mCount - 1], sample.mPoint) >= MIN_SAMPLE_DISTANCE) {
+		pushPoint(stroke, sample.mPoint);
+		if(stroke.mCount > 2) {
+			stampNewest(stroke, false, outStamps);
+		}
+	}
+
+	if(sample.mFlags & StrokeSample::kEnd) {
+		if(stroke.mCount > 1) {
+			stampNewest(stroke, true, outStamps);
+		}
+		mStrokes.erase(findy);
+	}
+}
+
+void StrokeTessellator::addLine(const ci::vec2& start, const ci::vec2& end, std::vector<ci::vec2>& outStamps) const {
+	outStamps.push_back(start);
+	float carry = 0.0f;
+	stampLine(carry, start, end, outStamps);
+}
+
+void StrokeTessellator::clear() {
+	mStrokes.clear();
+}
+
+void StrokeTessellator::pushPoint(Stroke& stroke, const ci::vec2& point) {
+	if(stroke.mCount == 4) {
+		std::copy(stroke.mPoints + 1, stroke.mPoints + 4, stroke.mPoints);
+		stroke.mCount = 3;
+	}
+	stroke.mPoints[stroke.mCount++] = point;
+}
+
+void StrokeTessellator::stampNewest(Stroke& stroke, const bool finishing, std::vector<ci::vec2>& outStamps) const {
+	// While drawing, the segment that just got its following point is the one before the newest point.
+	// When finishing, it's the last segment, with nothing after it.
+	const int		end = finishing ? stroke.mCount - 1 : stroke.mCount - 2;
+	const int		start = end - 1;
+	if(start < 0) return;
+
+	const ci::vec2&	p1 = stroke.mPoints[start];
+	const ci::vec2&	p2 = stroke.mPoints[end];
+
+	// Missing neighbours at the ends of the stroke are mirrored, which keeps the end tangents pointing along the stroke
+	const ci::vec2	p0 = start > 0 ? stroke.mPoints[start - 1] : p1 * 2.0f - p2;
+	const ci::vec2	p3 = end + 1 < stroke.mCount ? stroke.mPoints[end + 1] : p2 * 2.0f - p1;
+
+	stampCurve(stroke, p0, p1, p2, p3, outStamps);
+}
+
+void StrokeTessellator::stampCurve(Stroke& stroke, const ci::vec2& p0, const ci::vec2& p1, const ci::vec2& p2, const ci::vec2& p3, std::vector<ci::vec2>& outStamps) const {
+	const float		t0 = 0.0f;
+	const float		t1 = t0 + knotInterval(p0, p1);
+	const float		t2 = t1 + knotInterval(p1, p2);
+	const float		t3 = t2 + knotInterval(p2, p3);
+
+	// Walk the curve in straight pieces of about half a stamp, which is plenty for a brush
+	const float		spacing = getStampSpacing();
+	const int		numPieces = std::max(1, static_cast<int>(ceilf(glm::distance(p1, p2) / (spacing * 0.5f))));
+
+	ci::vec2		prev = p1;
+	for(int i = 1; i <= numPieces; ++i) {
+		const float	t = t1 + (t2 - t1) * (static_cast<float>(i) / static_cast<float>(numPieces));
+
+		const ci::vec2 a1 = p0 * ((t1 - t) / (t1 - t0)) + p1 * ((t - t0) / (t1 - t0));
+		const ci::vec2 a2 = p1 * ((t2 - t) / (t2 - t1)) + p2 * ((t - t1) / (t2 - t1));
+		const ci::vec2 a3 = p2 * ((t3 - t) / (t3 - t2)) + p3 * ((t - t2) / (t3 - t2));
+		const ci::vec2 b1 = a1 * ((t2 - t) / (t2 - t0)) + a2 * ((t - t0) / (t2 - t0));
+		const ci::vec2 b2 = a2 * ((t3 - t) / (t3 - t1)) + a3 * ((t - t1) / (t3 - t1));
+		const ci::vec2 point = i == numPieces ? p2 : b1 * ((t2 - t) / (t2 - t1)) + b2 * ((t - t1) / (t2 - t1));
+
+		stampLine(stroke.mCarry, prev, point, outStamps);
+		prev = point;
+	}
+}
+
+void StrokeTessellator::stampLine(float& carry, const ci::vec2& start, const ci::vec2& end, std::vector<ci::vec2>& outStamps) const {
+	const float		length = glm::distance(start, end);
+	if(length <= 0.0f) return;
+
+	const float		spacing = getStampSpacing();
+	float			along = spacing - carry;
+	while(along <= length) {
+		outStamps.push_back(start + (end - start) * (along / length));
+		along += spacing;
+	}
+	carry = length - (along - spacing);
+}
+
+void StrokeTessellator::buildQuadMesh(const std::vector<ci::vec2>& stamps, const ci::vec2& stampSize, ci::TriMesh& outMesh) {
+	const ci::vec2	half = stampSize * 0.5f;
+	uint32_t		index = static_cast<uint32_t>(outMesh.getNumVertices());
+
+	for(auto& it : stamps) {
+		outMesh.appendPosition(ci::vec2(it.x - half.x, it.y - half.y));
+		outMesh.appendTexCoord0(ci::vec2(0.0f, 1.0f));
+		outMesh.appendPosition(ci::vec2(it.x + half.x, it.y - half.y));
+		outMesh.appendTexCoord0(ci::vec2(1.0f, 1.0f));
+		outMesh.appendPosition(ci::vec2(it.x + half.x, it.y + half.y));
+		outMesh.appendTexCoord0(ci::vec2(1.0f, 0.0f));
+		outMesh.appendPosition(ci::vec2(it.x - half.x, it.y + half.y));
+		outMesh.appendTexCoord0(ci::vec2(0.0f, 0.0f));
+
+		outMesh.appendTriangle(index, index + 1, index + 2);
+		outMesh.appendTriangle(index, index + 2, index + 3);
+		index += 4;
+	}
+}
+
+void StrokeTessellator::buildCircleMesh(const std::vector<ci::vec2>& stamps, const float radius, const int numSegments, ci::TriMesh& outMesh) {
+	const int		segments = std::max(3, numSegments);
+	uint32_t		index = static_cast<uint32_t>(outMesh.getNumVertices());
+
+	std::vector<ci::vec2> ring(segments);
+	for(int i = 0; i < segments; ++i) {
+		const float	angle = static_cast<float>(i) / static_cast<float>(segments) * TWO_PI;
+		ring[i] = ci::vec2(cosf(angle), sinf(angle)) * radius;
+	}
+
+	for(auto& it : stamps) {
+		outMesh.appendPosition(it);
+		for(auto& r : ring) {
+			outMesh.appendPosition(it + r);
+		}
+		for(int i = 0; i < segments; ++i) {
+			outMesh.appendTriangle(index, index + 1 + i, index + 1 + (i + 1) % segments);
+		}
+		index += segments + 1;
+	}
+}
+
+/**
+* \class StrokeCodec
+*/
+void StrokeCodec::encode(const std::vector<StrokeSample>& samples, std::string& outBytes) {
+	int				slotIds[CODEC_NUM_SLOTS];
+	int32_t			slotX[CODEC_NUM_SLOTS], slotY[CODEC_NUM_SLOTS];
+	int				numSlots = 0;
+	int				nextEvict = 0;
+
+	outBytes.clear();
+	outBytes.reserve(samples.size() * 5 + 8);
+	appendRaw<uint32_t>(outBytes, static_cast<uint32_t>(samples.size()));
+
+	for(auto& it : samples) {
+		uint8_t		flags = 0;
+		int			slot = -1;
+		for(int i = 0; i < numSlots; ++i) {
+			if(slotIds[i] == it.mStrokeId) {
+				slot = i;
+				break;
+			}
+		}
+
+		if(slot < 0) {
+			if(numSlots < CODEC_NUM_SLOTS) {
+				slot = numSlots++;
+			} else {
+				slot = nextEvict;
+				nextEvict = (nextEvict + 1) % CODEC_NUM_SLOTS;
+			}
+			slotIds[slot] = it.mStrokeId;
+			flags |= CODEC_NEW_SLOT | CODEC_ABSOLUTE;
+		}
+
+		const int32_t	x = static_cast<int32_t>(std::lround(it.mPoint.x * CODEC_FIXED_SCALE));
+		const int32_t	y = static_cast<int32_t>(std::lround(it.mPoint.y * CODEC_FIXED_SCALE));
+		if(!(flags & CODEC_ABSOLUTE)) {
+			const int32_t dx = x - slotX[slot];
+			const int32_t dy = y - slotY[slot];
+			if(dx < INT16_MIN || dx > INT16_MAX || dy < INT16_MIN || dy > INT16_MAX) {
+				flags |= CODEC_ABSOLUTE;
+			}
+		}
+
+		flags |= static_cast<uint8_t>(slot);
+		if(it.mFlags & StrokeSample::kBegin) flags |= CODEC_BEGIN;
+		if(it.mFlags & StrokeSample::kEnd) flags |= CODEC_END;
+
+		appendRaw<uint8_t>(outBytes, flags);
+		if(flags & CODEC_NEW_SLOT) {
+			appendRaw<int32_t>(outBytes, static_cast<int32_t>(it.mStrokeId));
+		}
+		if(flags & CODEC_ABSOLUTE) {
+			appendRaw<int32_t>(outBytes, x);
+			appendRaw<int32_t>(outBytes, y);
+		} else {
+			appendRaw<int16_t>(outBytes, static_cast<int16_t>(x - slotX[slot]));
+			appendRaw<int16_t>(outBytes, static_cast<int16_t>(y - slotY[slot]));
+		}
+
+		slotX[slot] = x;
+		slotY[slot] = y;
+	}
+}
+
+bool StrokeCodec::decode(const std::string& bytes, std::vector<StrokeSample>& outSamples) {
+	int				slotIds[CODEC_NUM_SLOTS];
+	bool			slotValid[CODEC_NUM_SLOTS] = {};
+	int32_t			slotX[CODEC_NUM_SLOTS], slotY[CODEC_NUM_SLOTS];
+
+	size_t			pos = 0;
+	uint32_t		count = 0;
+	if(!readRaw(bytes, pos, count)) return false;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		uint8_t		flags = 0;
+		if(!readRaw(bytes, pos, flags)) return false;
+
+		const int	slot = flags & CODEC_SLOT_MASK;
+		if(flags & CODEC_NEW_SLOT) {
+			int32_t id = 0;
+			if(!readRaw(bytes, pos, id)) return false;
+			slotIds[slot] = id;
+			slotValid[slot] = true;
+		}
+		if(!slotValid[slot]) return false;
+
+		if(flags & CODEC_ABSOLUTE) {
+			if(!readRaw(bytes, pos, slotX[slot]) || !readRaw(bytes, pos, slotY[slot])) return false;
+		} else {
+			int16_t dx = 0, dy = 0;
+			if(!readRaw(bytes, pos, dx) || !readRaw(bytes, pos, dy)) return false;
+			slotX[slot] += dx;
+			slotY[slot] += dy;
+		}
+
+		int sampleFlags = StrokeSample::kNone;
+		if(flags & CODEC_BEGIN) sampleFlags |= StrokeSample::kBegin;
+		if(flags & CODEC_END) sampleFlags |= StrokeSample::kEnd;
+
+		outSamples.push_back(StrokeSample(slotIds[slot],
+										  ci::vec2(static_cast<float>(slotX[slot]) / CODEC_FIXED_SCALE, static_cast<float>(slotY[slot]) / CODEC_FIXED_SCALE),
+										  sampleFlags));
+	}
+
+	return true;
+}
+
+} // namespace ui
+} // namespace ds
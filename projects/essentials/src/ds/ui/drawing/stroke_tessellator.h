@@ -0,0 +1,105 @@
+#pragma once
+#ifndef DS_UI_DRAWING_STROKE_TESSELLATOR
+#define DS_UI_DRAWING_STROKE_TESSELLATOR
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cinder/TriMesh.h>
+#include <cinder/Vector.h>
+
+namespace ds {
+namespace ui {
+
+/**
+* \class StrokeSample
+*			One touch sample of a stroke. The samples are all that's needed to reproduce a stroke,
+*			so they're what gets replicated to clients instead of the brush stamps.
+*/
+struct StrokeSample {
+	enum Flags { kNone = 0, kBegin = 1, kEnd = 2 };
+
+	StrokeSample();
+	StrokeSample(const int strokeId, const ci::vec2& point, const int flags);
+
+	int			mStrokeId;
+	ci::vec2	mPoint;
+	int			mFlags;
+};
+
+/**
+* \class StrokeTessellator
+*			Turns touch samples into evenly spaced brush stamps along a smoothed (centripetal Catmull-Rom) curve,
+*			and stamps into a single indexed mesh. No GL calls, so it can run and be measured anywhere.
+*			Any number of strokes can be in progress at once, keyed by stroke id (the finger id works well).
+*			Smoothing needs the sample after a segment to shape it, so each stroke draws one sample behind the finger.
+*/
+class StrokeTessellator {
+public:
+	StrokeTessellator();
+
+	/// Distance between stamps as a fraction of the brush size. Defaults to 0.125
+	void							setSpacing(const float spacingRatio);
+	float							getSpacing() const { return mSpacingRatio; }
+
+	/// Brush size in pixels, the stamp spacing scales with it
+	void							setBrushSize(const float brushSize);
+	float							getBrushSize() const { return mBrushSize; }
+
+	/// Feeds one sample through the smoothing, appending the centers of any new stamps to outStamps
+	void							addSample(const StrokeSample& sample, std::vector<ci::vec2>& outStamps);
+
+	/// Stamps a straight line, with no smoothing and no stroke state
+	void							addLine(const ci::vec2& start, const ci::vec2& end, std::vector<ci::vec2>& outStamps) const;
+
+	/// Forgets every stroke in progress
+	void							clear();
+	size_t							getActiveStrokeCount() const { return mStrokes.size(); }
+
+	/// Appends one textured quad of stampSize per stamp. Texture coordinates match ci::gl::drawSolidRect()
+	static void						buildQuadMesh(const std::vector<ci::vec2>& stamps, const ci::vec2& stampSize, ci::TriMesh& outMesh);
+	/// Appends one circle (as a triangle fan) per stamp, for drawing without a brush texture
+	static void						buildCircleMesh(const std::vector<ci::vec2>& stamps, const float radius, const int numSegments, ci::TriMesh& outMesh);
+
+private:
+	struct Stroke {
+		Stroke();
+		/// The most recent control points, mPoints[mCount - 1] is the newest
+		ci::vec2					mPoints[4];
+		int							mCount;
+		/// Distance travelled since the last stamp
+		float						mCarry;
+	};
+
+	float							getStampSpacing() const;
+	void							pushPoint(Stroke&, const ci::vec2&);
+	/// Stamps the curve between p1 and p2, p0 and p3 shape it
+	void							stampCurve(Stroke&, const ci::vec2& p0, const ci::vec2& p1, const ci::vec2& p2, const ci::vec2& p3, std::vector<ci::vec2>& outStamps) const;
+	void							stampLine(float& carry, const ci::vec2& start, const ci::vec2& end, std::vector<ci::vec2>& outStamps) const;
+	/// Stamps the newest complete segment. Set finishing at the end of a stroke to stamp up to the last point
+	void							stampNewest(Stroke&, const bool finishing, std::vector<ci::vec2>& outStamps) const;
+
+	std::unordered_map<int, Stroke>	mStrokes;
+	float							mSpacingRatio;
+	float							mBrushSize;
+};
+
+/**
+* \class StrokeCodec
+*			Compact encoding of stroke samples for server -> client replication.
+*			Each sample is a flags byte, then either a 16 bit delta from the previous point of the same
+*			stroke or, when the stroke is new to the packet or moved too far, an absolute 32 bit point.
+*			Points are fixed point at 1/4 pixel. A typical moved sample is 5 bytes, down from 16 for a float pair of points.
+*/
+class StrokeCodec {
+public:
+	static void						encode(const std::vector<StrokeSample>& samples, std::string& outBytes);
+	/// Returns false (and whatever decoded cleanly) if the bytes are truncated or malformed
+	static bool						decode(const std::string& bytes, std::vector<StrokeSample>& outSamples);
+};
+
+} // namespace ui
+} // namespace ds
+
+#endif
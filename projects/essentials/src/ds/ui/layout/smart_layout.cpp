@@ -23,8 +23,8 @@ SmartLayout::SmartLayout(ds::ui::SpriteEngine& engine, const std::string& xmlLay
 						 const std::string xmlFileLocation, const bool loadImmediately)
   : ds::ui::LayoutSprite(engine)
   , mLayoutFile(xmlFileLocation + xmlLayoutFile)
-  , mNeedsLayout(false)
   , mInitialized(false)
+  , mBindingsCompiled(false)
   , mEventClient(engine) {
 	if (loadImmediately) {
 		initialize();
@@ -35,7 +35,7 @@ SmartLayout::SmartLayout(ds::ui::SpriteEngine& engine)
   : ds::ui::LayoutSprite(engine)
   , mLayoutFile("")
   , mInitialized(false)
-  , mNeedsLayout(false)
+  , mBindingsCompiled(false)
   , mEventClient(engine) {}
 
 void SmartLayout::setLayoutFile(const std::string& xmlLayoutFile, const std::string xmlFileLocation,
@@ -50,12 +50,11 @@ void SmartLayout::setLayoutFile(const std::string& xmlLayoutFile, const std::str
 
 void SmartLayout::initialize() {
 	mSpriteMap.clear();
+	mModelBindings.clear();
+	mBindingsCompiled = false;
 	clearChildren();
 	ds::ui::XmlImporter::loadXMLto(this, ds::Environment::expand(mLayoutFile), mSpriteMap, nullptr, "", true);
 
-	// Auto clear mNeedsLayout if client app runs layout manually
-	setLayoutUpdatedFunction([this] { mNeedsLayout = false; });
-
 	runLayout();
 	mInitialized = true;
 }
@@ -75,7 +74,7 @@ void SmartLayout::setSpriteText(const std::string& spriteName, const std::string
 
 	if (spr) {
 		spr->setText(theText);
-		mNeedsLayout = true;
+		invalidateLayout();
 	} else {
 		DS_LOG_VERBOSE(2, "Failed to set Text for Sprite: " << spriteName);
 	}
@@ -90,7 +89,7 @@ void SmartLayout::setSpriteFont(const std::string& spriteName, const std::string
 
 	if (spr) {
 		mEngine.getEngineCfg().getText(textCfgName).configure(*spr);
-		mNeedsLayout = true;
+		invalidateLayout();
 	} else {
 		DS_LOG_WARNING("Failed to set Font " << textCfgName << " for Sprite: " << spriteName);
 	}
@@ -119,11 +118,11 @@ void SmartLayout::setSpriteImage(const std::string& spriteName, const std::strin
 
 		if (skipMetaData) {
 			sprI->setStatusCallback([this](const ds::ui::Image::Status& status) {
-				mNeedsLayout = true;
+				invalidateLayout();
 			});
 		}
 		else {
-			mNeedsLayout = true;
+			invalidateLayout();
 		}
 
 	}
@@ -154,11 +153,11 @@ void SmartLayout::setSpriteImage(const std::string& spriteName, ds::Resource ima
 
 		if (skipMetaData) {
 			sprI->setStatusCallback([this](const ds::ui::Image::Status& status) {
-				mNeedsLayout = true;
+				invalidateLayout();
 			});
 		}
 		else {
-			mNeedsLayout = true;
+			invalidateLayout();
 		}
 	}
 	else {
@@ -196,194 +195,222 @@ void SmartLayout::setSpriteClickFn(const std::string& spriteName, const std::fun
 
 void SmartLayout::setContentModel(ds::model::ContentModelRef& theData) {
 	mContentModel = theData;
+
+	if (!mBindingsCompiled) {
+		compileModelBindings();
+	}
+
+	// Each node is looked up once per model, no matter how many sprites use it
+	std::vector<ds::model::ContentModelRef> nodes;
+	nodes.reserve(mBindingNodes.size());
+	for (auto& nodeName : mBindingNodes) {
+		nodes.push_back(nodeName == "this" ? mContentModel : mContentModel.getChildByName(nodeName));
+	}
+
+	for (auto& binding : mModelBindings) {
+		binding.mApply(binding, nodes[binding.mNode]);
+	}
+
+	// Nested layouts that nothing above changed are skipped
+	runLayout();
+
+	if (mContentUpdatedCallback) {
+		mContentUpdatedCallback();
+	}
+}
+
+SmartLayout::ModelBinding::ModelBinding(ds::ui::Sprite* sprite, const size_t node, const std::string& property)
+  : mSprite(sprite)
+  , mNode(node)
+  , mProperty(property) {}
+
+void SmartLayout::compileModelBindings() {
+	mModelBindings.clear();
+	mBindingNodes.clear();
+
+	// Most sprites have neither, so look them up by id rather than hashing the names for every sprite
+	static const auto MODEL_KEY		 = ds::KeyValueStore::getKeyId("model");
+	static const auto EACH_MODEL_KEY = ds::KeyValueStore::getKeyId("each_model");
+
 	for (auto child : mSpriteMap) {
 		// Handle model
-		auto theModel = child.second->getUserData().getString("model");
-		if (!theModel.empty()) {
-			applyModelToSprite(child.second, child.first, theModel);
+		std::string theModel;
+		if (child.second->getUserData().tryGetString(MODEL_KEY, theModel) && !theModel.empty()) {
+			compileModelToSprite(child.second, child.first, theModel);
 			continue;
 		}
 
 		// Handle each_model
-		auto eachModel = child.second->getUserData().getString("each_model");
-		if (!eachModel.empty()) {
-			applyEachModelToSprite(child.second, eachModel);
+		std::string eachModel;
+		if (child.second->getUserData().tryGetString(EACH_MODEL_KEY, eachModel) && !eachModel.empty()) {
+			compileEachModelToSprite(child.second, eachModel);
 			continue;
 		}
 	}
 
-	runLayout();
+	mBindingsCompiled = true;
+}
 
-	if (mContentUpdatedCallback) {
-		mContentUpdatedCallback();
+size_t SmartLayout::getBindingNode(const std::string& nodeName) {
+	for (size_t i = 0; i < mBindingNodes.size(); ++i) {
+		if (mBindingNodes[i] == nodeName) return i;
 	}
+	mBindingNodes.push_back(nodeName);
+	return mBindingNodes.size() - 1;
 }
 
-void SmartLayout::applyModelToSprite(ds::ui::Sprite* child, const std::string& childName, const std::string& model) {
+void SmartLayout::compileModelToSprite(ds::ui::Sprite* child, const std::string& childName, const std::string& model) {
 	if (!child) return;
 
 	for (auto mit : ds::split(model, "; ", true)) {
 		auto keyVals = ds::split(mit, ":", true);
-		if (keyVals.size() == 2) {
-			auto childProps = ds::split(keyVals[1], "->", true);
+		if (keyVals.size() != 2) {
+			DS_LOG_WARNING("SmartLayout::setData() Invalid syntax for prop / model mapping: " << model);
+			continue;
+		}
 
-			if (childProps.empty() || childProps.size() > 2) {
-				DS_LOG_WARNING("SmartLayout::setData() Invalid syntax for child / property mapping: " << model);
-				continue;
-			}
+		auto childProps = ds::split(keyVals[1], "->", true);
+		if (childProps.empty() || childProps.size() > 2) {
+			DS_LOG_WARNING("SmartLayout::setData() Invalid syntax for child / property mapping: " << model);
+			continue;
+		}
 
-			// Get the right content model
-			ds::model::ContentModelRef theNode = mContentModel;
-			if (childProps[0] != "this") {
-				theNode = mContentModel.getChildByName(childProps[0]);
-			}
+		const auto&  sprPropToSet = keyVals[0];
+		ModelBinding binding(child, getBindingNode(childProps[0]), childProps.size() == 2 ? childProps[1] : "");
 
+		if (sprPropToSet == "visible_if_exists" || sprPropToSet == "hidden_if_exists") {
+			// Without a property, this checks if the node exists, otherwise if the property has a value
+			const bool showIfExists = (sprPropToSet == "visible_if_exists");
+			binding.mApply = [showIfExists](ModelBinding& b, ds::model::ContentModelRef& node) {
+				const bool exists = b.mProperty.empty() ? !node.empty() : !node.getPropertyString(b.mProperty).empty();
+				if (exists == showIfExists) {
+					b.mSprite->show();
+				} else {
+					b.mSprite->hide();
+				}
+			};
 
-			if (childProps.size() == 1) {  // Handle model types that only require a model & not a property
-				auto sprPropToSet = keyVals[0];
-				if (sprPropToSet == "text_model") {
-					auto fmt = child->getUserData().getString("model_format");
+		} else if (childProps.size() == 1) {  // Handle model types that only require a model & not a property
+			if (sprPropToSet != "text_model") continue;
 
-					std::string formattedModel = ds::ui::processTextModel(fmt, theNode);
+			const auto fmt = child->getUserData().getString("model_format");
+			binding.mApply = [fmt](ModelBinding& b, ds::model::ContentModelRef& node) {
+				ds::ui::XmlImporter::setSpriteProperty(*b.mSprite, "text", ds::ui::processTextModel(fmt, node));
+			};
+
+		} else if (sprPropToSet.rfind("resource", 0) == 0) {  // Handle 'model->property' models
+			int flags = 0;
+			if (sprPropToSet.find("_") != std::string::npos) {
+
+				auto theFlags = ds::split(sprPropToSet, "_", true);
+				for (auto val : theFlags) {
+
+					if (val == "cache" || val == "c") {
+						flags |= ds::ui::Image::IMG_CACHE_F;
 
-					ds::ui::XmlImporter::setSpriteProperty(*child, "text", formattedModel);
-				} else if(sprPropToSet == "visible_if_exists") {
-					if(theNode.empty()) {
-						child->hide();
-					} else {
-						child->show();
-					}
-				} else if(sprPropToSet == "hidden_if_exists") {
-					if(theNode.empty()) {
-						child->show();
-					} else {
-						child->hide();
-					}
-				}
-			} else if (childProps.size() == 2) {  // Handle 'model->property' models
-				auto		sprPropToSet = keyVals[0];
-				auto		theProp		 = childProps[1];
-				std::string actualValue  = "";
-				
-				if (sprPropToSet.rfind( "resource",0)==0) {
-
-					int  flags = 0;
-					if (sprPropToSet.find("_") != std::string::npos) {
-
-						auto theFlags = ds::split(sprPropToSet, "_", true);
-						for (auto val : theFlags) {
-
-							if (val == "cache" || val == "c") {
-								flags |= ds::ui::Image::IMG_CACHE_F;
-
-							}
-							else if (val == "mipmap" || val == "m") {
-								flags |= ds::ui::Image::IMG_ENABLE_MIPMAP_F;
-
-							}
-							else if (val == "preload" || val == "p") {
-								flags |= ds::ui::Image::IMG_PRELOAD_F;
-
-							}
-							else if (val == "skipmeta" || val == "s") {
-								flags |= ds::ui::Image::IMG_SKIP_METADATA_F;
-
-							}
-							else if (val != "resource" ) {
-								DS_LOG_WARNING("Trying to set unknown flags to src/filename attribute: _" << val
-									<< "_ on sprite of type: " << typeid(child).name());
-							}
-						}
-					}
-					if(flags==0)
-					{
-						child->setResource(theNode.getProperty(theProp).getResource());
-					}
-					else {
-						setSpriteImage(childName, theNode.getProperty(theProp).getResource(), flags);
-					}
-				} else if(sprPropToSet == "media_player_src") {
-					auto theResource = theNode.getProperty(theProp).getResource();
-					if(theResource.empty()) {
-						theResource = ds::Resource(ds::Environment::expand(theNode.getPropertyString(theProp)));
-					} else if(theResource.getType() == ds::Resource::IMAGE_TYPE) {
-						ds::ImageMetaData metaData;
-						metaData.add(ds::Environment::expand(theResource.getAbsoluteFilePath()),
-									 ci::vec2(theResource.getWidth(), theResource.getHeight()));
 					}
+					else if (val == "mipmap" || val == "m") {
+						flags |= ds::ui::Image::IMG_ENABLE_MIPMAP_F;
 
-					if(!theResource.empty()) {
-						child->setResource(theResource);
 					}
-				} else if(sprPropToSet == "visible_if_exists"){
-					if(theNode.getPropertyString(theProp).empty()) {
-						child->hide();
-					} else {
-						child->show();
+					else if (val == "preload" || val == "p") {
+						flags |= ds::ui::Image::IMG_PRELOAD_F;
+
 					}
-				} else if(sprPropToSet == "hidden_if_exists"){
-					if(theNode.getPropertyString(theProp).empty()) {
-						child->show();
-					} else {
-						child->hide();
+					else if (val == "skipmeta" || val == "s") {
+						flags |= ds::ui::Image::IMG_SKIP_METADATA_F;
+
 					}
-				} else if (sprPropToSet.rfind("_",0)==0) {
-					auto click_data = theNode.getPropertyString(theProp);
-					if (!click_data.empty()) {
-						child->getUserData().setString(sprPropToSet, click_data);
+					else if (val != "resource" ) {
+						DS_LOG_WARNING("Trying to set unknown flags to src/filename attribute: _" << val
+							<< "_ on sprite of type: " << typeid(child).name());
 					}
+				}
+			}
+
+			binding.mApply = [this, childName, flags](ModelBinding& b, ds::model::ContentModelRef& node) {
+				auto theResource = node.getProperty(b.mProperty).getResource();
+				if (flags == 0) {
+					b.mSprite->setResource(theResource);
 				} else {
-					actualValue = theNode.getPropertyString(theProp);
+					setSpriteImage(childName, theResource, flags);
+				}
+			};
 
-					ds::ui::XmlImporter::setSpriteProperty(*child, sprPropToSet, actualValue);
+		} else if (sprPropToSet == "media_player_src") {
+			binding.mApply = [](ModelBinding& b, ds::model::ContentModelRef& node) {
+				auto theResource = node.getProperty(b.mProperty).getResource();
+				if (theResource.empty()) {
+					theResource = ds::Resource(ds::Environment::expand(node.getPropertyString(b.mProperty)));
 				}
-			}
+				if (theResource.empty()) return;
+
+				if (theResource.getType() == ds::Resource::IMAGE_TYPE) {
+					ds::ImageMetaData metaData;
+					metaData.add(ds::Environment::expand(theResource.getAbsoluteFilePath()),
+								 ci::vec2(theResource.getWidth(), theResource.getHeight()));
+				}
+
+				b.mSprite->setResource(theResource);
+			};
+
+		} else if (sprPropToSet.rfind("_", 0) == 0) {
+			binding.mApply = [sprPropToSet](ModelBinding& b, ds::model::ContentModelRef& node) {
+				auto click_data = node.getPropertyString(b.mProperty);
+				if (!click_data.empty()) {
+					b.mSprite->getUserData().setString(sprPropToSet, click_data);
+				}
+			};
+
 		} else {
-			DS_LOG_WARNING("SmartLayout::setData() Invalid syntax for prop / model mapping: " << model);
+			binding.mApply = [sprPropToSet](ModelBinding& b, ds::model::ContentModelRef& node) {
+				ds::ui::XmlImporter::setSpriteProperty(*b.mSprite, sprPropToSet, node.getPropertyString(b.mProperty));
+			};
 		}
+
+		mModelBindings.push_back(binding);
 	}
 }
 
-void SmartLayout::applyEachModelToSprite(ds::ui::Sprite* child, const std::string& eachModel) {
+void SmartLayout::compileEachModelToSprite(ds::ui::Sprite* child, const std::string& eachModel) {
 	if (!child) return;
 
 	auto pairy = ds::split(eachModel, ":");
-	if (pairy.size() == 2) {
-
-		auto theNode = mContentModel;
-		if (pairy[1] != "this") {
-			theNode = mContentModel.getChildByName(pairy[1]);
-		}
+	if (pairy.size() != 2) return;
 
-		if (auto smartScroller = dynamic_cast<ds::ui::SmartScrollList*>(child)) {
-			smartScroller->setItemLayoutFile(pairy[0]);
+	const std::string layoutFile = pairy[0];
+	ModelBinding	  binding(child, getBindingNode(pairy[1]), "");
+	binding.mApply = [this, layoutFile](ModelBinding& b, ds::model::ContentModelRef& theNode) {
+		if (auto smartScroller = dynamic_cast<ds::ui::SmartScrollList*>(b.mSprite)) {
+			smartScroller->setItemLayoutFile(layoutFile);
 			smartScroller->setContentList(theNode);
 		} else {
 			if (theNode.getChildren().empty()) return;
 
-			child->clearChildren();
+			b.mSprite->clearChildren();
 
-			int limit = child->getUserData().getInt("each_model_limit", 0, 0);
+			int limit = b.mSprite->getUserData().getInt("each_model_limit", 0, 0);
 			if (limit == 0) limit = -1;
 
 			for (auto baby : theNode.getChildren()) {
 				if(limit-- == 0) break;
 
-				auto babySprite = new ds::ui::SmartLayout(mEngine, pairy[0]);
-				child->addChildPtr(babySprite);
+				auto babySprite = new ds::ui::SmartLayout(mEngine, layoutFile);
+				b.mSprite->addChildPtr(babySprite);
 				babySprite->setContentModel(baby);
-				mNeedsLayout = true;
 			}
+			invalidateLayout();
 		}
-	}
-}
+	};
 
+	mModelBindings.push_back(binding);
+}
 
 void SmartLayout::tryAddChild(const std::string spriteName, std::function<ds::ui::Sprite*(void)> spriteGenerator) {
 	ds::ui::Sprite* spr = getSprite(spriteName);
 	if (spr && spriteGenerator) {
 		spr->addChildPtr(spriteGenerator());
-		mNeedsLayout = true;
+		invalidateLayout();
 	} else {
 		DS_LOG_WARNING("Failed to add child to " << spriteName);
 	}
@@ -394,19 +421,11 @@ void SmartLayout::addSpriteChild(const std::string spriteName, ds::ui::Sprite* n
 	ds::ui::Sprite* spr = getSprite(spriteName);
 	if (spr && newChild) {
 		spr->addChildPtr(newChild);
-		mNeedsLayout = true;
+		invalidateLayout();
 	} else {
 		DS_LOG_WARNING("Failed to add child to " << spriteName);
 	}
 }
 
-void SmartLayout::onUpdateServer(const ds::UpdateParams& p) {
-	if (mNeedsLayout) {
-		runLayout();
-		mNeedsLayout = false;
-	}
-}
-
-
 }  // namespace ui
 }  // namespace ds
@@ -92,6 +92,8 @@ class SmartLayout : public ds::ui::LayoutSprite {
 	///  - model="resource:this->image_resource" for instance will map the "image_resource" property of the set content model to the sprite's resource property
 	///  - You can use any sprite property in the first field
 	///  - The content model set here can be retrieved with getContentModel()
+	///  - The model properties are parsed once, the first time a model is set after loading the layout
+	///  - The layout is run once afterwards. Nested layouts that nothing changed are skipped (see LayoutSprite::runLayout())
 	///  - After all sprites have been set, the callback for setContentUpdatedCallback() is called
 	void setContentModel(ds::model::ContentModelRef& theData);
 
@@ -103,22 +105,42 @@ class SmartLayout : public ds::ui::LayoutSprite {
   protected:
 	using sMap = std::map<std::string, ds::ui::Sprite*>;
 
-	virtual void onUpdateServer(const ds::UpdateParams& p) override;
-
 	bool					   mInitialized;
+	bool					   mBindingsCompiled;
 	std::string				   mLayoutFile;
-	bool					   mNeedsLayout;
 	ds::EventClient			   mEventClient;
 	sMap					   mSpriteMap;
 	ds::model::ContentModelRef mContentModel;
 	std::function<void()>		mContentUpdatedCallback;
 
   private:
-	/// Apply a single model to a given sprite child
-	void applyModelToSprite(ds::ui::Sprite* child, const std::string& childName, const std::string& model);
+	/// One "model" or "each_model" mapping from the layout, parsed into a function that sets it
+	struct ModelBinding {
+		ModelBinding(ds::ui::Sprite* sprite, const size_t node, const std::string& property);
+
+		ds::ui::Sprite*	mSprite;
+		/// Index into mBindingNodes
+		size_t			mNode;
+		/// Empty for mappings that use the whole node, like text_model
+		std::string		mProperty;
+		std::function<void(ModelBinding&, ds::model::ContentModelRef&)> mApply;
+	};
+
+	/// Parses the model and each_model properties of everything in the sprite map
+	void compileModelBindings();
+
+	/// Parses a single model for a given sprite child
+	void compileModelToSprite(ds::ui::Sprite* child, const std::string& childName, const std::string& model);
+
+	/// Parses an each_model, which creates child sprites for each child of a ContentModelRef
+	void compileEachModelToSprite(ds::ui::Sprite* child, const std::string& eachModel);
+
+	/// Returns the index of the node in mBindingNodes, adding it if it's new
+	size_t getBindingNode(const std::string& nodeName);
 
-	/// Creates child sprites for each child of a ContentModelRef
-	void applyEachModelToSprite(ds::ui::Sprite* child, const std::string& eachModel);
+	std::vector<ModelBinding>  mModelBindings;
+	/// The content model nodes the bindings use, by name. "this" is the whole content model
+	std::vector<std::string>   mBindingNodes;
 };
 
 }  // namespace ui
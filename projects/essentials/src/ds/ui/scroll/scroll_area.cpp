@@ -28,6 +28,7 @@ ScrollArea::ScrollArea(ds::ui::SpriteEngine& engine, const float startWidth, con
 	, mScrollPercent(0.0f)
 	, mHandleRotatedTouches(false)
 {
+	setNeedsUpdate(true);
 
 	setSize(startWidth, startHeight);
 	mSpriteMomentum.setMass(8.0f);
@@ -6,6 +6,8 @@
 #include <ds/ui/scroll/scroll_area.h>
 #include <ds/debug/logger.h>
 
+#include <algorithm>
+
 namespace ds{
 namespace ui{
 
@@ -24,6 +26,12 @@ ScrollList::ScrollList(ds::ui::SpriteEngine& engine, const bool vertical)
 	, mTargetRow(0)
 	, mTargetColumn(0)
 	, mMatrixPadding(0)
+	, mItemOrder(kItemsUnordered)
+	, mAssignedBegin(0)
+	, mAssignedEnd(0)
+	, mPrefetchMargin(0.0f)
+	, mVariableSizes(false)
+	, mRelayingOut(false)
 {
 	mScrollArea = new ds::ui::ScrollArea(mEngine, getWidth(), getHeight(), mVerticalScrolling);
 	if(mScrollArea){
@@ -58,8 +66,18 @@ ScrollList::ScrollList(ds::ui::SpriteEngine& engine, const bool vertical)
 void ScrollList::setContent(const std::vector<int>& models){
 	clearItems();
 
+	mItemPlaceHolders.reserve(models.size());
 	for(auto it = models.begin(); it < models.end(); ++it){
 		mItemPlaceHolders.push_back(ItemPlaceHolder((*it)));
+		if(!mItemTemplateCallback || mItemTemplates.empty()) continue;
+
+		const std::string templateName = mItemTemplateCallback((*it));
+		for(size_t i = 0; i < mItemTemplates.size(); ++i){
+			if(mItemTemplates[i].mName == templateName){
+				mItemPlaceHolders.back().mTemplate = static_cast<int>(i + 1);
+				break;
+			}
+		}
 	}
 
 	layout();
@@ -70,10 +88,20 @@ void ScrollList::setContent(const std::vector<int>& models){
 }
 
 void ScrollList::animateItemsOn(){
+	if(!mScrollArea) return;
+
+	// Just the items actually onscreen, prefetched ones don't need to take up a delay
+	const ci::vec2 scrollerPos = mScrollArea->getScrollerPosition();
+	const float offset = mVerticalScrolling ? scrollerPos.y : scrollerPos.x;
+	const float viewSize = mVerticalScrolling ? mScrollArea->getHeight() : mScrollArea->getWidth();
+	size_t begin = 0;
+	size_t end = 0;
+	getItemRange(-offset, viewSize - offset, begin, end);
+
 	float theDelay = mAnimateOnStartDelay;
-	for(auto it = mItemPlaceHolders.begin(), it2 = mItemPlaceHolders.end(); it != it2; ++it){
-		if((*it).mAssociatedSprite){
-			if(mAnimateOnCallback) mAnimateOnCallback((*it).mAssociatedSprite, theDelay);
+	for(size_t i = begin; i < end; ++i){
+		if(mItemPlaceHolders[i].mAssociatedSprite){
+			if(mAnimateOnCallback) mAnimateOnCallback(mItemPlaceHolders[i].mAssociatedSprite, theDelay);
 			theDelay += mAnimateOnDeltaDelay;
 		}
 	}
@@ -83,6 +111,21 @@ void ScrollList::layout(){
 
 	layoutItems();
 
+	// Built in layouts are always in order, but an override of layoutItems() might not be
+	mItemOrder = kItemsUnordered;
+	if(!mItemPlaceHolders.empty()){
+		bool ascending = true;
+		bool descending = true;
+		for(size_t i = 1, count = mItemPlaceHolders.size(); i < count && (ascending || descending); ++i){
+			const float prev = mVerticalScrolling ? mItemPlaceHolders[i - 1].mY : mItemPlaceHolders[i - 1].mX;
+			const float cur = mVerticalScrolling ? mItemPlaceHolders[i].mY : mItemPlaceHolders[i].mX;
+			if(cur < prev) ascending = false;
+			if(cur > prev) descending = false;
+		}
+		if(ascending) mItemOrder = kItemsAscending;
+		else if(descending) mItemOrder = kItemsDescending;
+	}
+
 
 	if(mVerticalScrolling){
 		float scrollyHeight = mScrollableHolder->getHeight();
@@ -127,18 +170,18 @@ void ScrollList::pushItemsTop(){
 		float scrollHeight = mScrollableHolder->getHeight();
 		if(getPerspective()){
 			if(!mItemPlaceHolders.empty() &&
-			   mItemPlaceHolders[0].mY < scrollHeight - mStartPositionY - mIncrementAmount
+			   mItemPlaceHolders[0].mY < scrollHeight - mStartPositionY - getItemExtent(mItemPlaceHolders[0])
 			   ){
-				float delta = scrollHeight - mItemPlaceHolders[0].mY - mStartPositionY - mIncrementAmount;
+				float delta = scrollHeight - mItemPlaceHolders[0].mY - mStartPositionY - getItemExtent(mItemPlaceHolders[0]);
 				for(auto it = mItemPlaceHolders.begin(); it < mItemPlaceHolders.end(); ++it){
 					(*it).mY += delta;
 				}
 			}
 		} else {
 			if(!mItemPlaceHolders.empty() &&
-			   mItemPlaceHolders.back().mY < scrollHeight - mIncrementAmount
+			   mItemPlaceHolders.back().mY < scrollHeight - getItemExtent(mItemPlaceHolders.back())
 			   ){
-				float delta = scrollHeight - mItemPlaceHolders.back().mY - mIncrementAmount;
+				float delta = scrollHeight - mItemPlaceHolders.back().mY - getItemExtent(mItemPlaceHolders.back());
 				for(auto it = mItemPlaceHolders.begin(); it < mItemPlaceHolders.end(); ++it){
 					(*it).mY += delta;
 				}
@@ -285,22 +328,28 @@ void ScrollList::layoutItems(){
 	const bool isPerspective = Sprite::getPerspective();
 	float totalHeight = yp;
 	if (mVerticalScrolling){
-		totalHeight = (float)(mItemPlaceHolders.size()) * mIncrementAmount + mStartPositionY * 2.0f;
-		if(isPerspective) yp = totalHeight - mIncrementAmount - mStartPositionY;
+		totalHeight = mStartPositionY * 2.0f;
+		for(auto it = mItemPlaceHolders.begin(); it < mItemPlaceHolders.end(); ++it){
+			totalHeight += getItemExtent(*it);
+		}
+		if(isPerspective) yp = totalHeight - mStartPositionY;
 	}
 
 	for(auto it = mItemPlaceHolders.begin(); it < mItemPlaceHolders.end(); ++it){
+		const float extent = getItemExtent(*it);
+		if(mVerticalScrolling && isPerspective){
+			yp -= extent;
+		}
+
 		(*it).mX = xp;
 		(*it).mY = yp;
 
 		if(mVerticalScrolling){
-			if(isPerspective){
-				yp -= mIncrementAmount;
-			} else {
-				yp += mIncrementAmount;
+			if(!isPerspective){
+				yp += extent;
 			}
 		} else {
-			xp += mIncrementAmount;
+			xp += extent;
 		}
 	}
 
@@ -317,12 +366,13 @@ void ScrollList::layoutItems(){
 void ScrollList::clearItems(){
 	for(auto it = mItemPlaceHolders.begin(), it2 = mItemPlaceHolders.end(); it != it2; ++it){
 		if(it->mAssociatedSprite){
-			it->mAssociatedSprite->hide();
-			mReserveItems.push_back(it->mAssociatedSprite);
+			releaseItemSprite(*it);
 		}
 	}
 
 	mItemPlaceHolders.clear();
+	mAssignedBegin = 0;
+	mAssignedEnd = 0;
 
 	if(mScrollArea){
 		mScrollArea->setScrollSize(mScrollArea->getWidth(), mScrollArea->getHeight());
@@ -332,79 +382,153 @@ void ScrollList::clearItems(){
 void ScrollList::assignItems(){
 	if(!mScrollArea || !mScrollableHolder) return;
 
-	float y = mScrollArea->getScrollerPosition().y;
-	float x = mScrollArea->getScrollerPosition().x;
-	float scrollHeight = mScrollArea->getHeight();
-	float scrollWidth = mScrollArea->getWidth();
-
+	const ci::vec2 scrollerPos = mScrollArea->getScrollerPosition();
+	const float offset = mVerticalScrolling ? scrollerPos.y : scrollerPos.x;
+	const float viewSize = mVerticalScrolling ? mScrollArea->getHeight() : mScrollArea->getWidth();
 
-	std::vector<int> needsSprite;
+	size_t begin = 0;
+	size_t end = 0;
+	getItemRange(-offset - mPrefetchMargin, viewSize - offset + mPrefetchMargin, begin, end);
 
-	// Look through all the placeholdser and find all the items that should be onscreen
-	// push the offscreen sprites into the reserve vector
-	for(auto it = mItemPlaceHolders.begin(), it2 = mItemPlaceHolders.end(); it != it2; ++it){
-		float itemY = y + it->mY;
-		float itemX = x + it->mX;
-
-		if((mVerticalScrolling && ((itemY + mIncrementAmount > 0.0f) && (itemY < scrollHeight))) ||
-			(!mVerticalScrolling && ((itemX + mIncrementAmount > 0.0f) && (itemX < scrollWidth)))
-			){
-			if(it->mAssociatedSprite){
-				it->mAssociatedSprite->setPosition(it->mX, it->mY);
-			} else {
-				needsSprite.push_back(static_cast<int>(it - mItemPlaceHolders.begin()));
-			}
-		} else {
-			if(it->mAssociatedSprite){
-				mReserveItems.push_back(it->mAssociatedSprite);
-			}
-			it->mAssociatedSprite = nullptr;
+	// Only the items that had sprites last time can have one now, so anything that left the range is in here
+	const size_t oldEnd = std::min(mAssignedEnd, mItemPlaceHolders.size());
+	for(size_t i = mAssignedBegin; i < oldEnd; ++i){
+		if(i >= begin && i < end) continue;
+		if(mItemPlaceHolders[i].mAssociatedSprite){
+			releaseItemSprite(mItemPlaceHolders[i]);
 		}
 	}
+	mAssignedBegin = begin;
+	mAssignedEnd = end;
+
+	bool sizesChanged = false;
+	for(size_t i = begin; i < end; ++i){
+		auto &placeHolder = mItemPlaceHolders[i];
+		if(placeHolder.mAssociatedSprite){
+			placeHolder.mAssociatedSprite->setPosition(placeHolder.mX, placeHolder.mY);
+			continue;
+		}
 
-	// give all the placeholders that need a sprite
-	for(auto it = needsSprite.begin(), it2 = needsSprite.end(); it != it2; ++it){
-		ds::ui::Sprite* sprite = nullptr;
-		if(!mReserveItems.empty()){
-			sprite = mReserveItems.back();
-			mReserveItems.pop_back();
-		} else {
-			if(mCreateItemCallback) sprite = mCreateItemCallback();
-			if(sprite){
-				sprite->setProcessTouchCallback([this](ds::ui::Sprite* sp, const ds::ui::TouchInfo& ti){ handleItemTouchInfo(sp, ti); });
-				sprite->setTapCallback([this, sprite](ds::ui::Sprite* bs, const ci::vec3 cent){
-					Poco::Timestamp::TimeVal nowwwy = Poco::Timestamp().epochMicroseconds();
-					float timeDif = (float)(nowwwy - mLastUpdateTime) / 1000000.0f;
-					if(timeDif < 0.2f){
-						DS_LOG_VERBOSE(2, "Too soon since the last touch to tap this list!");
-						return;
-					}
-					mLastUpdateTime = Poco::Timestamp().epochMicroseconds();
-					if(mItemTappedCallback) mItemTappedCallback(sprite, cent);
-				});
-				mScrollableHolder->addChildPtr(sprite);
-			} else {
-				DS_LOG_WARNING("Didn't create a sprite for scroll list! Use the callback and make sprites when we need them!!");
+		ds::ui::Sprite* sprite = takeItemSprite(placeHolder.mTemplate);
+		if(!sprite) continue;
+
+		if(mSetDataCallback) mSetDataCallback(sprite, placeHolder.mDbId);
+		sprite->setPosition(placeHolder.mX, placeHolder.mY);
+		sprite->show();
+		placeHolder.mAssociatedSprite = sprite;
+
+		if(mVariableSizes){
+			const float itemSize = mVerticalScrolling ? sprite->getHeight() : sprite->getWidth();
+			if(itemSize > 0.0f && itemSize != placeHolder.mSize){
+				placeHolder.mSize = itemSize;
+				sizesChanged = true;
 			}
 		}
+	}
 
-		auto &placeHolder = mItemPlaceHolders[*it];
+	// Newly measured items move everything after them, which can change what's in range
+	if(sizesChanged && !mRelayingOut && !mGridLayout && !mSpecialLayout){
+		mRelayingOut = true;
+		layout();
+		mRelayingOut = false;
+	}
+}
 
-		if(sprite){
+float ScrollList::getItemExtent(const ItemPlaceHolder& item) const {
+	if(mGridLayout){
+		return mVerticalScrolling ? mGridIncrement.y : mGridIncrement.x;
+	}
+	if(mSpecialLayout || !mVariableSizes || item.mSize <= 0.0f){
+		return mIncrementAmount;
+	}
+	return item.mSize;
+}
 
-			if(mSetDataCallback) mSetDataCallback(sprite, placeHolder.mDbId);
-			sprite->setPosition(placeHolder.mX, placeHolder.mY);
-			sprite->show();
-			placeHolder.mAssociatedSprite = sprite;
+void ScrollList::getItemRange(const float minPos, const float maxPos, size_t& outBegin, size_t& outEnd) const {
+	outBegin = 0;
+	outEnd = 0;
+	if(mItemPlaceHolders.empty() || maxPos <= minPos) return;
+
+	const bool vertical = mVerticalScrolling;
+	auto itemPos = [vertical](const ItemPlaceHolder& item){ return vertical ? item.mY : item.mX; };
+	auto beforeMin = [this, &itemPos, minPos](const ItemPlaceHolder& item){ return itemPos(item) + getItemExtent(item) <= minPos; };
+	auto afterMax = [&itemPos, maxPos](const ItemPlaceHolder& item){ return itemPos(item) >= maxPos; };
+
+	if(mItemOrder == kItemsUnordered){
+		bool found = false;
+		for(size_t i = 0, count = mItemPlaceHolders.size(); i < count; ++i){
+			const ItemPlaceHolder& item = mItemPlaceHolders[i];
+			if(beforeMin(item) || afterMax(item)) continue;
+			if(!found) outBegin = i;
+			outEnd = i + 1;
+			found = true;
 		}
+		return;
 	}
 
-	// hide any extras
-	for(auto it = mReserveItems.begin(), it2 = mReserveItems.end(); it != it2; ++it){
-		auto sprite = *it;
-		sprite->hide();
+	// Perspective lists count down from the bottom
+	auto first = mItemPlaceHolders.begin();
+	auto last = mItemPlaceHolders.end();
+	if(mItemOrder == kItemsDescending){
+		auto begin = std::partition_point(first, last, afterMax);
+		auto end = std::partition_point(begin, last, [&beforeMin](const ItemPlaceHolder& item){ return !beforeMin(item); });
+		outBegin = static_cast<size_t>(begin - first);
+		outEnd = static_cast<size_t>(end - first);
+	} else {
+		auto begin = std::partition_point(first, last, beforeMin);
+		auto end = std::partition_point(begin, last, [&afterMax](const ItemPlaceHolder& item){ return !afterMax(item); });
+		outBegin = static_cast<size_t>(begin - first);
+		outEnd = static_cast<size_t>(end - first);
 	}
+}
 
+std::vector<ds::ui::Sprite*>& ScrollList::getReserveItems(const int itemTemplate){
+	if(itemTemplate > 0 && itemTemplate <= static_cast<int>(mItemTemplates.size())){
+		return mItemTemplates[itemTemplate - 1].mReserveItems;
+	}
+	return mReserveItems;
+}
+
+ds::ui::Sprite* ScrollList::takeItemSprite(const int itemTemplate){
+	auto& reserve = getReserveItems(itemTemplate);
+	if(!reserve.empty()){
+		ds::ui::Sprite* sprite = reserve.back();
+		reserve.pop_back();
+		return sprite;
+	}
+
+	ds::ui::Sprite* sprite = nullptr;
+	if(itemTemplate > 0 && itemTemplate <= static_cast<int>(mItemTemplates.size())){
+		if(mItemTemplates[itemTemplate - 1].mCreateCallback) sprite = mItemTemplates[itemTemplate - 1].mCreateCallback();
+	} else if(mCreateItemCallback){
+		sprite = mCreateItemCallback();
+	}
+
+	if(!sprite){
+		DS_LOG_WARNING("Didn't create a sprite for scroll list! Use the callback and make sprites when we need them!!");
+		return nullptr;
+	}
+
+	sprite->setProcessTouchCallback([this](ds::ui::Sprite* sp, const ds::ui::TouchInfo& ti){ handleItemTouchInfo(sp, ti); });
+	sprite->setTapCallback([this, sprite](ds::ui::Sprite* bs, const ci::vec3 cent){
+		Poco::Timestamp::TimeVal nowwwy = Poco::Timestamp().epochMicroseconds();
+		float timeDif = (float)(nowwwy - mLastUpdateTime) / 1000000.0f;
+		if(timeDif < 0.2f){
+			DS_LOG_VERBOSE(2, "Too soon since the last touch to tap this list!");
+			return;
+		}
+		mLastUpdateTime = Poco::Timestamp().epochMicroseconds();
+		if(mItemTappedCallback) mItemTappedCallback(sprite, cent);
+	});
+	mScrollableHolder->addChildPtr(sprite);
+	return sprite;
+}
+
+void ScrollList::releaseItemSprite(ItemPlaceHolder& item){
+	if(!item.mAssociatedSprite) return;
+	item.mAssociatedSprite->hide();
+	getReserveItems(item.mTemplate).push_back(item.mAssociatedSprite);
+	item.mAssociatedSprite = nullptr;
 }
 
 void ScrollList::handleItemTouchInfo(ds::ui::Sprite* bs, const TouchInfo& ti){
@@ -431,6 +555,24 @@ void ScrollList::setCreateItemCallback(const std::function<ds::ui::Sprite*() > &
 	mCreateItemCallback = func;
 }
 
+void ScrollList::setCreateItemCallback(const std::string& templateName, const std::function<ds::ui::Sprite*() > &func){
+	for(auto it = mItemTemplates.begin(); it < mItemTemplates.end(); ++it){
+		if((*it).mName == templateName){
+			(*it).mCreateCallback = func;
+			return;
+		}
+	}
+
+	ItemTemplate itemTemplate;
+	itemTemplate.mName = templateName;
+	itemTemplate.mCreateCallback = func;
+	mItemTemplates.push_back(itemTemplate);
+}
+
+void ScrollList::setItemTemplateCallback(const std::function<std::string(const int dbId)> &func){
+	mItemTemplateCallback = func;
+}
+
 void ScrollList::setDataCallback(const std::function<void(ds::ui::Sprite*, const int dbId) > &func){
 	mSetDataCallback = func;
 }
@@ -454,6 +596,17 @@ void ScrollList::setLayoutParams(const float startPositionX, const float startPo
 	mFillFromTop = fill_from_top;
 }
 
+void ScrollList::setPrefetchMargin(const float margin){
+	mPrefetchMargin = std::max(0.0f, margin);
+	assignItems();
+}
+
+void ScrollList::setVariableItemSizes(const bool variableSizes){
+	if(mVariableSizes == variableSizes) return;
+	mVariableSizes = variableSizes;
+	layout();
+}
+
 void ScrollList::setAnimateOnParams(const float startDelay, const float deltaDelay){
 	mAnimateOnStartDelay = startDelay;
 	mAnimateOnDeltaDelay = deltaDelay;
@@ -461,15 +614,22 @@ void ScrollList::setAnimateOnParams(const float startDelay, const float deltaDel
 
 void ScrollList::forEachLoadedSprite(std::function<void(ds::ui::Sprite*)> func){
 	if(!func) return;
-	for(auto it = mItemPlaceHolders.begin(); it < mItemPlaceHolders.end(); ++it){
-		if((*it).mAssociatedSprite){
-			func((*it).mAssociatedSprite);
+	const size_t end = std::min(mAssignedEnd, mItemPlaceHolders.size());
+	for(size_t i = mAssignedBegin; i < end; ++i){
+		if(mItemPlaceHolders[i].mAssociatedSprite){
+			func(mItemPlaceHolders[i].mAssociatedSprite);
 		}
 	}
 
 	for(auto it = mReserveItems.begin(); it < mReserveItems.end(); ++it){
 		func((*it));
 	}
+
+	for(auto tt = mItemTemplates.begin(); tt < mItemTemplates.end(); ++tt){
+		for(auto it = (*tt).mReserveItems.begin(); it < (*tt).mReserveItems.end(); ++it){
+			func((*it));
+		}
+	}
 }
 
 }
@@ -6,6 +6,8 @@
 
 #include <Poco/Timestamp.h>
 
+#include <string>
+
 namespace ds{
 namespace ui{
 class ScrollArea;
@@ -18,6 +20,9 @@ class ScrollArea;
 	* This assumes that you can refer to your content by integers only, so you may have to keep a map in your super class.
 	*
 	* NOTE: In perspective sprites, the list will fill up from the bottom. If you need to modify this, leave filling from the bottom the default.
+	*
+	* Only the items in view (plus the prefetch margin) have sprites. Those are found with a binary search over the laid-out
+	* positions, so scrolling costs the same for a list of 20 items or 20,000.
 	*/
 
 	class ScrollList : public ds::ui::Sprite {
@@ -32,6 +37,13 @@ class ScrollArea;
 		/// REQUIRED: When we need to create a new sprite, respond with a new sprite of your custom type
 		void						setCreateItemCallback(const std::function<ds::ui::Sprite*() > &func);
 
+		/// OPTIONAL: Create sprites for a named item template. Each template keeps its own pool of spare sprites.
+		/// Use setItemTemplateCallback() to pick the template for each item, anything else uses the callback above.
+		void						setCreateItemCallback(const std::string& templateName, const std::function<ds::ui::Sprite*() > &func);
+
+		/// OPTIONAL: Return the template name for an item. Called from setContent(). Empty or unknown names use the default template
+		void						setItemTemplateCallback(const std::function<std::string(const int dbId)> &func);
+
 		/// REQUIRED: When a sprite needs data assigned (coming onscreen for the first time for example). May need to cast the sprite to your custom type
 		void						setDataCallback(const std::function<void(ds::ui::Sprite*, const int dbId) > &func);
 
@@ -57,6 +69,13 @@ class ScrollArea;
 		/// \param fill_from_top Whether to align to the bottom of the scroll area or the top. For instance, if there's not enough items to fill the whole space, will start filling and align to the bottom if this param is false.
 		void						setLayoutParams(const float startPositionX, const float startPositionY, const float incremenetAmount, const bool fill_from_top = true);
 
+		/// Items within this distance outside the scroll area get their sprites and data early, so they're ready before they scroll on. Default is 0
+		void						setPrefetchMargin(const float margin);
+
+		/// Measure each item after its data is set (height when scrolling vertically, width otherwise) and lay out with that size instead of the increment amount.
+		/// Items that haven't been onscreen yet use the increment amount. Doesn't apply to grid or matrix layouts.
+		void						setVariableItemSizes(const bool variableSizes);
+
 
 		//When mOriginTop==true, shift items to top of scroll list
 		void						pushItemsTop();
@@ -97,6 +116,8 @@ class ScrollArea;
 				: mDbId(dbId)
 				, mX(x)
 				, mY(y)
+				, mSize(0.0f)
+				, mTemplate(0)
 				, mAssociatedSprite(associatedSprite)
 			{
 			};
@@ -104,11 +125,24 @@ class ScrollArea;
 			int							mDbId;
 			float						mX;
 			float						mY;
+			/// Measured size along the scroll direction, 0 until measured
+			float						mSize;
+			/// Index into the item templates, 0 is the default
+			int							mTemplate;
 			ds::ui::Sprite*				mAssociatedSprite;
 		};
 
+		/// A named create callback and its spare sprites
+		struct ItemTemplate {
+			std::string									mName;
+			std::function<ds::ui::Sprite*()>			mCreateCallback;
+			std::vector<ds::ui::Sprite*>				mReserveItems;
+		};
+
 
 		virtual void						onSizeChanged();
+		/// Overrides can put the placeholders anywhere, but getItemRange() is only fast when their positions along
+		/// the scroll direction only ever go up, or only ever go down, from one placeholder to the next.
 		virtual void						layoutItems();
 		virtual void						layoutItemsGrid();
 		virtual void						layoutItemsMatrix();
@@ -118,8 +152,32 @@ class ScrollArea;
 
 		void								handleItemTouchInfo(ds::ui::Sprite* bs, const TouchInfo& ti);
 
+		/// How far an item extends along the scroll direction
+		float								getItemExtent(const ItemPlaceHolder& item) const;
+		/// The placeholders overlapping [minPos, maxPos) along the scroll direction, in the scrollable holder's coordinates.
+		/// A binary search when the layout put the placeholders in order, otherwise a scan that answers the first through
+		/// last overlapping ones (which can include some in between that don't overlap).
+		void								getItemRange(const float minPos, const float maxPos, size_t& outBegin, size_t& outEnd) const;
+		std::vector<ds::ui::Sprite*>&		getReserveItems(const int itemTemplate);
+		/// Pulls a spare sprite for the template, or creates one
+		ds::ui::Sprite*						takeItemSprite(const int itemTemplate);
+		/// Hides the item's sprite and returns it to its template's spares
+		void								releaseItemSprite(ItemPlaceHolder& item);
+
 		std::vector<ItemPlaceHolder>		mItemPlaceHolders;
+		/// Which way the placeholder positions run along the scroll direction, checked after every layout
+		typedef enum { kItemsUnordered = 0, kItemsAscending, kItemsDescending } ItemOrder;
+		ItemOrder							mItemOrder;
 		std::vector<ds::ui::Sprite*>		mReserveItems;
+		/// Named templates, index 0 here is template 1. Template 0 uses mCreateItemCallback and mReserveItems
+		std::vector<ItemTemplate>			mItemTemplates;
+
+		/// The placeholders that were given sprites the last time assignItems() ran
+		size_t								mAssignedBegin;
+		size_t								mAssignedEnd;
+		float								mPrefetchMargin;
+		bool								mVariableSizes;
+		bool								mRelayingOut;
 
 		ds::ui::ScrollArea*					mScrollArea;
 		ds::ui::Sprite*						mScrollableHolder;
@@ -144,6 +202,7 @@ class ScrollArea;
 		std::function<void(ds::ui::Sprite*, const float delay)>		mAnimateOnCallback;
 		std::function<void(ds::ui::Sprite*, const bool highli)>		mStateChangeCallback;
 		std::function<void()>										mScrollUpdatedCallback;
+		std::function<std::string(const int dbId)>					mItemTemplateCallback;
 
 		/// Track update time so touches can't happen while the list is being dragged cause of lazy fingers
 		Poco::Timestamp::TimeVal			mLastUpdateTime;
@@ -20,6 +20,7 @@ PngSequenceSprite::PngSequenceSprite(SpriteEngine& engine, const std::vector<std
 	, mAnimationEndedCallback(nullptr)
 	, mLoadedCallback(nullptr)
 {
+	setNeedsUpdate(true);
 	mLayoutFixedAspect = true;
 	setImages(imageFiles);
 
@@ -39,6 +40,7 @@ PngSequenceSprite::PngSequenceSprite(SpriteEngine& engine)
 	, mFrameTime(0.0f)
 	, mNumFrames(0)
 {
+	setNeedsUpdate(true);
 	mLayoutFixedAspect = true;
 	mLastFrameTime = ci::app::getElapsedSeconds();
 }
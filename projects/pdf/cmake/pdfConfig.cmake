@@ -5,7 +5,10 @@ if( NOT TARGET pdf )
 	list( APPEND PDF_SRC_FILES
 		${PDF_SRC_PATH}/private/pdf_service.cpp
 		${PDF_SRC_PATH}/private/pdf_res.cpp
+		${PDF_SRC_PATH}/private/pdf_render_pool.cpp
+		${PDF_SRC_PATH}/private/pdf_tiler.cpp
 		${PDF_SRC_PATH}/ds/ui/sprite/pdf.cpp
+		${PDF_SRC_PATH}/ds/ui/sprite/pdf_thumbnailer.cpp
 	)
 	add_library( pdf ${PDF_SRC_FILES} )
 
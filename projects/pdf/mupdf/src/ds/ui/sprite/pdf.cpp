@@ -63,6 +63,10 @@ Pdf& Pdf::makePdf(SpriteEngine& e, Sprite* parent) {
 	return makeAlloc<ds::ui::Pdf>([&e]()->ds::ui::Pdf* { return new ds::ui::Pdf(e); }, parent);
 }
 
+ci::Surface8uRef Pdf::renderPage(SpriteEngine& e, const std::string& path) {
+	return ds::pdf::PdfRes::renderPage(e.getService<ds::pdf::Service>("pdf").mPool, path);
+}
+
 ci::Surface8uRef Pdf::renderPage(const std::string& path) {
 	return ds::pdf::PdfRes::renderPage(path);
 }
@@ -74,7 +78,10 @@ Pdf::Pdf(ds::ui::SpriteEngine& e)
 	, mHolder(e)
 	, mPrevScale(0.0f, 0.0f, 0.0f)
 	, mTexture(nullptr)
+	, mTiledRendering(false)
+	, mTileCacheBytes(64 * 1024 * 1024)
 {
+	setNeedsUpdate(true);
 	// Should be unnecessary, but make sure we reference the static.
 	INIT.doNothing();
 	mLayoutFixedAspect = true;
@@ -120,6 +127,8 @@ Pdf& Pdf::setResourceFilename(const std::string& filename) {
 		mErrorCallback(errorStr);
 	}
 	mHolder.setScale(mScale);
+	mHolder.setTiled(mTiledRendering);
+	mHolder.setTileCacheBytes(mTileCacheBytes);
 	setSize(mHolder.getWidth(), mHolder.getHeight());
 	markAsDirty(PDF_FN_DIRTY);
 	return *this;
@@ -153,11 +162,19 @@ void Pdf::onUpdateClient(const UpdateParams& p) {
 		mHolder.setScale(mScale);
 		mPrevScale = mScale;
 	}
+	mHolder.setVisible(visible());
+	if(mTiledRendering) updateTiledView();
 	mHolder.update();
+	if(mTiledRendering) mHolder.uploadTiles();
 }
 
 void Pdf::onUpdateServer(const UpdateParams& p) {
-	if(mHolder.update()) {
+	mHolder.setVisible(visible());
+	if(mTiledRendering) updateTiledView();
+	const bool wasUpdated = mHolder.update();
+	if(mTiledRendering) mHolder.uploadTiles();
+	if(wasUpdated) {
+
 
 		auto theSurface = mHolder.getSurface();
 		if(theSurface) {
@@ -194,6 +211,42 @@ void Pdf::onUpdateServer(const UpdateParams& p) {
 	}
 }
 
+void Pdf::setTiledRendering(const bool tiled) {
+	if(mTiledRendering == tiled) return;
+	mTiledRendering = tiled;
+	mHolder.setTiled(tiled);
+	if(tiled) mTexture = nullptr;
+}
+
+void Pdf::setTileCacheBytes(const size_t maxBytes) {
+	mTileCacheBytes = maxBytes;
+	mHolder.setTileCacheBytes(maxBytes);
+}
+
+void Pdf::updateTiledView() {
+	const float w = getWidth();
+	const float h = getHeight();
+	if(w < 1.0f || h < 1.0f) return;
+
+	// Screen pixels per page point: the accumulated scale of every parent, times the
+	// scale from the world to the window (the src rect drawn into the dst rect)
+	const ci::Rectf& srcRect = mEngine.getSrcRect();
+	const ci::Rectf& dstRect = mEngine.getDstRect();
+	const float worldToScreen = srcRect.getWidth() > 0.0f ? dstRect.getWidth() / srcRect.getWidth() : 1.0f;
+	const ci::mat4& globalTransform = getGlobalTransform();
+	const float zoom = glm::length(ci::vec3(globalTransform[0])) * worldToScreen;
+
+	// The part of the world on screen brought into local space, since rotated parents make this a quad
+	const ci::vec3 corners[4] = {globalToLocal(ci::vec3(srcRect.x1, srcRect.y1, 0.0f)), globalToLocal(ci::vec3(srcRect.x2, srcRect.y1, 0.0f)),
+								 globalToLocal(ci::vec3(srcRect.x1, srcRect.y2, 0.0f)), globalToLocal(ci::vec3(srcRect.x2, srcRect.y2, 0.0f))};
+	ci::Rectf visibleArea(ci::vec2(corners[0]), ci::vec2(corners[0]));
+	for(int i = 1; i < 4; ++i) {
+		visibleArea.include(ci::vec2(corners[i]));
+	}
+
+	mHolder.setVisibleArea(visibleArea.getClipBy(ci::Rectf(0.0f, 0.0f, w, h)), zoom);
+}
+
 void Pdf::setPageNum(const int pageNum) {
 	mHolder.setPageNum(pageNum);
 	markAsDirty(PDF_CURPAGE_DIRTY);
@@ -235,6 +288,11 @@ void Pdf::onScaleChanged() {
 }
 
 void Pdf::drawLocalClient() {
+	if(mTiledRendering) {
+		mHolder.drawTiles();
+		return;
+	}
+
 	if(!mTexture) {
 		return;
 	}
@@ -346,7 +404,7 @@ void Pdf::ResHolder::clear() {
 bool Pdf::ResHolder::setResourceFilename(const std::string& filename) {
 	clear();
 	bool success = false;
-	mRes = new ds::pdf::PdfRes(mService.mThread);
+	mRes = new ds::pdf::PdfRes(mService.mPool);
 	if(mRes) {
 		success = mRes->loadPDF(ds::Environment::expand(filename));
 	}
@@ -383,6 +441,54 @@ void Pdf::ResHolder::setScale(const ci::vec3& scale) {
 	}
 }
 
+void Pdf::ResHolder::setVisible(const bool isVisible) {
+	if(mRes) {
+		mRes->setVisible(isVisible);
+	}
+}
+
+void Pdf::ResHolder::setTiled(const bool isTiled) {
+	if(mRes) {
+		mRes->setTiled(isTiled);
+	}
+}
+
+void Pdf::ResHolder::setTileCacheBytes(const size_t maxBytes) {
+	if(mRes) {
+		mRes->setTileCacheBytes(maxBytes);
+	}
+}
+
+void Pdf::ResHolder::setVisibleArea(const ci::Rectf& area, const float zoom) {
+	if(mRes) {
+		mRes->setVisibleArea(area, zoom);
+	}
+}
+
+void Pdf::ResHolder::uploadTiles() {
+	if(!mRes) return;
+
+	for(auto& tile : mRes->getTiles()) {
+		if(tile->mPixels.empty()) continue;
+
+		auto& pixels = tile->mPixels;
+		ci::Surface8u surface(pixels.mData, pixels.mW, pixels.mH, pixels.mW * 3, ci::SurfaceChannelOrder::RGB);
+		tile->mTexture = ci::gl::Texture2d::create(surface);
+		// The tile still counts its bytes against the cache, they just live on the GPU now
+		pixels.deleteData();
+	}
+}
+
+void Pdf::ResHolder::drawTiles() const {
+	if(!mRes) return;
+
+	for(auto& tile : mRes->getTiles()) {
+		if(!tile->mTexture) continue;
+		ci::gl::ScopedTextureBind texBind(tile->mTexture);
+		ci::gl::drawSolidRect(tile->mPageRect, ci::vec2(0, 0), ci::vec2(1, 1));
+	}
+}
+
 float Pdf::ResHolder::getWidth() const {
 	if(mRes) return mRes->getWidth();
 	return 0.0f;
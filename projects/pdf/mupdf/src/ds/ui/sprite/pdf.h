@@ -51,7 +51,10 @@ public:
 class Pdf : public IPdf {
 public:
 	static Pdf&					makePdf(SpriteEngine&, Sprite* parent = nullptr);
-	// Utility to get a render of the first page of a PDF.
+	// Utility to get a render of the first page of a PDF. Uses the pdf service's render pool, so it shares
+	// its open documents and pages with the sprites.
+	static ci::Surface8uRef		renderPage(SpriteEngine&, const std::string& path);
+	// Same, without an engine. Slower, every call opens its own MuPDF context and the document.
 	static ci::Surface8uRef		renderPage(const std::string& path);
 
 	Pdf(ds::ui::SpriteEngine&);
@@ -103,6 +106,13 @@ public:
 	/** Returns the current texture for the current page (might not exist so use with caution **/
 	ci::gl::TextureRef			getTextureRef() { return mTexture; }
 
+	/** Tiled rendering only rasterizes the part of the page that's on screen, at the resolution it's shown at.
+		Use this for PDFs that get zoomed in on (posters, maps, etc). There's no single page texture while tiled. */
+	void						setTiledRendering(const bool tiled);
+	bool						getTiledRendering() const { return mTiledRendering; }
+	/** The most tile pixel data this sprite keeps around, in bytes. Defaults to 64MB */
+	void						setTileCacheBytes(const size_t maxBytes);
+
 #ifdef _DEBUG
 	virtual void				writeState(std::ostream&, const size_t tab) const;
 #endif
@@ -138,6 +148,13 @@ private:
 		ci::Surface8uRef		getSurface();
 		void					clearSurface();
 		void					setScale(const ci::vec3&);
+		void					setVisible(const bool);
+		void					setTiled(const bool);
+		void					setTileCacheBytes(const size_t);
+		void					setVisibleArea(const ci::Rectf&, const float zoom);
+		/// Creates textures for tiles that finished rendering
+		void					uploadTiles();
+		void					drawTiles() const;
 		float					getWidth() const;
 		float					getHeight() const;
 		void					setPageNum(const int pageNum);
@@ -156,6 +173,11 @@ private:
 
 	ci::gl::TextureRef			mTexture;
 
+	bool						mTiledRendering;
+	size_t						mTileCacheBytes;
+	/// Sends the on-screen part of the page and the current zoom to the tiler
+	void						updateTiledView();
+
 	// For clients to detect scale changes and re-render
 	ci::vec3					mPrevScale;
 
@@ -0,0 +1,187 @@
+#include "stdafx.h"
+
+#include "ds/ui/sprite/pdf_thumbnailer.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+
+#include <cinder/ImageIo.h>
+#include <cinder/Surface.h>
+
+#include <ds/app/environment.h>
+#include <ds/debug/logger.h>
+#include <ds/ui/sprite/sprite_engine.h>
+#include "private/pdf_render_pool.h"
+#include "private/pdf_service.h"
+
+namespace ds {
+namespace pdf {
+
+PdfThumbnailer::PdfThumbnailer(ds::ui::SpriteEngine& eng)
+	: ds::AutoUpdate(eng, AutoUpdateType::SERVER | AutoUpdateType::CLIENT)
+	, mService(eng.getService<ds::pdf::Service>("pdf"))
+	, mCancelled(false)
+	, mFinished(false)
+	, mSucceeded(false)
+{
+}
+
+PdfThumbnailer::~PdfThumbnailer() {
+	cancel();
+}
+
+void PdfThumbnailer::generate(const std::string& pdfPath, const int thumbnailHeight, GeneratedCallback callback) {
+	cancel();
+
+	if(pdfPath.empty() || thumbnailHeight < 1) return;
+
+	mCallback = callback;
+	mCancelled = false;
+	mFinished = false;
+	{
+		std::lock_guard<std::mutex> lock(mResultMutex);
+		mSucceeded = false;
+		mResults.clear();
+	}
+
+	mThread = std::thread([this, pdfPath, thumbnailHeight] { generateThreadFn(pdfPath, thumbnailHeight); });
+}
+
+void PdfThumbnailer::cancel() {
+	mCancelled = true;
+	if(mThread.joinable()) {
+		mThread.join();
+	}
+	mCallback = nullptr;
+}
+
+void PdfThumbnailer::update(const ds::UpdateParams&) {
+	if(!mFinished || !mThread.joinable()) return;
+
+	mThread.join();
+
+	std::vector<ds::Resource> results;
+	bool succeeded = false;
+	{
+		std::lock_guard<std::mutex> lock(mResultMutex);
+		results.swap(mResults);
+		succeeded = mSucceeded;
+	}
+
+	// Clear the callback first, in case it starts another generate
+	GeneratedCallback callback = mCallback;
+	mCallback = nullptr;
+	if(succeeded && callback) {
+		callback(results);
+	}
+}
+
+std::string PdfThumbnailer::hashFileContents(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if(!file.good()) return "";
+
+	uint64_t hash = 14695981039346656037ULL;
+	std::vector<char> buffer(64 * 1024);
+	while(file) {
+		file.read(buffer.data(), buffer.size());
+		const std::streamsize count = file.gcount();
+		for(std::streamsize i = 0; i < count; ++i) {
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return ss.str();
+}
+
+void PdfThumbnailer::generateThreadFn(const std::string& pdfPath, const int thumbnailHeight) {
+	std::vector<ds::Resource>	results;
+	bool						succeeded = false;
+	RenderPool&					pool = mService.mPool;
+
+	int w = 0, h = 0, pageCount = 0;
+	const std::string hash = hashFileContents(pdfPath);
+	if(hash.empty() || !pool.examine(pdfPath, w, h, pageCount)) {
+		DS_LOG_WARNING("PdfThumbnailer couldn't read " << pdfPath);
+	} else {
+		std::stringstream dirStream;
+		dirStream << "%LOCAL%/cache/%PP%/pdf_thumbnails/" << hash << "_" << thumbnailHeight;
+		Poco::Path dir(ds::Environment::expand(dirStream.str()));
+		Poco::File dirFile(dir);
+		if(!dirFile.exists()) dirFile.createDirectories();
+
+		// Pages of the same document are nearly always the same size, so scale off the first one
+		const float scale = static_cast<float>(thumbnailHeight) / static_cast<float>(h);
+
+		// Queue every missing page up front, so the pool can spread them over its workers
+		std::vector<std::string> paths(pageCount);
+		std::vector<RenderPool::RequestRef> requests(pageCount);
+		for(int i = 0; i < pageCount; ++i) {
+			Poco::Path pagePath(dir);
+			pagePath.append("page_" + std::to_string(i + 1) + ".png");
+			paths[i] = pagePath.toString();
+			if(!Poco::File(paths[i]).exists()) {
+				requests[i] = pool.render(pdfPath, i + 1, scale, RenderPool::kPriorityPrefetch);
+			}
+		}
+
+		succeeded = true;
+		for(int i = 0; i < pageCount; ++i) {
+			if(mCancelled) {
+				succeeded = false;
+				break;
+			}
+
+			auto& request = requests[i];
+			if(request) {
+				// Wake up now and then to notice a cancel
+				while(!mCancelled && !pool.waitFor(request, 50)) {}
+				if(mCancelled) {
+					succeeded = false;
+					break;
+				}
+
+				if(!request->mSuccess) {
+					DS_LOG_WARNING("PdfThumbnailer couldn't render page " << (i + 1) << " of " << pdfPath);
+					succeeded = false;
+					break;
+				}
+
+				auto& pixels = request->mPixels;
+				try {
+					ci::Surface8u surface(pixels.mData, pixels.mW, pixels.mH, pixels.mW * 3, ci::SurfaceChannelOrder::RGB);
+					ci::writeImage(paths[i], surface);
+				} catch(std::exception& e) {
+					DS_LOG_WARNING("PdfThumbnailer couldn't write " << paths[i] << ": " << e.what());
+					succeeded = false;
+					break;
+				}
+				request = nullptr;
+			}
+
+			ds::Resource thumb(paths[i], ds::Resource::IMAGE_TYPE);
+			thumb.setParentIndex(i + 1);
+			results.push_back(thumb);
+		}
+
+		for(auto& it : requests) {
+			if(it) it->cancel();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mResultMutex);
+		mResults.swap(results);
+		mSucceeded = succeeded;
+	}
+	mFinished = true;
+}
+
+} // namespace pdf
+} // namespace ds
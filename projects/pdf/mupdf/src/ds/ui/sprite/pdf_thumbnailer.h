@@ -0,0 +1,64 @@
+#pragma once
+#ifndef DS_UI_SPRITE_PDF_THUMBNAILER_H_
+#define DS_UI_SPRITE_PDF_THUMBNAILER_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ds/app/auto_update.h>
+#include <ds/data/resource.h>
+
+namespace ds {
+namespace pdf {
+class Service;
+
+/**
+* \class ds::pdf::PdfThumbnailer
+*			Generates a low-res image of every page of a PDF in the background, using the pdf service's render pool
+*			at prefetch priority. Thumbnails are written as png's to %LOCAL%/cache/%PP%/pdf_thumbnails/<content hash>/,
+*			so a document that's already been seen (even under another name) loads straight from disk.
+*			The results are image Resources with the parentIndex set to the page number, which is what ThumbnailBar expects.
+*/
+class PdfThumbnailer : public ds::AutoUpdate {
+public:
+	typedef std::function<void(const std::vector<ds::Resource>& thumbnails)> GeneratedCallback;
+
+	PdfThumbnailer(ds::ui::SpriteEngine&);
+	~PdfThumbnailer();
+
+	/// Starts generating thumbnails for the pdf at the given height in pixels. Cancels any previous generate.
+	/// The callback happens in the update cycle, and only if everything was generated or loaded from the cache.
+	void						generate(const std::string& pdfPath, const int thumbnailHeight, GeneratedCallback callback);
+	/// Stops any generation in progress. The callback won't be called.
+	void						cancel();
+
+	bool						isGenerating() const { return mThread.joinable() && !mFinished; }
+
+	/// Hex string of a 64-bit FNV-1a hash of the file's contents, empty if the file can't be read
+	static std::string			hashFileContents(const std::string& path);
+
+protected:
+	virtual void				update(const ds::UpdateParams&) override;
+
+private:
+	void						generateThreadFn(const std::string& pdfPath, const int thumbnailHeight);
+
+	ds::pdf::Service&			mService;
+	std::thread					mThread;
+	std::atomic<bool>			mCancelled;
+	std::atomic<bool>			mFinished;
+
+	std::mutex					mResultMutex;
+	bool						mSucceeded;
+	std::vector<ds::Resource>	mResults;
+	GeneratedCallback			mCallback;
+};
+
+} // namespace pdf
+} // namespace ds
+
+#endif // DS_UI_SPRITE_PDF_THUMBNAILER_H_
@@ -0,0 +1,589 @@
+#include "stdafx.h"
+
+#include "private/pdf_render_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <ds/debug/logger.h>
+#include <ds/util/string_util.h>
+
+extern "C" {
+#include "mupdf/fitz.h"
+#include "mupdf/pdf.h"
+}
+
+namespace ds {
+namespace pdf {
+
+namespace {
+
+static_assert(FZ_LOCK_MAX <= 4, "RenderPool needs more MuPDF lock mutexes");
+
+void lockMutex(void* user, int lock) {
+	static_cast<std::mutex*>(user)[lock].lock();
+}
+
+void unlockMutex(void* user, int lock) {
+	static_cast<std::mutex*>(user)[lock].unlock();
+}
+
+// Pages larger than this are refused, to avoid a memory overload
+const int		MAX_RENDER_SIZE = 12000;
+
+void loadLinks(fz_context& ctx, fz_page& page, const float pageW, const float pageH, std::vector<PdfLinkInfo>& outLinks) {
+	outLinks.clear();
+	fz_link*	links = fz_load_links(&ctx, &page);
+	for(fz_link* linky = links; linky; linky = linky->next) {
+		if(!linky->uri) continue;
+
+		ds::pdf::PdfLinkInfo this_link;
+		this_link.mRawUri = linky->uri;
+		this_link.mRect = ci::Rectf(linky->rect.x0 / pageW, linky->rect.y0 / pageH, linky->rect.x1 / pageW, linky->rect.y1 / pageH);
+
+		if(this_link.mRawUri.find("#") == 0) {
+			auto pageNum = this_link.mRawUri.substr(1);
+			auto findy = pageNum.find(",");
+			if(findy != std::string::npos) {
+				pageNum = pageNum.substr(0, findy);
+				this_link.mPageDest = ds::string_to_int(pageNum);
+			}
+		} else {
+			this_link.mUrl = this_link.mRawUri;
+		}
+
+		outLinks.emplace_back(this_link);
+	}
+	if(links) fz_drop_link(&ctx, links);
+}
+
+}
+
+/**
+ * \class ds::pdf::RenderPool
+ */
+RenderPool::RenderPool()
+	: mLocksContext(new fz_locks_context())
+	, mMasterContext(nullptr)
+	, mExamineContext(nullptr)
+	, mShouldQuit(false)
+	, mNextSequence(0)
+	, mMaxDocuments(8)
+	, mMaxPages(48)
+{
+	mLocksContext->user = mLocks;
+	mLocksContext->lock = lockMutex;
+	mLocksContext->unlock = unlockMutex;
+
+	mMasterContext = fz_new_context(NULL, mLocksContext.get(), FZ_STORE_DEFAULT);
+	if(!mMasterContext) {
+		DS_LOG_WARNING("RenderPool: couldn't create the MuPDF context, PDFs will not render.");
+		return;
+	}
+
+	fz_register_document_handlers(mMasterContext);
+	mExamineContext = fz_clone_context(mMasterContext);
+}
+
+RenderPool::~RenderPool() {
+	stop();
+	clearCache();
+
+	if(mExamineContext) {
+		fz_drop_context(mExamineContext);
+		mExamineContext = nullptr;
+	}
+
+	if(mMasterContext) {
+		fz_drop_context(mMasterContext);
+		mMasterContext = nullptr;
+	}
+}
+
+void RenderPool::start(const int requestedThreads) {
+	stop();
+	if(!mMasterContext) return;
+
+	int numThreads = requestedThreads;
+	if(numThreads < 1) numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for(int i = 0; i < numThreads; ++i) {
+		fz_context*		ctx = nullptr;
+		{
+			std::lock_guard<std::mutex>	l(mMasterMutex);
+			ctx = fz_clone_context(mMasterContext);
+		}
+		if(!ctx) {
+			DS_LOG_WARNING("RenderPool: couldn't clone a MuPDF context, running with " << mThreads.size() << " threads.");
+			break;
+		}
+
+		mThreads.emplace_back([this, ctx]() { workerThreadFn(ctx); });
+	}
+}
+
+void RenderPool::stop() {
+	{
+		std::lock_guard<std::mutex>	l(mQueueMutex);
+		mShouldQuit = true;
+	}
+	mQueueCondition.notify_all();
+
+	for(auto& it : mThreads) {
+		it.join();
+	}
+	mThreads.clear();
+
+	std::vector<RequestRef>			leftovers;
+	{
+		std::lock_guard<std::mutex>	l(mQueueMutex);
+		leftovers.swap(mQueue);
+		mShouldQuit = false;
+	}
+	for(auto& it : leftovers) {
+		finish(*it, false);
+	}
+}
+
+RenderPool::RequestRef RenderPool::render(const std::string& fileName, const int pageNum, const float scale, const int priority) {
+	return renderArea(fileName, pageNum, scale, ci::Area(), priority);
+}
+
+RenderPool::RequestRef RenderPool::renderArea(const std::string& fileName, const int pageNum, const float scale, const ci::Area& area, const int priority) {
+	auto request = std::make_shared<Request>(fileName, pageNum, scale, area, priority);
+	if(mThreads.empty()) {
+		finish(*request, false);
+		return request;
+	}
+
+	{
+		std::lock_guard<std::mutex>	l(mQueueMutex);
+		request->mSequence = mNextSequence++;
+		mQueue.push_back(request);
+	}
+	mQueueCondition.notify_one();
+	return request;
+}
+
+bool RenderPool::examine(const std::string& fileName, int& outWidth, int& outHeight, int& outPageCount) {
+	if(!mExamineContext) return false;
+
+	std::lock_guard<std::mutex>		l(mExamineMutex);
+	PageRef							page = acquirePage(*mExamineContext, fileName, 1);
+	if(!page) return false;
+
+	DocumentRef						doc = acquireDocument(*mExamineContext, fileName);
+	if(!doc) return false;
+
+	outWidth = page->mPageSize.x;
+	outHeight = page->mPageSize.y;
+	outPageCount = doc->mPageCount;
+	return outWidth > 0 && outHeight > 0 && outPageCount > 0;
+}
+
+void RenderPool::setCacheSizes(const size_t maxDocuments, const size_t maxPages) {
+	std::vector<DocumentRef>		droppedDocs;
+	std::vector<PageRef>			droppedPages;
+	{
+		std::lock_guard<std::mutex>	l(mCacheMutex);
+		mMaxDocuments = std::max<size_t>(1, maxDocuments);
+		mMaxPages = std::max<size_t>(1, maxPages);
+		while(mDocuments.size() > mMaxDocuments) {
+			droppedDocs.push_back(mDocuments.back());
+			mDocuments.pop_back();
+		}
+		while(mPages.size() > mMaxPages) {
+			droppedPages.push_back(mPages.back());
+			mPages.pop_back();
+		}
+	}
+	// Released outside the cache lock, since dropping takes the master lock
+}
+
+void RenderPool::clearCache() {
+	std::list<DocumentRef>			droppedDocs;
+	std::list<PageRef>				droppedPages;
+	{
+		std::lock_guard<std::mutex>	l(mCacheMutex);
+		droppedDocs.swap(mDocuments);
+		droppedPages.swap(mPages);
+	}
+}
+
+RenderPool::Stats RenderPool::getStats() const {
+	std::lock_guard<std::mutex>		l(mCacheMutex);
+	return mStats;
+}
+
+void RenderPool::workerThreadFn(fz_context* ctx) {
+	while(true) {
+		RequestRef		request = popRequest();
+		if(!request) break;
+
+		request->mStarted = true;
+		if(request->isCancelled()) {
+			finish(*request, false);
+			continue;
+		}
+
+		bool			success = false;
+		PageRef			page = acquirePage(*ctx, request->mFileName, request->mPageNum);
+		if(page && !request->isCancelled()) {
+			const auto	startTime = std::chrono::high_resolution_clock::now();
+			success = rasterize(*ctx, *page, *request);
+			const auto	endTime = std::chrono::high_resolution_clock::now();
+
+			if(success) {
+				std::lock_guard<std::mutex>	l(mCacheMutex);
+				mStats.mPagesRendered++;
+				mStats.mRasterSeconds += std::chrono::duration<double>(endTime - startTime).count();
+			}
+		}
+
+		// Make sure any page this thread was the last to hold is freed before finishing
+		page = nullptr;
+		finish(*request, success);
+	}
+
+	{
+		std::lock_guard<std::mutex>	l(mMasterMutex);
+		fz_drop_context(ctx);
+	}
+}
+
+RenderPool::RequestRef RenderPool::popRequest() {
+	std::unique_lock<std::mutex>	l(mQueueMutex);
+	mQueueCondition.wait(l, [this] { return mShouldQuit || !mQueue.empty(); });
+	if(mShouldQuit) return nullptr;
+
+	auto best = mQueue.begin();
+	for(auto it = mQueue.begin(); it < mQueue.end(); ++it) {
+		if((*it)->mPriority > (*best)->mPriority
+		   || ((*it)->mPriority == (*best)->mPriority && (*it)->mSequence < (*best)->mSequence)) {
+			best = it;
+		}
+	}
+
+	RequestRef						ans = *best;
+	mQueue.erase(best);
+	return ans;
+}
+
+void RenderPool::finish(Request& request, const bool success) {
+	{
+		std::lock_guard<std::mutex>	l(mQueueMutex);
+		request.mSuccess = success;
+		request.mDone = true;
+	}
+	mDoneCondition.notify_all();
+}
+
+bool RenderPool::waitFor(const RequestRef& request, const int timeoutMs) {
+	if(!request) return false;
+	std::unique_lock<std::mutex>	l(mQueueMutex);
+	return mDoneCondition.wait_for(l, std::chrono::milliseconds(timeoutMs), [&request] { return request->isDone(); });
+}
+
+RenderPool::DocumentRef RenderPool::acquireDocument(fz_context& ctx, const std::string& fileName) {
+	{
+		std::lock_guard<std::mutex>	l(mCacheMutex);
+		for(auto it = mDocuments.begin(); it != mDocuments.end(); ++it) {
+			if((*it)->mFileName == fileName) {
+				mStats.mDocumentHits++;
+				mDocuments.splice(mDocuments.begin(), mDocuments, it);
+				return mDocuments.front();
+			}
+		}
+		mStats.mDocumentMisses++;
+	}
+
+	// Open outside the cache lock, the open can be slow for large documents
+	DocumentRef						doc(new Document(), [this](Document* d) { dropDocument(d); });
+	doc->mFileName = fileName;
+
+	// This is pretty ugly because MuPDF uses custom C++-like error handing that
+	// has stringent rules, like you're not allowed to return.
+	fz_try((&ctx)) {
+		doc->mDoc = fz_open_document(&ctx, fileName.c_str());
+		if(doc->mDoc) {
+			doc->mPageCount = fz_count_pages(&ctx, doc->mDoc);
+		}
+	}
+	fz_catch((&ctx)) {
+		DS_LOG_WARNING("RenderPool: couldn't open \"" << fileName << "\": " << fz_caught_message(&ctx));
+	}
+
+	if(!doc->mDoc || doc->mPageCount < 1) return nullptr;
+
+	std::vector<DocumentRef>		dropped;
+	std::lock_guard<std::mutex>		l(mCacheMutex);
+	// Another thread may have opened the same file in the meantime
+	for(auto& it : mDocuments) {
+		if(it->mFileName == fileName) {
+			dropped.push_back(doc);
+			return it;
+		}
+	}
+	mDocuments.push_front(doc);
+	while(mDocuments.size() > mMaxDocuments) {
+		dropped.push_back(mDocuments.back());
+		mDocuments.pop_back();
+	}
+	return doc;
+}
+
+RenderPool::PageRef RenderPool::acquirePage(fz_context& ctx, const std::string& fileName, const int pageNum) {
+	{
+		std::lock_guard<std::mutex>	l(mCacheMutex);
+		for(auto it = mPages.begin(); it != mPages.end(); ++it) {
+			if((*it)->mPageNum == pageNum && (*it)->mFileName == fileName) {
+				mStats.mPageHits++;
+				mPages.splice(mPages.begin(), mPages, it);
+				return mPages.front();
+			}
+		}
+		mStats.mPageMisses++;
+	}
+
+	DocumentRef						doc = acquireDocument(ctx, fileName);
+	if(!doc || pageNum < 1 || pageNum > doc->mPageCount) return nullptr;
+
+	PageRef							page(new Page(), [this](Page* p) { dropPage(p); });
+	page->mFileName = fileName;
+	page->mPageNum = pageNum;
+
+	{
+		std::lock_guard<std::mutex>	docLock(doc->mMutex);
+		fz_page*					fzPage = nullptr;
+		fz_try((&ctx)) {
+			fzPage = fz_load_page(&ctx, doc->mDoc, pageNum - 1);
+
+			fz_rect					bounds;
+			fz_bound_page(&ctx, fzPage, &bounds);
+			if(!fz_is_empty_rect(&bounds) && !fz_is_infinite_rect(&bounds)) {
+				page->mPageSize.x = static_cast<int>(ceilf(bounds.x1 - bounds.x0));
+				page->mPageSize.y = static_cast<int>(ceilf(bounds.y1 - bounds.y0));
+			}
+
+			if(page->mPageSize.x > 0 && page->mPageSize.y > 0) {
+				loadLinks(ctx, *fzPage, static_cast<float>(page->mPageSize.x), static_cast<float>(page->mPageSize.y), page->mLinks);
+				// The display list is thread safe to run, so after this the document isn't needed to rasterize
+				page->mList = fz_new_display_list_from_page(&ctx, fzPage);
+			}
+		}
+		fz_always((&ctx)) {
+			if(fzPage) fz_drop_page(&ctx, fzPage);
+		}
+		fz_catch((&ctx)) {
+			DS_LOG_WARNING("RenderPool: couldn't load page " << pageNum << " of \"" << fileName << "\": " << fz_caught_message(&ctx));
+		}
+	}
+
+	if(!page->mList) return nullptr;
+
+	std::vector<PageRef>			dropped;
+	std::lock_guard<std::mutex>		l(mCacheMutex);
+	for(auto& it : mPages) {
+		if(it->mPageNum == pageNum && it->mFileName == fileName) {
+			dropped.push_back(page);
+			return it;
+		}
+	}
+	mPages.push_front(page);
+	while(mPages.size() > mMaxPages) {
+		dropped.push_back(mPages.back());
+		mPages.pop_back();
+	}
+	return page;
+}
+
+bool RenderPool::rasterize(fz_context& ctx, Page& page, Request& request) {
+	// Whole page renders are sized from the page, tiles from their area
+	fz_irect						bbox;
+	if(request.mArea.getWidth() > 0 && request.mArea.getHeight() > 0) {
+		bbox.x0 = request.mArea.x1;
+		bbox.y0 = request.mArea.y1;
+		bbox.x1 = request.mArea.x2;
+		bbox.y1 = request.mArea.y2;
+	} else {
+		bbox.x0 = 0;
+		bbox.y0 = 0;
+		bbox.x1 = std::max(1, static_cast<int>(static_cast<float>(page.mPageSize.x) * request.mScale));
+		bbox.y1 = std::max(1, static_cast<int>(static_cast<float>(page.mPageSize.y) * request.mScale));
+	}
+
+	const int w = bbox.x1 - bbox.x0;
+	const int h = bbox.y1 - bbox.y0;
+	if(w > MAX_RENDER_SIZE || h > MAX_RENDER_SIZE) {
+		DS_LOG_WARNING("Aborting RenderPool render due to too large of a size of a pdf w/h: " << w << " " << h);
+		return false;
+	}
+
+	if(!request.mPixels.setSize(w, h)) return false;
+
+	bool							ans = false;
+	fz_pixmap*						pixmap = nullptr;
+	fz_device*						device = nullptr;
+	fz_try((&ctx)) {
+		// Whole pages keep the exact pixel width, tiles need the exact pyramid scale so neighbours line up
+		const float					zoom = (request.mArea.getWidth() > 0) ? request.mScale : static_cast<float>(w) / static_cast<float>(page.mPageSize.x);
+		fz_matrix					transform = fz_identity;
+		fz_scale(&transform, zoom, zoom);
+
+		// Only run the parts of the display list that land in this area
+		fz_rect						area;
+		fz_rect_from_irect(&area, &bbox);
+		fz_matrix					inverse;
+		fz_invert_matrix(&inverse, &transform);
+		fz_transform_rect(&area, &inverse);
+
+		pixmap = fz_new_pixmap_with_bbox_and_data(&ctx, fz_device_rgb(&ctx), &bbox, 0, request.mPixels.mData);
+		fz_clear_pixmap_with_value(&ctx, pixmap, 0xff);
+		device = fz_new_draw_device(&ctx, &transform, pixmap);
+		fz_run_display_list(&ctx, page.mList, device, &fz_identity, &area, NULL);
+		fz_close_device(&ctx, device);
+		ans = true;
+	}
+	fz_always((&ctx)) {
+		if(device) fz_drop_device(&ctx, device);
+		if(pixmap) fz_drop_pixmap(&ctx, pixmap);
+	}
+	fz_catch((&ctx)) {
+		DS_LOG_WARNING("RenderPool: render page error: " << fz_caught_message(&ctx));
+		ans = false;
+	}
+
+	if(ans) {
+		request.mPageSize = page.mPageSize;
+		request.mLinks = page.mLinks;
+	}
+	return ans;
+}
+
+void RenderPool::dropDocument(Document* doc) {
+	if(!doc) return;
+	if(doc->mDoc) {
+		std::lock_guard<std::mutex>	l(mMasterMutex);
+		fz_drop_document(mMasterContext, doc->mDoc);
+	}
+	delete doc;
+}
+
+void RenderPool::dropPage(Page* page) {
+	if(!page) return;
+	if(page->mList) {
+		std::lock_guard<std::mutex>	l(mMasterMutex);
+		fz_drop_display_list(mMasterContext, page->mList);
+	}
+	delete page;
+}
+
+/**
+ * \class ds::pdf::RenderPool::Request
+ */
+RenderPool::Request::Request(const std::string& fileName, const int pageNum, const float scale, const ci::Area& area, const int priority)
+	: mFileName(fileName)
+	, mPageNum(pageNum)
+	, mScale(scale)
+	, mArea(area)
+	, mPriority(priority)
+	, mSuccess(false)
+	, mPageSize(0, 0)
+	, mDone(false)
+	, mCancelled(false)
+	, mStarted(false)
+	, mSequence(0)
+{
+}
+
+/**
+ * \class ds::pdf::RenderPool::Stats
+ */
+RenderPool::Stats::Stats()
+	: mPagesRendered(0)
+	, mRasterSeconds(0.0)
+	, mDocumentHits(0)
+	, mDocumentMisses(0)
+	, mPageHits(0)
+	, mPageMisses(0)
+{
+}
+
+/**
+ * \class ds::pdf::RenderPool::Document
+ */
+RenderPool::Document::Document()
+	: mDoc(nullptr)
+	, mPageCount(0)
+{
+}
+
+/**
+ * \class ds::pdf::RenderPool::Page
+ */
+RenderPool::Page::Page()
+	: mPageNum(0)
+	, mList(nullptr)
+	, mPageSize(0, 0)
+{
+}
+
+/**
+ * \class ds::pdf::PdfPixels
+ */
+PdfPixels::PdfPixels()
+	: mData(nullptr)
+	, mDataSize(0)
+	, mW(0)
+	, mH(0)
+{
+}
+
+PdfPixels::~PdfPixels() {
+	deleteData();
+}
+
+bool PdfPixels::empty() const {
+	return mW < 1 || mH < 1 || !mData;
+}
+
+bool PdfPixels::setSize(const int w, const int h) {
+	if(mW == w && mH == h && mData) return true;
+
+	deleteData();
+
+	if(w > 0 && h > 0) {
+		mDataSize = (w * h) * 3;
+		mData = new unsigned char[mDataSize];
+	}
+	if(!mData) return false;
+	mW = w;
+	mH = h;
+	return true;
+}
+
+void PdfPixels::clearPixels() {
+	if(mW < 1 || mH < 1 || !mData) return;
+	memset(mData, 0, mDataSize);
+}
+
+void PdfPixels::deleteData() {
+	if(mData) {
+		delete[] mData;
+		mData = nullptr;
+	}
+
+	mDataSize = 0;
+	mW = 0;
+	mH = 0;
+}
+
+void PdfPixels::swap(PdfPixels& o) {
+	std::swap(mData, o.mData);
+	std::swap(mDataSize, o.mDataSize);
+	std::swap(mW, o.mW);
+	std::swap(mH, o.mH);
+}
+
+} // namespace pdf
+} // namespace ds
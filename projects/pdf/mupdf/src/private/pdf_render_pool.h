@@ -0,0 +1,202 @@
+#pragma once
+#ifndef PRIVATE_PDFRENDERPOOL_H_
+#define PRIVATE_PDFRENDERPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ds/ui/sprite/pdf_link.h>
+
+// Opaque MuPDF types, so clients of the pool don't need the fitz headers
+struct fz_context_s;
+struct fz_locks_context_s;
+struct fz_document_s;
+struct fz_display_list_s;
+
+namespace ds {
+namespace pdf {
+
+/**
+ * \class ds::pdf::PdfPixels
+ * \brief Rasterized pixel data, color space is RGB, 8 bits per channel.
+ */
+struct PdfPixels {
+	PdfPixels();
+	~PdfPixels();
+
+	bool				empty() const;
+	bool				setSize(const int w, const int h);
+	void				clearPixels();
+	void				deleteData();
+	void				swap(PdfPixels&);
+	unsigned char*		mData;
+	int					mDataSize;
+	int					mW, mH;
+
+private:
+	PdfPixels(const PdfPixels&);
+	PdfPixels&			operator=(const PdfPixels&);
+};
+
+/**
+ * \class ds::pdf::RenderPool
+ * \brief A pool of worker threads that rasterize PDF pages.
+ * Each worker owns a clone of a single master fz_context (sharing the
+ * MuPDF store and glyph cache through the pool's locks). Open documents
+ * and parsed pages (as display lists) are kept in small LRU caches, so
+ * flipping pages or showing the same document in several sprites only
+ * pays the document open and page parse once.
+ * Requests are popped highest priority first, FIFO within a priority.
+ */
+class RenderPool {
+public:
+	/// Higher priorities are always rendered first
+	static const int			kPriorityPrefetch = 0;
+	static const int			kPriorityBackground = 1;
+	static const int			kPriorityVisible = 2;
+
+	/// A single rasterization job. The client holds on to the shared pointer
+	/// and polls isDone() from the main thread. If the client goes away before
+	/// the job finishes, the worker just renders into a buffer nobody reads.
+	class Request {
+	public:
+		Request(const std::string& fileName, const int pageNum, const float scale, const ci::Area& area, const int priority);
+
+		bool						isDone() const { return mDone; }
+		bool						isCancelled() const { return mCancelled; }
+		/// A worker has picked the job up, so cancelling it won't save any work
+		bool						isStarted() const { return mStarted; }
+		/// Skips the job if it hasn't started yet. Done will still be set.
+		void						cancel() { mCancelled = true; }
+
+		const std::string			mFileName;
+		const int					mPageNum;
+		const float					mScale;
+		/// The region to render, in pixels at mScale. Empty renders the whole page.
+		const ci::Area				mArea;
+		const int					mPriority;
+
+		/// Outputs, only valid once isDone() returns true
+		bool						mSuccess;
+		PdfPixels					mPixels;
+		ci::ivec2					mPageSize;
+		std::vector<PdfLinkInfo>	mLinks;
+
+	private:
+		friend class RenderPool;
+		std::atomic<bool>			mDone;
+		std::atomic<bool>			mCancelled;
+		std::atomic<bool>			mStarted;
+		size_t						mSequence;
+	};
+	typedef std::shared_ptr<Request> RequestRef;
+
+	struct Stats {
+		Stats();
+		size_t						mPagesRendered;
+		double						mRasterSeconds;
+		size_t						mDocumentHits, mDocumentMisses;
+		size_t						mPageHits, mPageMisses;
+	};
+
+	RenderPool();
+	~RenderPool();
+
+	/// Starts (or restarts) the workers. numThreads < 1 uses the hardware concurrency.
+	void						start(const int numThreads);
+	/// Stops all workers. Any requests still queued are marked done and unsuccessful.
+	void						stop();
+	size_t						getNumThreads() const { return mThreads.size(); }
+
+	/// Queue a render of the page (1-indexed) at the supplied scale.
+	RequestRef					render(const std::string& fileName, const int pageNum, const float scale, const int priority);
+	/// Queue a render of part of the page, area is in pixels at the supplied scale.
+	RequestRef					renderArea(const std::string& fileName, const int pageNum, const float scale, const ci::Area& area, const int priority);
+
+	/// Blocks the calling thread until the request finishes or the timeout passes. Returns true if it finished.
+	/// Don't call this from the main thread.
+	bool						waitFor(const RequestRef&, const int timeoutMs);
+
+	/// Synchronously get the size of the first page and the page count. Warms the document cache.
+	bool						examine(const std::string& fileName, int& outWidth, int& outHeight, int& outPageCount);
+
+	/// The number of documents and parsed pages to keep open
+	void						setCacheSizes(const size_t maxDocuments, const size_t maxPages);
+	/// Closes every cached document and page, for instance after a file changes on disk.
+	void						clearCache();
+
+	Stats						getStats() const;
+
+private:
+	struct Document {
+		Document();
+		std::string					mFileName;
+		fz_document_s*				mDoc;
+		int							mPageCount;
+		/// MuPDF documents can only be used by one thread at a time
+		std::mutex					mMutex;
+	};
+	typedef std::shared_ptr<Document> DocumentRef;
+
+	struct Page {
+		Page();
+		std::string					mFileName;
+		int							mPageNum;
+		fz_display_list_s*			mList;
+		ci::ivec2					mPageSize;
+		std::vector<PdfLinkInfo>	mLinks;
+	};
+	typedef std::shared_ptr<Page> PageRef;
+
+	RenderPool(const RenderPool&);
+	RenderPool&					operator=(const RenderPool&);
+
+	void						workerThreadFn(fz_context_s*);
+	RequestRef					popRequest();
+	void						finish(Request&, const bool success);
+
+	DocumentRef					acquireDocument(fz_context_s&, const std::string& fileName);
+	PageRef						acquirePage(fz_context_s&, const std::string& fileName, const int pageNum);
+	bool						rasterize(fz_context_s&, Page&, Request&);
+
+	/// Destroying cached objects happens on whatever thread drops the last
+	/// reference, so they're freed through the master context under its lock.
+	void						dropDocument(Document*);
+	void						dropPage(Page*);
+
+	/// MuPDF keeps a pointer to the locks, so they live as long as the pool
+	std::mutex					mLocks[4];
+	std::unique_ptr<fz_locks_context_s>	mLocksContext;
+	fz_context_s*				mMasterContext;
+	std::mutex					mMasterMutex;
+	/// A clone reserved for synchronous examine() calls from the main thread
+	fz_context_s*				mExamineContext;
+	std::mutex					mExamineMutex;
+
+	std::vector<std::thread>	mThreads;
+	bool						mShouldQuit;
+
+	mutable std::mutex			mQueueMutex;
+	std::condition_variable		mQueueCondition;
+	std::condition_variable		mDoneCondition;
+	std::vector<RequestRef>		mQueue;
+	size_t						mNextSequence;
+
+	mutable std::mutex			mCacheMutex;
+	std::list<DocumentRef>		mDocuments;
+	std::list<PageRef>			mPages;
+	size_t						mMaxDocuments;
+	size_t						mMaxPages;
+	Stats						mStats;
+};
+
+} // namespace pdf
+} // namespace ds
+
+#endif // PRIVATE_PDFRENDERPOOL_H_
@@ -194,8 +194,6 @@ public:
 							this_link.mUrl = this_link.mRawUri;
 						}
 
-						std::cout << "Found link in page: " << this_link.mPageDest << " " << this_link.mRawUri << " " << this_link.mRect << " " << this_link.mUrl << std::endl;
-
 						mLinks.emplace_back(this_link);
 
 						if(linky->next) {
@@ -270,11 +268,27 @@ public:
 								mPageSize;
 };
 
+/// Copies the pixels out, so the surface doesn't point into a buffer that's about to go away
+ci::Surface8uRef copy_to_surface(const PdfPixels& pixels) {
+	const ci::Surface8u		wrapped(pixels.mData, pixels.mW, pixels.mH, pixels.mW * 3, ci::SurfaceChannelOrder::RGB);
+	ci::Surface8uRef		s = ci::Surface8u::create(pixels.mW, pixels.mH, false, ci::SurfaceChannelOrder::RGB);
+	s->copyFrom(wrapped, wrapped.getBounds());
+	return s;
+}
+
 } // namespace
 
 /**
  * \class ds::ui::sprite::PdfRes
  */
+ci::Surface8uRef PdfRes::renderPage(RenderPool& pool, const std::string& path) {
+	// Same document and page caches as the sprites, and a worker's clone of the shared context
+	auto					request = pool.render(path, 1, 1.0f, RenderPool::kPriorityVisible);
+	while (!pool.waitFor(request, 1000)) {}
+	if (!request->mSuccess || request->mPixels.empty()) return ci::Surface8uRef();
+	return copy_to_surface(request->mPixels);
+}
+
 ci::Surface8uRef PdfRes::renderPage(const std::string& path) {
 	ci::Surface8uRef		s;
 
@@ -289,23 +303,27 @@ ci::Surface8uRef PdfRes::renderPage(const std::string& path) {
 	Draw					draw(pixels, 1.0f);
 	if (!load.run(draw, path, page_num)) return s;
 
-	return ci::Surface::create(pixels.mData, examine.mWidth, examine.mHeight, examine.mWidth * 3, ci::SurfaceChannelOrder(ci::SurfaceChannelOrder::BGRA));
+	return copy_to_surface(pixels);
 }
 
-PdfRes::PdfRes(ds::GlThread& t)
-		: ds::GlThreadClient<PdfRes>(t)
+PdfRes::PdfRes(RenderPool& pool)
+		: mPool(pool)
 		, mPageCount(0)
-		, mPixelsChanged(false) 
+		, mVisible(true)
+		, mTiled(false)
+		, mTiler(pool)
+		, mZoom(1.0f)
 		, mPrintedError(false)
 {
 	mDrawState.mPageNum = 0;
 }
 
 void PdfRes::scheduleDestructor() {
-	performOnWorkerThread(&PdfRes::_destructor);
-}
-
-void PdfRes::_destructor() {
+	// The pool only shares the request with us, so an in-flight render just finishes into a buffer nobody reads
+	if(mPending) {
+		mPending->cancel();
+		mPending = nullptr;
+	}
 	delete this;
 }
 
@@ -314,17 +332,15 @@ PdfRes::~PdfRes() {
 
 bool PdfRes::loadPDF(const std::string& fileName) {
 	mPrintedError = false;
-	// I'd really like to do this initial examine stuff in the
-	// worker thread, but I suspect the client is expecting this
-	// info to be valid as soon as this is called.
-	Examine							examine;
-	Load							load;
-	if (load.run(examine, fileName, 1)) {
-		std::lock_guard<decltype(mMutex)>	l(mMutex);
+	// The examine goes through the pool's document cache, so the
+	// first render doesn't need to open the document again.
+	int								w = 0, h = 0, pageCount = 0;
+	if (mPool.examine(fileName, w, h, pageCount)) {
 		mFileName = fileName;
-		mState.mWidth = examine.mWidth;
-		mState.mHeight = examine.mHeight;
-		mPageCount = examine.mPageCount;
+		mTiler.setFileName(fileName);
+		mState.mWidth = w;
+		mState.mHeight = h;
+		mPageCount = pageCount;
 		return mPageCount > 0;
 	}
 	return false;
@@ -349,7 +365,7 @@ void PdfRes::goToPreviousPage() {
 
 void PdfRes::clearSurface() {
 	mSurface = nullptr;
-	mSurfacePixels.clearPixels();
+	mSurfacePixels.deleteData();
 }
 
 std::vector<ds::pdf::PdfLinkInfo> PdfRes::getLinks() {
@@ -367,8 +383,6 @@ float PdfRes::getHeight() const {
 }
 
 void PdfRes::setPageNum(int thePageNum) {
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
-
 	if (thePageNum < 1) thePageNum = 1;
 	if (thePageNum > mPageCount) thePageNum = mPageCount;
 	if (thePageNum == mState.mPageNum) return;
@@ -376,163 +390,151 @@ void PdfRes::setPageNum(int thePageNum) {
 }
 
 int PdfRes::getPageNum() const {
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
 	return mState.mPageNum;
 }
 
 int PdfRes::getPageCount() const {
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
 	return mPageCount;
 }
 
 ci::ivec2 PdfRes::getPageSize() const {
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
 	return mState.mPageSize;
 }
 
 void PdfRes::setScale(const float theScale) {
-	if (mState.mScale == theScale) return;
-
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
 	mState.mScale = theScale;	
 }
 
+void PdfRes::setVisible(const bool isVisible) {
+	mVisible = isVisible;
+}
+
+void PdfRes::setTiled(const bool isTiled) {
+	if(mTiled == isTiled) return;
+	mTiled = isTiled;
+
+	if(mTiled) {
+		if(mPending) {
+			mPending->cancel();
+			mPending = nullptr;
+		}
+		clearSurface();
+	} else {
+		mTiler.clear();
+		// Force a fresh whole-page render
+		mDrawState.mPageNum = 0;
+	}
+}
+
+void PdfRes::setVisibleArea(const ci::Rectf& area, const float zoom) {
+	mVisibleArea = area;
+	mZoom = zoom;
+}
+
 bool PdfRes::update() {
-	// Update the page, if necessary.  Batch process -- once my value has been
-	// set, I only need the next pending redraw to perform, everything else
-	// is unnecessary.
-	if(needsUpdate()){
-		performOnWorkerThread(&PdfRes::_redrawPage, true);
+	if(mTiled) {
+		return updateTiles();
 	}
 
 	bool pixelsWereUpdated = false;
-	{
-		std::lock_guard<decltype(mMutex)>		l(mMutex);
-		if (mPixelsChanged) {
 
+	if(mPending && mPending->isDone()) {
+		RenderPool::RequestRef		done = mPending;
+		mPending = nullptr;
+
+		if(done->mSuccess) {
 			pixelsWereUpdated = true;
-			mPixelsChanged = false;
-			;
-			if (mPixels.empty()) {
-				mSurface = nullptr;
-			} else {
-				mSurfacePixels.setSize(mPixels.mW, mPixels.mH);
-				memcpy((unsigned char *)mSurfacePixels.mData, mPixels.mData, mPixels.mDataSize);
-
-				mPixels.deleteData();
-
-				mSurface = ci::Surface8u::create(mSurfacePixels.mData, mSurfacePixels.mW, mSurfacePixels.mH, mSurfacePixels.mW * 3, ci::SurfaceChannelOrder::RGB);
+			mSurfacePixels.swap(done->mPixels);
+			mSurface = ci::Surface8u::create(mSurfacePixels.mData, mSurfacePixels.mW, mSurfacePixels.mH, mSurfacePixels.mW * 3, ci::SurfaceChannelOrder::RGB);
+			mDrawState.mPageSize = done->mPageSize;
+			mDrawState.mLinks = done->mLinks;
+		} else if(!done->isCancelled() && !mPrintedError) {
+			DS_LOG_WARNING("ds::pdf::PdfRes unable to rasterize document \"" << mFileName << "\".");
+			mPrintedError = true;
+		}
 
-				if(!mSurface) {
-					return false;
-				}
+		// Record the attempt even on failure, so a bad page isn't re-requested every frame
+		if(!done->isCancelled()) {
+			mDrawState.mPageNum = done->mPageNum;
+			mDrawState.mScale = done->mScale;
+		}
+	}
+
+	// Update the page, if necessary. A render for another page, or one still waiting in the
+	// queue, gets replaced. A render of this page that's already started is left to finish
+	// (during a pinch nothing would ever finish otherwise), and the newest scale is asked
+	// for once it's in.
+	if(mPageCount > 0) {
+		const float renderScale = getRenderScale();
+		if(renderScale < 0.0f) {
+			DS_LOG_WARNING("Something terrible happened with the drawing scale for your pdf!");
+		} else if(mPending) {
+			const bool otherPage = mPending->mPageNum != mState.mPageNum;
+			if(otherPage || (!mPending->isStarted() && fabsf(mPending->mScale - renderScale) >= 1e-2f)) {
+				mPending->cancel();
+				mPending = nullptr;
 			}
 		}
-		mState.mPageSize = mDrawState.mPageSize;
-		mState.mLinks = mDrawState.mLinks;
+
+		if(!mPending && renderScale >= 0.0f && needsRedraw(mState.mPageNum, renderScale)) {
+			mPending = mPool.render(mFileName, mState.mPageNum, renderScale,
+									mVisible ? RenderPool::kPriorityVisible : RenderPool::kPriorityBackground);
+		}
 	}
 
+	mState.mPageSize = mDrawState.mPageSize;
+	mState.mLinks = mDrawState.mLinks;
+
 	return pixelsWereUpdated;
 }
 
-bool PdfRes::needsUpdate() {
-	std::lock_guard<decltype(mMutex)>		l(mMutex);
-	if (mPageCount < 1) return false;
-	return mState != mDrawState;
-}
+bool PdfRes::updateTiles() {
+	if(mPageCount < 1) return false;
 
-void PdfRes::_redrawPage() {
-	// Pop out the pieces we need
-	bool							printedError;
-	state							drawState;
-	std::string						fn;
-	{
-		std::lock_guard<decltype(mMutex)>		l(mMutex);
-		
-		// No reason to regenerate the same page.
-		const float scaleEpsilon = 1e-2f;
-		bool isScaleCloseEnough = (abs(mDrawState.mScale - mState.mScale) < scaleEpsilon);
-
-		bool isSameStateIgnoringScale = false;
-
-		float savedDrawStateScale = mDrawState.mScale;
-		float savedStateScale = mState.mScale;
-		mDrawState.mScale = 1.0f;
-		mState.mScale = 1.0f;
-		isSameStateIgnoringScale = (mDrawState == mState);
-		mDrawState.mScale = savedDrawStateScale;
-		mState.mScale = savedStateScale;
-
-		bool isSameFile = (mDrawFileName == mFileName);
-		
-		if(isScaleCloseEnough && isSameStateIgnoringScale && isSameFile) {
-			return;
-		}
-		drawState = mState;
-		fn = mFileName;
-		// Prevent the main thread from loading the pixels while
-		// I'll be modifying them.
-		mPixelsChanged = false;
-		printedError = mPrintedError;
-
-
-		// Setup parameters
-		int scaledWidth = (float)drawState.mWidth * drawState.mScale;
-		if(scaledWidth < 1) scaledWidth = 1;
-		int scaledHeight = scaledWidth * drawState.mHeight / drawState.mWidth;
-		if(scaledHeight < 1) scaledHeight = 1;
-
-		// Prevent trying to draw a PDF that's too large (can cause a memory overload and crashy thingy)
-		if(scaledWidth > 12000 || scaledHeight > 12000){
-			float newW = (float)scaledWidth;
-			float newH = (float)scaledHeight;
-			float asp = newW / newH;
-			newW = 12000;
-			newH = 12000;
-			if(asp < 1.0f){
-				newW = newH * asp;
-			} else {
-				newH = newW / asp;
-			}
-			scaledWidth = (int)floorf(newW);
-			scaledHeight = (int)floorf(newH);
-			drawState.mScale = (float)scaledWidth / (float)drawState.mPageSize.x;
-			mState.mScale = drawState.mScale;
-			mDrawState.mScale = drawState.mScale;
-		}
+	// Until a tile of this page comes back, lay it out against the first page's size
+	ci::ivec2 pageSize(mState.mWidth, mState.mHeight);
+	if(mTiler.getRenderedPageNum() == mState.mPageNum && mTiler.getRenderedPageSize().x > 0) {
+		pageSize = mTiler.getRenderedPageSize();
 	}
 
+	// Hidden sprites keep their cache but stop asking for anything new
+	const ci::Rectf area = mVisible ? mVisibleArea : ci::Rectf(0.0f, 0.0f, 0.0f, 0.0f);
+	const bool tilesFinished = mTiler.update(mState.mPageNum, pageSize, area, mZoom);
 
-	if(drawState.mScale < 0.0f){
-		DS_LOG_WARNING("Something terrible happened with the drawing scale for your pdf!");
-		return;
+	if(mTiler.getRenderedPageNum() == mState.mPageNum) {
+		const ci::ivec2& renderedSize = mTiler.getRenderedPageSize();
+		if(renderedSize.x > 0 && renderedSize != pageSize) {
+			// The estimate was wrong, so the edge tiles were cut against the wrong size
+			mTiler.clearPage(mState.mPageNum);
+		}
+		mDrawState.mPageNum = mState.mPageNum;
+		mDrawState.mPageSize = renderedSize;
+		mDrawState.mLinks = mTiler.getRenderedLinks();
 	}
 
-	// Render to the texture
-	Draw							draw(mPixels, drawState.mScale);
-	Load							load;
+	mState.mPageSize = mDrawState.mPageSize;
+	mState.mLinks = mDrawState.mLinks;
 
-	if(drawState.mScale < 0.0f){
-		DS_LOG_WARNING("Something terrible happened with the drawing scale for your pdf!");
-		return;
-	}
+	return tilesFinished;
+}
 
-	if(!load.run(draw, fn, drawState.mPageNum)) {
-		if(!printedError){
-			DS_LOG_WARNING("ds::pdf::PdfRes unable to rasterize document \"" << fn << "\".");
-			std::lock_guard<decltype(mMutex)>			l(mMutex);
-			mPrintedError = true;
-		}
-		return;
+bool PdfRes::needsRedraw(const int pageNum, const float scale) const {
+	// No reason to regenerate the same page.
+	const float scaleEpsilon = 1e-2f;
+	return mDrawState.mPageNum != pageNum || fabsf(mDrawState.mScale - scale) >= scaleEpsilon;
+}
+
+float PdfRes::getRenderScale() const {
+	// Prevent trying to draw a PDF that's too large (can cause a memory overload and crashy thingy)
+	const float maxSize = 12000.0f;
+	const float w = static_cast<float>(mState.mWidth) * mState.mScale;
+	const float h = static_cast<float>(mState.mHeight) * mState.mScale;
+	if(mState.mWidth < 1 || mState.mHeight < 1 || (w <= maxSize && h <= maxSize)) {
+		return mState.mScale;
 	}
-	drawState.mPageSize = draw.getPageSize();
-	drawState.mLinks = draw.mLinks;
-
-	std::lock_guard<decltype(mMutex)>			l(mMutex);
-	mPixelsChanged = true;
-	mDrawState = drawState;
-	// No reason to copy the string which will generally be the same
-	if (mDrawFileName != fn) mDrawFileName = fn;
+
+	const float biggest = static_cast<float>(std::max(mState.mWidth, mState.mHeight));
+	return floorf(maxSize) / biggest;
 }
 
 /**
@@ -554,56 +556,5 @@ bool PdfRes::state::operator!=(const PdfRes::state& o) {
 	return !(*this == o);
 }
 
-/**
- * \class ds::ui::sprite::Pdf::Pixels
- */
-PdfRes::Pixels::Pixels()
-		: mW(0)
-		, mH(0)
-		, mData(nullptr) {
-}
-
-PdfRes::Pixels::~Pixels() {
-	deleteData();
-}
-
-bool PdfRes::Pixels::empty() const {
-	return mW < 1 || mH < 1 || !mData;
-}
-
-bool PdfRes::Pixels::setSize(const int w, const int h) {
-	if (mW == w && mH == h) return true;
-
-	deleteData();
-
-	mW = 0;
-	mH = 0;
-	if (w > 0 && h > 0) {
-		mDataSize = (w * h) * 3;
-		mData = new unsigned char[mDataSize];
-	}
-	if (!mData) return false;
-	mW = w;
-	mH = h;
-	return true;
-}
-
-void PdfRes::Pixels::clearPixels() {
-	if (mW < 1 || mH < 1) return;
-	const int			size = mW * mH * 3;
-	memset(mData, 0, size);
-}
-
-
-void PdfRes::Pixels::deleteData() {
-	if(mData) {
-		delete mData;
-		mData = nullptr;
-	}
-
-	mW = 0;
-	mH = 0;
-}
-
 } // using namespace pdf
 } // using namespace ds
@@ -1,27 +1,31 @@
 #ifndef PRIVATE_PDFRES_H_
 #define PRIVATE_PDFRES_H_
 
-#include <mutex>
-
 #include <cinder/Surface.h>
 #include <cinder/gl/Texture.h>
 
-#include <ds/thread/gl_thread.h>
 #include <ds/ui/sprite/pdf.h>
 #include <ds/ui/sprite/pdf_link.h>
+#include "private/pdf_render_pool.h"
+#include "private/pdf_tiler.h"
 
 namespace ds {
 namespace pdf {
 
 /**
  * \class ds::ui::sprite::PdfRes
+ * \brief Tracks the page and scale a Pdf sprite wants, and hands the
+ * rasterization off to the service's RenderPool. All calls are made
+ * from the main thread; results are picked up in update().
  */
-class PdfRes : public ds::GlThreadClient<PdfRes> {
+class PdfRes {
 public:
-	// Utility to get a render of the first page of a PDF.
+	// Utility to get a render of the first page of a PDF. Blocks until one of the pool's workers has it.
+	static ci::Surface8uRef	renderPage(RenderPool&, const std::string& path);
+	// Same, for when there's no engine to get a pool from. Opens its own MuPDF context for every call.
 	static ci::Surface8uRef	renderPage(const std::string& path);
 
-	PdfRes(ds::GlThread&);
+	PdfRes(RenderPool&);
 	// Clients should never delete this class, instead schedule it for deletion and consider it invalid.
 	void scheduleDestructor();
 
@@ -30,21 +34,9 @@ private:
 
 
 public:
-	// Store my pixel data, color space is RGBA, 8 bits per pixel.
-	struct Pixels {
-		Pixels();
-		~Pixels();
-
-		bool				empty() const;
-		bool				setSize(const int w, const int h);
-		void				clearPixels();
-		void				deleteData();
-		unsigned char*		mData;
-		int					mDataSize;
-		int					mW, mH;
-	};
+	// Store my pixel data, color space is RGB, 8 bits per channel.
+	typedef PdfPixels	Pixels;
 
-	
 
 	bool loadPDF(const std::string &theFileName);
 
@@ -65,11 +57,17 @@ public:
 	void					goToNextPage();
 	void					goToPreviousPage();
 	void					setScale(const float theScale);
-
-protected:
-	// worker thread calls
-	void _destructor();
-	void _redrawPage();
+	/// Visible pages get rendered before anything else in the pool
+	void					setVisible(const bool isVisible);
+
+	/// Tiled mode renders only the visible part of the page at the current zoom, see PdfTiler.
+	/// No whole-page surface is produced while tiled.
+	void					setTiled(const bool isTiled);
+	bool					getTiled() const { return mTiled; }
+	/// The visible part of the page in page points, and the screen pixels per page point
+	void					setVisibleArea(const ci::Rectf& area, const float zoom);
+	const std::vector<PdfTiler::TileRef>& getTiles() const { return mTiler.getDrawList(); }
+	void					setTileCacheBytes(const size_t maxBytes) { mTiler.setMaxBytes(maxBytes); }
 
 private:
 	struct state {
@@ -84,26 +82,28 @@ private:
 		std::vector<PdfLinkInfo>	mLinks;
 	};
 
-	bool						needsUpdate();
+	/// True if the requested state is far enough from the drawn (or drawing) state to need a new render
+	bool						needsRedraw(const int pageNum, const float scale) const;
+	/// Clamps the scale so the page never renders past the pool's size limit
+	float						getRenderScale() const;
+	bool						updateTiles();
 
-	mutable std::mutex			mMutex;
+	RenderPool&					mPool;
+	RenderPool::RequestRef		mPending;		// The in-flight render, if any
 
-	// MAIN THREAD
 	ci::Surface8uRef			mSurface;
 	Pixels						mSurfacePixels;
-	
-	// WORKER THREAD
 
-	// SHARED
-	bool						mRequestUpdate;
 	int							mPageCount;		// Page count < 1 means no PDF has been loaded
-	Pixels						mPixels;		// The buffer of data.
-	bool						mPixelsChanged;	// Indicates the main thread needs to load in the pixels.
 	std::string					mFileName;
-	state						mState;			// Store the current state as set by the main thread.  This data is only
-													// read by the worker thread, so it's safe to read it in the main without a lock.
+	state						mState;			// Store the current state as set by the client
 	state						mDrawState;		// Store the state used to generate the current active texture
-	std::string					mDrawFileName;	// Store so I can avoid redrawing duplicate pages
+	bool						mVisible;
+
+	bool						mTiled;
+	PdfTiler					mTiler;
+	ci::Rectf					mVisibleArea;
+	float						mZoom;
 
 	bool						mPrintedError; // to prevent a ton of warnings flooding the output
 };
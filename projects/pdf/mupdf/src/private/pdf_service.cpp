@@ -4,6 +4,7 @@
 
 #include <ds/app/engine/engine.h>
 #include <ds/util/file_meta_data.h>
+#include <ds/util/string_util.h>
 #include <ds/ui/sprite/pdf.h>
 
 namespace ds {
@@ -26,14 +27,25 @@ Service::Service(ds::Engine& engine)
 
 		pdfy->setResourceFilename(absPath);
 	});
+
+	mEngine.registerSpritePropertySetter("pdf_tiled", [this](ds::ui::Sprite& theSprite, const std::string& theValue, const std::string& fileReferrer){
+		ds::ui::Pdf* pdfy = dynamic_cast<ds::ui::Pdf*>(&theSprite);
+		if(!pdfy){
+			DS_LOG_WARNING("Tried to set the property pdf_tiled on a non-Pdf sprite");
+			return;
+		}
+
+		pdfy->setTiledRendering(ds::parseBoolean(theValue));
+	});
 }
 
 Service::~Service(){
-	mThread.waitForNoInput();
+	mPool.stop();
 }
 
 void Service::start(){
-	mThread.start(false);
+	mEngine.getEngineSettings().getSetting("pdf:render_threads", 0, ds::cfg::SETTING_TYPE_INT, "How many threads rasterize PDF pages. 0 uses one per core", "2", "0", "32");
+	mPool.start(mEngine.getEngineSettings().getInt("pdf:render_threads", 0, 2));
 }
 
 } // namespace pdf
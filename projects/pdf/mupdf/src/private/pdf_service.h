@@ -3,7 +3,7 @@
 #define PRIVATE_PDFSERVICE_H_
 
 #include <ds/app/engine/engine_service.h>
-#include <ds/thread/gl_thread.h>
+#include "private/pdf_render_pool.h"
 
 namespace ds {
 
@@ -14,7 +14,8 @@ namespace pdf {
 /**
  * \class ds::pdf::PdfService
  * \brief The engine service object that provides access to the
- * PDF rendering thread.
+ * PDF rendering pool. The number of workers comes from the
+ * pdf:render_threads engine setting.
  */
 class Service : public ds::EngineService {
 public:
@@ -25,7 +26,7 @@ public:
 
 	ds::Engine&			mEngine;
 
-	GlThread			mThread;
+	RenderPool			mPool;
 };
 
 } // namespace ui
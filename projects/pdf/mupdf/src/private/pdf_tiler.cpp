@@ -0,0 +1,285 @@
+#include "stdafx.h"
+
+#include "private/pdf_tiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include <ds/debug/logger.h>
+
+namespace ds {
+namespace pdf {
+
+namespace {
+
+ci::ivec2 pixelSizeAtLevel(const int level, const ci::ivec2& pageSize) {
+	const float scale = PdfTiler::levelScale(level);
+	return ci::ivec2(static_cast<int>(ceilf(static_cast<float>(pageSize.x) * scale)),
+					 static_cast<int>(ceilf(static_cast<float>(pageSize.y) * scale)));
+}
+
+}
+
+/**
+ * \class ds::pdf::PdfTiler
+ */
+PdfTiler::PdfTiler(RenderPool& pool)
+	: mPool(pool)
+	, mMaxBytes(64 * 1024 * 1024)
+	, mBytes(0)
+	, mRenderedPageSize(0, 0)
+	, mRenderedPageNum(0)
+	, mPrintedError(false)
+{
+}
+
+PdfTiler::~PdfTiler() {
+	clear();
+}
+
+void PdfTiler::setFileName(const std::string& fileName) {
+	if(mFileName == fileName) return;
+	clear();
+	mFileName = fileName;
+	mPrintedError = false;
+}
+
+void PdfTiler::setMaxBytes(const size_t maxBytes) {
+	mMaxBytes = maxBytes;
+	evict();
+}
+
+bool PdfTiler::update(const int pageNum, const ci::ivec2& pageSize, const ci::Rectf& visibleArea, const float zoom) {
+	bool finishedAny = false;
+
+	// Collect finished renders
+	for(auto& tile : mLru) {
+		if(!tile->mPending || !tile->mPending->isDone()) continue;
+
+		RenderPool::RequestRef done = tile->mPending;
+		tile->mPending = nullptr;
+		if(!done->mSuccess) {
+			// Asking again every frame would keep failing, so the tile stays empty while it's in view
+			if(!done->isCancelled()) {
+				if(!mPrintedError) DS_LOG_WARNING("ds::pdf::PdfTiler unable to render a tile of \"" << mFileName << "\" page " << done->mPageNum);
+				mPrintedError = true;
+				tile->mFailed = true;
+			}
+			continue;
+		}
+
+		tile->mPixels.swap(done->mPixels);
+		tile->mTexture = nullptr;
+		mBytes -= tile->mBytes;
+		tile->mBytes = static_cast<size_t>(tile->mPixels.mDataSize);
+		mBytes += tile->mBytes;
+
+		mRenderedPageSize = done->mPageSize;
+		mRenderedPageNum = done->mPageNum;
+		mRenderedLinks = done->mLinks;
+		finishedAny = true;
+	}
+
+	mWanted.clear();
+	mDrawList.clear();
+	if(mFileName.empty() || pageSize.x < 1 || pageSize.y < 1) {
+		evict();
+		return finishedAny;
+	}
+
+	const ci::Rectf		area = visibleArea.getClipBy(ci::Rectf(0.0f, 0.0f, static_cast<float>(pageSize.x), static_cast<float>(pageSize.y)));
+	const int			fineLevel = levelForZoom(zoom);
+	const int			coarseLevel = std::max(static_cast<int>(kMinLevel), fineLevel - kCoarseLevels);
+
+	// Coarse tiles go first, so they're queued (and rendered) before the refinement
+	if(area.getWidth() > 0.0f && area.getHeight() > 0.0f) {
+		tilesForArea(pageNum, coarseLevel, pageSize, area, mWanted);
+		if(fineLevel != coarseLevel) {
+			tilesForArea(pageNum, fineLevel, pageSize, area, mWanted);
+		}
+	}
+
+	std::unordered_set<TileKey, TileKeyHash> wanted(mWanted.begin(), mWanted.end());
+
+	// Anything still in flight that scrolled or zoomed out of view isn't worth finishing
+	for(auto& tile : mLru) {
+		if(tile->mPending && wanted.find(tile->mKey) == wanted.end()) {
+			tile->mPending->cancel();
+			tile->mPending = nullptr;
+		}
+	}
+
+	for(auto& key : mWanted) {
+		TileRef tile = findOrCreate(key, pageSize);
+		touch(key);
+		if(!tile->mPending && tile->mBytes == 0 && !tile->mFailed) {
+			tile->mPending = mPool.renderArea(mFileName, pageNum, levelScale(key.mLevel), tileArea(key, pageSize), RenderPool::kPriorityVisible);
+		}
+	}
+
+	// Draw whatever's ready from coarse to fine, including intermediate levels left over from earlier zooms
+	std::vector<TileKey> levelKeys;
+	for(int level = coarseLevel; level <= fineLevel; ++level) {
+		levelKeys.clear();
+		tilesForArea(pageNum, level, pageSize, area, levelKeys);
+		for(auto& key : levelKeys) {
+			auto findy = mTiles.find(key);
+			if(findy == mTiles.end()) continue;
+			TileRef tile = *findy->second;
+			if(tile->mBytes > 0) mDrawList.push_back(tile);
+		}
+	}
+
+	evict();
+	return finishedAny;
+}
+
+void PdfTiler::clear() {
+	for(auto& tile : mLru) {
+		if(tile->mPending) tile->mPending->cancel();
+	}
+	mLru.clear();
+	mTiles.clear();
+	mDrawList.clear();
+	mWanted.clear();
+	mBytes = 0;
+	mRenderedPageSize = ci::ivec2(0, 0);
+	mRenderedPageNum = 0;
+	mRenderedLinks.clear();
+}
+
+void PdfTiler::clearPage(const int pageNum) {
+	for(auto it = mLru.begin(); it != mLru.end();) {
+		TileRef tile = *it;
+		if(tile->mKey.mPageNum != pageNum) {
+			++it;
+			continue;
+		}
+
+		if(tile->mPending) tile->mPending->cancel();
+		mBytes -= tile->mBytes;
+		mTiles.erase(tile->mKey);
+		it = mLru.erase(it);
+	}
+	mDrawList.clear();
+}
+
+int PdfTiler::levelForZoom(const float zoom) {
+	if(zoom <= 0.0f) return 0;
+	const int level = static_cast<int>(ceilf(log2f(zoom) - 1e-3f));
+	return std::min(static_cast<int>(kMaxLevel), std::max(static_cast<int>(kMinLevel), level));
+}
+
+float PdfTiler::levelScale(const int level) {
+	return ldexpf(1.0f, level);
+}
+
+void PdfTiler::tilesForArea(const int pageNum, const int level, const ci::ivec2& pageSize, const ci::Rectf& area, std::vector<TileKey>& outKeys) {
+	const ci::ivec2		pixels = pixelSizeAtLevel(level, pageSize);
+	if(pixels.x < 1 || pixels.y < 1 || area.getWidth() <= 0.0f || area.getHeight() <= 0.0f) return;
+
+	const float			scale = levelScale(level);
+	const int			maxCol = (pixels.x - 1) / kTileSize;
+	const int			maxRow = (pixels.y - 1) / kTileSize;
+	const int			col0 = std::max(0, static_cast<int>(floorf(area.x1 * scale / kTileSize)));
+	const int			row0 = std::max(0, static_cast<int>(floorf(area.y1 * scale / kTileSize)));
+	const int			col1 = std::min(maxCol, static_cast<int>(ceilf(area.x2 * scale / kTileSize)) - 1);
+	const int			row1 = std::min(maxRow, static_cast<int>(ceilf(area.y2 * scale / kTileSize)) - 1);
+
+	for(int row = row0; row <= row1; ++row) {
+		for(int col = col0; col <= col1; ++col) {
+			outKeys.push_back(TileKey(pageNum, level, col, row));
+		}
+	}
+}
+
+ci::Area PdfTiler::tileArea(const TileKey& key, const ci::ivec2& pageSize) {
+	const ci::ivec2		pixels = pixelSizeAtLevel(key.mLevel, pageSize);
+	return ci::Area(key.mCol * kTileSize, key.mRow * kTileSize,
+					std::min((key.mCol + 1) * kTileSize, pixels.x), std::min((key.mRow + 1) * kTileSize, pixels.y));
+}
+
+PdfTiler::TileRef PdfTiler::findOrCreate(const TileKey& key, const ci::ivec2& pageSize) {
+	auto findy = mTiles.find(key);
+	if(findy != mTiles.end()) return *findy->second;
+
+	TileRef				tile = std::make_shared<Tile>();
+	tile->mKey = key;
+	const ci::Area		pixelArea = tileArea(key, pageSize);
+	const float			scale = levelScale(key.mLevel);
+	tile->mPageRect = ci::Rectf(pixelArea.x1 / scale, pixelArea.y1 / scale, pixelArea.x2 / scale, pixelArea.y2 / scale);
+
+	mLru.push_front(tile);
+	mTiles[key] = mLru.begin();
+	return tile;
+}
+
+void PdfTiler::touch(const TileKey& key) {
+	auto findy = mTiles.find(key);
+	if(findy == mTiles.end()) return;
+	mLru.splice(mLru.begin(), mLru, findy->second);
+}
+
+void PdfTiler::evict() {
+	std::unordered_set<TileKey, TileKeyHash> wanted(mWanted.begin(), mWanted.end());
+
+	auto it = mLru.end();
+	while(it != mLru.begin()) {
+		--it;
+		TileRef& tile = *it;
+		if(wanted.find(tile->mKey) != wanted.end()) continue;
+
+		// Placeholders for cancelled or failed renders never hold anything, so they always go
+		const bool		isEmpty = tile->mBytes == 0 && !tile->mPending;
+		if(!isEmpty && mBytes <= mMaxBytes) continue;
+
+		if(tile->mPending) tile->mPending->cancel();
+		mBytes -= tile->mBytes;
+		mTiles.erase(tile->mKey);
+		it = mLru.erase(it);
+	}
+}
+
+/**
+ * \class ds::pdf::PdfTiler::TileKey
+ */
+PdfTiler::TileKey::TileKey()
+	: mPageNum(0)
+	, mLevel(0)
+	, mCol(0)
+	, mRow(0)
+{
+}
+
+PdfTiler::TileKey::TileKey(const int pageNum, const int level, const int col, const int row)
+	: mPageNum(pageNum)
+	, mLevel(level)
+	, mCol(col)
+	, mRow(row)
+{
+}
+
+bool PdfTiler::TileKey::operator==(const TileKey& o) const {
+	return mPageNum == o.mPageNum && mLevel == o.mLevel && mCol == o.mCol && mRow == o.mRow;
+}
+
+size_t PdfTiler::TileKeyHash::operator()(const TileKey& k) const {
+	size_t h = std::hash<int>()(k.mPageNum);
+	h = h * 31 + std::hash<int>()(k.mLevel);
+	h = h * 31 + std::hash<int>()(k.mCol);
+	h = h * 31 + std::hash<int>()(k.mRow);
+	return h;
+}
+
+/**
+ * \class ds::pdf::PdfTiler::Tile
+ */
+PdfTiler::Tile::Tile()
+	: mBytes(0)
+	, mFailed(false)
+{
+}
+
+} // namespace pdf
+} // namespace ds
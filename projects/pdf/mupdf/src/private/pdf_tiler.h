@@ -0,0 +1,128 @@
+#pragma once
+#ifndef PRIVATE_PDFTILER_H_
+#define PRIVATE_PDFTILER_H_
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <cinder/Area.h>
+#include <cinder/Rect.h>
+#include <cinder/gl/Texture.h>
+
+#include "private/pdf_render_pool.h"
+
+namespace ds {
+namespace pdf {
+
+/**
+ * \class ds::pdf::PdfTiler
+ * \brief Renders a document as fixed size tiles across a mip pyramid.
+ * Level 0 is the page at 1 pixel per point, each level up doubles the
+ * resolution. Each update only requests tiles that intersect the visible
+ * area: the coarse level first, so something shows up quickly, then the
+ * level that matches the current zoom. Finished tiles stay in a byte
+ * bounded LRU so panning and zooming back out reuse them.
+ * This class makes no GL calls; the owner uploads tile pixels into
+ * mTexture and can then drop the pixels.
+ */
+class PdfTiler {
+public:
+	static const int			kTileSize = 256;
+	static const int			kMinLevel = -4;
+	static const int			kMaxLevel = 5;
+	/// How many levels below the target level the coarse pass renders
+	static const int			kCoarseLevels = 2;
+
+	struct TileKey {
+		TileKey();
+		TileKey(const int pageNum, const int level, const int col, const int row);
+		bool					operator==(const TileKey&) const;
+
+		int						mPageNum, mLevel, mCol, mRow;
+	};
+
+	struct TileKeyHash {
+		size_t					operator()(const TileKey&) const;
+	};
+
+	struct Tile {
+		Tile();
+
+		TileKey					mKey;
+		/// The area covered by this tile in page points (sprite-local units)
+		ci::Rectf				mPageRect;
+		/// Pixels waiting for upload. Empty once uploaded or before the render finishes
+		PdfPixels				mPixels;
+		ci::gl::TextureRef		mTexture;
+		size_t					mBytes;
+		RenderPool::RequestRef	mPending;
+		/// The render failed. Not asked for again until the tile is evicted and comes back into view.
+		bool					mFailed;
+	};
+	typedef std::shared_ptr<Tile> TileRef;
+
+	PdfTiler(RenderPool&);
+	~PdfTiler();
+
+	void						setFileName(const std::string& fileName);
+	/// Once the cache grows past this, the least recently visible tiles are dropped
+	void						setMaxBytes(const size_t maxBytes);
+	size_t						getMaxBytes() const { return mMaxBytes; }
+	size_t						getBytes() const { return mBytes; }
+
+	/// Request the tiles needed to show visibleArea (in page points) at zoom
+	/// (screen pixels per page point) and collect finished tiles.
+	/// Returns true if any tile finished rendering on this pass.
+	bool						update(const int pageNum, const ci::ivec2& pageSize, const ci::Rectf& visibleArea, const float zoom);
+
+	/// The finished tiles intersecting the last visible area, coarse levels first so finer tiles draw on top
+	const std::vector<TileRef>&	getDrawList() const { return mDrawList; }
+
+	/// The page size reported by the most recently finished tile, 0,0 if none have finished
+	const ci::ivec2&			getRenderedPageSize() const { return mRenderedPageSize; }
+	int							getRenderedPageNum() const { return mRenderedPageNum; }
+	const std::vector<PdfLinkInfo>& getRenderedLinks() const { return mRenderedLinks; }
+
+	/// Cancels everything in flight and drops every tile
+	void						clear();
+	/// Drops the tiles for one page, for instance when they were laid out against the wrong page size
+	void						clearPage(const int pageNum);
+
+	/// Pyramid math, exposed for anyone that needs to reason about tiles
+	static int					levelForZoom(const float zoom);
+	static float				levelScale(const int level);
+	/// All the tiles at level that intersect area (in page points) on a page of pageSize points
+	static void					tilesForArea(const int pageNum, const int level, const ci::ivec2& pageSize, const ci::Rectf& area, std::vector<TileKey>& outKeys);
+	/// The pixel area covered by key at its level, clipped to the page
+	static ci::Area				tileArea(const TileKey& key, const ci::ivec2& pageSize);
+
+private:
+	TileRef						findOrCreate(const TileKey&, const ci::ivec2& pageSize);
+	void						touch(const TileKey&);
+	void						evict();
+
+	typedef std::list<TileRef>	TileList;
+
+	RenderPool&					mPool;
+	std::string					mFileName;
+	size_t						mMaxBytes;
+	size_t						mBytes;
+
+	/// Most recently used at the front
+	TileList					mLru;
+	std::unordered_map<TileKey, TileList::iterator, TileKeyHash> mTiles;
+
+	std::vector<TileRef>		mDrawList;
+	std::vector<TileKey>		mWanted;
+	ci::ivec2					mRenderedPageSize;
+	int							mRenderedPageNum;
+	std::vector<PdfLinkInfo>	mRenderedLinks;
+	bool						mPrintedError;
+};
+
+} // namespace pdf
+} // namespace ds
+
+#endif // PRIVATE_PDFTILER_H_
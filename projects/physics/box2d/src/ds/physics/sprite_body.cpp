@@ -69,6 +69,7 @@ bool SpriteBody::empty() const {
 }
 
 void SpriteBody::create(const BodyBuilder& b) {
+	auto				lock = mWorld.lockWorld();
 	destroy();
 
 	b2BodyDef			def;
@@ -112,9 +113,10 @@ b2PrismaticJoint* SpriteBody::createPrismaticJoint(const SpriteBody& body, ci::v
 void SpriteBody::destroy() {
 	if (!mBody) return;
 
-	
+	auto				lock = mWorld.lockWorld();
 	// Destroying a body also destroys all joints associated with that body.
 	releaseJoints();
+	mWorld.forgetBody(mBody);
 	mWorld.mWorld->DestroyBody(mBody);
 	mBody = nullptr;
 }
@@ -125,6 +127,7 @@ void SpriteBody::releaseJoints() {
 
 void SpriteBody::setActive(bool flag) {
 	if (!mBody) return;
+	auto				lock = mWorld.lockWorld();
 	// Setting a body as inactive also sets all associated joints as inactive, but does not delete them from the world.
 	mBody->SetActive(flag);
 }
@@ -132,6 +135,7 @@ void SpriteBody::setActive(bool flag) {
 void SpriteBody::enableCollisions(const bool on) {
 	if (!mBody) return;
 
+	auto			lock = mWorld.lockWorld();
 	const bool		sensor = !on;
 	b2Fixture*		fix = mBody->GetFixtureList();
 	while (fix) {
@@ -168,22 +172,26 @@ void SpriteBody::processTouchRemoved(const ds::ui::TouchInfo& ti) {
 void SpriteBody::setPosition(const ci::vec3& pos) {
 	if (!mBody) return;
 
+	auto				lock = mWorld.lockWorld();
 	const b2Vec2		boxpos = mWorld.Ci2BoxTranslation(pos, &mSprite);
 	mBody->SetTransform(boxpos, mBody->GetAngle());
+	mWorld.resetBody(mBody);
 }
 
 void SpriteBody::clearVelocity() {
 	if (!mBody) return;
 
-	b2Vec2			zeroVec;
-	zeroVec.SetZero();
-	mBody->SetLinearVelocity(zeroVec);
-	mBody->SetAngularVelocity(0);
+	mWorld.changeBody(*mBody, [](b2Body& body) {
+		b2Vec2		zeroVec;
+		zeroVec.SetZero();
+		body.SetLinearVelocity(zeroVec);
+		body.SetAngularVelocity(0);
+	});
 }
 
 void SpriteBody::setLinearVelocity(const float x, const float y) {
 	if (mBody) {
-		mBody->SetLinearVelocity(b2Vec2(x, y));
+		mWorld.changeBody(*mBody, [x, y](b2Body& body) { body.SetLinearVelocity(b2Vec2(x, y)); });
 	}
 }
 
@@ -192,6 +200,7 @@ ci::vec2 SpriteBody::getLinearVelocity() {
 	b2Vec2 vel = b2Vec2(0.0f, 0.0f);
 
 	if (mBody) {
+		auto		lock = mWorld.lockWorld();
 		vel =  mBody->GetLinearVelocity();
 	}
 	return ci::vec2(vel.x, vel.y);
@@ -200,20 +209,22 @@ ci::vec2 SpriteBody::getLinearVelocity() {
 
 void SpriteBody::applyForceToCenter(const float x, const float y) {
 	if (mBody) {
-		mBody->ApplyForceToCenter(b2Vec2(x, y), true);
+		mWorld.changeBody(*mBody, [x, y](b2Body& body) { body.ApplyForceToCenter(b2Vec2(x, y), true); });
 	}
 }
 void SpriteBody::applyImpulseToCenter(const float x, const float y, ci::vec2 point) {
 	if (mBody) {
-		mBody->ApplyLinearImpulse (b2Vec2(x, y), b2Vec2(point.x, point.y), true);
+		mWorld.changeBody(*mBody, [x, y, point](b2Body& body) { body.ApplyLinearImpulse(b2Vec2(x, y), b2Vec2(point.x, point.y), true); });
 	}
 }
 
 void SpriteBody::setRotation(const float degree) {
 	if (!mBody) return;
 
+	auto			lock = mWorld.lockWorld();
 	const float		angle = degree * ds::math::DEGREE2RADIAN;
 	mBody->SetTransform(mBody->GetPosition(), angle);
+	mWorld.resetBody(mBody);
 	if (!mBody->IsAwake()) {
 		// You'd think setting the transform would wake up the body,
 		// but nope.
@@ -223,6 +234,7 @@ void SpriteBody::setRotation(const float degree) {
 
 float SpriteBody::getRotation() const {
 	if (!mBody) return 0.0f;
+	auto			lock = mWorld.lockWorld();
 	return mBody->GetAngle() * ds::math::RADIAN2DEGREE;
 }
 
@@ -231,26 +243,28 @@ void SpriteBody::setCollisionCallback(const std::function<void(const Collision&)
 }
 
 void SpriteBody::setContactPreSolveFn(const std::function<void( b2Contact* , const b2Manifold* )>& fn) {
-
+	auto			lock = mWorld.lockWorld();
 	mWorld.mContactListener.setPreSolveFunction(fn);
 }
 
 void SpriteBody::setContactPostSolveFn(const std::function<void( b2Contact*, const b2ContactImpulse*)>& fn) {
-
+	auto			lock = mWorld.lockWorld();
 	mWorld.mContactListener.setPostSolveFunction(fn);
 }
 void SpriteBody::setBeginContactFn(const std::function<void(b2Contact*)>& fn){
+	auto			lock = mWorld.lockWorld();
 	mWorld.mContactListener.setBeginContactFunction(fn);
 }
 
 void SpriteBody::setEndContactFn(const std::function<void(b2Contact*)>& fn){
+	auto			lock = mWorld.lockWorld();
 	mWorld.mContactListener.setEndContactFunction(fn);
-
 }
 
 void SpriteBody::onCenterChanged() {
 	if (!mBody) return;
 
+	auto					lock = mWorld.lockWorld();
 	// Currently there should only be 1 fixture.
 	b2Fixture*				fix = mBody->GetFixtureList();
 	while (fix) {
@@ -86,6 +86,7 @@ public:
 	// Forces the physics body to this position, may result in non-natural movement. But who cares, right?
 	void					setPosition(const ci::vec3&);
 
+	// With step:threaded these don't wait for the steps to finish; they're applied before the next one.
 	void					clearVelocity();
 	void					setLinearVelocity(const float x, const float y);
 	ci::vec2				getLinearVelocity();
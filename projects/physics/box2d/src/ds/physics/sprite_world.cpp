@@ -10,8 +10,8 @@ namespace physics {
 /**
  * \class SpriteWorld
  */
-SpriteWorld::SpriteWorld(ds::ui::Sprite& s, const int world_id) {
-	s.getEngine().getService<ds::physics::Service>(SERVICE_NAME).createWorld(s, world_id);
+SpriteWorld::SpriteWorld(ds::ui::Sprite& s, const int world_id, const std::string& settingsFile) {
+	s.getEngine().getService<ds::physics::Service>(SERVICE_NAME).createWorld(s, world_id, settingsFile);
 }
 
 } // namespace physics
@@ -2,6 +2,8 @@
 #ifndef DS_PHYSICS_SPRITEWORLD_H_
 #define DS_PHYSICS_SPRITEWORLD_H_
 
+#include <string>
+
 namespace ds {
 namespace ui {
 class Sprite;
@@ -13,10 +15,12 @@ namespace physics {
  * \brief Construct a physics world attached to a sprite.
  * NOTE: Right now the sprite does not own the world, so if
  * the sprite gets deleted, CRASH.
+ * Settings come from physics.xml, with settingsFile (in the app's
+ * settings folder) read over them for this world.
  */
 class SpriteWorld {
 public:
-	SpriteWorld(ds::ui::Sprite&, const int world_id = 0);
+	SpriteWorld(ds::ui::Sprite&, const int world_id = 0, const std::string& settingsFile = "");
 
 private:
 };
@@ -90,6 +90,7 @@ void DebugDraw::drawClient(const ci::mat4& t, const DrawParams& p) {
 	ci::gl::setModelMatrix(trans);
 	ci::gl::setViewMatrix(trans);
 //	ci::gl::multModelView(trans);
+	auto lock = mPhysicsWorld.lockWorld();
 	mB2World.DrawDebugData();
 	ci::gl::popModelView();
 }
@@ -45,8 +45,8 @@ void Service::stop() {
 	mWorlds.clear();
 }
 
-void Service::createWorld(ds::ui::Sprite& owner, const int id) {
-	std::unique_ptr<World>		up(new World(mEngine, owner));
+void Service::createWorld(ds::ui::Sprite& owner, const int id, const std::string& settingsFile) {
+	std::unique_ptr<World>		up(new World(mEngine, owner, settingsFile));
 	World*						w(up.get());
 	if (!w) {
 		throw std::runtime_error("Can't create physics world");
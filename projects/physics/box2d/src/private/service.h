@@ -30,7 +30,8 @@ public:
 	virtual void				stop();
 
 	// Throw if the world can't be created / doesn't exist.
-	void						createWorld(ds::ui::Sprite&, const int id);
+	// settingsFile is read over physics.xml for this world only, see World.
+	void						createWorld(ds::ui::Sprite&, const int id, const std::string& settingsFile = "");
 	World&						getWorld(const int id);
 
 private:
@@ -1,5 +1,8 @@
 #include "private/world.h"
 
+#include <algorithm>
+
+#include <Poco/Timestamp.h>
 #include <cinder/CinderMath.h>
 #include <ds/app/auto_update.h>
 #include <ds/app/environment.h>
@@ -41,7 +44,7 @@ void*						BOUNDS_BOTTOM_PTR = reinterpret_cast<void*>(&BOUNDS_BOTTOM);
 /**
  * \class ds::physics::World
  */
-World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy)
+World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy, const std::string& settingsFile)
 		: ds::AutoUpdate(e)
 		, mSprite(spriddy)
 		, mTouch(*this)
@@ -59,6 +62,19 @@ World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy)
 		, mMouseFrequencyHz(25.0f)
 		, mTranslateToLocalSpace(false)
 		, mSettings()
+		, mAccumulate(false)
+		, mThreaded(false)
+		, mMaxSubSteps(4)
+		, mAccumulator(0.0f)
+		, mSyncThreshold(0.01f)
+		, mSyncThresholdDegrees(0.01f)
+		, mBackAlpha(0.0f)
+		, mFrontAlpha(0.0f)
+		, mStepsRequested(-1)
+		, mStepsRunning(false)
+		, mStopStepThread(false)
+		, mLastStepMs(0.0)
+		, mLastSyncMs(0.0)
 {
 	mWorld = std::move(std::unique_ptr<b2World>(new b2World(b2Vec2(0.0f, 0.0f))));
 	if (mWorld.get() == nullptr) throw std::runtime_error("ds::physics::World() can't create b2World");
@@ -67,6 +83,9 @@ World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy)
 	if (!mGround) throw std::runtime_error("ds::physics::World() can't create mGround");
 
 	ds::Environment::loadSettings("physics", "physics.xml", mSettings);
+	if (!settingsFile.empty()) {
+		mSettings.readFrom(ds::Environment::getAppFolder(ds::Environment::SETTINGS(), settingsFile), true);
+	}
 	mTranslateToLocalSpace = mSettings.getBool("use_local_translation", 0, false);
 	mFriction = mSettings.getFloat("friction", 0, mFriction);
 	mLinearDampening = mSettings.getFloat("dampening:linear", 0, mLinearDampening);
@@ -81,6 +100,12 @@ World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy)
 	mPositionIterations = mSettings.getInt("step:position_iterations", 0, 2);
 	mFixedStep = mSettings.getBool("step:fixed", 0, false);
 	mFixedStepAmount = mSettings.getFloat("step:fixed_amount", 0, 1.0f/60.0f);
+	if (mFixedStepAmount <= 0.0f) mFixedStepAmount = 1.0f/60.0f;
+	mThreaded = mSettings.getBool("step:threaded", 0, false);
+	mAccumulate = mThreaded || mSettings.getBool("step:accumulate", 0, false);
+	mMaxSubSteps = std::max(1, mSettings.getInt("step:max_sub_steps", 0, mMaxSubSteps));
+	mSyncThreshold = mSettings.getFloat("step:sync_threshold", 0, mSyncThreshold);
+	mSyncThresholdDegrees = mSettings.getFloat("step:sync_threshold_degrees", 0, mSyncThresholdDegrees);
 
 	// Slightly complicated, but flexible: Bounds can be either fixed or unit,
 	// or a combination of both, which applies the fixed as an offset.
@@ -102,11 +127,49 @@ World::World(ds::ui::SpriteEngine& e, ds::ui::Sprite& spriddy)
 	if (mSettings.getBool("draw_debug", 0, false)) {
 		mDebugDraw.reset(new DebugDraw(e, *(mWorld.get()), *this));
 	}
+
+	if (mThreaded) startStepThread();
+}
+
+World::~World() {
+	stopStepThread();
+}
+
+std::unique_lock<std::recursive_mutex> World::lockWorld() const {
+	return std::unique_lock<std::recursive_mutex>(mWorldMutex);
+}
+
+void World::changeBody(b2Body& body, const std::function<void(b2Body&)>& fn) {
+	std::unique_lock<std::recursive_mutex>	lock(mWorldMutex, std::try_to_lock);
+	if (lock.owns_lock()) {
+		// Anything queued goes first, to keep the order
+		applyBodyChanges();
+		fn(body);
+		return;
+	}
+
+	std::lock_guard<std::mutex>	l(mChangeMutex);
+	BodyChange					change;
+	change.mBody = &body;
+	change.mFn = fn;
+	mBodyChanges.push_back(change);
+}
+
+void World::applyBodyChanges() {
+	{
+		std::lock_guard<std::mutex>	l(mChangeMutex);
+		if (mBodyChanges.empty()) return;
+		mApplyingChanges.swap(mBodyChanges);
+	}
+	for (auto it = mApplyingChanges.begin(), end = mApplyingChanges.end(); it != end; ++it) {
+		it->mFn(*it->mBody);
+	}
+	mApplyingChanges.clear();
 }
 
 b2DistanceJoint* World::createDistanceJoint(const SpriteBody& body1, const SpriteBody& body2, float length, float dampingRatio, float frequencyHz,
 	const ci::vec3 bodyAOffset, const ci::vec3 bodyBOffset) {
-	
+	auto lock = lockWorld();
 	if (body1.mBody && body2.mBody) {
 		b2DistanceJointDef jointDef;
 		jointDef.bodyA = body1.mBody;
@@ -132,7 +195,7 @@ b2DistanceJoint* World::createDistanceJoint(const SpriteBody& body1, const Sprit
 b2PrismaticJoint* World::createPrismaticJoint(const SpriteBody& body1, const SpriteBody& body2, b2Vec2 axis, bool enableLimit, float lowerTranslation, float upperTranslation,
 	bool enableMotor, float maxMotorForce, float motorSpeed,
 	const ci::vec3 bodyAOffset, const ci::vec3 bodyBOffset) {
-
+	auto lock = lockWorld();
 	if (body1.mBody && body2.mBody) {
 		b2PrismaticJointDef jointDef; 
 		jointDef.Initialize(body1.mBody, body2.mBody, b2Vec2(0.0f, 0.0f), axis);
@@ -166,6 +229,7 @@ b2PrismaticJoint* World::createPrismaticJoint(const SpriteBody& body1, const Spr
 
 
 void World::resizeDistanceJoint(const SpriteBody& body1, const SpriteBody& body2, float length) {
+	auto lock = lockWorld();
 	for(auto it  = mDistanceJoints.begin(); it != mDistanceJoints.end(); ++it) {
 		b2DistanceJoint* joint  = *it;
 		if (joint->GetBodyA() == body1.mBody && joint->GetBodyB() == body2.mBody
@@ -176,6 +240,7 @@ void World::resizeDistanceJoint(const SpriteBody& body1, const SpriteBody& body2
 }
 
 void World::createWeldJoint(const SpriteBody& body1, const SpriteBody& body2, const float damping, const float frequency, const ci::vec3 bodyAOffset, const ci::vec3 bodyBOffset) {
+	auto lock = lockWorld();
 	if (body1.mBody && body2.mBody) {
 		b2WeldJointDef jointDef;
 		jointDef.bodyA = body1.mBody;
@@ -197,6 +262,7 @@ void World::createWeldJoint(const SpriteBody& body1, const SpriteBody& body2, co
 
 void World::releaseJoints(const SpriteBody& body) {
 	if(!body.mBody) return;
+	auto lock = lockWorld();
 	for (int i = 0; i < mDistanceJoints.size(); i++){
 		if(mDistanceJoints[i]->GetBodyA() == body.mBody || mDistanceJoints[i]->GetBodyB() == body.mBody){
 			mWorld->DestroyJoint(mDistanceJoints[i]);
@@ -222,15 +288,18 @@ void World::releaseJoints(const SpriteBody& body) {
 }
 
 
-void World::processTouchAdded(const SpriteBody& body, const ds::ui::TouchInfo& ti) {	
+void World::processTouchAdded(const SpriteBody& body, const ds::ui::TouchInfo& ti) {
+	auto lock = lockWorld();
 	mTouch.processTouchAdded(body, ti);
 }
 
 void World::processTouchMoved(const SpriteBody& body, const ds::ui::TouchInfo& ti) {
+	auto lock = lockWorld();
 	mTouch.processTouchMoved(body, ti);
 }
 
 void World::processTouchRemoved(const SpriteBody& body, const ds::ui::TouchInfo& ti) {
+	auto lock = lockWorld();
 	mTouch.processTouchRemoved(body, ti);
 }
 
@@ -256,6 +325,7 @@ bool World::getFixedRotation() const
 
 void World::setCollisionCallback(const ds::ui::Sprite& s, const std::function<void(const Collision&)>& fn)
 {
+	auto lock = lockWorld();
 	mContactListener.setCollisionCallback(s, fn);
 	if (!mContactListenerRegistered) {
 		mContactListenerRegistered = true;
@@ -279,6 +349,45 @@ bool World::makeCollision(const b2Fixture& fix, Collision& c) const
 
 void World::update(const ds::UpdateParams& p)
 {
+	Poco::Timestamp		start;
+
+	if (mThreaded) {
+		// Normally the steps finished while the last frame was drawing
+		waitForSteps();
+		{
+			auto lock = lockWorld();
+			std::swap(mFrontTransforms, mBackTransforms);
+			mFrontAlpha = mBackAlpha;
+			mContactListener.report();
+			mContactListener.clear();
+		}
+
+		int				steps = accumulate(p.getDeltaTime(), mBackAlpha);
+		{
+			std::lock_guard<std::mutex>	l(mStepMutex);
+			mStepsRequested = steps;
+			mStepsRunning = true;
+		}
+		mStepCondition.notify_all();
+
+		// The front transforms are only touched on this thread, so this overlaps with the steps
+		syncSprites(mFrontTransforms, mFrontAlpha);
+		mLastSyncMs = static_cast<double>(start.elapsed()) / 1000.0;
+		return;
+	}
+
+	auto				lock = lockWorld();
+	if (mAccumulate) {
+		mContactListener.clear();
+		const int		steps = accumulate(p.getDeltaTime(), mFrontAlpha);
+		runSteps(steps);
+		std::swap(mFrontTransforms, mBackTransforms);
+		syncSprites(mFrontTransforms, mFrontAlpha);
+		mContactListener.report();
+		mLastSyncMs = static_cast<double>(start.elapsed()) / 1000.0 - mLastStepMs;
+		return;
+	}
+
 	mContactListener.clear();
 	
 	if(mFixedStep){
@@ -287,6 +396,8 @@ void World::update(const ds::UpdateParams& p)
 		mWorld->Step(p.getDeltaTime(), mVelocityIterations, mPositionIterations);
 	}
 	
+	mLastStepMs = static_cast<double>(start.elapsed()) / 1000.0;
+
 	// Update all objects
 	for ( b2Body* b = mWorld->GetBodyList(); b; b = b->GetNext() )
 	{
@@ -297,9 +408,7 @@ void World::update(const ds::UpdateParams& p)
 			ds::ui::Sprite*	sprite = reinterpret_cast<ds::ui::Sprite*>( b->GetUserData() );
 			if (sprite)
 			{
-				auto pos = box2CiTranslation(b->GetPosition(), sprite);
-				sprite->setPosition(pos);
-				sprite->setRotation(ci::toDegrees(b->GetAngle()));
+				syncSprite(*sprite, b->GetPosition(), b->GetAngle());
 			}
 		}
 	}
@@ -328,6 +437,153 @@ void World::update(const ds::UpdateParams& p)
 #endif
 
 	mContactListener.report();
+	mLastSyncMs = static_cast<double>(start.elapsed()) / 1000.0 - mLastStepMs;
+}
+
+int World::accumulate(const float dt, float& outAlpha) {
+	if (dt > 0.0f) mAccumulator += dt;
+
+	int					steps = static_cast<int>(mAccumulator / mFixedStepAmount);
+	if (steps > mMaxSubSteps) {
+		// Too far behind to catch up, so drop the time rather than spiral
+		steps = mMaxSubSteps;
+		mAccumulator = 0.0f;
+	} else {
+		mAccumulator -= static_cast<float>(steps) * mFixedStepAmount;
+	}
+
+	outAlpha = std::min(1.0f, std::max(0.0f, mAccumulator / mFixedStepAmount));
+	return steps;
+}
+
+void World::runSteps(const int count) {
+	Poco::Timestamp		start;
+
+	for (int i = 0; i < count; ++i) {
+		auto			lock = lockWorld();
+		applyBodyChanges();
+		if (i == count - 1) {
+			mCaptured.clear();
+			for (b2Body* b = mWorld->GetBodyList(); b; b = b->GetNext()) {
+				if (b->GetType() != b2_dynamicBody) continue;
+				ds::ui::Sprite*	sprite = reinterpret_cast<ds::ui::Sprite*>(b->GetUserData());
+				if (!sprite) continue;
+
+				BodyTransform	t;
+				t.mBody = b;
+				t.mSprite = sprite;
+				t.mPreviousPosition = t.mPosition = b->GetPosition();
+				t.mPreviousAngle = t.mAngle = b->GetAngle();
+				mCaptured.push_back(t);
+			}
+		}
+		mWorld->Step(mFixedStepAmount, mVelocityIterations, mPositionIterations);
+	}
+
+	auto				lock = lockWorld();
+	// Without any steps this frame, the changes still shouldn't wait
+	applyBodyChanges();
+	// Bodies destroyed since the last step were already taken out of mCaptured
+	if (count > 0) {
+		for (auto it = mCaptured.begin(), end = mCaptured.end(); it != end; ++it) {
+			it->mPosition = it->mBody->GetPosition();
+			it->mAngle = it->mBody->GetAngle();
+		}
+	}
+	// With no steps, the last ones are interpolated further
+	mBackTransforms = mCaptured;
+
+	mLastStepMs = static_cast<double>(start.elapsed()) / 1000.0;
+}
+
+void World::syncSprites(const std::vector<BodyTransform>& transforms, const float alpha) {
+	for (auto it = transforms.begin(), end = transforms.end(); it != end; ++it) {
+		const b2Vec2	pos = it->mPreviousPosition + alpha * (it->mPosition - it->mPreviousPosition);
+		const float		angle = it->mPreviousAngle + alpha * (it->mAngle - it->mPreviousAngle);
+		syncSprite(*it->mSprite, pos, angle);
+	}
+}
+
+void World::syncSprite(ds::ui::Sprite& sprite, const b2Vec2& position, const float angle) {
+	// Moving a sprite marks it dirty for the clients, so leave anything that hasn't really moved alone
+	const ci::vec3		pos = box2CiTranslation(position, &sprite);
+	const ci::vec3		delta = pos - sprite.getPosition();
+	if (delta.x * delta.x + delta.y * delta.y > mSyncThreshold * mSyncThreshold) {
+		sprite.setPosition(pos);
+	}
+
+	const float			degrees = ci::toDegrees(angle);
+	if (std::abs(degrees - sprite.getRotation().z) > mSyncThresholdDegrees) {
+		sprite.setRotation(degrees);
+	}
+}
+
+void World::forgetBody(const b2Body* body) {
+	auto				matches = [body](const BodyTransform& t) { return t.mBody == body; };
+	mCaptured.erase(std::remove_if(mCaptured.begin(), mCaptured.end(), matches), mCaptured.end());
+	mBackTransforms.erase(std::remove_if(mBackTransforms.begin(), mBackTransforms.end(), matches), mBackTransforms.end());
+	mFrontTransforms.erase(std::remove_if(mFrontTransforms.begin(), mFrontTransforms.end(), matches), mFrontTransforms.end());
+
+	std::lock_guard<std::mutex>	l(mChangeMutex);
+	mBodyChanges.erase(std::remove_if(mBodyChanges.begin(), mBodyChanges.end(), [body](const BodyChange& c) { return c.mBody == body; }), mBodyChanges.end());
+}
+
+void World::resetBody(const b2Body* body) {
+	auto				reset = [body](std::vector<BodyTransform>& transforms) {
+		for (auto it = transforms.begin(), end = transforms.end(); it != end; ++it) {
+			if (it->mBody != body) continue;
+			it->mPreviousPosition = it->mPosition = body->GetPosition();
+			it->mPreviousAngle = it->mAngle = body->GetAngle();
+		}
+	};
+	reset(mCaptured);
+	reset(mBackTransforms);
+	reset(mFrontTransforms);
+}
+
+void World::startStepThread() {
+	mStopStepThread = false;
+	mStepThread = std::thread([this]() { runStepThread(); });
+}
+
+void World::stopStepThread() {
+	if (!mStepThread.joinable()) return;
+	{
+		std::lock_guard<std::mutex>	l(mStepMutex);
+		mStopStepThread = true;
+	}
+	mStepCondition.notify_all();
+	mStepThread.join();
+}
+
+void World::runStepThread() {
+	while (true) {
+		int				steps = 0;
+		{
+			std::unique_lock<std::mutex>	l(mStepMutex);
+			mStepCondition.wait(l, [this]() { return mStopStepThread || mStepsRequested >= 0; });
+			if (mStopStepThread) {
+				mStepsRunning = false;
+				mStepCondition.notify_all();
+				return;
+			}
+			steps = mStepsRequested;
+			mStepsRequested = -1;
+		}
+
+		runSteps(steps);
+
+		{
+			std::lock_guard<std::mutex>	l(mStepMutex);
+			mStepsRunning = false;
+		}
+		mStepCondition.notify_all();
+	}
+}
+
+void World::waitForSteps() {
+	std::unique_lock<std::mutex>	l(mStepMutex);
+	mStepCondition.wait(l, [this]() { return !mStepsRunning; });
 }
 
 float World::getCi2BoxScale() const {
@@ -2,6 +2,11 @@
 #ifndef DS_PHYSICS_PRIVATE_WORLD_H_
 #define DS_PHYSICS_PRIVATE_WORLD_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <cinder/Vector.h>
 #include <ds/app/auto_draw.h>
@@ -31,11 +36,33 @@ class SpriteBody;
 
 /**
  * \class ds::physics::World
+ * \brief By default the world steps once per update, by the frame time (or step:fixed_amount with step:fixed),
+ *        and copies every awake body to its sprite. With step:accumulate it instead runs as many steps of
+ *        step:fixed_amount as the elapsed time calls for (up to step:max_sub_steps, extra time is dropped) and
+ *        sprites are interpolated between the last two steps. Adding step:threaded runs those steps on a
+ *        dedicated thread while the rest of the frame is updated and drawn, which puts sprites one update
+ *        behind the simulation. In that mode contact pre/post solve and begin/end functions are called on the
+ *        step thread; collision callbacks are still reported on the main thread. The step thread only holds the
+ *        world lock one step at a time, and forces and velocity changes made meanwhile are queued for the next one.
+ *        Sprites are only moved when their body has moved more than step:sync_threshold pixels or
+ *        step:sync_threshold_degrees.
  */
 class World : public ds::EngineService
 			, public ds::AutoUpdate {
 public:
-	World(ds::ui::SpriteEngine&, ds::ui::Sprite&);
+	/// settingsFile, if any, is read from the app's settings folder over physics.xml, so one world can step
+	/// differently from the others (say, threaded for a busy scene)
+	World(ds::ui::SpriteEngine&, ds::ui::Sprite&, const std::string& settingsFile = "");
+	~World();
+
+	/// Anything touching the b2World, its bodies or its joints needs to hold this, since the world may
+	/// be stepping on another thread. Recursive, so contact functions called during a step can call back in.
+	std::unique_lock<std::recursive_mutex>
+									lockWorld() const;
+	/// Runs fn on the body. If the world is busy stepping on the step thread, it's queued instead and run
+	/// just before the next step, so the main thread doesn't wait on the steps. Changes run in the order
+	/// they were made. Reading the body back right after a queued change can still answer the old value.
+	void							changeBody(b2Body&, const std::function<void(b2Body&)>& fn);
 
 	b2DistanceJoint*				createDistanceJoint(const SpriteBody&, const SpriteBody&, float length, float dampingRatio, float frequencyHz,
 													const ci::vec3 bodyAOffset = ci::vec3(0.0f, 0.0f, 0.0f), const ci::vec3 bodyBOffset = ci::vec3(0.0f, 0.0f, 0.0f));
@@ -68,12 +95,47 @@ public:
 
 	bool							isLocked() const;
 
+	/// Time spent in the last batch of steps (on whichever thread ran them), and on the main thread in the
+	/// last update (waiting for steps, reporting collisions and moving sprites)
+	double							getLastStepMs() const { return mLastStepMs; }
+	double							getLastSyncMs() const { return mLastSyncMs; }
+
 protected:
 	virtual void					update(const ds::UpdateParams&);
 
 private:
+	/// A dynamic body's transform before and after the most recent step
+	struct BodyTransform {
+		b2Body*						mBody;
+		ds::ui::Sprite*				mSprite;
+		b2Vec2						mPreviousPosition,
+									mPosition;
+		float						mPreviousAngle,
+									mAngle;
+	};
+
 	void							setBounds(const ci::Rectf&, const float restitution);
 
+	/// Answers the number of steps to run for the elapsed time, and sets the interpolation for after them
+	int								accumulate(const float dt, float& outAlpha);
+	/// Run the steps and capture the transforms into mBackTransforms. Takes the world lock one step at a
+	/// time, so the main thread never waits longer than a single step for it.
+	void							runSteps(const int count);
+	/// Run the queued body changes. The world lock must be held.
+	void							applyBodyChanges();
+	void							syncSprites(const std::vector<BodyTransform>&, const float alpha);
+	void							syncSprite(ds::ui::Sprite&, const b2Vec2& position, const float angle);
+	/// Called when a body is destroyed, so no transform refers to it
+	void							forgetBody(const b2Body*);
+	/// Called when a body is moved by hand, so the transforms captured before the move don't
+	/// interpolate it back. The world lock must be held.
+	void							resetBody(const b2Body*);
+
+	void							startStepThread();
+	void							stopStepThread();
+	void							runStepThread();
+	void							waitForSteps();
+
 	friend class ds::physics::SpriteBody;
 	friend class ds::physics::Touch;
 
@@ -107,6 +169,42 @@ private:
 	bool							mFixedStep;
 	float							mFixedStepAmount;
 
+	bool							mAccumulate;
+	bool							mThreaded;
+	int								mMaxSubSteps;
+	float							mAccumulator;
+	float							mSyncThreshold,
+									mSyncThresholdDegrees;
+
+	mutable std::recursive_mutex	mWorldMutex;
+	/// Written by whoever runs the steps, swapped into the front on the main thread once they're done
+	std::vector<BodyTransform>		mCaptured,
+									mBackTransforms,
+									mFrontTransforms;
+	float							mBackAlpha,
+									mFrontAlpha;
+
+	struct BodyChange {
+		b2Body*						mBody;
+		std::function<void(b2Body&)>	mFn;
+	};
+	/// Changes made while the steps were running. Guarded by mChangeMutex, not the world lock, so
+	/// queueing never waits; mApplyingChanges is only touched with the world lock held.
+	std::mutex						mChangeMutex;
+	std::vector<BodyChange>			mBodyChanges,
+									mApplyingChanges;
+
+	std::thread						mStepThread;
+	std::mutex						mStepMutex;
+	std::condition_variable			mStepCondition;
+	int								mStepsRequested;
+	bool							mStepsRunning;
+	bool							mStopStepThread;
+
+	/// Written on the step thread when threaded
+	std::atomic<double>				mLastStepMs;
+	double							mLastSyncMs;
+
 	std::vector<b2DistanceJoint*>	mDistanceJoints;
 	std::vector<b2WeldJoint*>		mWeldJoints;
 	std::vector<b2PrismaticJoint*>	mPrismaticJoints;
@@ -6,6 +6,7 @@ if( NOT TARGET video )
 		${VIDEO_SRC_PATH}/gstreamer/gstreamer_wrapper.cpp
 		${VIDEO_SRC_PATH}/gstreamer/gstreamer_env_check.cpp
 		${VIDEO_SRC_PATH}/gstreamer/video_meta_cache.cpp
+		${VIDEO_SRC_PATH}/gstreamer/video_frame_buffer.cpp
 		${VIDEO_SRC_PATH}/private/gst_video_service.cpp
 		${VIDEO_SRC_PATH}/ds/ui/sprite/panoramic_video.cpp
 		${VIDEO_SRC_PATH}/ds/ui/sprite/gst_video.cpp
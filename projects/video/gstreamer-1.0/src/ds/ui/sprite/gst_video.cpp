@@ -206,6 +206,7 @@ GstVideo::GstVideo(SpriteEngine& engine)
   , mStreaming(false)
   , mClientVideoCompleted(false)
   , mStreamingLatency(200000000) {
+	setNeedsUpdate(true);
 	mLayoutFixedAspect = true;
 	mBlobType		   = BLOB_TYPE;
 
@@ -246,6 +247,11 @@ float GstVideo::getVideoPlayingFramerate() {
 	return (float)(mBufferUpdateTimes.size() - 1) / deltaTime;
 }
 
+gstwrapper::VideoFrameStats GstVideo::getFrameStats() {
+	if (!mGstreamerWrapper) return gstwrapper::VideoFrameStats();
+	return mGstreamerWrapper->getFrameStats();
+}
+
 void GstVideo::setAutoSynchronize(const bool doSync) {
 	mDoSyncronization = doSync;
 	markAsDirty(mDoSyncDirty);
@@ -404,7 +410,9 @@ void GstVideo::updateVideoTexture() {
 			}
 		}
 
-		DS_LOG_VERBOSE(5, "GstVideo: New video frame gst fps:" << getVideoPlayingFramerate());
+		DS_LOG_VERBOSE(5, "GstVideo: New video frame gst fps:" << getVideoPlayingFramerate()
+							  << " dropped:" << mGstreamerWrapper->getFrameStats().mDropped
+							  << " late:" << mGstreamerWrapper->getFrameStats().mLate);
 	}
 }
 
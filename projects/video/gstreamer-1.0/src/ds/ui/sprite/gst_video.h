@@ -9,6 +9,7 @@
 #include <Poco/Timestamp.h>
 
 #include "gstreamer/gstreamer_audio_device.h"
+#include "gstreamer/video_frame_stats.h"
 
 namespace gstwrapper {
 class GStreamerWrapper;
@@ -205,6 +206,9 @@ class GstVideo : public Sprite {
 	/// Calculates a rough fps for how many actual buffers we're displaying per second
 	float getVideoPlayingFramerate();
 
+	/// How many frames the decoder delivered, how many were shown, and how many were dropped or late since the video loaded
+	gstwrapper::VideoFrameStats getFrameStats();
+
 	/// If true, will automatically synchronize clients based on ClientServer / Client setup
 	/// If false, will send state between client / server, but not attempt any synchronization of the video
 	/// For best results, set before loading movies
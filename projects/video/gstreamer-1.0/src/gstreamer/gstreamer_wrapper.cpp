@@ -18,7 +18,6 @@ static GstGLContext* sGstAsyncContext = nullptr;
 
 GStreamerWrapper::GStreamerWrapper()
   : mFileIsOpen(false)
-  , mVideoBuffer(NULL)
   , mAudioBuffer(NULL)
   , mGstPipeline(NULL)
   , mGstVideoSink(NULL)
@@ -102,6 +101,7 @@ void GStreamerWrapper::resetProperties() {
 	mSyncedMode			= false;
 	mStreamNeedsRestart = false;
 	mStreamingLatency   = 200000000;
+	mFrames.resetStats();
 }
 
 void GStreamerWrapper::parseFilename(const std::string& theFile) {
@@ -300,7 +300,6 @@ bool GStreamerWrapper::open(const std::string& strFilename, const bool bGenerate
 										   "height", G_TYPE_INT, mHeight, NULL);
 			}
 
-			mVideoBuffer = new unsigned char[mVideoBufferSize];
 			gst_app_sink_set_caps(GST_APP_SINK(mGstVideoSink), caps);
 			gst_caps_unref(caps);
 
@@ -619,7 +618,6 @@ bool GStreamerWrapper::openStream(const std::string& streamingPipeline, const in
 	// Set some fix caps for the video sink
 	// 1.5 * w * h, for I420 color space, which has a full-size luma channel, and 1/4 size U and V color channels
 	mVideoBufferSize = (int)(1.5 * mWidth * mHeight);
-	mVideoBuffer	 = new unsigned char[mVideoBufferSize];
 
 	// Tell the video appsink that it should not emit signals as the buffer retrieving is handled via callback methods
 	g_object_set(mGstVideoSink, "emit-signals", false, (void*)NULL);
@@ -706,8 +704,6 @@ bool GStreamerWrapper::parseLaunch(const std::string& fullPipeline, const int vi
 		mVideoBufferSize = (int)(1.5 * mWidth * mHeight);
 	}
 
-	mVideoBuffer = new unsigned char[mVideoBufferSize];
-
 	mGstVideoSink	 = gst_bin_get_by_name(GST_BIN(mGstPipeline), videoSinkName.c_str());
 	mGstVolumeElement = gst_bin_get_by_name(GST_BIN(mGstPipeline), volumeElementName.c_str());
 	mGstPanorama	  = gst_bin_get_by_name(GST_BIN(mGstPipeline), "panorama0");
@@ -870,13 +866,6 @@ void GStreamerWrapper::close() {
 		if(sGstAsyncContext) {
 		//	gst_object_unref(sGstAsyncContext);
 		}
-
-		if(mCurrentBuffer) {
-			mCurrentBuffer.reset();
-		}
-		if(mNewBuffer) {
-			mNewBuffer.reset();
-		}
 	}
 
 	// Cleanup member variables under mutex
@@ -889,8 +878,8 @@ void GStreamerWrapper::close() {
 		mGstPanorama  = NULL;
 		mGstBus		  = NULL;
 
-		delete[] mVideoBuffer;
-		mVideoBuffer = NULL;
+		// The pipeline is stopped, so nothing can publish a frame while these are released
+		mFrames.clear();
 
 		delete[] mAudioBuffer;
 		mAudioBuffer = NULL;
@@ -1123,20 +1112,33 @@ void GStreamerWrapper::setNVDecode(const bool nvDecode) {
 }
 
 unsigned char* GStreamerWrapper::getVideo() {
-	std::lock_guard<std::mutex> lock(mVideoMutex);
 	mIsNewVideoFrame = false;
-	return mVideoBuffer;
+	mFrames.acquire();
+
+	size_t		   frameSize = 0;
+	unsigned char* frameData = mFrames.mapFront(frameSize);
+	if(!frameData) return nullptr;
+
+	// sanity check on buffer size, in case something weird happened.
+	if(frameSize < mVideoBufferSize) {
+		DS_LOG_WARNING("Unexpected buffer size returned!");
+		return nullptr;
+	}
+	mVideoBufferSize = frameSize;
+	return frameData;
 }
 
 ci::gl::Texture2dRef GStreamerWrapper::getVideoTexture() {
 	if(mGlMode && mIsNewVideoFrame) {
-		{
-			std::lock_guard<std::mutex> guard(mVideoMutex);
-			std::swap(mCurrentBuffer, mNewBuffer);
+		mFrames.acquire();
+		GstSample* frontSample = mFrames.getFrontSample();
+		if(!frontSample) {
+			mIsNewVideoFrame = false;
+			return mVideoTexture;
 		}
 
 		GLint id = 0;
-		GstMemory *mem = gst_buffer_peek_memory(mCurrentBuffer.get(), 0);
+		GstMemory *mem = gst_buffer_peek_memory(gst_sample_get_buffer(frontSample), 0);
 		
 		if(gst_is_gl_memory(mem)) {
 			id = ((GstGLMemory *)mem)->tex_id;
@@ -1668,63 +1670,40 @@ GstFlowReturn GStreamerWrapper::onNewBufferFromAudioSource(GstAppSink* appsink,
 	return GST_FLOW_OK;
 }
 
-void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample) {
-	std::lock_guard<std::mutex> lock(mVideoMutex);
-
-	if(mGlMode) {
-		mNewBuffer = std::shared_ptr<GstBuffer>(gst_buffer_ref(gst_sample_get_buffer(videoSinkSample)), &gst_buffer_unref);
-		if(!mPendingSeek) mIsNewVideoFrame = true;
-		return;
-	}
-
-	GstMapFlags flags = GST_MAP_READ;
-
-	if(!mVideoBuffer) return;
-
-	GstVideoInfo info;
-	GstCaps* currentCaps = gst_sample_get_caps(videoSinkSample);
-	gboolean success = gst_video_info_from_caps(&info, currentCaps);
-	if(info.width != mWidth || info.height != mHeight) {
-		DS_LOG_WARNING("RUH ROH! " << mWidth << " " << info.width);
-	}
-
-	GstBuffer* buff = gst_sample_get_buffer(videoSinkSample);
-	GstMapInfo  map;
-	gst_buffer_map(buff, &map, flags);
+void GStreamerWrapper::handleVideoBuffer(GstSample* videoSinkSample, const bool isPreroll) {
+	// No copy and no lock, the render thread maps the sample in getVideo() or getVideoTexture().
+	// If it hasn't gotten to the previous frame yet, that frame is dropped instead of holding up the pipeline.
+	mFrames.publish(videoSinkSample, !isPreroll && isLateSample(videoSinkSample));
 
-	size_t videoBufferSize = map.size;
+	if(!isPreroll || !mPendingSeek) mIsNewVideoFrame = true;
+}
 
-	bool errored = false;
-	// sanity check on buffer size, in case something weird happened.
-	if(mVideoBufferSize != videoBufferSize) {
+bool GStreamerWrapper::isLateSample(GstSample* videoSinkSample) {
+	GstBuffer*  buff	= gst_sample_get_buffer(videoSinkSample);
+	GstSegment* segment = gst_sample_get_segment(videoSinkSample);
+	if(!buff || !segment || !mGstVideoSink || !GST_BUFFER_PTS_IS_VALID(buff)) return false;
 
-		delete[] mVideoBuffer;
-		mVideoBuffer = nullptr;
-		if(videoBufferSize > mVideoBufferSize) {
-			mVideoBufferSize = videoBufferSize;
-			mVideoBuffer = new unsigned char[mVideoBufferSize];
-		} else {
-			DS_LOG_WARNING("Unexpected buffer size returned!");
-			errored = true;
-		}
-	}
+	const GstClockTime runningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buff));
+	if(!GST_CLOCK_TIME_IS_VALID(runningTime)) return false;
 
-	if(!errored) {
-		memcpy((unsigned char*)mVideoBuffer, map.data, videoBufferSize);
-		gst_buffer_unmap(buff, &map);
+	GstClock* clock = gst_element_get_clock(mGstVideoSink);
+	if(!clock) return false;
 
-		if(!mPendingSeek) mIsNewVideoFrame = true;
-	}
+	const GstClockTime now		= gst_clock_get_time(clock);
+	const GstClockTime baseTime = gst_element_get_base_time(mGstVideoSink);
+	gst_object_unref(clock);
 
+	// The sink releases frames right at their presentation time, so allow a frame's worth of slack
+	const GstClockTime slack = GST_BUFFER_DURATION_IS_VALID(buff) ? GST_BUFFER_DURATION(buff) : 20 * GST_MSECOND;
+	return now > baseTime && now - baseTime > runningTime + slack;
 }
 
 void GStreamerWrapper::newVideoSinkPrerollCallback(GstSample* videoSinkSample) {
-	handleVideoBuffer(videoSinkSample);
+	handleVideoBuffer(videoSinkSample, true);
 }
 
 void GStreamerWrapper::newVideoSinkBufferCallback(GstSample* videoSinkSample) {
-	handleVideoBuffer(videoSinkSample);
-	mIsNewVideoFrame = true;
+	handleVideoBuffer(videoSinkSample, false);
 }
 
 void GStreamerWrapper::newAudioSinkPrerollCallback(GstSample* audioSinkBuffer) {
@@ -15,6 +15,7 @@ struct GLeglImageOES {};
 #include <gst/gl/gl.h>
 
 #include "gstreamer_audio_device.h"
+#include "video_frame_buffer.h"
 
 #include <atomic>
 #include <functional>
@@ -264,13 +265,21 @@ class GStreamerWrapper {
 
 	/*
 	Returns an unsigned char pointer containing the pixel data for the currently decoded frame.
-	Returns NULL if there is either no video stream in the media file, no media file has been opened or something
-	went wrong while streaming
+	The pixels are the decoded GStreamer buffer itself (no copy), and stay valid until the next call to getVideo() or close().
+	Returns NULL if there is either no video stream in the media file, no media file has been opened, no frame has been
+	decoded yet or something went wrong while streaming
 	*/
 	unsigned char* getVideo();
 
 	size_t getVideoBufferSize() { return mVideoBufferSize; }
 
+	/*
+	Counts of frames received from the decoder, picked up for display, dropped because a newer frame replaced them before
+	they were displayed, and delivered after their presentation time
+	*/
+	VideoFrameBuffer::Stats getFrameStats() const { return mFrames.getStats(); }
+	void					resetFrameStats() { mFrames.resetStats(); }
+
 	/* OpenGL mode only - returns a texture ref if there is video. Will be an empty ref otherwise*/
 	ci::gl::Texture2dRef getVideoTexture();
 	
@@ -598,11 +607,13 @@ class GStreamerWrapper {
 	static GstFlowReturn onNewBufferFromAudioSource(GstAppSink* appsink, void* listener);
 
 	/// internal buffer handling
-	void handleVideoBuffer(GstSample* videoSinkSample);
+	void handleVideoBuffer(GstSample* videoSinkSample, const bool isPreroll);
+
+	/// True if the sample reached the sink more than a frame after its presentation time
+	bool isLateSample(GstSample* videoSinkSample);
 	/*
 	Non-static method that is called inside "onNewPrerollFromVideoSource()" in order to handle
-	member variables that are non-static. Here the unsigned char array with the pixel data is actually filled
-	and also allocated if is NULL
+	member variables that are non-static. Here the sample is handed over to the render thread through mFrames
 
 	params:
 	@videoSinkBuffer: The buffer that was gathered from the video sink
@@ -611,7 +622,7 @@ class GStreamerWrapper {
 
 	/*
 	Non-static method that is called inside "onNewBufferFromVideoSource()" in order to handle
-	member variables that are non-static. Here the unsigned char array with the pixel data is actually filled
+	member variables that are non-static. Here the sample is handed over to the render thread through mFrames
 
 	params:
 	@videoSinkBuffer: The buffer that was gathered from the video sink
@@ -672,8 +683,6 @@ class GStreamerWrapper {
 	bool		   mGlMode;				 ///<  If we're using GStreamer's openGL capabilities, outputs a texture instead of a buffer
 	bool		   mNVDecode;			 ///<  Uses NVidia CUDA to decode videos, support is limited
 
-	std::shared_ptr<GstBuffer> mCurrentBuffer;		 ///<  For GL Mode
-	std::shared_ptr<GstBuffer> mNewBuffer;			 ///<  For GL Mode
 	ci::gl::Texture2dRef       mVideoTexture;		 ///<  For GL Mode
 
 	std::function<void(GStreamerWrapper*)>  mVideoCompleteCallback;
@@ -715,8 +724,8 @@ class GStreamerWrapper {
 	PlayDirection  mPlayDirection;		 ///<  The current playback direction
 	ContentType    mContentType;  ///<  Describes whether the currently loaded media file contains only video / audio streams or both
 
-	unsigned char* mVideoBuffer;	  ///<  Stores the video pixels
-	size_t		   mVideoBufferSize;  ///<  Number of bytes in mVideoBuffer
+	VideoFrameBuffer mFrames;			///<  Hands decoded samples from the streaming thread to the render thread
+	size_t			 mVideoBufferSize;  ///<  Number of bytes in a video frame
 
 	GstElement* mGstVideoSink;  ///<  Video sink that contains the raw video buffer. Gathered from the pipeline
 	GstAppSinkCallbacks
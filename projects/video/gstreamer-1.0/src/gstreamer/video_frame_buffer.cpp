@@ -0,0 +1,113 @@
+#include "stdafx.h"
+
+#include "video_frame_buffer.h"
+
+namespace gstwrapper {
+
+VideoFrameStats::VideoFrameStats()
+  : mReceived(0)
+  , mDisplayed(0)
+  , mDropped(0)
+  , mLate(0) {}
+
+VideoFrameBuffer::Slot::Slot()
+  : mSample(nullptr)
+  , mMapped(false) {}
+
+VideoFrameBuffer::VideoFrameBuffer()
+  : mBack(0)
+  , mFront(1)
+  , mReady(2)
+  , mReceived(0)
+  , mDisplayed(0)
+  , mDropped(0)
+  , mLate(0) {}
+
+VideoFrameBuffer::~VideoFrameBuffer() { clear(); }
+
+void VideoFrameBuffer::publish(GstSample* sample, const bool late) {
+	if (!sample) return;
+
+	Slot& back	 = mSlots[mBack];
+	back.mSample = gst_sample_ref(sample);
+
+	const int previous = mReady.exchange(mBack | kFreshBit);
+	mBack			   = previous & kIndexMask;
+
+	mReceived++;
+	if (late) mLate++;
+
+	if (previous & kFreshBit) mDropped++;
+
+	// Either a frame the reader never saw or an empty slot it handed back. Let it go now rather than at the next frame
+	release(mSlots[mBack]);
+}
+
+bool VideoFrameBuffer::acquire() {
+	// Only the reader clears the fresh bit, so if it's set here it's still set at the exchange below
+	if (!(mReady.load() & kFreshBit)) return false;
+
+	// The slot goes back to the writer, so it can't still be mapped or hold on to its sample
+	release(mSlots[mFront]);
+	mFront = mReady.exchange(mFront) & kIndexMask;
+
+	mDisplayed++;
+	return true;
+}
+
+bool VideoFrameBuffer::hasNewFrame() const { return (mReady.load() & kFreshBit) != 0; }
+
+GstSample* VideoFrameBuffer::getFrontSample() const { return mSlots[mFront].mSample; }
+
+unsigned char* VideoFrameBuffer::mapFront(size_t& outSize) {
+	outSize		= 0;
+	Slot& front = mSlots[mFront];
+	if (!front.mSample) return nullptr;
+
+	if (!front.mMapped) {
+		GstBuffer* buff = gst_sample_get_buffer(front.mSample);
+		if (!buff || !gst_buffer_map(buff, &front.mMap, GST_MAP_READ)) return nullptr;
+		front.mMapped = true;
+	}
+
+	outSize = front.mMap.size;
+	return front.mMap.data;
+}
+
+void VideoFrameBuffer::clear() {
+	for (auto& slot : mSlots) {
+		release(slot);
+	}
+	mBack  = 0;
+	mFront = 1;
+	mReady = 2;
+}
+
+VideoFrameBuffer::Stats VideoFrameBuffer::getStats() const {
+	Stats stats;
+	stats.mReceived  = mReceived;
+	stats.mDisplayed = mDisplayed;
+	stats.mDropped   = mDropped;
+	stats.mLate		 = mLate;
+	return stats;
+}
+
+void VideoFrameBuffer::resetStats() {
+	mReceived  = 0;
+	mDisplayed = 0;
+	mDropped   = 0;
+	mLate	  = 0;
+}
+
+void VideoFrameBuffer::release(Slot& slot) {
+	if (slot.mMapped) {
+		gst_buffer_unmap(gst_sample_get_buffer(slot.mSample), &slot.mMap);
+		slot.mMapped = false;
+	}
+	if (slot.mSample) {
+		gst_sample_unref(slot.mSample);
+		slot.mSample = nullptr;
+	}
+}
+
+};  // namespace gstwrapper
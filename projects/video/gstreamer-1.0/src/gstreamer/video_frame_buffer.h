@@ -0,0 +1,76 @@
+#pragma once
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "video_frame_stats.h"
+
+namespace gstwrapper {
+
+/*
+class VideoFrameBuffer
+
+Hands decoded video samples from the appsink streaming thread to the render thread without copying and without either
+side waiting on the other. Three slots rotate between the writer (the appsink callback), a shared "ready" slot and the
+reader (the render thread), swapped with a single atomic exchange.
+
+The writer never blocks: if the reader didn't pick up the previous frame before the next one arrived, the stale frame is
+released and counted as dropped. The reader keeps a reference to its GstSample and maps it in place, so the pixels it gets
+stay valid until its next acquire(). At most two samples are held at once, so decoder buffer pools aren't starved.
+*/
+class VideoFrameBuffer {
+  public:
+	typedef VideoFrameStats Stats;
+
+	VideoFrameBuffer();
+	~VideoFrameBuffer();
+
+	/* Streaming thread only. Takes its own reference to the sample. */
+	void publish(GstSample* sample, const bool late);
+
+	/* Render thread only. Swaps in the newest published frame, if there is one. Returns true if the front frame changed. */
+	bool acquire();
+
+	/* Render thread only. True if a frame has been published since the last acquire() */
+	bool hasNewFrame() const;
+
+	/* Render thread only. The sample from the last acquire(), or nullptr. Valid until the next acquire() or clear() */
+	GstSample* getFrontSample() const;
+
+	/* Render thread only. Maps the front sample for reading (once per frame) and returns the data, or nullptr if there's no
+	 * frame. Valid until the next acquire() or clear() */
+	unsigned char* mapFront(size_t& outSize);
+
+	/* Releases every sample. Only call this when the streaming thread can't publish, e.g. after the pipeline is stopped */
+	void clear();
+
+	Stats getStats() const;
+	void  resetStats();
+
+  private:
+	struct Slot {
+		Slot();
+		GstSample* mSample;
+		GstMapInfo mMap;
+		bool	   mMapped;
+	};
+
+	static void release(Slot&);
+
+	static const int kIndexMask = 0x3;
+	static const int kFreshBit  = 0x4;
+
+	Slot			 mSlots[3];
+	int				 mBack;   ///<  Owned by the streaming thread
+	int				 mFront;  ///<  Owned by the render thread
+	std::atomic<int> mReady;  ///<  Slot index of the newest frame, plus kFreshBit if it hasn't been acquired yet
+
+	std::atomic<uint64_t> mReceived;
+	std::atomic<uint64_t> mDisplayed;
+	std::atomic<uint64_t> mDropped;
+	std::atomic<uint64_t> mLate;
+};
+
+};  // namespace gstwrapper
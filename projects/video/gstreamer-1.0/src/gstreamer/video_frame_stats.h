@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gstwrapper {
+
+/*
+struct VideoFrameStats
+
+Counts of the frames a VideoFrameBuffer handed from the streaming thread to the render thread. Separate from the buffer so
+headers that only report them, like GstVideo's, don't pull in GStreamer's headers.
+*/
+struct VideoFrameStats {
+	VideoFrameStats();
+	uint64_t mReceived;   ///<  Frames published by the streaming thread
+	uint64_t mDisplayed;  ///<  Frames picked up by the render thread
+	uint64_t mDropped;	///<  Frames replaced before the render thread got to them
+	uint64_t mLate;		  ///<  Frames that arrived after their presentation time
+};
+
+};  // namespace gstwrapper
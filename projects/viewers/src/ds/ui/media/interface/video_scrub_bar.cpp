@@ -23,6 +23,7 @@ VideoScrubBar::VideoScrubBar(ds::ui::SpriteEngine& eng, const float heighty, con
 	, mLinkedPdf(nullptr)
 	, mLinkedYouTube(nullptr)
 {
+	setNeedsUpdate(true);
 
 	// 	setTransparent(false);
 	// 	setColor(ci::Color(0.0f, 0.5f, 0.0f));
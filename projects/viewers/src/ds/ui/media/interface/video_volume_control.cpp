@@ -20,6 +20,7 @@ VideoVolumeControl::VideoVolumeControl(ds::ui::SpriteEngine& eng, const float th
 	, mLinkedYouTube(nullptr)
 	, mOffOpacity(0.2f)
 {
+	setNeedsUpdate(true);
 	//setTransparent(false);
 	//setColor(ci::Color(0.5f, 0.0f, 0.0f));
 
@@ -28,6 +28,7 @@ MediaInterface::MediaInterface(ds::ui::SpriteEngine& eng, const ci::vec2& sizey,
   , mInterfaceIdleSettings(5.0f)
   , mCanIdle(true)
   , mCanDisplay(true) {
+	setNeedsUpdate(true);
 	// TODO: settings?
 	const float backOpacccy = 0.95f;
 
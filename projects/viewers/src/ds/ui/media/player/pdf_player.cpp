@@ -21,6 +21,7 @@ namespace ui {
 
 PDFPlayer::PDFPlayer(ds::ui::SpriteEngine& eng, bool embedInterface)
   : ds::ui::IPdf(eng)
+  , mThumbnailer(eng)
   , mPdfInterface(nullptr)
   , mEmbedInterface(embedInterface)
   , mInterfaceBelowMedia(false)
@@ -61,51 +62,50 @@ PDFPlayer::PDFPlayer(ds::ui::SpriteEngine& eng, bool embedInterface)
 
 void PDFPlayer::setMedia(const std::string mediaPath) { setResource(ds::Resource(mediaPath)); }
 
-void PDFPlayer::loadNextPage() {
-	mLoadingCount++;
+void PDFPlayer::loadPageWindow() {
+	if(mNumPages < 1) return;
 
-	// prevent an infinite loop if we're already loaded and there's only a few pages
-	if(mLoadingCount > mNumPages){
-		//std::cout << "Cancelling loads cause we've loaded everything" << std::endl;
-		return;
+	const int firstPage = std::max(1, mCurrentPage - mRenderBehindPages);
+	const int lastPage = std::min(mNumPages, mCurrentPage + mRenderAheadPages);
+
+	// The current page goes first so it's at the front of the render queue
+	auto findy = mPages.find(mCurrentPage);
+	if(findy != mPages.end()) loadPage(findy->second, findy->first);
+
+	for(int i = firstPage; i <= lastPage; i++) {
+		if(i == mCurrentPage) continue;
+		findy = mPages.find(i);
+		if(findy != mPages.end()) loadPage(findy->second, findy->first);
 	}
+}
 
-	
-	// only load a few pages ahead, cause we don't know how many pdfs could be onscreen at once
-	if(mLoadedPage > mCurrentPage + mRenderAheadPages) {
-		return;
+void PDFPlayer::loadPage(ds::ui::Pdf* thePdf, const int pageNum) {
+	if(thePdf->getResourceFilename() != mResourceFilename) {
+		thePdf->setResourceFilename(mResourceFilename);
+		thePdf->setPageNum(pageNum);
 	}
-	
-	mLoadedPage++;
 
-	// don't loop around when loading
-	if(mLoadedPage > mPages.size()) {
-		return;
+	/// this changes the scale, which kicks off a re-render if needed
+	/// hidden pages render at background priority, so they don't hold up the visible one
+	fitInside(thePdf, ci::Rectf(0.0f, 0.0f, getWidth(), getHeight()), mLetterbox);
+}
 
-		// tried out looping around, but just skip it
-//		mLoadedPage = 1;
-	}
-	
-	auto findy = mPages.find(mLoadedPage);
-	if(findy != mPages.end()) {
-		auto thePdf = findy->second;
-		if(thePdf->getResourceFilename() != mResourceFilename) {
-			thePdf->setResourceFilename(mResourceFilename);
-			thePdf->setPageNum(findy->first);
-		}
+void PDFPlayer::setRenderAheadPages(const int numPages) {
+	mRenderAheadPages = std::max(0, numPages);
+	loadPageWindow();
+}
 
-		float preW = thePdf->getScale().x;
+void PDFPlayer::setRenderBehindPages(const int numPages) {
+	mRenderBehindPages = std::max(0, numPages);
+	loadPageWindow();
+}
 
-		const float w = getWidth();
-		const float h = getHeight();
-		/// this changes the scale, which kicks off a re-render
-		/// that will end in a page load notification which hits this function again
-		fitInside(thePdf, ci::Rectf(0.0f, 0.0f, w, h), mLetterbox);
+void PDFPlayer::onThumbnailsGenerated(const std::vector<ds::Resource>& thumbnails) {
+	if(thumbnails.size() < 2) return;
 
-		/// if the pdf didn't change scale, it won't re-render, so just move ahead
-		if(thePdf->getScale().x == preW) {
-			loadNextPage();
-		}
+	mSourceResource.setChildrenResources(thumbnails);
+	if(mPdfInterface) {
+		mPdfInterface->linkPDF(this, mSourceResource);
 	}
 }
 
@@ -114,6 +114,8 @@ void PDFPlayer::setResource(const ds::Resource& mediaResource) {
 	mSourceResource	= mediaResource;
 	mResourceFilename = mSourceResource.getAbsoluteFilePath();
 
+	mThumbnailer.cancel();
+
 	ci::vec2 prevSize = ci::vec2(0.0f, 0.0f);
 
 	for (auto it : mPages){
@@ -123,7 +125,6 @@ void PDFPlayer::setResource(const ds::Resource& mediaResource) {
 	mPages.clear();
 
 	mCurrentPage = 1;
-	mLoadingCount = 0;
 	
 	if(mPdfInterface) {
 		mPdfInterface->linkPDF(nullptr, ds::Resource());
@@ -141,7 +142,6 @@ void PDFPlayer::setResource(const ds::Resource& mediaResource) {
 		newPdf->setPageLoadedCallback([this, thePage] {
 			//std::cout << "Page loaded: " << thePage << std::endl;
 			if(mGoodStatusCallback) mGoodStatusCallback();
-			loadNextPage();
 
 			if(mPdfInterface) {
 				mPdfInterface->updateWidgets();
@@ -151,7 +151,6 @@ void PDFPlayer::setResource(const ds::Resource& mediaResource) {
 		if(firsty) {
 			newPdf->setResourceFilename(mResourceFilename);
 			newPdf->setPageNum(thePage);
-			mLoadedPage = 1;
 
 			newPdf->setPageSizeChangedFn([this] {
 				layout();
@@ -219,6 +218,12 @@ void PDFPlayer::setResource(const ds::Resource& mediaResource) {
 	}
 
 	setSize(theW, theH);
+
+	if(mThumbnailHeight > 0 && mNumPages > 1 && mSourceResource.getChildrenResources().size() < 2) {
+		mThumbnailer.generate(mResourceFilename, mThumbnailHeight, [this](const std::vector<ds::Resource>& thumbnails) {
+			onThumbnailsGenerated(thumbnails);
+		});
+	}
 }
 
 void PDFPlayer::onSizeChanged() { layout(); }
@@ -227,10 +232,7 @@ void PDFPlayer::layout() {
 	const float w = getWidth();
 	const float h = getHeight();
 
-	mLoadedPage = mCurrentPage - 1;
-	mLoadingCount = 0;
-
-	loadNextPage();
+	loadPageWindow();
 
 	if (mPdfInterface) {
 		mPdfInterface->setSize(w * 2.0f / 3.0f, mPdfInterface->getHeight());
@@ -313,10 +315,8 @@ void PDFPlayer::setPageNum(const int pageNum) {
 		mPdfInterface->updateWidgets();
 	}
 
-	// ensure the current page is loaded
-	mLoadingCount = 0;
-	mLoadedPage = mCurrentPage - 1;
-	loadNextPage();
+	// ensure the current page and its neighbours are loaded
+	loadPageWindow();
 }
 
 int PDFPlayer::getPageNum() const {
@@ -5,6 +5,7 @@
 #include <ds/data/resource.h>
 #include <ds/ui/sprite/sprite.h>
 #include <ds/ui/sprite/pdf.h>
+#include <ds/ui/sprite/pdf_thumbnailer.h>
 
 namespace ds {
 namespace ui {
@@ -18,6 +19,10 @@ struct MediaViewerSettings;
  *			Note: for PDF thumbnail viewer to show up, the PDF needs to be loaded via a Resource
  *					that has a children vector of resources of the thumbnails set, and the children need to have the correct parentIndex
  *(i.e. page number) set.
+ *					Setting a thumbnail height generates them in the background for resources that have none (cached
+ *					to disk), and the thumbnail bar picks them up when they're done. See setThumbnailHeight().
+ *			Pages within setRenderAheadPages() / setRenderBehindPages() of the current page are all queued for rendering
+ *			together, so the render pool can work on them in parallel and flipping to them is instant.
  */
 class PDFPlayer : public ds::ui::IPdf {
   public:
@@ -73,20 +78,34 @@ class PDFPlayer : public ds::ui::IPdf {
 	virtual void showLinks();
 	virtual void hideLinks();
 
+	/// How many pages after and before the current page to keep rendered at display resolution. Defaults to 3 and 1
+	void setRenderAheadPages(const int numPages);
+	void setRenderBehindPages(const int numPages);
+
+	/// The height in pixels of generated thumbnails. Defaults to 0, which doesn't generate any: generating means hashing
+	/// the whole file and writing a png per page, so only turn it on for players that show the thumbnail bar.
+	/// Applies on the next setResource()
+	void setThumbnailHeight(const int thumbHeight) { mThumbnailHeight = thumbHeight; }
+
   protected:
 	virtual void	onSizeChanged();
 
-	void loadNextPage();
+	/// Queue renders for every page in the prefetch window around the current page
+	void loadPageWindow();
+	void loadPage(ds::ui::Pdf* thePdf, const int pageNum);
+	void onThumbnailsGenerated(const std::vector<ds::Resource>& thumbnails);
 
 	std::map<int, ds::ui::Pdf*> mPages;
 	ds::Resource	mSourceResource;
 	std::string		mResourceFilename;
 
 	int			mCurrentPage = 0;
-	int			mLoadedPage = 0;
-	int			mLoadingCount = 0;
 	int			mNumPages = 0;
 	int			mRenderAheadPages = 3;
+	int			mRenderBehindPages = 1;
+	int			mThumbnailHeight = 0;
+
+	ds::pdf::PdfThumbnailer					mThumbnailer;
 
 	PDFInterface*							mPdfInterface;
 	bool									mEmbedInterface;
@@ -29,6 +29,7 @@ StreamPlayer::StreamPlayer(ds::ui::SpriteEngine& eng, const bool embedInterface)
   , mLetterbox(true)
   , mInterfaceBelowMedia(false)
   , mVolume(1.0f) {
+	setNeedsUpdate(true);
 	mLayoutFixedAspect = true;
 }
 
@@ -32,6 +32,7 @@ BasePanel::BasePanel(ds::ui::SpriteEngine& engine)
 	, mAutoSendToFront(true)
 	, mPositionUpdateCallback(nullptr)
 {
+	setNeedsUpdate(true);
 
 	mLayoutFixedAspect = true;
 
@@ -113,6 +113,7 @@ Web::Web( ds::ui::SpriteEngine &engine, float width, float height )
 	, mCallbacksCue(nullptr)
 	, mNativeTouchInput(true)
 {
+	setNeedsUpdate(true);
 	// Should be unnecessary, but really want to make sure that static gets initialized
 	INIT.doNothing();
 
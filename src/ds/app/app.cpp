@@ -14,6 +14,7 @@
 #include "ds/app/environment.h"
 #include "ds/debug/logger.h"
 #include "ds/debug/debug_defines.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/content/content_events.h"
 #include "ds/network/https_client.h"
 
@@ -193,7 +194,8 @@ void App::prepareSettings(ci::app::AppBase::Settings *settings) {
 	if (settings) {
 		mEngine.prepareSettings(*settings);
 		settings->setWindowPos(static_cast<unsigned>(mEngineData.mDstRect.x1), static_cast<unsigned>(mEngineData.mDstRect.y1));
-		inherited::setFrameRate(settings->getFrameRate());
+		if(settings->isFrameRateEnabled()) inherited::setFrameRate(settings->getFrameRate());
+		else inherited::disableFrameRate();
 		inherited::setWindowSize(settings->getWindowSize());
 		inherited::setWindowPos(settings->getWindowPos());
 		inherited::setFullScreen(settings->isFullScreen());
@@ -307,6 +309,9 @@ void App::preServerSetup() {
 }
 
 void App::update() {
+	ds::FrameProfiler::nextFrame();
+	DS_PROFILE_SCOPE("App::update");
+
 #ifdef _WIN32
 	if(mEngine.getEngineSettings().getBool("system:never_sleep", 0, true)) {
 		// prevents the system from going to sleep
@@ -349,6 +354,7 @@ void App::update() {
 }
 
 void App::draw() {
+	DS_PROFILE_SCOPE("App::draw");
 	mEngine.draw();
 }
 void App::mouseDown(ci::app::MouseEvent e) {
@@ -471,6 +477,8 @@ void App::setupKeyPresses() {
 	mKeyManager.registerKey("Toggle console", [this] {mEngine.toggleConsole(); }, KeyEvent::KEY_c);
 	mKeyManager.registerKey("Touch mode", [this] {mEngine.nextTouchMode(); }, KeyEvent::KEY_t, true);
 	mKeyManager.registerKey("Take screenshot", [this] {saveTransparentScreenshot(); }, KeyEvent::KEY_F8);
+	mKeyManager.registerKey("Cycle frame profiler", [this] { ds::FrameProfiler::setLevel((ds::FrameProfiler::getLevel() + 1) % 3); }, KeyEvent::KEY_F7);
+	mKeyManager.registerKey("Save profiler trace", [this] { saveProfilerTrace(); }, KeyEvent::KEY_F9);
 	mKeyManager.registerKey("Kill supporting apps", [this] { killSupportingApps(); }, KeyEvent::KEY_k, false, true);
 	mKeyManager.registerKey("Toggle mouse", [this] { mEngine.setHideMouse(!mEngine.getHideMouse()); }, KeyEvent::KEY_m);
 	mKeyManager.registerKey("Verbose logging toggle", [this] { if(ds::getLogger().getVerboseLevel() > 0) ds::getLogger().setVerboseLevel(0); else ds::getLogger().setVerboseLevel(9); }, KeyEvent::KEY_v);
@@ -582,6 +590,25 @@ void App::saveTransparentScreenshot() {
 	ci::writeImage(Poco::Path::expand(p.toString()), copyWindowSurface());
 }
 
+void App::saveProfilerTrace() {
+	if(ds::FrameProfiler::getLevel() == ds::FrameProfiler::OFF) {
+		DS_LOG_WARNING("App::saveProfilerTrace() the frame profiler is off, turn it on with F7 or the profiler:level setting");
+		return;
+	}
+
+	Poco::Path		p(Poco::Path::home());
+	Poco::Timestamp::TimeVal t = Poco::Timestamp().epochMicroseconds();
+	std::stringstream filepath;
+	filepath << "ds_cinder.trace." << t << ".json";
+	p.append("Desktop").append(filepath.str());
+	const std::string path = Poco::Path::expand(p.toString());
+	if(ds::FrameProfiler::writeChromeTrace(path)) {
+		DS_LOG_INFO("Saved profiler trace to " << path);
+	} else {
+		DS_LOG_WARNING("App::saveProfilerTrace() couldn't write " << path);
+	}
+}
+
 void App::quit() {
 	if(mEngine.getEngineSettings().getBool("apphost:exit_on_quit", 0, true)) {
 		DS_LOG_INFO("Requesting Apphost to exit...");
@@ -120,6 +120,9 @@ public:
 	/// Triggered by F8 key, saves a transparent png on the desktop
 	void						saveTransparentScreenshot();
 
+	/// Triggered by F9 key, saves the frame profiler's buffers as a Chrome trace on the desktop
+	void						saveProfilerTrace();
+
 	/// Kills RoC, dsnode, then this app
 	void						killSupportingApps();
 
@@ -13,10 +13,12 @@ namespace ds {
  */
 AutoUpdate::AutoUpdate(ds::ui::SpriteEngine &e, const int mask)
 		: mEngine(e)
-		, mMask(mask) {
+		, mMask(mask)
+		, mServerEntry(nullptr)
+		, mClientEntry(nullptr) {
 	try {
-		if ((mask&AutoUpdateType::SERVER) != 0) e.getAutoUpdateList(AutoUpdateType::SERVER).addWaiting(this);
-		if ((mask&AutoUpdateType::CLIENT) != 0) e.getAutoUpdateList(AutoUpdateType::CLIENT).addWaiting(this);
+		if ((mask&AutoUpdateType::SERVER) != 0) mServerEntry = e.getAutoUpdateList(AutoUpdateType::SERVER).add(this);
+		if ((mask&AutoUpdateType::CLIENT) != 0) mClientEntry = e.getAutoUpdateList(AutoUpdateType::CLIENT).add(this);
 	} catch (std::exception const&) {
 		DS_LOG_ERROR("AutoUpdate() on illegal mask (" << mask << ")");
 	}
@@ -24,10 +26,25 @@ AutoUpdate::AutoUpdate(ds::ui::SpriteEngine &e, const int mask)
 
 AutoUpdate::~AutoUpdate() {
 	try {
-		if ((mMask&AutoUpdateType::SERVER) != 0) mEngine.getAutoUpdateList(AutoUpdateType::SERVER).remove(this);
-		if ((mMask&AutoUpdateType::CLIENT) != 0) mEngine.getAutoUpdateList(AutoUpdateType::CLIENT).remove(this);
+		if (mServerEntry) mEngine.getAutoUpdateList(AutoUpdateType::SERVER).remove(mServerEntry);
+		if (mClientEntry) mEngine.getAutoUpdateList(AutoUpdateType::CLIENT).remove(mClientEntry);
 	} catch (std::exception const&) {
 	}
 }
 
+void AutoUpdate::setUpdateInterval(const int frames) {
+	if (mServerEntry) mEngine.getAutoUpdateList(AutoUpdateType::SERVER).setInterval(mServerEntry, frames);
+	if (mClientEntry) mEngine.getAutoUpdateList(AutoUpdateType::CLIENT).setInterval(mClientEntry, frames);
+}
+
+void AutoUpdate::setUpdateRate(const float hz) {
+	if (mServerEntry) mEngine.getAutoUpdateList(AutoUpdateType::SERVER).setRate(mServerEntry, hz);
+	if (mClientEntry) mEngine.getAutoUpdateList(AutoUpdateType::CLIENT).setRate(mClientEntry, hz);
+}
+
+void AutoUpdate::setUpdateGroup(const int group) {
+	if (mServerEntry) mEngine.getAutoUpdateList(AutoUpdateType::SERVER).setGroup(mServerEntry, group);
+	if (mClientEntry) mEngine.getAutoUpdateList(AutoUpdateType::CLIENT).setGroup(mClientEntry, group);
+}
+
 } // namespace ds
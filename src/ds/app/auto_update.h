@@ -5,9 +5,9 @@
 #include <vector>
 #include <Poco/Timestamp.h>
 #include <ds/app/app_defs.h>
+#include <ds/app/auto_update_list.h>
 
 namespace ds {
-class AutoUpdateList;
 class UpdateParams;
 namespace ui {
 class SpriteEngine;
@@ -16,13 +16,21 @@ class SpriteEngine;
 /**
  * \class AutoUpdate
  * Automatically run an update operation. Handle managing myself
- * in my containing list.
+ * in my containing list. Can be constructed on any thread; updates
+ * start on the next frame. Must be destroyed on the update thread.
  */
 class AutoUpdate {
 public:
 	AutoUpdate(ds::ui::SpriteEngine&, const int mask = AutoUpdateType::SERVER);
 	virtual ~AutoUpdate();
 
+	/// Only update every N frames. Clients with the same interval are spread across the frames.
+	void					setUpdateInterval(const int frames);
+	/// Only update this many times a second, if the frame rate allows. 0 goes back to every frame.
+	void					setUpdateRate(const float hz);
+	/// Lower groups update first. Within a group, clients update in the order they were made. Default 0.
+	void					setUpdateGroup(const int group);
+
 protected:
 	friend class			AutoUpdateList;
 	virtual void			update(const ds::UpdateParams&) = 0;
@@ -33,6 +41,8 @@ private:
 	AutoUpdate();
 
 	const int				mMask;
+	AutoUpdateList::Entry*	mServerEntry;
+	AutoUpdateList::Entry*	mClientEntry;
 };
 
 } // namespace ds
@@ -3,43 +3,230 @@
 #include "ds/app/auto_update_list.h"
 
 #include <algorithm>
-#include <Poco/Timestamp.h>
+#include <chrono>
+#include <cmath>
+#include <typeinfo>
 #include "ds/app/auto_update.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/params/update_params.h"
 
 namespace ds {
 
+namespace {
+// Spreads the slots evenly around a period, however many there are
+const double		GOLDEN_RATIO_FRACTION = 0.6180339887498949;
+// How much each run counts towards a client's average time
+const double		AVERAGE_WEIGHT = 0.1;
+}
+
+struct AutoUpdateList::Entry {
+	Entry(AutoUpdate* client)
+			: mClient(client)
+			, mNextPending(nullptr)
+			, mSlot(0)
+			, mInterval(1)
+			, mRate(0.0f)
+			, mGroup(0)
+			, mNextRun(-1.0)
+			, mLastRun(-1.0)
+			, mRuns(0)
+			, mLastMs(0.0)
+			, mAverageMs(0.0)
+			, mMaxMs(0.0) {
+	}
+
+	/// Null once removed. The list deletes the entry the next time it passes it.
+	std::atomic<AutoUpdate*>	mClient;
+	Entry*						mNextPending;
+	uint32_t					mSlot;
+
+	/// Settings, which the client can change from any thread
+	std::atomic<int>			mInterval;
+	std::atomic<float>			mRate;
+	std::atomic<int>			mGroup;
+
+	/// Elapsed seconds. A negative next run means the phase hasn't been picked yet.
+	double						mNextRun;
+	double						mLastRun;
+
+	int							mRuns;
+	double						mLastMs;
+	double						mAverageMs;
+	double						mMaxMs;
+};
+
 /**
  * \class AutoUpdateList
  */
-AutoUpdateList::AutoUpdateList() {
-	mRunning.reserve(32);
-	mWaiting.reserve(8);
+AutoUpdateList::AutoUpdateList()
+		: mSlotCount(0)
+		, mPending(nullptr)
+		, mOrderChanged(false)
+		, mFrame(0) {
+	mOrder.reserve(32);
+}
+
+AutoUpdateList::~AutoUpdateList() {
+	for (auto it : mOrder) delete it;
+	Entry*		pending = mPending.exchange(nullptr);
+	while (pending) {
+		Entry*	next = pending->mNextPending;
+		delete pending;
+		pending = next;
+	}
 }
 
 void AutoUpdateList::update(const ds::UpdateParams &p) {
-	if (!mWaiting.empty()) {
-		for (auto it=mWaiting.begin(), end=mWaiting.end(); it!=end; ++it) {
-			mRunning.push_back(*it);
+	++mFrame;
+	if (mPending.load(std::memory_order_relaxed)) addPending();
+	if (mOrderChanged.exchange(false)) {
+		std::stable_sort(mOrder.begin(), mOrder.end(), [](const Entry* a, const Entry* b) {
+			return a->mGroup.load(std::memory_order_relaxed) < b->mGroup.load(std::memory_order_relaxed);
+		});
+	}
+	if (mOrder.empty()) return;
+
+	DS_PROFILE_SCOPE("auto update");
+	const bool			timing = FrameProfiler::isActive(FrameProfiler::DETAIL);
+	const double		now = p.getElapsedTime();
+	auto				out = mOrder.begin();
+	// Removed clients are dropped as the list is passed, keeping the order of the rest. A client removed by
+	// an earlier one in this loop is skipped when it's reached; one removed after it ran goes on the next update.
+	for (auto it = mOrder.begin(), end = mOrder.end(); it != end; ++it) {
+		Entry*			e = *it;
+		AutoUpdate*		client = e->mClient.load(std::memory_order_acquire);
+		if (!client) {
+			mFreeSlots.push_back(e->mSlot);
+			delete e;
+			continue;
 		}
-		mWaiting.clear();
+		*out++ = e;
+		if (!isDue(*e, now)) continue;
+
+		// Clients that don't run every frame see the time since they last ran
+		const bool		everyFrame = e->mInterval.load(std::memory_order_relaxed) <= 1 && e->mRate.load(std::memory_order_relaxed) <= 0.0f;
+		UpdateParams	params(p);
+		if (!everyFrame && e->mLastRun >= 0.0) params.setDeltaTime(static_cast<float>(now - e->mLastRun));
+		e->mLastRun = now;
+
+		DS_PROFILE_OBJECT_SCOPE(client, "auto update");
+		if (!timing) {
+			client->update(params);
+			continue;
+		}
+		const auto		start = std::chrono::steady_clock::now();
+		client->update(params);
+		const double	ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		// Still safe if the client removed itself: its entry isn't deleted until the next update
+		e->mAverageMs = e->mRuns == 0 ? ms : e->mAverageMs + (ms - e->mAverageMs) * AVERAGE_WEIGHT;
+		e->mLastMs = ms;
+		e->mMaxMs = std::max(e->mMaxMs, ms);
+		++e->mRuns;
 	}
-	if (mRunning.empty()) return;
+	mOrder.erase(out, mOrder.end());
+}
 
-	for (auto it : mRunning) {
-		it->update(p);
+std::vector<AutoUpdateList::Timing> AutoUpdateList::getTimings(const size_t count) const {
+	std::vector<Timing>		ans;
+	for (auto it : mOrder) {
+		AutoUpdate*			client = it->mClient.load(std::memory_order_acquire);
+		if (!client || it->mRuns == 0) continue;
+		Timing				t;
+		t.mName = typeid(*client).name();
+		t.mGroup = it->mGroup.load(std::memory_order_relaxed);
+		t.mRuns = it->mRuns;
+		t.mAverageMs = it->mAverageMs;
+		t.mLastMs = it->mLastMs;
+		t.mMaxMs = it->mMaxMs;
+		ans.push_back(t);
 	}
+	std::sort(ans.begin(), ans.end(), [](const Timing& a, const Timing& b) { return a.mAverageMs > b.mAverageMs; });
+	if (ans.size() > count) ans.resize(count);
+	return ans;
 }
 
-void AutoUpdateList::addWaiting(AutoUpdate *v) {
-	if (!v) return;
-	mWaiting.push_back(v);
+AutoUpdateList::Entry* AutoUpdateList::add(AutoUpdate *v) {
+	if (!v) return nullptr;
+	Entry*		e = new Entry(v);
+	e->mNextPending = mPending.load(std::memory_order_relaxed);
+	while (!mPending.compare_exchange_weak(e->mNextPending, e, std::memory_order_release, std::memory_order_relaxed)) {
+	}
+	return e;
 }
 
-void AutoUpdateList::remove(AutoUpdate *v) {
-	if (!v) return;
-	mRunning.erase(std::remove(mRunning.begin(), mRunning.end(), v), mRunning.end());
-	mWaiting.erase(std::remove(mWaiting.begin(), mWaiting.end(), v), mWaiting.end());
+void AutoUpdateList::remove(Entry *e) {
+	if (!e) return;
+	e->mClient.store(nullptr, std::memory_order_release);
+}
+
+void AutoUpdateList::setInterval(Entry *e, const int frames) {
+	if (!e) return;
+	e->mInterval.store(std::max(frames, 1), std::memory_order_relaxed);
+	e->mRate.store(0.0f, std::memory_order_relaxed);
+}
+
+void AutoUpdateList::setRate(Entry *e, const float hz) {
+	if (!e) return;
+	e->mRate.store(std::max(hz, 0.0f), std::memory_order_relaxed);
+	e->mInterval.store(1, std::memory_order_relaxed);
+}
+
+void AutoUpdateList::setGroup(Entry *e, const int group) {
+	if (!e) return;
+	if (e->mGroup.exchange(group, std::memory_order_relaxed) != group) mOrderChanged.store(true);
+}
+
+void AutoUpdateList::addPending() {
+	Entry*					e = mPending.exchange(nullptr, std::memory_order_acquire);
+	// The stack is newest first, so flip it to run in the order added
+	Entry*					reversed = nullptr;
+	while (e) {
+		Entry*				next = e->mNextPending;
+		e->mNextPending = reversed;
+		reversed = e;
+		e = next;
+	}
+
+	for (e = reversed; e; ) {
+		Entry*				next = e->mNextPending;
+		e->mNextPending = nullptr;
+		if (!e->mClient.load(std::memory_order_acquire)) {
+			delete e;
+		} else {
+			if (mFreeSlots.empty()) {
+				e->mSlot = mSlotCount++;
+			} else {
+				e->mSlot = mFreeSlots.back();
+				mFreeSlots.pop_back();
+			}
+			const int		group = e->mGroup.load(std::memory_order_relaxed);
+			if (!mOrder.empty() && mOrder.back()->mGroup.load(std::memory_order_relaxed) > group) mOrderChanged.store(true);
+			mOrder.push_back(e);
+		}
+		e = next;
+	}
+}
+
+bool AutoUpdateList::isDue(Entry &e, const double now) {
+	const float			rate = e.mRate.load(std::memory_order_relaxed);
+	if (rate > 0.0f) {
+		const double	period = 1.0 / rate;
+		if (e.mNextRun < 0.0) {
+			// Each slot starts at its own point in the period, so clients with the same rate take turns
+			double		whole;
+			e.mNextRun = now + period * std::modf(static_cast<double>(e.mSlot) * GOLDEN_RATIO_FRACTION, &whole);
+		}
+		if (now < e.mNextRun) return false;
+		e.mNextRun += period;
+		// After a stall, carry on from now instead of running to catch up
+		if (e.mNextRun <= now) e.mNextRun = now + period;
+		return true;
+	}
+
+	const int			interval = e.mInterval.load(std::memory_order_relaxed);
+	if (interval <= 1) return true;
+	// Offset by slot, so clients with the same interval run on different frames
+	return (mFrame + e.mSlot) % static_cast<uint64_t>(interval) == 0;
 }
 
 } // namespace ds
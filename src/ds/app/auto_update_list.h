@@ -2,6 +2,9 @@
 #ifndef DS_APP_AUTOUPDATELIST_H_
 #define DS_APP_AUTOUPDATELIST_H_
 
+#include <atomic>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace ds {
@@ -11,24 +14,62 @@ class UpdateParams;
 /**
  * \class AutoUpdateList
  * Store a collection of auto update objects.
+ * Each client gets a slot it keeps for life, so adding and removing don't search the list.
+ * Clients can be added from any thread: they wait on a lock-free stack until the start of the next update.
+ * Removing one, including from inside another client's update, stops it right away. Removing is only
+ * allowed on the update thread: a client destroyed elsewhere could be deleted while it's running.
+ * Clients can run every N frames or at a rate instead of every frame (see AutoUpdate::setUpdateInterval()),
+ * and run by group, lowest first, then in the order they were added.
  */
 class AutoUpdateList {
 public:
+	/// A client's place in the list. Opaque outside of the list.
+	struct Entry;
+
+	struct Timing {
+		/// The client's class
+		std::string				mName;
+		int						mGroup;
+		int						mRuns;
+		/// Smoothed over recent runs
+		double					mAverageMs;
+		double					mLastMs;
+		double					mMaxMs;
+	};
+
 	AutoUpdateList();
+	~AutoUpdateList();
 
 	void						update(const ds::UpdateParams&);
 
-private:
-	void						addWaiting(AutoUpdate*);
-	void						remove(AutoUpdate*);
+	/// Time spent in each client, slowest first (by average). Only recorded while the FrameProfiler is at DETAIL.
+	std::vector<Timing>			getTimings(const size_t count) const;
 
+private:
 	friend class AutoUpdate;
-	std::vector<AutoUpdate*>	mRunning;
-	/// A list of pending update objects -- when an update is added,
-	/// it starts here, then gets placed in the real update list
-	/// at the start of the next update cycle. This prevents a
-	/// a bug where the vector gets modified during an update.
-	std::vector<AutoUpdate*>	mWaiting;
+
+	/// Safe from any thread
+	Entry*						add(AutoUpdate*);
+	/// Update thread only. The entry stays until the next update passes it, so removing mid-update is safe.
+	void						remove(Entry*);
+
+	void						setInterval(Entry*, const int frames);
+	void						setRate(Entry*, const float hz);
+	void						setGroup(Entry*, const int group);
+
+	void						addPending();
+	bool						isDue(Entry&, const double now);
+
+	/// Slots are handed out in order, and reused once their client is gone
+	uint32_t					mSlotCount;
+	std::vector<uint32_t>		mFreeSlots;
+	/// Clients in the order they run: by group, then the order they were added
+	std::vector<Entry*>			mOrder;
+	/// Clients added since the last update, newest first
+	std::atomic<Entry*>			mPending;
+	std::atomic<bool>			mOrderChanged;
+	/// Counts updates, for clients that run every N frames
+	uint64_t					mFrame;
 };
 
 } // namespace ds
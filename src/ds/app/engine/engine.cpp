@@ -15,6 +15,7 @@
 #include "ds/debug/console.h"
 #endif
 #include "ds/debug/debug_defines.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/debug/logger.h"
 #include "ds/math/math_defs.h"
 #include "ds/metrics/metrics_service.h"
@@ -58,6 +59,8 @@ Engine::Engine(ds::App& app, ds::EngineSettings &settings,
 	, mRequestedRootList(_roots)
 	, mDsApp(app)
 	, mTweenline(app.timeline())
+	, mHeadless(false)
+	, mUpdateCount(0)
 	, mIdling(true)
 	, mTouchMode(ds::ui::TouchMode::kTuioAndMouse)
 	, mTouchManager(*this, mTouchMode)
@@ -91,6 +94,7 @@ Engine::Engine(ds::App& app, ds::EngineSettings &settings,
 	, mFonts(*this)
 	, mEventClient(ed.mNotifier, [this](const ds::Event *m){ if(m) onAppEvent(*m); })
 	, mAutoRefresh(*this)
+	, mResourceResolver(*this, mResources)
 {
 
 
@@ -119,6 +123,7 @@ Engine::~Engine() {
 void Engine::setupEngine() {
 	setupConsole();
 	setupLogger();
+	setupHeadless();
 	setupFrameRate();
 	setupVerticalSync();
 	setupWindowMode();
@@ -137,12 +142,23 @@ void Engine::setupEngine() {
 void Engine::setupLogger() {
 
 	ds::Logger::setup(mSettings);
+	ds::FrameProfiler::setLevel(mSettings.getInt("profiler:level"));
 
 	mData.mAppInstanceName = mSettings.getString("platform:guid");
 
 	ds::Environment::setConfigDirFileExpandOverride(mSettings.getBool("configuration_folder:allow_expand_override"));
 }
 
+void Engine::setupHeadless() {
+#ifdef DS_CINDER_HEADLESS
+	// Built against Cinder's offscreen GL, so there's no window to show
+	mHeadless = true;
+#else
+	mHeadless = mSettings.getBool("platform:headless");
+#endif
+	if(mHeadless) DS_LOG_INFO("Engine running headless: no window, no drawing, " << mSettings.getFloat("frame_rate") << " simulated updates per second");
+}
+
 void Engine::setupWorldSize(){
 	mData.mWorldSize = mSettings.getVec2("world_dimensions");
 }
@@ -205,6 +221,10 @@ void Engine::setupConsole(){
 
 void Engine::setupWindowMode(){
 	if(!ci::app::getWindow()) return;
+	if(mHeadless) {
+		ci::app::getWindow()->hide();
+		return;
+	}
 
 	auto newMode = mSettings.getString("screen:mode");
 	if(newMode == "borderless"){
@@ -234,11 +254,13 @@ void Engine::setupMouseHide(){
 
 void Engine::setupFrameRate(){
 	mData.mFrameRate = mSettings.getFloat("frame_rate");
-	ci::app::setFrameRate(mData.mFrameRate);
+	// Headless apps keep frame_rate for the simulated clock, but don't wait on it
+	if(mHeadless) ci::app::disableFrameRate();
+	else ci::app::setFrameRate(mData.mFrameRate);
 }
 
 void Engine::setupVerticalSync(){
-	ci::gl::enableVerticalSync(mSettings.getBool("vertical_sync"));
+	ci::gl::enableVerticalSync(!mHeadless && mSettings.getBool("vertical_sync"));
 }
 
 void Engine::setupIdleTimeout(){
@@ -419,6 +441,7 @@ void Engine::prepareSettings(ci::app::AppBase::Settings& settings) {
 	bool aot = mSettings.getBool("screen:always_on_top");
 	settings.setAlwaysOnTop(aot);
 	settings.setFrameRate(mData.mFrameRate);
+	if(mHeadless) settings.disableFrameRate();
 	
 	DS_LOG_INFO("Engine::prepareSettings: screenMode is " << screenMode << " and always on top " << settings.isAlwaysOnTop());
 
@@ -492,6 +515,7 @@ void Engine::setup(ds::App& app) {
 
 	mCinderWindow = app.getWindow();
 	//mCinderWindow->spanAllDisplays
+	if(mHeadless && mCinderWindow) mCinderWindow->hide();
 
 	mTouchTranslator.setTranslation(mData.mSrcRect.x1, mData.mSrcRect.y1);
 	mTouchTranslator.setScale(mData.mSrcRect.getWidth() / ci::app::getWindowWidth(), mData.mSrcRect.getHeight() / ci::app::getWindowHeight());
@@ -521,7 +545,8 @@ void Engine::setup(ds::App& app) {
 		DS_LOG_WARNING("Engine::setup() on 0 size width or height");
 	}
 
-	float curr = static_cast<float>(ci::app::getElapsedSeconds());
+	mUpdateCount = 0;
+	float curr = getClockTime();
 	mLastTime = curr;
 	mLastTouchTime = 0;
 
@@ -836,31 +861,49 @@ const RootList::Root& Engine::getRootBuilder(const size_t index){
 }
 
 void Engine::updateClient() {
-	float curr = static_cast<float>(ci::app::getElapsedSeconds());
+	++mUpdateCount;
+	float curr = getClockTime();
 	float dt = curr - mLastTime;
 	mLastTime = curr;
 
 	checkIdle();
 
 	{
-		std::lock_guard<std::mutex> lock(mTouchMutex);
-		mMouseBeginEvents.lockedUpdate();
-		mMouseMovedEvents.lockedUpdate();
-		mMouseEndedEvents.lockedUpdate();
-	}
+		DS_PROFILE_SCOPE("touch");
+		{
+			std::lock_guard<std::mutex> lock(mTouchMutex);
+			mMouseBeginEvents.lockedUpdate();
+			mMouseMovedEvents.lockedUpdate();
+			mMouseEndedEvents.lockedUpdate();
+		}
 
-	mMouseBeginEvents.update(curr);
-	mMouseMovedEvents.update(curr);
-	mMouseEndedEvents.update(curr);
+		mMouseBeginEvents.update(curr);
+		mMouseMovedEvents.update(curr);
+		mMouseEndedEvents.update(curr);
+	}
 
 	mUpdateParams.setDeltaTime(dt);
 	mUpdateParams.setElapsedTime(curr);
 
 	mAutoUpdateClient.update(mUpdateParams);
+	{
+		DS_PROFILE_SCOPE("batch tweens");
+		mBatchTweener.update(curr);
+	}
 
-	for (auto it=mRoots.begin(), end=mRoots.end(); it!=end; ++it) {
-		(*it)->updateClient(mUpdateParams);
+	{
+		DS_PROFILE_SCOPE("roots update");
+		for (auto it=mRoots.begin(), end=mRoots.end(); it!=end; ++it) {
+			(*it)->updateClient(mUpdateParams);
+		}
 	}
+
+	{
+		DS_PROFILE_SCOPE("listed sprites update");
+		updateListedSprites(mUpdateParams, false);
+	}
+
+	flushDeferredEvents();
 }
 
 void Engine::updateServer() {
@@ -871,48 +914,74 @@ void Engine::updateServer() {
 									mData.mSrcRect.getHeight() / static_cast<float>(mCachedWindowH));
 	}
 
-	const float		curr = static_cast<float>(ci::app::getElapsedSeconds());
+	++mUpdateCount;
+	const float		curr = getClockTime();
 	const float		dt = curr - mLastTime;
 	mLastTime = curr;
 
 	checkIdle();
 
-	//////////////////////////////////////////////////////////////////////////
 	{
-		std::lock_guard<std::mutex> lock(mTouchMutex);
-		mMouseBeginEvents.lockedUpdate();
-		mMouseMovedEvents.lockedUpdate();
-		mMouseEndedEvents.lockedUpdate();
+		DS_PROFILE_SCOPE("touch");
+		//////////////////////////////////////////////////////////////////////////
+		{
+			std::lock_guard<std::mutex> lock(mTouchMutex);
+			mMouseBeginEvents.lockedUpdate();
+			mMouseMovedEvents.lockedUpdate();
+			mMouseEndedEvents.lockedUpdate();
 
-		mTouchBeginEvents.lockedUpdate();
-		mTouchMovedEvents.lockedUpdate();
-		mTouchEndedEvents.lockedUpdate();
+			mTouchBeginEvents.lockedUpdate();
+			mTouchMovedEvents.lockedUpdate();
+			mTouchEndedEvents.lockedUpdate();
 
-		mTuioObjectsBegin.lockedUpdate();
-		mTuioObjectsMoved.lockedUpdate();
-		mTuioObjectsEnded.lockedUpdate();
-	} // unlock touch mutex
-	//////////////////////////////////////////////////////////////////////////
+			mTuioObjectsBegin.lockedUpdate();
+			mTuioObjectsMoved.lockedUpdate();
+			mTuioObjectsEnded.lockedUpdate();
+		} // unlock touch mutex
+		//////////////////////////////////////////////////////////////////////////
 
-	mMouseBeginEvents.update(curr);
-	mMouseMovedEvents.update(curr);
-	mMouseEndedEvents.update(curr);
+		mMouseBeginEvents.update(curr);
+		mMouseMovedEvents.update(curr);
+		mMouseEndedEvents.update(curr);
 
-	mTouchBeginEvents.update(curr);
-	mTouchMovedEvents.update(curr);
-	mTouchEndedEvents.update(curr);
+		mTouchBeginEvents.update(curr);
+		mTouchMovedEvents.update(curr);
+		mTouchEndedEvents.update(curr);
 
-	mTuioObjectsBegin.update(curr);
-	mTuioObjectsMoved.update(curr);
-	mTuioObjectsEnded.update(curr);
+		mTuioObjectsBegin.update(curr);
+		mTuioObjectsMoved.update(curr);
+		mTuioObjectsEnded.update(curr);
+	}
 
 	mUpdateParams.setDeltaTime(dt);
 	mUpdateParams.setElapsedTime(curr);
 
 	mAutoUpdateServer.update(mUpdateParams);
+	{
+		DS_PROFILE_SCOPE("batch tweens");
+		mBatchTweener.update(curr);
+	}
 
-	for (auto it=mRoots.begin(), end=mRoots.end(); it!=end; ++it) {
-		(*it)->updateServer(mUpdateParams);
+	{
+		DS_PROFILE_SCOPE("roots update");
+		for (auto it=mRoots.begin(), end=mRoots.end(); it!=end; ++it) {
+			(*it)->updateServer(mUpdateParams);
+		}
+	}
+
+	{
+		DS_PROFILE_SCOPE("listed sprites update");
+		updateListedSprites(mUpdateParams, true);
+	}
+
+	flushDeferredEvents();
+}
+
+void Engine::flushDeferredEvents() {
+	DS_PROFILE_SCOPE("deferred events");
+	getNotifier().flushDeferred();
+	for (auto it = mChannels.begin(), end = mChannels.end(); it != end; ++it) {
+		it->second.mNotifier.flushDeferred();
 	}
 }
 
@@ -1010,25 +1079,38 @@ void Engine::registerForTuioObjects(ci::tuio::Client& client) {
 }
 
 void Engine::drawClient() {
+	if(mHeadless) return;
 	ci::gl::enableAlphaBlending();
 
 	ci::gl::clear(ci::ColorA(0.0f, 0.0f, 0.0f, 0.0f));
 
+	DS_PROFILE_SCOPE("roots draw");
 	for(auto it = getRoots().begin(), end = getRoots().end(); it != end; ++it){
 		(*it)->drawClient(getDrawParams(), getAutoDrawService());
 	}
 }
 
 void Engine::drawServer() {
+	if(mHeadless) return;
 	ci::gl::enableAlphaBlending();
 
 	ci::gl::clear(ci::ColorA(0.0f, 0.0f, 0.0f, 0.0f));
 
+	DS_PROFILE_SCOPE("roots draw");
 	for(auto it = getRoots().cbegin(), end = getRoots().cend(); it != end; ++it){
 		(*it)->drawServer(getDrawParams());
 	}
 }
 
+double Engine::getElapsedTimeSeconds() const {
+	if(mHeadless && mData.mFrameRate > 0.0f) return static_cast<double>(mUpdateCount) / mData.mFrameRate;
+	return ci::app::getElapsedSeconds();
+}
+
+float Engine::getClockTime() const {
+	return static_cast<float>(getElapsedTimeSeconds());
+}
+
 ds::sprite_id_t Engine::nextSpriteId() {
 	static ds::sprite_id_t              ID = 0;
 	++ID;
@@ -1166,6 +1248,10 @@ ds::ResourceList& Engine::getResources() {
 	return mResources;
 }
 
+ds::ResourceResolver& Engine::getResourceResolver() {
+	return mResourceResolver;
+}
+
 const ds::FontList& Engine::getFonts() const {
 	return mFonts;
 }
@@ -1279,7 +1365,7 @@ void Engine::startIdling() {
 }
 
 void Engine::resetIdleTimeout() {
-	float curr = static_cast<float>(ci::app::getElapsedSeconds());
+	float curr = getClockTime();
 	mLastTime = curr;
 	mLastTouchTime = curr;
 
@@ -27,6 +27,7 @@
 #include "ds/data/color_list.h"
 #include "ds/data/font_list.h"
 #include "ds/data/resource_list.h"
+#include "ds/data/resource_resolver.h"
 #include "ds/data/tuio_object.h"
 #include "ds/debug/auto_refresh.h"
 #include "ds/app/engine/engine_settings.h"
@@ -180,6 +181,7 @@ public:
 	virtual bool						getRotateTouchesDefault();
 
 	virtual ds::ResourceList&			getResources();
+	virtual ds::ResourceResolver&		getResourceResolver();
 	virtual const ds::FontList&			getFonts() const;
 	ds::FontList&						editFonts();
 
@@ -234,6 +236,16 @@ public:
 	void								setAverageFps(const float fps){ mAverageFps = fps; }
 	const float							getAverageFps() const { return mAverageFps; }
 
+	/// Set by the "platform:headless" setting. The window is hidden and nothing is drawn, updates run as fast
+	/// as they can, and time advances exactly one frame_rate step per update, so runs are repeatable.
+	/// Networking, touch injection and sprite serialization all behave normally.
+	/// Always on when built with DS_CINDER_HEADLESS_GL, which needs no display or, with osmesa, no GPU.
+	bool								isHeadless() const { return mHeadless; }
+	/// The number of updates since setup
+	int64_t								getUpdateCount() const { return mUpdateCount; }
+	/// The engine clock: seconds since the app started, or the simulated time when headless
+	virtual double						getElapsedTimeSeconds() const override;
+
 	size_t								getNumberOfSprites() { return mSprites.size(); }
 
 	/// -------------------------------------------------------------
@@ -291,6 +303,7 @@ private:
 	/// Read these values from settings and apply them
 	void								setupEngine(); /// calls all the below setup functions
 	void								setupLogger();
+	void								setupHeadless();
 	void								setupWorldSize();
 	void								setupSrcDstRects();
 	void								setupAutoSpan();
@@ -306,6 +319,11 @@ private:
 	void								setupMetrics();
 	void								setupAutoRefresh();
 
+	/// getElapsedTimeSeconds() as a float, for the update params
+	float								getClockTime() const;
+	/// Sends the events queued with EventNotifier::notifyDeferred() on the main notifier and every channel
+	void								flushDeferredEvents();
+
 	friend class EngineStatsView;
 	std::vector<std::unique_ptr<EngineRoot> >
 										mRoots;
@@ -323,6 +341,8 @@ private:
 	UpdateParams						mUpdateParams;
 	DrawParams							mDrawParams;
 	float								mLastTime;
+	bool								mHeadless;
+	int64_t								mUpdateCount;
 	bool								mIdling;
 	float								mLastTouchTime;
 
@@ -344,6 +364,8 @@ private:
 	AutoDrawService*					mAutoDraw;
 
 	AutoRefresh							mAutoRefresh;
+	/// Fills mResources off the main thread. After the auto update lists, since it's in them
+	ResourceResolver					mResourceResolver;
 
 	ds::ui::TouchTranslator				mTouchTranslator;
 	std::mutex							mTouchMutex;
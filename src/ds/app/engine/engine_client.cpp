@@ -4,6 +4,7 @@
 
 #include "ds/app/engine/engine_io_defs.h"
 #include "ds/app/engine/engine_data.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/debug/logger.h"
 #include "ds/debug/debug_defines.h"
 #include "ds/ui/sprite/image.h"
@@ -87,10 +88,15 @@ ds::sprite_id_t EngineClient::nextSpriteId() {
 }
 
 void EngineClient::update() {
-	mWorkManager.update();
+	{
+		DS_PROFILE_SCOPE("work manager");
+		mWorkManager.update();
+	}
 	updateClient();
 	mComputerInfo->update();
 
+	DS_PROFILE_SCOPE("network");
+
 	if (!mConnectionRenewed && 
 		(mReceiver.hasLostConnection() || !mSendConnection.initialized())
 		){
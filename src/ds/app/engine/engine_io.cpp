@@ -41,24 +41,20 @@ EngineSender::AutoSend::~AutoSend() {
 	if (!mSender.mConnection.initialized()) return;
 	if (mData.size() < 1) return;
 
-	const int size = static_cast<int>(mData.size());
-	mSender.mRawDataBuffer.setSize(size);
-	mData.readRaw(mSender.mRawDataBuffer.data(), size);
-	snappy::Compress(mSender.mRawDataBuffer.data(), size, &mSender.mCompressionBuffer);
-
-	std::vector<std::string> chunks;
+	const unsigned size = mData.size();
+	const char* raw = mData.readRaw(size);
+	if (!raw) return;
+	snappy::Compress(raw, size, &mSender.mCompressionBuffer);
 
 	if(mSender.mUseChunker){
 
 		mSender.mPacketId++;
-		ds::net::Chunker chunker;
-		chunker.Chunkify(mSender.mCompressionBuffer, mSender.mPacketId, chunks);
+		mSender.mChunker.Chunkify(mSender.mCompressionBuffer.c_str(), static_cast<unsigned>(mSender.mCompressionBuffer.size()), mSender.mPacketId, mSender.mChunks);
+		for (const auto& it : mSender.mChunks){
+			mSender.mConnection.sendMessage(it);
+		}
 	} else {
-		chunks.push_back(mSender.mCompressionBuffer);
-	}
-
-	for (auto it : chunks){
-		mSender.mConnection.sendMessage(it);
+		mSender.mConnection.sendMessage(mSender.mCompressionBuffer);
 	}
 
 	mData.clear();
@@ -73,7 +69,9 @@ EngineReceiver::EngineReceiver(ds::NetConnection& con, const bool useChunker)
 		, mCommandId(0)
 		, mHeaderAndCommandOnly(false)
 		, mUseChunker(useChunker)
-		, mNoDataCount(0) {
+		, mNoDataCount(0)
+		, mReceiveNext(0)
+		, mReceiveCount(0) {
 	setHeaderAndCommandOnly();
 }
 
@@ -90,34 +88,34 @@ ds::DataBuffer& EngineReceiver::getData() {
 	return mCurrentDataBuffer;
 }
 
-bool EngineReceiver::receiveBlob(const bool strict) {
-	std::string recvBuffer;
+std::string& EngineReceiver::nextReceiveBuffer() {
+	if (mReceiveCount >= mReceiveBuffers.size()) mReceiveBuffers.emplace_back();
+	return mReceiveBuffers[mReceiveCount++];
+}
 
+bool EngineReceiver::receiveBlob(const bool strict) {
 	if(mUseChunker){
-		while(mConnection.recvMessage(recvBuffer)) {
-			mDechunker.addChunk(recvBuffer);
+		while(mConnection.recvMessage(mRecvBuffer)) {
+			mDechunker.addChunk(mRecvBuffer);
 		}
 
 		while(mDechunker.getAvailable() > 0) {
-			std::string outBuf;
-			bool validy = mDechunker.getNextGroup(outBuf);
+			bool validy = mDechunker.getNextGroup(mGroupBuffer);
 
 			if(!validy) {
 				DS_LOG_WARNING_M("EngineReceiver: Invalid chunk received. Expect a new world frame shortly.", ds::IO_LOG);
 				return false;
 			}
 
-			snappy::Uncompress(outBuf.c_str(), outBuf.size(), &mCompressionBufferRead);
-			mReceiveBuffers.push_back(mCompressionBufferRead);
+			snappy::Uncompress(mGroupBuffer.c_str(), mGroupBuffer.size(), &nextReceiveBuffer());
 		}
 	} else {
-		while(mConnection.recvMessage(recvBuffer)) {
-			snappy::Uncompress(recvBuffer.c_str(), recvBuffer.size(), &mCompressionBufferRead);
-			mReceiveBuffers.push_back(mCompressionBufferRead);
+		while(mConnection.recvMessage(mRecvBuffer)) {
+			snappy::Uncompress(mRecvBuffer.c_str(), mRecvBuffer.size(), &nextReceiveBuffer());
 		}
 	}
 
-	if(mReceiveBuffers.empty()) {
+	if(mReceiveNext >= mReceiveCount) {
 		++mNoDataCount;
 		if(strict) {
 			return false;
@@ -128,7 +126,7 @@ bool EngineReceiver::receiveBlob(const bool strict) {
 }
 
 bool EngineReceiver::handleBlob(ds::BlobRegistry& registry, ds::BlobReader& reader, bool& morePacketsAvailable) {
-	if(mReceiveBuffers.empty()) {
+	if(mReceiveNext >= mReceiveCount) {
 		++mNoDataCount;
 		morePacketsAvailable = false;
 		return false;
@@ -136,11 +134,15 @@ bool EngineReceiver::handleBlob(ds::BlobRegistry& registry, ds::BlobReader& read
 
 	mNoDataCount = 0;
 
+	const std::string&			received = mReceiveBuffers[mReceiveNext++];
 	mCurrentDataBuffer.clear(); 
-	mCurrentDataBuffer.addRaw(mReceiveBuffers.front().c_str(), static_cast<unsigned int>(mReceiveBuffers.front().size()));
-	mReceiveBuffers.erase(mReceiveBuffers.begin());
+	mCurrentDataBuffer.addRaw(received.c_str(), static_cast<unsigned int>(received.size()));
+	if (mReceiveNext >= mReceiveCount) {
+		mReceiveNext = 0;
+		mReceiveCount = 0;
+	}
 
-	morePacketsAvailable = !mReceiveBuffers.empty();
+	morePacketsAvailable = mReceiveNext < mReceiveCount;
 
 	const size_t				receiveSize = mCurrentDataBuffer.size();
 	const char					size = static_cast<char>(registry.mReader.size());
@@ -28,8 +28,10 @@ public:
 private:
 	ds::NetConnection&			mConnection;
 	ds::DataBuffer				mSendBuffer;
-	RecycleArray<char>			mRawDataBuffer;
 	std::string					mCompressionBuffer;
+	/// Kept between sends so their storage is reused
+	ds::net::Chunker			mChunker;
+	std::vector<std::string>	mChunks;
 	unsigned int				mPacketId;
 	bool						mUseChunker;
 
@@ -73,8 +75,9 @@ public:
 private:
 	ds::DataBuffer				mCurrentDataBuffer;
 	ds::NetConnection&			mConnection;
-	std::string					mCompressionBufferRead;
-	std::string					mCompressionBufferWrite;
+	/// Scratch for the network and dechunker, kept so their storage is reused
+	std::string					mRecvBuffer;
+	std::string					mGroupBuffer;
 	/// The header and command blob IDs, used for filtering. The header
 	/// and command are always processed, but anything else depends on the state
 	char						mHeaderId,
@@ -87,8 +90,13 @@ private:
 
 	/// Keep track of all the packets we receive.
 	/// This is in case we're running slower than the server,
-	/// in which case we can run through and update all the buffers at once and catch up
+	/// in which case we can run through and update all the buffers at once and catch up.
+	/// Packets are decompressed straight into these, which are recycled once they've all been
+	/// handled, so a steady stream of frames doesn't allocate. mReceiveNext to mReceiveCount are waiting.
+	std::string&				nextReceiveBuffer();
 	std::vector<std::string>	mReceiveBuffers;
+	size_t						mReceiveNext;
+	size_t						mReceiveCount;
 	ds::net::DeChunker			mDechunker;
 	bool						mUseChunker;
 };
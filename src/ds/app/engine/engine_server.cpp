@@ -5,6 +5,7 @@
 #include <ds/app/engine/engine_io_defs.h>
 #include "ds/app/app.h"
 #include "ds/app/blob_reader.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/debug/logger.h"
 #include "ds/util/string_util.h"
 #include "ds/debug/computer_info.h"
@@ -90,9 +91,14 @@ void AbstractEngineServer::setup(ds::App& app) {
 
 void AbstractEngineServer::update() {
 	mComputerInfo->update();
-	mWorkManager.update();
+	{
+		DS_PROFILE_SCOPE("work manager");
+		mWorkManager.update();
+	}
 	updateServer();
 
+	DS_PROFILE_SCOPE("network");
+
 	mState->update(*this);
 }
 
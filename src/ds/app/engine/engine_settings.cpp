@@ -188,6 +188,7 @@ void EngineSettings::setDefaults(){
 	getSetting("idle_time", 0, ds::cfg::SETTING_TYPE_DOUBLE, "Seconds before idle happens. 300 = 5 minutes.", "300", "0", "1000");
 	getSetting("system:never_sleep", 0, ds::cfg::SETTING_TYPE_BOOL, "Prevent the system from sleeping or powering off the screen", "true");
 	getSetting("apphost:exit_on_quit", 0, ds::cfg::SETTING_TYPE_BOOL, "Exit apphost when quitting the app", "true");
+	getSetting("platform:headless", 0, ds::cfg::SETTING_TYPE_BOOL, "Run without a visible window or drawing, as fast as possible, with time advancing one frame_rate step per update. For benchmarks and automated runs.", "false");
 	getSetting("resetup_server_on_display_change", 0, ds::cfg::SETTING_TYPE_BOOL, "Resetup the server when the display changes", "true");
 	
 
@@ -241,6 +242,7 @@ void EngineSettings::setDefaults(){
 	getSetting("logger:async", 0, ds::cfg::SETTING_TYPE_STRING, "Whether to save logs on another thread or the main one.", "true");
 	getSetting("logger:file", 0, ds::cfg::SETTING_TYPE_STRING, "Filename and location", "%LOCAL%/logs/");
 	getSetting("logger:verbose_level", 0, ds::cfg::SETTING_TYPE_INT, "How much verbose output to log. 0=nothing, 9=everything", "0", "0", "9");
+	getSetting("profiler:level", 0, ds::cfg::SETTING_TYPE_INT, "Frame profiler shown in the stats view and saved with F9. 0=off, 1=engine phases, 2=also every sprite and auto update by class", "0", "0", "2");
 
 	getSetting("METRICS", 0, ds::cfg::SETTING_TYPE_SECTION_HEADER, "");
 	getSetting("metrics:active", 0, ds::cfg::SETTING_TYPE_BOOL, "Enable telegraf metrics sending", "true");
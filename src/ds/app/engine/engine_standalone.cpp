@@ -4,6 +4,7 @@
 
 #include "ds/app/app.h"
 #include "ds/content/content_wrangler.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/debug/logger.h"
 #include "ds/debug/computer_info.h"
 
@@ -53,7 +54,10 @@ void EngineStandalone::setup(ds::App& app) {
 
 
 void EngineStandalone::update() {
-	mWorkManager.update();
+	{
+		DS_PROFILE_SCOPE("work manager");
+		mWorkManager.update();
+	}
 	mComputerInfo->update();
 	updateServer();
 }
@@ -2,8 +2,12 @@
 
 #include "engine_stats_view.h"
 
+#include <iomanip>
+#include "ds/app/auto_update_list.h"
 #include "ds/app/blob_reader.h"
 #include "ds/data/data_buffer.h"
+#include "ds/debug/frame_profiler.h"
+#include "ds/util/string_util.h"
 #include "engine_data.h"
 #include <ds/debug/computer_info.h>
 
@@ -30,6 +34,14 @@ std::string			make_line(const std::string &key, const float v) {
 	return buf.str();
 }
 
+// Class names can have template brackets in them
+std::string			escape_markup(std::string v) {
+	ds::replace(v, "&", "&amp;");
+	ds::replace(v, "<", "&lt;");
+	ds::replace(v, ">", "&gt;");
+	return v;
+}
+
 }
 
 /**
@@ -129,6 +141,7 @@ void EngineStatsView::updateStats() {
 	if(mText){
 		std::stringstream ss;
 		ss << "<span weight='bold'>Sprites:</span> " << mEngine.mSprites.size() << std::endl;
+		ss << "<span weight='bold'>Listed for update:</span> " << mEngine.getUpdateListSize() << std::endl;
 		ss << "<span weight='bold'>Touch mode (t):</span> " << ds::ui::TouchMode::toString(mEngine.mTouchMode) << std::endl;
 
 		ss << "<span weight='bold'>Physical Memory:</span> " << mEngine.getComputerInfo().getPhysicalMemoryUsedByProcess() << std::endl;
@@ -149,6 +162,31 @@ void EngineStatsView::updateStats() {
 			ss << "<span weight='bold'>FPS:</span> " << fpsy << std::endl;
 		}
 
+		if(ds::FrameProfiler::getLevel() > ds::FrameProfiler::OFF) {
+			ss << std::fixed << std::setprecision(2);
+			ss << std::endl << "<span weight='bold'>Frame (F7):</span> " << ds::FrameProfiler::getAverageFrameMs() << "ms" << std::endl;
+			const auto phases = ds::FrameProfiler::getPhaseTimings();
+			for(auto it = phases.begin(), end = phases.end(); it != end; ++it) {
+				ss << std::string(static_cast<size_t>(it->mDepth) * 4, ' ') << escape_markup(it->mName) << ": " << it->mAverageMs << "ms" << std::endl;
+			}
+			const auto classes = ds::FrameProfiler::getClassTimings(6);
+			if(!classes.empty()) {
+				ss << "<span weight='bold'>Slowest classes:</span>" << std::endl;
+				for(auto it = classes.begin(), end = classes.end(); it != end; ++it) {
+					ss << "    " << escape_markup(it->mName) << " (" << it->mCategory << "): " << it->mAverageMs << "ms" << std::endl;
+				}
+			}
+			const int updateList = mEngine.getMode() == ds::ui::SpriteEngine::CLIENT_MODE ? AutoUpdateType::CLIENT : AutoUpdateType::SERVER;
+			const auto updaters = mEngine.getAutoUpdateList(updateList).getTimings(4);
+			if(!updaters.empty()) {
+				ss << "<span weight='bold'>Slowest auto updates:</span>" << std::endl;
+				for(auto it = updaters.begin(), end = updaters.end(); it != end; ++it) {
+					ss << "    " << escape_markup(it->mName) << ": " << it->mAverageMs << "ms (max " << it->mMaxMs << "ms)" << std::endl;
+				}
+			}
+			ss.unsetf(std::ios_base::floatfield);
+		}
+
 		if(mShowingHelp) {
 			auto appy = dynamic_cast<ds::App*>(ds::App::get());
 			ss << std::endl << "<span size='xx-small'>" << appy->getKeyManager().getAllKeysString() << "</span>";
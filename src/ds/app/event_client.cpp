@@ -1,6 +1,8 @@
 #include "stdafx.h"
 
 #include <ds/app/event_client.h>
+
+#include <algorithm>
 #include <ds/app/event_notifier.h>
 #include <ds/ui/sprite/sprite_engine.h>
 
@@ -13,16 +15,8 @@ EventClient::EventClient( EventNotifier& n,
 						  const std::function<void(const ds::Event *)>& fn,
 						  const std::function<void(ds::Event &)>& requestFn)
 		: mNotifier(n) {
-	if(fn) {
-		n.mEventNotifier.addListener(this, [this, fn](const ds::Event* m) {
-			if(m) this->onAppEvent(*m);
-			if(fn) fn(m);
-		});
-	} else {
-		n.mEventNotifier.addListener(this, [this](const ds::Event* m) {
-			if(m) this->onAppEvent(*m);
-		});
-	}
+	// Clients that only use listenToEvents() don't need to hear about everything
+	if(fn) n.mEventNotifier.addListener(this, fn);
 	if (requestFn) n.mEventNotifier.addRequestListener(this, requestFn);
 
 }
@@ -30,18 +24,18 @@ EventClient::EventClient( EventNotifier& n,
 EventClient::EventClient(ds::ui::SpriteEngine& eng)
 	: mNotifier(eng.getNotifier())
 {
-	mNotifier.mEventNotifier.addListener(this, [this](const ds::Event* m) {
-		if(m) this->onAppEvent(*m);
-	});
 }
 
 EventClient::~EventClient() {
 	mNotifier.mEventNotifier.removeListener(this);
 	mNotifier.mEventNotifier.removeRequestListener(this);
+	for(auto it = mEventTypes.begin(), end = mEventTypes.end(); it != end; ++it) {
+		mNotifier.removeTypedListener(this, *it);
+	}
 }
 
 void EventClient::notify(const ds::Event& e) {
-	mNotifier.mEventNotifier.notify(&e);
+	mNotifier.notify(e);
 }
 
 void EventClient::notify(const std::string& eventName) {
@@ -52,13 +46,14 @@ void EventClient::request(ds::Event& e) {
 	mNotifier.mEventNotifier.request(e);
 }
 
-void EventClient::onAppEvent(const ds::Event& in_e) {
-	if(mEventCallbacks.empty()) return;
+void EventClient::addEventCallback(const size_t type, const eventCallback& callback) {
+	mNotifier.addTypedListener(this, type, callback);
+	if(std::find(mEventTypes.begin(), mEventTypes.end(), type) == mEventTypes.end()) mEventTypes.push_back(type);
+}
 
-	auto callbackIt = mEventCallbacks.find(in_e.mWhat);
-	if(callbackIt != end(mEventCallbacks)) {
-		(callbackIt->second)(in_e);
-	}
+void EventClient::removeEventCallback(const size_t type) {
+	mNotifier.removeTypedListener(this, type);
+	mEventTypes.erase(std::remove(mEventTypes.begin(), mEventTypes.end(), type), mEventTypes.end());
 }
 
 } // namespace ds
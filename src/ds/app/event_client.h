@@ -4,6 +4,7 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace ds {
 class Event;
@@ -37,13 +38,14 @@ public:
 
 
 	/// Calls the lambda callback for the event type from Template, casting event automatically
-	/// This is an alternative to supplying a listener callback in the constructor for all events
+	/// This is an alternative to supplying a listener callback in the constructor for all events,
+	/// and is cheaper: the notifier only calls clients that listen to the type being sent.
 	template <class EVENT>
 	void listenToEvents(std::function<void(const EVENT&)> callback) {
 		static_assert(std::is_base_of<ds::Event, EVENT>::value, "EVENT not derived from ds::Event");
 		auto type = EVENT::WHAT();
 
-		mEventCallbacks[type] = [callback](const ds::Event& e) { callback(static_cast<const EVENT&>(e)); };
+		addEventCallback(type, [callback](const ds::Event& e) { callback(static_cast<const EVENT&>(e)); });
 	}
 	/// Disables / removes callback (if it exists) for the event from the template
 	/// This doesn't affect the callback supplied in the constructor
@@ -52,20 +54,19 @@ public:
 		static_assert(std::is_base_of<ds::Event, EVENT>::value, "EVENT not derived from ds::Event");
 		auto type = EVENT::WHAT();
 
-		auto findy = mEventCallbacks.find(type);
-		if(findy != end(mEventCallbacks)) {
-			mEventCallbacks.erase(findy);
-		}
+		removeEventCallback(type);
 	}
 
 private:
 	EventNotifier&	mNotifier;
 
 	using eventCallback = std::function<void(const ds::Event&)>;
-	using eventMap = std::unordered_map<size_t, eventCallback>;
 
-	void			onAppEvent(const ds::Event&);
-	eventMap		mEventCallbacks;
+	void			addEventCallback(const size_t type, const eventCallback&);
+	void			removeEventCallback(const size_t type);
+	/// The types registered with the notifier by listenToEvents()
+	std::vector<size_t>
+					mEventTypes;
 
 
 };
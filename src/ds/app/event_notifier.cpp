@@ -2,14 +2,17 @@
 
 #include <ds/app/event_notifier.h>
 
-
+#include <algorithm>
 
 namespace ds {
 
 /**
  * \class EventNotifier
  */
-EventNotifier::EventNotifier() {
+EventNotifier::EventNotifier()
+	: mSendDepth(0)
+	, mNeedsCompact(false)
+{
 }
 
 EventNotifier::~EventNotifier() {
@@ -31,19 +34,75 @@ void EventNotifier::removeRequestListener(void *id) {
 	mEventNotifier.removeRequestListener(id);
 }
 
+void EventNotifier::addTypedListener(void *id, const size_t what, const std::function<void(const ds::Event&)>& fn) {
+	if(!id || !fn) return;
+
+	TypedListener		listener;
+	listener.mId = id;
+	listener.mFn = fn;
+
+	// Sending could be part way through this type's listeners, so don't move them around
+	if(mSendDepth > 0) {
+		removeTypedListener(id, what);
+		mAddedTyped.push_back(std::make_pair(what, listener));
+		mNeedsCompact = true;
+		return;
+	}
+
+	TypedListeners&		listeners = mTypedListeners[what];
+	for(auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+		if(it->mId == id) {
+			it->mFn = fn;
+			return;
+		}
+	}
+	listeners.push_back(listener);
+}
+
+void EventNotifier::removeTypedListener(void *id, const size_t what) {
+	if(!id) return;
+
+	if(mSendDepth > 0) {
+		for(auto it = mAddedTyped.begin(); it != mAddedTyped.end(); ) {
+			if(it->first == what && it->second.mId == id) it = mAddedTyped.erase(it);
+			else ++it;
+		}
+	}
+
+	auto found = mTypedListeners.find(what);
+	if(found == mTypedListeners.end()) return;
+
+	TypedListeners&		listeners = found->second;
+	for(auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+		if(it->mId != id) continue;
+
+		// The function might be the one running, so it has to outlive the send
+		if(mSendDepth > 0) {
+			it->mId = nullptr;
+			mNeedsCompact = true;
+		} else {
+			listeners.erase(it);
+			if(listeners.empty()) mTypedListeners.erase(found);
+		}
+		return;
+	}
+}
+
 void EventNotifier::notify(const ds::Event& e) {
 	DS_LOG_VERBOSE(2, "EventNotifier::notify event " << e.getName());
+	notifyTyped(e);
 	mEventNotifier.notify(&e);
 }
 
 void EventNotifier::notify(const ds::Event* e) {
 	if(e) DS_LOG_VERBOSE(2, "EventNotifier::notify event " << e->getName());
+	if(e) notifyTyped(*e);
 	mEventNotifier.notify(e);
 }
 
 void EventNotifier::notify(const std::string& eventName) {
 	DS_LOG_VERBOSE(2, "EventNotifier::notify event " << eventName);
-	mEventNotifier.notify(event::Registry::get().getEventCreator(eventName)());
+	notify(event::Registry::get().getEventCreator(eventName)());
 }
 
 void EventNotifier::request(ds::Event& e) {
@@ -54,4 +113,60 @@ void EventNotifier::setOnAddListenerFn(const std::function<ds::Event*(void)> &fn
 	mEventNotifier.setOnAddListenerFn(fn);
 }
 
+void EventNotifier::flushDeferred() {
+	if(mDeferred.empty()) return;
+
+	// Anything deferred while these are sent waits for the next flush
+	std::vector<std::shared_ptr<ds::Event>>		events;
+	events.swap(mDeferred);
+	for(auto it = events.begin(), end = events.end(); it != end; ++it) {
+		notify(**it);
+	}
+}
+
+void EventNotifier::notifyTyped(const ds::Event& e) {
+	if(mTypedListeners.empty()) return;
+	auto found = mTypedListeners.find(e.mWhat);
+	if(found == mTypedListeners.end()) return;
+
+	// Nothing is added to or erased from this vector while it's being sent, see compactTyped()
+	const TypedListeners&	listeners = found->second;
+	++mSendDepth;
+	for(size_t i = 0, count = listeners.size(); i < count; ++i) {
+		if(listeners[i].mId) listeners[i].mFn(e);
+	}
+	--mSendDepth;
+
+	if(mSendDepth == 0 && mNeedsCompact) compactTyped();
+}
+
+void EventNotifier::compactTyped() {
+	mNeedsCompact = false;
+
+	for(auto it = mTypedListeners.begin(); it != mTypedListeners.end(); ) {
+		TypedListeners&		listeners = it->second;
+		listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [](const TypedListener& l) { return l.mId == nullptr; }), listeners.end());
+		if(listeners.empty()) it = mTypedListeners.erase(it);
+		else ++it;
+	}
+
+	std::vector<std::pair<size_t, TypedListener>>	added;
+	added.swap(mAddedTyped);
+	for(auto it = added.begin(), end = added.end(); it != end; ++it) {
+		addTypedListener(it->second.mId, it->first, it->second.mFn);
+	}
+}
+
+void EventNotifier::queueDeferred(const std::shared_ptr<ds::Event>& e) {
+	if(!e) return;
+
+	for(auto it = mDeferred.begin(), end = mDeferred.end(); it != end; ++it) {
+		if((*it)->mWhat == e->mWhat) {
+			*it = e;
+			return;
+		}
+	}
+	mDeferred.push_back(e);
+}
+
 } // namespace ds
@@ -2,6 +2,9 @@
 #ifndef DS_APP_EVENTNOTIFIER_H
 #define DS_APP_EVENTNOTIFIER_H
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include <ds/app/event.h>
 #include <ds/util/notifier.h>
 
@@ -10,6 +13,9 @@ namespace ds {
 /**
  * \class EventNotifier
  * \brief Holder for an event notifier.
+ *        Listeners either get every event (addListener()), or only the types they ask for
+ *        (addTypedListener(), which EventClient::listenToEvents() uses). Typed listeners are kept
+ *        in a table by event type, so sending an event only calls the listeners that want it.
  */
 class EventNotifier {
 public:
@@ -21,6 +27,11 @@ public:
 	void						removeListener(void *id);
 	void						removeRequestListener(void *id);
 
+	/// Calls fn for every event of type what. There's one per id and type, adding again replaces it.
+	/// Safe to add and remove while events are being sent; anything added then starts with the next event.
+	void						addTypedListener(void *id, const size_t what, const std::function<void(const ds::Event&)>&);
+	void						removeTypedListener(void *id, const size_t what);
+
 	/// Send an event to the system, for clients that don't need
 	/// an EventClient (i.e. don't need to receive events)
 	void						notify(const ds::Event&);
@@ -33,6 +44,13 @@ public:
 	/// If the name does not match, will fail without warning in release, with a warning in debug
 	void						notify(const std::string& eventName);
 
+	/// Queues a copy of the event to be sent at the end of the frame. If one of the same type is
+	/// already waiting it's replaced, so listeners only hear the latest of a burst of events.
+	template <class EVENT>
+	void						notifyDeferred(const EVENT& e) { queueDeferred(std::make_shared<EVENT>(e)); }
+	/// Sends everything queued by notifyDeferred(). The engine calls this after every update.
+	void						flushDeferred();
+
 	/**
 	* Request information from the system.
 	* \param requestEvent The event to be sent as a request to the event system
@@ -50,6 +68,27 @@ protected:
 	friend class EventClient;
 
 	ds::Notifier<ds::Event>    mEventNotifier;
+
+private:
+	struct TypedListener {
+		/// nullptr once removed while sending
+		void*										mId;
+		std::function<void(const ds::Event&)>		mFn;
+	};
+	typedef std::vector<TypedListener>			TypedListeners;
+
+	void						notifyTyped(const ds::Event&);
+	/// Applies anything added and removed while sending
+	void						compactTyped();
+	void						queueDeferred(const std::shared_ptr<ds::Event>&);
+
+	std::unordered_map<size_t, TypedListeners>	mTypedListeners;
+	/// Added while sending, keyed by event type
+	std::vector<std::pair<size_t, TypedListener>>
+												mAddedTyped;
+	int											mSendDepth;
+	bool										mNeedsCompact;
+	std::vector<std::shared_ptr<ds::Event>>		mDeferred;
 };
 
 } // namespace ds
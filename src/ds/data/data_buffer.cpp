@@ -1,23 +1,23 @@
 #include "stdafx.h"
 
 #include "data_buffer.h"
+#include <cstring>
 #include <string>
 
 namespace ds {
 
+namespace {
+// A varint is 7 bits per byte, so an unsigned is never more than 5
+const unsigned		MAX_LENGTH_BYTES = 5;
+}
+
 DataBuffer::DataBuffer(unsigned initialStreamSize)
 	: mStream(initialStreamSize)
 {
 }
 
 unsigned DataBuffer::size(){
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	return length;
+	return mStream.getLength();
 }
 
 void DataBuffer::seekBegin(){
@@ -34,26 +34,26 @@ void DataBuffer::addRaw(const char *b, unsigned size){
 }
 
 bool DataBuffer::readRaw(char *b, unsigned size){
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	if(size > (length - currentPosition))
+	if(size > mStream.getReadRemaining())
 		return false;
 
 	mStream.read(b, size);
 	return true;
 }
 
+const char *DataBuffer::readRaw(unsigned size){
+	return mStream.readInPlace(size);
+}
+
 void DataBuffer::add(const char *b, unsigned size){
 	add(size);
 	mStream.write(b, size);
 }
 
 void DataBuffer::add(const char *cs){
-	add<std::string>(cs);
+	const unsigned size = cs ? static_cast<unsigned>(strlen(cs)) : 0;
+	addLength(size);
+	mStream.write(cs, size);
 }
 
 void DataBuffer::add(const wchar_t *cs){
@@ -67,74 +67,83 @@ bool DataBuffer::read(char *b, unsigned size){
 		return false;
 	}
 
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	if(size > (length - currentPosition))
+	if(size > mStream.getReadRemaining())
 		return false;
 
-
 	mStream.read(b, size);
 	return true;
 }
 
+boost::string_ref DataBuffer::readStringRef(){
+	const unsigned startPosition = mStream.getReadPosition();
+	unsigned size = 0;
+	if(!readLength(size)) return boost::string_ref();
+
+	const char *s = mStream.readInPlace(size);
+	if(!s) {
+		mStream.setReadPosition(startPosition);
+		return boost::string_ref();
+	}
+	return boost::string_ref(s, size);
+}
+
+void DataBuffer::addLength(unsigned length){
+	char		bytes[MAX_LENGTH_BYTES];
+	unsigned	count = 0;
+	while(length >= 0x80) {
+		bytes[count++] = static_cast<char>((length & 0x7f) | 0x80);
+		length >>= 7;
+	}
+	bytes[count++] = static_cast<char>(length);
+	mStream.write(bytes, count);
+}
+
+bool DataBuffer::readLength(unsigned &length){
+	const unsigned startPosition = mStream.getReadPosition();
+	length = 0;
+	for(unsigned i = 0; i < MAX_LENGTH_BYTES; ++i) {
+		const char *b = mStream.readInPlace(1);
+		if(!b) break;
+
+		const unsigned char byte = static_cast<unsigned char>(*b);
+		length |= static_cast<unsigned>(byte & 0x7f) << (7 * i);
+		if((byte & 0x80) == 0) return true;
+	}
+
+	mStream.setReadPosition(startPosition);
+	length = 0;
+	return false;
+}
+
 
 // Template specializations
 template <>
 void DataBuffer::add<std::string>(const std::string &s){
 	unsigned size = (unsigned)s.size();
-	add(size);
+	addLength(size);
 	mStream.write(s.c_str(), size);
 }
 
 template <>
 void DataBuffer::add<std::wstring>(const std::wstring &ws){
 	unsigned size = (static_cast<unsigned int>(ws.size()))*sizeof(wchar_t);
-	add(size);
+	addLength(size);
 	mStream.write((const char *)(ws.c_str()), size);
 }
 
 template <>
 std::string DataBuffer::read<std::string>(){
-	unsigned size = read<unsigned>();
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	if(size > (length - currentPosition)) {
-		add(size);
-		return std::string();
-	}
-
-	mStringBuffer.setSize(size);
-
-	mStream.read(mStringBuffer.data(), size);
-	return std::string(mStringBuffer.data(), size);
+	const boost::string_ref s = readStringRef();
+	return std::string(s.data(), s.size());
 }
 
 template <>
 std::wstring DataBuffer::read<std::wstring>(){
-	unsigned size = read<unsigned>();
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	if(size > (length - currentPosition)) {
-		add(size);
-		return std::wstring();
-	}
-
-	mWStringBuffer.setSize(size);
-
-	mStream.read((char *)mWStringBuffer.data(), size);
-	return std::wstring((const wchar_t *)mWStringBuffer.data(), size / 2);
+	// Copied out rather than cast, since the characters aren't necessarily aligned in the buffer
+	const boost::string_ref s = readStringRef();
+	std::wstring ans(s.size() / sizeof(wchar_t), 0);
+	if(!ans.empty()) memcpy(&ans[0], s.data(), ans.size() * sizeof(wchar_t));
+	return ans;
 }
 
 } // namespace ds
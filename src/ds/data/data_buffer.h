@@ -2,14 +2,15 @@
 #ifndef DS_DATA_BUFFER_H
 #define DS_DATA_BUFFER_H
 #include <string>
+#include <boost/utility/string_ref.hpp>
 #include "read_write_buffer.h"
-#include "ds/query/recycle_array.h"
 
 namespace ds {
 
 /*
 	* brief
 	*   add functions must be matched be read function.
+	*   Strings are written with a varint length prefix, so short strings only cost one extra byte.
 	*/
 class DataBuffer
 {
@@ -26,6 +27,9 @@ public:
 	void addRaw(const char *b, unsigned size);
 	/// function to read raw data no size will be read.
 	bool readRaw(char *b, unsigned size);
+	/// Answers the next size bytes without copying them, or nullptr if there aren't that many.
+	/// Only valid until this buffer is next added to or cleared.
+	const char *readRaw(unsigned size);
 
 	/// will write size when writing data.
 	void add(const char *b, unsigned size);
@@ -38,6 +42,10 @@ public:
 	bool read(char *b, unsigned size);
 	template <typename T>
 	T read();
+	/// Reads a string written with add<std::string>() without copying it. The answer points into this buffer,
+	/// so it's only valid until the buffer is next added to or cleared; copy it with to_string() to keep it.
+	/// Answers an empty string and leaves the read position alone if there isn't a whole string to read.
+	boost::string_ref readStringRef();
 
 	template <typename T>
 	void rewindRead();
@@ -45,23 +53,15 @@ public:
 	template <typename T>
 	void rewindAdd();
 private:
+	void addLength(unsigned length);
+	bool readLength(unsigned &length);
+
 	ReadWriteBuffer		mStream;
-	RecycleArray<char>	mStringBuffer;
-	RecycleArray<char>	mWStringBuffer;
 };
 
 template <typename T>
 bool ds::DataBuffer::canRead(){
-	unsigned size = sizeof(T);
-	unsigned currentPosition = mStream.getReadPosition();
-
-	mStream.setReadPosition(ReadWriteBuffer::End);
-	unsigned length = mStream.getReadPosition();
-	mStream.setReadPosition(currentPosition);
-
-	if(size > (length - currentPosition))
-		return false;
-	return true;
+	return mStream.getReadRemaining() >= sizeof(T);
 }
 
 template <typename T>
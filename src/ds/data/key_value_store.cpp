@@ -2,46 +2,45 @@
 
 #include "ds/data/key_value_store.h"
 
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+#include <boost/variant/get.hpp>
+#include "ds/debug/logger.h"
 
 namespace ds {
 
 namespace {
 
-template <typename T>
-T				get_value(const std::unique_ptr<std::unordered_map<std::string, T>>& values, const std::string& key, const size_t index) {
-	if (!values.get()) throw std::invalid_argument("Key " + key + " is invalid");
-	if (values->empty()) throw std::invalid_argument("Key " + key + " is invalid");
-	const auto f = values->find(key);
-	if (f == values->end()) throw std::invalid_argument("Key " + key + " is invalid");
-	return f->second;
+// Far more keys than any app's data should have; past this, something is probably using values as keys
+const size_t	KEY_WARNING_COUNT = 100000;
+
+// Every key string used by any store, to its id
+std::mutex&		get_key_mutex() {
+	static std::mutex		MUTEX;
+	return MUTEX;
 }
 
-template <typename T>
-void			set_value(std::unique_ptr<std::unordered_map<std::string, T>>& values, const std::string& key, const T& value, const size_t index) {
-	if (!values.get()) {
-		values.reset(new std::unordered_map<std::string, T>());
-		if (!values.get()) throw std::runtime_error("Out of memory (KeyValueStore)");
-	}
+std::unordered_map<std::string, KeyValueStore::KeyId>& get_key_ids() {
+	static std::unordered_map<std::string, KeyValueStore::KeyId>	IDS;
+	return IDS;
+}
 
-	std::unordered_map<std::string, T>*		ptr = values.get();
-	(*ptr)[key] = value;
+// The map's nodes never move, so the key string can be held onto and read without the lock
+const std::pair<const std::string, KeyValueStore::KeyId>& intern_key(const std::string& key) {
+	std::lock_guard<std::mutex>	lock(get_key_mutex());
+	auto&						ids = get_key_ids();
+	auto						added = ids.emplace(key, static_cast<KeyValueStore::KeyId>(ids.size() + 1));
+	if (added.second && ids.size() == KEY_WARNING_COUNT) {
+		DS_LOG_WARNING("KeyValueStore has interned " << KEY_WARNING_COUNT << " distinct keys, which are never freed. Are values being used as keys?");
+	}
+	return *added.first;
 }
 
 template <typename T>
-void			set_equal(	const std::unique_ptr<std::unordered_map<std::string, T>>& src,
-							std::unique_ptr<std::unordered_map<std::string, T>>& dst) {
-	if (!src.get()) {
-		dst.release();
-		return;
-	}
-	if (!dst.get()) {
-		dst.reset(new std::unordered_map<std::string, T>());
-		if (!dst.get()) throw std::runtime_error("Out of memory (KeyValueStore)");
-	}
-	const std::unordered_map<std::string, T>*	src_ptr = src.get();
-	std::unordered_map<std::string, T>*			dst_ptr = dst.get();
-	(*dst) = (*src);
+T				get_or_throw(const T* value, const std::string& key) {
+	if (!value) throw std::invalid_argument("Key " + key + " is invalid");
+	return *value;
 }
 
 }
@@ -49,106 +48,174 @@ void			set_equal(	const std::unique_ptr<std::unordered_map<std::string, T>>& src
 /**
  * ds::KeyValueStore
  */
+KeyValueStore::KeyId KeyValueStore::getKeyId(const std::string& key) {
+	return intern_key(key).second;
+}
+
 KeyValueStore::KeyValueStore() {
 }
 
-KeyValueStore::KeyValueStore(const KeyValueStore& o) {
-	*this = o;
+KeyValueStore::KeyValueStore(const KeyValueStore& o)
+	: mEntries(o.mEntries)
+{
 }
 
 KeyValueStore& KeyValueStore::operator=(const KeyValueStore& o) {
 	if (this == &o) return *this;
 
-	set_equal<ci::ColorA>(o.mColorA, mColorA);
-	set_equal<float>(o.mFloat, mFloat);
-	set_equal<std::int32_t>(o.mInt, mInt);
+	mEntries = o.mEntries;
 
 	return *this;
 }
 
+template <typename T>
+const T* KeyValueStore::find(const std::string& key) const {
+	// Stores only hold a few entries, so comparing the strings is cheaper than looking up the id
+	for (auto it = mEntries.begin(), end = mEntries.end(); it != end; ++it) {
+		if (*it->mName != key) continue;
+		if (const T* value = boost::get<T>(&it->mValue)) return value;
+	}
+	return nullptr;
+}
+
+template <typename T>
+const T* KeyValueStore::find(const KeyId key) const {
+	if (key == 0) return nullptr;
+	for (auto it = mEntries.begin(), end = mEntries.end(); it != end; ++it) {
+		if (it->mKey != key) continue;
+		if (const T* value = boost::get<T>(&it->mValue)) return value;
+	}
+	return nullptr;
+}
+
+template <typename T>
+void KeyValueStore::set(const std::string& key, const T& value) {
+	const Entry*	sameKey = nullptr;
+	for (auto it = mEntries.begin(), end = mEntries.end(); it != end; ++it) {
+		if (*it->mName != key) continue;
+		if (T* existing = boost::get<T>(&it->mValue)) {
+			*existing = value;
+			return;
+		}
+		sameKey = &*it;
+	}
+	// Only a key this store hasn't seen needs the global table
+	if (sameKey) {
+		mEntries.push_back(Entry(sameKey->mKey, *sameKey->mName, Value(value)));
+		return;
+	}
+	const auto&		interned = intern_key(key);
+	mEntries.push_back(Entry(interned.second, interned.first, Value(value)));
+}
+
 ci::ColorA KeyValueStore::getColorA(const std::string& key, const size_t index) const {
-	return get_value<ci::ColorA>(mColorA, key, index);
+	return get_or_throw(find<ci::ColorA>(key), key);
 }
 
 ci::ColorA KeyValueStore::getColorA(const std::string& key, const size_t index, const ci::ColorA& notFound) const {
-	try {
-		return getColorA(key, index);
-	} catch (std::exception const&) {
-	}
-	return notFound;
+	const ci::ColorA*	value = find<ci::ColorA>(key);
+	return value ? *value : notFound;
 }
 
 float KeyValueStore::getFloat(const std::string& key, const size_t index) const {
-	return get_value<float>(mFloat, key, index);
+	return get_or_throw(find<float>(key), key);
 }
 
 float KeyValueStore::getFloat(const std::string& key, const size_t index, const float notFound) const {
-	try {
-		return getFloat(key, index);
-	} catch (std::exception const&) {
-	}
-	return notFound;
+	const float*		value = find<float>(key);
+	return value ? *value : notFound;
 }
 
 std::int32_t KeyValueStore::getInt(const std::string& key, const size_t index) const {
-	try {
-		return get_value<std::int32_t>(mInt, key, index);
-	} catch (std::exception const&) {
-		return 0;
-	}
+	const std::int32_t*	value = find<std::int32_t>(key);
+	return value ? *value : 0;
 }
 
 std::int32_t KeyValueStore::getInt(const std::string& key, const size_t index, const std::int32_t notFound) const {
-	int32_t out = getInt(key, index);
-	if (out == 0) {
-		out = notFound;
-	}
-	return out;
+	const std::int32_t*	value = find<std::int32_t>(key);
+	return value && *value != 0 ? *value : notFound;
 }
 
 std::string KeyValueStore::getString(const std::string& key, const size_t index) const {
-	try {
-		return get_value<std::string>(mString, key, index);
-	} catch (std::exception const&) {
-	}
-	return "";
+	const std::string*	value = find<std::string>(key);
+	return value ? *value : std::string();
 }
 
 std::string KeyValueStore::getString(const std::string& key, const size_t index, const std::string& notFound) const {
-	std::string found = getString(key, index);
-	if(!found.empty()) {
-		return found;
-	} else {
-		return notFound;
-	}
+	const std::string*	value = find<std::string>(key);
+	return value && !value->empty() ? *value : notFound;
+}
+
+bool KeyValueStore::tryGetColorA(const std::string& key, ci::ColorA& value) const {
+	const ci::ColorA*	found = find<ci::ColorA>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetColorA(const KeyId key, ci::ColorA& value) const {
+	const ci::ColorA*	found = find<ci::ColorA>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetFloat(const std::string& key, float& value) const {
+	const float*	found = find<float>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetFloat(const KeyId key, float& value) const {
+	const float*		found = find<float>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetInt(const std::string& key, std::int32_t& value) const {
+	const std::int32_t*	found = find<std::int32_t>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetInt(const KeyId key, std::int32_t& value) const {
+	const std::int32_t*	found = find<std::int32_t>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetString(const std::string& key, std::string& value) const {
+	const std::string*	found = find<std::string>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
+}
+
+bool KeyValueStore::tryGetString(const KeyId key, std::string& value) const {
+	const std::string*	found = find<std::string>(key);
+	if (!found) return false;
+	value = *found;
+	return true;
 }
 
 void KeyValueStore::setColorA(const std::string& key, const ci::ColorA& value, const size_t index) {
-	try {
-		set_value<ci::ColorA>(mColorA, key, value, index);
-	} catch (std::exception const&) {
-	}
+	set<ci::ColorA>(key, value);
 }
 
 void KeyValueStore::setFloat(const std::string& key, const float value, const size_t index) {
-	try {
-		set_value<float>(mFloat, key, value, index);
-	} catch (std::exception const&) {
-	}
+	set<float>(key, value);
 }
 
 void KeyValueStore::setInt(const std::string& key, const std::int32_t value, const size_t index) {
-	try {
-		set_value<std::int32_t>(mInt, key, value, index);
-	} catch (std::exception const&) {
-	}
+	set<std::int32_t>(key, value);
 }
 
 void KeyValueStore::setString(const std::string& key, const std::string& value, const size_t index) {
-	try {
-		set_value<std::string>(mString, key, value, index);
-	} catch (std::exception const&) {
-	}
+	set<std::string>(key, value);
 }
 
 } // namespace ds
@@ -4,8 +4,8 @@
 
 #include <cstdint>
 #include <string>
-#include <unordered_map>
-#include <vector>
+#include <boost/container/small_vector.hpp>
+#include <boost/variant/variant.hpp>
 #include <cinder/Color.h>
 
 namespace ds {
@@ -13,10 +13,22 @@ namespace ds {
 /**
  * \class KeyValueStore
  * \brief A generic data store. Intended to be relatively efficient for
- * sparse users, only allocating storage as needed.
+ * sparse users: the first few entries are stored inline, so most stores
+ * never allocate, and lookups just scan them in order.
+ * Keys are interned into global ids, so each key string is only stored once.
+ * A key can hold one value of each type at the same time.
  */
 class KeyValueStore {
 public:
+	/// Global id for a key string. 0 is never a valid id.
+	typedef std::uint32_t	KeyId;
+
+	/// Returns the id for the key, adding it to the global table if it's new. Ids are never reused.
+	/// Looking values up by id compares numbers instead of strings. Only adding a key locks the table.
+	/// The table holds every distinct key ever set and never shrinks, so keys should be names
+	/// (field names and the like), not data. It logs a warning if it gets suspiciously big.
+	static KeyId			getKeyId(const std::string& key);
+
 	KeyValueStore();
 	KeyValueStore(const KeyValueStore&);
 
@@ -30,25 +42,54 @@ public:
 	ci::ColorA				getColorA(const std::string& key, const size_t index, const ci::ColorA& notFound) const;
 	float					getFloat(const std::string& key, const size_t index = 0) const;
 	float					getFloat(const std::string& key, const size_t index, const float notFound) const;
+	/// Returns 0 when missing
 	std::int32_t			getInt(const std::string& key, const size_t index = 0) const;
+	/// Returns notFound when missing or 0. Use tryGetInt() to tell a stored 0 apart.
 	std::int32_t			getInt(const std::string& key, const size_t index, const std::int32_t notFound) const;
+	/// Returns an empty string when missing
 	std::string				getString(const std::string& key, const size_t index = 0) const;
+	/// Returns notFound when missing or empty. Use tryGetString() to tell a stored empty string apart.
 	std::string				getString(const std::string& key, const size_t index, const std::string& notFound) const;
 
+	/// Returns true and fills in value if the key has a value of that type, otherwise leaves value alone. Never throws.
+	bool					tryGetColorA(const std::string& key, ci::ColorA& value) const;
+	bool					tryGetColorA(const KeyId key, ci::ColorA& value) const;
+	bool					tryGetFloat(const std::string& key, float& value) const;
+	bool					tryGetFloat(const KeyId key, float& value) const;
+	bool					tryGetInt(const std::string& key, std::int32_t& value) const;
+	bool					tryGetInt(const KeyId key, std::int32_t& value) const;
+	bool					tryGetString(const std::string& key, std::string& value) const;
+	bool					tryGetString(const KeyId key, std::string& value) const;
+
 	void					setColorA(const std::string& key, const ci::ColorA& value, const size_t index = 0);
 	void					setFloat(const std::string& key, const float value, const size_t index = 0);
 	void					setInt(const std::string& key, const std::int32_t value, const size_t index = 0);
 	void					setString(const std::string& key, const std::string& value, const size_t index = 0);
 
+	bool					empty() const { return mEntries.empty(); }
+
 private:
-	std::unique_ptr<std::unordered_map<std::string, ci::ColorA>>
-							mColorA;
-	std::unique_ptr<std::unordered_map<std::string, float>>
-							mFloat;
-	std::unique_ptr<std::unordered_map<std::string, std::int32_t>>
-							mInt;
-	std::unique_ptr<std::unordered_map<std::string, std::string>>
-							mString;
+	typedef boost::variant<ci::ColorA, float, std::int32_t, std::string>
+							Value;
+
+	struct Entry {
+		Entry(const KeyId key, const std::string& name, const Value& value) : mKey(key), mName(&name), mValue(value) { }
+		KeyId				mKey;
+		/// The interned key string, so looking up by string doesn't touch the global table
+		const std::string*	mName;
+		Value				mValue;
+	};
+
+	template <typename T>
+	const T*				find(const std::string& key) const;
+	template <typename T>
+	const T*				find(const KeyId key) const;
+	template <typename T>
+	void					set(const std::string& key, const T& value);
+
+	/// Stores are usually created for a handful of values, so that many fit without allocating
+	boost::container::small_vector<Entry, 4>
+							mEntries;
 };
 
 } // namespace ds
@@ -36,6 +36,15 @@ bool ReadWriteBuffer::read(char *buffer, unsigned size){
 	return true;
 }
 
+const char *ReadWriteBuffer::readInPlace(unsigned size){
+	if(mBufferReadPosition + size > mMaxBufferWritePosition)
+		return nullptr;
+
+	const char *ans = mBuffer + mBufferReadPosition;
+	mBufferReadPosition += size;
+	return ans;
+}
+
 bool ReadWriteBuffer::write(const char *buffer, unsigned size){
 	if(mBufferWritePosition + size > mSize)
 		grow(math::getNextPowerOf2(static_cast<int32_t>(mSize + size)));
@@ -107,10 +116,10 @@ void ReadWriteBuffer::setWritePosition(const Postions &position){
 void ReadWriteBuffer::grow(unsigned size){
 	unsigned newSize = size;
 	char *newBuffer = new char[newSize];
-	memset(newBuffer, 0, newSize);
 
+	// Only what's been written matters, the rest gets written before it's read
 	if(mBuffer) {
-		memcpy(newBuffer, mBuffer, mSize);
+		memcpy(newBuffer, mBuffer, mMaxBufferWritePosition);
 		delete[] mBuffer;
 		mBuffer = nullptr;
 	}
@@ -15,6 +15,9 @@ public:
 	~ReadWriteBuffer();
 
 	bool read(char *buffer, unsigned size);
+	/// Answers the next size bytes in place and moves past them, or nullptr if there aren't that many.
+	/// Only valid until the next write or clear.
+	const char *readInPlace(unsigned size);
 	void rewindRead(unsigned size);
 	bool write(const char *buffer, unsigned size);
 	void rewindWrite(unsigned size);
@@ -22,6 +25,10 @@ public:
 	void reserve(unsigned size);
 	void clear();
 	unsigned size();
+	/// How much has been written
+	unsigned getLength() const { return mMaxBufferWritePosition; }
+	/// How much is left to read
+	unsigned getReadRemaining() const { return mMaxBufferWritePosition - mBufferReadPosition; }
 
 	unsigned getReadPosition() const;
 	void setReadPosition(const unsigned &position);
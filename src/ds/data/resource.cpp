@@ -3,6 +3,7 @@
 #include "ds/data/resource.h"
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <boost/algorithm/string.hpp>
 #include <Poco/Path.h>
@@ -33,6 +34,10 @@ const std::string		AUDIO_TYPE_SZ("a");
 
 const std::string		EMPTY_SZ("");
 
+const std::string		RESOURCE_COLUMNS_SZ("SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath,resourcesthumbid");
+// SQLite's default limit on bound params is 999
+const size_t			QUERY_MANY_BATCH = 512;
+
 const std::wstring		FONT_NAME_SZ(L"font");
 const std::wstring		IMAGE_NAME_SZ(L"image");
 const std::wstring		IMAGE_SEQUENCE_NAME_SZ(L"image sequence");
@@ -500,11 +505,8 @@ bool Resource::query(const Resource::Id& id) {
 	const std::string&          dbPath = id.getDatabasePath();
 	if (dbPath.empty()) return false;
 
-	std::stringstream           buf;
-	buf.str("");
-	buf << "SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath,resourcesthumbid FROM Resources WHERE resourcesid = " << id.mValue;
 	query::Result               r;
-	if (!query::Client::query(dbPath, buf.str(), r) || r.rowsAreEmpty()) {
+	if (!query::Client::query(dbPath, RESOURCE_COLUMNS_SZ + " FROM Resources WHERE resourcesid = ?", {query::SqlParam(id.mValue)}, r) || r.rowsAreEmpty()) {
 		return false;
 	}
 
@@ -535,6 +537,81 @@ bool Resource::query(const Resource::Id& id, Resource* outThumb) {
 	return ans;
 }
 
+std::vector<Resource> Resource::queryMany(const std::vector<Resource::Id>& ids, std::vector<Resource>* outThumbs) {
+	std::vector<Resource>		ans(ids.size());
+	if (outThumbs) {
+		outThumbs->clear();
+		outThumbs->resize(ids.size());
+	}
+
+	// Group the ids by database, then by value, keeping track of where each one goes in the answer
+	std::map<std::string, std::map<int, std::vector<size_t>>>	byDatabase;
+	for (size_t i = 0; i < ids.size(); ++i) {
+		const std::string&		dbPath = ids[i].getDatabasePath();
+		if (dbPath.empty()) continue;
+		byDatabase[dbPath][ids[i].mValue].push_back(i);
+	}
+
+	std::vector<query::SqlParam>	params;
+	std::string						sql;
+	for (auto db = byDatabase.begin(), dbEnd = byDatabase.end(); db != dbEnd; ++db) {
+		auto					next = db->second.begin();
+		while (next != db->second.end()) {
+			// Round the batch up to a power of two by repeating the last id, so there are only a handful of
+			// distinct statements and they stay in the prepared statement cache
+			params.clear();
+			for (; next != db->second.end() && params.size() < QUERY_MANY_BATCH; ++next) {
+				params.push_back(query::SqlParam(next->first));
+			}
+			const size_t		idCount = params.size();
+			size_t				batchSize = 1;
+			while (batchSize < params.size()) batchSize *= 2;
+			while (params.size() < batchSize) params.push_back(params.back());
+
+			sql = RESOURCE_COLUMNS_SZ + ",resourcesid FROM Resources WHERE resourcesid IN (?";
+			for (size_t i = 1; i < batchSize; ++i) sql += ",?";
+			sql += ")";
+
+			query::Result		r;
+			if (!query::Client::query(db->first, sql, params, r)) {
+				DS_LOG_WARNING("Resource::queryMany failed on " << db->first << " for a batch of " << idCount << " ids, they will come back empty");
+				continue;
+			}
+
+			query::Result::RowIterator	it(r);
+			while (it.hasValue()) {
+				auto			found = db->second.find(it.getInt(7));
+				if (found != db->second.end()) {
+					for (auto index : found->second) {
+						Resource&	res = ans[index];
+						res.setDbId(ids[index]);
+						res.setTypeFromString(it.getString(0));
+						res.mDuration = it.getFloat(1);
+						res.mWidth = it.getFloat(2);
+						res.mHeight = it.getFloat(3);
+						res.mFileName = it.getString(4);
+						res.mPath = it.getString(5);
+						res.mThumbnailId = it.getInt(6);
+					}
+				}
+				++it;
+			}
+		}
+	}
+
+	if (outThumbs) {
+		std::vector<Resource::Id>	thumbIds(ids.size());
+		for (size_t i = 0; i < ans.size(); ++i) {
+			if (ans[i].mThumbnailId <= 0) continue;
+			thumbIds[i] = ans[i].mDbId;
+			thumbIds[i].mValue = ans[i].mThumbnailId;
+		}
+		*outThumbs = queryMany(thumbIds);
+	}
+
+	return ans;
+}
+
 void Resource::setTypeFromString(const std::string& typeChar) {
 	mType = makeTypeFromString(typeChar);
 }
@@ -2,52 +2,69 @@
 
 #include "ds/data/resource_list.h"
 
-#include "ds/query/query_client.h"
-#include "ds/query/query_result.h"
+namespace {
+const size_t		DEFAULT_MAX_SIZE = 4096;
+}
 
 namespace ds {
 
 ResourceList::ResourceList()
+	: mMaxSize(DEFAULT_MAX_SIZE)
 {
 }
 
 void ResourceList::clear(){
-  mData.clear();
+	mData.clear();
+	mOrder.clear();
 }
 
 bool ResourceList::get(const Resource::Id& id, Resource& ans){
-	if(!mData.empty()) {
-		auto it = mData.find(id);
-		if(it != mData.end()) {
-			ans = it->second;
-			return true;
-		}
+	const Resource* found = find(id);
+	if(found) {
+		ans = *found;
+		return true;
 	}
 	return query(id, ans);
 }
 
+const Resource* ResourceList::find(const Resource::Id& id){
+	if(mData.empty()) return nullptr;
+	auto it = mData.find(id);
+	if(it == mData.end()) return nullptr;
+	mOrder.splice(mOrder.begin(), mOrder, it->second);
+	return &(*it->second);
+}
+
+void ResourceList::add(const Resource& r){
+	auto it = mData.find(r.getDbId());
+	if(it != mData.end()) {
+		*it->second = r;
+		mOrder.splice(mOrder.begin(), mOrder, it->second);
+		return;
+	}
+	mOrder.push_front(r);
+	mData[r.getDbId()] = mOrder.begin();
+	trim();
+}
+
+void ResourceList::setMaxSize(const size_t maxSize){
+	mMaxSize = maxSize < 1 ? 1 : maxSize;
+	trim();
+}
+
+void ResourceList::trim(){
+	while(mOrder.size() > mMaxSize) {
+		mData.erase(mOrder.back().getDbId());
+		mOrder.pop_back();
+	}
+}
+
 bool ResourceList::query(const Resource::Id& id, Resource& ans){
-	const std::string&          dbPath = id.getDatabasePath();
-	if(dbPath.empty()) return false;
-	std::stringstream buf;
-	buf.str("");
-	buf << "SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath FROM Resources WHERE resourcesid = " << id.mValue;
-	query::Result               r;
-	if(!query::Client::query(dbPath, buf.str(), r) || r.rowsAreEmpty()) return false;
-
-	query::Result::RowIterator  it(r);
-	if(!it.hasValue()) return false;
-
-	ans.setDbId(id);
-	ans.setTypeFromString(it.getString(0));
-	ans.mDuration = it.getFloat(1);
-	ans.mWidth = it.getFloat(2);
-	ans.mHeight = it.getFloat(3);
-	ans.mFileName = it.getString(4);
-	ans.mPath = it.getString(5);
-
-	mData[id] = ans;
+	Resource r;
+	if(!r.query(id)) return false;
 
+	ans = r;
+	add(r);
 	return true;
 }
 
@@ -2,6 +2,7 @@
 #ifndef DS_DATA_RESOURCELIST_H_
 #define DS_DATA_RESOURCELIST_H_
 
+#include <list>
 #include <sstream>
 #include <unordered_map>
 #include "ds/data/resource.h"
@@ -10,7 +11,9 @@ namespace ds {
 
 /**
  * \class ResourceList
- * \brief A caching collection of resources.
+ * \brief A caching collection of resources. The cache is bounded, least recently used
+ *        resources are dropped first. Main thread only; use ds::ResourceResolver to fill it
+ *        asynchronously.
  */
 class ResourceList
 {
@@ -18,11 +21,27 @@ public:
 	ResourceList();
 
 	void	clear();
+	/// Answer the cached resource, or query it synchronously if it isn't cached
 	bool	get(const Resource::Id&, Resource&);
 
+	/// Answer the cached resource, or nullptr. Doesn't query. The pointer is valid until the list next changes.
+	const Resource*
+			find(const Resource::Id&);
+	void	add(const Resource&);
+
+	/// Maximum number of cached resources. Defaults to 4096.
+	void	setMaxSize(const size_t);
+	size_t	size() const { return mOrder.size(); }
+
 private:
-	std::unordered_map<Resource::Id, ds::Resource>	
+	void	trim();
+
+	/// Most recently used first
+	std::list<ds::Resource>
+			mOrder;
+	std::unordered_map<Resource::Id, std::list<ds::Resource>::iterator>	
 			mData;
+	size_t	mMaxSize;
 
 	bool	query(const Resource::Id&, Resource&);
 };
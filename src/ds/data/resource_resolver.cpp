@@ -0,0 +1,284 @@
+#include "stdafx.h"
+
+#include "ds/data/resource_resolver.h"
+
+#include "ds/data/resource_list.h"
+#include "ds/debug/logger.h"
+#include "ds/thread/work_manager.h"
+#include "ds/util/memory_ds.h"
+
+namespace ds {
+
+namespace {
+const uint8_t		WAITING = 0;
+const uint8_t		WAITING_FOR_THUMBNAIL = 1;
+const uint8_t		DONE = 2;
+}
+
+/**
+ * \class ResourceResolver::Stats
+ */
+ResourceResolver::Stats::Stats()
+	: mRequests(0)
+	, mCacheHits(0)
+	, mCacheMisses(0)
+	, mCoalesced(0)
+	, mBatches(0)
+	, mIdsQueried(0)
+	, mTotalLatencyMs(0.0)
+	, mMaxLatencyMs(0.0)
+{
+}
+
+double ResourceResolver::Stats::getHitRate() const {
+	const size_t total = mCacheHits + mCacheMisses;
+	if(total < 1) return 0.0;
+	return static_cast<double>(mCacheHits) / static_cast<double>(total);
+}
+
+double ResourceResolver::Stats::getAverageLatencyMs() const {
+	if(mRequests < 1) return 0.0;
+	return mTotalLatencyMs / static_cast<double>(mRequests);
+}
+
+/**
+ * \class ResourceResolver
+ */
+ResourceResolver::ResourceResolver(ui::SpriteEngine& e, ResourceList& cache)
+	: ds::WorkClient(e)
+	, ds::AutoUpdate(e, AutoUpdateType::SERVER | AutoUpdateType::CLIENT)
+	, mCache(cache)
+	, mRequests(this)
+	, mNextRequestId(1)
+{
+}
+
+size_t ResourceResolver::resolve(const std::vector<Resource::Id>& ids, const Callback& callback, const bool withThumbnails) {
+	Pending p;
+	p.mRequestId = mNextRequestId++;
+	p.mIds = ids;
+	p.mWantsThumbnails = withThumbnails;
+	p.mCallback = callback;
+	p.mResources.resize(ids.size());
+	if(withThumbnails) p.mThumbnails.resize(ids.size());
+	p.mState.resize(ids.size(), WAITING);
+
+	for(auto it = ids.begin(), end = ids.end(); it != end; ++it) {
+		if(mCache.find(*it)) {
+			++mStats.mCacheHits;
+		} else {
+			++mStats.mCacheMisses;
+			if(mQueued.find(*it) != mQueued.end() || mInFlight.find(*it) != mInFlight.end()) ++mStats.mCoalesced;
+		}
+	}
+
+	mPending.push_back(std::move(p));
+	return mPending.back().mRequestId;
+}
+
+size_t ResourceResolver::resolve(const Resource::Id& id, const std::function<void(const Resource&)>& callback) {
+	return resolve(std::vector<Resource::Id>(1, id), [callback](const std::vector<Resource>& resources, const std::vector<Resource>&) {
+		if(callback && !resources.empty()) callback(resources.front());
+	});
+}
+
+void ResourceResolver::cancel(const size_t requestId) {
+	for(auto it = mPending.begin(), end = mPending.end(); it != end; ++it) {
+		if(it->mRequestId == requestId) {
+			mPending.erase(it);
+			return;
+		}
+	}
+}
+
+void ResourceResolver::clearMissing() {
+	mMissing.clear();
+}
+
+void ResourceResolver::resetStats() {
+	mStats = Stats();
+}
+
+void ResourceResolver::update(const ds::UpdateParams&) {
+	if(mPending.empty()) return;
+
+	// Everything that's still waiting queues what it needs, so the whole frame goes out as one batch
+	std::vector<Pending> ready;
+	for(auto it = mPending.begin(); it != mPending.end();) {
+		if(prepare(*it)) {
+			ready.push_back(std::move(*it));
+			it = mPending.erase(it);
+		} else {
+			++it;
+		}
+	}
+	sendBatch();
+	if(ready.empty()) return;
+
+	for(size_t i = 0; i < ready.size(); ++i) {
+		const Pending& p = ready[i];
+		const double latency = static_cast<double>(p.mStarted.elapsed()) / 1000.0;
+		++mStats.mRequests;
+		mStats.mTotalLatencyMs += latency;
+		if(latency > mStats.mMaxLatencyMs) mStats.mMaxLatencyMs = latency;
+	}
+
+	for(size_t i = 0; i < ready.size(); ++i) {
+		if(ready[i].mCallback) ready[i].mCallback(ready[i].mResources, ready[i].mThumbnails);
+	}
+}
+
+void ResourceResolver::handleResult(std::unique_ptr<WorkRequest>& wr) {
+	std::unique_ptr<Request> r(ds::unique_dynamic_cast<Request, WorkRequest>(wr));
+	if(!r) return;
+
+	// Everything found, for handing straight to the requests waiting on it. Going through the cache
+	// alone would lose whatever a big batch pushes out of it before the next update.
+	std::unordered_map<Resource::Id, const Resource*> found;
+	const size_t plainCount = r->mIds.size();
+	for(size_t i = 0; i < r->mResources.size(); ++i) {
+		const bool wantsThumbnail = i >= plainCount;
+		const Resource::Id& id = wantsThumbnail ? r->mThumbnailIds[i - plainCount] : r->mIds[i];
+		mInFlight.erase(id);
+
+		const Resource& res = r->mResources[i];
+		if(res.getDbId().empty()) {
+			mMissing.insert(id);
+			continue;
+		}
+		mCache.add(res);
+		found[id] = &res;
+
+		if(!wantsThumbnail) continue;
+		const Resource::Id tid = getThumbnailId(res);
+		if(tid.empty()) continue;
+		const Resource& thumb = r->mThumbnails[i - plainCount];
+		if(thumb.getDbId().empty()) {
+			mMissing.insert(tid);
+		} else {
+			mCache.add(thumb);
+			found[tid] = &thumb;
+		}
+	}
+
+	if(!found.empty()) {
+		for(auto it = mPending.begin(), end = mPending.end(); it != end; ++it) collect(*it, found);
+	}
+
+	mRequests.push(r);
+}
+
+bool ResourceResolver::prepare(Pending& p) {
+	bool ready = true;
+	for(size_t k = 0; k < p.mIds.size(); ++k) {
+		if(p.mState[k] == WAITING) {
+			const Resource* r = mCache.find(p.mIds[k]);
+			if(!r) {
+				if(require(p.mIds[k], p.mWantsThumbnails)) {
+					p.mState[k] = DONE;
+				} else {
+					ready = false;
+				}
+				continue;
+			}
+			p.mResources[k] = *r;
+			p.mState[k] = p.mWantsThumbnails ? WAITING_FOR_THUMBNAIL : DONE;
+		}
+		if(p.mState[k] != WAITING_FOR_THUMBNAIL) continue;
+
+		// Possibly cached without its thumbnail, i.e. resolved earlier by someone who didn't want it
+		const Resource::Id tid = getThumbnailId(p.mResources[k]);
+		const Resource* thumb = tid.empty() ? nullptr : mCache.find(tid);
+		if(thumb) {
+			p.mThumbnails[k] = *thumb;
+			p.mState[k] = DONE;
+		} else if(tid.empty() || require(tid, false)) {
+			p.mState[k] = DONE;
+		} else {
+			ready = false;
+		}
+	}
+	return ready;
+}
+
+void ResourceResolver::collect(Pending& p, const std::unordered_map<Resource::Id, const Resource*>& found) {
+	for(size_t k = 0; k < p.mIds.size(); ++k) {
+		if(p.mState[k] == WAITING) {
+			auto findy = found.find(p.mIds[k]);
+			if(findy == found.end()) continue;
+			p.mResources[k] = *findy->second;
+			p.mState[k] = p.mWantsThumbnails ? WAITING_FOR_THUMBNAIL : DONE;
+		}
+		if(p.mState[k] != WAITING_FOR_THUMBNAIL) continue;
+
+		const Resource::Id tid = getThumbnailId(p.mResources[k]);
+		if(tid.empty()) continue;
+		auto findy = found.find(tid);
+		if(findy == found.end()) continue;
+		p.mThumbnails[k] = *findy->second;
+		p.mState[k] = DONE;
+	}
+}
+
+bool ResourceResolver::require(const Resource::Id& id, const bool needsThumbnail) {
+	if(id.getDatabasePath().empty() || mMissing.find(id) != mMissing.end()) return true;
+	if(mCache.find(id)) return true;
+	if(mInFlight.find(id) != mInFlight.end()) return false;
+
+	bool& queuedThumbnail = mQueued[id];
+	queuedThumbnail = queuedThumbnail || needsThumbnail;
+	return false;
+}
+
+Resource::Id ResourceResolver::getThumbnailId(const Resource& r) const {
+	if(r.getThumbnailId() <= 0) return Resource::Id();
+	Resource::Id tid(r.getDbId());
+	tid.mValue = r.getThumbnailId();
+	return tid;
+}
+
+void ResourceResolver::sendBatch() {
+	if(mQueued.empty()) return;
+
+	std::unique_ptr<Request> r(std::move(mRequests.next()));
+	if(!r) return;
+
+	r->mIds.clear();
+	r->mThumbnailIds.clear();
+	r->mResources.clear();
+	r->mThumbnails.clear();
+	for(auto it = mQueued.begin(), end = mQueued.end(); it != end; ++it) {
+		if(it->second) r->mThumbnailIds.push_back(it->first);
+		else r->mIds.push_back(it->first);
+		mInFlight.insert(it->first);
+	}
+
+	++mStats.mBatches;
+	mStats.mIdsQueried += mQueued.size();
+
+	if(!mManager.sendRequest(ds::unique_dynamic_cast<WorkRequest, Request>(r))) {
+		DS_LOG_WARNING("ResourceResolver unable to send a batch of " << mQueued.size() << " resources, will retry");
+		// Leave them queued for the next update
+		for(auto it = mQueued.begin(), end = mQueued.end(); it != end; ++it) mInFlight.erase(it->first);
+		return;
+	}
+	mQueued.clear();
+}
+
+/**
+ * \class ResourceResolver::Request
+ */
+ResourceResolver::Request::Request(const void* clientId)
+	: WorkRequest(clientId)
+{
+}
+
+void ResourceResolver::Request::run() {
+	mResources = Resource::queryMany(mIds);
+	if(mThumbnailIds.empty()) return;
+
+	const std::vector<Resource> withThumbnails = Resource::queryMany(mThumbnailIds, &mThumbnails);
+	mResources.insert(mResources.end(), withThumbnails.begin(), withThumbnails.end());
+}
+
+} // namespace ds
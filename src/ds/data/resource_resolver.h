@@ -0,0 +1,131 @@
+#pragma once
+#ifndef DS_DATA_RESOURCERESOLVER_H_
+#define DS_DATA_RESOURCERESOLVER_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <Poco/Timestamp.h>
+#include "ds/app/auto_update.h"
+#include "ds/data/resource.h"
+#include "ds/thread/work_client.h"
+#include "ds/thread/work_request_list.h"
+
+namespace ds {
+class ResourceList;
+
+/**
+ * \class ResourceResolver
+ * \brief Resolves resource ids off the main thread. Everything requested in one frame goes to a
+ *        worker as a single batch (see Resource::queryMany()), ids that are already cached or
+ *        already being queried aren't queried again, and the results land in the engine's
+ *        ResourceList. Callbacks always happen in the update cycle, never inside resolve().
+ *        Get the engine's instance from SpriteEngine::getResourceResolver().
+ */
+class ResourceResolver : public ds::WorkClient
+					   , public ds::AutoUpdate
+{
+public:
+	/// resources lines up with the requested ids, anything that wasn't found is empty.
+	/// thumbnails is the same, and only filled out if they were requested.
+	typedef std::function<void(const std::vector<Resource>& resources, const std::vector<Resource>& thumbnails)>
+									Callback;
+
+	struct Stats {
+		Stats();
+		double						getHitRate() const;
+		double						getAverageLatencyMs() const;
+
+		size_t						mRequests;
+		/// Requested ids that were already cached
+		size_t						mCacheHits;
+		size_t						mCacheMisses;
+		/// Requested ids that were already queued or being queried for someone else
+		size_t						mCoalesced;
+		size_t						mBatches;
+		size_t						mIdsQueried;
+		/// Time from resolve() to the callback
+		double						mTotalLatencyMs;
+		double						mMaxLatencyMs;
+	};
+
+	ResourceResolver(ui::SpriteEngine&, ResourceList& cache);
+
+	/// Answers an id that can be passed to cancel(), which is never 0
+	size_t							resolve(const std::vector<Resource::Id>& ids, const Callback&, const bool withThumbnails = false);
+	size_t							resolve(const Resource::Id& id, const std::function<void(const Resource&)>&);
+	/// The callback won't be called. Anything already being queried still lands in the cache.
+	void							cancel(const size_t requestId);
+
+	/// Forgets which ids weren't found, so they're queried again. Call this when the database changes.
+	void							clearMissing();
+
+	const Stats&					getStats() const { return mStats; }
+	void							resetStats();
+
+protected:
+	virtual void					update(const ds::UpdateParams&);
+	virtual void					handleResult(std::unique_ptr<WorkRequest>&);
+
+private:
+	struct Pending {
+		size_t						mRequestId;
+		std::vector<Resource::Id>	mIds;
+		bool						mWantsThumbnails;
+		Callback					mCallback;
+		Poco::Timestamp				mStarted;
+
+		/// Answers collected so far, lined up with mIds. Copied here as they're found, so a request
+		/// with more ids than the cache holds still completes.
+		std::vector<Resource>		mResources,
+									mThumbnails;
+		/// Per id: waiting for the resource, waiting for its thumbnail, or done
+		std::vector<uint8_t>		mState;
+	};
+
+	class Request : public ds::WorkRequest {
+	public:
+		Request(const void* clientId);
+
+		/// input
+		std::vector<Resource::Id>	mIds,
+									mThumbnailIds;
+
+		/// output
+		std::vector<Resource>		mResources,
+									mThumbnails;
+
+		virtual void				run();
+	};
+
+	/// Collects anything the request needs that's cached and queues the rest. Answers true when everything is
+	/// collected or known missing.
+	bool							prepare(Pending&);
+	/// Collects anything the request needs from a finished batch, keyed by id
+	void							collect(Pending&, const std::unordered_map<Resource::Id, const Resource*>&);
+	/// needsThumbnail is ignored if the id is already cached
+	bool							require(const Resource::Id&, const bool needsThumbnail);
+	Resource::Id					getThumbnailId(const Resource&) const;
+	void							sendBatch();
+
+	ResourceList&					mCache;
+	ds::WorkRequestList<Request>	mRequests;
+	std::vector<Pending>			mPending;
+	size_t							mNextRequestId;
+
+	/// Ids for the next batch, and whether their thumbnails are wanted
+	std::unordered_map<Resource::Id, bool>
+									mQueued;
+	std::unordered_set<Resource::Id>
+									mInFlight;
+	std::unordered_set<Resource::Id>
+									mMissing;
+
+	Stats							mStats;
+};
+
+} // namespace ds
+
+#endif // DS_DATA_RESOURCERESOLVER_H_
@@ -21,7 +21,7 @@ float UserData::getFloat(const std::string& key, const size_t index, const float
 	if(!mStore) {
 		return notFound;
 	}
-	return mStore->getFloat(key, index);
+	return mStore->getFloat(key, index, notFound);
 }
 
 std::int32_t UserData::getInt(const std::string& key, const size_t index) const {
@@ -44,6 +44,30 @@ std::string UserData::getString(const std::string& key, const size_t index /*= 0
 	return mStore->getString(key, index);
 }
 
+bool UserData::tryGetFloat(const std::string& key, float& value) const {
+	return mStore && mStore->tryGetFloat(key, value);
+}
+
+bool UserData::tryGetFloat(const KeyValueStore::KeyId key, float& value) const {
+	return mStore && mStore->tryGetFloat(key, value);
+}
+
+bool UserData::tryGetInt(const std::string& key, std::int32_t& value) const {
+	return mStore && mStore->tryGetInt(key, value);
+}
+
+bool UserData::tryGetInt(const KeyValueStore::KeyId key, std::int32_t& value) const {
+	return mStore && mStore->tryGetInt(key, value);
+}
+
+bool UserData::tryGetString(const std::string& key, std::string& value) const {
+	return mStore && mStore->tryGetString(key, value);
+}
+
+bool UserData::tryGetString(const KeyValueStore::KeyId key, std::string& value) const {
+	return mStore && mStore->tryGetString(key, value);
+}
+
 void UserData::setFloat(const std::string& key, const float value, const size_t index) {
 	try {
 		if (!mStore) mStore.reset(new KeyValueStore());
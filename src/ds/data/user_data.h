@@ -26,6 +26,15 @@ public:
 	std::int32_t			getInt(const std::string& key, const size_t index, const std::int32_t notFound) const;
 	std::string				getString(const std::string& key, const size_t index = 0, const std::string& default = "") const;
 
+	/// Returns true and fills in value if the key has a value of that type, otherwise leaves value alone. Never throws.
+	/// The KeyId versions skip hashing the key, see KeyValueStore::getKeyId()
+	bool					tryGetFloat(const std::string& key, float& value) const;
+	bool					tryGetFloat(const KeyValueStore::KeyId key, float& value) const;
+	bool					tryGetInt(const std::string& key, std::int32_t& value) const;
+	bool					tryGetInt(const KeyValueStore::KeyId key, std::int32_t& value) const;
+	bool					tryGetString(const std::string& key, std::string& value) const;
+	bool					tryGetString(const KeyValueStore::KeyId key, std::string& value) const;
+
 	void					setFloat(const std::string& key, const float value, const size_t index = 0);
 	void					setInt(const std::string& key, const std::int32_t value, const size_t index = 0);
 	void					setString(const std::string& key, const std::string& value, const size_t index = 0);
@@ -0,0 +1,353 @@
+#include "stdafx.h"
+
+#include "ds/debug/frame_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ds {
+
+namespace {
+// Worker threads only record for the trace export; the main thread has room for a few frames of DETAIL
+const size_t		THREAD_CAPACITY = 1 << 14;
+const size_t		MAIN_THREAD_CAPACITY = 1 << 18;
+const double		SMOOTHING = 0.1;
+// Anything that hasn't run in a while decays below this and is dropped
+const double		DROP_BELOW_MS = 0.0001;
+
+uint64_t now_ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct Event {
+	const char*		mName;
+	const char*		mCategory;
+	uint64_t		mStart;
+	uint64_t		mDuration;
+	/// Duration minus nested scopes
+	uint64_t		mSelf;
+	uint32_t		mDepth;
+};
+
+/// Only the owning thread pushes, and nothing locks: a push writes the slot, then publishes it by bumping the count.
+/// Readers copy what's there, then drop anything the owner may have written over while they were copying.
+struct ThreadBuffer {
+	ThreadBuffer(const uint32_t id) : mCount(0), mId(id) { mEvents.resize(THREAD_CAPACITY); }
+
+	void push(const Event& e) {
+		const uint64_t		count = mCount.load(std::memory_order_relaxed);
+		mEvents[count % mEvents.size()] = e;
+		mCount.store(count + 1, std::memory_order_release);
+	}
+
+	/// Appends the events from index from on that are still in the ring, and answers where to read from next time
+	uint64_t read(const uint64_t from, std::vector<Event>& out) const {
+		const uint64_t		count = mCount.load(std::memory_order_acquire);
+		const uint64_t		capacity = mEvents.size();
+		const uint64_t		first = std::max(from, count > capacity ? count - capacity : 0);
+		const size_t		start = out.size();
+		for(uint64_t i = first; i < count; ++i) {
+			out.push_back(mEvents[i % capacity]);
+		}
+
+		// The owner could have lapped the oldest of those, including the slot it's writing right now
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t		after = mCount.load(std::memory_order_relaxed) + 1;
+		if(after > capacity + first) {
+			const uint64_t	lost = std::min(after - capacity, count) - first;
+			out.erase(out.begin() + start, out.begin() + start + static_cast<size_t>(lost));
+		}
+		return count;
+	}
+
+	std::vector<Event>	mEvents;
+	/// Total ever pushed, the ring index is this modulo the capacity
+	std::atomic<uint64_t>
+						mCount;
+	const uint32_t		mId;
+	std::string			mName;
+};
+
+struct StatKey {
+	const char*			mName;
+	const char*			mCategory;
+	bool operator==(const StatKey& o) const { return mName == o.mName && mCategory == o.mCategory; }
+};
+
+struct StatKeyHash {
+	size_t operator()(const StatKey& k) const {
+		return std::hash<const void*>()(k.mName) ^ (std::hash<const void*>()(k.mCategory) << 1);
+	}
+};
+
+struct Stat {
+	Stat() : mDepth(0), mFirstStart(0), mIsClass(false), mAverageMs(0.0), mLastMs(0.0), mFrameNs(0) {}
+	int					mDepth;
+	/// Phases are listed in the order they first ran
+	uint64_t			mFirstStart;
+	bool				mIsClass;
+	double				mAverageMs;
+	double				mLastMs;
+	uint64_t			mFrameNs;
+};
+
+struct Registry {
+	Registry() : mEpoch(now_ns()), mMain(nullptr), mMainRead(0), mFrameStart(0), mFrameMs(0.0) {}
+
+	std::mutex			mMutex;
+	const uint64_t		mEpoch;
+	std::vector<std::unique_ptr<ThreadBuffer>>
+						mBuffers;
+
+	// Main thread summary
+	ThreadBuffer*		mMain;
+	uint64_t			mMainRead;
+	uint64_t			mFrameStart;
+	double				mFrameMs;
+	std::unordered_map<StatKey, Stat, StatKeyHash>
+						mStats;
+	std::vector<Event>	mScratch;
+};
+
+Registry& get_registry() {
+	static Registry		REGISTRY;
+	return REGISTRY;
+}
+
+thread_local ThreadBuffer*				THREAD_BUFFER = nullptr;
+thread_local FrameProfiler::Scope*		THREAD_SCOPE = nullptr;
+
+ThreadBuffer& get_thread_buffer() {
+	if(!THREAD_BUFFER) {
+		Registry&					r = get_registry();
+		std::lock_guard<std::mutex>	l(r.mMutex);
+		r.mBuffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(static_cast<uint32_t>(r.mBuffers.size() + 1))));
+		THREAD_BUFFER = r.mBuffers.back().get();
+		THREAD_BUFFER->mName = "thread " + std::to_string(THREAD_BUFFER->mId);
+	}
+	return *THREAD_BUFFER;
+}
+
+/// MSVC type names come through as "class ds::ui::Sprite"
+std::string pretty_name(const char* name) {
+	std::string		ans(name);
+	if(ans.compare(0, 6, "class ") == 0) ans.erase(0, 6);
+	else if(ans.compare(0, 7, "struct ") == 0) ans.erase(0, 7);
+	return ans;
+}
+
+void write_json_string(std::ostream& os, const std::string& s) {
+	os << '"';
+	for(auto it = s.begin(), end = s.end(); it != end; ++it) {
+		const char c = *it;
+		if(c == '"' || c == '\\') os << '\\' << c;
+		else if(static_cast<unsigned char>(c) < 0x20) os << ' ';
+		else os << c;
+	}
+	os << '"';
+}
+
+/// Merges stats that share a name and category (the same literal can have a different address in each translation unit)
+std::vector<FrameProfiler::Timing> merge_stats(const std::vector<std::pair<const StatKey*, const Stat*>>& stats) {
+	std::vector<FrameProfiler::Timing>		ans;
+	std::unordered_map<std::string, size_t>	index;
+	for(auto it = stats.begin(), end = stats.end(); it != end; ++it) {
+		const std::string	name = pretty_name(it->first->mName);
+		const std::string	key = name + "|" + it->first->mCategory;
+		auto				found = index.find(key);
+		if(found != index.end()) {
+			FrameProfiler::Timing&	t = ans[found->second];
+			t.mAverageMs += it->second->mAverageMs;
+			t.mLastMs += it->second->mLastMs;
+			t.mDepth = std::min(t.mDepth, it->second->mDepth);
+			continue;
+		}
+		FrameProfiler::Timing		t;
+		t.mName = name;
+		t.mCategory = it->first->mCategory;
+		t.mDepth = it->second->mDepth;
+		t.mAverageMs = it->second->mAverageMs;
+		t.mLastMs = it->second->mLastMs;
+		index[key] = ans.size();
+		ans.push_back(t);
+	}
+	return ans;
+}
+}
+
+/**
+ * \class FrameProfiler::Scope
+ */
+void FrameProfiler::Scope::begin(const char* name, const char* category) {
+	mName = name;
+	mCategory = category;
+	mChildren = 0;
+	mParent = THREAD_SCOPE;
+	mDepth = mParent ? mParent->mDepth + 1 : 0;
+	THREAD_SCOPE = this;
+	mStart = now_ns();
+}
+
+void FrameProfiler::Scope::end() {
+	const uint64_t		duration = now_ns() - mStart;
+	if(mParent) mParent->mChildren += duration;
+	THREAD_SCOPE = mParent;
+
+	Event				e;
+	e.mName = mName;
+	e.mCategory = mCategory;
+	e.mStart = mStart;
+	e.mDuration = duration;
+	e.mSelf = duration > mChildren ? duration - mChildren : 0;
+	e.mDepth = mDepth;
+	get_thread_buffer().push(e);
+}
+
+/**
+ * \class FrameProfiler
+ */
+std::atomic<int> FrameProfiler::sLevel(FrameProfiler::OFF);
+
+void FrameProfiler::setLevel(const int level) {
+	sLevel.store(std::max<int>(OFF, std::min<int>(DETAIL, level)), std::memory_order_relaxed);
+}
+
+void FrameProfiler::nextFrame() {
+	if(!isActive(PHASES)) return;
+
+	ThreadBuffer&				b = get_thread_buffer();
+	Registry&					r = get_registry();
+	const uint64_t				now = now_ns();
+	std::lock_guard<std::mutex>	l(r.mMutex);
+
+	if(r.mMain != &b) {
+		// First frame, this is the main thread from here on. Only this thread pushes to its buffer, and
+		// the registry lock keeps the trace export out.
+		r.mMain = &b;
+		b.mName = "main";
+		b.mEvents.resize(MAIN_THREAD_CAPACITY);
+		b.mCount.store(0, std::memory_order_relaxed);
+		r.mMainRead = 0;
+		r.mFrameStart = now;
+		return;
+	}
+
+	const double				frameMs = static_cast<double>(now - r.mFrameStart) / 1000000.0;
+	r.mFrameStart = now;
+	r.mFrameMs = r.mFrameMs > 0.0 ? r.mFrameMs * (1.0 - SMOOTHING) + frameMs * SMOOTHING : frameMs;
+
+	r.mScratch.clear();
+	r.mMainRead = b.read(r.mMainRead, r.mScratch);
+
+	for(auto it = r.mStats.begin(), end = r.mStats.end(); it != end; ++it) it->second.mFrameNs = 0;
+	for(auto it = r.mScratch.begin(), end = r.mScratch.end(); it != end; ++it) {
+		StatKey					key;
+		key.mName = it->mName;
+		key.mCategory = it->mCategory;
+		auto					found = r.mStats.find(key);
+		if(found == r.mStats.end()) {
+			Stat				s;
+			s.mFirstStart = it->mStart;
+			s.mDepth = static_cast<int>(it->mDepth);
+			s.mIsClass = std::strcmp(it->mCategory, "phase") != 0;
+			found = r.mStats.insert(std::make_pair(key, s)).first;
+		}
+		Stat&					s = found->second;
+		// Classes nest inside each other (sprites inside sprites), so they only count their own time
+		s.mFrameNs += s.mIsClass ? it->mSelf : it->mDuration;
+		s.mDepth = std::min(s.mDepth, static_cast<int>(it->mDepth));
+	}
+
+	for(auto it = r.mStats.begin(); it != r.mStats.end();) {
+		Stat&					s = it->second;
+		s.mLastMs = static_cast<double>(s.mFrameNs) / 1000000.0;
+		s.mAverageMs = s.mAverageMs * (1.0 - SMOOTHING) + s.mLastMs * SMOOTHING;
+		if(s.mFrameNs == 0 && s.mAverageMs < DROP_BELOW_MS) it = r.mStats.erase(it);
+		else ++it;
+	}
+}
+
+std::vector<FrameProfiler::Timing> FrameProfiler::getPhaseTimings() {
+	Registry&					r = get_registry();
+	std::lock_guard<std::mutex>	l(r.mMutex);
+
+	std::vector<std::pair<const StatKey*, const Stat*>>	stats;
+	for(auto it = r.mStats.begin(), end = r.mStats.end(); it != end; ++it) {
+		if(!it->second.mIsClass) stats.push_back(std::make_pair(&it->first, &it->second));
+	}
+	std::sort(stats.begin(), stats.end(), [](const std::pair<const StatKey*, const Stat*>& a, const std::pair<const StatKey*, const Stat*>& b) {
+		return a.second->mFirstStart < b.second->mFirstStart; });
+	return merge_stats(stats);
+}
+
+std::vector<FrameProfiler::Timing> FrameProfiler::getClassTimings(const size_t count) {
+	std::vector<Timing>			ans;
+	{
+		Registry&					r = get_registry();
+		std::lock_guard<std::mutex>	l(r.mMutex);
+
+		std::vector<std::pair<const StatKey*, const Stat*>>	stats;
+		for(auto it = r.mStats.begin(), end = r.mStats.end(); it != end; ++it) {
+			if(it->second.mIsClass) stats.push_back(std::make_pair(&it->first, &it->second));
+		}
+		ans = merge_stats(stats);
+	}
+	std::sort(ans.begin(), ans.end(), [](const Timing& a, const Timing& b) { return a.mAverageMs > b.mAverageMs; });
+	if(ans.size() > count) ans.resize(count);
+	return ans;
+}
+
+double FrameProfiler::getAverageFrameMs() {
+	Registry&					r = get_registry();
+	std::lock_guard<std::mutex>	l(r.mMutex);
+	return r.mFrameMs;
+}
+
+void FrameProfiler::setThreadName(const std::string& name) {
+	ThreadBuffer&				b = get_thread_buffer();
+	std::lock_guard<std::mutex>	l(get_registry().mMutex);
+	b.mName = name;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& path) {
+	std::ofstream				os(path.c_str(), std::ios::out | std::ios::trunc);
+	if(!os.is_open()) return false;
+
+	Registry&					r = get_registry();
+	std::lock_guard<std::mutex>	l(r.mMutex);
+	bool						first = true;
+	std::vector<Event>			events;
+	os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+	for(auto it = r.mBuffers.begin(), end = r.mBuffers.end(); it != end; ++it) {
+		ThreadBuffer&				b = **it;
+		events.clear();
+		b.read(0, events);
+
+		os << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b.mId << ",\"args\":{\"name\":";
+		write_json_string(os, b.mName);
+		os << "}}";
+		first = false;
+
+		for(auto e_it = events.begin(), e_end = events.end(); e_it != e_end; ++e_it) {
+			const Event&			e = *e_it;
+			os << ",\n{\"name\":";
+			write_json_string(os, pretty_name(e.mName));
+			os << ",\"cat\":";
+			write_json_string(os, e.mCategory);
+			os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << b.mId
+				<< ",\"ts\":" << static_cast<double>(static_cast<int64_t>(e.mStart - r.mEpoch)) / 1000.0
+				<< ",\"dur\":" << static_cast<double>(e.mDuration) / 1000.0 << "}";
+		}
+	}
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return os.good();
+}
+
+} // namespace ds
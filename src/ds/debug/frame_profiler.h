@@ -0,0 +1,103 @@
+#pragma once
+#ifndef DS_DEBUG_FRAMEPROFILER_H_
+#define DS_DEBUG_FRAMEPROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace ds {
+
+/**
+ * \class FrameProfiler
+ * \brief Scoped timers placed through the engine, services and sprites. Each thread records into
+ *        its own ring buffer, the main thread's frame is summarized every App::update() for the
+ *        stats view, and everything still in the buffers can be written out as a Chrome trace
+ *        (open it in chrome://tracing or https://ui.perfetto.dev).
+ *        When the level is OFF, a scope costs one relaxed load and one branch.
+ *        Levels:
+ *          PHASES: engine phases (touch, auto updates, roots, network, draw).
+ *          DETAIL: also every sprite update and draw, and every AutoUpdate, summarized by class.
+ *        Set with the engine setting "profiler:level", or toggle with the F7 key.
+ *        Use the DS_PROFILE_SCOPE() macros rather than Scope directly.
+ */
+class FrameProfiler {
+public:
+	enum Level { OFF = 0, PHASES = 1, DETAIL = 2 };
+
+	static bool					isActive(const int level) { return sLevel.load(std::memory_order_relaxed) >= level; }
+	static int					getLevel() { return sLevel.load(std::memory_order_relaxed); }
+	static void					setLevel(const int);
+
+	class Scope {
+	public:
+		/// name and category must outlive the profiler, i.e. string literals or type_info names
+		Scope(const char* name, const char* category, const int level = PHASES)
+			: mName(nullptr)
+		{
+			if(isActive(level)) begin(name, category);
+		}
+		/// Named for the dynamic type of obj, which is only looked up when active
+		template <typename T>
+		Scope(const T* obj, const char* category, const int level)
+			: mName(nullptr)
+		{
+			if(isActive(level)) begin(typeid(*obj).name(), category);
+		}
+		~Scope() { if(mName) end(); }
+
+	private:
+		Scope(const Scope&) = delete;
+		Scope&					operator=(const Scope&) = delete;
+		void					begin(const char* name, const char* category);
+		void					end();
+
+		const char*				mName;
+		const char*				mCategory;
+		uint64_t				mStart;
+		uint64_t				mChildren;
+		Scope*					mParent;
+		uint32_t				mDepth;
+	};
+
+	struct Timing {
+		std::string				mName;
+		std::string				mCategory;
+		int						mDepth;
+		/// Smoothed over recent frames
+		double					mAverageMs;
+		double					mLastMs;
+	};
+
+	/// Called once per frame on the main thread, at the top of App::update().
+	/// Summarizes everything the main thread recorded since the last call.
+	static void					nextFrame();
+
+	/// The main thread's phases, in the order they first ran. Times include nested scopes.
+	static std::vector<Timing>	getPhaseTimings();
+	/// The slowest sprite and AutoUpdate classes, by time spent in themselves excluding their children
+	static std::vector<Timing>	getClassTimings(const size_t count);
+	static double				getAverageFrameMs();
+
+	/// Names the calling thread in exported traces
+	static void					setThreadName(const std::string&);
+	/// Everything currently in every thread's ring buffer, in Chrome's trace event format
+	static bool					writeChromeTrace(const std::string& path);
+
+private:
+	static std::atomic<int>		sLevel;
+};
+
+} // namespace ds
+
+#define DS_PROFILE_CONCAT_INNER(a, b)		a##b
+#define DS_PROFILE_CONCAT(a, b)				DS_PROFILE_CONCAT_INNER(a, b)
+
+/// Times the rest of the enclosing block as an engine phase
+#define DS_PROFILE_SCOPE(name)				ds::FrameProfiler::Scope DS_PROFILE_CONCAT(ds_profile_scope_, __LINE__)(name, "phase")
+/// Times the rest of the enclosing block under the class of the object ptr points to, at the DETAIL level
+#define DS_PROFILE_OBJECT_SCOPE(ptr, category)	ds::FrameProfiler::Scope DS_PROFILE_CONCAT(ds_profile_scope_, __LINE__)(ptr, category, ds::FrameProfiler::DETAIL)
+
+#endif // DS_DEBUG_FRAMEPROFILER_H_
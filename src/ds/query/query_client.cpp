@@ -5,18 +5,31 @@
 #include "ds/debug/debug_defines.h"
 #include "ds/util/memory_ds.h"
 #include "ds/thread/work_manager.h"
-#include "ds/query/sql_database.h"
+#include "ds/query/sql_connection_pool.h"
 #include "ds/query/sql_query_result_builder.h"
 
-static bool run_query(ds::query::SqlDatabase& db,  const std::string& select, ds::query::Result& qr, const int flags = 0)
+namespace {
+const std::vector<ds::query::SqlParam>	NO_PARAMS;
+
+bool run_query(	const std::string& database, const int openFlags, const std::string& select,
+				const std::vector<ds::query::SqlParam>& params, ds::query::Result& qr, const int flags = 0,
+				int* errorCode = nullptr)
 {
 	qr.clear();
-	if (select.empty()) return false;
+	if (database.empty() || select.empty()) return false;
+
+	// The lease has to outlive the result builder, which resets the cached statement when it's done
+	ds::query::SqlConnectionPool::Lease	db(ds::query::SqlConnectionPool::get().acquire(database, openFlags, errorCode));
+	if (!db) return false;
 
-	ds::query::SqlResultBuilder		qrb(qr, db.rawSelect(select));
+	sqlite3_stmt*					stmt = db->prepareCached(select);
+	if (stmt && !ds::query::SqlDatabase::bind(stmt, params)) return false;
+
+	ds::query::SqlResultBuilder		qrb(qr, stmt, false);
 	qrb.build((flags&ds::query::Client::INCLUDE_COLUMN_NAMES_F) != 0);
 	return qrb.isValid();
 }
+}
 
 namespace ds {
 
@@ -25,25 +38,30 @@ namespace query {
 bool Client::query(	const std::string& database, const std::string& select,
 					          Result& qr, const int flags)
 {
-	qr.clear();
-	if (database.empty() || select.empty()) return false;
+	return run_query(database, SQLITE_OPEN_READONLY, select, NO_PARAMS, qr, flags);
+}
 
-	int							errorCode = 0;
-	SqlDatabase					sqlDb(database, SQLITE_OPEN_READONLY, &errorCode);
-	if (errorCode != SQLITE_OK) return false;
-	return run_query(sqlDb, select, qr, flags);
+bool Client::query(	const std::string& database, const std::string& select, const std::vector<SqlParam>& params,
+					Result& qr, const int flags)
+{
+	return run_query(database, SQLITE_OPEN_READONLY, select, params, qr, flags);
 }
 
 bool Client::queryWrite(const std::string& database, const std::string& select,
 						            Result& qr)
 {
-	qr.clear();
-	if (database.empty()) return false;
+	return run_query(database, SQLITE_OPEN_READWRITE, select, NO_PARAMS, qr);
+}
 
-	int							errorCode = 0;
-	SqlDatabase					sqlDb(database, SQLITE_OPEN_READWRITE, &errorCode);
-	if (errorCode != SQLITE_OK) return false;
-	return run_query(sqlDb, select, qr);
+bool Client::queryWrite(const std::string& database, const std::string& select, const std::vector<SqlParam>& params,
+						Result& qr)
+{
+	return run_query(database, SQLITE_OPEN_READWRITE, select, params, qr);
+}
+
+void Client::closeConnections(const std::string& database)
+{
+	SqlConnectionPool::get().closeConnections(database);
 }
 
 /**
@@ -103,13 +121,10 @@ Client::Request::Request(const void* clientId)
 void Client::Request::run()
 {
 	int							errorCode = 0;
-	SqlDatabase					resourceDB(mDatabase, SQLITE_OPEN_READONLY, &errorCode);
+	run_query(mDatabase, SQLITE_OPEN_READONLY, mQuery, NO_PARAMS, mResult, 0, &errorCode);
 	if (errorCode != SQLITE_OK) {
 		DS_LOG_WARNING("ds::query::Client::Request: Unable to access the resource database (SQLite error " << errorCode << ").");
 	} else {
-		SqlResultBuilder		qrb(mResult, resourceDB.rawSelect(mQuery));
-		qrb.build();
-
 		ResultBuilder::setRequestTime(mResult, mRequestTime);
 		ResultBuilder::setClientId(mResult, mRunId);
 	}
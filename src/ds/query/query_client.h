@@ -7,6 +7,7 @@
 #include "ds/thread/work_request_list.h"
 #include "ds/query/query_result.h"
 #include "ds/query/query_talkback.h"
+#include "ds/query/sql_database.h"
 
 namespace ds {
 
@@ -45,6 +46,19 @@ class Client : public ds::WorkClient {
 	static bool             queryWrite(	const std::string& database, const std::string& query,
 									   Result& result);
 
+	/** \brief Same as the query() and queryWrite() above, with values bound to each '?' in the query.
+				Connections and prepared statements are cached per database, so a query whose text doesn't
+				change (only its params) skips both the open and the prepare after the first call.
+	*/
+	static bool             query(const std::string& database, const std::string& query, const std::vector<SqlParam>& params,
+								  Result& result, const int flags = 0);
+	static bool             queryWrite(	const std::string& database, const std::string& query, const std::vector<SqlParam>& params,
+									   Result& result);
+
+	/** \brief Close the cached connections to the database. Call this before replacing or deleting the database file.
+	*/
+	static void             closeConnections(const std::string& database);
+
 	/** \brief Regular constructor for non-static queries. In most cases, you can safely use the static API.	
 	*/
 	Client(ui::SpriteEngine&, const std::function<void(const Result&, Talkback&)>& = nullptr);
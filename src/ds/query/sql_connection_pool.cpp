@@ -0,0 +1,279 @@
+#include "stdafx.h"
+
+#include "ds/query/sql_connection_pool.h"
+
+#include <Poco/File.h>
+#include "ds/debug/logger.h"
+#include "ds/util/file_meta_data.h"
+
+namespace {
+const size_t		DEFAULT_MAX_IDLE = 4;
+const double		DEFAULT_IDLE_TIMEOUT = 5.0;
+
+std::string make_key_prefix(const std::string& normalizedPath) {
+	return normalizedPath + "|";
+}
+}
+
+namespace ds {
+
+namespace query {
+
+/* SQL-CONNECTION-POOL LEASE
+ ******************************************************************/
+SqlConnectionPool::Lease::Lease()
+	: mPool(nullptr)
+	, mGeneration(0)
+{
+}
+
+SqlConnectionPool::Lease::Lease(Lease&& o)
+	: mPool(o.mPool)
+	, mKey(std::move(o.mKey))
+	, mGeneration(o.mGeneration)
+	, mDb(std::move(o.mDb))
+{
+	o.mPool = nullptr;
+}
+
+SqlConnectionPool::Lease& SqlConnectionPool::Lease::operator=(Lease&& o)
+{
+	if (this != &o) {
+		release();
+		mPool = o.mPool;
+		mKey = std::move(o.mKey);
+		mGeneration = o.mGeneration;
+		mDb = std::move(o.mDb);
+		o.mPool = nullptr;
+	}
+	return *this;
+}
+
+SqlConnectionPool::Lease::~Lease()
+{
+	release();
+}
+
+void SqlConnectionPool::Lease::release()
+{
+	if (mPool && mDb) mPool->release(mKey, mGeneration, mDb);
+	mDb.reset();
+	mPool = nullptr;
+}
+
+/* SQL-CONNECTION-POOL
+ ******************************************************************/
+SqlConnectionPool& SqlConnectionPool::get()
+{
+	static SqlConnectionPool	POOL;
+	return POOL;
+}
+
+SqlConnectionPool::Slot::Slot()
+	: mGeneration(0)
+{
+}
+
+SqlConnectionPool::SqlConnectionPool()
+	: mMaxIdle(DEFAULT_MAX_IDLE)
+	, mIdleTimeout(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(DEFAULT_IDLE_TIMEOUT)))
+	, mMmapSize(0)
+	, mStopping(false)
+{
+}
+
+SqlConnectionPool::~SqlConnectionPool()
+{
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		mStopping = true;
+	}
+	mReaperCondition.notify_all();
+	if (mReaper.joinable()) mReaper.join();
+}
+
+SqlConnectionPool::Lease SqlConnectionPool::acquire(const std::string& database, const int flags, int* errorCode)
+{
+	if (errorCode) *errorCode = SQLITE_OK;
+
+	Lease						lease;
+	lease.mPool = this;
+	lease.mKey = make_key_prefix(ds::getNormalizedPath(database)) + std::to_string(flags);
+
+	Poco::Timestamp				modified;
+	int64_t						size = 0;
+	const bool					hasStats = getFileStats(database, modified, size);
+
+	// Anything found stale is closed outside the lock
+	std::vector<std::unique_ptr<SqlDatabase>>	stale;
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		Slot&					slot = mSlots[lease.mKey];
+		lease.mGeneration = slot.mGeneration;
+		while (!slot.mIdle.empty()) {
+			Idle&				idle = slot.mIdle.back();
+			if (hasStats && idle.mModified == modified && idle.mSize == size) {
+				lease.mDb = std::move(idle.mDb);
+				slot.mIdle.pop_back();
+				break;
+			}
+			stale.push_back(std::move(idle.mDb));
+			slot.mIdle.pop_back();
+		}
+	}
+	stale.clear();
+	if (lease.mDb) return lease;
+
+	int							err = SQLITE_OK;
+	std::unique_ptr<SqlDatabase>	db(new SqlDatabase(database, flags, &err));
+	if (errorCode) *errorCode = err;
+	if (err != SQLITE_OK || !db->isValid()) {
+		lease.mPool = nullptr;
+		return lease;
+	}
+	if ((flags & SQLITE_OPEN_READONLY) != 0) {
+		int64_t					mmapSize = 0;
+		{
+			std::lock_guard<std::mutex>	l(mMutex);
+			mmapSize = mMmapSize;
+		}
+		db->applyReadPragmas(mmapSize);
+	}
+
+	lease.mDb = std::move(db);
+	return lease;
+}
+
+void SqlConnectionPool::release(const std::string& key, const int generation, std::unique_ptr<SqlDatabase>& db)
+{
+	Idle						idle;
+	// A connection to a file that's gone can't be reused
+	if (!getFileStats(db->getFilename(), idle.mModified, idle.mSize)) return;
+	idle.mDb = std::move(db);
+
+	std::lock_guard<std::mutex>	l(mMutex);
+	Slot&						slot = mSlots[key];
+	if (slot.mGeneration != generation || slot.mIdle.size() >= mMaxIdle || mIdleTimeout <= Clock::duration::zero() || mStopping) {
+		// Let the lock go before closing
+		db = std::move(idle.mDb);
+		return;
+	}
+	idle.mExpires = Clock::now() + mIdleTimeout;
+	slot.mIdle.push_back(std::move(idle));
+
+	if (!mReaper.joinable()) {
+		mReaper = std::thread([this] { reaperThreadFn(); });
+	} else {
+		mReaperCondition.notify_one();
+	}
+}
+
+void SqlConnectionPool::reaperThreadFn()
+{
+	std::unique_lock<std::mutex>	l(mMutex);
+	while (!mStopping) {
+		// Idle connections are pushed on the back, so the oldest of each slot is at the front
+		std::vector<Idle>			expired;
+		const Clock::time_point		now = Clock::now();
+		Clock::time_point			next = Clock::time_point::max();
+		for (auto it = mSlots.begin(), end = mSlots.end(); it != end; ++it) {
+			auto&					idle = it->second.mIdle;
+			auto					keep = idle.begin();
+			while (keep != idle.end() && keep->mExpires <= now) {
+				expired.push_back(std::move(*keep));
+				++keep;
+			}
+			idle.erase(idle.begin(), keep);
+			if (!idle.empty() && idle.front().mExpires < next) next = idle.front().mExpires;
+		}
+
+		if (!expired.empty()) {
+			// Close outside the lock, then look again
+			l.unlock();
+			expired.clear();
+			l.lock();
+			continue;
+		}
+
+		if (next == Clock::time_point::max()) {
+			mReaperCondition.wait(l);
+		} else {
+			mReaperCondition.wait_until(l, next);
+		}
+	}
+}
+
+void SqlConnectionPool::closeConnections(const std::string& database)
+{
+	const std::string			prefix = make_key_prefix(ds::getNormalizedPath(database));
+	std::vector<Idle>			closing;
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		for (auto it = mSlots.begin(), end = mSlots.end(); it != end; ++it) {
+			if (it->first.compare(0, prefix.size(), prefix) != 0) continue;
+			++it->second.mGeneration;
+			for (auto& idle : it->second.mIdle) closing.push_back(std::move(idle));
+			it->second.mIdle.clear();
+		}
+	}
+}
+
+void SqlConnectionPool::closeAllConnections()
+{
+	std::vector<Idle>			closing;
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		for (auto it = mSlots.begin(), end = mSlots.end(); it != end; ++it) {
+			++it->second.mGeneration;
+			for (auto& idle : it->second.mIdle) closing.push_back(std::move(idle));
+			it->second.mIdle.clear();
+		}
+	}
+}
+
+void SqlConnectionPool::setIdleTimeout(const double seconds)
+{
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		mIdleTimeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds > 0.0 ? seconds : 0.0));
+		// Connections already idle keep the expiry they had
+	}
+	if (seconds <= 0.0) closeAllConnections();
+}
+
+void SqlConnectionPool::setMmapSize(const int64_t bytes)
+{
+	std::lock_guard<std::mutex>	l(mMutex);
+	mMmapSize = bytes > 0 ? bytes : 0;
+}
+
+void SqlConnectionPool::setMaxIdleConnections(const size_t maxIdle)
+{
+	std::vector<Idle>			closing;
+	{
+		std::lock_guard<std::mutex>	l(mMutex);
+		mMaxIdle = maxIdle;
+		for (auto it = mSlots.begin(), end = mSlots.end(); it != end; ++it) {
+			while (it->second.mIdle.size() > mMaxIdle) {
+				closing.push_back(std::move(it->second.mIdle.back()));
+				it->second.mIdle.pop_back();
+			}
+		}
+	}
+}
+
+bool SqlConnectionPool::getFileStats(const std::string& path, Poco::Timestamp& outModified, int64_t& outSize)
+{
+	try {
+		Poco::File				f(path);
+		outModified = f.getLastModified();
+		outSize = static_cast<int64_t>(f.getSize());
+		return true;
+	} catch (std::exception&) {
+	}
+	return false;
+}
+
+} // namespace query
+
+} // namespace ds
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef DS_QUERY_SQLCONNECTIONPOOL_H_
+#define DS_QUERY_SQLCONNECTIONPOOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <Poco/Timestamp.h>
+#include "ds/query/sql_database.h"
+
+namespace ds {
+
+namespace query {
+
+/**
+ * \class SqlConnectionPool
+ * \brief Keeps sqlite connections open between queries, keyed by database path and open flags.
+ *        A connection is leased to one thread at a time and returned when the lease goes away,
+ *        so each worker thread effectively reuses its own connection (and its prepared statements)
+ *        without any locking inside sqlite.
+ *        Idle connections are closed after a few seconds without use (see setIdleTimeout()), so
+ *        database files aren't held open while nothing is querying them. They're also dropped if
+ *        the file has been replaced (modified time or size changed underneath a read-only
+ *        connection), or when closeConnections() is called.
+ */
+class SqlConnectionPool
+{
+public:
+	class Lease
+	{
+	public:
+		Lease();
+		Lease(Lease&&);
+		Lease&				operator=(Lease&&);
+		~Lease();
+
+		SqlDatabase*		operator->() const { return mDb.get(); }
+		SqlDatabase*		get() const { return mDb.get(); }
+		explicit operator bool() const { return mDb != nullptr; }
+
+	private:
+		friend class SqlConnectionPool;
+		Lease(const Lease&) = delete;
+		Lease&				operator=(const Lease&) = delete;
+		void				release();
+
+		SqlConnectionPool*	mPool;
+		std::string			mKey;
+		int					mGeneration;
+		std::unique_ptr<SqlDatabase>
+							mDb;
+	};
+
+	static SqlConnectionPool&	get();
+
+	/// Answer an open connection for the database, reusing an idle one when possible.
+	/// Read-only connections have SqlDatabase::applyReadPragmas() applied, with the mmap size from setMmapSize().
+	/// errorCode is the sqlite error if a new connection couldn't be opened.
+	Lease					acquire(const std::string& database, const int flags, int* errorCode = nullptr);
+
+	/// Close every idle connection to the database. Connections that are leased out are closed when they
+	/// come back. Call this before replacing or deleting a database file, particularly on Windows, where
+	/// an open connection keeps the file locked.
+	void					closeConnections(const std::string& database);
+	void					closeAllConnections();
+
+	/// How many idle connections are kept per database and flags. Defaults to 4.
+	void					setMaxIdleConnections(const size_t);
+	/// How long an idle connection stays open. 0 closes every connection as soon as its lease ends,
+	/// as if there were no pool. Defaults to 5 seconds.
+	void					setIdleTimeout(const double seconds);
+	/// Bytes of the database file memory mapped by read-only connections opened from now on. Off (0) by
+	/// default: on Windows a mapped file can't be truncated or replaced until its connection closes.
+	void					setMmapSize(const int64_t bytes);
+
+private:
+	SqlConnectionPool();
+	~SqlConnectionPool();
+
+	typedef std::chrono::steady_clock	Clock;
+
+	struct Idle {
+		std::unique_ptr<SqlDatabase>	mDb;
+		Poco::Timestamp					mModified;
+		int64_t							mSize;
+		Clock::time_point				mExpires;
+	};
+	struct Slot {
+		Slot();
+		std::vector<Idle>				mIdle;
+		int								mGeneration;
+	};
+
+	void					release(const std::string& key, const int generation, std::unique_ptr<SqlDatabase>&);
+	static bool				getFileStats(const std::string& path, Poco::Timestamp& outModified, int64_t& outSize);
+	/// Closes idle connections as they expire. Started with the first idle connection, and sleeps while there are none.
+	void					reaperThreadFn();
+
+	std::mutex				mMutex;
+	std::unordered_map<std::string, Slot>
+							mSlots;
+	size_t					mMaxIdle;
+	Clock::duration			mIdleTimeout;
+	int64_t					mMmapSize;
+
+	std::thread				mReaper;
+	std::condition_variable	mReaperCondition;
+	bool					mStopping;
+};
+
+} // namespace query
+
+} // namespace ds
+
+#endif // DS_QUERY_SQLCONNECTIONPOOL_H_
@@ -101,15 +101,68 @@ wrong_number_args:
 	sqlite3_result_error(pCtx, "wrong number of arguments to function rank()", -1);
 }
 
+namespace {
+const size_t		DEFAULT_STATEMENT_CACHE_SIZE = 32;
+const std::string	READ_PRAGMAS = "PRAGMA temp_store=MEMORY; PRAGMA query_only=1;";
+}
+
 namespace ds {
 
 namespace query {
 
+/* SQL-PARAM
+ ******************************************************************/
+SqlParam::SqlParam()
+	: mType(NULL_TYPE)
+	, mInt(0)
+	, mDouble(0.0)
+{
+}
+
+SqlParam::SqlParam(const int v)
+	: mType(INT_TYPE)
+	, mInt(v)
+	, mDouble(0.0)
+{
+}
+
+SqlParam::SqlParam(const int64_t v)
+	: mType(INT_TYPE)
+	, mInt(v)
+	, mDouble(0.0)
+{
+}
+
+SqlParam::SqlParam(const double v)
+	: mType(DOUBLE_TYPE)
+	, mInt(0)
+	, mDouble(v)
+{
+}
+
+SqlParam::SqlParam(const std::string& v)
+	: mType(TEXT_TYPE)
+	, mInt(0)
+	, mDouble(0.0)
+	, mText(v)
+{
+}
+
+SqlParam::SqlParam(const char* v)
+	: mType(v ? TEXT_TYPE : NULL_TYPE)
+	, mInt(0)
+	, mDouble(0.0)
+	, mText(v ? v : "")
+{
+}
+
 /* SQL-DATABASE
  ******************************************************************/
 SqlDatabase::SqlDatabase(const std::string& sDB, int flags, int *errorCode)
 	: db(NULL)
 	, db_file(ds::getNormalizedPath(sDB))
+	, mFlags(flags)
+	, mMaxStatements(DEFAULT_STATEMENT_CACHE_SIZE)
 {
 	const int		result = sqlite3_open_v2(db_file.c_str(), &db, flags, 0);
 	if (errorCode) *errorCode = result;
@@ -122,6 +175,9 @@ SqlDatabase::SqlDatabase(const std::string& sDB, int flags, int *errorCode)
 		// Actually a fatal error but ...
 		// GN, much much later: I dunno how this is a fatal error. Maybe your app can run just fine without this particular database. Just sayin'
 		DS_LOG_ERROR("  SqlDatabase: Unable to access the database " << sDB << " (SQLite error " << result << ")." << std::endl);
+		// sqlite usually hands back a handle even on failure, which still needs closing
+		sqlite3_close(db);
+		db = NULL;
 		
 		// Why were we living with 10 seconds of sleep for so long?
 		// Leaving this here for future people to ponder their existence
@@ -131,11 +187,13 @@ SqlDatabase::SqlDatabase(const std::string& sDB, int flags, int *errorCode)
 
 SqlDatabase::~SqlDatabase()
 {
+	clearStatements();
 	sqlite3_close(db);
 }
 
 sqlite3_stmt* SqlDatabase::rawSelect(const std::string& rawSqlSelect)
 {
+	if (!db) return NULL;
 	sqlite3_stmt*		statement;
 	const int			err = sqlite3_prepare_v2(db, rawSqlSelect.c_str(), -1, &statement, 0);
 	if (err != SQLITE_OK) {
@@ -146,6 +204,83 @@ sqlite3_stmt* SqlDatabase::rawSelect(const std::string& rawSqlSelect)
 	return statement;
 }
 
+sqlite3_stmt* SqlDatabase::prepareCached(const std::string& sql)
+{
+	auto found = mStatementLookup.find(sql);
+	if (found != mStatementLookup.end()) {
+		mStatements.splice(mStatements.begin(), mStatements, found->second);
+		return found->second->second;
+	}
+
+	if (!db) return NULL;
+	sqlite3_stmt*		statement = rawSelect(sql);
+	if (!statement) return NULL;
+
+	mStatements.push_front(std::make_pair(sql, statement));
+	mStatementLookup[sql] = mStatements.begin();
+	while (mStatements.size() > mMaxStatements) {
+		sqlite3_finalize(mStatements.back().second);
+		mStatementLookup.erase(mStatements.back().first);
+		mStatements.pop_back();
+	}
+	return statement;
+}
+
+void SqlDatabase::setStatementCacheSize(const size_t size)
+{
+	mMaxStatements = size < 1 ? 1 : size;
+	while (mStatements.size() > mMaxStatements) {
+		sqlite3_finalize(mStatements.back().second);
+		mStatementLookup.erase(mStatements.back().first);
+		mStatements.pop_back();
+	}
+}
+
+void SqlDatabase::applyReadPragmas(const int64_t mmapSize)
+{
+	if (!db) return;
+	std::string			pragmas = READ_PRAGMAS;
+	// sqlite only maps as much of the file as exists
+	if (mmapSize > 0) pragmas += " PRAGMA mmap_size=" + std::to_string(mmapSize) + ";";
+	char*				errMsg = nullptr;
+	if (sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+		// Not fatal, the connection just runs without them
+		DS_LOG_WARNING("SqlDatabase::applyReadPragmas() " << db_file << " " << (errMsg ? errMsg : ""));
+	}
+	sqlite3_free(errMsg);
+}
+
+bool SqlDatabase::bind(sqlite3_stmt* statement, const std::vector<SqlParam>& params)
+{
+	if (!statement) return false;
+	sqlite3_clear_bindings(statement);
+
+	int					index = 1;
+	for (auto it = params.begin(), end = params.end(); it != end; ++it, ++index) {
+		int				err = SQLITE_OK;
+		if (it->mType == SqlParam::INT_TYPE) err = sqlite3_bind_int64(statement, index, it->mInt);
+		else if (it->mType == SqlParam::DOUBLE_TYPE) err = sqlite3_bind_double(statement, index, it->mDouble);
+		else if (it->mType == SqlParam::TEXT_TYPE) err = sqlite3_bind_text(statement, index, it->mText.c_str(), static_cast<int>(it->mText.size()), SQLITE_TRANSIENT);
+		else err = sqlite3_bind_null(statement, index);
+
+		if (err != SQLITE_OK) {
+			DS_LOG_ERROR("SqlDatabase::bind SQL error = " << err << " on param " << index << " of " << sqlite3_sql(statement));
+			sqlite3_clear_bindings(statement);
+			return false;
+		}
+	}
+	return true;
+}
+
+void SqlDatabase::clearStatements()
+{
+	for (auto it = mStatements.begin(), end = mStatements.end(); it != end; ++it) {
+		sqlite3_finalize(it->second);
+	}
+	mStatements.clear();
+	mStatementLookup.clear();
+}
+
 } // namespace query
 
 } // namespace ds
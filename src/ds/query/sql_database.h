@@ -2,13 +2,38 @@
 #ifndef DS_QUERY_SQLDATABASE_H_
 #define DS_QUERY_SQLDATABASE_H_
 
+#include <cstdint>
+#include <list>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 #include "ds/query/sqlite/sqlite3.h"
 
 namespace ds {
 
 namespace query {
 
+/**
+ * \class SqlParam
+ * \brief A value bound to a '?' in a prepared statement.
+ */
+struct SqlParam
+{
+	enum Type { NULL_TYPE, INT_TYPE, DOUBLE_TYPE, TEXT_TYPE };
+
+	SqlParam();
+	SqlParam(const int);
+	SqlParam(const int64_t);
+	SqlParam(const double);
+	SqlParam(const std::string&);
+	SqlParam(const char*);
+
+	Type					mType;
+	int64_t					mInt;
+	double					mDouble;
+	std::string				mText;
+};
+
 /**
  * \class SqlDatabase
  * \brief Handle an sqlite database connection.
@@ -19,14 +44,44 @@ public:
 	SqlDatabase(const std::string& sDB, int flags, int *errorCode);
 	~SqlDatabase();
 
+	bool					isValid() const { return db != nullptr; }
+	const std::string&		getFilename() const { return db_file; }
+	int						getFlags() const { return mFlags; }
+
 	/// Answer a hook to process a query results.  This could be
 	/// cleaner, it started off as a modification to the ofx stuff.
 	/// Client is responsible for finalizing the statement.
 	sqlite3_stmt*			rawSelect(const std::string& rawSqlSelect);
 
+	/// Answer a statement from the prepared statement cache, preparing it if needed.
+	/// The statement stays owned by the database: don't finalize it, reset it when you're done
+	/// (SqlResultBuilder does this when it isn't finalizing). Least recently used statements
+	/// are finalized once the cache is full.
+	sqlite3_stmt*			prepareCached(const std::string& sql);
+	void					setStatementCacheSize(const size_t);
+	size_t					getCachedStatementCount() const { return mStatements.size(); }
+
+	/// Set up a long-lived read-only connection: in-memory temp storage, query_only, and memory mapped
+	/// I/O of up to mmapSize bytes when that's over 0. A mapped file can't be truncated on Windows while
+	/// the connection is open. The journal mode is left alone, so WAL databases keep working with their writers.
+	void					applyReadPragmas(const int64_t mmapSize = 0);
+
+	/// Bind the params, in order, to the statement. On failure the bindings are cleared and false is answered.
+	static bool				bind(sqlite3_stmt*, const std::vector<SqlParam>&);
+
 private:
+	void					clearStatements();
+
 	sqlite3* db;
 	std::string db_file;
+	int						mFlags;
+
+	typedef std::list<std::pair<std::string, sqlite3_stmt*>> StatementList;
+	/// Most recently used first
+	StatementList			mStatements;
+	std::unordered_map<std::string, StatementList::iterator>
+							mStatementLookup;
+	size_t					mMaxStatements;
 };
 
 } // namespace query
@@ -13,17 +13,24 @@ namespace query {
 /**
  * \class SqlResultBuilder
  */
-SqlResultBuilder::SqlResultBuilder(Result& qr, sqlite3_stmt* stmt)
+SqlResultBuilder::SqlResultBuilder(Result& qr, sqlite3_stmt* stmt, const bool finalize)
 	: ResultBuilder(qr)
 	, mStatement(stmt)
 	, mStatementResult(SQLITE_ERROR)
+	, mFinalize(finalize)
 {
 	next();
 }
 
 SqlResultBuilder::~SqlResultBuilder()
 {
-	if (mStatement) sqlite3_finalize(mStatement);
+	if (!mStatement) return;
+	if (mFinalize) {
+		sqlite3_finalize(mStatement);
+	} else {
+		sqlite3_reset(mStatement);
+		sqlite3_clear_bindings(mStatement);
+	}
 }
 
 int SqlResultBuilder::getColumnCount() const
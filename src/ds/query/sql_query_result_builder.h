@@ -17,7 +17,9 @@ namespace query {
 class SqlResultBuilder : public ResultBuilder
 {
 public:
-	SqlResultBuilder(Result&, sqlite3_stmt* = nullptr);
+	/// By default the statement is finalized when the builder is done. Pass finalize false for statements
+	/// owned by someone else (i.e. SqlDatabase::prepareCached()), which are reset and unbound instead.
+	SqlResultBuilder(Result&, sqlite3_stmt* = nullptr, const bool finalize = true);
 	virtual ~SqlResultBuilder();
 
 	virtual int					getColumnCount() const;
@@ -31,6 +33,7 @@ public:
 private:
 	sqlite3_stmt*				mStatement;
 	int							mStatementResult;
+	const bool					mFinalize;
 	/// Reuse our string buffer
 	std::stringstream			mStrBuf;
 };
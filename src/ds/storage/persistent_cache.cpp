@@ -2,16 +2,24 @@
 
 #include "persistent_cache.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <Poco/File.h>
 #include <Poco/Path.h>
+#include <ds/debug/logger.h>
 #include <ds/query/query_client.h>
 #include <ds/query/query_result.h>
+#include <ds/query/sql_connection_pool.h>
 
 namespace ds {
 
 namespace {
 const std::string	EMPTY_SZ;
+// A row that fails this many times in a row is left in memory only
+const int			MAX_WRITE_ATTEMPTS = 3;
+// Waited before retrying, times the number of failures so far, so a locked or busy database gets a chance to recover
+const int			RETRY_DELAY_MS = 250;
 
 std::string			make_filename(const std::string& location) {
 	Poco::Path		p(Poco::Path::home());
@@ -23,6 +31,27 @@ std::string			make_filename(const std::string& location) {
 	return p.toString();
 }
 
+// Field names go into the SQL as identifiers, so quote them
+std::string			quote_name(const std::string& name) {
+	std::string		ans("\"");
+	for (auto it=name.begin(), end=name.end(); it!=end; ++it) {
+		if (*it == '"') ans.push_back('"');
+		ans.push_back(*it);
+	}
+	ans.push_back('"');
+	return ans;
+}
+
+// Run a statement that doesn't answer rows, leaving it ready for the next use
+bool				step_statement(sqlite3_stmt* stmt) {
+	if (!stmt) return false;
+	const int		err = sqlite3_step(stmt);
+	sqlite3_reset(stmt);
+	if (err == SQLITE_DONE || err == SQLITE_ROW) return true;
+	DS_LOG_WARNING("PersistentCache SQL error = " << err << " on " << sqlite3_sql(stmt));
+	return false;
+}
+
 } // anonymous namespace
 
 /**
@@ -30,9 +59,35 @@ std::string			make_filename(const std::string& location) {
  */
 PersistentCache::PersistentCache(const std::string& location, const int version, const FieldList& list)
 		: mFilename(make_filename(location))
-		, mFieldFormats(list) {
+		, mFieldFormats(list)
+		, mIndexes(list.mFields.size())
+		, mLastId(0)
+		, mWriting(false)
+		, mWriteFailed(false)
+		, mStopWriting(false) {
 	verifyDatabase(version, list);
 	loadDatabase(list);
+
+	std::stringstream		buf_1, buf_2;
+	buf_1 << "INSERT OR REPLACE INTO cache (id";
+	buf_2 << "?";
+	for (auto it=list.mFields.begin(), end=list.mFields.end(); it!=end; ++it) {
+		buf_1 << ", " << quote_name(it->mName);
+		buf_2 << ", ?";
+	}
+	buf_1 << ") VALUES (" << buf_2.str() << ")";
+	mWriteSql = buf_1.str();
+
+	mWriteThread = std::thread([this]{ writeThreadFn(); });
+}
+
+PersistentCache::~PersistentCache() {
+	{
+		std::unique_lock<std::mutex>	lock(mWriteMutex);
+		mStopWriting = true;
+	}
+	mWriteCondition.notify_all();
+	if (mWriteThread.joinable()) mWriteThread.join();
 }
 
 PersistentCache::Row PersistentCache::fetchOne(const std::string& field_name, const std::string& value) const {
@@ -47,99 +102,262 @@ PersistentCache::Row PersistentCache::fetchOne(const std::string& field_name, co
 	if (idx >= mFieldFormats.mFields.size()) return Row();
 
 	std::unique_lock<std::mutex>		lock(mMutex);
-	for (auto it=mRows.begin(), end=mRows.end(); it!=end; ++it) {
-		const Row&				r(*it);
-		if (r.mFields[idx].mString == value) return r;
+	if (mFieldFormats.mFields[idx].mType != FieldFormat::kString) {
+		for (auto it=mRows.begin(), end=mRows.end(); it!=end; ++it) {
+			const Row&				r(*it);
+			if (r.mFields[idx].mString == value) return r;
+		}
+		return Row();
+	}
+
+	// Several rows can share a value, the first one wins
+	const auto					range = mIndexes[idx].equal_range(value);
+	if (range.first == range.second) return Row();
+	size_t						first = range.first->second;
+	for (auto it=range.first; it!=range.second; ++it) {
+		if (it->second < first) first = it->second;
+	}
+	return mRows[first];
+}
+
+void PersistentCache::setValues(const Row& src) {
+	Row									row(src);
+	row.mFields.resize(mFieldFormats.mFields.size());
+
+	{
+		std::unique_lock<std::mutex>	lock(mMutex);
+		// UPDATE
+		if (row.mId > 0) {
+			const auto					found = mRowsById.find(row.mId);
+			if (found == mRowsById.end()) {
+				DS_LOG_WARNING("PersistentCache::setValues() no row with id " << row.mId);
+				return;
+			}
+			removeFromIndexes(found->second);
+			mRows[found->second] = row;
+			addToIndexes(found->second);
+
+		// CREATE
+		} else {
+			row.mId = ++mLastId;
+			mRowsById[row.mId] = mRows.size();
+			mRows.push_back(row);
+			addToIndexes(mRows.size() - 1);
+		}
 	}
-	return Row();
+
+	{
+		std::unique_lock<std::mutex>	lock(mWriteMutex);
+		const auto						found = mPendingById.find(row.mId);
+		if (found != mPendingById.end()) {
+			mPendingWrites[found->second].mRow = row;
+			mPendingWrites[found->second].mAttempts = 0;
+		} else {
+			PendingWrite				write;
+			write.mRow = row;
+			write.mAttempts = 0;
+			mPendingById[row.mId] = mPendingWrites.size();
+			mPendingWrites.push_back(write);
+		}
+	}
+	mWriteCondition.notify_all();
+}
+
+bool PersistentCache::flush() {
+	std::unique_lock<std::mutex>		lock(mWriteMutex);
+	mWriteCondition.wait(lock, [this]{ return mPendingWrites.empty() && !mWriting; });
+	const bool							written = !mWriteFailed;
+	mWriteFailed = false;
+	return written;
 }
 
-void PersistentCache::setValues(const Row& row) {
-	ds::query::Result					ans;
+void PersistentCache::addToIndexes(const size_t rowIndex) {
+	const Row&					row(mRows[rowIndex]);
+	for (size_t k=0; k<mFieldFormats.mFields.size(); ++k) {
+		if (mFieldFormats.mFields[k].mType != FieldFormat::kString) continue;
+		mIndexes[k].insert(std::make_pair(row.mFields[k].mString, rowIndex));
+	}
+}
 
-	// UPDATE
-	if (row.mId > 0) {
-		std::stringstream				buf;
-		buf << "UPDATE cache SET ";
-		for (size_t k=0; k<mFieldFormats.mFields.size(); ++k) {
-			const FieldFormat::Type		type(mFieldFormats.mFields[k].mType);
-			if (k != 0) buf << ", ";
-			buf << mFieldFormats.mFields[k].mName << "=";
-			if (type == FieldFormat::kFloat) {
-				buf << row.getFloat(k);
-			} else if (type == FieldFormat::kInt) {
-				buf << row.getInt(k);
-			} else if (type == FieldFormat::kString) {
-				buf << "'" << row.getString(k) << "'";
+void PersistentCache::removeFromIndexes(const size_t rowIndex) {
+	const Row&					row(mRows[rowIndex]);
+	for (size_t k=0; k<mFieldFormats.mFields.size(); ++k) {
+		if (mFieldFormats.mFields[k].mType != FieldFormat::kString) continue;
+		auto					range = mIndexes[k].equal_range(row.mFields[k].mString);
+		for (auto it=range.first; it!=range.second; ++it) {
+			if (it->second == rowIndex) {
+				mIndexes[k].erase(it);
+				break;
 			}
 		}
-		buf << " WHERE id=" << row.mId;
-		ds::query::Client::queryWrite(mFilename, buf.str(), ans);
+	}
+}
 
-	// CREATE
-	} else {
-		std::stringstream		buf_1, buf_2;
-		buf_1 << "INSERT INTO cache (";
-		for (size_t k=0; k<mFieldFormats.mFields.size(); ++k) {
-			const FieldFormat::Type		type(mFieldFormats.mFields[k].mType);
-			if (k != 0) {
-				buf_1 << ", ";
-				buf_2 << ", ";
+void PersistentCache::writeThreadFn() {
+	std::unique_lock<std::mutex>		lock(mWriteMutex);
+	while (true) {
+		mWriteCondition.wait(lock, [this]{ return mStopWriting || !mPendingWrites.empty(); });
+		if (mPendingWrites.empty()) break;
+
+		// Anything set while these are written goes in the next batch
+		std::vector<PendingWrite>		writes;
+		writes.swap(mPendingWrites);
+		mPendingById.clear();
+		mWriting = true;
+
+		lock.unlock();
+		std::vector<size_t>				failed;
+		writeRows(writes, failed);
+		lock.lock();
+
+		int								retryDelayMs = 0;
+		for (auto it=failed.begin(), end=failed.end(); it!=end; ++it) {
+			PendingWrite&				write(writes[*it]);
+			// A newer copy was set while this one was being written, and that's what should go to disk
+			if (mPendingById.find(write.mRow.mId) != mPendingById.end()) continue;
+
+			if (++write.mAttempts >= MAX_WRITE_ATTEMPTS) {
+				DS_LOG_WARNING("PersistentCache gave up writing row " << write.mRow.mId << " to " << mFilename << " after " << write.mAttempts << " attempts, it's only in memory");
+				mWriteFailed = true;
+				continue;
 			}
-			buf_1 << mFieldFormats.mFields[k].mName;
+			retryDelayMs = std::max(retryDelayMs, RETRY_DELAY_MS * write.mAttempts);
+			mPendingById[write.mRow.mId] = mPendingWrites.size();
+			mPendingWrites.push_back(write);
+		}
+
+		if (retryDelayMs > 0) {
+			// Still counts as writing, so flush() waits for the retries. Stopping cuts the wait short.
+			mWriteCondition.wait_for(lock, std::chrono::milliseconds(retryDelayMs), [this]{ return mStopWriting; });
+		}
+		mWriting = false;
+		mWriteCondition.notify_all();
+	}
+}
+
+void PersistentCache::writeRows(const std::vector<PendingWrite>& writes, std::vector<size_t>& outFailed) {
+	auto									allFailed = [&writes, &outFailed]() {
+		outFailed.clear();
+		for (size_t k=0; k<writes.size(); ++k) outFailed.push_back(k);
+	};
+
+	ds::query::SqlConnectionPool::Lease		db(ds::query::SqlConnectionPool::get().acquire(mFilename, SQLITE_OPEN_READWRITE));
+	if (!db) {
+		DS_LOG_WARNING("PersistentCache::writeRows() couldn't open " << mFilename << ", " << writes.size() << " rows not written");
+		allFailed();
+		return;
+	}
+
+	const bool								inTransaction = step_statement(db->prepareCached("BEGIN"));
+	std::vector<ds::query::SqlParam>		params;
+	for (size_t w=0; w<writes.size(); ++w) {
+		const Row&							row(writes[w].mRow);
+		params.clear();
+		params.push_back(ds::query::SqlParam(row.mId));
+		for (size_t k=0; k<mFieldFormats.mFields.size(); ++k) {
+			const FieldFormat::Type			type(mFieldFormats.mFields[k].mType);
 			if (type == FieldFormat::kFloat) {
-				buf_2 << row.getFloat(k);
+				params.push_back(ds::query::SqlParam(row.getFloat(k)));
 			} else if (type == FieldFormat::kInt) {
-				buf_2 << row.getInt(k);
-			} else if (type == FieldFormat::kString) {
-				buf_2 << "'" << row.getString(k) << "'";
+				params.push_back(ds::query::SqlParam(row.getInt(k)));
+			} else {
+				params.push_back(ds::query::SqlParam(row.getString(k)));
 			}
 		}
-		buf_1 << ") values (" << buf_2.str() << ")";
-		ds::query::Client::queryWrite(mFilename, buf_1.str(), ans);
-	}
 
-	// sync
-	std::unique_lock<std::mutex>		lock(mMutex);
-	loadDatabase(mFieldFormats);
+		sqlite3_stmt*						stmt = db->prepareCached(mWriteSql);
+		if (!ds::query::SqlDatabase::bind(stmt, params)) {
+			DS_LOG_WARNING("PersistentCache::writeRows() couldn't bind row " << row.mId << " in " << mFilename << ", not written");
+			outFailed.push_back(w);
+		} else if (!step_statement(stmt)) {
+			outFailed.push_back(w);
+		}
+	}
+	if (inTransaction && !step_statement(db->prepareCached("COMMIT"))) {
+		// Don't leave the pooled connection stuck in a transaction
+		step_statement(db->prepareCached("ROLLBACK"));
+		DS_LOG_WARNING("PersistentCache::writeRows() couldn't commit to " << mFilename << ", " << writes.size() << " rows not written");
+		allFailed();
+		return;
+	}
+	if (!outFailed.empty()) {
+		DS_LOG_WARNING("PersistentCache::writeRows() " << outFailed.size() << " of " << writes.size() << " rows not written to " << mFilename);
+	}
 }
 
 void PersistentCache::verifyDatabase(const int version, const FieldList& list) {
 	if (mFilename.empty()) return;
 
+	for (auto it=list.mFields.begin(), end=list.mFields.end(); it!=end; ++it) {
+		if (it->mName.empty()) throw std::runtime_error("PersistentCache::verifyDatabase() empty field name");
+	}
+
 	Poco::File			f(mFilename);
-	// XXX Check for version number
-	if (f.exists()) return;
+	if (f.exists()) {
+		// Older caches didn't store a version (it reads as 0), so they're kept if their columns still match
+		ds::query::Result			versionAns;
+		ds::query::Client::query(mFilename, "PRAGMA user_version", versionAns);
+		ds::query::Result::RowIterator	versionIt(versionAns);
+		const int					storedVersion = versionIt.hasValue() ? versionIt.getInt(0) : 0;
+
+		std::vector<std::string>	columns;
+		ds::query::Result			columnAns;
+		ds::query::Client::query(mFilename, "PRAGMA table_info(cache)", columnAns);
+		for (ds::query::Result::RowIterator it(columnAns); it.hasValue(); ++it) {
+			columns.push_back(it.getString(1));
+		}
 
-	f.createFile();
+		bool						matches = (storedVersion == 0 || storedVersion == version) && columns.size() == list.mFields.size() + 1;
+		for (size_t k=0; matches && k<list.mFields.size(); ++k) {
+			matches = (columns[k+1] == list.mFields[k].mName);
+		}
+
+		ds::query::Result			r;
+		if (matches) {
+			if (storedVersion != version) {
+				ds::query::Client::queryWrite(mFilename, "PRAGMA user_version=" + std::to_string(version), r);
+			}
+			return;
+		}
+
+		DS_LOG_INFO("PersistentCache::verifyDatabase() " << mFilename << " is version " << storedVersion << ", expected " << version << ", recreating");
+		ds::query::Client::queryWrite(mFilename, "DROP TABLE IF EXISTS cache", r);
+		// The read connections would otherwise keep the old schema
+		ds::query::Client::closeConnections(mFilename);
+	} else {
+		f.createFile();
+	}
 
 	std::stringstream	buf;
 	buf << "CREATE TABLE cache(id INTEGER PRIMARY KEY AUTOINCREMENT";
 	for (auto it=list.mFields.begin(), end=list.mFields.end(); it!=end; ++it) {
-		if (it->mName.empty()) throw std::runtime_error("PersistentCache::verifyDatabase() empty field name");
 		if (it->mType == it->kFloat) {
-			buf << ", " << it->mName << " DOUBLE NOT NULL DEFAULT '0'";
+			buf << ", " << quote_name(it->mName) << " DOUBLE NOT NULL DEFAULT '0'";
 		} else if (it->mType == it->kInt) {
-			buf << ", " << it->mName << " INT NOT NULL DEFAULT '0'";
+			buf << ", " << quote_name(it->mName) << " INT NOT NULL DEFAULT '0'";
 		} else if (it->mType == it->kString) {
-			buf << ", " << it->mName << " TEXT NOT NULL DEFAULT ''";
+			buf << ", " << quote_name(it->mName) << " TEXT NOT NULL DEFAULT ''";
 		}
 	}
 	buf << ");";
 	ds::query::Result	r;
 	ds::query::Client::queryWrite(mFilename, buf.str(), r);
+	ds::query::Client::queryWrite(mFilename, "PRAGMA user_version=" + std::to_string(version), r);
 }
 
 void PersistentCache::loadDatabase(const FieldList& list) {
 	mRows.clear();
+	mRowsById.clear();
+	for (auto it=mIndexes.begin(), end=mIndexes.end(); it!=end; ++it) it->clear();
+	mLastId = 0;
 
 	std::stringstream				buf;
 	buf << "SELECT id";
 	for (auto it=list.mFields.begin(), end=list.mFields.end(); it!=end; ++it) {
 		if (it->mName.empty()) throw std::runtime_error("PersistentCache::loadDatabase() empty field name");
-		buf << "," << it->mName;
+		buf << "," << quote_name(it->mName);
 	}
-	buf << " FROM cache";
+	buf << " FROM cache ORDER BY id";
 
 	ds::query::Result				ans;
 	ds::query::Client::query(mFilename, buf.str(), ans);
@@ -153,11 +371,14 @@ void PersistentCache::loadDatabase(const FieldList& list) {
 			if (fmt.mType == fmt.kFloat) {
 				row.mFields.push_back(Field(it.getFloat(k+1), 0, ""));
 			} else if (fmt.mType == fmt.kInt) {
-				row.mFields.push_back(Field(0.0, it.getInt(k+1), ""));
+				row.mFields.push_back(Field(0.0, it.getInt64(k+1), ""));
 			} else if (fmt.mType == fmt.kString) {
 				row.mFields.push_back(Field(0.0, 0, it.getString(k+1)));
 			}
 		}
+		mRowsById[row.mId] = mRows.size() - 1;
+		addToIndexes(mRows.size() - 1);
+		if (row.mId > mLastId) mLastId = row.mId;
 		++it;
 	}
 }
@@ -186,7 +407,9 @@ PersistentCache::FieldList& PersistentCache::FieldList::addString(const std::str
 /**
  * \class Field
  */
-PersistentCache::Field::Field() {
+PersistentCache::Field::Field()
+		: mFloat(0.0)
+		, mInt(0) {
 }
 
 PersistentCache::Field::Field(const double v1, const int64_t v2, const std::string& v3)
@@ -227,7 +450,7 @@ PersistentCache::Row& PersistentCache::Row::addFloat(const double v) {
 }
 
 PersistentCache::Row& PersistentCache::Row::addInt(const int64_t v) {
-	mFields.push_back(Field(0.0, v, 0));
+	mFields.push_back(Field(0.0, v, ""));
 	return *this;
 }
 
@@ -2,7 +2,9 @@
 #ifndef DS_STORAGE_PERSISTENTCACHE_H_
 #define DS_STORAGE_PERSISTENTCACHE_H_
 
+#include <condition_variable>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <cinder/Thread.h>
 
@@ -12,6 +14,9 @@ namespace ds {
  * \class PersistentCache
  * \brief Abstract persistent storage. Define a data format, then add and query.
  * I am thread safe (meaning I block on all calls).
+ * Rows are kept in memory, and writes go to the database on a background thread,
+ * batched into one transaction for however many piled up while the last batch was written.
+ * Rows that fail to write are retried a few times, after a short wait, before they're given up on.
  */
 class PersistentCache {
 public:
@@ -38,18 +43,35 @@ public:
 
 	/// Location will be relative to user/documents/downstream/cache. Location
 	/// should be a folder -- the file will be named and generated.
-	/// Version is currently unused, but maintain it for the future.
+	/// Version is stored in the database. If an existing database has a different version,
+	/// or its columns don't match the field list, it's cleared and recreated.
 	/// For convenience you can use field list like this: PersistentCache::FieldList().addString("query")
 	PersistentCache(const std::string& location, const int version, const FieldList&);
+	/// Finishes any pending writes
+	~PersistentCache();
 
+	/// Answers the first row where the field has the value. String fields are looked up in a hash index.
 	Row								fetchOne(const std::string& field_name, const std::string& value) const;
 	/// If the row has an ID, this is an update operation, otherwise this is a create.
+	/// The change is visible to fetchOne() right away, and written to disk in the background.
 	void							setValues(const Row&);
+	/// Blocks until everything passed to setValues() has been written, or given up on after its retries.
+	/// Answers false if any row was given up on since the last flush(). That's logged, and the rows stay in memory.
+	bool							flush();
 
 private:
 	void							verifyDatabase(const int version, const FieldList& list);
 	void							loadDatabase(const FieldList& list);
 
+	/// Index or un-index the string fields of the row at this position in mRows
+	void							addToIndexes(const size_t rowIndex);
+	void							removeFromIndexes(const size_t rowIndex);
+
+	struct PendingWrite;
+	void							writeThreadFn();
+	/// Fills in the positions of any writes that didn't make it to disk
+	void							writeRows(const std::vector<PendingWrite>&, std::vector<size_t>& outFailed);
+
 	PersistentCache();
 	PersistentCache(const PersistentCache&);
 
@@ -85,9 +107,36 @@ public:
 	};
 
 private:
+	struct PendingWrite {
+		Row							mRow;
+		/// Failed writes so far
+		int							mAttempts;
+	};
+
 	const FieldList					mFieldFormats;
+	/// INSERT OR REPLACE for every column, ids included, so one statement covers creates and updates
+	std::string						mWriteSql;
+
 	mutable std::mutex				mMutex;
 	std::vector<Row>				mRows;
+	/// Row id to position in mRows
+	std::unordered_map<int, size_t>	mRowsById;
+	/// One per field, only filled in for string fields: value to positions in mRows
+	std::vector<std::unordered_multimap<std::string, size_t>>
+									mIndexes;
+	/// New rows get ids above this, so they're known before they're written
+	int								mLastId;
+
+	/// Written by the write thread. Multiple changes to the same row before a write only keep the last
+	std::mutex						mWriteMutex;
+	std::condition_variable			mWriteCondition;
+	std::vector<PendingWrite>		mPendingWrites;
+	std::unordered_map<int, size_t>	mPendingById;
+	bool							mWriting;
+	/// A row was given up on since the last flush()
+	bool							mWriteFailed;
+	bool							mStopWriting;
+	std::thread						mWriteThread;
 };
 
 } // namespace ds
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include "ds/debug/frame_profiler.h"
 #include "ds/thread/work_client.h"
 
 using namespace ds;
@@ -206,6 +207,7 @@ void WorkManager::Loop::handleInput(std::unique_ptr<WorkRequest>& upR) const
 	WorkRequest*			r = upR.get();
 	if (!r) return;
 
+	DS_PROFILE_OBJECT_SCOPE(r, "work request");
 	r->run();
 
   mManager.addOutput(upR);
@@ -12,6 +12,12 @@
 namespace ds {
 namespace ui {
 
+namespace {
+// Counts outermost runLayout() calls, so nested layouts only check their descendants once per pass
+uint64_t	LAYOUT_PASS = 0;
+int			LAYOUT_DEPTH = 0;
+}
+
 LayoutSprite::LayoutSprite(ds::ui::SpriteEngine& engine)
 	: ds::ui::Sprite(engine)
 	, mLayoutType(kLayoutVFlow)
@@ -20,11 +26,18 @@ LayoutSprite::LayoutSprite(ds::ui::SpriteEngine& engine)
 	, mOverallAlign(0)
 	, mLayoutUpdatedFunction(nullptr)
 	, mSkipHiddenChildren(false)
+	, mLayoutValid(false)
+	, mLayoutPending(false)
+	, mCheckedPass(0)
+	, mDescendantsNeedLayout(false)
 {
 
 }
 
 void LayoutSprite::runLayout(){
+	mLayoutPending = false;
+	if(LAYOUT_DEPTH++ == 0) ++LAYOUT_PASS;
+
 	if(mLayoutType == kLayoutNone){
 		runNoneLayout();
 	} else if(mLayoutType == kLayoutVFlow){
@@ -39,13 +52,95 @@ void LayoutSprite::runLayout(){
 		runFlowLayout(false, true);
 	}
 
+	// Remember what everything looked like, so the next run can be skipped if none of it changes.
+	// This is done before the callback, so anything the callback moves counts as a change
+	mMeasuredSize = ci::vec2(getWidth(), getHeight());
+	mMeasuredChildren.clear();
+	mMeasuredChildren.reserve(mChildren.size());
+	for(auto chillin : mChildren){
+		mMeasuredChildren.push_back(ChildMeasure(chillin));
+	}
+	mLayoutValid = true;
+	// The nested layouts were just run or found to be up to date
+	mCheckedPass = LAYOUT_PASS;
+	mDescendantsNeedLayout = false;
+	--LAYOUT_DEPTH;
+
+	onLayoutUpdate();
+}
+
+void LayoutSprite::invalidateLayout(){
+	mLayoutValid = false;
+
+	// Layouts this is nested in can't skip it when they next run, but they only run when they're asked to
+	for(auto parent = getParent(); parent; parent = parent->getParent()){
+		LayoutSprite* ls = dynamic_cast<LayoutSprite*>(parent);
+		if(!ls) break;
+		ls->mLayoutValid = false;
+	}
+
+	mLayoutPending = true;
+	requestUpdate();
+}
+
+bool LayoutSprite::needsLayout(){
+	if(!mLayoutValid) return true;
+	if(mMeasuredSize.x != getWidth() || mMeasuredSize.y != getHeight()) return true;
+	if(mMeasuredChildren.size() != mChildren.size()) return true;
+
+	for(size_t i = 0; i < mChildren.size(); ++i){
+		if(!(mMeasuredChildren[i] == ChildMeasure(mChildren[i]))) return true;
+	}
+
+	// During a pass a layout only changes its own children before running them, so what's below those
+	// can't change between checks, and is only looked at once. A layout updated function that changes
+	// some other layout mid-pass calls invalidateLayout() on it, which the checks above catch
+	if(LAYOUT_DEPTH > 0 && mCheckedPass == LAYOUT_PASS) return mDescendantsNeedLayout;
+
+	mDescendantsNeedLayout = false;
+	for(auto chillin : mChildren){
+		LayoutSprite* ls = dynamic_cast<LayoutSprite*>(chillin);
+		if(ls && ls->needsLayout()){
+			mDescendantsNeedLayout = true;
+			break;
+		}
+	}
+	mCheckedPass = LAYOUT_PASS;
+
+	return mDescendantsNeedLayout;
+}
+
+void LayoutSprite::runChildLayout(LayoutSprite* child){
+	if(!child) return;
+
+	if(child->needsLayout()){
+		child->runLayout();
+	} else {
+		// Nothing changed, but apps still expect to hear about every pass
+		child->onLayoutSkipped();
+	}
+}
+
+void LayoutSprite::onLayoutSkipped(){
+	for(auto chillin : mChildren){
+		if(mSkipHiddenChildren && !chillin->visible()) continue;
+		if(auto ls = dynamic_cast<LayoutSprite*>(chillin)){
+			ls->onLayoutSkipped();
+		}
+	}
 	onLayoutUpdate();
 }
 
+void LayoutSprite::onUpdateServer(const ds::UpdateParams& p){
+	if(mLayoutPending){
+		runLayout();
+	}
+}
+
 void LayoutSprite::runNoneLayout(){
 	for(auto chillin : mChildren){
 		if(auto layoutSprite = dynamic_cast<LayoutSprite*>(chillin)){
-			layoutSprite->runLayout();
+			runChildLayout(layoutSprite);
 		}
 	}
 }
@@ -87,8 +182,8 @@ void LayoutSprite::runSizeLayout(){
 				fitInside(chillin, ci::Rectf(0.0f, 0.0f, fixedW, fixedH), chillin->mLayoutUserType != kStretchSize);
 				chillin->setPosition(prePos);
 			} else if(ls){
+				// the layout itself is run once, below
 				ls->setSize(fixedW, fixedH);
-				ls->runLayout();
 			} else {
 				chillin->setSize(fixedW, fixedH);
 			}
@@ -96,7 +191,7 @@ void LayoutSprite::runSizeLayout(){
 
 
 		if(auto ls = dynamic_cast<LayoutSprite*>(chillin)){
-			ls->runLayout();
+			runChildLayout(ls);
 		}
 	}
 
@@ -173,7 +268,7 @@ void LayoutSprite::runFlowLayout(const bool vertical, const bool wrap /* = false
 
 				// run layouts in case they change their size
 				if(ls){
-					ls->runLayout();
+					runChildLayout(ls);
 				}
 
 				// figure out how big this layout is going to be
@@ -251,7 +346,7 @@ void LayoutSprite::runFlowLayout(const bool vertical, const bool wrap /* = false
 				fitInside(chillin, ci::Rectf(0.0f, 0.0f, stretchW, stretchH), true);
 			} else if(ls){
 				ls->setSize(stretchW, stretchH);
-				ls->runLayout();
+				runChildLayout(ls);
 			} else {
 				chillin->setSize(stretchW, stretchH);
 			}
@@ -352,7 +447,7 @@ void LayoutSprite::runFlowLayout(const bool vertical, const bool wrap /* = false
 					fitInside(chillin, ci::Rectf(0.0f, 0.0f, fixedW, fixedH), false);
 				} else if(ls){
 					ls->setSize(fixedW, fixedH);
-					ls->runLayout();
+					runChildLayout(ls);
 				} else {
 					chillin->setSize(fixedW, fixedH);
 				}
@@ -370,6 +465,34 @@ void LayoutSprite::runFlowLayout(const bool vertical, const bool wrap /* = false
 	}
 }
 
+LayoutSprite::ChildMeasure::ChildMeasure(ds::ui::Sprite* sp)
+	: mSprite(sp)
+	, mVisible(sp->visible())
+	, mSize(sp->getWidth(), sp->getHeight(), sp->getDepth())
+	, mScale(sp->getScale())
+	, mPosition(sp->getPosition())
+	, mCenter(sp->getCenter())
+	, mTPad(sp->mLayoutTPad)
+	, mBPad(sp->mLayoutBPad)
+	, mLPad(sp->mLayoutLPad)
+	, mRPad(sp->mLayoutRPad)
+	, mLayoutSize(sp->mLayoutSize)
+	, mFudge(sp->mLayoutFudge)
+	, mHAlign(sp->mLayoutHAlign)
+	, mVAlign(sp->mLayoutVAlign)
+	, mUserType(sp->mLayoutUserType)
+	, mFixedAspect(sp->mLayoutFixedAspect)
+{
+}
+
+bool LayoutSprite::ChildMeasure::operator==(const ChildMeasure& o) const {
+	return mSprite == o.mSprite && mVisible == o.mVisible && mSize == o.mSize && mScale == o.mScale
+		&& mPosition == o.mPosition && mCenter == o.mCenter
+		&& mTPad == o.mTPad && mBPad == o.mBPad && mLPad == o.mLPad && mRPad == o.mRPad
+		&& mLayoutSize == o.mLayoutSize && mFudge == o.mFudge && mHAlign == o.mHAlign && mVAlign == o.mVAlign
+		&& mUserType == o.mUserType && mFixedAspect == o.mFixedAspect;
+}
+
 void LayoutSprite::onLayoutUpdate(){
 	if(mLayoutUpdatedFunction){
 		mLayoutUpdatedFunction();
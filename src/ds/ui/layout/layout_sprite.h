@@ -39,10 +39,20 @@ public:
 	/// Fits the sprite supplied into the target area
 	static void				fitInside(ds::ui::Sprite* sp, const ci::Rectf area, const bool letterbox);
 
+	/// Runs the layout right away. Nested layouts are only run if needsLayout() says they have to be.
 	void					runLayout();
 
+	/// Runs the layout once in the next server update, no matter how many times this is called before then.
+	/// Layouts this one is nested in won't skip it the next time they run, but aren't run by this.
+	void					invalidateLayout();
+
+	/// True if anything this layout uses changed since it last ran: its own size or settings, or the size, scale, position,
+	/// visibility or layout settings of a child, or a nested layout needs to run.
+	/// Nested layouts are only checked once during a runLayout() pass.
+	bool					needsLayout();
+
 	const LayoutType&		getLayoutType(){ return mLayoutType; }
-	void					setLayoutType(const LayoutType& typey){ mLayoutType = typey; }
+	void					setLayoutType(const LayoutType& typey){ mLayoutType = typey; mLayoutValid = false; }
 
 	void					setLayoutUpdatedFunction(const std::function<void()> layoutUpdatedFunction);
 	void					onLayoutUpdate();
@@ -50,11 +60,11 @@ public:
 	/// Returns the spacing between each element in the layout (use padding on each element to do add specific spacing)
 	float					getSpacing(){ return mSpacing; }
 	/// Sets the spacing between each element in the layout (use padding on each element to do add specific spacing)
-	void					setSpacing(const float spacing){ mSpacing = spacing; }
+	void					setSpacing(const float spacing){ mSpacing = spacing; mLayoutValid = false; }
 
 	/// For V or H flow layouts, sets the overall alignment for the children. 
 	/// Generally only has an effect for sizeType = kFixedSize, kStretchSize or fill; layoutType = kLayoutVFlow or kLayoutHFlow; and there are no stretch children
-	void					setOverallAlignment(const int align){ mOverallAlign = align; }
+	void					setOverallAlignment(const int align){ mOverallAlign = align; mLayoutValid = false; }
 	int						getOverallAlignment(){ return mOverallAlign; }
 
 	/**determines how the sprite adjusts to it's children. 
@@ -63,11 +73,11 @@ public:
 		3. height: Adjusts the height of this sprite to it's children (for vertical, the total height of the children, for horiz, the tallest child)
 		4. both: Both width and height*/
 	const ShrinkType&		getShrinkToChildren() { return mShrinkToChildren; }
-	void					setShrinkToChildren(const ShrinkType& shrink) { mShrinkToChildren = shrink; }
+	void					setShrinkToChildren(const ShrinkType& shrink) { mShrinkToChildren = shrink; mLayoutValid = false; }
 
 	/// If a child is hidden (hide() not setTransparent(false)) will be completely ignored in layouts. Default = false
 	const bool				getSkipHiddenChildren() { return mSkipHiddenChildren; }
-	void					setSkipHiddenChildren(const bool skipHidden) { mSkipHiddenChildren = skipHidden; }
+	void					setSkipHiddenChildren(const bool skipHidden) { mSkipHiddenChildren = skipHidden; mLayoutValid = false; }
 
 	/// Helper functions for constructing xml sheets for layouts
 	static std::string		getLayoutSizeModeString(const int sizeMode);
@@ -85,6 +95,12 @@ protected:
 	/// virtual in case you want to override with your own layout jimmies.
 	virtual void			runFlowLayout(const bool vertical, const bool wrap = false);
 
+	/// Runs a nested layout, unless nothing it uses has changed since it last ran.
+	/// A skipped layout, and every layout nested in it, still calls its layout updated function.
+	void					runChildLayout(LayoutSprite* child);
+
+	virtual void			onUpdateServer(const ds::UpdateParams& p) override;
+
 	std::function<void()>	mLayoutUpdatedFunction;
 
 	float					mSpacing;
@@ -93,6 +109,40 @@ protected:
 	ShrinkType				mShrinkToChildren;
 	bool					mSkipHiddenChildren;
 
+private:
+	/// Calls the layout updated functions a run would have, innermost first, without running anything
+	void					onLayoutSkipped();
+
+	/// What a child looked like when the layout last finished, to tell if it's changed since
+	struct ChildMeasure {
+		ChildMeasure(ds::ui::Sprite* sp);
+		bool				operator==(const ChildMeasure& o) const;
+
+		ds::ui::Sprite*		mSprite;
+		bool				mVisible;
+		ci::vec3			mSize;
+		ci::vec3			mScale;
+		ci::vec3			mPosition;
+		ci::vec3			mCenter;
+		float				mTPad, mBPad, mLPad, mRPad;
+		ci::vec2			mLayoutSize;
+		ci::vec3			mFudge;
+		int					mHAlign;
+		int					mVAlign;
+		int					mUserType;
+		bool				mFixedAspect;
+	};
+
+	/// False when a setting changed or invalidateLayout() was called since the last run
+	bool					mLayoutValid;
+	/// invalidateLayout() was called and the layout hasn't run since
+	bool					mLayoutPending;
+	ci::vec2				mMeasuredSize;
+	std::vector<ChildMeasure>	mMeasuredChildren;
+	/// Whether a nested layout needed to run, as of the layout pass in mCheckedPass
+	uint64_t				mCheckedPass;
+	bool					mDescendantsNeedLayout;
+
 };
 
 } // namespace ui
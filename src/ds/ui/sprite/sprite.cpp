@@ -10,9 +10,11 @@
 #include "ds/data/data_buffer.h"
 #include "ds/debug/logger.h"
 #include "ds/debug/debug_defines.h"
+#include "ds/debug/frame_profiler.h"
 #include "ds/math/math_defs.h"
 #include "ds/math/math_func.h"
 #include "ds/ui/sprite/sprite_engine.h"
+#include "ds/ui/tween/batch_tweener.h"
 #include "ds/ui/tween/tweenline.h"
 #include "ds/util/string_util.h"
 #include "util/clip_plane.h"
@@ -152,6 +154,12 @@ void Sprite::init(const ds::sprite_id_t id) {
 	mColor = ci::Color(1.0f, 1.0f, 1.0f);
 	mMultiTouchEnabled = false;
 	mCheckBounds = false;
+	mScheduledUpdates = false;
+	mInScheduledSubtree = false;
+	mNeedsUpdate = false;
+	mUpdateRequested = false;
+	mUpdateListed = false;
+	mUpdateListIndex = 0;
 	mBoundsNeedChecking = true;
 	mInBounds = true;
 	mDragDestination = nullptr;
@@ -203,6 +211,11 @@ Sprite::~Sprite() {
 	animStop();
 	cancelDelayedCall();
 
+	if(mUpdateListed) {
+		mEngine.removeFromUpdateList(this);
+		mUpdateListed = false;
+	}
+
 	mEngine.removeFromDragDestinationList(this);
 
 	// We only want to request a delete for the sprite at the head of a tree,
@@ -225,20 +238,25 @@ Sprite::~Sprite() {
 }
 
 void Sprite::updateClient(const UpdateParams &p) {
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite update");
 	mIdleTimer.update();
 
 	if(mCheckBounds) {
 		updateCheckBounds();
 	}
 
-	for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
-		(*it)->updateClient(p);
+	// Descendants of a scheduled subtree are updated from the engine's update list
+	if(!mScheduledUpdates) {
+		for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
+			(*it)->updateClient(p);
+		}
 	}
 
 	onUpdateClient(p);
 }
 
 void Sprite::updateServer(const UpdateParams &p) {
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite update");
 	mTouchProcess.update(p);
 
 	mIdleTimer.update();
@@ -247,17 +265,118 @@ void Sprite::updateServer(const UpdateParams &p) {
 		updateCheckBounds();
 	}
 
-	for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
-		(*it)->updateServer(p);
+	// Descendants of a scheduled subtree are updated from the engine's update list
+	if(!mScheduledUpdates) {
+		for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
+			(*it)->updateServer(p);
+		}
 	}
 
 	onUpdateServer(p);
 }
 
+bool Sprite::updateClientListed(const UpdateParams &p) {
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite update");
+	mUpdateRequested = false;
+	mIdleTimer.update();
+
+	if(mCheckBounds) {
+		updateCheckBounds();
+	}
+
+	onUpdateClient(p);
+
+	if(!mUpdateListed) {
+		// Taken off the list during the update, so it's already gone from there unless this adds it again
+		refreshUpdateListing();
+		return mUpdateListed;
+	}
+	mUpdateListed = mInScheduledSubtree && wantsListedUpdate();
+	return mUpdateListed;
+}
+
+bool Sprite::updateServerListed(const UpdateParams &p) {
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite update");
+	mUpdateRequested = false;
+	mTouchProcess.update(p);
+
+	mIdleTimer.update();
+
+	if(mCheckBounds) {
+		updateCheckBounds();
+	}
+
+	onUpdateServer(p);
+
+	if(!mUpdateListed) {
+		// Taken off the list during the update, so it's already gone from there unless this adds it again
+		refreshUpdateListing();
+		return mUpdateListed;
+	}
+	mUpdateListed = mInScheduledSubtree && wantsListedUpdate();
+	return mUpdateListed;
+}
+
+void Sprite::setScheduledUpdates(const bool scheduled) {
+	if(mScheduledUpdates == scheduled) return;
+	mScheduledUpdates = scheduled;
+
+	const bool childrenScheduled = mInScheduledSubtree || mScheduledUpdates;
+	for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
+		(*it)->setInScheduledSubtree(childrenScheduled);
+	}
+}
+
+void Sprite::setNeedsUpdate(const bool needsUpdate) {
+	if(mNeedsUpdate == needsUpdate) return;
+	mNeedsUpdate = needsUpdate;
+	refreshUpdateListing();
+}
+
+void Sprite::requestUpdate() {
+	if(!mInScheduledSubtree || mUpdateRequested) return;
+	mUpdateRequested = true;
+	refreshUpdateListing();
+}
+
+bool Sprite::wantsListedUpdate() const {
+	// Touched sprites stay listed so the touch process keeps its clock for swipes and double taps.
+	// Momentum moves the sprite, which requests an update on its own.
+	return mNeedsUpdate || mUpdateRequested || mCheckBounds || mIdleTimer.isActive() || mTouchProcess.hasTouches() || mTouchProcess.isWaitingForDoubleTap();
+}
+
+void Sprite::refreshUpdateListing() {
+	const bool listed = mInScheduledSubtree && wantsListedUpdate();
+	if(listed == mUpdateListed) return;
+
+	mUpdateListed = listed;
+	if(mUpdateListed) {
+		mEngine.addToUpdateList(this);
+	} else {
+		mEngine.removeFromUpdateList(this);
+	}
+}
+
+void Sprite::setInScheduledSubtree(const bool inScheduledSubtree) {
+	// Descendants always match, so nothing below here changes either
+	if(mInScheduledSubtree == inScheduledSubtree) return;
+	mInScheduledSubtree = inScheduledSubtree;
+
+	// Whatever happened while this wasn't scheduled still needs an update
+	mUpdateRequested = mInScheduledSubtree;
+	refreshUpdateListing();
+
+	if(mScheduledUpdates) return;
+	for(auto it = mChildren.begin(), it2 = mChildren.end(); it != it2; ++it) {
+		(*it)->setInScheduledSubtree(inScheduledSubtree);
+	}
+}
+
 void Sprite::drawClient(const ci::mat4 &trans, const DrawParams &drawParams) {
 	if ((mSpriteFlags&VISIBLE_F) == 0) {
 		return;
 	}
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite draw");
 	DS_REPORT_GL_ERRORS();
 
 	buildTransform();
@@ -380,6 +499,7 @@ void Sprite::drawServer(const ci::mat4 &trans, const DrawParams &drawParams) {
 	if((mSpriteFlags&VISIBLE_F) == 0) {
 		return;
 	}
+	DS_PROFILE_OBJECT_SCOPE(this, "sprite draw");
 
 	buildTransform();
 	ci::mat4 totalTransformation = trans*mTransformation;
@@ -524,6 +644,27 @@ void Sprite::doSetScale(const ci::vec3& scale) {
 	onScaleChanged();
 }
 
+void Sprite::onBatchTweened(const int changed) {
+	const bool		position = (changed & (1 << BatchTweener::POSITION)) != 0;
+	const bool		scale = (changed & (1 << BatchTweener::SCALE)) != 0;
+	const bool		rotation = (changed & (1 << BatchTweener::ROTATION)) != 0;
+
+	DirtyState		dirty;
+	if(position) dirty |= POSITION_DIRTY;
+	if(scale) dirty |= SCALE_DIRTY;
+	if(rotation) dirty |= ROTATION_DIRTY;
+	if((changed & (1 << BatchTweener::OPACITY)) != 0) dirty |= OPACITY_DIRTY;
+	markAsDirty(dirty);
+
+	if(!position && !scale && !rotation) return;
+	mUpdateTransform = true;
+	mBoundsNeedChecking = true;
+	dimensionalStateChanged();
+	if(position) onPositionChanged();
+	if(scale) onScaleChanged();
+	if(rotation) onRotationChanged();
+}
+
 const ci::vec3& Sprite::getPosition() const {
 	return mPosition;
 }
@@ -681,6 +822,7 @@ void Sprite::addChild(Sprite &child){
 	child.setPerspective(mPerspective);
 	child.setDrawSorted(getDrawSorted());
 	child.setUseDepthBuffer(mUseDepthBuffer);
+	child.setInScheduledSubtree(mInScheduledSubtree || mScheduledUpdates);
 
 	onChildAdded(child);
 }
@@ -697,6 +839,7 @@ void Sprite::removeChild(Sprite &child){
 		child.setParent(nullptr);
 		child.setPerspective(false);
 	}
+	child.setInScheduledSubtree(false);
 }
 
 void Sprite::setParent(Sprite *parent) {
@@ -1093,6 +1236,8 @@ void Sprite::setProcessTouchCallback(const std::function<void(Sprite *, const To
 
 void Sprite::processTouchInfo(const TouchInfo &touchInfo) {
 	mTouchProcess.processTouchInfo(touchInfo);
+	// Held touches and a single tap that might become a double tap both need updates
+	refreshUpdateListing();
 }
 
 void Sprite::move(const ci::vec3 &delta) {
@@ -1321,6 +1466,7 @@ void Sprite::setCheckBounds(bool checkBounds) {
 	mInBounds = !mCheckBounds;
 	mBoundsNeedChecking = checkBounds;
 	markAsDirty(CHECKBOUNDS_DIRTY);
+	refreshUpdateListing();
 }
 
 bool Sprite::getCheckBounds() const {
@@ -1605,6 +1751,7 @@ bool Sprite::getFlag(const int bit, const int flags) const {
 
 void Sprite::markAsDirty(const DirtyState& dirty){
 	mDirty |= dirty;
+	requestUpdate();
 	Sprite*		      p = mParent;
 	while (p) {
 		if ((p->mDirty&CHILD_DIRTY) == true) break;
@@ -1813,6 +1960,7 @@ void Sprite::makeSortedChildren() {
 
 void Sprite::setSecondBeforeIdle( const double idleTime ) {
 	mIdleTimer.setSecondBeforeIdle(idleTime);
+	refreshUpdateListing();
 }
 
 double Sprite::secondsToIdle() const {
@@ -1833,6 +1981,7 @@ void Sprite::resetIdleTimer() {
 
 void Sprite::clearIdleTimer() {
 	mIdleTimer.clear();
+	refreshUpdateListing();
 }
 
 void Sprite::setNoReplicationOptimization(const bool on) {
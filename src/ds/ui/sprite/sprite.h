@@ -113,6 +113,24 @@ namespace ui {
 		\param updateParams UpdateParams containing some conveniences such as delta time.		*/
 		virtual void			onUpdateServer(const ds::UpdateParams& updateParams){}
 
+		/** Hands this sprite's descendants over to the engine's update list, instead of visiting every one of them each frame.
+			Inside the subtree, a sprite is only updated while it needs to be: it called setNeedsUpdate(true), it's checking bounds,
+			it has an idle timer, it's waiting on a double tap, or it changed since its last update (see requestUpdate()).
+			Listed sprites update after the normal traversal, in the order they were created.
+			Off by default, which visits the whole tree every frame.
+			\param scheduled Whether descendants are only updated from the engine's update list.		*/
+		void					setScheduledUpdates(const bool scheduled);
+		bool					getScheduledUpdates() const { return mScheduledUpdates; }
+
+		/** Keeps this sprite updating every frame when it's inside a subtree with scheduled updates.
+			Sprites that do work in onUpdateServer() or onUpdateClient() every frame should turn this on. No effect elsewhere.		*/
+		void					setNeedsUpdate(const bool needsUpdate);
+		bool					getNeedsUpdate() const { return mNeedsUpdate; }
+
+		/** Updates this sprite once more, on the next frame, when it's inside a subtree with scheduled updates.
+			markAsDirty() calls this, so any property change is picked up.		*/
+		void					requestUpdate();
+
 		/** Draw function for when this app is set to be a client.
 			In most cases, you'll want to override drawLocalClient() to do custom drawing, as this function handles drawing for children as well.
 			\param transformMatrix The transform matrix of the parent.
@@ -731,6 +749,8 @@ namespace ui {
 		friend class        TouchProcess;
 		friend class		ds::gl::ClipPlaneState;
 		friend class		SpriteAnimatable;
+		friend class		BatchTweener;
+		friend class		SpriteEngine;
 
 		void				swipe(const ci::vec3 &swipeVector);
 		bool				tapInfo(const TapInfo&);
@@ -879,6 +899,14 @@ namespace ui {
 		TouchProcess		mTouchProcess;
 
 		bool				mCheckBounds;
+		/// Update scheduling, see setScheduledUpdates()
+		bool				mScheduledUpdates;
+		bool				mInScheduledSubtree;
+		bool				mNeedsUpdate;
+		bool				mUpdateRequested;
+		bool				mUpdateListed;
+		/// Where this is in the engine's update list, while it's listed
+		size_t				mUpdateListIndex;
 		Sprite*				mDragDestination;
 		IdleTimer			mIdleTimer;
 		bool				mUseDepthBuffer;
@@ -895,6 +923,15 @@ namespace ui {
 		/// Utility to reorder the sprites
 		void				setSpriteOrder(const std::vector<sprite_id_t>&);
 
+		/// The update for sprites on the engine's update list, which doesn't visit children.
+		/// Returns false once the sprite doesn't need to be on the list anymore.
+		bool				updateServerListed(const ds::UpdateParams&);
+		bool				updateClientListed(const ds::UpdateParams&);
+		bool				wantsListedUpdate() const;
+		/// Adds or removes this from the engine's update list to match its state
+		void				refreshUpdateListing();
+		void				setInScheduledSubtree(const bool inScheduledSubtree);
+
 		friend class ds::Engine;
 		friend class ds::EngineRoot;
 		/// Disable copy constructor; sprites are managed by their parent and
@@ -908,6 +945,9 @@ namespace ui {
 		void				readAttributesFrom(ds::DataBuffer&);
 
 		void				dimensionalStateChanged();
+		/// BatchTweener writes position, scale, rotation and opacity directly, then calls this once
+		/// with a bit (1 << BatchTweener::Property) for each that changed.
+		void				onBatchTweened(const int changed);
 		/// Applies to all children, too.
 		void				markClippingDirty();
 		/// Store all children in mSortedTmp by z order.
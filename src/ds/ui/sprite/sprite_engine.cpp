@@ -2,6 +2,7 @@
 
 #include "sprite_engine.h"
 #include "sprite.h"
+#include <algorithm>
 #include <cinder/app/App.h>
 #include "ds/app/engine/engine_data.h"
 #include "ds/app/engine/engine_events.h"
@@ -21,6 +22,8 @@ SpriteEngine::SpriteEngine(ds::EngineData& ed, const int appMode)
 	, mCallbackId(0)
 	, mMetricsService(nullptr)
 	, mRestartAfterUpdate(false)
+	, mUpdateListCount(0)
+	, mUpdateListSortedCount(0)
 {
 	mComputerInfo = new ds::ComputerInfo();
 }
@@ -133,6 +136,80 @@ void SpriteEngine::removeFromDragDestinationList(Sprite *sprite){
 		mDragDestinationSprites.erase(found);
 }
 
+void SpriteEngine::addToUpdateList(Sprite *sprite){
+	if(!sprite)
+		return;
+
+	// Anything added during an update waits until next frame
+	sprite->mUpdateListIndex = mUpdateList.size();
+	mUpdateList.push_back(sprite);
+	++mUpdateListCount;
+}
+
+void SpriteEngine::removeFromUpdateList(Sprite *sprite){
+	if(!sprite)
+		return;
+
+	const size_t index = sprite->mUpdateListIndex;
+	if(index >= mUpdateList.size() || mUpdateList[index] != sprite)
+		return;
+
+	// Leave a hole rather than moving things around under updateListedSprites()
+	mUpdateList[index] = nullptr;
+	--mUpdateListCount;
+}
+
+void SpriteEngine::updateListedSprites(const ds::UpdateParams& updateParams, const bool isServer){
+	if(mUpdateList.empty())
+		return;
+
+	// Ids are handed out in creation order, and match on every client. Only the sprites added
+	// since last frame need sorting, then they're merged into the rest.
+	compactUpdateList();
+	if(mUpdateListSortedCount < mUpdateList.size()) {
+		auto byId = [](const Sprite* a, const Sprite* b) { return a->getId() < b->getId(); };
+		const auto added = mUpdateList.begin() + mUpdateListSortedCount;
+		std::stable_sort(added, mUpdateList.end(), byId);
+		// Nothing in front of where the first new sprite lands moves
+		const auto moved = std::upper_bound(mUpdateList.begin(), added, *added, byId);
+		std::inplace_merge(mUpdateList.begin(), added, mUpdateList.end(), byId);
+		for(size_t i = moved - mUpdateList.begin(), count = mUpdateList.size(); i < count; ++i) {
+			mUpdateList[i]->mUpdateListIndex = i;
+		}
+		mUpdateListSortedCount = mUpdateList.size();
+	}
+
+	for(size_t i = 0, count = mUpdateList.size(); i < count; ++i) {
+		Sprite* sprite = mUpdateList[i];
+		if(!sprite) continue;
+
+		const bool keep = isServer ? sprite->updateServerListed(updateParams) : sprite->updateClientListed(updateParams);
+		// Goes by the sprite's index, since it might have been taken off and added again at the end during its update
+		if(!keep) removeFromUpdateList(sprite);
+	}
+
+	compactUpdateList();
+}
+
+void SpriteEngine::compactUpdateList(){
+	if(mUpdateListCount == mUpdateList.size())
+		return;
+
+	size_t out = 0;
+	size_t sorted = 0;
+	for(size_t i = 0, count = mUpdateList.size(); i < count; ++i) {
+		Sprite* sprite = mUpdateList[i];
+		if(!sprite) continue;
+
+		if(i < mUpdateListSortedCount) ++sorted;
+		sprite->mUpdateListIndex = out;
+		mUpdateList[out++] = sprite;
+	}
+	mUpdateList.resize(out);
+	// Closing the holes keeps the order, so the sorted front just gets shorter
+	mUpdateListSortedCount = sorted;
+}
+
 Sprite *SpriteEngine::getDragDestinationSprite(const ci::vec3 &globalPoint, Sprite *draggingSprite){
 	for(auto it = mDragDestinationSprites.begin(), it2 = mDragDestinationSprites.end(); it != it2; ++it) {
 		Sprite *sprite = *it;
@@ -17,6 +17,7 @@
 #include "ds/thread/work_manager.h"
 #include "ds/content/content_model.h"
 #include "ds/cfg/settings_variables.h"
+#include "ds/ui/tween/batch_tweener.h"
 
 namespace ds {
 class AutoUpdateList;
@@ -28,9 +29,11 @@ class EventNotifier;
 class FontList;
 class PerspCameraParams;
 class ResourceList;
+class ResourceResolver;
 class WorkManager;
 class ComputerInfo;
 class MetricsService;
+class UpdateParams;
 
 namespace cfg {
 class Settings;
@@ -65,12 +68,16 @@ public:
 	/// General engine services
 	virtual ds::WorkManager&		getWorkManager() final { return mWorkManager;	};
 	virtual ds::ResourceList&		getResources() = 0;
+	/// Asynchronous, batched lookups that fill getResources()
+	virtual ds::ResourceResolver&	getResourceResolver() = 0;
 	virtual const ds::ColorList&	getColors() const = 0;
 	virtual const ds::FontList&		getFonts() const = 0;
 	virtual ds::AutoUpdateList&		getAutoUpdateList(const int = AutoUpdateType::SERVER) = 0;
 	virtual LoadImageService&		getLoadImageService() = 0;
 	virtual PangoFontService&		getPangoFontService() = 0;
 	virtual Tweenline&				getTweenline() = 0;
+	/// Flat-array tweens for animating many sprites at once
+	virtual BatchTweener&			getBatchTweener() final { return mBatchTweener; };
 	virtual ci::app::WindowRef		getWindow() = 0;
 
 	bool							getMute();
@@ -167,7 +174,13 @@ public:
 	void							removeFromDragDestinationList(Sprite *sprite);
 	Sprite*							getDragDestinationSprite(const ci::vec3 &globalPoint, Sprite *draggingSprite);
 
-	double							getElapsedTimeSeconds() const;
+	/// Sprites inside subtrees with scheduled updates that need updating. Sprites manage this themselves, see Sprite::setScheduledUpdates()
+	void							addToUpdateList(Sprite *sprite);
+	void							removeFromUpdateList(Sprite *sprite);
+	size_t							getUpdateListSize() const { return mUpdateListCount; }
+
+	/// Seconds since the app started. The engine overrides this with its own clock, which is simulated when headless.
+	virtual double					getElapsedTimeSeconds() const;
 
 	int								getIdleTimeout() const;
 	void							setIdleTimeout(int idleTimeout);
@@ -306,10 +319,21 @@ protected:
 
 	ds::EngineData&					mData;
 	std::list<Sprite *>				mDragDestinationSprites;
+
+	/// Updates everything on the update list, in sprite id order. Called after the roots update.
+	void							updateListedSprites(const ds::UpdateParams&, const bool isServer);
+	/// Closes the holes in the update list, keeping the order
+	void							compactUpdateList();
+	/// Removed sprites leave a null hole, which the next update closes. Each sprite knows its place, see Sprite::mUpdateListIndex
+	std::vector<Sprite *>			mUpdateList;
+	size_t							mUpdateListCount;
+	/// How many entries at the front are in id order. Anything after that was added since the last update.
+	size_t							mUpdateListSortedCount;
 	ds::ComputerInfo*				mComputerInfo;
 	IEntryField*					mRegisteredEntryField;
 	const int						mAppMode;
 	WorkManager						mWorkManager;
+	BatchTweener					mBatchTweener;
 
 	ds::MetricsService*				mMetricsService;
 
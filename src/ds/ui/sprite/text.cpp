@@ -317,6 +317,7 @@ Text& Text::setFitFontSizes(std::vector<double> font_sizes)
 		mFontSizes = font_sizes;
 		mNeedsRefit = true;
 		mNeedsMeasuring = true;
+		requestUpdate();
 		return *this;
 }
 
@@ -374,6 +375,7 @@ void Text::setFitMaxFontSize(double fontSize)
 		mFitMaxTextSize = fontSize;
 		mNeedsMeasuring = true;
 		mNeedsRefit = true;
+		requestUpdate();
 	}
 }
 
@@ -383,6 +385,7 @@ void Text::setFitMinFontSize(double fontSize)
 		mFitMinTextSize = fontSize;
 		mNeedsMeasuring = true;
 		mNeedsRefit = true;
+		requestUpdate();
 	}
 }
 
@@ -1283,17 +1286,19 @@ void Text::writeAttributesTo(ds::DataBuffer& buf){
 
 void Text::readAttributeFrom(const char attributeId, ds::DataBuffer& buf){
 	if(attributeId == TEXT_ATT) {
-		setText(buf.read<std::string>());
+		// Only copied out of the buffer if it's changed
+		const boost::string_ref text = buf.readStringRef();
+		if(text != mText) setText(text.to_string());
 	} else if(attributeId == FONTNAME_ATT) {
 
-		std::string fontName = buf.read<std::string>();
+		const boost::string_ref fontName = buf.readStringRef();
 		double fontSize = buf.read<double>();
 		float leading = buf.read<float>();
 		float letterSpacing = buf.read<float>();
 		ci::Color fontColor = buf.read<ci::Color>();
 		auto alignment = (ds::ui::Alignment::Enum)(buf.read<int>());
 
-		setFont(fontName, fontSize);
+		if(fontName != mTextFont || fontSize != mTextSize) setFont(fontName.to_string(), fontSize);
 		setLeading(leading);
 		setLetterSpacing(letterSpacing);
 		setTextColor(fontColor);
@@ -43,6 +43,9 @@ bool TouchProcess::processTouchInfo( const TouchInfo &touchInfo )
 	if (!mSprite.visible() || !mSprite.isEnabled())
 		return false;
 
+	// A sprite with scheduled updates might not have been updated since before this touch
+	mLastUpdateTime = static_cast<float>(mSpriteEngine.getElapsedTimeSeconds());
+
 	mSprite.userInputReceived();
 
 	processTap(touchInfo);
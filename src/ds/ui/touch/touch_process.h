@@ -29,6 +29,8 @@ public:
 	void					update(const UpdateParams &updateParams);
 
 	bool					hasTouches() const;
+	/// A single tap is waiting to see if it turns into a double tap, which update() resolves
+	bool					isWaitingForDoubleTap() const { return mOneTap; }
 
 	void					clearTouches();
 
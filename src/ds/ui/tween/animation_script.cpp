@@ -0,0 +1,161 @@
+#include "stdafx.h"
+
+#include "ds/ui/tween/animation_script.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include "ds/debug/logger.h"
+#include "ds/ui/sprite/sprite.h"
+#include "ds/ui/sprite/sprite_engine.h"
+#include "ds/util/string_util.h"
+
+namespace ds {
+namespace ui {
+
+namespace {
+// Scripts almost always come from layouts and settings, so this only matters if an app builds them on the fly
+const size_t		MAX_CACHED_SCRIPTS = 512;
+
+typedef std::unordered_map<std::string, std::shared_ptr<const AnimationScript>> ScriptCache;
+ScriptCache& get_cache() {
+	static ScriptCache	CACHE;
+	return CACHE;
+}
+
+bool get_op(const std::string& name, AnimationScript::Op& out) {
+	static const std::unordered_map<std::string, AnimationScript::Op> OPS = {
+		{ "color", AnimationScript::COLOR }, { "fade", AnimationScript::FADE }, { "grow", AnimationScript::GROW },
+		{ "opacity", AnimationScript::OPACITY }, { "position", AnimationScript::POSITION }, { "rotation", AnimationScript::ROTATION },
+		{ "scale", AnimationScript::SCALE }, { "shift", AnimationScript::SHIFT }, { "size", AnimationScript::SIZE },
+		{ "slide", AnimationScript::SLIDE } };
+	auto found = OPS.find(name);
+	if(found == OPS.end()) return false;
+	out = found->second;
+	return true;
+}
+}
+
+/**
+ * \class AnimationScript
+ */
+std::shared_ptr<const AnimationScript> AnimationScript::get(const std::string& script) {
+	ScriptCache&	cache = get_cache();
+	auto			found = cache.find(script);
+	if(found != cache.end()) return found->second;
+
+	if(cache.size() >= MAX_CACHED_SCRIPTS) cache.clear();
+	std::shared_ptr<const AnimationScript>	compiled(new AnimationScript(script));
+	cache[script] = compiled;
+	return compiled;
+}
+
+void AnimationScript::clearCache() {
+	get_cache().clear();
+}
+
+AnimationScript::AnimationScript(const std::string& script)
+	: mScript(script)
+	, mEmpty(true)
+	, mEase(ci::EaseInOutCubic())
+	, mHasDuration(false)
+	, mDuration(0.0f)
+	, mDelay(0.0f)
+	, mHasCenter(false)
+{
+	compile();
+}
+
+float AnimationScript::getDuration(const SpriteEngine& e) const {
+	return getDuration(e.getAnimDur());
+}
+
+float AnimationScript::getDuration(const float defaultDuration) const {
+	return mHasDuration ? mDuration : defaultDuration;
+}
+
+float AnimationScript::run(const std::vector<Sprite*>& sprites, const float delay, const float deltaDelay, const bool isReverse) const {
+	float thisDelay = delay;
+	float total = delay;
+	for(auto it = sprites.begin(), end = sprites.end(); it != end; ++it) {
+		if(!*it) continue;
+		total = std::max(total, (*it)->runReversibleAnimationScript(*this, thisDelay, isReverse));
+		thisDelay += deltaDelay;
+	}
+	return total;
+}
+
+void AnimationScript::compile() {
+	if(mScript.empty()) return;
+
+	// find all the commands in the string
+	const std::vector<std::string> commands = ds::split(mScript, "; ", true);
+	if(commands.empty()) return;
+	mEmpty = false;
+
+	// The last of each type wins, and they're applied in type order
+	std::map<std::string, ci::vec3> animationCommands;
+	for(auto it = commands.begin(); it != commands.end(); ++it) {
+		// Split commands between the type and the destination
+		const std::vector<std::string> commandProperties = ds::split(*it, ":", true);
+		if(commandProperties.empty()) continue;
+
+		// Parse out the special commands
+		const std::string& key = commandProperties.front();
+		if(key == "ease" || key == "duration" || key == "delay") {
+			if(commandProperties.size() < 2) {
+				addError("\"" + key + "\" needs a value");
+				continue;
+			}
+			const std::string& value = commandProperties[1];
+			if(key == "ease") {
+				mEase = SpriteAnimatable::getEasingByString(value);
+				const auto fn = mEase.target<float(*)(float)>();
+				if(value != "none" && fn && *fn == &ci::easeNone) addError("unknown ease \"" + value + "\"");
+			} else if(key == "duration") {
+				if(ds::string_to_value<float>(value, mDuration)) mHasDuration = true;
+				else addError("bad duration \"" + value + "\"");
+			} else {
+				float rootDelay = 0.0f;
+				if(!ds::string_to_value<float>(value, rootDelay)) addError("bad delay \"" + value + "\"");
+				mDelay += rootDelay;
+			}
+			continue;
+		}
+
+		// parse the destination vectors to floats
+		ci::vec3 destination = ci::vec3();
+		if(commandProperties.size() > 1) {
+			const std::vector<std::string> destinationTokens = ds::split(commandProperties[1], ", ", true);
+			for(size_t i = 0; i < destinationTokens.size() && i < 3; ++i) {
+				if(!ds::string_to_value<float>(destinationTokens[i], destination[static_cast<int>(i)])) {
+					addError("bad number \"" + destinationTokens[i] + "\" for \"" + key + "\"");
+				}
+			}
+		}
+		animationCommands[key] = destination;
+	}
+
+	for(auto it = animationCommands.begin(); it != animationCommands.end(); ++it) {
+		if(it->first == "center") {
+			mHasCenter = true;
+			mCenter = it->second;
+			continue;
+		}
+		Instruction		inst;
+		if(!get_op(it->first, inst.mOp)) {
+			addError("unknown command \"" + it->first + "\"");
+			continue;
+		}
+		inst.mValue = it->second;
+		mInstructions.push_back(inst);
+	}
+}
+
+void AnimationScript::addError(const std::string& error) {
+	DS_LOG_WARNING("AnimationScript " << error << " in \"" << mScript << "\"");
+	mErrors.push_back(error);
+}
+
+} // namespace ui
+} // namespace ds
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef DS_UI_TWEEN_ANIMATIONSCRIPT_H_
+#define DS_UI_TWEEN_ANIMATIONSCRIPT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cinder/Easing.h>
+#include <cinder/Vector.h>
+
+namespace ds {
+namespace ui {
+class Sprite;
+class SpriteEngine;
+
+/**
+ * \class AnimationScript
+ * \brief An animation script (see SpriteAnimatable::runAnimationScript() for the syntax) parsed
+ *        into a list of instructions. Scripts are compiled once and cached by their text, so
+ *        running the same script on lots of sprites doesn't re-parse it for each one.
+ *        Problems in the script (unknown commands, eases or numbers that don't parse) are logged
+ *        once when it's compiled, and available from getErrors().
+ *        Compiled scripts are immutable and can be shared freely.
+ */
+class AnimationScript {
+public:
+	/// In the order they're applied, which matches the order the uncompiled scripts always used
+	enum Op { COLOR, FADE, GROW, OPACITY, POSITION, ROTATION, SCALE, SHIFT, SIZE, SLIDE };
+
+	struct Instruction {
+		Op							mOp;
+		ci::vec3					mValue;
+	};
+
+	/// Answers the cached compile of the script, compiling it if needed. Never null. Main thread only.
+	static std::shared_ptr<const AnimationScript>
+									get(const std::string& script);
+	static void						clearCache();
+
+	explicit AnimationScript(const std::string& script);
+
+	const std::string&				getScript() const { return mScript; }
+	bool							empty() const { return mEmpty; }
+	const std::vector<std::string>&	getErrors() const { return mErrors; }
+
+	/// The script's duration, or the engine's default animation duration if it doesn't have one
+	float							getDuration(const SpriteEngine&) const;
+	float							getDuration(const float defaultDuration) const;
+	/// The total of the script's delay commands
+	float							getDelay() const { return mDelay; }
+
+	/// Runs the script on each sprite, each one deltaDelay later than the one before.
+	/// Answers the time until the last one is done, like SpriteAnimatable::runAnimationScript().
+	float							run(const std::vector<Sprite*>&, const float delay = 0.0f, const float deltaDelay = 0.0f,
+										const bool isReverse = false) const;
+
+private:
+	friend class SpriteAnimatable;
+	void							compile();
+	void							addError(const std::string&);
+
+	std::string						mScript;
+	bool							mEmpty;
+	ci::EaseFn						mEase;
+	bool							mHasDuration;
+	float							mDuration;
+	float							mDelay;
+	bool							mHasCenter;
+	ci::vec3						mCenter;
+	std::vector<Instruction>		mInstructions;
+	std::vector<std::string>		mErrors;
+};
+
+} // namespace ui
+} // namespace ds
+
+#endif // DS_UI_TWEEN_ANIMATIONSCRIPT_H_
@@ -0,0 +1,425 @@
+#include "stdafx.h"
+
+#include "ds/ui/tween/batch_tweener.h"
+
+#include <limits>
+#include "ds/ui/sprite/sprite.h"
+
+namespace ds {
+namespace ui {
+
+namespace {
+const uint16_t		EASE_NONE_INDEX = 0;
+
+int bit_of(const BatchTweener::Property p) {
+	return 1 << static_cast<int>(p);
+}
+}
+
+/**
+ * \class BatchTweener::Entry
+ */
+BatchTweener::Entry::Entry()
+	: mSprite(nullptr)
+	, mCount(0)
+	, mChanged(0)
+{
+	for(int p = 0; p < PROPERTY_COUNT; ++p) mRecord[p] = NONE;
+}
+
+/**
+ * \class BatchTweener::Track
+ */
+void BatchTweener::Track::push(Entry* e, const float start, const float invDuration, const uint16_t ease, const uint32_t extra,
+							   const float* from, const float* to) {
+	mEntry.push_back(e);
+	mStart.push_back(start);
+	mInvDuration.push_back(invDuration);
+	mEase.push_back(ease);
+	mExtra.push_back(extra);
+	for(int c = 0; c < mComponents; ++c) {
+		mFrom[c].push_back(from[c]);
+		mTo[c].push_back(to[c]);
+	}
+}
+
+void BatchTweener::Track::pop(const size_t index) {
+	const size_t last = size() - 1;
+	if(index != last) {
+		mEntry[index] = mEntry[last];
+		mStart[index] = mStart[last];
+		mInvDuration[index] = mInvDuration[last];
+		mEase[index] = mEase[last];
+		mExtra[index] = mExtra[last];
+		for(int c = 0; c < mComponents; ++c) {
+			mFrom[c][index] = mFrom[c][last];
+			mTo[c][index] = mTo[c][last];
+		}
+	}
+	mEntry.pop_back();
+	mStart.pop_back();
+	mInvDuration.pop_back();
+	mEase.pop_back();
+	mExtra.pop_back();
+	for(int c = 0; c < mComponents; ++c) {
+		mFrom[c].pop_back();
+		mTo[c].pop_back();
+	}
+}
+
+/**
+ * \class BatchTweener
+ */
+BatchTweener::BatchTweener()
+	: mUpdating(false)
+	, mNow(0.0f)
+	, mHasUpdated(false)
+{
+	for(int p = 0; p < PROPERTY_COUNT; ++p) mTracks[p].mComponents = 3;
+	mTracks[OPACITY].mComponents = 1;
+
+	// Index 0 is always easeNone, which update() skips entirely
+	Ease none;
+	none.mFn = &ci::easeNone;
+	mEases.push_back(none);
+}
+
+void BatchTweener::tweenPosition(Sprite& s, const ci::vec3& pos, const float duration, const float delay,
+								 const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const ci::vec3 from = s.getPosition();
+	start(s, POSITION, &from.x, &pos.x, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::tweenScale(Sprite& s, const ci::vec3& scale, const float duration, const float delay,
+							  const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const ci::vec3 from = s.getScale();
+	start(s, SCALE, &from.x, &scale.x, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::tweenRotation(Sprite& s, const ci::vec3& rot, const float duration, const float delay,
+								 const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const ci::vec3 from = s.getRotation();
+	start(s, ROTATION, &from.x, &rot.x, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::tweenSize(Sprite& s, const ci::vec3& size, const float duration, const float delay,
+							 const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const ci::vec3 from = s.getSize();
+	start(s, SIZE, &from.x, &size.x, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::tweenOpacity(Sprite& s, const float opacity, const float duration, const float delay,
+								const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const float from = s.getOpacity();
+	start(s, OPACITY, &from, &opacity, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::tweenColor(Sprite& s, const ci::Color& color, const float duration, const float delay,
+							  const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	const ci::Color from = s.getColor();
+	start(s, COLOR, &from.r, &color.r, duration, delay, ease, finishFn);
+}
+
+void BatchTweener::stop(Sprite& s) {
+	auto found = mEntries.find(&s);
+	if(found == mEntries.end()) return;
+
+	Entry& e = found->second;
+	for(int p = 0; p < PROPERTY_COUNT; ++p) {
+		if(e.mRecord[p] != NONE) remove(static_cast<Property>(p), e.mRecord[p], nullptr);
+	}
+	// In case this happens during a flush, i.e. the sprite is being deleted
+	e.mChanged = 0;
+	eraseIfIdle(&s);
+}
+
+void BatchTweener::stop(Sprite& s, const Property p) {
+	auto found = mEntries.find(&s);
+	if(found == mEntries.end() || found->second.mRecord[p] == NONE) return;
+
+	remove(p, found->second.mRecord[p], nullptr);
+	eraseIfIdle(&s);
+}
+
+void BatchTweener::complete(Sprite& s, const bool callFinishFunctions) {
+	auto found = mEntries.find(&s);
+	if(found == mEntries.end()) return;
+
+	std::vector<std::function<void(void)>>	finishFns;
+	Entry& e = found->second;
+	for(int p = 0; p < PROPERTY_COUNT; ++p) {
+		if(e.mRecord[p] == NONE) continue;
+		write(static_cast<Property>(p), e.mRecord[p], 1.0f);
+		remove(static_cast<Property>(p), e.mRecord[p], callFinishFunctions ? &finishFns : nullptr);
+	}
+	// Mid-update, the update's own flush picks this up
+	if(!mUpdating) flush();
+	eraseIfIdle(&s);
+
+	for(auto it = finishFns.begin(), end = finishFns.end(); it != end; ++it) (*it)();
+}
+
+bool BatchTweener::isTweening(const Sprite& s) const {
+	auto found = mEntries.find(const_cast<Sprite*>(&s));
+	return found != mEntries.end() && found->second.mCount > 0;
+}
+
+bool BatchTweener::isTweening(const Sprite& s, const Property p) const {
+	auto found = mEntries.find(const_cast<Sprite*>(&s));
+	return found != mEntries.end() && found->second.mRecord[p] != NONE;
+}
+
+size_t BatchTweener::getActiveCount() const {
+	size_t count = 0;
+	for(int p = 0; p < PROPERTY_COUNT; ++p) count += mTracks[p].size();
+	return count;
+}
+
+void BatchTweener::update(const float now) {
+	if(!mHasUpdated) {
+		// Tweens started before the clock was known were timed from 0
+		for(int p = 0; p < PROPERTY_COUNT; ++p) {
+			for(auto& start : mTracks[p].mStart) start += now;
+		}
+		mHasUpdated = true;
+	}
+	mNow = now;
+	if(mEntries.empty()) return;
+
+	mUpdating = true;
+	for(int p = 0; p < PROPERTY_COUNT; ++p) {
+		Track& t = mTracks[p];
+		if(t.size() < 1) continue;
+
+		mFinished.clear();
+		evaluate(t, now);
+
+		const size_t count = t.size();
+		for(size_t i = 0; i < count; ++i) {
+			if(t.mProgress[i] >= 0.0f) write(static_cast<Property>(p), i, t.mProgress[i]);
+		}
+		// Highest index first, so swapping the last record into a removed slot never moves one still waiting to be removed
+		for(auto it = mFinished.rbegin(), end = mFinished.rend(); it != end; ++it) {
+			remove(static_cast<Property>(p), *it, &mFinishFns);
+		}
+	}
+	flush();
+	mUpdating = false;
+
+	for(auto it = mDeferredErase.begin(), end = mDeferredErase.end(); it != end; ++it) eraseIfIdle(*it);
+	mDeferredErase.clear();
+
+	if(mFinishFns.empty()) return;
+	// Finish functions are free to start new tweens
+	std::vector<std::function<void(void)>>	finishFns;
+	finishFns.swap(mFinishFns);
+	for(auto it = finishFns.begin(), end = finishFns.end(); it != end; ++it) (*it)();
+}
+
+void BatchTweener::start(Sprite& s, const Property p, const float* from, const float* to, const float duration,
+						 const float delay, const ci::EaseFn& ease, const std::function<void(void)>& finishFn) {
+	// Also stops any tween on this property in here
+	stopAnimatable(s, p);
+
+	const uint16_t easeIndex = internEase(ease);
+	uint32_t extra = NONE;
+	if(easeIndex == CUSTOM_EASE || finishFn) {
+		extra = allocExtra();
+		if(easeIndex == CUSTOM_EASE) mExtras[extra].mEase = ease;
+		mExtras[extra].mFinish = finishFn;
+	}
+
+	Entry& e = mEntries[&s];
+	e.mSprite = &s;
+	e.mRecord[p] = static_cast<uint32_t>(mTracks[p].size());
+	++e.mCount;
+
+	const float invDuration = duration > 0.0f ? 1.0f / duration : std::numeric_limits<float>::max();
+	mTracks[p].push(&e, mNow + delay, invDuration, easeIndex, extra, from, to);
+}
+
+void BatchTweener::stopAnimatable(Sprite& s, const Property p) {
+	switch(p) {
+	case POSITION:	s.animPositionStop(); break;
+	case SCALE:		s.animScaleStop(); break;
+	case ROTATION:	s.animRotationStop(); break;
+	case SIZE:		s.animSizeStop(); break;
+	case OPACITY:	s.animOpacityStop(); break;
+	case COLOR:		s.animColorStop(); break;
+	default:		break;
+	}
+}
+
+void BatchTweener::remove(const Property p, const size_t index, std::vector<std::function<void(void)>>* finishFns) {
+	Track& t = mTracks[p];
+	Entry* e = t.mEntry[index];
+	e->mRecord[p] = NONE;
+	--e->mCount;
+
+	const uint32_t extra = t.mExtra[index];
+	if(extra != NONE) {
+		Extra& x = mExtras[extra];
+		if(finishFns && x.mFinish) finishFns->push_back(std::move(x.mFinish));
+		x.mFinish = nullptr;
+		x.mEase = nullptr;
+		mFreeExtras.push_back(extra);
+	}
+
+	const size_t last = t.size() - 1;
+	if(index != last) t.mEntry[last]->mRecord[p] = static_cast<uint32_t>(index);
+	t.pop(index);
+}
+
+void BatchTweener::evaluate(Track& t, const float now) {
+	const size_t count = t.size();
+	const size_t groups = mEases.size() + 1;
+	t.mProgress.resize(count);
+	mEaseCounts.assign(groups + 1, 0);
+
+	// Linear progress. Delayed tweens are negative and left alone, finished ones land exactly on 1.
+	for(size_t i = 0; i < count; ++i) {
+		float v = (now - t.mStart[i]) * t.mInvDuration[i];
+		if(v >= 1.0f) {
+			v = 1.0f;
+			mFinished.push_back(static_cast<uint32_t>(i));
+		} else if(v >= 0.0f) {
+			++mEaseCounts[(t.mEase[i] == CUSTOM_EASE ? groups - 1 : t.mEase[i]) + 1];
+		}
+		t.mProgress[i] = v;
+	}
+
+	// Counting sort the running tweens by ease, then ease each group in one pass
+	for(size_t g = 1; g <= groups; ++g) mEaseCounts[g] += mEaseCounts[g - 1];
+	mOrder.resize(mEaseCounts[groups]);
+	for(size_t i = 0; i < count; ++i) {
+		const float v = t.mProgress[i];
+		if(v < 0.0f || v >= 1.0f) continue;
+		const size_t g = (t.mEase[i] == CUSTOM_EASE ? groups - 1 : t.mEase[i]);
+		mOrder[mEaseCounts[g]++] = static_cast<uint32_t>(i);
+	}
+	// Each count is now the end of its group
+	size_t begin = mEaseCounts[EASE_NONE_INDEX];
+	for(size_t g = 1; g < groups - 1; ++g) {
+		float (*fn)(float) = mEases[g].mFn;
+		const size_t end = mEaseCounts[g];
+		for(size_t k = begin; k < end; ++k) {
+			float& v = t.mProgress[mOrder[k]];
+			v = fn(v);
+		}
+		begin = end;
+	}
+	const size_t end = mEaseCounts[groups - 1];
+	for(size_t k = begin; k < end; ++k) {
+		const uint32_t i = mOrder[k];
+		t.mProgress[i] = mExtras[t.mExtra[i]].mEase(t.mProgress[i]);
+	}
+}
+
+void BatchTweener::write(const Property p, const size_t index, const float progress) {
+	Track& t = mTracks[p];
+	Entry* e = t.mEntry[index];
+	Sprite& s = *e->mSprite;
+
+	float v[3] = { 0.0f, 0.0f, 0.0f };
+	for(int c = 0; c < t.mComponents; ++c) {
+		const float from = t.mFrom[c][index], to = t.mTo[c][index];
+		v[c] = progress == 1.0f ? to : from + (to - from) * progress;
+	}
+
+	bool changed = true;
+	switch(p) {
+	case POSITION: {
+		const ci::vec3 pos(v[0], v[1], v[2]);
+		changed = s.mPosition != pos;
+		s.mPosition = pos;
+		break;
+	}
+	case SCALE: {
+		const ci::vec3 scale(v[0], v[1], v[2]);
+		changed = s.mScale != scale;
+		s.mScale = scale;
+		break;
+	}
+	case ROTATION: {
+		const ci::vec3 rot(v[0], v[1], v[2]);
+		changed = s.mRotation != rot;
+		s.mRotation = rot;
+		break;
+	}
+	case OPACITY:
+		changed = s.mOpacity != v[0];
+		s.mOpacity = v[0];
+		break;
+	case SIZE:
+		e->mSize = ci::vec3(v[0], v[1], v[2]);
+		break;
+	case COLOR:
+		e->mColor = ci::Color(v[0], v[1], v[2]);
+		break;
+	default:
+		changed = false;
+		break;
+	}
+	if(!changed) return;
+
+	if(e->mChanged == 0) mChangedEntries.push_back(e);
+	e->mChanged |= bit_of(p);
+}
+
+void BatchTweener::flush() {
+	const int direct = bit_of(POSITION) | bit_of(SCALE) | bit_of(ROTATION) | bit_of(OPACITY);
+
+	// By index, anything the sprite callbacks tween gets appended and flushed here too
+	for(size_t i = 0; i < mChangedEntries.size(); ++i) {
+		Entry* e = mChangedEntries[i];
+		const int changed = e->mChanged;
+		e->mChanged = 0;
+		if(changed == 0) continue;
+
+		Sprite& s = *e->mSprite;
+		if((changed & bit_of(SIZE)) != 0) s.setSizeAll(e->mSize.x, e->mSize.y, e->mSize.z);
+		if((changed & bit_of(COLOR)) != 0) s.setColor(e->mColor);
+		if((changed & direct) != 0) s.onBatchTweened(changed & direct);
+	}
+	mChangedEntries.clear();
+}
+
+uint16_t BatchTweener::internEase(const ci::EaseFn& ease) {
+	if(!ease) return static_cast<uint16_t>(EASE_NONE_INDEX);
+
+	float (* const* fn)(float) = ease.target<float(*)(float)>();
+	// Lambdas and the cinder ease structs can't be compared, so they're evaluated one at a time
+	if(!fn || !*fn) return CUSTOM_EASE;
+
+	for(size_t i = 0; i < mEases.size(); ++i) {
+		if(mEases[i].mFn == *fn) return static_cast<uint16_t>(i);
+	}
+	if(mEases.size() >= CUSTOM_EASE - 1) return CUSTOM_EASE;
+
+	Ease interned;
+	interned.mFn = *fn;
+	mEases.push_back(interned);
+	return static_cast<uint16_t>(mEases.size() - 1);
+}
+
+uint32_t BatchTweener::allocExtra() {
+	if(!mFreeExtras.empty()) {
+		const uint32_t index = mFreeExtras.back();
+		mFreeExtras.pop_back();
+		return index;
+	}
+	mExtras.push_back(Extra());
+	return static_cast<uint32_t>(mExtras.size() - 1);
+}
+
+void BatchTweener::eraseIfIdle(Sprite* s) {
+	if(mUpdating) {
+		mDeferredErase.push_back(s);
+		return;
+	}
+	auto found = mEntries.find(s);
+	if(found != mEntries.end() && found->second.mCount < 1 && found->second.mChanged == 0) mEntries.erase(found);
+}
+
+} // namespace ui
+} // namespace ds
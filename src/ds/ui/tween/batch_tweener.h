@@ -0,0 +1,153 @@
+#pragma once
+#ifndef DS_UI_TWEEN_BATCHTWEENER_H_
+#define DS_UI_TWEEN_BATCHTWEENER_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <cinder/Color.h>
+#include <cinder/Easing.h>
+#include <cinder/Vector.h>
+
+namespace ds {
+namespace ui {
+class Sprite;
+
+/**
+ * \class BatchTweener
+ * \brief An alternative to the Tweenline for animating lots of sprites at once, i.e. grids and
+ *        particle-ish layouts that tween hundreds of sprites on the same frame.
+ *        Active tweens are stored per property in flat arrays instead of one heap-allocated
+ *        cinder tween each. Each update evaluates the easing for every tween sharing an ease
+ *        function together, writes the values straight into the sprites, then marks each sprite
+ *        dirty once regardless of how many of its properties moved.
+ *        Position, scale, rotation and opacity are written directly, so overrides of doSetPosition()
+ *        and friends are skipped (onPositionChanged() etc. are still called). Size and color go through
+ *        setSizeAll() and setColor(), since sprites commonly override those.
+ *        Starting a tween replaces any tween on the same property of that sprite, in here or in
+ *        the sprite's own SpriteAnimatable tweens. There's no update function; if you need one,
+ *        use the regular tweens.
+ *        Get the engine's instance from SpriteEngine::getBatchTweener().
+ */
+class BatchTweener {
+public:
+	enum Property { POSITION = 0, SCALE, ROTATION, SIZE, OPACITY, COLOR, PROPERTY_COUNT };
+
+	BatchTweener();
+
+	void						tweenPosition(Sprite&, const ci::vec3& pos, const float duration = 1.0f, const float delay = 0.0f,
+											  const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+	void						tweenScale(Sprite&, const ci::vec3& scale, const float duration = 1.0f, const float delay = 0.0f,
+										   const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+	void						tweenRotation(Sprite&, const ci::vec3& rot, const float duration = 1.0f, const float delay = 0.0f,
+											  const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+	void						tweenSize(Sprite&, const ci::vec3& size, const float duration = 1.0f, const float delay = 0.0f,
+										  const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+	void						tweenOpacity(Sprite&, const float opacity, const float duration = 1.0f, const float delay = 0.0f,
+											 const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+	void						tweenColor(Sprite&, const ci::Color& color, const float duration = 1.0f, const float delay = 0.0f,
+										   const ci::EaseFn& = ci::easeNone, const std::function<void(void)>& finishFn = nullptr);
+
+	/// Stops without calling finish functions, leaving the sprite wherever it currently is
+	void						stop(Sprite&);
+	void						stop(Sprite&, const Property);
+	/// Jumps every tween on the sprite to its end value
+	void						complete(Sprite&, const bool callFinishFunctions = false);
+
+	bool						isTweening(const Sprite&) const;
+	bool						isTweening(const Sprite&, const Property) const;
+	size_t						getActiveCount() const;
+
+	/// Called by the engine every update with the engine clock's time. Tweens start at the time of
+	/// the last update; anything started before the first update starts at the first update.
+	void						update(const float now);
+
+private:
+	static const uint32_t		NONE = 0xffffffff;
+	static const uint16_t		CUSTOM_EASE = 0xffff;
+
+	struct Entry {
+		Entry();
+		Sprite*					mSprite;
+		uint32_t				mRecord[PROPERTY_COUNT];
+		int						mCount;
+		/// Property bits written since the last flush
+		int						mChanged;
+		/// Size and color go through the sprite's setters when flushed
+		ci::vec3				mSize;
+		ci::Color				mColor;
+	};
+
+	/// Interned plain-function eases, so tweens sharing an ease can be evaluated together
+	struct Ease {
+		float					(*mFn)(float);
+	};
+
+	/// Anything a record has that most don't: a finish function or an ease that isn't a plain function
+	struct Extra {
+		ci::EaseFn				mEase;
+		std::function<void(void)>	mFinish;
+	};
+
+	/// One property's tweens, one array per field
+	struct Track {
+		size_t					size() const { return mEntry.size(); }
+		void					push(Entry*, const float start, const float invDuration, const uint16_t ease, const uint32_t extra,
+									 const float* from, const float* to);
+		void					pop(const size_t index);
+
+		int						mComponents;
+		std::vector<Entry*>		mEntry;
+		std::vector<float>		mStart,
+								mInvDuration;
+		std::vector<uint16_t>	mEase;
+		std::vector<uint32_t>	mExtra;
+		std::vector<float>		mFrom[3],
+								mTo[3];
+		/// Scratch, rebuilt every update
+		std::vector<float>		mProgress;
+	};
+
+	void						start(Sprite&, const Property, const float* from, const float* to, const float duration,
+									  const float delay, const ci::EaseFn&, const std::function<void(void)>& finishFn);
+	/// Stops the sprite's SpriteAnimatable tween on the same property
+	void						stopAnimatable(Sprite&, const Property);
+	/// Finish functions are moved into finishFns, or dropped if it's null
+	void						remove(const Property, const size_t index, std::vector<std::function<void(void)>>* finishFns);
+	/// Turns each track record's time into eased progress, grouped by ease function
+	void						evaluate(Track&, const float now);
+	void						write(const Property, const size_t index, const float progress);
+	/// Marks each sprite written since the last flush dirty, once
+	void						flush();
+	uint16_t					internEase(const ci::EaseFn&);
+	uint32_t					allocExtra();
+	void						eraseIfIdle(Sprite*);
+
+	Track						mTracks[PROPERTY_COUNT];
+	std::unordered_map<Sprite*, Entry>
+								mEntries;
+	std::vector<Ease>			mEases;
+	std::vector<Extra>			mExtras;
+	std::vector<uint32_t>		mFreeExtras;
+
+	/// Scratch for update()
+	std::vector<uint32_t>		mEaseCounts;
+	std::vector<uint32_t>		mOrder;
+	std::vector<uint32_t>		mFinished;
+	std::vector<Entry*>			mChangedEntries;
+	std::vector<std::function<void(void)>>
+								mFinishFns;
+	/// Entries aren't erased mid-update, since mChangedEntries points at them
+	std::vector<Sprite*>		mDeferredErase;
+	bool						mUpdating;
+
+	/// The time of the last update, which new tweens start from
+	float						mNow;
+	bool						mHasUpdated;
+};
+
+} // namespace ui
+} // namespace ds
+
+#endif // DS_UI_TWEEN_BATCHTWEENER_H_
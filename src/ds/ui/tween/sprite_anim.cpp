@@ -4,6 +4,8 @@
 
 #include "ds/ui/sprite/sprite.h"
 #include "ds/ui/sprite/sprite_engine.h"
+#include "ds/ui/tween/animation_script.h"
+#include "ds/ui/tween/batch_tweener.h"
 #include "ds/ui/tween/tweenline.h"
 
 #include "ds/util/string_util.h"
@@ -51,6 +53,8 @@ SpriteAnimatable::~SpriteAnimatable() {
 	mAnimScriptCueRef = nullptr;
 
 	mMultiDelayedCallCueRefs.clear();
+
+	mEngine.getBatchTweener().stop(mOwner);
 }
 
 const SpriteAnim<ci::Color>& SpriteAnimatable::ANIM_COLOR() {
@@ -256,7 +260,8 @@ const bool SpriteAnimatable::animationRunning(){
 		|| getSizeTweenIsRunning() 
 		|| getRotationTweenIsRunning() 
 		|| getColorTweenIsRunning() 
-		|| getNormalizeTweenIsRunning();
+		|| getNormalizeTweenIsRunning()
+		|| mEngine.getBatchTweener().isTweening(mOwner);
 }
 
 const bool SpriteAnimatable::getPositionTweenIsRunning(){
@@ -303,31 +308,37 @@ void SpriteAnimatable::animStop() {
 void SpriteAnimatable::animPositionStop(){
 	mAnimPosition.stop();
 	mInternalPositionCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::POSITION);
 }
 
 void SpriteAnimatable::animRotationStop(){
 	mAnimRotation.stop();
 	mInternalRotationCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::ROTATION);
 }
 
 void SpriteAnimatable::animScaleStop(){
 	mAnimScale.stop();
 	mInternalScaleCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::SCALE);
 }
 
 void SpriteAnimatable::animSizeStop(){
 	mAnimSize.stop();
 	mInternalSizeCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::SIZE);
 }
 
 void SpriteAnimatable::animOpacityStop(){
 	mAnimOpacity.stop();
 	mInternalOpacityCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::OPACITY);
 }
 
 void SpriteAnimatable::animColorStop(){
 	mAnimColor.stop();
 	mInternalColorCinderTweenRef = nullptr;
+	mEngine.getBatchTweener().stop(mOwner, BatchTweener::COLOR);
 }
 
 void SpriteAnimatable::animNormalizedStop(){
@@ -344,6 +355,7 @@ void SpriteAnimatable::completeAllTweens(const bool callFinishFunctions, const b
 	completeTweenScale(callFinishFunctions);
 	completeTweenSize(callFinishFunctions);
 	completeTweenNormalized(callFinishFunctions);
+	mEngine.getBatchTweener().complete(mOwner, callFinishFunctions);
 
 	// Complete my babies tweenies
 	if(recursive){
@@ -367,7 +379,7 @@ float SpriteAnimatable::tweenAnimateOn(const bool recursive, const float delay,
 
 	float thisDelay = delay;
 	float total = delay;
-	total = std::max(total, runAnimationScript(mAnimateOnScript, thisDelay));
+	if(mAnimateOnCompiled) total = std::max(total, runReversibleAnimationScript(*mAnimateOnCompiled, thisDelay, false));
 	if(recursive){
 		for(auto it = begin(mOwner.mChildren); it != end(mOwner.mChildren); ++it) {
 			auto child = *it;
@@ -387,6 +399,7 @@ float SpriteAnimatable::tweenAnimateOn(const bool recursive, const float delay,
 
 void SpriteAnimatable::setAnimateOnScript(const std::string& animateOnScript){
 	mAnimateOnScript = animateOnScript;
+	mAnimateOnCompiled = animateOnScript.empty() ? nullptr : AnimationScript::get(animateOnScript);
 }
 
 void SpriteAnimatable::setAnimateOnTargets(){
@@ -428,7 +441,7 @@ float SpriteAnimatable::tweenAnimateOff(const bool recursive, const float delay,
 			}
 		}
 	}
-	total = std::max(total, runAnimationOffScript(mAnimateOffScript, thisDelay+deltaDelay));
+	if(mAnimateOffCompiled) total = std::max(total, runReversibleAnimationScript(*mAnimateOffCompiled, thisDelay+deltaDelay, true));
 
 	if(finishFn){
 		auto& timeline = mEngine.getTweenline().getTimeline();
@@ -440,6 +453,7 @@ float SpriteAnimatable::tweenAnimateOff(const bool recursive, const float delay,
 
 void SpriteAnimatable::setAnimateOffScript(const std::string& animateOffScript){
 	mAnimateOffScript = animateOffScript;
+	mAnimateOffCompiled = animateOffScript.empty() ? nullptr : AnimationScript::get(animateOffScript);
 }
 
 float SpriteAnimatable::runAnimationScript(const std::string& animScript, const float addedDelay){
@@ -452,76 +466,23 @@ float SpriteAnimatable::runAnimationOffScript(const std::string& animScript, con
 
 float SpriteAnimatable::runReversibleAnimationScript(const std::string& animScript, const float addedDelay, const bool isReverse){
 	if (animScript.empty()) return 0.f;
+	return runReversibleAnimationScript(*AnimationScript::get(animScript), addedDelay, isReverse);
+}
 
-	// find all the commands in the string
-	std::vector<std::string> commands = ds::split(animScript, "; ", true);
-
-	if (commands.empty()) return 0.f;
+float SpriteAnimatable::runReversibleAnimationScript(const AnimationScript& script, const float addedDelay, const bool isReverse){
+	if (script.empty()) return 0.f;
 
-	// set default parameters, if they're not supplied by the string
-	ci::EaseFn easing = ci::EaseInOutCubic();
-	float dur = mEngine.getAnimDur();
-	float delayey = addedDelay;
+	const ci::EaseFn& easing = script.mEase;
+	const float dur = script.getDuration(mEngine);
+	const float delayey = addedDelay + script.getDelay();
 
-	// I'm 98% sure this can never return true.
-	// if (!&mOwner)
-	// 	return 0.f;
 	ci::vec3 currentPos = mOwner.getPosition();
 
-	// This maps tracks all the types (scale, position, etc) and their destinations (as 3d vectors)
-	std::map<std::string, ci::vec3> animationCommands;
-	for (auto it = commands.begin(); it < commands.end(); ++it){
-
-		// Split commands between the type and the destination
-		std::vector<std::string> commandProperties = ds::split((*it), ":", true);
-		if (commandProperties.empty() || commandProperties.size() < 1) continue;
-
-		// Parse out the special commands
-		std::string keyey = commandProperties.front();
-		if (keyey == "ease"){
-			std::string easeString = commandProperties[1];
-			easing = getEasingByString(easeString);
-			continue;
-		}
-		else if (keyey == "duration"){
-			ds::string_to_value<float>(commandProperties[1], dur);
-			continue;
-		}
-		else if (keyey == "delay"){
-			float rootDelay = 0.0f;
-			ds::string_to_value<float>(commandProperties[1], rootDelay);
-			delayey += rootDelay;
-			continue;
-		}
-
-		// parse the destination vectors to floats
-		ci::vec3 destination = ci::vec3();
-
-		if (commandProperties.size() > 1){
-			std::vector<std::string> destinationTokens = ds::split(commandProperties[1], ", ", true);
-
-			ds::string_to_value<float>(destinationTokens[0], destination.x);
-			if (destinationTokens.size() > 1){
-				ds::string_to_value<float>(destinationTokens[1], destination.y);
-			}
-			if (destinationTokens.size() > 2){
-				ds::string_to_value<float>(destinationTokens[2], destination.z);
-			}
-		}
-
-		animationCommands[keyey] = destination;
-	}
-
 	//apply center first 
-	for (auto it = animationCommands.begin(); it != animationCommands.end(); ++it)
-	{
-		std::string animType = it->first;
-		ci::vec3 dest = it->second;
-		if (animType == "center"){
-			auto currentCenter = mOwner.getCenter();
-			if (ci::vec2(currentCenter) == ci::vec2(dest))
-				break;
-
+	if (script.mHasCenter){
+		const ci::vec3& dest = script.mCenter;
+		auto currentCenter = mOwner.getCenter();
+		if (ci::vec2(currentCenter) != ci::vec2(dest)){
 			mOwner.setCenter(dest.x, dest.y);
 			mOwner.setPosition((dest.x - currentCenter.x) * mOwner.getScaleWidth() + currentPos.x, (dest.y - currentCenter.y) * mOwner.getScaleHeight() + currentPos.y);
 			currentPos = mOwner.getPosition();
@@ -529,39 +490,42 @@ float SpriteAnimatable::runReversibleAnimationScript(const std::string& animScri
 	}
 
 	// now that we have all the commands, apply them
-	for (auto it = animationCommands.begin(); it != animationCommands.end(); ++it){
-		std::string animType = it->first;
-		ci::vec3 dest = it->second;
-		if (animType == "scale"){
+	for (auto it = script.mInstructions.begin(); it != script.mInstructions.end(); ++it){
+		const ci::vec3& dest = it->mValue;
+		switch (it->mOp){
+		case AnimationScript::SCALE:
 			tweenScale(dest, dur, delayey, easing);
-		}
-		else if (animType == "opacity"){
+			break;
+		case AnimationScript::OPACITY:
 			tweenOpacity(dest.x, dur, delayey, easing);
-		}
-		else if (animType == "position"){
+			break;
+		case AnimationScript::POSITION:
 			tweenPosition(dest, dur, delayey, easing);
-		}
-		else if (animType == "rotation"){
+			break;
+		case AnimationScript::ROTATION:
 			tweenRotation(dest, dur, delayey, easing);
-		}
-		else if (animType == "size"){
+			break;
+		case AnimationScript::SIZE:
 			tweenSize(dest, dur, delayey, easing);
-		}
-		else if (animType == "color"){
+			break;
+		case AnimationScript::COLOR:
 			tweenColor(ci::Color(dest.x, dest.y, dest.z), dur, delayey, easing);
-		}
-		else if (animType == "shift"){
+			break;
+		case AnimationScript::SHIFT:
 			tweenPosition(currentPos + dest, dur, delayey, easing);
-		}
-
-		if(!isReverse){
-			if (animType == "slide") {
+			break;
+		case AnimationScript::SLIDE:
+			if(!isReverse){
 				setAnimateOnTargetsIfNeeded();
 				mOwner.setPosition(mAnimateOnPositionTarget + dest);
 				tweenPosition(mAnimateOnPositionTarget, dur, delayey, easing);
-
+			} else {
+				mOwner.setPosition(mAnimateOnPositionTarget);
+				tweenPosition(mAnimateOnPositionTarget + dest, dur, delayey, easing);
 			}
-			else if (animType == "fade") {
+			break;
+		case AnimationScript::FADE:
+			if(!isReverse){
 				setAnimateOnTargetsIfNeeded();
 				if (dest.x == 0.0f) {
 					mOwner.setOpacity(0.0f);
@@ -570,9 +534,18 @@ float SpriteAnimatable::runReversibleAnimationScript(const std::string& animScri
 					mOwner.setOpacity(mAnimateOnOpacityTarget + dest.x);
 				}
 				tweenOpacity(mAnimateOnOpacityTarget, dur, delayey, easing);
-
+			} else {
+				mOwner.setOpacity(mAnimateOnOpacityTarget);
+				if (dest.x == 0.0f){
+					tweenOpacity(0.f, dur, delayey, easing);
+				}
+				else {
+					tweenOpacity(mAnimateOnOpacityTarget + dest.x, dur, delayey, easing);
+				}
 			}
-			else if (animType == "grow") {
+			break;
+		case AnimationScript::GROW:
+			if(!isReverse){
 				setAnimateOnTargetsIfNeeded();
 				if (dest.x == 0.0f && dest.y == 0.0f) {
 					mOwner.setScale(0.0f);
@@ -581,27 +554,7 @@ float SpriteAnimatable::runReversibleAnimationScript(const std::string& animScri
 					mOwner.setScale(mAnimateOnScaleTarget + dest);
 				}
 				tweenScale(mAnimateOnScaleTarget, dur, delayey, easing);
-			}
-		}else{
-			if (animType == "slide"){
-				//setAnimateOnTargetsIfNeeded();
-				mOwner.setPosition(mAnimateOnPositionTarget);
-				tweenPosition(mAnimateOnPositionTarget + dest, dur, delayey, easing);
-
-			}
-			else if (animType == "fade"){
-				//setAnimateOnTargetsIfNeeded();
-				mOwner.setOpacity(mAnimateOnOpacityTarget);
-				if (dest.x == 0.0f){
-					tweenOpacity(0.f, dur, delayey, easing);
-				}
-				else {
-					tweenOpacity(mAnimateOnOpacityTarget + dest.x, dur, delayey, easing);
-				}
-
-			}
-			else if (animType == "grow"){
-				//setAnimateOnTargetsIfNeeded();
+			} else {
 				mOwner.setScale(mAnimateOnScaleTarget);
 				if (dest.x == 0.0f && dest.y == 0.0f){
 					tweenScale(ci::vec3( 0.f ), dur, delayey, easing);
@@ -610,6 +563,7 @@ float SpriteAnimatable::runReversibleAnimationScript(const std::string& animScri
 					tweenScale(mAnimateOnScaleTarget + dest, dur, delayey, easing);
 				}
 			}
+			break;
 		}
 	}
 	
@@ -652,37 +606,11 @@ void SpriteAnimatable::parseMultiScripts(const std::vector<std::string> animScri
 
 	for (auto i = 0; i < animScripts.size(); i++)
 	{
-		// find all the commands in the string
-		std::vector<std::string> commands = ds::split(animScripts[i], "; ", true);
+		auto script = AnimationScript::get(animScripts[i]);
+		if (script->empty()) return;
 
-		if (commands.empty()) return;
-
-		// set default parameters, if they're not supplied by the string
-		ci::EaseFn easing = ci::EaseInOutCubic();
-		float dur = 0.35f;
-		float delayey = 0.0f;
-
-		// This maps tracks all the types (scale, position, etc) and their destinations (as 3d vectors)
-		std::map<std::string, ci::vec3> animationCommands;
-		for (auto it = commands.begin(); it < commands.end(); ++it){
-
-			// Split commands between the type and the destination
-			std::vector<std::string> commandProperties = ds::split((*it), ":", true);
-			if (commandProperties.empty() || commandProperties.size() < 1) continue;
-
-			// Parse out the special commands
-			std::string keyey = commandProperties.front();
-			if (keyey == "duration"){
-				ds::string_to_value<float>(commandProperties[1], dur);
-				continue;
-			}
-			else if (keyey == "delay"){
-				ds::string_to_value<float>(commandProperties[1], delayey);
-				continue;
-			}
-		}
-		durations.push_back(dur);
-		delays.push_back(delayey);
+		durations.push_back(script->getDuration(0.35f));
+		delays.push_back(script->getDelay());
 	}
 }
 
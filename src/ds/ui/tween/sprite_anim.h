@@ -2,6 +2,7 @@
 #ifndef DS_UI_TWEEN_SPRITEANIM_H_
 #define DS_UI_TWEEN_SPRITEANIM_H_
 
+#include <memory>
 #include <cinder/Color.h>
 #include <cinder/Easing.h>
 #include <cinder/Tween.h>
@@ -9,6 +10,7 @@
 
 namespace ds {
 namespace ui {
+class AnimationScript;
 class Sprite;
 class SpriteEngine;
 
@@ -169,8 +171,9 @@ public:
 
 	/** Parse the string as a script to run a few animations.
 		Syntax: `<type>:<valueX, valueY, valueZ>;`
+		Scripts are compiled once and cached (see AnimationScript), so running the same script repeatedly is cheap.
 		Special params: 
-			easing: see getEasingByString() implementation for details. Same easing applies to all tween types (opacity and position would use the same easing for instance, unfortunately)
+			ease: see getEasingByString() implementation for details. Same easing applies to all tween types (opacity and position would use the same easing for instance, unfortunately)
 			duration: in seconds
 			delay: in seconds
 			center: change center directly without changing position
@@ -178,13 +181,15 @@ public:
 			slide: tweens the position to the cached destination position, and offsets the start by the supplied values. Cache is created the first time slide, grow or fade is called. Call setAnimateOnTargets() to reset the cached targets.
 			grow: tweens the scale to the cached scale, and starts at the supplied value
 			fade: tweens the opacity to the cached opacity and starts at the supplied value
-		Example: "scale:1, 1, 1; position:100, 200, 300; opacity:1.0; color:0.5, 0.6, 1.0; rotation:0.0, 0.0, 90.0; size:20, 20; easing:inOutBack; duration:1.0; slide:-100; delay:0.5"
+		Example: "scale:1, 1, 1; position:100, 200, 300; opacity:1.0; color:0.5, 0.6, 1.0; rotation:0.0, 0.0, 90.0; size:20, 20; ease:inOutBack; duration:1.0; slide:-100; delay:0.5"
 		*/
 	float									runAnimationScript(const std::string& animScript, const float addedDelay = 0.0f);
 	float									runAnimationOffScript(const std::string& animScript, const float addedDelay = 0.0f);
 
 	/// Run an animation script from current values to animateOnTargets OR from targets to  current/off state (reversible)
 	float									runReversibleAnimationScript(const std::string& animScript, const float addedDelay = 0.f, const bool isReverse = false);
+	/// Run an already compiled script, see AnimationScript::get()
+	float									runReversibleAnimationScript(const AnimationScript&, const float addedDelay = 0.f, const bool isReverse = false);
 
 	void									runMultiAnimationScripts(const std::vector<std::string> animScripts, const float gapTime, const float addedDelay = 0.0f);
 	void									parseMultiScripts(const std::vector<std::string> animScripts, std::vector<float>& durations, std::vector<float>& delays);
@@ -208,8 +213,10 @@ private:
 	SpriteEngine&							mEngine;
 
 	std::string								mAnimateOffScript;
+	std::shared_ptr<const AnimationScript>	mAnimateOffCompiled;
 
 	std::string								mAnimateOnScript;
+	std::shared_ptr<const AnimationScript>	mAnimateOnCompiled;
 	bool									mAnimateOnTargetsSet;
 	ci::vec3								mAnimateOnScaleTarget;
 	ci::vec3								mAnimateOnPositionTarget;
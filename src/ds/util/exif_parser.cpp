@@ -0,0 +1,422 @@
+#include "stdafx.h"
+
+#include "ds/util/exif_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+
+#include <ds/debug/logger.h>
+
+namespace ds {
+
+namespace {
+const int				MAX_JPEG_SEGMENTS = 1024;
+// Real tables have a few dozen entries. Anything past this is garbage, or someone trying to make us spin
+const uint32_t			MAX_IFD_ENTRIES = 1024;
+const size_t			IFD_ENTRY_SIZE = 12;
+
+const uint16_t			TYPE_BYTE = 1;
+const uint16_t			TYPE_ASCII = 2;
+const uint16_t			TYPE_SHORT = 3;
+const uint16_t			TYPE_LONG = 4;
+const uint16_t			TYPE_RATIONAL = 5;
+const uint16_t			TYPE_SBYTE = 6;
+const uint16_t			TYPE_UNDEFINED = 7;
+const uint16_t			TYPE_SSHORT = 8;
+const uint16_t			TYPE_SLONG = 9;
+const uint16_t			TYPE_SRATIONAL = 10;
+const uint16_t			TYPE_FLOAT = 11;
+const uint16_t			TYPE_DOUBLE = 12;
+const uint16_t			TYPE_IFD = 13;
+
+// Bytes per value, or 0 for types we don't know
+size_t					type_size(const uint16_t type) {
+	switch(type) {
+	case TYPE_BYTE: case TYPE_ASCII: case TYPE_SBYTE: case TYPE_UNDEFINED: return 1;
+	case TYPE_SHORT: case TYPE_SSHORT: return 2;
+	case TYPE_LONG: case TYPE_SLONG: case TYPE_FLOAT: case TYPE_IFD: return 4;
+	case TYPE_RATIONAL: case TYPE_SRATIONAL: case TYPE_DOUBLE: return 8;
+	default: return 0;
+	}
+}
+
+bool					is_integer_type(const uint16_t type) {
+	return type == TYPE_BYTE || type == TYPE_SHORT || type == TYPE_LONG || type == TYPE_SBYTE
+		|| type == TYPE_SSHORT || type == TYPE_SLONG || type == TYPE_IFD;
+}
+
+unsigned				read_16_be(const unsigned char* b) {
+	return (b[0] << 8) | b[1];
+}
+
+// Degrees, minutes and seconds, turned negative by a reference of negativeRef ('S' or 'W')
+bool					read_coordinate(const ExifParser& parser, const uint16_t tag, const uint16_t refTag, const char negativeRef, double& degrees) {
+	double d = 0.0, m = 0.0, s = 0.0;
+	if(!parser.getDouble(ExifParser::IFD_GPS, tag, d, 0)) return false;
+	parser.getDouble(ExifParser::IFD_GPS, tag, m, 1);
+	parser.getDouble(ExifParser::IFD_GPS, tag, s, 2);
+
+	degrees = d + m / 60.0 + s / 3600.0;
+	std::string ref;
+	if(parser.getString(ExifParser::IFD_GPS, refTag, ref) && !ref.empty() && ref[0] == negativeRef) degrees = -degrees;
+	return true;
+}
+}
+
+/**
+ * \class ExifParser
+ */
+ExifParser::ExifParser()
+	: mTiff(nullptr)
+	, mTiffSize(0)
+	, mLittleEndian(false)
+{
+}
+
+bool ExifParser::open(const std::string& filePath) {
+	close();
+
+	try {
+		Poco::File file(filePath);
+		if(!file.exists() || !file.isFile() || file.getSize() == 0) return false;
+
+		// Read-only and shared, so nothing is copied until the pages holding the tags are touched
+		std::shared_ptr<Poco::SharedMemory> mapping = std::make_shared<Poco::SharedMemory>(file, Poco::SharedMemory::AM_READ);
+		const unsigned char* data = reinterpret_cast<const unsigned char*>(mapping->begin());
+		if(!open(data, static_cast<size_t>(mapping->end() - mapping->begin()))) return false;
+
+		mMapping = mapping;
+		return true;
+	} catch(std::exception& ex) {
+		DS_LOG_VERBOSE(1, "ExifParser::open couldn't map " << filePath << ": " << ex.what());
+	}
+
+	close();
+	return false;
+}
+
+bool ExifParser::open(const unsigned char* data, const size_t size) {
+	close();
+	if(!data || size < 8) return false;
+
+	// A TIFF file is all one TIFF block
+	if((data[0] == 'I' && data[1] == 'I' && data[2] == 42 && data[3] == 0) || (data[0] == 'M' && data[1] == 'M' && data[2] == 0 && data[3] == 42)) {
+		return indexTiff(data, size);
+	}
+
+	if(memcmp(data, "Exif\0\0", 6) == 0) {
+		return indexTiff(data + 6, size - 6);
+	}
+
+	if(data[0] != 0xFF || data[1] != 0xD8) return false;
+
+	// Walk the segments up to the image data, looking for the APP1 block that starts with "Exif\0\0"
+	size_t pos = 2;
+	for(int i = 0; i < MAX_JPEG_SEGMENTS && pos + 4 <= size; ++i) {
+		if(data[pos] != 0xFF) return false;
+
+		const unsigned char marker = data[pos + 1];
+		// Fill bytes, and markers that have no length
+		if(marker == 0xFF) { ++pos; continue; }
+		if(marker == 0x01 || marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7)) { pos += 2; continue; }
+		// Start of scan or end of image, so there's no EXIF block
+		if(marker == 0xDA || marker == 0xD9) return false;
+
+		const size_t length = read_16_be(data + pos + 2);
+		if(length < 2 || length > size - pos - 2) return false;
+
+		const unsigned char* segment = data + pos + 4;
+		const size_t segmentSize = length - 2;
+		if(marker == 0xE1 && segmentSize >= 6 && memcmp(segment, "Exif\0\0", 6) == 0) {
+			return indexTiff(segment + 6, segmentSize - 6);
+		}
+
+		pos += 2 + length;
+	}
+
+	return false;
+}
+
+void ExifParser::close() {
+	mTiff = nullptr;
+	mTiffSize = 0;
+	mLittleEndian = false;
+	mEntries.clear();
+	mMapping.reset();
+}
+
+bool ExifParser::hasTag(const Ifd ifd, const uint16_t tag) const {
+	return find(ifd, tag) != nullptr;
+}
+
+bool ExifParser::getString(const Ifd ifd, const uint16_t tag, std::string& value) const {
+	const Entry* e = find(ifd, tag);
+	if(!e || (e->mType != TYPE_ASCII && e->mType != TYPE_UNDEFINED && e->mType != TYPE_BYTE)) return false;
+
+	const char* s = reinterpret_cast<const char*>(mTiff + e->mOffset);
+	const void* nul = memchr(s, 0, e->mCount);
+	value.assign(s, nul ? static_cast<const char*>(nul) - s : e->mCount);
+	return true;
+}
+
+bool ExifParser::getInt(const Ifd ifd, const uint16_t tag, int64_t& value, const size_t index) const {
+	const Entry* e = find(ifd, tag);
+	return e && readInteger(*e, index, value);
+}
+
+bool ExifParser::getDouble(const Ifd ifd, const uint16_t tag, double& value, const size_t index) const {
+	const Entry* e = find(ifd, tag);
+	return e && readNumber(*e, index, value);
+}
+
+std::string ExifParser::getText(const Ifd ifd, const uint16_t tag) const {
+	std::string text;
+	const Entry* e = find(ifd, tag);
+	if(!e) return text;
+
+	if(e->mType == TYPE_ASCII || e->mType == TYPE_UNDEFINED) {
+		getString(ifd, tag, text);
+		return text;
+	}
+
+	char number[32];
+	for(uint32_t i = 0; i < e->mCount; ++i) {
+		if(i > 0) text.push_back(' ');
+
+		int64_t integer = 0;
+		double real = 0.0;
+		if(readInteger(*e, i, integer)) {
+			snprintf(number, sizeof(number), "%lld", static_cast<long long>(integer));
+		} else if(readNumber(*e, i, real)) {
+			snprintf(number, sizeof(number), "%g", real);
+		} else {
+			number[0] = 0;
+		}
+		text.append(number);
+	}
+	return text;
+}
+
+int ExifParser::getOrientation() const {
+	int64_t orientation = 0;
+	if(!getInt(IFD_IMAGE, TAG_ORIENTATION, orientation) || orientation < 1 || orientation > 8) return 1;
+	return static_cast<int>(orientation);
+}
+
+bool ExifParser::getImageSize(int& width, int& height) const {
+	int64_t w = 0, h = 0;
+	if(!getInt(IFD_EXIF, TAG_PIXEL_WIDTH, w) || !getInt(IFD_EXIF, TAG_PIXEL_HEIGHT, h) || w <= 0 || h <= 0) {
+		if(!getInt(IFD_IMAGE, TAG_IMAGE_WIDTH, w) || !getInt(IFD_IMAGE, TAG_IMAGE_HEIGHT, h)) return false;
+	}
+	if(w <= 0 || h <= 0 || w > INT32_MAX || h > INT32_MAX) return false;
+
+	width = static_cast<int>(w);
+	height = static_cast<int>(h);
+	return true;
+}
+
+bool ExifParser::getLatitude(double& degrees) const {
+	return read_coordinate(*this, TAG_GPS_LATITUDE, TAG_GPS_LATITUDE_REF, 'S', degrees);
+}
+
+bool ExifParser::getLongitude(double& degrees) const {
+	return read_coordinate(*this, TAG_GPS_LONGITUDE, TAG_GPS_LONGITUDE_REF, 'W', degrees);
+}
+
+void ExifParser::forEachFile(const std::vector<std::string>& filePaths, const std::function<void(const size_t index, const ExifParser&)>& fn, unsigned threads) {
+	if(filePaths.empty() || !fn) return;
+
+	if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = static_cast<unsigned>(std::min<size_t>(threads, filePaths.size()));
+
+	// Each worker takes the next file until there aren't any, so a few slow files don't hold up the rest
+	std::atomic<size_t> next(0);
+	auto work = [&filePaths, &fn, &next]() {
+		ExifParser parser;
+		for(size_t i = next++; i < filePaths.size(); i = next++) {
+			if(parser.open(filePaths[i])) fn(i, parser);
+		}
+	};
+
+	if(threads <= 1) {
+		work();
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for(unsigned i = 1; i < threads; ++i) {
+		workers.push_back(std::thread(work));
+	}
+	work();
+	for(auto it = workers.begin(), end = workers.end(); it != end; ++it) {
+		it->join();
+	}
+}
+
+std::vector<std::vector<std::string>> ExifParser::readTags(const std::vector<std::string>& filePaths, const std::vector<TagId>& tags, const unsigned threads) {
+	std::vector<std::vector<std::string>> values(filePaths.size(), std::vector<std::string>(tags.size()));
+
+	// Each file only writes its own row, so there's nothing to lock
+	forEachFile(filePaths, [&values, &tags](const size_t index, const ExifParser& parser) {
+		std::vector<std::string>& row = values[index];
+		for(size_t i = 0; i < tags.size(); ++i) {
+			row[i] = parser.getText(tags[i].mIfd, tags[i].mTag);
+		}
+	}, threads);
+
+	return values;
+}
+
+bool ExifParser::indexTiff(const unsigned char* tiff, const size_t size) {
+	// Offsets in the block are 32 bits, so anything past that can't be pointed at
+	if(size < 8 || size > UINT32_MAX) return false;
+
+	if(tiff[0] == 'I' && tiff[1] == 'I') mLittleEndian = true;
+	else if(tiff[0] == 'M' && tiff[1] == 'M') mLittleEndian = false;
+	else return false;
+
+	mTiff = tiff;
+	mTiffSize = size;
+	if(read16(2) != 42) {
+		close();
+		return false;
+	}
+
+	indexIfd(IFD_IMAGE, read32(4));
+
+	// The EXIF and GPS tables hang off the image table. Each is only followed once, so they can't loop
+	uint32_t exifOffset = 0, gpsOffset = 0;
+	if(const Entry* e = find(IFD_IMAGE, TAG_EXIF_IFD)) {
+		if(e->mCount == 1 && (e->mType == TYPE_LONG || e->mType == TYPE_IFD)) exifOffset = read32(e->mOffset);
+	}
+	if(const Entry* e = find(IFD_IMAGE, TAG_GPS_IFD)) {
+		if(e->mCount == 1 && (e->mType == TYPE_LONG || e->mType == TYPE_IFD)) gpsOffset = read32(e->mOffset);
+	}
+	if(exifOffset) indexIfd(IFD_EXIF, exifOffset);
+	if(gpsOffset) indexIfd(IFD_GPS, gpsOffset);
+
+	// Stable, so a duplicated tag finds the first one, like a reader going down the table would
+	std::stable_sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b) {
+		return a.mIfd < b.mIfd || (a.mIfd == b.mIfd && a.mTag < b.mTag);
+	});
+	return true;
+}
+
+void ExifParser::indexIfd(const Ifd ifd, const uint32_t offset) {
+	if(offset < 8 || offset > mTiffSize - 2) return;
+
+	// Only the entries that fit in the block count
+	const size_t room = (mTiffSize - offset - 2) / IFD_ENTRY_SIZE;
+	const size_t count = std::min<size_t>(std::min<size_t>(read16(offset), room), MAX_IFD_ENTRIES);
+
+	mEntries.reserve(mEntries.size() + count);
+	for(size_t i = 0; i < count; ++i) {
+		const size_t at = offset + 2 + i * IFD_ENTRY_SIZE;
+
+		Entry e;
+		e.mIfd = static_cast<uint8_t>(ifd);
+		e.mTag = read16(at);
+		e.mType = read16(at + 2);
+		e.mCount = read32(at + 4);
+
+		const size_t typeSize = type_size(e.mType);
+		if(typeSize == 0 || e.mCount == 0) continue;
+
+		// Values of 4 bytes or less are stored in the entry. Bigger ones are somewhere else in the block
+		const uint64_t valueSize = static_cast<uint64_t>(typeSize) * e.mCount;
+		if(valueSize <= 4) {
+			e.mOffset = static_cast<uint32_t>(at + 8);
+		} else {
+			e.mOffset = read32(at + 8);
+			if(valueSize > mTiffSize || e.mOffset > mTiffSize - valueSize) continue;
+		}
+
+		mEntries.push_back(e);
+	}
+}
+
+const ExifParser::Entry* ExifParser::find(const Ifd ifd, const uint16_t tag) const {
+	auto it = std::lower_bound(mEntries.begin(), mEntries.end(), std::make_pair(static_cast<uint8_t>(ifd), tag), [](const Entry& e, const std::pair<uint8_t, uint16_t>& key) {
+		return e.mIfd < key.first || (e.mIfd == key.first && e.mTag < key.second);
+	});
+	if(it == mEntries.end() || it->mIfd != ifd || it->mTag != tag) return nullptr;
+	return &*it;
+}
+
+bool ExifParser::readInteger(const Entry& e, const size_t index, int64_t& value) const {
+	if(index >= e.mCount || !is_integer_type(e.mType)) return false;
+
+	const size_t at = e.mOffset + index * type_size(e.mType);
+	switch(e.mType) {
+	case TYPE_BYTE: value = mTiff[at]; break;
+	case TYPE_SBYTE: value = static_cast<int8_t>(mTiff[at]); break;
+	case TYPE_SHORT: value = read16(at); break;
+	case TYPE_SSHORT: value = static_cast<int16_t>(read16(at)); break;
+	case TYPE_SLONG: value = static_cast<int32_t>(read32(at)); break;
+	default: value = read32(at); break;
+	}
+	return true;
+}
+
+bool ExifParser::readNumber(const Entry& e, const size_t index, double& value) const {
+	int64_t integer = 0;
+	if(readInteger(e, index, integer)) {
+		value = static_cast<double>(integer);
+		return true;
+	}
+	if(index >= e.mCount) return false;
+
+	const size_t at = e.mOffset + index * type_size(e.mType);
+	switch(e.mType) {
+	case TYPE_RATIONAL: {
+		const uint32_t denominator = read32(at + 4);
+		if(denominator == 0) return false;
+		value = static_cast<double>(read32(at)) / denominator;
+		return true;
+	}
+	case TYPE_SRATIONAL: {
+		const int32_t denominator = static_cast<int32_t>(read32(at + 4));
+		if(denominator == 0) return false;
+		value = static_cast<double>(static_cast<int32_t>(read32(at))) / denominator;
+		return true;
+	}
+	case TYPE_FLOAT: {
+		const uint32_t bits = read32(at);
+		float f = 0.0f;
+		memcpy(&f, &bits, sizeof(f));
+		value = f;
+		return true;
+	}
+	case TYPE_DOUBLE: {
+		const uint64_t high = read32(mLittleEndian ? at + 4 : at);
+		const uint64_t low = read32(mLittleEndian ? at : at + 4);
+		const uint64_t bits = (high << 32) | low;
+		memcpy(&value, &bits, sizeof(value));
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+uint16_t ExifParser::read16(const size_t offset) const {
+	if(offset > mTiffSize - 2) return 0;
+	const unsigned char* b = mTiff + offset;
+	return static_cast<uint16_t>(mLittleEndian ? (b[0] | (b[1] << 8)) : ((b[0] << 8) | b[1]));
+}
+
+uint32_t ExifParser::read32(const size_t offset) const {
+	if(offset > mTiffSize - 4) return 0;
+	const unsigned char* b = mTiff + offset;
+	if(mLittleEndian) return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+	return (static_cast<uint32_t>(b[0]) << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+} // namespace ds
@@ -0,0 +1,153 @@
+#pragma once
+#ifndef DS_UTIL_EXIFPARSER_H_
+#define DS_UTIL_EXIFPARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Poco {
+class SharedMemory;
+}
+
+namespace ds {
+
+/**
+ * \class ExifParser
+ * \brief Reads the EXIF tags of a jpeg, or the tags of a TIFF file.
+ *        Files are memory mapped instead of read, and open() only indexes the tag tables (the image, EXIF and GPS IFDs).
+ *        Values are decoded when they're asked for, so asking for the orientation doesn't cost a pass over every string.
+ *        Every offset in the file is checked before it's used: broken files give missing tags, not crashes.
+ *        Once open, the getters don't change anything and can be called from any thread.
+ */
+class ExifParser {
+public:
+	/// Which table a tag is in. The same number can mean something different in each.
+	enum Ifd { IFD_IMAGE = 0, IFD_EXIF, IFD_GPS };
+
+	/// Some common tags. Any tag number can be asked for.
+	enum Tag {
+		TAG_IMAGE_WIDTH = 0x0100,
+		TAG_IMAGE_HEIGHT = 0x0101,
+		TAG_BITS_PER_SAMPLE = 0x0102,
+		TAG_IMAGE_DESCRIPTION = 0x010e,
+		TAG_MAKE = 0x010f,
+		TAG_MODEL = 0x0110,
+		TAG_ORIENTATION = 0x0112,
+		TAG_SOFTWARE = 0x0131,
+		TAG_DATE_TIME = 0x0132,
+		TAG_COPYRIGHT = 0x8298,
+		TAG_EXIF_IFD = 0x8769,
+		TAG_GPS_IFD = 0x8825,
+
+		/// In IFD_EXIF
+		TAG_EXPOSURE_TIME = 0x829a,
+		TAG_F_NUMBER = 0x829d,
+		TAG_ISO_SPEED = 0x8827,
+		TAG_DATE_TIME_ORIGINAL = 0x9003,
+		TAG_DATE_TIME_DIGITIZED = 0x9004,
+		TAG_SHUTTER_SPEED = 0x9201,
+		TAG_EXPOSURE_BIAS = 0x9204,
+		TAG_SUBJECT_DISTANCE = 0x9206,
+		TAG_METERING_MODE = 0x9207,
+		TAG_FLASH = 0x9209,
+		TAG_FOCAL_LENGTH = 0x920a,
+		TAG_SUB_SEC_TIME_ORIGINAL = 0x9291,
+		TAG_PIXEL_WIDTH = 0xa002,
+		TAG_PIXEL_HEIGHT = 0xa003,
+		TAG_FOCAL_PLANE_X_RESOLUTION = 0xa20e,
+		TAG_FOCAL_PLANE_Y_RESOLUTION = 0xa20f,
+		TAG_FOCAL_LENGTH_35MM = 0xa405,
+		TAG_LENS_INFO = 0xa432,
+		TAG_LENS_MAKE = 0xa433,
+		TAG_LENS_MODEL = 0xa434,
+
+		/// In IFD_GPS
+		TAG_GPS_LATITUDE_REF = 0x0001,
+		TAG_GPS_LATITUDE = 0x0002,
+		TAG_GPS_LONGITUDE_REF = 0x0003,
+		TAG_GPS_LONGITUDE = 0x0004,
+		TAG_GPS_ALTITUDE_REF = 0x0005,
+		TAG_GPS_ALTITUDE = 0x0006,
+		TAG_GPS_DOP = 0x000b
+	};
+
+	struct TagId {
+		TagId(const Ifd ifd, const uint16_t tag) : mIfd(ifd), mTag(tag) {}
+
+		Ifd						mIfd;
+		uint16_t				mTag;
+	};
+
+	ExifParser();
+
+	/// Maps the file and indexes its tags. False if it's not a jpeg with EXIF data, or a TIFF file.
+	bool						open(const std::string& filePath);
+	/// Same as above for a file that's already in memory, or an EXIF block (starting with "Exif\0\0").
+	/// The data isn't copied, so it has to stay around until this is closed or opened again.
+	bool						open(const unsigned char* data, const size_t size);
+	void						close();
+
+	bool						isOpen() const { return mTiff != nullptr; }
+	/// How many tags are in all the tables together
+	size_t						getTagCount() const { return mEntries.size(); }
+	bool						hasTag(const Ifd ifd, const uint16_t tag) const;
+
+	/// ASCII or UNDEFINED tags, up to the first null
+	bool						getString(const Ifd ifd, const uint16_t tag, std::string& value) const;
+	/// BYTE, SHORT or LONG tags, signed or not. index picks a value from tags that have more than one.
+	bool						getInt(const Ifd ifd, const uint16_t tag, int64_t& value, const size_t index = 0) const;
+	/// Any number, including RATIONAL and FLOAT tags. False for a fraction over zero.
+	bool						getDouble(const Ifd ifd, const uint16_t tag, double& value, const size_t index = 0) const;
+	/// Any tag as text, with numbers separated by spaces. Empty if the tag isn't there.
+	std::string					getText(const Ifd ifd, const uint16_t tag) const;
+
+	/// 1 (upright) through 8. 1 if the file doesn't say, or says something out of range.
+	int							getOrientation() const;
+	/// The size from the EXIF table, or the image table for TIFFs. The orientation isn't applied.
+	bool						getImageSize(int& width, int& height) const;
+	/// Decimal degrees, negative for south and west
+	bool						getLatitude(double& degrees) const;
+	bool						getLongitude(double& degrees) const;
+
+	/// Opens each file on a few worker threads and calls fn for the ones that opened.
+	/// fn runs on the workers, so it has to be thread safe and shouldn't throw. 0 threads is one per core.
+	static void					forEachFile(const std::vector<std::string>& filePaths, const std::function<void(const size_t index, const ExifParser&)>& fn, unsigned threads = 0);
+	/// getText() of each tag for each file, in the same order as filePaths then tags. Empty strings for anything missing.
+	static std::vector<std::vector<std::string>>
+								readTags(const std::vector<std::string>& filePaths, const std::vector<TagId>& tags, const unsigned threads = 0);
+
+private:
+	struct Entry {
+		uint8_t					mIfd;
+		uint16_t				mTag;
+		uint16_t				mType;
+		uint32_t				mCount;
+		/// Where the value starts, from the start of the TIFF header. The whole value is known to be in bounds.
+		uint32_t				mOffset;
+	};
+
+	bool						indexTiff(const unsigned char* tiff, const size_t size);
+	void						indexIfd(const Ifd ifd, const uint32_t offset);
+	const Entry*				find(const Ifd ifd, const uint16_t tag) const;
+	bool						readNumber(const Entry&, const size_t index, double& value) const;
+	bool						readInteger(const Entry&, const size_t index, int64_t& value) const;
+	uint16_t					read16(const size_t offset) const;
+	uint32_t					read32(const size_t offset) const;
+
+	/// Keeps a mapped file open while tags are read from it
+	std::shared_ptr<Poco::SharedMemory>
+								mMapping;
+	const unsigned char*		mTiff;
+	size_t						mTiffSize;
+	bool						mLittleEndian;
+	/// Sorted by table, then tag
+	std::vector<Entry>			mEntries;
+};
+
+} // namespace ds
+
+#endif // DS_UTIL_EXIFPARSER_H_
@@ -1,5 +1,5 @@
 #include <stdio.h>
-#include "exif.h"
+#include "exif_parser.h"
 #include <ds/debug/logger.h>
 
 namespace ds {
@@ -7,119 +7,85 @@ namespace ds {
 class ExifHelper {
 public:
 /// Returns true if exif was found and w/h is valid (above zero)
+/// The file is mapped and only the EXIF block is read (see ds::ExifParser). For the size of any image, see ds::ImageProbe
 static bool getImageSize(const std::string filePath, int& outWidth, int& outHeight){
 	FILE *fp = fopen(filePath.c_str(), "rb");
 	if(!fp) {
 		DS_LOG_WARNING("Can't open file for exif data. " << filePath);
 		return false;
 	}
-	fseek(fp, 0, SEEK_END);
-	unsigned long fsize = ftell(fp);
-	rewind(fp);
-	unsigned char *buf = new unsigned char[fsize];
-	if(fread(buf, 1, fsize, fp) != fsize) {
-		DS_LOG_WARNING("Can't read file for exif data. " << filePath);
-		delete[] buf;
-		return false;
-	}
 	fclose(fp);
 
-	/// Parse EXIF
-	easyexif::EXIFInfo result;
-	int code = result.parseFrom(buf, fsize);
-	delete[] buf;
-	if(code) {
-		if(code == 1983){
-			/// this means the file didn't have any exif. Bummer. ignore it, no reason to log it.
-		} else {
-			DS_LOG_WARNING("Error parsing EXIF: code " << code << " for filepath: " << filePath);
-		}
+	/// A file without EXIF isn't an error, so that's not logged
+	ExifParser exif;
+	if(!exif.open(filePath)) {
 		return false;
 	}
 
-	outWidth = result.ImageWidth;
-	outHeight = result.ImageHeight;
-
-	if(outHeight < 1 || outWidth < 1){
-		return false;
-	}
-
-	return true;
+	outWidth = 0;
+	outHeight = 0;
+	return exif.getImageSize(outWidth, outHeight);
 }
 
 /// Prints out all the exif data
 static int printExifData(std::string filePath) {
 
-	/// Read the JPEG file into a buffer
-	FILE *fp = fopen(filePath.c_str(), "rb");
-	if(!fp) {
-		printf("Can't open file.\n");
-		return -1;
-	}
-	fseek(fp, 0, SEEK_END);
-	unsigned long fsize = ftell(fp);
-	rewind(fp);
-	unsigned char *buf = new unsigned char[fsize];
-	if(fread(buf, 1, fsize, fp) != fsize) {
-		printf("Can't read file.\n");
-		delete[] buf;
-		return -2;
-	}
-	fclose(fp);
-
-	/// Parse EXIF
-	easyexif::EXIFInfo result;
-	int code = result.parseFrom(buf, fsize);
-	delete[] buf;
-	if(code) {
-		printf("Error parsing EXIF: code %d\n", code);
+	/// Maps the file and indexes the tags, see ds::ExifParser
+	ExifParser exif;
+	if(!exif.open(filePath)) {
+		printf("Can't read EXIF data.\n");
 		return -3;
 	}
 
+	const auto text = [&exif](const ExifParser::Ifd ifd, const uint16_t tag) { return exif.getText(ifd, tag); };
+	const auto number = [&exif](const ExifParser::Ifd ifd, const uint16_t tag, const size_t index) {
+		double value = 0.0;
+		exif.getDouble(ifd, tag, value, index);
+		return value;
+	};
+
+	int width = 0, height = 0;
+	exif.getImageSize(width, height);
+	double latitude = 0.0, longitude = 0.0;
+	exif.getLatitude(latitude);
+	exif.getLongitude(longitude);
+	const double exposure = number(ExifParser::IFD_EXIF, ExifParser::TAG_EXPOSURE_TIME, 0);
+
 	/// Dump EXIF information
-	printf("Camera make          : %s\n", result.Make.c_str());
-	printf("Camera model         : %s\n", result.Model.c_str());
-	printf("Software             : %s\n", result.Software.c_str());
-	printf("Bits per sample      : %d\n", result.BitsPerSample);
-	printf("Image width          : %d\n", result.ImageWidth);
-	printf("Image height         : %d\n", result.ImageHeight);
-	printf("Image description    : %s\n", result.ImageDescription.c_str());
-	printf("Image orientation    : %d\n", result.Orientation);
-	printf("Image copyright      : %s\n", result.Copyright.c_str());
-	printf("Image date/time      : %s\n", result.DateTime.c_str());
-	printf("Original date/time   : %s\n", result.DateTimeOriginal.c_str());
-	printf("Digitize date/time   : %s\n", result.DateTimeDigitized.c_str());
-	printf("Subsecond time       : %s\n", result.SubSecTimeOriginal.c_str());
-	printf("Exposure time        : 1/%d s\n",
-			(unsigned)(1.0 / result.ExposureTime));
-	printf("F-stop               : f/%.1f\n", result.FNumber);
-	printf("ISO speed            : %d\n", result.ISOSpeedRatings);
-	printf("Subject distance     : %f m\n", result.SubjectDistance);
-	printf("Exposure bias        : %f EV\n", result.ExposureBiasValue);
-	printf("Flash used?          : %d\n", result.Flash);
-	printf("Metering mode        : %d\n", result.MeteringMode);
-	printf("Lens focal length    : %f mm\n", result.FocalLength);
-	printf("35mm focal length    : %u mm\n", result.FocalLengthIn35mm);
-	printf("GPS Latitude         : %f deg (%f deg, %f min, %f sec %c)\n",
-			result.GeoLocation.Latitude, result.GeoLocation.LatComponents.degrees,
-			result.GeoLocation.LatComponents.minutes,
-			result.GeoLocation.LatComponents.seconds,
-			result.GeoLocation.LatComponents.direction);
-	printf("GPS Longitude        : %f deg (%f deg, %f min, %f sec %c)\n",
-			result.GeoLocation.Longitude, result.GeoLocation.LonComponents.degrees,
-			result.GeoLocation.LonComponents.minutes,
-			result.GeoLocation.LonComponents.seconds,
-			result.GeoLocation.LonComponents.direction);
-	printf("GPS Altitude         : %f m\n", result.GeoLocation.Altitude);
-	printf("GPS Precision (DOP)  : %f\n", result.GeoLocation.DOP);
-	printf("Lens min focal length: %f mm\n", result.LensInfo.FocalLengthMin);
-	printf("Lens max focal length: %f mm\n", result.LensInfo.FocalLengthMax);
-	printf("Lens f-stop min      : f/%.1f\n", result.LensInfo.FStopMin);
-	printf("Lens f-stop max      : f/%.1f\n", result.LensInfo.FStopMax);
-	printf("Lens make            : %s\n", result.LensInfo.Make.c_str());
-	printf("Lens model           : %s\n", result.LensInfo.Model.c_str());
-	printf("Focal plane XRes     : %f\n", result.LensInfo.FocalPlaneXResolution);
-	printf("Focal plane YRes     : %f\n", result.LensInfo.FocalPlaneYResolution);
+	printf("Camera make          : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_MAKE).c_str());
+	printf("Camera model         : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_MODEL).c_str());
+	printf("Software             : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_SOFTWARE).c_str());
+	printf("Bits per sample      : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_BITS_PER_SAMPLE).c_str());
+	printf("Image width          : %d\n", width);
+	printf("Image height         : %d\n", height);
+	printf("Image description    : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_IMAGE_DESCRIPTION).c_str());
+	printf("Image orientation    : %d\n", exif.getOrientation());
+	printf("Image copyright      : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_COPYRIGHT).c_str());
+	printf("Image date/time      : %s\n", text(ExifParser::IFD_IMAGE, ExifParser::TAG_DATE_TIME).c_str());
+	printf("Original date/time   : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_DATE_TIME_ORIGINAL).c_str());
+	printf("Digitize date/time   : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_DATE_TIME_DIGITIZED).c_str());
+	printf("Subsecond time       : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_SUB_SEC_TIME_ORIGINAL).c_str());
+	printf("Exposure time        : 1/%d s\n", exposure > 0.0 ? static_cast<int>(1.0 / exposure + 0.5) : 0);
+	printf("F-stop               : f/%.1f\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_F_NUMBER, 0));
+	printf("ISO speed            : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_ISO_SPEED).c_str());
+	printf("Subject distance     : %f m\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_SUBJECT_DISTANCE, 0));
+	printf("Exposure bias        : %f EV\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_EXPOSURE_BIAS, 0));
+	printf("Flash                : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_FLASH).c_str());
+	printf("Metering mode        : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_METERING_MODE).c_str());
+	printf("Lens focal length    : %f mm\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_FOCAL_LENGTH, 0));
+	printf("35mm focal length    : %s mm\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_FOCAL_LENGTH_35MM).c_str());
+	printf("GPS Latitude         : %f deg\n", latitude);
+	printf("GPS Longitude        : %f deg\n", longitude);
+	printf("GPS Altitude         : %f m\n", number(ExifParser::IFD_GPS, ExifParser::TAG_GPS_ALTITUDE, 0));
+	printf("GPS Precision (DOP)  : %f\n", number(ExifParser::IFD_GPS, ExifParser::TAG_GPS_DOP, 0));
+	printf("Lens min focal length: %f mm\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_INFO, 0));
+	printf("Lens max focal length: %f mm\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_INFO, 1));
+	printf("Lens f-stop min      : f/%.1f\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_INFO, 2));
+	printf("Lens f-stop max      : f/%.1f\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_INFO, 3));
+	printf("Lens make            : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_MAKE).c_str());
+	printf("Lens model           : %s\n", text(ExifParser::IFD_EXIF, ExifParser::TAG_LENS_MODEL).c_str());
+	printf("Focal plane XRes     : %f\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_FOCAL_PLANE_X_RESOLUTION, 0));
+	printf("Focal plane YRes     : %f\n", number(ExifParser::IFD_EXIF, ExifParser::TAG_FOCAL_PLANE_Y_RESOLUTION, 0));
 
 	return 0;
 }
@@ -64,6 +64,11 @@ void IdleTimer::update()
 		mIdling = (mEngine.getElapsedTimeSeconds() - mStartTime) > mIdleTime;
 }
 
+bool IdleTimer::isActive() const
+{
+	return mActive && mSetup;
+}
+
 void IdleTimer::clear()
 {
 	mActive = false;
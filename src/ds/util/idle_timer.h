@@ -17,6 +17,8 @@ public:
 	void    startIdling();
 	void    resetIdleTimer();
 	void    clear();
+	/// Whether there's a timer running, which needs update() every frame
+	bool    isActive() const;
 	void    update();
 private:
 	ui::SpriteEngine     &mEngine;
@@ -6,148 +6,24 @@
 #include <cinder/ImageIo.h>
 #include <cinder/Surface.h>
 #include <Poco/File.h>
-#include <Poco/Path.h>
-#include <Poco/String.h>
 #include "ds/app/environment.h"
 #include "ds/debug/logger.h"
 #include "ds/storage/persistent_cache.h"
 #include "ds/util/file_meta_data.h"
 #include "ds/debug/debug_defines.h"
 
-#include "ds/util/exif_reader.h"
+#include "ds/util/image_probe.h"
 
 namespace ds {
 
 namespace {
 
-// Should have universal formats somewhere
-const int					FORMAT_UNKNOWN = 0;
-const int					FORMAT_PNG = 1;
-const int					FORMAT_JPG = 2;
-
 // Storage object
 const std::string			PATH_SZ("q");
 const std::string			WIDTH_SZ("w");
 const std::string			HEIGHT_SZ("h");
 const std::string			TIMESTAMP_SZ("ts");
 
-int							get_format(const std::string& filename) {
-	const Poco::Path		path(filename);
-	std::string				ext = path.getExtension();
-	Poco::toLowerInPlace(ext);
-	if (ext == "png") return FORMAT_PNG;
-	if (ext == "jpg" || ext == "jpeg") return FORMAT_JPG;
-	return FORMAT_UNKNOWN;
-}
-
-uint32_t					big_endian_bytes_to_native( const char* bytes ) {
-	const unsigned char* data = (unsigned char*)bytes;
-	return (data[3]<<0) | (data[2]<<8) | (data[1]<<16) | (data[0]<<24);
-}
-
-bool						get_format_png(const std::string& filename, ci::vec2& outSize) {
-	std::ifstream file(filename, std::ios_base::binary | std::ios_base::in);
-	if (!file.is_open() || !file) return false;
-
-	// Skip PNG file signature
-	file.seekg(8, std::ios_base::cur);
-
-	// First chunk: IHDR image header
-	// Skip Chunk Length
-	file.seekg(4, std::ios_base::cur);
-	// Skip Chunk Type
-	file.seekg(4, std::ios_base::cur);
-
-	char widthBytes[4];
-	char heightBytes[4];
-	file.read(widthBytes, 4);
-	file.read(heightBytes, 4);
-
-	// PNG format stores as big endian, convert to native endianness
-	uint32_t width = big_endian_bytes_to_native(widthBytes);
-	uint32_t height = big_endian_bytes_to_native(heightBytes);
-
-	// check to make sure we correctly read the size. There's some bad png's out there
-	if(width < 1 || width > 20000 || height < 1 || height > 20000){
-		return false;
-	}
-
-	outSize.x = static_cast<float>(width);
-	outSize.y = static_cast<float>(height);
-	return true;
-}
-
-bool						get_format_jpg(const std::string& filename, ci::vec2& outSize) {
-	std::ifstream file(filename, std::ios_base::binary | std::ios_base::in);
-	if (!file.is_open() || !file) return false;
-
-	char buf[4] = {0, 0, 0, 0};
-	unsigned char* ubuf = (unsigned char*)buf;
-	unsigned char marker;
-
-	// Read until we find a marker
-	const auto nextMarker = [&file, &buf, &ubuf, &marker]() {
-		int discardedBytes = 0;
-		file.read(buf, 1);
-		while (ubuf[0] != 0xFF) {
-			discardedBytes++;
-			file.read(buf, 1);
-		}
-		do {
-			file.read(buf, 1);
-		} while (ubuf[0] == 0xFF);
-		marker = ubuf[0];
-		return discardedBytes;
-	};
-
-	const auto readWord = [&file, &buf]() -> unsigned {
-		file.read(buf, 2);
-		return ((unsigned char)(buf[0]) << 8) + (unsigned char)(buf[1]);
-	};
-
-	// Check Header
-	unsigned header;
-	if ((header = readWord()) != 0x0000ffd8)
-		return false;
-
-	// Read until we find a SOF (Start of Frame) marker
-	while(!file.eof()) {
-		if (nextMarker() != 0)
-			return false;
-
-		if ( ((marker & 0xf0) == 0xc0)
-		  && ((marker & 0x0f) != 0x04)
-		  && ((marker & 0x0f) != 0x08)
-		  && ((marker & 0x0f) != 0x0c))
-		{
-			// Skip length, precision bytes
-			file.seekg(3, std::ios_base::cur);
-			const unsigned height = readWord();
-			const unsigned width = readWord();
-			// Sanity check dimensions
-			if (width < 1 || width > 20000 || height < 1 || height > 20000) {
-				return false;
-			}
-			outSize.x = static_cast<float>(width);
-			outSize.y = static_cast<float>(height);
-			return true;
-		}
-		else if (marker == 0xDA || marker == 0xD9) {
-			return false;
-		}
-		else {
-			// Skip this segment
-			auto length = readWord();
-			if (length < 2)
-				return false;
-			file.seekg(length-2, std::ios_base::cur);
-		}
-	}
-
-	return false;
-}
-
-
 // A horrible fallback when no meta info has been supplied about the image size.
 void						super_slow_image_atts(const std::string& filename, ci::vec2& outSize) {
 	try {
@@ -298,31 +174,16 @@ private:
 		} catch (std::exception const&) {
 		}
 
-		// 2. Probe known file formats
-		try {
-			ImageAtts			atts;
-			const int			format = get_format(fn);
-			if(format == FORMAT_PNG && get_format_png(fn, atts.mSize)) {
-				DS_LOG_VERBOSE(7, "ImageAttsCache got png image size " << atts.mSize.x<< "x" << atts.mSize.y << " for " << fn);
-				return atts;
+		// 2. Read the size from the file's header. Only reads the first few KB, whatever the format
+		if(fn.find("http") != 0) {
+			ImageProbe			probe;
+			if(probe.probe(fn)) {
+				DS_LOG_VERBOSE(7, "ImageAttsCache got header image size " << probe.mWidth << "x" << probe.mHeight << " for " << fn);
+				return ImageAtts(ci::vec2(static_cast<float>(probe.mWidth), static_cast<float>(probe.mHeight)));
 			}
-			if(format == FORMAT_JPG && get_format_jpg(fn, atts.mSize)) {
-				DS_LOG_VERBOSE(7, "ImageAttsCache got jpg image size " << atts.mSize.x << "x" << atts.mSize.y << " for " << fn);
-				return atts;
-			}
-		} catch (std::exception const& e) {
-			DS_LOG_WARNING_M("ImageFileAtts() error=" << e.what(), GENERAL_LOG);
-		}
-
-		// 3. let's see if there's exif data if path exists
-		int outW = 0;
-		int outH = 0;
-		if (ds::safeFileExistsCheck(fn) && ds::ExifHelper::getImageSize(fn, outW, outH)){
-			DS_LOG_VERBOSE(7, "ImageAttsCache got exif image size " << outW << "x" << outH << " for " << fn);
-			return ImageAtts(ci::vec2(static_cast<float>(outW), static_cast<float>(outH)));
 		}
 
-		// 4. Load the whole damn image in and get that.
+		// 3. Load the whole damn image in and get that.
 		ImageAtts			atts;
 		super_slow_image_atts(fn, atts.mSize);
 		DS_LOG_VERBOSE(7, "ImageAttsCache got super slow image size " << atts.mSize.x << "x" << atts.mSize.y << " for " << fn);
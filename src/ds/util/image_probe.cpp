@@ -0,0 +1,366 @@
+#include "stdafx.h"
+
+#include "ds/util/image_probe.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ds {
+
+namespace {
+// Most headers are in the first read. Growing past that only happens for big EXIF blocks or odd files
+const size_t			READ_SIZE = 4096;
+// No single header read is bigger than this (a jpeg segment is at most 64K)
+const size_t			MAX_READ = 65536 + 16;
+// Past this the window starts over at the new offset instead of growing
+const size_t			MAX_WINDOW = 256 * 1024;
+// Bigger than any real image, so anything over it is a broken header
+const int				MAX_DIMENSION = 1 << 20;
+const int				MAX_JPEG_SEGMENTS = 1024;
+const int				MAX_TIFF_ENTRIES = 1024;
+
+const int				TIFF_WIDTH = 256;
+const int				TIFF_HEIGHT = 257;
+const int				TIFF_ORIENTATION = 274;
+const int				TIFF_SHORT = 3;
+const int				TIFF_LONG = 4;
+
+unsigned				read_16(const unsigned char* b, const bool littleEndian) {
+	return littleEndian ? (b[0] | (b[1] << 8)) : ((b[0] << 8) | b[1]);
+}
+
+uint32_t				read_32(const unsigned char* b, const bool littleEndian) {
+	if(littleEndian) return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+	return (static_cast<uint32_t>(b[0]) << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+uint32_t				read_24_le(const unsigned char* b) {
+	return b[0] | (b[1] << 8) | (b[2] << 16);
+}
+
+/// A file or memory block, read through a small window that only grows as far as the parser asks
+class Source {
+public:
+	explicit Source(FILE* file)
+		: mFile(file)
+		, mData(nullptr)
+		, mDataSize(0)
+		, mWindowStart(0)
+	{
+	}
+
+	Source(const unsigned char* data, const size_t size)
+		: mFile(nullptr)
+		, mData(data)
+		, mDataSize(size)
+		, mWindowStart(0)
+	{
+	}
+
+	/// length bytes starting at offset, or nullptr if the file is too short.
+	/// Only valid until the next call.
+	const unsigned char* get(const uint64_t offset, const size_t length) {
+		if(length > MAX_READ) return nullptr;
+
+		if(!mFile) {
+			if(offset > mDataSize || length > mDataSize - offset) return nullptr;
+			return mData + offset;
+		}
+
+		const uint64_t windowEnd = mWindowStart + mWindow.size();
+		if(offset >= mWindowStart && offset + length <= windowEnd) {
+			return &mWindow[static_cast<size_t>(offset - mWindowStart)];
+		}
+
+		const size_t readSize = std::max(length, READ_SIZE);
+		if(offset >= mWindowStart && offset <= windowEnd && mWindow.size() + readSize <= MAX_WINDOW) {
+			// Carries on from the end of what's already here
+			if(!fill(windowEnd, readSize)) return nullptr;
+		} else {
+			mWindow.clear();
+			mWindowStart = offset;
+			if(!fill(offset, readSize)) return nullptr;
+		}
+
+		if(offset + length > mWindowStart + mWindow.size()) return nullptr;
+		return &mWindow[static_cast<size_t>(offset - mWindowStart)];
+	}
+
+private:
+	bool fill(const uint64_t filePosition, const size_t size) {
+		if(filePosition > static_cast<uint64_t>(LONG_MAX)) return false;
+		if(fseek(mFile, static_cast<long>(filePosition), SEEK_SET) != 0) return false;
+
+		const size_t have = mWindow.size();
+		mWindow.resize(have + size);
+		const size_t got = fread(&mWindow[have], 1, size, mFile);
+		mWindow.resize(have + got);
+		return got > 0;
+	}
+
+	FILE*						mFile;
+	const unsigned char*		mData;
+	const size_t				mDataSize;
+	std::vector<unsigned char>	mWindow;
+	uint64_t					mWindowStart;
+};
+
+/// A TIFF header and its first IFD, starting at base and no more than limit bytes long.
+/// Used for TIFF files and the EXIF block in jpegs. Anything not found is left at 0.
+bool					read_tiff(Source& src, const uint64_t base, const uint64_t limit, int& outWidth, int& outHeight, int& outOrientation) {
+	if(limit < 8) return false;
+	const unsigned char* b = src.get(base, 8);
+	if(!b) return false;
+
+	bool littleEndian = false;
+	if(b[0] == 'I' && b[1] == 'I') littleEndian = true;
+	else if(b[0] != 'M' || b[1] != 'M') return false;
+	if(read_16(b + 2, littleEndian) != 42) return false;
+
+	const uint64_t ifd = read_32(b + 4, littleEndian);
+	if(ifd < 8 || ifd + 2 > limit) return false;
+	b = src.get(base + ifd, 2);
+	if(!b) return false;
+
+	const uint64_t maxEntries = (limit - ifd - 2) / 12;
+	const unsigned entries = static_cast<unsigned>(std::min<uint64_t>(std::min<uint64_t>(read_16(b, littleEndian), maxEntries), MAX_TIFF_ENTRIES));
+	for(unsigned i = 0; i < entries; ++i) {
+		b = src.get(base + ifd + 2 + i * 12, 12);
+		if(!b) return false;
+
+		const unsigned tag = read_16(b, littleEndian);
+		const unsigned type = read_16(b + 2, littleEndian);
+		// Tags are sorted, and nothing past the orientation matters here
+		if(tag > TIFF_ORIENTATION) break;
+		if(tag != TIFF_WIDTH && tag != TIFF_HEIGHT && tag != TIFF_ORIENTATION) continue;
+
+		uint32_t value = 0;
+		if(type == TIFF_SHORT) value = read_16(b + 8, littleEndian);
+		else if(type == TIFF_LONG) value = read_32(b + 8, littleEndian);
+		else continue;
+		if(value > static_cast<uint32_t>(INT_MAX)) continue;
+
+		if(tag == TIFF_WIDTH) outWidth = static_cast<int>(value);
+		else if(tag == TIFF_HEIGHT) outHeight = static_cast<int>(value);
+		else if(value >= 1 && value <= 8) outOrientation = static_cast<int>(value);
+	}
+	return true;
+}
+
+bool					probe_jpeg(Source& src, ImageProbe& out) {
+	uint64_t pos = 2;
+	for(int segment = 0; segment < MAX_JPEG_SEGMENTS; ++segment) {
+		const unsigned char* b = src.get(pos, 1);
+		if(!b || *b != 0xFF) return false;
+
+		// Markers can be padded with any number of 0xFF
+		unsigned char marker = 0xFF;
+		while(marker == 0xFF) {
+			b = src.get(++pos, 1);
+			if(!b) return false;
+			marker = *b;
+		}
+		++pos;
+
+		// These don't have a length
+		if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+		// Image data or the end of the file, and still no frame header
+		if(marker == 0xDA || marker == 0xD9) return false;
+
+		b = src.get(pos, 2);
+		if(!b) return false;
+		const unsigned length = read_16(b, false);
+		if(length < 2) return false;
+
+		// SOF0 - SOF15, except DHT, JPG and DAC which share the range
+		if((marker & 0xF0) == 0xC0 && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+			if(length < 7) return false;
+			b = src.get(pos + 2, 5);
+			if(!b) return false;
+			out.mHeight = static_cast<int>(read_16(b + 1, false));
+			out.mWidth = static_cast<int>(read_16(b + 3, false));
+			return true;
+		}
+
+		// APP1, which is where the EXIF orientation is
+		if(marker == 0xE1 && length > 8) {
+			b = src.get(pos + 2, 6);
+			if(b && memcmp(b, "Exif\0\0", 6) == 0) {
+				int w = 0, h = 0, orientation = 0;
+				if(read_tiff(src, pos + 8, length - 8, w, h, orientation) && orientation > 0) {
+					out.mOrientation = orientation;
+				}
+			}
+		}
+
+		pos += length;
+	}
+	return false;
+}
+
+bool					probe_png(Source& src, ImageProbe& out) {
+	// Signature, then the IHDR chunk has to come first
+	const unsigned char* b = src.get(0, 24);
+	if(!b) return false;
+	if(memcmp(b, "\x89PNG\r\n\x1a\n", 8) != 0 || memcmp(b + 12, "IHDR", 4) != 0) return false;
+
+	const uint32_t width = read_32(b + 16, false);
+	const uint32_t height = read_32(b + 20, false);
+	if(width > static_cast<uint32_t>(INT_MAX) || height > static_cast<uint32_t>(INT_MAX)) return false;
+	out.mWidth = static_cast<int>(width);
+	out.mHeight = static_cast<int>(height);
+	return true;
+}
+
+bool					probe_gif(Source& src, ImageProbe& out) {
+	const unsigned char* b = src.get(0, 10);
+	if(!b) return false;
+	if(memcmp(b, "GIF87a", 6) != 0 && memcmp(b, "GIF89a", 6) != 0) return false;
+
+	out.mWidth = static_cast<int>(read_16(b + 6, true));
+	out.mHeight = static_cast<int>(read_16(b + 8, true));
+	return true;
+}
+
+bool					probe_bmp(Source& src, ImageProbe& out) {
+	const unsigned char* b = src.get(0, 18);
+	if(!b || b[0] != 'B' || b[1] != 'M') return false;
+
+	const uint32_t headerSize = read_32(b + 14, true);
+	if(headerSize == 12) {
+		// OS/2 BITMAPCOREHEADER, 16 bit sizes
+		b = src.get(18, 4);
+		if(!b) return false;
+		out.mWidth = static_cast<int>(read_16(b, true));
+		out.mHeight = static_cast<int>(read_16(b + 2, true));
+		return true;
+	}
+	if(headerSize < 40) return false;
+
+	b = src.get(18, 8);
+	if(!b) return false;
+	const int32_t width = static_cast<int32_t>(read_32(b, true));
+	// Negative heights are top-down bitmaps
+	const int32_t height = static_cast<int32_t>(read_32(b + 4, true));
+	if(width <= 0 || height == INT32_MIN) return false;
+	out.mWidth = width;
+	out.mHeight = height < 0 ? -height : height;
+	return true;
+}
+
+bool					probe_webp(Source& src, ImageProbe& out) {
+	const unsigned char* b = src.get(0, 30);
+	if(!b) return false;
+	if(memcmp(b, "RIFF", 4) != 0 || memcmp(b + 8, "WEBP", 4) != 0) return false;
+
+	const unsigned char* chunk = b + 12;
+	const unsigned char* data = b + 20;
+	if(memcmp(chunk, "VP8 ", 4) == 0) {
+		// Lossy: 3 byte frame tag, then a start code and 14 bit sizes
+		if(data[3] != 0x9D || data[4] != 0x01 || data[5] != 0x2A) return false;
+		out.mWidth = static_cast<int>(read_16(data + 6, true) & 0x3FFF);
+		out.mHeight = static_cast<int>(read_16(data + 8, true) & 0x3FFF);
+		return true;
+	}
+	if(memcmp(chunk, "VP8L", 4) == 0) {
+		// Lossless: signature byte, then 14 bits each of width - 1 and height - 1
+		if(data[0] != 0x2F) return false;
+		const uint32_t bits = read_32(data + 1, true);
+		out.mWidth = static_cast<int>((bits & 0x3FFF) + 1);
+		out.mHeight = static_cast<int>(((bits >> 14) & 0x3FFF) + 1);
+		return true;
+	}
+	if(memcmp(chunk, "VP8X", 4) == 0) {
+		// Extended: 4 bytes of flags, then 24 bits each of canvas width - 1 and height - 1
+		out.mWidth = static_cast<int>(read_24_le(data + 4) + 1);
+		out.mHeight = static_cast<int>(read_24_le(data + 7) + 1);
+		return true;
+	}
+	return false;
+}
+
+bool					probe_tiff(Source& src, ImageProbe& out) {
+	int orientation = 0;
+	if(!read_tiff(src, 0, UINT64_MAX, out.mWidth, out.mHeight, orientation)) return false;
+	if(orientation > 0) out.mOrientation = orientation;
+	return true;
+}
+
+bool					probe_source(Source& src, ImageProbe& out) {
+	const unsigned char* b = src.get(0, 4);
+	if(!b) return false;
+
+	// The parsers read from the source again, which can move what b points to
+	unsigned char sig[4];
+	memcpy(sig, b, 4);
+
+	if(sig[0] == 0xFF && sig[1] == 0xD8 && sig[2] == 0xFF) {
+		out.mFormat = ImageProbe::FORMAT_JPEG;
+		return probe_jpeg(src, out);
+	}
+	if(sig[0] == 0x89 && sig[1] == 'P' && sig[2] == 'N' && sig[3] == 'G') {
+		out.mFormat = ImageProbe::FORMAT_PNG;
+		return probe_png(src, out);
+	}
+	if(sig[0] == 'G' && sig[1] == 'I' && sig[2] == 'F' && sig[3] == '8') {
+		out.mFormat = ImageProbe::FORMAT_GIF;
+		return probe_gif(src, out);
+	}
+	if(sig[0] == 'B' && sig[1] == 'M') {
+		out.mFormat = ImageProbe::FORMAT_BMP;
+		return probe_bmp(src, out);
+	}
+	if(memcmp(sig, "RIFF", 4) == 0) {
+		out.mFormat = ImageProbe::FORMAT_WEBP;
+		return probe_webp(src, out);
+	}
+	if(memcmp(sig, "II*\0", 4) == 0 || memcmp(sig, "MM\0*", 4) == 0) {
+		out.mFormat = ImageProbe::FORMAT_TIFF;
+		return probe_tiff(src, out);
+	}
+	return false;
+}
+
+}
+
+/**
+ * \class ImageProbe
+ */
+ImageProbe::ImageProbe()
+	: mFormat(FORMAT_UNKNOWN)
+	, mWidth(0)
+	, mHeight(0)
+	, mOrientation(1)
+{
+}
+
+bool ImageProbe::probe(const std::string& filePath) {
+	*this = ImageProbe();
+
+	FILE* file = fopen(filePath.c_str(), "rb");
+	if(!file) return false;
+
+	bool found = false;
+	{
+		Source src(file);
+		found = probe_source(src, *this);
+	}
+	fclose(file);
+
+	return found && mWidth > 0 && mHeight > 0 && mWidth <= MAX_DIMENSION && mHeight <= MAX_DIMENSION;
+}
+
+bool ImageProbe::probe(const unsigned char* data, const size_t size) {
+	*this = ImageProbe();
+	if(!data) return false;
+
+	Source src(data, size);
+	const bool found = probe_source(src, *this);
+	return found && mWidth > 0 && mHeight > 0 && mWidth <= MAX_DIMENSION && mHeight <= MAX_DIMENSION;
+}
+
+} // namespace ds
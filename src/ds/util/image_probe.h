@@ -0,0 +1,42 @@
+#pragma once
+#ifndef DS_UTIL_IMAGEPROBE_H_
+#define DS_UTIL_IMAGEPROBE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace ds {
+
+/**
+ * \class ImageProbe
+ * \brief Reads the size of an image from its header, without decoding it or reading the whole file.
+ *        Files are read a few KB at a time, and only as far as the header goes, so a 40 MP jpeg
+ *        costs about the same as a thumbnail.
+ *        Knows JPEG (SOF markers, plus the EXIF orientation), PNG, GIF, BMP, WebP (VP8, VP8L and VP8X) and TIFF.
+ *        Detects the format from the file's contents, not the extension.
+ */
+class ImageProbe {
+public:
+	enum Format { FORMAT_UNKNOWN = 0, FORMAT_JPEG, FORMAT_PNG, FORMAT_GIF, FORMAT_BMP, FORMAT_WEBP, FORMAT_TIFF };
+
+	ImageProbe();
+
+	/// Returns true if the format was recognized and the width and height are valid (above zero).
+	bool				probe(const std::string& filePath);
+	/// Same as above, for a file that's already in memory.
+	bool				probe(const unsigned char* data, const size_t size);
+
+	Format				mFormat;
+	/// The stored size of the image, before the orientation is applied
+	int					mWidth;
+	int					mHeight;
+	/// EXIF / TIFF orientation, 1 through 8. 1 (upright) if the file doesn't say.
+	int					mOrientation;
+
+	/// True when the orientation turns the image on its side, so the displayed width and height are swapped
+	bool				isTransposed() const { return mOrientation >= 5 && mOrientation <= 8; }
+};
+
+} // namespace ds
+
+#endif // DS_UTIL_IMAGEPROBE_H_
@@ -3,6 +3,12 @@
 #include "markdown_to_pango.h"
 #include "string_util.h"
 
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 #include "ds/util/sundown/markdown.h"
 
 namespace ds {
@@ -14,42 +20,42 @@ static void rndr_normal_text(struct buf *ob, const struct buf *text, void *opaqu
 
 static void rndr_paragraph(struct buf *ob, const struct buf *text, void *opaque) {
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "\n\n");
+	BUFPUTSL(ob, "\n\n");
 }
 static int rndr_strikethrough(struct buf *ob, const struct buf *text, void *opaque) {
 	if(!text || !text->size) return 0;
-	bufputs(ob, "<span strikethrough='true'>");
+	BUFPUTSL(ob, "<span strikethrough='true'>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</span>");
+	BUFPUTSL(ob, "</span>");
 	return 1;
 }
 static int rndr_superscript(struct buf *ob, const struct buf *text, void *opaque) {
 	if(!text || !text->size) return 0;
-	bufputs(ob, "<sup>");
+	BUFPUTSL(ob, "<sup>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</sup>");
+	BUFPUTSL(ob, "</sup>");
 	return 1;
 }
 static int rndr_double_emphasis(struct buf *ob, const struct buf *text, void *opaque) {
 	if(!text || !text->size) return 0;
-	bufputs(ob, "<span weight='bold'>");
+	BUFPUTSL(ob, "<span weight='bold'>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</span>");
+	BUFPUTSL(ob, "</span>");
 	return 1;
 }
 static int rndr_emphasis(struct buf *ob, const struct buf *text, void *opaque) {
 	if(!text || !text->size) return 0;
-	bufputs(ob, "<span style='oblique'>");
+	BUFPUTSL(ob, "<span style='oblique'>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</span>");
+	BUFPUTSL(ob, "</span>");
 	return 1;
 }
 
 static int rndr_triple_emphasis(struct buf *ob, const struct buf *text, void *opaque) {
 	if(!text || !text->size) return 0;
-	bufputs(ob, "<span weight='bold' style='oblique'>");
+	BUFPUTSL(ob, "<span weight='bold' style='oblique'>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</span>");
+	BUFPUTSL(ob, "</span>");
 	return 1;
 }
 
@@ -59,31 +65,31 @@ static void rndr_header(struct buf *ob, const struct buf *text, int level, void
 	//	bufputc(ob, '\n');
 	}
 
-	if(level == 1) bufputs(ob, "<span weight='heavy' size='xx-large'>");
-	else if(level == 2) bufputs(ob, "<span weight='heavy' size='x-large'>");
-	else bufputs(ob, "<span weight='heavy' size='large'>");
+	if(level == 1) BUFPUTSL(ob, "<span weight='heavy' size='xx-large'>");
+	else if(level == 2) BUFPUTSL(ob, "<span weight='heavy' size='x-large'>");
+	else BUFPUTSL(ob, "<span weight='heavy' size='large'>");
 	bufput(ob, text->data, text->size);
-	bufputs(ob, "</span>\n\n");
+	BUFPUTSL(ob, "</span>\n\n");
 }
 
 static void rndr_list(struct buf *ob, const struct buf *text, int flags, void *opaque){
 	if(flags & MKD_LIST_ORDERED) {
-		bufputs(ob, "<ol>\n");
+		BUFPUTSL(ob, "<ol>\n");
 	} else {
-		bufputs(ob, "<ul>\n");
+		BUFPUTSL(ob, "<ul>\n");
 	}
 	if(text) bufput(ob, text->data, text->size);
 
 	if(flags & MKD_LIST_ORDERED) {
-		bufputs(ob, "\n</ol>\n");
+		BUFPUTSL(ob, "\n</ol>\n");
 	} else {
-		bufputs(ob, "\n</ul>\n");
+		BUFPUTSL(ob, "\n</ul>\n");
 	}
-	bufputc(ob, '\n');	
+	bufputc(ob, '\n');
 }
 
 static void rndr_listitem(struct buf *ob, const struct buf *text, int flags, void *opaque){
-	bufputs(ob, "&bull;");
+	BUFPUTSL(ob, "&bull;");
 	if(text) {
 		size_t size = text->size;
 		while(size && text->data[size - 1] == '\n')
@@ -91,11 +97,11 @@ static void rndr_listitem(struct buf *ob, const struct buf *text, int flags, voi
 
 		bufput(ob, text->data, size);
 	}
-	bufputs(ob, "\n");
+	bufputc(ob, '\n');
 }
 
 static int rndr_linebreak(struct buf *ob, void *opaque){
-	bufputs(ob, "\n\n");
+	BUFPUTSL(ob, "\n\n");
 	return 1;
 }
 
@@ -136,126 +142,128 @@ static void rndr_tablerow(struct buf *ob, const struct buf *text, void *opaque){
 }
 
 static void rndr_tablecell(struct buf *ob, const struct buf *text, int flags, void *opaque){
-	if(text) 
+	if(text)
 		bufput(ob, text->data, text->size);
 	BUFPUTSL(ob, " | ");
 }
 
-std::wstring markdown_to_pango(const std::wstring& inputMarkdown) {
-	return ds::wstr_from_utf8(markdown_to_pango(ds::utf8_from_wstr(inputMarkdown)));
+namespace {
+
+// see the html directory for usage
+// https://github.com/apiaryio/sundown/
+const struct sd_callbacks cb_default = {
+
+	/// NULL skips these ones (note: tables aren't parsed)
+	rndr_blockcode, // rndr_blockcode,
+	rndr_blockquote, // rndr_blockquote,
+	rndr_normal_text, // rndr_raw_block,
+	rndr_header, // rndr_header,
+	NULL, // rndr_hrule,
+	rndr_list, // rndr_list,
+	rndr_listitem, // rndr_listitem,
+	rndr_paragraph, // rndr_paragraph,
+	rndr_table, // rndr_table,
+	rndr_tablerow, // rndr_tablerow,
+	rndr_tablecell, // rndr_tablecell,
+
+	/// NULL or returning 0 adds the original text verbatim
+	NULL, // rndr_autolink,
+	rndr_codespan, // rndr_codespan,
+	rndr_double_emphasis, // rndr_double_emphasis,
+	rndr_emphasis, // rndr_emphasis,
+	NULL, // rndr_image,
+	rndr_linebreak, // rndr_linebreak,
+	NULL, // rndr_link,
+	NULL, // rndr_raw_html,
+	rndr_triple_emphasis, // rndr_triple_emphasis,
+	rndr_strikethrough, // rndr_strikethrough,
+	rndr_superscript, // rndr_superscript,
+
+
+	/// These all return the original if NULL
+	NULL, // entity - copied directly
+	rndr_normal_text,
+
+	NULL, // header - copied directly
+	NULL, // footer - copied directly
+};
+
+const int			PARSER_EXTENSIONS = MKDEXT_FENCED_CODE | MKDEXT_NO_INTRA_EMPHASIS | MKDEXT_LAX_SPACING | MKDEXT_SUPERSCRIPT | MKDEXT_STRIKETHROUGH  /*| MKDEXT_TABLES */;
+
+// U+2022 and a space, in utf8
+const char* const	BULLET = "\xE2\x80\xA2 ";
+
+// Remove some "offensive" characters
+// These will break pango's markup later on
+// These also break blockquotes, but we re-add those later
+// Runs between them are copied in one go, so plain text costs a scan and a memcpy
+void append_escaped(const char* data, const size_t size, std::string& out) {
+	out.reserve(out.size() + size + size / 16 + 16);
+
+	const char*			run = data;
+	const char* const	end = data + size;
+	for(const char* it = data; it != end; ++it) {
+		const char c = *it;
+		if(c != '&' && c != '<' && c != '>') continue;
+
+		out.append(run, it - run);
+		if(c == '&') out.append("&amp;", 5);
+		else if(c == '<') out.append("&lt;", 4);
+		else out.append("&gt;", 4);
+		run = it + 1;
+	}
+	out.append(run, end - run);
 }
 
-std::string markdown_to_pango(const std::string& source) {
-	
-	// see the html directory for usage
-	// https://github.com/apiaryio/sundown/
-
-
-	static const struct sd_callbacks cb_default = {
-
-		/// NULL skips these ones (note: tables aren't parsed)
-		rndr_blockcode, // rndr_blockcode,
-		rndr_blockquote, // rndr_blockquote,
-		rndr_normal_text, // rndr_raw_block,
-		rndr_header, // rndr_header,
-		NULL, // rndr_hrule,
-		rndr_list, // rndr_list,
-		rndr_listitem, // rndr_listitem,
-		rndr_paragraph, // rndr_paragraph,
-		rndr_table, // rndr_table,
-		rndr_tablerow, // rndr_tablerow,
-		rndr_tablecell, // rndr_tablecell,
-
-		/// NULL or returning 0 adds the original text verbatim
-		NULL, // rndr_autolink,
-		rndr_codespan, // rndr_codespan,
-		rndr_double_emphasis, // rndr_double_emphasis,
-		rndr_emphasis, // rndr_emphasis,
-		NULL, // rndr_image,
-		rndr_linebreak, // rndr_linebreak,
-		NULL, // rndr_link,
-		NULL, // rndr_raw_html,
-		rndr_triple_emphasis, // rndr_triple_emphasis,
-		rndr_strikethrough, // rndr_strikethrough,
-		rndr_superscript, // rndr_superscript,
-
-
-		/// These all return the original if NULL
-		NULL, // entity - copied directly
-		rndr_normal_text,
-
-		NULL, // header - copied directly
-		NULL, // footer - copied directly
-	};
-
-	struct sd_callbacks callbacks;
-	struct sd_markdown *markdown;
-	struct buf *ob;
-	callbacks = cb_default;
-
-	const int parserExtensions = MKDEXT_FENCED_CODE | MKDEXT_NO_INTRA_EMPHASIS | MKDEXT_LAX_SPACING | MKDEXT_SUPERSCRIPT | MKDEXT_STRIKETHROUGH  /*| MKDEXT_TABLES */;
-	markdown = sd_markdown_new(parserExtensions, 16, &callbacks, nullptr);
+// Appends sundown's output for some already escaped markdown, before the post-processing
+void render_escaped(const std::string& escaped, std::string& out) {
+	if(escaped.empty()) return;
 
+	struct sd_markdown* markdown = sd_markdown_new(PARSER_EXTENSIONS, 16, &cb_default, nullptr);
+	if(!markdown) return;
 
-	std::string theInput = source;
-	
-	// Remove some "offensive" characters
-	// These will break pango's markup later on
-	// These also break blockquotes, but we re-add those later
-	ds::replace(theInput, "&", "&amp;");
-	ds::replace(theInput, "<", "&lt;");
-	ds::replace(theInput, ">", "&gt;");
-
-	ob = bufnew(64);
-	sd_markdown_render(ob, reinterpret_cast<const uint8_t*>(theInput.c_str()), theInput.length(), markdown);
+	// The tags add a bit to the input, and buffers grow by a fixed unit, so sizing off the input keeps reallocs to a few
+	struct buf* ob = bufnew(std::max<size_t>(64, escaped.size() + escaped.size() / 2));
+	if(ob) {
+		sd_markdown_render(ob, reinterpret_cast<const uint8_t*>(escaped.data()), escaped.size(), markdown);
+		if(ob->data && ob->size) out.append(reinterpret_cast<const char*>(ob->data), ob->size);
+		bufrelease(ob);
+	}
 	sd_markdown_free(markdown);
+}
 
-	if(!ob || !ob->data || !ob->size) return "";
-
-	std::string outputString = std::string(reinterpret_cast<char*>(ob->data), ob->size);
-
-	bufrelease(ob);
-
-	std::string outputty;
-
-
-	// We've got to do some post-processing for lists and other element types, due to the way the parser handles lists
-	auto lines = ds::split(outputString, "\n", false);
-	int indent = 0;
-
-	struct ListType {
-		ListType(const int typey) :listType(typey), listCount(1) {}
+struct ListType {
+	ListType(const int typey) :listType(typey), listCount(1) {}
 
-		int listType;
-		int listCount;
-	};
+	int listType;
+	int listCount;
+};
 
-	// 0 = unordered list
-	// 1 = ordered list
-	std::vector<ListType> listTypes;
-
-	for (auto it : lines){
+// We've got to do some post-processing for lists and other element types, due to the way the parser handles lists
+// Goes a line at a time, so MarkdownToPango can pick up part way through with the state it saved
+class PangoLines {
+public:
+	PangoLines() : indent(0) {}
 
-		std::string thisLine = it;
+	void add(const boost::string_ref& line, std::string& outputty) {
+		thisLine.assign(line.data(), line.size());
 
 		if(thisLine.find("<ol>") != std::string::npos) {
 			listTypes.push_back(ListType(1));
-			ds::replace(thisLine, "<ol>", "");
 			indent++;
-			continue;
+			return;
 		} else if(thisLine.find("<ul>") != std::string::npos) {
 			listTypes.push_back(ListType(0));
-			ds::replace(thisLine, "<ul>", "");
 			indent++;
-			continue;
+			return;
 		} else if(thisLine.find("</ol>") != std::string::npos) {
 			indent--;
 			if(!listTypes.empty()) listTypes.pop_back();
-			continue;
+			return;
 		} else if(thisLine.find("</ul>") != std::string::npos) {
 			indent--;
 			if(!listTypes.empty()) listTypes.pop_back();
-			continue;
+			return;
 		}
 
 		if(thisLine.find("<blockquote>") != std::string::npos) {
@@ -272,10 +280,10 @@ std::string markdown_to_pango(const std::string& source) {
 		if(indent < 0) indent = 0;
 
 		/// this fixes a bug where there could be an extra line when dropping down a level in indentation
-		if(!listTypes.empty() && thisLine.empty()) continue;
+		if(!listTypes.empty() && thisLine.empty()) return;
 
 		// blockquote parsing got smushed by our > find/replace earlier
-		if(listTypes.empty() &&  thisLine.find("&gt;") == 0) {
+		if(listTypes.empty() && thisLine.compare(0, 4, "&gt;") == 0) {
 			thisLine.replace(0, 4, "    <span font='Palatino Italic'>");
 			thisLine.append("</span>");
 		}
@@ -284,22 +292,352 @@ std::string markdown_to_pango(const std::string& source) {
 			outputty.append("	");
 		}
 
-		// to properly encode bullets, add it here using a wstr
+		// to properly encode bullets, add it here
 		if(thisLine.find("&bull;") != std::string::npos) {
 			if(listTypes.empty() || listTypes.back().listType == 0) {
-				ds::replace(thisLine, "&bull;", ds::utf8_from_wstr(L"\u2022 "));
+				ds::replace(thisLine, "&bull;", BULLET);
 			} else if(listTypes.back().listType == 1) {
 				ds::replace(thisLine, "&bull;", std::to_string(listTypes.back().listCount) + ". ");
 				listTypes.back().listCount++;
-			}  
+			}
 		}
 
 		outputty.append(thisLine);
 		outputty.append("\n");
 	}
 
-	return outputty;
+	/// The indent, then the type and count of each open list
+	void save(std::vector<int>& state) const {
+		state.clear();
+		state.push_back(indent);
+		for(auto it = listTypes.begin(), end = listTypes.end(); it != end; ++it) {
+			state.push_back(it->listType);
+			state.push_back(it->listCount);
+		}
+	}
+
+	void load(const std::vector<int>& state) {
+		indent = state.empty() ? 0 : state[0];
+		listTypes.clear();
+		for(size_t i = 1; i + 1 < state.size(); i += 2) {
+			listTypes.push_back(ListType(state[i]));
+			listTypes.back().listCount = state[i + 1];
+		}
+	}
+
+private:
+	int indent;
+
+	// 0 = unordered list
+	// 1 = ordered list
+	std::vector<ListType> listTypes;
+
+	// Reused for each line, so lines only allocate when they're longer than any before
+	std::string thisLine;
+};
+
+void post_process(const std::string& outputString, std::string& outputty) {
+	outputty.reserve(outputty.size() + outputString.size() + outputString.size() / 8);
+
+	PangoLines lines;
+	ds::split_each(outputString, "\n", false, [&](const boost::string_ref& line) {
+		lines.add(line, outputty);
+		return true;
+	});
+}
+
+std::string convert_markdown(const std::string& source) {
+	std::string escaped;
+	append_escaped(source.data(), source.size(), escaped);
+
+	std::string rendered;
+	render_escaped(escaped, rendered);
+	if(rendered.empty()) return "";
+
+	std::string output;
+	post_process(rendered, output);
+	return output;
+}
+
+bool is_blank_line(const boost::string_ref& line) {
+	for(auto it = line.begin(), end = line.end(); it != end; ++it) {
+		if(*it != ' ' && *it != '\t') return false;
+	}
+	return true;
+}
+
+// Anything that could open a fence, at any indent. Fences can hold blank lines, so nothing after one gets split.
+bool is_fence_line(const boost::string_ref& line) {
+	size_t i = 0;
+	while(i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i;
+	if(i >= line.size() || (line[i] != '`' && line[i] != '~')) return false;
+
+	const char	fence = line[i];
+	size_t		count = 0;
+	while(i < line.size() && line[i] == fence) { ++i; ++count; }
+	return count >= 3;
+}
+
+// A line after a blank line that can't carry on a list, quote or indented code, or be a link reference that sundown
+// takes out first, so sundown always starts a new block there
+bool starts_block(const boost::string_ref& line) {
+	const char c = line[0];
+	if(c == ' ' || c == '\t' || c == '>' || c == '[' || c == '*' || c == '+' || c == '-') return false;
+	if(c >= '0' && c <= '9') {
+		size_t i = 0;
+		while(i < line.size() && line[i] >= '0' && line[i] <= '9') ++i;
+		if(i < line.size() && line[i] == '.') return false;
+	}
+	return true;
+}
+
+// Splits markdown where rendering each piece on its own gives the same output as rendering it all together.
+// Blank lines stay on the end of the block before them.
+void split_blocks(const std::string& source, std::vector<boost::string_ref>& blocks) {
+	blocks.clear();
+
+	const boost::string_ref	all(source);
+	size_t					blockStart = 0;
+	size_t					pos = 0;
+	bool					hasContent = false;
+	bool					afterBlank = false;
+	bool					afterColon = false;
+	bool					fenced = false;
+	while(pos < all.size() && !fenced) {
+		// Like sundown, a \r on its own ends a line too
+		size_t			end = pos;
+		while(end < all.size() && all[end] != '\n' && all[end] != '\r') ++end;
+		const boost::string_ref	line = all.substr(pos, end - pos);
+
+		if(is_blank_line(line)) {
+			// A link reference ("[id]:") can have its url on a later line, past blank ones
+			if(!afterColon) afterBlank = true;
+		} else {
+			fenced = is_fence_line(line);
+			if(!fenced && afterBlank && hasContent && starts_block(line)) {
+				blocks.push_back(all.substr(blockStart, pos - blockStart));
+				blockStart = pos;
+			}
+			afterBlank = false;
+			afterColon = line.find("]:") != boost::string_ref::npos;
+			hasContent = true;
+		}
+		pos = end + 1;
+		if(end + 1 < all.size() && all[end] == '\r' && all[end + 1] == '\n') ++pos;
+	}
+
+	if(blockStart < all.size()) blocks.push_back(all.substr(blockStart));
+}
+
+/* Least recently used first out, bounded by the bytes of source and markup held.
+ * Entries are found by a hash of the source, then the source is compared in case two hash the same. */
+class MarkupCache {
+public:
+	MarkupCache() : mMaxBytes(4 * 1024 * 1024), mBytes(0) {}
+
+	bool get(const std::string& source, const size_t hash, std::string& markup) {
+		std::lock_guard<std::mutex>		lock(mMutex);
+		auto range = mLookup.equal_range(hash);
+		for(auto it = range.first; it != range.second; ++it) {
+			if(it->second->mSource != source) continue;
+			mEntries.splice(mEntries.begin(), mEntries, it->second);
+			markup = it->second->mMarkup;
+			return true;
+		}
+		return false;
+	}
+
+	void put(const std::string& source, const size_t hash, const std::string& markup) {
+		const size_t bytes = source.size() + markup.size();
+
+		std::lock_guard<std::mutex>		lock(mMutex);
+		if(bytes > mMaxBytes) return;
+
+		// Two callers could have converted the same text at once
+		auto range = mLookup.equal_range(hash);
+		for(auto it = range.first; it != range.second; ++it) {
+			if(it->second->mSource == source) return;
+		}
+
+		mEntries.push_front(Entry());
+		mEntries.front().mHash = hash;
+		mEntries.front().mSource = source;
+		mEntries.front().mMarkup = markup;
+		mLookup.insert(std::make_pair(hash, mEntries.begin()));
+		mBytes += bytes;
+		trim();
+	}
+
+	void setMaxBytes(const size_t maxBytes) {
+		std::lock_guard<std::mutex>		lock(mMutex);
+		mMaxBytes = maxBytes;
+		trim();
+	}
+
+	size_t getMaxBytes() {
+		std::lock_guard<std::mutex>		lock(mMutex);
+		return mMaxBytes;
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex>		lock(mMutex);
+		mEntries.clear();
+		mLookup.clear();
+		mBytes = 0;
+	}
+
+private:
+	struct Entry {
+		size_t			mHash;
+		std::string		mSource;
+		std::string		mMarkup;
+	};
+	typedef std::list<Entry>	EntryList;
+
+	void trim() {
+		while(mBytes > mMaxBytes && !mEntries.empty()) {
+			const Entry& oldest = mEntries.back();
+			auto range = mLookup.equal_range(oldest.mHash);
+			for(auto it = range.first; it != range.second; ++it) {
+				if(&*it->second != &oldest) continue;
+				mLookup.erase(it);
+				break;
+			}
+			mBytes -= oldest.mSource.size() + oldest.mMarkup.size();
+			mEntries.pop_back();
+		}
+	}
+
+	std::mutex											mMutex;
+	EntryList											mEntries;
+	std::unordered_multimap<size_t, EntryList::iterator>	mLookup;
+	size_t												mMaxBytes;
+	size_t												mBytes;
+};
+
+MarkupCache& get_cache() {
+	static MarkupCache		CACHE;
+	return CACHE;
 }
 
 }
-}
\ No newline at end of file
+
+std::wstring markdown_to_pango(const std::wstring& inputMarkdown) {
+	return ds::wstr_from_utf8(markdown_to_pango(ds::utf8_from_wstr(inputMarkdown)));
+}
+
+std::string markdown_to_pango(const std::string& source) {
+	MarkupCache&	cache = get_cache();
+	if(source.empty() || cache.getMaxBytes() == 0) return convert_markdown(source);
+
+	const size_t	hash = std::hash<std::string>()(source);
+	std::string		output;
+	if(cache.get(source, hash, output)) return output;
+
+	output = convert_markdown(source);
+	cache.put(source, hash, output);
+	return output;
+}
+
+void set_markdown_to_pango_cache_size(const size_t maxBytes) {
+	get_cache().setMaxBytes(maxBytes);
+}
+
+void clear_markdown_to_pango_cache() {
+	get_cache().clear();
+}
+
+/**
+ * \class MarkdownToPango
+ */
+MarkdownToPango::MarkdownToPango() {
+}
+
+const std::string& MarkdownToPango::convert(const std::string& inputMarkdown) {
+	std::vector<boost::string_ref>	sources;
+	split_blocks(inputMarkdown, sources);
+
+	// Typing or pasting changes the middle or the end, so keep whatever matches at the front and back
+	const size_t	most = std::min(sources.size(), mBlocks.size());
+	size_t			front = 0;
+	while(front < most && sources[front] == boost::string_ref(mBlocks[front].mSource)) ++front;
+	size_t			back = 0;
+	while(back < most - front && sources[sources.size() - 1 - back] == boost::string_ref(mBlocks[mBlocks.size() - 1 - back].mSource)) ++back;
+
+	std::vector<Block>	blocks(sources.size());
+	for(size_t i = 0; i < front; ++i) {
+		blocks[i] = std::move(mBlocks[i]);
+	}
+	for(size_t i = 0; i < back; ++i) {
+		blocks[blocks.size() - 1 - i] = std::move(mBlocks[mBlocks.size() - 1 - i]);
+	}
+
+	std::string		escaped;
+	for(size_t i = front; i < sources.size() - back; ++i) {
+		Block& block = blocks[i];
+		block.mSource.assign(sources[i].data(), sources[i].size());
+		escaped.clear();
+		append_escaped(block.mSource.data(), block.mSource.size(), escaped);
+		render_escaped(escaped, block.mRendered);
+	}
+	mBlocks.swap(blocks);
+	mOutput.clear();
+
+	// Each block's lines are post-processed on their own, from where the block before left off, which needs every line
+	// to end in its own block. Sundown's blocks all end in a newline, but do the whole thing over if one doesn't
+	bool	anyRendered = false;
+	bool	linesEnd = true;
+	for(auto it = mBlocks.begin(), end = mBlocks.end(); it != end; ++it) {
+		if(it->mRendered.empty()) continue;
+		anyRendered = true;
+		if(it->mRendered.back() != '\n') linesEnd = false;
+	}
+	if(!anyRendered) return mOutput;
+
+	if(!linesEnd) {
+		std::string		rendered;
+		for(auto it = mBlocks.begin(), end = mBlocks.end(); it != end; ++it) {
+			rendered.append(it->mRendered);
+			it->mStartState.clear();
+		}
+		post_process(rendered, mOutput);
+		return mOutput;
+	}
+
+	// Blocks that haven't changed and start in the same state keep their markup. New blocks have no state, so never match
+	PangoLines			lines;
+	std::vector<int>	state;
+	lines.save(state);
+	for(auto it = mBlocks.begin(), end = mBlocks.end(); it != end; ++it) {
+		Block& block = *it;
+		if(block.mStartState != state) {
+			block.mStartState = state;
+			block.mMarkup.clear();
+			if(!block.mRendered.empty()) {
+				lines.load(state);
+				ds::split_each(boost::string_ref(block.mRendered.data(), block.mRendered.size() - 1), "\n", false, [&](const boost::string_ref& line) {
+					lines.add(line, block.mMarkup);
+					return true;
+				});
+				lines.save(block.mEndState);
+			} else {
+				block.mEndState = state;
+			}
+		}
+		mOutput.append(block.mMarkup);
+		state = block.mEndState;
+	}
+
+	// The piece after the last newline
+	lines.load(state);
+	lines.add(boost::string_ref(), mOutput);
+	return mOutput;
+}
+
+void MarkdownToPango::clear() {
+	mBlocks.clear();
+	mOutput.clear();
+}
+
+}
+}
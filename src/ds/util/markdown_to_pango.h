@@ -3,14 +3,48 @@
 #define DS_UTIL_MARKDOWN_TO_PANGO
 
 #include <string>
+#include <vector>
 
 namespace ds {
 namespace ui {
 
 /// TODO: it'd be cool if this supported custom callbacks for certain elements for further styling
 ///			For instance, you could specify your own font or background color for code blocks or headers, etc
+/// Results are kept in a cache shared by every caller, so the same body text on many cards is only converted once.
 std::wstring markdown_to_pango(const std::wstring& inputMarkdown);
 std::string markdown_to_pango(const std::string& inputMarkdown);
+
+/// Bytes of markdown and markup the shared cache holds before dropping the least recently used. 0 turns the cache off.
+void set_markdown_to_pango_cache_size(const size_t maxBytes);
+void clear_markdown_to_pango_cache();
+
+/**
+ * \class MarkdownToPango
+ * \brief For text that changes a little at a time, like an entry field. Keeps the blocks (paragraphs, lists, etc)
+ *        from the last conversion and only renders the ones that changed. The output is the same as markdown_to_pango().
+ */
+class MarkdownToPango {
+public:
+	MarkdownToPango();
+
+	const std::string&			convert(const std::string& inputMarkdown);
+	void						clear();
+
+private:
+	struct Block {
+		std::string				mSource;
+		/// Sundown's output, then the markup its lines turn into
+		std::string				mRendered;
+		std::string				mMarkup;
+		/// The post-processing state (indent and open lists) before and after this block's lines
+		std::vector<int>		mStartState;
+		std::vector<int>		mEndState;
+	};
+
+	std::vector<Block>			mBlocks;
+	std::string					mOutput;
+};
+
 }
 
 } // namespace ds
@@ -4,7 +4,10 @@
 
 #include <sstream>
 #include <fstream>
+#include <cerrno>
 #include <codecvt>
+#include <cstdlib>
+#include <limits>
 #include <string>
 
 //using namespace std;
@@ -184,9 +187,178 @@ std::string		utf8_from_wstr(const std::wstring& src) {
 
 namespace ds {
 
+namespace {
+
+bool is_space(const char c){
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool is_digit(const char c){
+	return c >= '0' && c <= '9';
+}
+
+/// Returns the number in str without the leading whitespace, or an empty view if the rest isn't exactly one
+/// decimal number, which is what a stream needs to read it and hit the end
+boost::string_ref number_part(const boost::string_ref& str, const bool allowFraction){
+	const size_t		size = str.size();
+	size_t				i = 0;
+	while(i < size && is_space(str[i])) ++i;
+	const size_t		start = i;
+
+	if(i < size && (str[i] == '+' || str[i] == '-')) ++i;
+	size_t				digits = 0;
+	while(i < size && is_digit(str[i])){ ++i; ++digits; }
+
+	if(allowFraction){
+		if(i < size && str[i] == '.'){
+			++i;
+			while(i < size && is_digit(str[i])){ ++i; ++digits; }
+		}
+		if(digits < 1) return boost::string_ref();
+
+		if(i < size && (str[i] == 'e' || str[i] == 'E')){
+			++i;
+			if(i < size && (str[i] == '+' || str[i] == '-')) ++i;
+			size_t		expDigits = 0;
+			while(i < size && is_digit(str[i])){ ++i; ++expDigits; }
+			if(expDigits < 1) return boost::string_ref();
+		}
+	} else if(digits < 1){
+		return boost::string_ref();
+	}
+
+	if(i != size) return boost::string_ref();
+	return str.substr(start);
+}
+
+/// strto* need a terminated string, so numbers are copied to the stack (or the heap if they're absurdly long)
+template <typename T, typename Fn>
+bool parse_number(const boost::string_ref& str, const bool allowFraction, T& value, Fn&& convert){
+	const boost::string_ref	number = number_part(str, allowFraction);
+	if(number.empty()) return false;
+
+	char					stackBuffer[64];
+	std::string				heapBuffer;
+	const char*				terminated = stackBuffer;
+	if(number.size() < sizeof(stackBuffer)){
+		memcpy(stackBuffer, number.data(), number.size());
+		stackBuffer[number.size()] = 0;
+	} else {
+		heapBuffer.assign(number.data(), number.size());
+		terminated = heapBuffer.c_str();
+	}
+
+	errno = 0;
+	char*					end = nullptr;
+	const auto				v = convert(terminated, &end);
+	if(end != terminated + number.size()) return false;
+	// Overflow fails, like a stream. Underflow to (nearly) zero doesn't
+	if(v < std::numeric_limits<T>::lowest() || v > std::numeric_limits<T>::max()) return false;
+	if(errno == ERANGE && (v > 1 || v < -1)) return false;
+	value = static_cast<T>(v);
+	return true;
+}
+
+}
+
+bool parse_float(const boost::string_ref& str, float& value){
+	return parse_number<float>(str, true, value, [](const char* s, char** end){ return strtof(s, end); });
+}
+
+bool parse_double(const boost::string_ref& str, double& value){
+	return parse_number<double>(str, true, value, [](const char* s, char** end){ return strtod(s, end); });
+}
+
+bool parse_int(const boost::string_ref& str, int& value){
+	return parse_number<int>(str, false, value, [](const char* s, char** end){ return strtoll(s, end, 10); });
+}
+
+size_t find_delimiter(const boost::string_ref& str, const boost::string_ref& delimiter, const size_t pos){
+	if(delimiter.empty()) return pos <= str.size() ? pos : boost::string_ref::npos;
+	if(pos >= str.size() || str.size() - pos < delimiter.size()) return boost::string_ref::npos;
+
+	const char*			begin = str.data();
+	// the last place the delimiter could start
+	const char*			last = begin + str.size() - delimiter.size();
+	const char			first = delimiter[0];
+	for(const char* p = begin + pos; p <= last; ++p){
+		p = static_cast<const char*>(memchr(p, first, static_cast<size_t>(last - p) + 1));
+		if(!p) break;
+		if(memcmp(p + 1, delimiter.data() + 1, delimiter.size() - 1) == 0) return static_cast<size_t>(p - begin);
+	}
+	return boost::string_ref::npos;
+}
+
+size_t count_any_of(const boost::string_ref& str, const boost::string_ref& set){
+	size_t				count = 0;
+	if(set.size() == 1){
+		const char*		p = str.data();
+		const char*		end = p + str.size();
+		while(p < end && (p = static_cast<const char*>(memchr(p, set[0], static_cast<size_t>(end - p)))) != nullptr){
+			++count;
+			++p;
+		}
+		return count;
+	}
+
+	bool				inSet[256] = {};
+	for(auto it = set.begin(), end = set.end(); it != end; ++it) inSet[static_cast<unsigned char>(*it)] = true;
+	for(auto it = str.begin(), end = str.end(); it != end; ++it){
+		if(inSet[static_cast<unsigned char>(*it)]) ++count;
+	}
+	return count;
+}
+
+size_t split_into(const boost::string_ref& str, const boost::string_ref& delimiter, boost::string_ref* out, const size_t capacity, const bool dropEmpty){
+	size_t				count = 0;
+	if(!out || capacity < 1) return 0;
+	split_each(str, delimiter, dropEmpty, [out, capacity, &count](const boost::string_ref& piece){
+		out[count++] = piece;
+		return count < capacity;
+	});
+	return count;
+}
+
+std::string replace_all(const boost::string_ref& str, const std::vector<std::pair<std::string, std::string>>& replacements){
+	// Only spots that start with the first character of some token are compared
+	bool				isFirst[256] = {};
+	for(auto it = replacements.begin(), end = replacements.end(); it != end; ++it){
+		if(!it->first.empty()) isFirst[static_cast<unsigned char>(it->first[0])] = true;
+	}
+
+	std::string			out;
+	out.reserve(str.size());
+	size_t				copied = 0;
+	size_t				i = 0;
+	while(i < str.size()){
+		if(isFirst[static_cast<unsigned char>(str[i])]){
+			const std::pair<std::string, std::string>*	match = nullptr;
+			for(auto it = replacements.begin(), end = replacements.end(); it != end; ++it){
+				const std::string&	token = it->first;
+				if(token.empty() || str.size() - i < token.size()) continue;
+				if(memcmp(str.data() + i, token.data(), token.size()) == 0){
+					match = &(*it);
+					break;
+				}
+			}
+
+			if(match){
+				out.append(str.data() + copied, i - copied);
+				out.append(match->second);
+				i += match->first.size();
+				copied = i;
+				continue;
+			}
+		}
+		++i;
+	}
+	out.append(str.data() + copied, str.size() - copied);
+	return out;
+}
+
 const float string_to_float(const std::string& str){
 	float floatValue = 0.0f;
-	string_to_value<float>(str, floatValue);
+	parse_float(str, floatValue);
 	return floatValue;
 }
 
@@ -198,7 +370,7 @@ const float wstring_to_float(const std::wstring& str){
 
 const int string_to_int(const std::string& str){
 	int intValue = 0;
-	string_to_value<int>(str, intValue);
+	parse_int(str, intValue);
 	return intValue;
 }
 
@@ -210,7 +382,7 @@ const int wstring_to_int(const std::wstring& str){
 
 const double string_to_double(const std::string& str){
 	double doubleValue = 0.0;
-	string_to_value<double>(str, doubleValue);
+	parse_double(str, doubleValue);
 	return doubleValue;
 }
 
@@ -220,38 +392,13 @@ const double wstring_to_double(const std::wstring& str){
 	return doubleValue;
 }
 
-//variation on a function found on stackoverflow
 std::vector<std::string> split(const std::string &str, const std::string &delimiters, bool dropEmpty)
 {
-	std::size_t pos;
-	std::size_t lastPos = 0;
 	std::vector<std::string> splitWords;
-
-	while(true)
-	{
-		pos = str.find(delimiters, lastPos);
-		if(pos == std::string::npos)
-		{
-			pos = str.length();
-
-			if(pos != lastPos || !dropEmpty)
-				splitWords.push_back(std::string(str.data() + lastPos, pos - lastPos));
-
-			break;
-		} else
-		{
-			if(pos != lastPos || !dropEmpty) {
-				std::string tstr = std::string(str.data() + lastPos, pos - lastPos);
-				if(!tstr.empty() || !dropEmpty)
-					splitWords.push_back(tstr);
-				lastPos = pos + delimiters.size();
-				continue;
-			}
-		}
-
-		lastPos = pos + 1;
-	}
-
+	split_each(str, delimiters, dropEmpty, [&splitWords](const boost::string_ref& piece){
+		splitWords.push_back(std::string(piece.data(), piece.size()));
+		return true;
+	});
 	return splitWords;
 }
 
@@ -469,23 +616,7 @@ std::vector<std::wstring> partition(const std::wstring &str, const std::vector<s
 
 int find_count(const std::string &str, const std::string &token)
 {
-	std::size_t pos;
-	std::size_t lastPos = 0;
-	int count = 0;
-
-	while(true)
-	{
-		pos = str.find_first_of(token, lastPos);
-		if(pos == std::string::npos)
-		{
-			break;
-		}
-
-		++count;
-		lastPos = pos + 1;
-	}
-
-	return count;
+	return static_cast<int>(count_any_of(str, token));
 }
 
 int find_count(const std::wstring &str, const std::wstring &token)
@@ -511,35 +642,23 @@ int find_count(const std::wstring &str, const std::wstring &token)
 
 void replace(std::string &str, const std::string &oldToken, const std::string &newToken)
 {
-	std::size_t pos;
-	std::size_t lastPos = 0;
-	std::string tStr = str;
-	str.clear();
-
-	while(true)
-	{
-		pos = tStr.find(oldToken, lastPos);
-		if(pos == std::string::npos)
-		{
-			pos = tStr.length();
-
-			if(pos != lastPos)
-			{
-				str += std::string(tStr.data() + lastPos, pos - lastPos);
-				//str += newToken;
-			}
+	if(oldToken.empty()) return;
 
-			break;
-		} else
-		{
-			str += std::string(tStr.data() + lastPos, pos - lastPos);
-			str += newToken;
-			lastPos = pos + oldToken.size();
-			continue;
-		}
+	std::size_t pos = find_delimiter(str, oldToken);
+	if(pos == std::string::npos) return;
 
-		lastPos = pos + 1;
+	std::string tStr;
+	tStr.reserve(str.size());
+	std::size_t lastPos = 0;
+	while(pos != std::string::npos)
+	{
+		tStr.append(str.data() + lastPos, pos - lastPos);
+		tStr += newToken;
+		lastPos = pos + oldToken.size();
+		pos = find_delimiter(str, oldToken, lastPos);
 	}
+	tStr.append(str.data() + lastPos, str.size() - lastPos);
+	str.swap(tStr);
 }
 
 void replace(std::wstring &str, const std::wstring &oldToken, const std::wstring &newToken)
@@ -692,13 +811,16 @@ void saveStringToFile(const std::wstring &filename, const std::wstring &src)
 
 void tokenize(const std::string& input, const char delim, const std::function<void(const std::string&)>& f)
 {
+	if(!f) return;
+
 	try {
-		std::istringstream			lineBuf(input);
-		while(lineBuf.good()) {
-			std::string				out;
-			getline(lineBuf, out, delim);
-			if(f) f(out);
-		}
+		// one string, reused for every token
+		std::string					out;
+		tokenize_each(input, delim, [&out, &f](const boost::string_ref& piece){
+			out.assign(piece.data(), piece.size());
+			f(out);
+			return true;
+		});
 	} catch(std::exception&) {
 	}
 }
@@ -720,22 +842,25 @@ void to_uppercase(std::wstring& str) {
 }
 
 ci::vec3 parseVector(const std::string &s){
-	auto tokens = ds::split(s, ", ", true);
-	ci::vec3 v;
-	v.x = tokens.size() > 0 ? ds::string_to_float(tokens[0]) : 0.0f;
-	v.y = tokens.size() > 1 ? ds::string_to_float(tokens[1]) : 0.0f;
-	v.z = tokens.size() > 2 ? ds::string_to_float(tokens[2]) : 0.0f;
+	boost::string_ref tokens[3];
+	const size_t count = split_into(s, ", ", tokens, 3, true);
+	float values[3] = { 0.0f, 0.0f, 0.0f };
+	for(size_t i = 0; i < count; ++i) parse_float(tokens[i], values[i]);
 
-	return v;
+	return ci::vec3(values[0], values[1], values[2]);
 }
 
 ci::Rectf parseRect(const std::string &s){
-	auto tokens = ds::split(s, ", ", true);
+	boost::string_ref tokens[4];
+	const size_t count = split_into(s, ", ", tokens, 4, true);
+	float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for(size_t i = 0; i < count; ++i) parse_float(tokens[i], values[i]);
+
 	ci::Rectf v;
-	v.x1 = tokens.size() > 0 ? ds::string_to_float(tokens[0]) : 0.0f;
-	v.y1 = tokens.size() > 1 ? ds::string_to_float(tokens[1]) : 0.0f;
-	v.x2 = tokens.size() > 2 ? ds::string_to_float(tokens[2]) : 0.0f;
-	v.y2 = tokens.size() > 3 ? ds::string_to_float(tokens[3]) : 0.0f;
+	v.x1 = values[0];
+	v.y1 = values[1];
+	v.x2 = values[2];
+	v.y2 = values[3];
 
 	v.x2 += v.x1;
 	v.y2 += v.y1;
@@ -2,11 +2,13 @@
 #ifndef DS_UTIL_STRINGUTIL_H_
 #define DS_UTIL_STRINGUTIL_H_
 
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <sstream>
 #include <string>
 #include <vector>
+#include <boost/utility/string_ref.hpp>
 #include <cinder/Vector.h>
 #include <cinder/Rect.h>
 
@@ -133,6 +135,74 @@ std::string unparseBoolean(const bool b);
 
 std::vector<std::pair<int, std::string>> extractPairs(const std::string& value, const std::string& leftDelim, const std::string& rightDelim);
 
+/// Versions of the above that work on views into the caller's string and don't allocate.
+/// The views are only good as long as the string they point into.
+
+/// Parses the whole string as a number, the same way string_to_value() does: leading whitespace is skipped,
+/// and anything after the number is a failure. Returns false and leaves value alone if it doesn't parse.
+bool parse_float(const boost::string_ref& str, float& value);
+bool parse_double(const boost::string_ref& str, double& value);
+bool parse_int(const boost::string_ref& str, int& value);
+
+/// Returns the position of delimiter (the whole string) at or after pos, or npos.
+/// Scans for the first character with memchr, which the C runtime vectorizes.
+size_t find_delimiter(const boost::string_ref& str, const boost::string_ref& delimiter, const size_t pos = 0);
+
+/// Counts the characters in str that are any of the characters in set. Same as find_count().
+size_t count_any_of(const boost::string_ref& str, const boost::string_ref& set);
+
+/// Calls fn(boost::string_ref) with each piece of str between delimiters, giving the same pieces as split().
+/// fn returns false to stop early. An empty delimiter gives back the whole string.
+template <typename Fn>
+void split_each(const boost::string_ref& str, const boost::string_ref& delimiter, const bool dropEmpty, Fn&& fn){
+	if(delimiter.empty()){
+		if(!str.empty() || !dropEmpty) fn(str);
+		return;
+	}
+
+	size_t lastPos = 0;
+	while(true){
+		const size_t pos = find_delimiter(str, delimiter, lastPos);
+		if(pos == boost::string_ref::npos){
+			if(str.size() != lastPos || !dropEmpty) fn(str.substr(lastPos));
+			return;
+		}
+
+		if(pos != lastPos || !dropEmpty){
+			if(!fn(str.substr(lastPos, pos - lastPos))) return;
+			lastPos = pos + delimiter.size();
+		} else {
+			// Like split(), when dropping empties a delimiter at the start of a piece only skips one character
+			lastPos = pos + 1;
+		}
+	}
+}
+
+/// Writes up to capacity pieces of split() into out, and returns how many were written. The rest are ignored.
+size_t split_into(const boost::string_ref& str, const boost::string_ref& delimiter, boost::string_ref* out, const size_t capacity, const bool dropEmpty = false);
+
+/// Calls fn(boost::string_ref) with each piece between delim characters, giving the same pieces as tokenize(),
+/// including the empty ones. fn returns false to stop early.
+template <typename Fn>
+void tokenize_each(const boost::string_ref& input, const char delim, Fn&& fn){
+	size_t lastPos = 0;
+	while(true){
+		const char* found = (lastPos < input.size()) ? static_cast<const char*>(memchr(input.data() + lastPos, delim, input.size() - lastPos)) : nullptr;
+		if(!found){
+			fn(input.substr(lastPos));
+			return;
+		}
+
+		const size_t pos = static_cast<size_t>(found - input.data());
+		if(!fn(input.substr(lastPos, pos - lastPos))) return;
+		lastPos = pos + 1;
+	}
+}
+
+/// Replaces each token (first) with its replacement (second) in one pass over str.
+/// Where more than one token matches at the same spot, the first in the list wins. Empty tokens are ignored.
+std::string replace_all(const boost::string_ref& str, const std::vector<std::pair<std::string, std::string>>& replacements);
+
 } // namespace ds
 
 #endif // DS_UTIL_STRINGUTIL_H_
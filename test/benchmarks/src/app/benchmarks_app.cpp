@@ -0,0 +1,68 @@
+#include "stdafx.h"
+
+#include "benchmarks_app.h"
+
+#include <algorithm>
+#include <iostream>
+#include <ds/app/engine/engine.h>
+#include <ds/debug/logger.h>
+#include <ds/util/string_util.h>
+
+#include <cinder/app/RendererGl.h>
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+namespace downstream {
+
+benchmarks_app::benchmarks_app()
+	: ds::App()
+	, mRan(false)
+	, mScale(mEngine.getAppSettings().getFloat("benchmarks:scale", 0, 1.0f))
+	, mMinMs(mEngine.getAppSettings().getInt("benchmarks:min_ms", 0, 200))
+{
+	std::string only = mEngine.getAppSettings().getString("benchmarks:only", 0, "");
+	only.erase(std::remove(only.begin(), only.end(), ' '), only.end());
+	mOnly = ds::split(only, ",", true);
+}
+
+void benchmarks_app::update(){
+	ds::App::update();
+	if(mRan) return;
+	mRan = true;
+
+	run("string_util", [](benchmarks::Timer& t){ benchmarks::benchmarkStringUtil(t); });
+	run("strokes", [](benchmarks::Timer& t){ benchmarks::benchmarkStrokes(t); });
+	run("resource_query", [](benchmarks::Timer& t){ benchmarks::benchmarkResourceQuery(t); });
+	run("resource_resolver", [this](benchmarks::Timer& t){ benchmarks::benchmarkResourceResolver(t, mEngine); });
+	run("tweens", [this](benchmarks::Timer& t){ benchmarks::benchmarkTweens(t, mEngine); });
+	run("animation_scripts", [this](benchmarks::Timer& t){ benchmarks::benchmarkAnimationScripts(t, mEngine); });
+	run("profiler", [this](benchmarks::Timer& t){ benchmarks::benchmarkProfiler(t, mEngine); });
+	run("data_buffer", [](benchmarks::Timer& t){ benchmarks::benchmarkDataBuffer(t); });
+	run("events", [](benchmarks::Timer& t){ benchmarks::benchmarkEvents(t); });
+	run("scroll_list", [this](benchmarks::Timer& t){ benchmarks::benchmarkScrollList(t, mEngine); });
+	run("sprite_updates", [this](benchmarks::Timer& t){ benchmarks::benchmarkSpriteUpdates(t, mEngine); });
+	run("layouts", [this](benchmarks::Timer& t){ benchmarks::benchmarkLayouts(t, mEngine); });
+	run("smart_layout", [this](benchmarks::Timer& t){ benchmarks::benchmarkSmartLayout(t, mEngine); });
+	run("key_value_store", [](benchmarks::Timer& t){ benchmarks::benchmarkKeyValueStore(t); });
+	run("persistent_cache", [](benchmarks::Timer& t){ benchmarks::benchmarkPersistentCache(t); });
+	run("markdown", [](benchmarks::Timer& t){ benchmarks::benchmarkMarkdown(t); });
+	run("exif", [](benchmarks::Timer& t){ benchmarks::benchmarkExif(t); });
+	run("auto_update", [this](benchmarks::Timer& t){ benchmarks::benchmarkAutoUpdate(t, mEngine); });
+
+	// ctest looks for this, so a suite that crashes or hangs fails the run
+	std::cout << "benchmarks: done" << std::endl;
+	quit();
+}
+
+void benchmarks_app::run(const std::string& suite, const std::function<void(benchmarks::Timer&)>& fn){
+	if(!mOnly.empty() && std::find(mOnly.begin(), mOnly.end(), suite) == mOnly.end()) return;
+
+	benchmarks::Timer timer(suite, static_cast<double>(mScale), static_cast<double>(mMinMs));
+	fn(timer);
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::benchmarks_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
@@ -0,0 +1,41 @@
+#ifndef _BENCHMARKS_APP_H_
+#define _BENCHMARKS_APP_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+
+namespace benchmarks {
+class Timer;
+}
+
+namespace downstream {
+
+/**
+ * \class benchmarks_app
+ * Runs the micro-benchmark suites once the engine is up, prints the results and quits.
+ * Runs headless (see settings/engine.xml), so the engine suites don't depend on a GPU.
+ * settings/app_settings.xml picks the suites and how big and long each measurement is.
+ */
+class benchmarks_app : public ds::App {
+public:
+	benchmarks_app();
+
+	virtual void				update() override;
+
+private:
+	/// Runs fn with a Timer for suite, unless benchmarks:only leaves it out
+	void						run(const std::string& suite, const std::function<void(benchmarks::Timer&)>& fn);
+
+	/// The suites run on the first update, after the engine has finished setting up
+	bool						mRan;
+	const float					mScale;
+	const int					mMinMs;
+	std::vector<std::string>	mOnly;
+};
+
+} // !namespace downstream
+
+#endif // !_BENCHMARKS_APP_H_
@@ -0,0 +1,134 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cinder/Easing.h>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/sprite/sprite.h>
+#include <ds/ui/tween/animation_script.h>
+#include <ds/util/string_util.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// An animate-on script like the ones layouts set on every tile. It sticks to the commands that don't need the
+/// cached animate on targets, so the previous version below can run it through the public tween calls.
+const std::string			SCRIPT = "position:0, 40, 0; scale:0.9, 0.9, 1; opacity:1; ease:outQuint; duration:0.35; delay:0.05";
+
+/// What runReversibleAnimationScript() did before scripts were compiled: split and parse the script on
+/// every call, into a map keyed by command, then apply it
+float previous_run(ds::ui::Sprite& s, const std::string& animScript, const float defaultDuration, const float addedDelay) {
+	std::vector<std::string> commands = ds::split(animScript, "; ", true);
+	if (commands.empty()) return 0.f;
+
+	ci::EaseFn easing = ci::EaseInOutCubic();
+	float dur = defaultDuration;
+	float delayey = addedDelay;
+
+	std::map<std::string, ci::vec3> animationCommands;
+	for (auto it = commands.begin(); it < commands.end(); ++it){
+		std::vector<std::string> commandProperties = ds::split((*it), ":", true);
+		if (commandProperties.empty()) continue;
+
+		std::string keyey = commandProperties.front();
+		if (keyey == "ease"){
+			easing = ds::ui::SpriteAnimatable::getEasingByString(commandProperties[1]);
+			continue;
+		} else if (keyey == "duration"){
+			ds::string_to_value<float>(commandProperties[1], dur);
+			continue;
+		} else if (keyey == "delay"){
+			float rootDelay = 0.0f;
+			ds::string_to_value<float>(commandProperties[1], rootDelay);
+			delayey += rootDelay;
+			continue;
+		}
+
+		ci::vec3 destination = ci::vec3();
+		if (commandProperties.size() > 1){
+			std::vector<std::string> destinationTokens = ds::split(commandProperties[1], ", ", true);
+			ds::string_to_value<float>(destinationTokens[0], destination.x);
+			if (destinationTokens.size() > 1) ds::string_to_value<float>(destinationTokens[1], destination.y);
+			if (destinationTokens.size() > 2) ds::string_to_value<float>(destinationTokens[2], destination.z);
+		}
+		animationCommands[keyey] = destination;
+	}
+
+	for (auto it = animationCommands.begin(); it != animationCommands.end(); ++it){
+		if (it->first == "scale") s.tweenScale(it->second, dur, delayey, easing);
+		else if (it->first == "opacity") s.tweenOpacity(it->second.x, dur, delayey, easing);
+		else if (it->first == "position") s.tweenPosition(it->second, dur, delayey, easing);
+	}
+	return delayey + dur;
+}
+
+}
+
+void benchmarkAnimationScripts(Timer& t, ds::Engine& engine) {
+	ds::ui::Sprite*			holder = new ds::ui::Sprite(engine);
+	engine.getRootSprite().addChildPtr(holder);
+	std::vector<ds::ui::Sprite*>	sprites;
+	for (size_t i = 0, count = t.scaled(1000); i < count; ++i) {
+		ds::ui::Sprite*		s = new ds::ui::Sprite(engine, 32.0f, 24.0f);
+		holder->addChildPtr(s);
+		sprites.push_back(s);
+	}
+	const float				defaultDuration = engine.getAnimDur();
+	const std::string		perSprite = "per sprite, " + std::to_string(sprites.size()) + " sprites";
+
+	// The parse on its own, which is all that compiling saves
+	const double			parse = t.time("parse, previous", 1, []() {
+		std::vector<std::string>	commands = ds::split(SCRIPT, "; ", true);
+		std::map<std::string, ci::vec3>	parsed;
+		for (auto& c : commands) {
+			const auto		properties = ds::split(c, ":", true);
+			ci::vec3		v;
+			if (properties.size() > 1) ds::string_to_value<float>(properties[1], v.x);
+			parsed[properties.front()] = v;
+		}
+		keep(parsed);
+	});
+	const double			compile = t.time("compile", 1, []() {
+		const ds::ui::AnimationScript	script(SCRIPT);
+		keep(script);
+	});
+	const double			lookup = t.time("AnimationScript::get, cached", 1, []() {
+		keep(ds::ui::AnimationScript::get(SCRIPT));
+	});
+	t.compare("cached lookup vs parse", parse, lookup);
+	t.compare("cached lookup vs compile", compile, lookup);
+
+	// Applying the script to every sprite, which starts three tweens on each. Starting a tween replaces the
+	// one already running on the same property, so repeating doesn't pile them up.
+	const double			previous = t.time("previous parse and run, " + perSprite, sprites.size(), [&sprites, defaultDuration]() {
+		float				total = 0.0f;
+		for (size_t i = 0; i < sprites.size(); ++i) total += previous_run(*sprites[i], SCRIPT, defaultDuration, static_cast<float>(i % 20) * 0.01f);
+		keep(total);
+	});
+	const double			byText = t.time("runAnimationScript, " + perSprite, sprites.size(), [&sprites]() {
+		float				total = 0.0f;
+		for (size_t i = 0; i < sprites.size(); ++i) total += sprites[i]->runAnimationScript(SCRIPT, static_cast<float>(i % 20) * 0.01f);
+		keep(total);
+	});
+	const auto				compiled = ds::ui::AnimationScript::get(SCRIPT);
+	const double			run = t.time("AnimationScript::run, " + perSprite, sprites.size(), [&sprites, &compiled]() {
+		keep(compiled->run(sprites, 0.0f, 0.01f));
+	});
+	for (auto s : sprites) s->setAnimateOnScript(SCRIPT);
+	const double			animateOn = t.time("tweenAnimateOn, " + perSprite, sprites.size(), [holder]() {
+		keep(holder->tweenAnimateOn(true, 0.0f, 0.01f));
+	});
+	t.compare("runAnimationScript vs previous", previous, byText);
+	t.compare("AnimationScript::run vs previous", previous, run);
+	t.compare("tweenAnimateOn vs previous", previous, animateOn);
+
+	for (auto s : sprites) s->animStop();
+	holder->release();
+}
+
+} // namespace benchmarks
@@ -0,0 +1,186 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ds/app/app_defs.h>
+#include <ds/app/auto_update.h>
+#include <ds/app/auto_update_list.h>
+#include <ds/app/engine/engine.h>
+#include <ds/debug/frame_profiler.h>
+#include <ds/params/update_params.h>
+
+namespace benchmarks {
+
+namespace {
+
+const float					FRAME_TIME = 1.0f / 60.0f;
+/// Loop iterations in an expensive client's update, a few microseconds of work
+const int					EXPENSIVE_WORK = 2000;
+const int					INTERVAL = 4;
+const unsigned				THREADS = 4;
+
+/// Does a little arithmetic every update, so there's something to skip
+int spin(const int work, int value) {
+	for (int i = 0; i < work; ++i) value = value * 1664525 + 1013904223;
+	return value;
+}
+
+class Client : public ds::AutoUpdate {
+public:
+	Client(ds::ui::SpriteEngine& e, const int work)
+			: ds::AutoUpdate(e)
+			, mValue(0)
+			, mWork(work) {
+	}
+
+	int						mValue;
+
+protected:
+	virtual void			update(const ds::UpdateParams&) override { mValue = spin(mWork, mValue); }
+
+private:
+	const int				mWork;
+};
+
+/// How AutoUpdateList kept its clients before slots: new ones waited in a vector until the next update,
+/// and removing one searched and erased from both vectors
+class PreviousList {
+public:
+	class Client {
+	public:
+		Client(PreviousList& list, const int work) : mList(list), mWork(work), mValue(0) { mList.mWaiting.push_back(this); }
+		virtual ~Client() { mList.remove(this); }
+		virtual void		update(const ds::UpdateParams&) { mValue = spin(mWork, mValue); }
+
+		PreviousList&		mList;
+		const int			mWork;
+		int					mValue;
+	};
+
+	void					update(const ds::UpdateParams& p) {
+		mRunning.insert(mRunning.end(), mWaiting.begin(), mWaiting.end());
+		mWaiting.clear();
+		for (auto it : mRunning) it->update(p);
+	}
+
+	void					remove(Client* v) {
+		mRunning.erase(std::remove(mRunning.begin(), mRunning.end(), v), mRunning.end());
+		mWaiting.erase(std::remove(mWaiting.begin(), mWaiting.end(), v), mWaiting.end());
+	}
+
+private:
+	std::vector<Client*>	mRunning;
+	std::vector<Client*>	mWaiting;
+};
+
+/// Simulated frames, carrying on from the engine clock like the unit tests do
+class Frames {
+public:
+	Frames(ds::Engine& e) : mNow(e.getElapsedTimeSeconds()) {}
+
+	const ds::UpdateParams&	next() {
+		mNow += FRAME_TIME;
+		mParams.setDeltaTime(FRAME_TIME);
+		mParams.setElapsedTime(static_cast<float>(mNow));
+		return mParams;
+	}
+
+private:
+	double					mNow;
+	ds::UpdateParams		mParams;
+};
+
+}
+
+void benchmarkAutoUpdate(Timer& t, ds::Engine& engine) {
+	ds::AutoUpdateList&		list = engine.getAutoUpdateList(ds::AutoUpdateType::SERVER);
+	Frames					frames(engine);
+	const size_t			count = t.scaled(2000);
+	const std::string		clients = ", " + std::to_string(count) + " clients";
+
+	// Every client every frame, doing almost nothing, so the list's own cost shows
+	{
+		PreviousList		previousList;
+		std::vector<std::unique_ptr<PreviousList::Client>>	previous;
+		for (size_t i = 0; i < count; ++i) previous.emplace_back(new PreviousList::Client(previousList, 1));
+		const double		previousFrame = t.time("update, previous vectors" + clients, 1, [&]() { previousList.update(frames.next()); });
+
+		std::vector<std::unique_ptr<Client>>	current;
+		for (size_t i = 0; i < count; ++i) current.emplace_back(new Client(engine, 1));
+		const double		slotFrame = t.time("update, slots" + clients, 1, [&]() { list.update(frames.next()); });
+		t.compare("update, slots vs previous", previousFrame, slotFrame);
+
+		// Per-client timing is recorded at DETAIL
+		ds::FrameProfiler::setLevel(ds::FrameProfiler::DETAIL);
+		const double		timedFrame = t.time("update, slots, timing each client" + clients, 1, [&]() {
+			list.update(frames.next());
+			ds::FrameProfiler::nextFrame();
+		});
+		ds::FrameProfiler::setLevel(ds::FrameProfiler::OFF);
+		t.report("timing each client", (timedFrame - slotFrame) / static_cast<double>(count), "ns/client");
+	}
+
+	// Services coming and going: add a batch, run a frame, then destroy them oldest first
+	const double			previousChurn = t.time("add, update and remove, previous vectors" + clients, count, [&]() {
+		PreviousList		previousList;
+		std::vector<std::unique_ptr<PreviousList::Client>>	previous;
+		for (size_t i = 0; i < count; ++i) previous.emplace_back(new PreviousList::Client(previousList, 1));
+		previousList.update(frames.next());
+		previous.clear();
+	});
+	const double			slotChurn = t.time("add, update and remove, slots" + clients, count, [&]() {
+		std::vector<std::unique_ptr<Client>>	current;
+		for (size_t i = 0; i < count; ++i) current.emplace_back(new Client(engine, 1));
+		list.update(frames.next());
+		current.clear();
+	});
+	t.compare("add, update and remove, slots vs previous", previousChurn, slotChurn);
+
+	// The same clients made on worker threads, like loaders that start services as they finish
+	t.time("add from " + std::to_string(THREADS) + " threads, update and remove" + clients, count, [&]() {
+		std::vector<std::unique_ptr<Client>>	current(count);
+		std::vector<std::thread>	threads;
+		for (unsigned th = 0; th < THREADS; ++th) {
+			threads.emplace_back([&current, &engine, th, count]() {
+				for (size_t i = th; i < count; i += THREADS) current[i].reset(new Client(engine, 1));
+			});
+		}
+		for (auto& th : threads) th.join();
+		list.update(frames.next());
+		current.clear();
+	});
+
+	// Expensive clients every frame, or every few frames with their phases spread out. The worst frame
+	// shows whether the spread works: if they all landed together it'd be as bad as every frame.
+	const size_t			expensive = t.scaled(200);
+	const std::string		expensiveClients = ", " + std::to_string(expensive) + " expensive clients";
+	std::vector<std::unique_ptr<Client>>	current;
+	for (size_t i = 0; i < expensive; ++i) current.emplace_back(new Client(engine, EXPENSIVE_WORK));
+	list.update(frames.next());
+	auto					worstFrame = [&]() {
+		double				worst = 0.0;
+		for (int i = 0; i < INTERVAL * 10; ++i) {
+			const auto		start = std::chrono::steady_clock::now();
+			list.update(frames.next());
+			worst = std::max(worst, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+		}
+		return worst;
+	};
+	const double			everyFrame = t.time("update, every frame" + expensiveClients, 1, [&]() { list.update(frames.next()); });
+	t.report("worst frame, every frame" + expensiveClients, worstFrame(), "us");
+	for (auto& c : current) c->setUpdateInterval(INTERVAL);
+	const double			spread = t.time("update, every " + std::to_string(INTERVAL) + " frames" + expensiveClients, 1, [&]() {
+		list.update(frames.next());
+	});
+	t.report("worst frame, every " + std::to_string(INTERVAL) + " frames" + expensiveClients, worstFrame(), "us");
+	t.compare("every " + std::to_string(INTERVAL) + " frames vs every frame", everyFrame, spread);
+}
+
+} // namespace benchmarks
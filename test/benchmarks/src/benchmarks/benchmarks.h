@@ -0,0 +1,80 @@
+#ifndef _BENCHMARKS_BENCHMARKS_BENCHMARKS_H_
+#define _BENCHMARKS_BENCHMARKS_BENCHMARKS_H_
+
+namespace ds {
+class Engine;
+}
+
+namespace benchmarks {
+
+class Timer;
+
+/// Each suite times its work through the Timer, which prints the results as it goes.
+/// Where there's an older way of doing the same thing, the suite times both and compares them.
+
+/// Splitting, tokenizing, number parsing and replacing, through the allocating functions and the string views
+void			benchmarkStringUtil(Timer&);
+
+/// Five fingers of samples through the tessellator, the stamps into meshes, and the samples through the codec
+void			benchmarkStrokes(Timer&);
+
+/// Resolving a few thousand resources from a generated table: opened per lookup, pooled, and batched with queryMany
+void			benchmarkResourceQuery(Timer&);
+
+/// Screens resolving their resources as they are built: synchronously through the ResourceList, then batched through
+/// the ResourceResolver, driving whole engine frames until every callback has fired
+void			benchmarkResourceResolver(Timer&, ds::Engine&);
+
+/// A couple of thousand sprites tweening position, scale and opacity at once, through the Timeline and the BatchTweener
+void			benchmarkTweens(Timer&, ds::Engine&);
+
+/// One animate-on script applied to a thousand sprites: parsed per sprite the way it used to be, looked up in the
+/// script cache by runAnimationScript(), and run compiled through AnimationScript::run() and tweenAnimateOn()
+void			benchmarkAnimationScripts(Timer&, ds::Engine&);
+
+/// What a profiled scope costs with the profiler off, timing phases and timing every sprite, and what each level
+/// adds to a whole engine frame over a couple of thousand sprites
+void			benchmarkProfiler(Timer&, ds::Engine&);
+
+/// A frame of text sprite attributes through the DataBuffer: written with the previous four byte string lengths and
+/// the varint ones, and read back by copying every string, with read<std::string>(), and in place with readStringRef()
+void			benchmarkDataBuffer(Timer&);
+
+/// Sending an event that a handful of five hundred clients want: through catch-all listeners that each look the type
+/// up, the way every client used to, and through the typed listener table. Also a coalesced burst and subscribing.
+void			benchmarkEvents(Timer&);
+
+/// Scroll updates down a ScrollList of twenty thousand items: the binary searched visible range against a scan of
+/// every item, against a short list, with prefetching, and with variable item sizes
+void			benchmarkScrollList(Timer&, ds::Engine&);
+
+/// Whole engine updates over a large, mostly static tree: visiting every sprite each frame, and with the tree handed
+/// to the scheduled update list, both standing still and with a few sprites moving
+void			benchmarkSpriteUpdates(Timer&, ds::Engine&);
+
+/// Runs a deep nested layout loaded from xml with everything changed, nothing changed and one box changed, and
+/// a burst of changes run each time vs invalidated and run once in the next update
+void			benchmarkLayouts(Timer&, ds::Engine&);
+
+/// Swaps between content models on a detail screen SmartLayout, with the bindings compiled and parsed each time
+void			benchmarkSmartLayout(Timer&, ds::Engine&);
+
+/// KeyValueStore against a copy of the previous map per type store: hits, misses, defaults, copies and empty stores
+void			benchmarkKeyValueStore(Timer&);
+
+/// Inserts 100k rows into a PersistentCache, writes them out, queries and updates them, then reopens the cache
+void			benchmarkPersistentCache(Timer&);
+
+/// Converts a corpus of long CMS articles with and without the markdown cache, and typing into one with MarkdownToPango
+void			benchmarkMarkdown(Timer&);
+
+/// ExifParser against easyexif on an EXIF block in memory and on a folder of photos, and the batch readTags API
+void			benchmarkExif(Timer&);
+
+/// AutoUpdateList against the previous vectors for updates and add and remove churn, adding from threads,
+/// per-client timing, and expensive clients every frame vs spread across frames
+void			benchmarkAutoUpdate(Timer&, ds::Engine&);
+
+} // namespace benchmarks
+
+#endif // !_BENCHMARKS_BENCHMARKS_BENCHMARKS_H_
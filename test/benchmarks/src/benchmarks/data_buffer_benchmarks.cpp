@@ -0,0 +1,168 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <vector>
+#include <ds/app/app_defs.h>
+#include <ds/data/data_buffer.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// Attribute ids, as Sprite and Text write them
+const char					SPRITE_ID_ATTRIBUTE = 1;
+const char					SIZE_ATT = 3;
+const char					FLAGS_ATT = 4;
+const char					POSITION_ATT = 5;
+const char					OPACITY_ATT = 9;
+const char					FONTNAME_ATT = 80;
+const char					TEXT_ATT = 81;
+const size_t				STRINGS_PER_SPRITE = 4;
+
+/// What a text sprite sends when its text changes: the id, size, flags with the shader, position, opacity,
+/// then the text and font
+struct Attributes {
+	ds::sprite_id_t			mId;
+	float					mSize[3];
+	int						mFlags;
+	std::string				mShaderLocation;
+	std::string				mShaderName;
+	float					mPosition[3];
+	float					mOpacity;
+	std::string				mText;
+	std::string				mFont;
+};
+
+std::vector<Attributes> make_sprites(const size_t count) {
+	std::vector<Attributes>	ans(count);
+	for (size_t i = 0; i < count; ++i) {
+		Attributes&			a = ans[i];
+		a.mId = static_cast<ds::sprite_id_t>(i + 1);
+		a.mSize[0] = 200.0f; a.mSize[1] = 40.0f; a.mSize[2] = 1.0f;
+		a.mFlags = 3;
+		a.mShaderLocation = "";
+		a.mShaderName = "base";
+		a.mPosition[0] = static_cast<float>(i % 10) * 100.0f; a.mPosition[1] = static_cast<float>(i / 10) * 20.0f; a.mPosition[2] = 0.0f;
+		a.mOpacity = 1.0f;
+		a.mText = "Frame " + std::to_string(i * 7) + " of the attract loop";
+		a.mFont = "Noto Sans Bold";
+	}
+	return ans;
+}
+
+/// Before strings were written with a varint length, they had a four byte one
+void previous_add(ds::DataBuffer& buf, const std::string& s) {
+	buf.add(static_cast<unsigned>(s.size()));
+	buf.addRaw(s.data(), static_cast<unsigned>(s.size()));
+}
+
+/// And read<std::string>() copied each one into a staging buffer, then into a new string
+std::string previous_read(ds::DataBuffer& buf, std::vector<char>& staging) {
+	const unsigned			size = buf.read<unsigned>();
+	staging.resize(size);
+	if (size > 0 && !buf.readRaw(staging.data(), size)) return std::string();
+	return std::string(staging.data(), size);
+}
+
+template <typename AddString>
+void encode(ds::DataBuffer& buf, const std::vector<Attributes>& sprites, const AddString& addString) {
+	buf.clear();
+	for (auto& a : sprites) {
+		buf.add(SPRITE_ID_ATTRIBUTE);
+		buf.add(a.mId);
+		buf.add(SIZE_ATT);
+		for (auto f : a.mSize) buf.add(f);
+		buf.add(FLAGS_ATT);
+		buf.add(a.mFlags);
+		addString(buf, a.mShaderLocation);
+		addString(buf, a.mShaderName);
+		buf.add(POSITION_ATT);
+		for (auto f : a.mPosition) buf.add(f);
+		buf.add(OPACITY_ATT);
+		buf.add(a.mOpacity);
+		buf.add(TEXT_ATT);
+		addString(buf, a.mText);
+		buf.add(FONTNAME_ATT);
+		addString(buf, a.mFont);
+		buf.add(ds::TERMINATOR_CHAR);
+	}
+}
+
+/// Reads back what encode() wrote, handing each string to readString. Answers a sum of everything read,
+/// so none of it can be skipped.
+template <typename ReadString>
+size_t decode(ds::DataBuffer& buf, const size_t count, const ReadString& readString) {
+	buf.seekBegin();
+	size_t					total = 0;
+	for (size_t i = 0; i < count; ++i) {
+		buf.read<char>();
+		total += static_cast<size_t>(buf.read<ds::sprite_id_t>());
+		buf.read<char>();
+		for (int j = 0; j < 3; ++j) total += static_cast<size_t>(buf.read<float>());
+		buf.read<char>();
+		total += static_cast<size_t>(buf.read<int>());
+		total += readString(buf);
+		total += readString(buf);
+		buf.read<char>();
+		for (int j = 0; j < 3; ++j) total += static_cast<size_t>(buf.read<float>());
+		buf.read<char>();
+		total += static_cast<size_t>(buf.read<float>());
+		buf.read<char>();
+		total += readString(buf);
+		buf.read<char>();
+		total += readString(buf);
+		buf.read<char>();
+	}
+	return total;
+}
+
+}
+
+void benchmarkDataBuffer(Timer& t) {
+	const std::vector<Attributes>	sprites = make_sprites(t.scaled(1000));
+	const std::string		perSprite = ", " + std::to_string(sprites.size()) + " text sprites";
+	ds::DataBuffer			previousBuf, buf;
+
+	const double			previousEncode = t.time("encode, previous four byte lengths" + perSprite, sprites.size(), [&]() {
+		encode(previousBuf, sprites, previous_add);
+		keep(previousBuf);
+	});
+	const double			varintEncode = t.time("encode, varint lengths" + perSprite, sprites.size(), [&]() {
+		encode(buf, sprites, [](ds::DataBuffer& b, const std::string& s) { b.add(s); });
+		keep(buf);
+	});
+	t.compare("encode, varint vs previous", previousEncode, varintEncode);
+	t.report("previous bytes", static_cast<double>(previousBuf.size()) / static_cast<double>(sprites.size()), "bytes/sprite");
+	t.report("varint bytes", static_cast<double>(buf.size()) / static_cast<double>(sprites.size()), "bytes/sprite");
+
+	std::vector<char>		staging;
+	const double			previousDecode = t.time("decode, previous string copies" + perSprite, sprites.size(), [&]() {
+		keep(decode(previousBuf, sprites.size(), [&staging](ds::DataBuffer& b) { return previous_read(b, staging).size(); }));
+	});
+	const double			copyDecode = t.time("decode, read<std::string>" + perSprite, sprites.size(), [&]() {
+		keep(decode(buf, sprites.size(), [](ds::DataBuffer& b) { return b.read<std::string>().size(); }));
+	});
+	const double			refDecode = t.time("decode, readStringRef" + perSprite, sprites.size(), [&]() {
+		keep(decode(buf, sprites.size(), [](ds::DataBuffer& b) { return b.readStringRef().size(); }));
+	});
+	// What Text does: only copies a string out when it's different from the one it already has. After the
+	// warm up run every string is the same, like a frame where the text didn't change.
+	std::vector<std::string>	held(sprites.size() * STRINGS_PER_SPRITE);
+	const double			unchangedDecode = t.time("decode, readStringRef, copying changed strings" + perSprite, sprites.size(), [&]() {
+		size_t				next = 0;
+		keep(decode(buf, sprites.size(), [&held, &next](ds::DataBuffer& b) {
+			const boost::string_ref	s = b.readStringRef();
+			std::string&	h = held[next++];
+			if (s != h) h.assign(s.data(), s.size());
+			return s.size();
+		}));
+	});
+	t.compare("decode, read<std::string> vs previous", previousDecode, copyDecode);
+	t.compare("decode, readStringRef vs previous", previousDecode, refDecode);
+	t.compare("decode, copying changed strings vs previous", previousDecode, unchangedDecode);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ds/app/event.h>
+#include <ds/app/event_client.h>
+#include <ds/app/event_notifier.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// What a few clients want, like a directory watcher's change
+class WantedEvent : public ds::RegisteredEvent<WantedEvent> {
+public:
+	WantedEvent() {}
+};
+
+/// What every other client is listening for instead
+class OtherEvent : public ds::RegisteredEvent<OtherEvent> {
+public:
+	OtherEvent() {}
+};
+
+typedef std::vector<std::unique_ptr<ds::EventClient>>	Clients;
+
+/// How every client used to listen: a catch-all on the notifier, then a lookup of the event's type in its own map
+class PreviousClient {
+public:
+	PreviousClient(ds::EventNotifier& n, const size_t what, const std::function<void(const ds::Event&)>& fn)
+		: mClient(n, [this](const ds::Event* e) { onEvent(e); })
+	{
+		mCallbacks[what] = fn;
+	}
+
+private:
+	void onEvent(const ds::Event* e) {
+		if (!e) return;
+		auto found = mCallbacks.find(e->mWhat);
+		if (found != mCallbacks.end()) found->second(*e);
+	}
+
+	ds::EventClient			mClient;
+	std::unordered_map<size_t, std::function<void(const ds::Event&)>>	mCallbacks;
+};
+
+}
+
+void benchmarkEvents(Timer& t) {
+	const size_t			clientCount = t.scaled(500);
+	const size_t			wanting = 5;
+	const std::string		clients = ", " + std::to_string(clientCount) + " clients, " + std::to_string(wanting) + " listening";
+	const WantedEvent		wanted;
+	size_t					heard = 0;
+
+	ds::EventNotifier		previousNotifier;
+	std::vector<std::unique_ptr<PreviousClient>>	previous;
+	for (size_t i = 0; i < clientCount; ++i) {
+		const size_t		what = i < wanting ? WantedEvent::WHAT() : OtherEvent::WHAT();
+		previous.emplace_back(new PreviousClient(previousNotifier, what, [&heard](const ds::Event&) { ++heard; }));
+	}
+	const double			catchAll = t.time("notify, catch-all clients" + clients, 1, [&]() {
+		previousNotifier.notify(wanted);
+	});
+
+	ds::EventNotifier		notifier;
+	Clients					typed;
+	for (size_t i = 0; i < clientCount; ++i) {
+		typed.emplace_back(new ds::EventClient(notifier, nullptr));
+		if (i < wanting) typed.back()->listenToEvents<WantedEvent>([&heard](const WantedEvent&) { ++heard; });
+		else typed.back()->listenToEvents<OtherEvent>([&heard](const OtherEvent&) { ++heard; });
+	}
+	const double			table = t.time("notify, typed listeners" + clients, 1, [&]() {
+		notifier.notify(wanted);
+	});
+	t.compare("notify, typed vs catch-all", catchAll, table);
+
+	// A burst of the same event in one frame: every one sent right away, or coalesced and sent once at the end
+	const size_t			burst = 20;
+	const double			immediate = t.time("burst of " + std::to_string(burst) + ", notify" + clients, 1, [&]() {
+		for (size_t i = 0; i < burst; ++i) notifier.notify(wanted);
+	});
+	const double			deferred = t.time("burst of " + std::to_string(burst) + ", notifyDeferred and flush" + clients, 1, [&]() {
+		for (size_t i = 0; i < burst; ++i) notifier.notifyDeferred(wanted);
+		notifier.flushDeferred();
+	});
+	t.compare("burst, deferred vs notify", immediate, deferred);
+
+	// Subscribing and unsubscribing, which sprites do as they're built and released
+	t.time("listenToEvents and stopListeningToEvents", 1, [&]() {
+		typed.back()->listenToEvents<WantedEvent>([&heard](const WantedEvent&) { ++heard; });
+		typed.back()->stopListeningToEvents<WantedEvent>();
+	});
+	keep(heard);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,241 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/temp_file.h"
+#include "benchmarks/timer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ds/util/exif.h>
+#include <ds/util/exif_parser.h>
+
+namespace benchmarks {
+
+namespace {
+
+typedef ds::ExifParser		Exif;
+
+/// Roughly a phone photo, most of which is the compressed image after the EXIF block
+const size_t				FILE_BYTES = 3 * 1024 * 1024;
+const size_t				FILES = 100;
+
+std::string u16(const uint16_t v) {
+	return std::string{ static_cast<char>(v & 0xFF), static_cast<char>(v >> 8) };
+}
+
+std::string u32(const uint32_t v) {
+	return u16(static_cast<uint16_t>(v & 0xFFFF)) + u16(static_cast<uint16_t>(v >> 16));
+}
+
+/// One little endian IFD entry, with its value as the bytes it's stored as
+struct Field {
+	uint16_t				mTag;
+	uint16_t				mType;
+	uint32_t				mCount;
+	std::string				mData;
+};
+
+Field ascii(const uint16_t tag, const std::string& s) {
+	return Field{ tag, 2, static_cast<uint32_t>(s.size() + 1), s + std::string(1, '\0') };
+}
+
+Field short_field(const uint16_t tag, const uint16_t v) {
+	return Field{ tag, 3, 1, u16(v) };
+}
+
+Field long_field(const uint16_t tag, const uint32_t v) {
+	return Field{ tag, 4, 1, u32(v) };
+}
+
+Field rationals(const uint16_t tag, const std::vector<std::pair<uint32_t, uint32_t>>& values) {
+	Field					f{ tag, 5, static_cast<uint32_t>(values.size()), std::string() };
+	for (auto& v : values) f.mData += u32(v.first) + u32(v.second);
+	return f;
+}
+
+/// The table, then the values that don't fit in their entries
+size_t ifd_size(const std::vector<Field>& fields) {
+	size_t					size = 2 + fields.size() * 12 + 4;
+	for (auto& f : fields) {
+		if (f.mData.size() > 4) size += f.mData.size() + (f.mData.size() & 1);
+	}
+	return size;
+}
+
+/// out is the TIFF block so far, so its size is where this table starts
+void write_ifd(std::string& out, const std::vector<Field>& fields) {
+	uint32_t				dataAt = static_cast<uint32_t>(out.size() + 2 + fields.size() * 12 + 4);
+	out += u16(static_cast<uint16_t>(fields.size()));
+	for (auto& f : fields) {
+		out += u16(f.mTag) + u16(f.mType) + u32(f.mCount);
+		if (f.mData.size() <= 4) {
+			out += f.mData + std::string(4 - f.mData.size(), '\0');
+		} else {
+			out += u32(dataAt);
+			dataAt += static_cast<uint32_t>(f.mData.size() + (f.mData.size() & 1));
+		}
+	}
+	out += u32(0);
+	for (auto& f : fields) {
+		if (f.mData.size() <= 4) continue;
+		out += f.mData;
+		if (f.mData.size() & 1) out.push_back('\0');
+	}
+}
+
+/// What a camera writes: descriptive strings and dates, exposure, lens and GPS
+std::string make_tiff(const size_t i) {
+	std::vector<Field>		exif = {
+		rationals(Exif::TAG_EXPOSURE_TIME, { { 1, 250 } }),
+		rationals(Exif::TAG_F_NUMBER, { { 28, 10 } }),
+		short_field(Exif::TAG_ISO_SPEED, 400),
+		ascii(Exif::TAG_DATE_TIME_ORIGINAL, "2016:07:04 12:34:56"),
+		ascii(Exif::TAG_DATE_TIME_DIGITIZED, "2016:07:04 12:34:56"),
+		rationals(Exif::TAG_FOCAL_LENGTH, { { 420, 100 } }),
+		ascii(Exif::TAG_SUB_SEC_TIME_ORIGINAL, "123"),
+		long_field(Exif::TAG_PIXEL_WIDTH, 4032),
+		long_field(Exif::TAG_PIXEL_HEIGHT, 3024),
+		short_field(Exif::TAG_FOCAL_LENGTH_35MM, 28),
+		rationals(Exif::TAG_LENS_INFO, { { 420, 100 }, { 420, 100 }, { 22, 10 }, { 22, 10 } }),
+		ascii(Exif::TAG_LENS_MAKE, "Downstream Optics"),
+		ascii(Exif::TAG_LENS_MODEL, "Back camera 4.2mm f/2.2"),
+	};
+	std::vector<Field>		gps = {
+		ascii(Exif::TAG_GPS_LATITUDE_REF, "N"),
+		rationals(Exif::TAG_GPS_LATITUDE, { { 44, 1 }, { 58, 1 }, { static_cast<uint32_t>(i % 60), 1 } }),
+		ascii(Exif::TAG_GPS_LONGITUDE_REF, "W"),
+		rationals(Exif::TAG_GPS_LONGITUDE, { { 93, 1 }, { 16, 1 }, { 12, 1 } }),
+		rationals(Exif::TAG_GPS_ALTITUDE, { { 2560, 10 } }),
+	};
+	std::vector<Field>		image = {
+		long_field(Exif::TAG_IMAGE_WIDTH, 4032),
+		long_field(Exif::TAG_IMAGE_HEIGHT, 3024),
+		ascii(Exif::TAG_IMAGE_DESCRIPTION, "Gallery photo " + std::to_string(i)),
+		ascii(Exif::TAG_MAKE, "Downstream"),
+		ascii(Exif::TAG_MODEL, "Phone 7"),
+		short_field(Exif::TAG_ORIENTATION, static_cast<uint16_t>(1 + i % 8)),
+		ascii(Exif::TAG_SOFTWARE, "10.3.2"),
+		ascii(Exif::TAG_DATE_TIME, "2016:07:04 12:34:56"),
+		ascii(Exif::TAG_COPYRIGHT, "Downstream"),
+		long_field(Exif::TAG_EXIF_IFD, 0),
+		long_field(Exif::TAG_GPS_IFD, 0),
+	};
+	// The tables go one after another, so the pointers are known before anything's written
+	const size_t			exifAt = 8 + ifd_size(image);
+	image[9].mData = u32(static_cast<uint32_t>(exifAt));
+	image[10].mData = u32(static_cast<uint32_t>(exifAt + ifd_size(exif)));
+
+	std::string				tiff = "II" + u16(42) + u32(8);
+	write_ifd(tiff, image);
+	write_ifd(tiff, exif);
+	write_ifd(tiff, gps);
+	return tiff;
+}
+
+/// A JFIF segment, the EXIF block, then filler standing in for the image data
+std::string make_jpeg(const size_t i) {
+	const std::string		tiff = make_tiff(i);
+	const size_t			length = tiff.size() + 8;
+	std::string				ans = "\xFF\xD8\xFF\xE0" + std::string("\x00\x10JFIF\x00\x01\x01\x00\x00\x01\x00\x01\x00\x00", 16);
+	ans += "\xFF\xE1";
+	ans.push_back(static_cast<char>(length >> 8));
+	ans.push_back(static_cast<char>(length & 0xFF));
+	ans += std::string("Exif\0\0", 6) + tiff;
+	ans += "\xFF\xDA" + std::string("\x00\x02", 2);
+	ans += std::string(FILE_BYTES - ans.size() - 2, '\x5A');
+	ans += "\xFF\xD9";
+	return ans;
+}
+
+/// How files were read before: all of it into memory with fread, then every tag decoded
+int previous_orientation(const std::string& path) {
+	FILE*					fp = fopen(path.c_str(), "rb");
+	if (!fp) return 0;
+	fseek(fp, 0, SEEK_END);
+	const long				size = ftell(fp);
+	rewind(fp);
+	std::vector<unsigned char>	bytes(static_cast<size_t>(size));
+	const bool				read = fread(bytes.data(), 1, bytes.size(), fp) == bytes.size();
+	fclose(fp);
+	easyexif::EXIFInfo		info;
+	if (!read || info.parseFrom(bytes.data(), static_cast<unsigned>(bytes.size())) != PARSE_EXIF_SUCCESS) return 0;
+	return info.Orientation;
+}
+
+}
+
+void benchmarkExif(Timer& t) {
+	// One EXIF block already in memory: easyexif decodes every tag, ExifParser only indexes them
+	const std::string		jpeg = make_jpeg(0);
+	const unsigned char*	data = reinterpret_cast<const unsigned char*>(jpeg.data());
+	const double			eager = t.time("in memory, easyexif parseFrom", 1, [&]() {
+		easyexif::EXIFInfo	info;
+		info.parseFrom(data, static_cast<unsigned>(jpeg.size()));
+		keep(info.Orientation);
+	});
+	const double			lazy = t.time("in memory, ExifParser open and getOrientation", 1, [&]() {
+		Exif				exif;
+		exif.open(data, jpeg.size());
+		keep(exif.getOrientation());
+	});
+	t.compare("in memory, ExifParser vs easyexif", eager, lazy);
+	t.time("in memory, ExifParser open and every common tag", 1, [&]() {
+		Exif				exif;
+		exif.open(data, jpeg.size());
+		int					width = 0, height = 0;
+		double				latitude = 0.0, longitude = 0.0;
+		exif.getImageSize(width, height);
+		exif.getLatitude(latitude);
+		exif.getLongitude(longitude);
+		size_t				total = 0;
+		for (auto tag : { Exif::TAG_MAKE, Exif::TAG_MODEL, Exif::TAG_SOFTWARE, Exif::TAG_DATE_TIME, Exif::TAG_COPYRIGHT }) {
+			total += exif.getText(Exif::IFD_IMAGE, tag).size();
+		}
+		keep(total + width + height + static_cast<size_t>(latitude + longitude));
+	});
+
+	// Files on disk, like a folder of photos being sorted by orientation
+	const size_t			count = t.scaled(FILES);
+	std::vector<std::unique_ptr<TempFile>>	files;
+	std::vector<std::string>	paths;
+	for (size_t i = 0; i < count; ++i) {
+		files.emplace_back(new TempFile("ds_benchmarks_exif_" + std::to_string(i) + ".jpg", make_jpeg(i)));
+		if (!files.back()->isValid()) {
+			t.report("couldn't write the photos", 0.0, "");
+			return;
+		}
+		paths.push_back(files.back()->getPath());
+	}
+	const std::string		photos = ", " + std::to_string(count) + " photos of " + std::to_string(FILE_BYTES / (1024 * 1024)) + " MB";
+
+	const double			previousFiles = t.time("orientation, read the file and easyexif" + photos, count, [&]() {
+		int					total = 0;
+		for (auto& path : paths) total += previous_orientation(path);
+		keep(total);
+	});
+	const double			mappedFiles = t.time("orientation, mapped ExifParser" + photos, count, [&]() {
+		int					total = 0;
+		for (auto& path : paths) {
+			Exif			exif;
+			if (exif.open(path)) total += exif.getOrientation();
+		}
+		keep(total);
+	});
+	t.compare("orientation, mapped ExifParser vs reading the file", previousFiles, mappedFiles);
+
+	// The batch API pulling a few tags for every photo, on one thread and one per core
+	const std::vector<Exif::TagId>	tags = { Exif::TagId(Exif::IFD_IMAGE, Exif::TAG_ORIENTATION),
+		Exif::TagId(Exif::IFD_EXIF, Exif::TAG_DATE_TIME_ORIGINAL), Exif::TagId(Exif::IFD_GPS, Exif::TAG_GPS_LATITUDE) };
+	const double			oneThread = t.time("readTags, one thread" + photos, count, [&]() {
+		keep(Exif::readTags(paths, tags, 1));
+	});
+	const double			workers = t.time("readTags, a thread per core" + photos, count, [&]() {
+		keep(Exif::readTags(paths, tags));
+	});
+	t.compare("readTags, a thread per core vs one thread", oneThread, workers);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,201 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ds/data/key_value_store.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// KeyValueStore before the keys were interned: a map per type, each allocated on the first set, and
+/// a throw on every miss. Only the types the benchmark uses.
+class PreviousKeyValueStore {
+public:
+	PreviousKeyValueStore() {}
+	PreviousKeyValueStore(const PreviousKeyValueStore& o) { *this = o; }
+
+	PreviousKeyValueStore&	operator=(const PreviousKeyValueStore& o) {
+		if (this == &o) return *this;
+		set_equal(o.mFloat, mFloat);
+		set_equal(o.mInt, mInt);
+		set_equal(o.mString, mString);
+		return *this;
+	}
+
+	float					getFloat(const std::string& key, const size_t index, const float notFound) const {
+		try {
+			return get_value(mFloat, key);
+		} catch (std::exception const&) {
+		}
+		return notFound;
+	}
+
+	std::int32_t			getInt(const std::string& key) const {
+		try {
+			return get_value(mInt, key);
+		} catch (std::exception const&) {
+			return 0;
+		}
+	}
+
+	std::string				getString(const std::string& key) const {
+		try {
+			return get_value(mString, key);
+		} catch (std::exception const&) {
+		}
+		return "";
+	}
+
+	void					setFloat(const std::string& key, const float value) { set_value(mFloat, key, value); }
+	void					setInt(const std::string& key, const std::int32_t value) { set_value(mInt, key, value); }
+	void					setString(const std::string& key, const std::string& value) { set_value(mString, key, value); }
+
+private:
+	template <typename T>
+	using Map = std::unique_ptr<std::unordered_map<std::string, T>>;
+
+	template <typename T>
+	static T				get_value(const Map<T>& values, const std::string& key) {
+		if (!values.get() || values->empty()) throw std::invalid_argument("Key " + key + " is invalid");
+		const auto			f = values->find(key);
+		if (f == values->end()) throw std::invalid_argument("Key " + key + " is invalid");
+		return f->second;
+	}
+
+	template <typename T>
+	static void				set_value(Map<T>& values, const std::string& key, const T& value) {
+		if (!values.get()) values.reset(new std::unordered_map<std::string, T>());
+		(*values)[key] = value;
+	}
+
+	template <typename T>
+	static void				set_equal(const Map<T>& src, Map<T>& dst) {
+		if (!src.get()) {
+			dst.reset();
+			return;
+		}
+		if (!dst.get()) dst.reset(new std::unordered_map<std::string, T>());
+		*dst = *src;
+	}
+
+	Map<float>				mFloat;
+	Map<std::int32_t>		mInt;
+	Map<std::string>		mString;
+};
+
+/// What a sprite loaded from xml usually carries: its model binding, a limit and a float or two
+template <typename Store>
+void fill(Store& store) {
+	store.setString("model", "size:this->box_size; opacity:this->box_opacity");
+	store.setInt("each_model_limit", 3);
+	store.setFloat("scroll_speed", 1.5f);
+}
+
+}
+
+void benchmarkKeyValueStore(Timer& t) {
+	const size_t			count = t.scaled(1000);
+	const std::string		stores = ", " + std::to_string(count) + " stores";
+	std::vector<PreviousKeyValueStore>	previous(count);
+	std::vector<ds::KeyValueStore>		current(count);
+	for (auto& s : previous) fill(s);
+	for (auto& s : current) fill(s);
+	static const auto		MODEL_KEY = ds::KeyValueStore::getKeyId("model");
+	static const auto		MISSING_KEY = ds::KeyValueStore::getKeyId("each_model");
+
+	// Hits, the way the xml importer and app code read back what a layout set
+	const double			previousHit = t.time("getString hit, previous" + stores, count, [&]() {
+		size_t				total = 0;
+		for (auto& s : previous) total += s.getString("model").size();
+		keep(total);
+	});
+	const double			currentHit = t.time("getString hit" + stores, count, [&]() {
+		size_t				total = 0;
+		for (auto& s : current) total += s.getString("model").size();
+		keep(total);
+	});
+	const double			idHit = t.time("tryGetString hit by key id" + stores, count, [&]() {
+		size_t				total = 0;
+		std::string			value;
+		for (auto& s : current) {
+			if (s.tryGetString(MODEL_KEY, value)) total += value.size();
+		}
+		keep(total);
+	});
+	t.compare("getString hit vs previous", previousHit, currentHit);
+	t.compare("tryGetString by id hit vs previous", previousHit, idHit);
+
+	// Misses, like SmartLayout probing every sprite for an each_model most of them don't have
+	const double			previousMiss = t.time("getString miss, previous" + stores, count, [&]() {
+		size_t				total = 0;
+		for (auto& s : previous) total += s.getString("each_model").size();
+		keep(total);
+	});
+	const double			currentMiss = t.time("getString miss" + stores, count, [&]() {
+		size_t				total = 0;
+		for (auto& s : current) total += s.getString("each_model").size();
+		keep(total);
+	});
+	const double			idMiss = t.time("tryGetString miss by key id" + stores, count, [&]() {
+		size_t				total = 0;
+		std::string			value;
+		for (auto& s : current) {
+			if (s.tryGetString(MISSING_KEY, value)) total += value.size();
+		}
+		keep(total);
+	});
+	t.compare("getString miss vs previous", previousMiss, currentMiss);
+	t.compare("tryGetString by id miss vs previous", previousMiss, idMiss);
+
+	// A float missing with a default, which threw and caught in the previous store
+	const double			previousDefault = t.time("getFloat with a default, missing, previous" + stores, count, [&]() {
+		float				total = 0.0f;
+		for (auto& s : previous) total += s.getFloat("layout_fudge", 0, 1.0f);
+		keep(total);
+	});
+	const double			currentDefault = t.time("getFloat with a default, missing" + stores, count, [&]() {
+		float				total = 0.0f;
+		for (auto& s : current) total += s.getFloat("layout_fudge", 0, 1.0f);
+		keep(total);
+	});
+	t.compare("getFloat with a default vs previous", previousDefault, currentDefault);
+
+	// Copies, which sprites and content make of their user data. The previous store didn't copy its
+	// strings, but this copy of it does, so both copy the same data.
+	std::vector<PreviousKeyValueStore>	previousCopies(count);
+	std::vector<ds::KeyValueStore>		currentCopies(count);
+	const double			previousCopy = t.time("copy, previous" + stores, count, [&]() {
+		for (size_t i = 0; i < count; ++i) previousCopies[i] = previous[i];
+	});
+	const double			currentCopy = t.time("copy" + stores, count, [&]() {
+		for (size_t i = 0; i < count; ++i) currentCopies[i] = current[i];
+	});
+	t.compare("copy vs previous", previousCopy, currentCopy);
+
+	// Most sprites never set anything, so the empty store is what most of them pay for
+	const double			previousEmpty = t.time("create, copy and destroy empty, previous" + stores, count, [count]() {
+		for (size_t i = 0; i < count; ++i) {
+			PreviousKeyValueStore	s, copy(s);
+			keep(copy);
+		}
+	});
+	const double			currentEmpty = t.time("create, copy and destroy empty" + stores, count, [count]() {
+		for (size_t i = 0; i < count; ++i) {
+			ds::KeyValueStore	s, copy(s);
+			keep(copy);
+		}
+	});
+	t.compare("empty vs previous", previousEmpty, currentEmpty);
+	t.report("sizeof, previous", static_cast<double>(sizeof(PreviousKeyValueStore)), "bytes");
+	t.report("sizeof", static_cast<double>(sizeof(ds::KeyValueStore)), "bytes");
+}
+
+} // namespace benchmarks
@@ -0,0 +1,127 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/temp_file.h"
+#include "benchmarks/timer.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/interface_xml/interface_xml_importer.h>
+#include <ds/ui/layout/layout_sprite.h>
+
+namespace benchmarks {
+
+namespace {
+
+const int					DEPTH = 6;
+const int					BRANCHES = 3;
+const int					BOXES_PER_LAYOUT = 2;
+
+/// Alternates vertical, horizontal and size layouts going down, each with a couple of fixed boxes and a few
+/// nested layouts, like a detail screen of cards of rows of labels
+void write_layout(std::ostream& xml, const int depth, const std::string& name) {
+	const char*				types[] = { "vert", "horiz", "size" };
+	const char*				shrink[] = { "height", "width", "none" };
+	const int				type = depth % 3;
+	const std::string		indent(depth + 1, '\t');
+
+	xml << indent << "<layout name=\"" << name << "\" layout_type=\"" << types[type] << "\" shrink_to_children=\"" << shrink[type]
+		<< "\" layout_spacing=\"4\" padding=\"2, 2, 2, 2\" layout_size_mode=\"" << (depth == 0 ? "fixed" : "flex")
+		<< "\" size=\"1920, 1080\">\n";
+	for (int i = 0; i < BOXES_PER_LAYOUT; ++i) {
+		xml << indent << "\t<sprite name=\"" << name << "_box" << i << "\" size=\"" << 40 + i * 10 << ", 20\" layout_size_mode=\""
+			<< (type == 2 ? "stretch" : "fixed") << "\"/>\n";
+	}
+	if (depth + 1 < DEPTH) {
+		for (int i = 0; i < BRANCHES; ++i) write_layout(xml, depth + 1, name + "_" + std::to_string(i));
+	}
+	xml << indent << "</layout>\n";
+}
+
+std::string make_layout_xml() {
+	std::stringstream		xml;
+	xml << "<interface>\n";
+	write_layout(xml, 0, "l");
+	xml << "</interface>\n";
+	return xml.str();
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+void benchmarkLayouts(Timer& t, ds::Engine& engine) {
+	const TempFile			file("ds_benchmarks_nested_layout.xml", make_layout_xml());
+	if (!file.isValid()) {
+		t.report("couldn't write the layout file", 0.0, "");
+		return;
+	}
+
+	ds::ui::Sprite*			holder = new ds::ui::Sprite(engine);
+	engine.getRootSprite().addChildPtr(holder);
+	ds::ui::XmlImporter::NamedSpriteMap	sprites;
+	const auto				loadStart = std::chrono::steady_clock::now();
+	ds::ui::XmlImporter::loadXMLto(holder, file.getPath(), sprites);
+	t.report("load the xml", ms_since(loadStart), "ms");
+
+	std::vector<ds::ui::LayoutSprite*>	layouts;
+	for (auto& it : sprites) {
+		if (auto layout = dynamic_cast<ds::ui::LayoutSprite*>(it.second)) layouts.push_back(layout);
+	}
+	ds::ui::LayoutSprite*	root = dynamic_cast<ds::ui::LayoutSprite*>(sprites["l"]);
+	ds::ui::Sprite*			deepBox = sprites["l_0_0_0_0_0_box0"];
+	ds::ui::LayoutSprite*	deepLayout = dynamic_cast<ds::ui::LayoutSprite*>(sprites["l_0_0_0_0_0"]);
+	if (!root || !deepBox || !deepLayout) {
+		t.report("couldn't find the generated layouts", 0.0, "");
+		holder->release();
+		return;
+	}
+	const std::string		size = ", " + std::to_string(layouts.size()) + " layouts " + std::to_string(DEPTH) + " deep";
+
+	// Every layout out of date, which is how every nested layout ran on every pass before they could be skipped
+	const double			everything = t.time("runLayout, every layout changed" + size, 1, [&layouts, root]() {
+		for (auto layout : layouts) layout->setSpacing(layout->getSpacing());
+		root->runLayout();
+	});
+	const double			unchanged = t.time("runLayout, nothing changed" + size, 1, [root]() {
+		root->runLayout();
+	});
+	bool					wide = false;
+	const double			oneBox = t.time("runLayout, one box at the bottom resized" + size, 1, [root, deepBox, &wide]() {
+		wide = !wide;
+		deepBox->setSize(wide ? 60.0f : 40.0f, 20.0f);
+		root->runLayout();
+	});
+	t.compare("nothing changed vs every layout", everything, unchanged);
+	t.compare("one box resized vs every layout", everything, oneBox);
+
+	// A burst of changes in one frame, like text being set on several labels: each one running the layout it's in
+	// right away, or invalidating it so it runs once in the next update
+	const int				burst = 10;
+	const double			immediate = t.time("burst of " + std::to_string(burst) + ", runLayout each time", 1, [&]() {
+		for (int i = 0; i < burst; ++i) {
+			wide = !wide;
+			deepBox->setSize(wide ? 60.0f : 40.0f, 20.0f);
+			deepLayout->runLayout();
+		}
+		engine.update();
+	});
+	const double			coalesced = t.time("burst of " + std::to_string(burst) + ", invalidateLayout and update", 1, [&]() {
+		for (int i = 0; i < burst; ++i) {
+			wide = !wide;
+			deepBox->setSize(wide ? 60.0f : 40.0f, 20.0f);
+			deepLayout->invalidateLayout();
+		}
+		engine.update();
+	});
+	t.compare("burst, invalidateLayout vs runLayout", immediate, coalesced);
+
+	holder->release();
+}
+
+} // namespace benchmarks
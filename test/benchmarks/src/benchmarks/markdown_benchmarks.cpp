@@ -0,0 +1,119 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <vector>
+#include <ds/util/markdown_to_pango.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// Matches the cache size markdown_to_pango() starts with
+const size_t				DEFAULT_CACHE_BYTES = 4 * 1024 * 1024;
+const size_t				ARTICLES = 50;
+const size_t				SECTIONS_PER_ARTICLE = 12;
+/// Cards showing each article's body, like a grid of stories that all use the same text
+const size_t				CARDS_PER_ARTICLE = 4;
+
+/// A long CMS story, about 14 KB: headings, paragraphs with inline markup and reserved characters,
+/// lists, quotes and code
+std::string make_article(const size_t a) {
+	std::string				ans = "# Story " + std::to_string(a) + ": The collection & its <history>\n\n";
+	for (size_t s = 0; s < SECTIONS_PER_ARTICLE; ++s) {
+		ans += "## Section " + std::to_string(s + 1) + "\n\n";
+		for (size_t p = 0; p < 3; ++p) {
+			ans += "The *museum* opened its **new wing** in " + std::to_string(1900 + a + s * 3 + p)
+				+ ", bringing together works that had been stored for decades. Curators & conservators spent years on it, "
+				"and visitors can now see pieces from the [archive](http://example.com/archive/" + std::to_string(a * 100 + s)
+				+ ") side by side with new acquisitions. Sizes are listed as width < height where it matters.\n\n";
+		}
+		ans += "* Gallery " + std::to_string(s) + " on the *second* floor\n"
+			"* Open daily & on holidays\n"
+			"  1. Guided tours at 10:00\n"
+			"  2. Audio guides in `six` languages\n"
+			"* Tickets at the front desk\n\n";
+		ans += "> \"A place to see it all together\", said the director.\n\n";
+		if (s % 4 == 0) ans += "    catalog_id = " + std::to_string(a * 1000 + s) + "\n\n";
+	}
+	return ans;
+}
+
+size_t convert_all(const std::vector<std::string>& articles, const size_t cards) {
+	size_t					total = 0;
+	for (size_t c = 0; c < cards; ++c) {
+		for (auto& article : articles) total += ds::ui::markdown_to_pango(article).size();
+	}
+	return total;
+}
+
+}
+
+void benchmarkMarkdown(Timer& t) {
+	std::vector<std::string>	articles;
+	size_t					bytes = 0;
+	for (size_t a = 0; a < t.scaled(ARTICLES); ++a) {
+		articles.push_back(make_article(a));
+		bytes += articles.back().size();
+	}
+	const std::string		corpus = ", " + std::to_string(articles.size()) + " articles, " + std::to_string(bytes / 1024) + " KB";
+	const double			kb = static_cast<double>(bytes) / 1024.0;
+
+	// Every article converted as it's set, with no cache
+	ds::ui::set_markdown_to_pango_cache_size(0);
+	const double			uncached = t.time("markdown_to_pango, no cache" + corpus, 1, [&]() {
+		keep(convert_all(articles, 1));
+	});
+	t.report("markdown_to_pango, no cache", kb / (uncached / 1000000000.0) / 1024.0, "MB/s");
+	const double			uncachedCards = t.time("markdown_to_pango, no cache, " + std::to_string(CARDS_PER_ARTICLE) + " cards each" + corpus, 1, [&]() {
+		keep(convert_all(articles, CARDS_PER_ARTICLE));
+	});
+
+	// A cache big enough for the whole corpus: the warm up fills it, then every card is a hit
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES * 4);
+	ds::ui::clear_markdown_to_pango_cache();
+	const double			cachedCards = t.time("markdown_to_pango, cached, " + std::to_string(CARDS_PER_ARTICLE) + " cards each" + corpus, 1, [&]() {
+		keep(convert_all(articles, CARDS_PER_ARTICLE));
+	});
+	t.compare("cards, cached vs no cache", uncachedCards, cachedCards);
+
+	// A cache smaller than the corpus, so each article has fallen out by the time it comes round again
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES / 4);
+	ds::ui::clear_markdown_to_pango_cache();
+	const double			overflowing = t.time("markdown_to_pango, cache a quarter of the default" + corpus, 1, [&]() {
+		keep(convert_all(articles, 1));
+	});
+	t.compare("cache smaller than the corpus vs no cache", uncached, overflowing);
+
+	// Typing at the end of one long article, like an entry field showing a preview. Each keystroke is
+	// a new string, so the cache doesn't help; MarkdownToPango reuses the blocks that didn't change.
+	ds::ui::set_markdown_to_pango_cache_size(0);
+	const std::string		typed = " More text typed in";
+	std::string				text = articles.front();
+	const size_t			base = text.size();
+	size_t					key = 0;
+	auto					nextKeystroke = [&]() {
+		if (key == typed.size()) {
+			text.resize(base);
+			key = 0;
+		}
+		text.push_back(typed[key++]);
+	};
+	const double			retyped = t.time("typing, markdown_to_pango each keystroke", 1, [&]() {
+		nextKeystroke();
+		keep(ds::ui::markdown_to_pango(text).size());
+	});
+	ds::ui::MarkdownToPango	converter;
+	const double			incremental = t.time("typing, MarkdownToPango each keystroke", 1, [&]() {
+		nextKeystroke();
+		keep(converter.convert(text).size());
+	});
+	t.compare("typing, MarkdownToPango vs markdown_to_pango", retyped, incremental);
+
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES);
+	ds::ui::clear_markdown_to_pango_cache();
+}
+
+} // namespace benchmarks
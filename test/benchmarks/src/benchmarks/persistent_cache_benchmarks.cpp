@@ -0,0 +1,111 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <ds/storage/persistent_cache.h>
+
+namespace benchmarks {
+
+namespace {
+
+const char*					CACHE_LOCATION = "ds_benchmarks_persistent_cache";
+const int					CACHE_VERSION = 1;
+/// Queries per timed call
+const size_t				LOOKUPS = 1000;
+
+/// Where PersistentCache puts CACHE_LOCATION, so each run starts and ends without a database
+std::string cache_folder() {
+	Poco::Path				p(Poco::Path::home());
+	p.append("documents").append("downstream").append("cache").append(CACHE_LOCATION);
+	return Poco::Path::expand(p.toString());
+}
+
+void remove_cache() {
+	try {
+		Poco::File			f(cache_folder());
+		if (f.exists()) f.remove(true);
+	} catch (std::exception&) {
+	}
+}
+
+ds::PersistentCache* open_cache() {
+	return new ds::PersistentCache(CACHE_LOCATION, CACHE_VERSION,
+			ds::PersistentCache::FieldList().addString("query").addString("result").addInt("hits"));
+}
+
+/// Like a cached lookup: the query, what it answered, and how often it's been asked
+ds::PersistentCache::Row make_row(const size_t i) {
+	return ds::PersistentCache::Row()
+			.addString("query_" + std::to_string(i))
+			.addString("/content/items/" + std::to_string(i * 7) + "/thumbnail.png")
+			.addInt(static_cast<int64_t>(i % 10));
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+void benchmarkPersistentCache(Timer& t) {
+	const size_t			count = t.scaled(100000);
+	const std::string		rows = ", " + std::to_string(count) + " rows";
+	remove_cache();
+
+	std::unique_ptr<ds::PersistentCache>	cache(open_cache());
+
+	// Inserts only touch memory and queue the write, so they're timed apart from writing them out
+	const auto				insertStart = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; ++i) cache->setValues(make_row(i));
+	const double			insertMs = ms_since(insertStart);
+	t.report("setValues, insert" + rows, insertMs * 1000000.0 / static_cast<double>(count), "ns/op");
+	const auto				flushStart = std::chrono::steady_clock::now();
+	if (!cache->flush()) t.report("some rows failed to write", 0.0, "");
+	t.report("insert and write to disk" + rows, insertMs + ms_since(flushStart), "ms");
+
+	size_t					next = 0;
+	t.time("fetchOne hit" + rows, LOOKUPS, [&]() {
+		size_t				total = 0;
+		for (size_t i = 0; i < LOOKUPS; ++i) {
+			next = (next + 7919) % count;
+			total += cache->fetchOne("query", "query_" + std::to_string(next)).getString(1).size();
+		}
+		keep(total);
+	});
+	t.time("fetchOne miss" + rows, LOOKUPS, [&]() {
+		size_t				total = 0;
+		for (size_t i = 0; i < LOOKUPS; ++i) {
+			total += cache->fetchOne("query", "missing_" + std::to_string(i)).empty() ? 0 : 1;
+		}
+		keep(total);
+	});
+
+	// Updates to rows already on disk, which used to reload every row after each one
+	const size_t			updates = count < LOOKUPS ? count : LOOKUPS;
+	const auto				updateStart = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < updates; ++i) {
+		ds::PersistentCache::Row	row = cache->fetchOne("query", "query_" + std::to_string(i * (count / updates)));
+		row.mFields[2].mInt += 1;
+		cache->setValues(row);
+	}
+	cache->flush();
+	t.report("fetchOne, setValues and write " + std::to_string(updates) + " updates" + rows, ms_since(updateStart), "ms");
+
+	// Opening an existing cache loads and indexes every row
+	cache.reset();
+	const auto				openStart = std::chrono::steady_clock::now();
+	cache.reset(open_cache());
+	t.report("open an existing cache" + rows, ms_since(openStart), "ms");
+	if (cache->fetchOne("query", "query_" + std::to_string(count - 1)).empty()) t.report("rows missing after reopening", 0.0, "");
+
+	cache.reset();
+	remove_cache();
+}
+
+} // namespace benchmarks
@@ -0,0 +1,77 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <ds/app/engine/engine.h>
+#include <ds/debug/frame_profiler.h>
+#include <ds/ui/sprite/sprite.h>
+
+namespace benchmarks {
+
+namespace {
+
+const char*					LEVEL_NAMES[] = { "off", "phases", "detail" };
+
+/// Scopes are timed a batch at a time, so the loop around them doesn't swamp a disabled scope
+const size_t				SCOPES_PER_CALL = 1000;
+
+void benchmarkScopes(Timer& t, ds::Engine& engine) {
+	// Named from the sprite's dynamic type, the way Sprite::update() names its scope
+	ds::ui::Sprite*			sprite = new ds::ui::Sprite(engine);
+	const ds::ui::Sprite*	obj = sprite;
+	double					phase[3], object[3];
+	for (int level = ds::FrameProfiler::OFF; level <= ds::FrameProfiler::DETAIL; ++level) {
+		ds::FrameProfiler::setLevel(level);
+		const std::string	suffix = std::string(", ") + LEVEL_NAMES[level];
+		phase[level] = t.time("phase scope" + suffix, SCOPES_PER_CALL, []() {
+			for (size_t i = 0; i < SCOPES_PER_CALL; ++i) {
+				DS_PROFILE_SCOPE("benchmark");
+			}
+		});
+		object[level] = t.time("object scope" + suffix, SCOPES_PER_CALL, [obj]() {
+			for (size_t i = 0; i < SCOPES_PER_CALL; ++i) {
+				DS_PROFILE_OBJECT_SCOPE(obj, "benchmark");
+			}
+		});
+		// Summarizes what was recorded, as App::update() does every frame
+		ds::FrameProfiler::nextFrame();
+	}
+	t.report("phase scope, recording cost", phase[ds::FrameProfiler::PHASES] - phase[ds::FrameProfiler::OFF], "ns/scope");
+	t.report("object scope, recording cost", object[ds::FrameProfiler::DETAIL] - object[ds::FrameProfiler::OFF], "ns/scope");
+
+	sprite->release();
+}
+
+/// Whole headless frames over a few thousand updating sprites, which is where the DETAIL scopes add up
+void benchmarkFrames(Timer& t, ds::Engine& engine) {
+	ds::ui::Sprite*			holder = new ds::ui::Sprite(engine);
+	engine.getRootSprite().addChildPtr(holder);
+	const size_t			count = t.scaled(2000);
+	for (size_t i = 0; i < count; ++i) holder->addChildPtr(new ds::ui::Sprite(engine, 32.0f, 24.0f));
+
+	double					frame[3];
+	for (int level = ds::FrameProfiler::OFF; level <= ds::FrameProfiler::DETAIL; ++level) {
+		ds::FrameProfiler::setLevel(level);
+		frame[level] = t.time("engine update, " + std::to_string(count) + " sprites, " + LEVEL_NAMES[level], 1, [&engine]() {
+			engine.update();
+			ds::FrameProfiler::nextFrame();
+		});
+	}
+	t.compare("engine update, phases vs off (under 1 is overhead)", frame[ds::FrameProfiler::OFF], frame[ds::FrameProfiler::PHASES]);
+	t.compare("engine update, detail vs off (under 1 is overhead)", frame[ds::FrameProfiler::OFF], frame[ds::FrameProfiler::DETAIL]);
+
+	holder->release();
+}
+
+}
+
+void benchmarkProfiler(Timer& t, ds::Engine& engine) {
+	const int				level = ds::FrameProfiler::getLevel();
+	benchmarkScopes(t, engine);
+	benchmarkFrames(t, engine);
+	ds::FrameProfiler::setLevel(level);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,76 @@
+#include "stdafx.h"
+
+#include "benchmarks/resource_database.h"
+
+#include <algorithm>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <ds/debug/logger.h>
+#include <ds/query/query_client.h>
+#include <ds/query/sqlite/sqlite3.h>
+
+namespace benchmarks {
+
+namespace {
+
+const char					DATABASE_TYPE = ds::Resource::Id::CUSTOM_TYPE;
+const std::string			NO_PATH;
+std::string					DATABASE_PATH;
+
+bool create_database(const std::string& path, const size_t rows) {
+	sqlite3*				db = nullptr;
+	if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+		sqlite3_close(db);
+		return false;
+	}
+	const std::string		sql = "DROP TABLE IF EXISTS Resources;"
+								  "CREATE TABLE Resources (resourcesid INTEGER PRIMARY KEY, resourcestype TEXT, resourcesduration REAL,"
+								  " resourceswidth REAL, resourcesheight REAL, resourcesfilename TEXT, resourcespath TEXT, resourcesthumbid INTEGER);"
+								  "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < " + std::to_string(rows) + ")"
+								  " INSERT INTO Resources SELECT i, 'i', 0, 1920, 1080, 'image_' || i || '.jpg', 'images/' || (i % 100) || '/',"
+								  " (i * 7919) % " + std::to_string(rows) + " + 1 FROM n;";
+	char*					error = nullptr;
+	const bool				ok = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &error) == SQLITE_OK;
+	if (error) DS_LOG_WARNING("benchmarks: couldn't create the resources table: " << error);
+	sqlite3_free(error);
+	sqlite3_close(db);
+	return ok;
+}
+
+}
+
+ResourceDatabase::ResourceDatabase(const size_t rows)
+		: mRows(std::max<size_t>(1, rows))
+		, mValid(false) {
+	DATABASE_PATH = Poco::Path(Poco::Path::temp(), "ds_benchmarks_resources.sqlite").toString();
+	mValid = create_database(DATABASE_PATH, mRows);
+	ds::Resource::Id::setupCustomPaths([](const ds::Resource::Id&) -> const std::string& { return NO_PATH; },
+									   [](const ds::Resource::Id&) -> const std::string& { return DATABASE_PATH; });
+}
+
+ResourceDatabase::~ResourceDatabase() {
+	ds::Resource::Id::setupCustomPaths(nullptr, nullptr);
+	ds::query::Client::closeConnections(DATABASE_PATH);
+	try {
+		Poco::File(DATABASE_PATH).remove();
+	} catch (std::exception&) {
+	}
+}
+
+const std::string& ResourceDatabase::getPath() const {
+	return DATABASE_PATH;
+}
+
+char ResourceDatabase::getType() const {
+	return DATABASE_TYPE;
+}
+
+std::vector<ds::Resource::Id> ResourceDatabase::makeIds(const size_t count, const size_t seed) const {
+	std::vector<ds::Resource::Id>	ids;
+	for (size_t i = 0; i < count; ++i) {
+		ids.push_back(ds::Resource::Id(DATABASE_TYPE, static_cast<int>(((i + seed) * 104729) % mRows + 1)));
+	}
+	return ids;
+}
+
+} // namespace benchmarks
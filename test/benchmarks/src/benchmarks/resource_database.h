@@ -0,0 +1,36 @@
+#ifndef _BENCHMARKS_BENCHMARKS_RESOURCE_DATABASE_H_
+#define _BENCHMARKS_BENCHMARKS_RESOURCE_DATABASE_H_
+
+#include <string>
+#include <vector>
+#include <ds/data/resource.h>
+
+namespace benchmarks {
+
+/**
+ * \class ResourceDatabase
+ * A generated Resources table like a CMS export, in the temp folder. Every row is an image with a
+ * thumbnail, which is another row. While it exists, ids of getType() resolve against it.
+ */
+class ResourceDatabase {
+public:
+	explicit ResourceDatabase(const size_t rows);
+	/// Closes the pooled connections and deletes the file
+	~ResourceDatabase();
+
+	bool						isValid() const { return mValid; }
+	const std::string&			getPath() const;
+	char						getType() const;
+
+	/// count ids scattered through the table, repeating once count passes the number of rows
+	std::vector<ds::Resource::Id>
+								makeIds(const size_t count, const size_t seed = 0) const;
+
+private:
+	const size_t				mRows;
+	bool						mValid;
+};
+
+} // namespace benchmarks
+
+#endif // !_BENCHMARKS_BENCHMARKS_RESOURCE_DATABASE_H_
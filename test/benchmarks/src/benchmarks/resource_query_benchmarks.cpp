@@ -0,0 +1,82 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/resource_database.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <vector>
+#include <ds/data/resource.h>
+#include <ds/query/sql_database.h>
+#include <ds/query/sqlite/sqlite3.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// What Resource::query() used to do: open the database, prepare the formatted SQL, read the row and close it all again
+bool open_and_prepare(const std::string& path, const int id) {
+	int						errorCode = 0;
+	ds::query::SqlDatabase	db(path, SQLITE_OPEN_READONLY, &errorCode);
+	if (errorCode != SQLITE_OK) return false;
+	sqlite3_stmt*			statement = db.rawSelect("SELECT resourcestype,resourcesduration,resourceswidth,resourcesheight,resourcesfilename,resourcespath,resourcesthumbid"
+													 " FROM Resources WHERE resourcesid = " + std::to_string(id));
+	if (!statement) return false;
+	bool					found = false;
+	while (sqlite3_step(statement) == SQLITE_ROW) {
+		found = sqlite3_column_bytes(statement, 4) > 0;
+	}
+	sqlite3_finalize(statement);
+	return found;
+}
+
+}
+
+void benchmarkResourceQuery(Timer& t) {
+	const ResourceDatabase	database(t.scaled(20000));
+	if (!database.isValid()) {
+		t.report("skipped, no database", 0.0, "");
+		return;
+	}
+	const std::string&		path = database.getPath();
+
+	// The ids a few screens might resolve at startup
+	const std::vector<ds::Resource::Id>	ids = database.makeIds(t.scaled(2000));
+
+	const double			opened = t.time("open and prepare per lookup", ids.size(), [&path, &ids]() {
+		int					found = 0;
+		for (auto& id : ids) found += open_and_prepare(path, id.mValue) ? 1 : 0;
+		keep(found);
+	});
+	const double			pooled = t.time("Resource::query, pooled", ids.size(), [&ids]() {
+		int					found = 0;
+		for (auto& id : ids) {
+			ds::Resource	r;
+			found += r.query(id) ? 1 : 0;
+		}
+		keep(found);
+	});
+	const double			batched = t.time("Resource::queryMany", ids.size(), [&ids]() {
+		const auto			resources = ds::Resource::queryMany(ids);
+		keep(resources.size());
+	});
+	t.compare("pooled vs open and prepare", opened, pooled);
+	t.compare("queryMany vs open and prepare", opened, batched);
+
+	const double			thumbs = t.time("Resource::query with thumbnail, pooled", ids.size(), [&ids]() {
+		int					found = 0;
+		for (auto& id : ids) {
+			ds::Resource	r, thumb;
+			found += r.query(id, &thumb) && !thumb.empty() ? 1 : 0;
+		}
+		keep(found);
+	});
+	const double			batchedThumbs = t.time("Resource::queryMany with thumbnails", ids.size(), [&ids]() {
+		std::vector<ds::Resource>	thumbnails;
+		const auto			resources = ds::Resource::queryMany(ids, &thumbnails);
+		keep(thumbnails.size());
+	});
+	t.compare("queryMany vs query, with thumbnails", thumbs, batchedThumbs);
+}
+
+} // namespace benchmarks
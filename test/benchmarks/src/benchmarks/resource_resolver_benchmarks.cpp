@@ -0,0 +1,116 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/resource_database.h"
+#include "benchmarks/timer.h"
+
+#include <functional>
+#include <vector>
+#include <Poco/Timestamp.h>
+#include <ds/app/engine/engine.h>
+#include <ds/data/resource_list.h>
+#include <ds/data/resource_resolver.h>
+
+namespace benchmarks {
+
+namespace {
+
+const Poco::Timestamp::TimeDiff	TIMEOUT = 10 * 1000 * 1000;
+
+/// Runs whole engine frames until done() says so. Answers how many it took, or -1 if it gave up.
+int run_frames_until(ds::Engine& e, const std::function<bool()>& done) {
+	const Poco::Timestamp	started;
+	int						frames = 0;
+	while (!done()) {
+		if (started.elapsed() > TIMEOUT) return -1;
+		e.update();
+		++frames;
+	}
+	return frames;
+}
+
+}
+
+void benchmarkResourceResolver(Timer& t, ds::Engine& engine) {
+	const ResourceDatabase	database(t.scaled(20000));
+	if (!database.isValid()) {
+		t.report("skipped, no database", 0.0, "");
+		return;
+	}
+
+	// Screens that each resolve their ids as they're built, one screen a frame. Each shares half its
+	// ids with the one before, like a menu and the detail pages it opens.
+	const size_t			perScreen = 60;
+	std::vector<std::vector<ds::Resource::Id>>	screens;
+	for (size_t i = 0, count = t.scaled(20); i < count; ++i) screens.push_back(database.makeIds(perScreen, i * perScreen / 2));
+	const size_t			total = screens.size() * perScreen;
+
+	const double			synchronous = t.time("ResourceList::get, on the main thread, per id", total, [&screens]() {
+		ds::ResourceList	list;
+		size_t				found = 0;
+		for (auto& ids : screens) {
+			for (auto& id : ids) {
+				ds::Resource	r;
+				found += list.get(id, r) ? 1 : 0;
+			}
+		}
+		keep(found);
+	});
+
+	// Only the resolve() calls happen while a screen is being built, the queries are on a worker
+	const double			issuing = t.time("ResourceResolver::resolve, per id", total, [&engine, &screens]() {
+		ds::ResourceList	list;
+		ds::ResourceResolver	resolver(engine, list);
+		size_t				requestId = 0;
+		for (auto& ids : screens) {
+			for (auto& id : ids) requestId = resolver.resolve(id, [](const ds::Resource&) {});
+		}
+		keep(requestId);
+	});
+	t.compare("main thread, resolve vs get", synchronous, issuing);
+
+	ds::ResourceResolver::Stats	stats;
+	int						frames = 0;
+	t.time("ResourceResolver, per id until its callback", total, [&engine, &screens, &stats, &frames, total]() {
+		ds::ResourceList	list;
+		ds::ResourceResolver	resolver(engine, list);
+		size_t				callbacks = 0;
+		frames = 0;
+		for (auto& ids : screens) {
+			for (auto& id : ids) resolver.resolve(id, [&callbacks](const ds::Resource&) { ++callbacks; });
+			engine.update();
+			++frames;
+		}
+		const int			more = run_frames_until(engine, [&callbacks, total]() { return callbacks >= total; });
+		frames = more < 0 ? -1 : frames + more;
+		stats = resolver.getStats();
+	});
+	t.report("frames until the last callback", static_cast<double>(frames), "frames");
+	t.report("request latency, mean", stats.getAverageLatencyMs(), "ms");
+	t.report("request latency, worst", stats.mMaxLatencyMs, "ms");
+	t.report("cache hit rate", stats.getHitRate() * 100.0, "%");
+	t.report("coalesced ids", static_cast<double>(stats.mCoalesced), "ids");
+	t.report("ids queried", static_cast<double>(stats.mIdsQueried), "ids");
+	t.report("batches", static_cast<double>(stats.mBatches), "batches");
+
+	// Coming back to screens that are already cached is all hits, answered on the next frame
+	ds::ResourceList		warm;
+	for (auto& ids : screens) {
+		for (auto& id : ids) {
+			ds::Resource	r;
+			warm.get(id, r);
+		}
+	}
+	t.time("ResourceResolver, cached, per id until its callback", total, [&engine, &screens, &warm, &stats, total]() {
+		ds::ResourceResolver	resolver(engine, warm);
+		size_t				callbacks = 0;
+		for (auto& ids : screens) {
+			for (auto& id : ids) resolver.resolve(id, [&callbacks](const ds::Resource&) { ++callbacks; });
+		}
+		run_frames_until(engine, [&callbacks, total]() { return callbacks >= total; });
+		stats = resolver.getStats();
+	});
+	t.report("cached hit rate", stats.getHitRate() * 100.0, "%");
+}
+
+} // namespace benchmarks
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <vector>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/scroll/scroll_area.h>
+#include <ds/ui/scroll/scroll_list.h>
+
+namespace benchmarks {
+
+namespace {
+
+const float					LIST_WIDTH = 400.0f;
+const float					LIST_HEIGHT = 1080.0f;
+const float					ITEM_HEIGHT = 60.0f;
+/// Not a multiple of the item height, so items come and go on most steps
+const float					SCROLL_STEP = 37.0f;
+
+/// Finds its visible items the way ScrollList did before the binary search: by checking every placeholder
+class ScanningScrollList : public ds::ui::ScrollList {
+public:
+	ScanningScrollList(ds::ui::SpriteEngine& e) : ds::ui::ScrollList(e) {}
+
+	virtual void layout() override {
+		ds::ui::ScrollList::layout();
+		mItemOrder = kItemsUnordered;
+	}
+};
+
+ds::ui::ScrollList* make_list(ds::Engine& engine, const bool scanning, const size_t items, const bool variableSizes, const float prefetch) {
+	ds::ui::ScrollList*		list = scanning ? new ScanningScrollList(engine) : new ds::ui::ScrollList(engine);
+	engine.getRootSprite().addChildPtr(list);
+	list->setCreateItemCallback([&engine]() { return new ds::ui::Sprite(engine, LIST_WIDTH, ITEM_HEIGHT); });
+	list->setDataCallback([variableSizes](ds::ui::Sprite* s, const int dbId) {
+		// Like rows whose text wraps to a few different heights
+		if (variableSizes) s->setSize(LIST_WIDTH, ITEM_HEIGHT * static_cast<float>(1 + dbId % 3));
+	});
+	list->setLayoutParams(0.0f, 0.0f, ITEM_HEIGHT);
+	list->setVariableItemSizes(variableSizes);
+	list->setPrefetchMargin(prefetch);
+	list->setSize(LIST_WIDTH, LIST_HEIGHT);
+
+	std::vector<int>		ids(items);
+	for (size_t i = 0; i < items; ++i) ids[i] = static_cast<int>(i);
+	list->setContent(ids);
+	return list;
+}
+
+/// How far the list scrolls, which changes as variable sized items are measured
+float scrollable_length(ds::ui::ScrollArea* area) {
+	return LIST_HEIGHT / area->getVisiblePercent() - LIST_HEIGHT;
+}
+
+/// Scrolls down the list a step at a time, the way a drag or momentum moves it every frame, wrapping back to the top
+/// at the end. Each step is one scroll update.
+double time_scrolling(Timer& t, const std::string& name, ds::ui::ScrollList* list) {
+	ds::ui::ScrollArea*		area = list->getScrollArea();
+	float					position = 0.0f;
+	return t.time(name, 1, [area, &position]() {
+		position += SCROLL_STEP;
+		if (position > scrollable_length(area)) position = 0.0f;
+		area->setScrollerPosition(ci::vec2(0.0f, -position));
+	});
+}
+
+}
+
+void benchmarkScrollList(Timer& t, ds::Engine& engine) {
+	const size_t			small = 200;
+	const size_t			large = t.scaled(20000);
+	const std::string		largeName = std::to_string(large) + " items";
+
+	ds::ui::ScrollList*		list = make_list(engine, false, small, false, 0.0f);
+	const double			smallNs = time_scrolling(t, "binary search, " + std::to_string(small) + " items", list);
+	list->release();
+
+	list = make_list(engine, false, large, false, 0.0f);
+	const double			largeNs = time_scrolling(t, "binary search, " + largeName, list);
+	list->release();
+
+	list = make_list(engine, true, large, false, 0.0f);
+	const double			scanNs = time_scrolling(t, "scanning every item, " + largeName, list);
+	list->release();
+
+	t.compare("binary search vs scanning, " + largeName, scanNs, largeNs);
+	t.report("binary search, " + largeName + " over " + std::to_string(small) + " items", largeNs / smallNs, "x the time");
+
+	// Prefetching assigns more items per update, for a margin's worth of rows on each side
+	list = make_list(engine, false, large, false, LIST_HEIGHT * 0.5f);
+	time_scrolling(t, "binary search, prefetching half a screen, " + largeName, list);
+	list->release();
+
+	// Variable sizes measure each item the first time it scrolls on, which lays the list out again, so the
+	// first pass down the list includes the measuring. After a screen at a time down the whole list, everything
+	// has been measured.
+	list = make_list(engine, false, large, true, 0.0f);
+	time_scrolling(t, "variable sizes, measuring, " + largeName, list);
+	ds::ui::ScrollArea*		area = list->getScrollArea();
+	for (float position = 0.0f; position <= scrollable_length(area); position += LIST_HEIGHT) {
+		area->setScrollerPosition(ci::vec2(0.0f, -position));
+	}
+	area->setScrollerPosition(ci::vec2(0.0f, 0.0f));
+	time_scrolling(t, "variable sizes, all measured, " + largeName, list);
+	list->release();
+}
+
+} // namespace benchmarks
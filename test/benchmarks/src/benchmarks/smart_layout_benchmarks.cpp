@@ -0,0 +1,164 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/temp_file.h"
+#include "benchmarks/timer.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Poco/Path.h>
+#include <ds/app/engine/engine.h>
+#include <ds/content/content_model.h>
+#include <ds/ui/interface_xml/interface_xml_importer.h>
+#include <ds/ui/layout/smart_layout.h>
+#include <ds/util/string_util.h>
+
+namespace benchmarks {
+
+namespace {
+
+const char*					LAYOUT_FILE = "ds_benchmarks_smart_layout.xml";
+const int					SECTIONS = 8;
+const int					FIELDS_PER_SECTION = 6;
+/// Models the detail screen cycles through, like swiping between items
+const int					MODELS = 4;
+
+/// Sets its model the way SmartLayout did before the bindings were compiled: reading each sprite's model
+/// string, splitting it and looking up its content node on every call. Covers the bindings the generated
+/// layout uses.
+class PreviousSmartLayout : public ds::ui::SmartLayout {
+public:
+	PreviousSmartLayout(ds::ui::SpriteEngine& e)
+			: ds::ui::SmartLayout(e, LAYOUT_FILE, Poco::Path::temp()) {
+	}
+
+	size_t					getSpriteCount() const { return mSpriteMap.size(); }
+
+	void					setContentModelPreviously(ds::model::ContentModelRef& theData) {
+		mContentModel = theData;
+		for (auto child : mSpriteMap) {
+			const auto		theModel = child.second->getUserData().getString("model");
+			if (theModel.empty()) continue;
+
+			for (auto mit : ds::split(theModel, "; ", true)) {
+				auto		keyVals = ds::split(mit, ":", true);
+				if (keyVals.size() != 2) continue;
+				auto		childProps = ds::split(keyVals[1], "->", true);
+				if (childProps.size() != 2) continue;
+
+				ds::model::ContentModelRef	theNode = mContentModel;
+				if (childProps[0] != "this") theNode = mContentModel.getChildByName(childProps[0]);
+
+				const auto	value = theNode.getPropertyString(childProps[1]);
+				if (keyVals[0] == "visible_if_exists") {
+					if (value.empty()) child.second->hide();
+					else child.second->show();
+				} else {
+					ds::ui::XmlImporter::setSpriteProperty(*child.second, keyVals[0], value);
+				}
+			}
+		}
+		runLayout();
+	}
+};
+
+/// A detail screen: a header with a thumbnail, title and badge, then sections of label and value rows
+std::string make_layout_xml() {
+	std::stringstream		xml;
+	xml << "<interface>\n"
+		<< "\t<layout name=\"detail\" layout_type=\"vert\" size=\"1080, 0\" shrink_to_children=\"height\" layout_spacing=\"10\" padding=\"20, 20, 20, 20\">\n"
+		<< "\t\t<layout name=\"header\" layout_type=\"horiz\" shrink_to_children=\"height\" layout_spacing=\"10\">\n"
+		<< "\t\t\t<sprite name=\"thumb\" size=\"200, 200\" model=\"size:this->thumb_size; opacity:this->thumb_opacity\"/>\n"
+		<< "\t\t\t<sprite name=\"title\" size=\"400, 60\" model=\"size:this->title_size\"/>\n"
+		<< "\t\t\t<sprite name=\"badge\" size=\"40, 40\" model=\"visible_if_exists:this->badge\"/>\n"
+		<< "\t\t</layout>\n";
+	for (int s = 0; s < SECTIONS; ++s) {
+		const std::string	section = "section_" + std::to_string(s);
+		xml << "\t\t<layout name=\"" << section << "\" layout_type=\"vert\" shrink_to_children=\"height\" layout_spacing=\"4\" model=\"visible_if_exists:" << section << "->heading\">\n"
+			<< "\t\t\t<sprite name=\"" << section << "_heading\" size=\"300, 30\" model=\"size:" << section << "->heading_size\"/>\n";
+		for (int f = 0; f < FIELDS_PER_SECTION; ++f) {
+			const std::string	field = section + "_field_" + std::to_string(f);
+			xml << "\t\t\t<layout name=\"" << field << "\" layout_type=\"horiz\" shrink_to_children=\"height\" layout_spacing=\"8\">\n"
+				<< "\t\t\t\t<sprite name=\"" << field << "_label\" size=\"160, 24\"/>\n"
+				<< "\t\t\t\t<sprite name=\"" << field << "_value\" size=\"100, 24\" model=\"size:" << section << "->value_" << f << "_size; opacity:"
+				<< section << "->value_" << f << "_opacity\"/>\n"
+				<< "\t\t\t</layout>\n";
+		}
+		xml << "\t\t</layout>\n";
+	}
+	xml << "\t</layout>\n"
+		<< "</interface>\n";
+	return xml.str();
+}
+
+std::string size_string(const int w, const int h) {
+	return std::to_string(w) + ", " + std::to_string(h);
+}
+
+/// Each model has different sizes, and every other one has a badge and skips a section
+ds::model::ContentModelRef make_model(const int m) {
+	ds::model::ContentModelRef	model("item", m + 1);
+	model.setProperty("thumb_size", size_string(200, 200 + m * 20));
+	model.setProperty("thumb_opacity", std::string(m % 2 == 0 ? "1.0" : "0.8"));
+	model.setProperty("title_size", size_string(400 + m * 40, 60));
+	if (m % 2 == 0) model.setProperty("badge", std::string("new"));
+	for (int s = 0; s < SECTIONS; ++s) {
+		ds::model::ContentModelRef	section("section_" + std::to_string(s));
+		if (m % 2 == 0 || s != SECTIONS - 1) section.setProperty("heading", std::string("Section"));
+		section.setProperty("heading_size", size_string(300, 30 + (m + s) % 2 * 30));
+		for (int f = 0; f < FIELDS_PER_SECTION; ++f) {
+			section.setProperty("value_" + std::to_string(f) + "_size", size_string(100 + (m + s + f) % 5 * 40, 24 + (m + f) % 3 * 24));
+			section.setProperty("value_" + std::to_string(f) + "_opacity", std::string((m + f) % 2 == 0 ? "1.0" : "0.6"));
+		}
+		model.addChild(section);
+	}
+	return model;
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+void benchmarkSmartLayout(Timer& t, ds::Engine& engine) {
+	const TempFile			file(LAYOUT_FILE, make_layout_xml());
+	if (!file.isValid()) {
+		t.report("couldn't write the layout file", 0.0, "");
+		return;
+	}
+
+	std::vector<ds::model::ContentModelRef>	models;
+	for (int m = 0; m < MODELS; ++m) models.push_back(make_model(m));
+
+	const auto				loadStart = std::chrono::steady_clock::now();
+	PreviousSmartLayout*	layout = new PreviousSmartLayout(engine);
+	t.report("load the layout", ms_since(loadStart), "ms");
+	engine.getRootSprite().addChildPtr(layout);
+	const std::string		sprites = ", " + std::to_string(layout->getSpriteCount()) + " named sprites";
+
+	// The first model compiles the bindings
+	const auto				compileStart = std::chrono::steady_clock::now();
+	layout->setContentModel(models[0]);
+	t.report("first setContentModel, compiling the bindings", ms_since(compileStart), "ms");
+
+	size_t					next = 0;
+	const double			previous = t.time("swap models, parsing the bindings each time" + sprites, 1, [&]() {
+		layout->setContentModelPreviously(models[next++ % models.size()]);
+	});
+	const double			compiled = t.time("swap models, compiled bindings" + sprites, 1, [&]() {
+		layout->setContentModel(models[next++ % models.size()]);
+	});
+	t.compare("swap models, compiled vs parsing each time", previous, compiled);
+
+	// Setting the same model again still applies every binding and runs the layout, but nothing moves
+	t.time("same model again, compiled bindings" + sprites, 1, [&]() {
+		layout->setContentModel(models[0]);
+	});
+
+	layout->release();
+}
+
+} // namespace benchmarks
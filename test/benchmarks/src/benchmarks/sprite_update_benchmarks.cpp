@@ -0,0 +1,80 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <string>
+#include <vector>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/sprite/sprite.h>
+
+namespace benchmarks {
+
+namespace {
+
+const size_t				CHILDREN_PER_GROUP = 100;
+/// One in this many sprites does per-frame work, like a video or a scroll area
+const size_t				NEEDS_UPDATE_EVERY = 100;
+/// Sprites moved every frame in the changing scene
+const size_t				MOVING = 50;
+
+/// Groups of plain sprites standing in for labels and images that never change
+ds::ui::Sprite* make_tree(ds::Engine& engine, const size_t sprites, std::vector<ds::ui::Sprite*>& leaves) {
+	ds::ui::Sprite*			holder = new ds::ui::Sprite(engine);
+	engine.getRootSprite().addChildPtr(holder);
+	ds::ui::Sprite*			group = nullptr;
+	for (size_t i = 0; i < sprites; ++i) {
+		if (i % CHILDREN_PER_GROUP == 0) {
+			group = new ds::ui::Sprite(engine);
+			holder->addChildPtr(group);
+		}
+		ds::ui::Sprite*		s = new ds::ui::Sprite(engine, 40.0f, 20.0f);
+		s->setPosition(static_cast<float>(i % CHILDREN_PER_GROUP) * 42.0f, static_cast<float>(i / CHILDREN_PER_GROUP) * 22.0f);
+		if (i % NEEDS_UPDATE_EVERY == 0) s->setNeedsUpdate(true);
+		group->addChildPtr(s);
+		leaves.push_back(s);
+	}
+	return holder;
+}
+
+}
+
+void benchmarkSpriteUpdates(Timer& t, ds::Engine& engine) {
+	const double			emptyNs = t.time("engine update, empty scene", 1, [&engine]() { engine.update(); });
+
+	std::vector<ds::ui::Sprite*>	leaves;
+	const size_t			count = t.scaled(10000);
+	ds::ui::Sprite*			holder = make_tree(engine, count, leaves);
+	const std::string		sprites = ", " + std::to_string(count) + " sprites";
+	size_t					frame = 0;
+	auto					move = [&leaves, &frame]() {
+		++frame;
+		for (size_t i = 0; i < MOVING; ++i) {
+			ds::ui::Sprite*	s = leaves[(frame * MOVING + i) * 37 % leaves.size()];
+			s->setPosition(s->getPosition() + ci::vec3(0.0f, (frame % 2 == 0) ? 1.0f : -1.0f, 0.0f));
+		}
+	};
+
+	const double			fullStatic = t.time("full traversal, static" + sprites, 1, [&engine]() { engine.update(); });
+	const double			fullMoving = t.time("full traversal, " + std::to_string(MOVING) + " moving" + sprites, 1, [&]() {
+		move();
+		engine.update();
+	});
+
+	holder->setScheduledUpdates(true);
+	engine.update();
+	t.report("scheduled, sprites on the update list", static_cast<double>(engine.getUpdateListSize()), "sprites");
+	const double			scheduledStatic = t.time("scheduled, static" + sprites, 1, [&engine]() { engine.update(); });
+	const double			scheduledMoving = t.time("scheduled, " + std::to_string(MOVING) + " moving" + sprites, 1, [&]() {
+		move();
+		engine.update();
+	});
+
+	// The sprites' share of each frame, net of an empty scene
+	t.compare("scheduled vs full traversal, static", fullStatic - emptyNs, scheduledStatic - emptyNs);
+	t.compare("scheduled vs full traversal, moving", fullMoving - emptyNs, scheduledMoving - emptyNs);
+
+	holder->release();
+}
+
+} // namespace benchmarks
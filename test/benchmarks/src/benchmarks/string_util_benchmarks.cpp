@@ -0,0 +1,148 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <ds/util/string_util.h>
+
+namespace benchmarks {
+
+namespace {
+
+/// A line of comma separated numbers, like a long attribute value
+std::string number_list(const size_t count) {
+	std::string				s;
+	for (size_t i = 0; i < count; ++i) {
+		if (i > 0) s += ", ";
+		s += std::to_string(i * 37 % 1000) + "." + std::to_string(i % 10);
+	}
+	return s;
+}
+
+/// Lines of text, like a settings or layout file
+std::string lines(const size_t count) {
+	std::string				s;
+	for (size_t i = 0; i < count; ++i) s += "<setting name=\"item_" + std::to_string(i) + "\" value=\"" + std::to_string(i) + "\"/>\n";
+	return s;
+}
+
+void benchmarkSplit(Timer& t) {
+	const std::string		list = number_list(t.scaled(1000));
+	const size_t			pieces = ds::split(list, ", ").size();
+
+	const double			allocating = t.time("split", pieces, [&list]() {
+		const auto			v = ds::split(list, ", ");
+		keep(v);
+	});
+	const double			views = t.time("split_each", pieces, [&list]() {
+		size_t				total = 0;
+		ds::split_each(list, ", ", false, [&total](const boost::string_ref& piece) {
+			total += piece.size();
+			return true;
+		});
+		keep(total);
+	});
+	t.compare("split_each vs split", allocating, views);
+
+	const std::string		size = "400, 300, 2";
+	t.time("split_into, 3 of a vector", 1, [&size]() {
+		boost::string_ref	out[3];
+		keep(ds::split_into(size, ", ", out, 3));
+	});
+
+	const std::string		text = lines(t.scaled(1000));
+	t.time("tokenize, per line", t.scaled(1000), [&text]() {
+		size_t				total = 0;
+		ds::tokenize(text, [&total](const std::string& line) { total += line.size(); });
+		keep(total);
+	});
+	t.time("tokenize_each, per line", t.scaled(1000), [&text]() {
+		size_t				total = 0;
+		ds::tokenize_each(text, '\n', [&total](const boost::string_ref& line) {
+			total += line.size();
+			return true;
+		});
+		keep(total);
+	});
+}
+
+void benchmarkNumbers(Timer& t) {
+	std::vector<std::string>	numbers;
+	for (size_t i = 0; i < 1000; ++i) numbers.push_back(std::to_string(static_cast<double>(i) * 1.37 - 200.0));
+
+	const double			stream = t.time("string_to_value<float>", numbers.size(), [&numbers]() {
+		float				total = 0.0f;
+		for (auto& n : numbers) {
+			float			v = 0.0f;
+			ds::string_to_value(n, v);
+			total += v;
+		}
+		keep(total);
+	});
+	const double			parsed = t.time("parse_float", numbers.size(), [&numbers]() {
+		float				total = 0.0f;
+		for (auto& n : numbers) {
+			float			v = 0.0f;
+			ds::parse_float(n, v);
+			total += v;
+		}
+		keep(total);
+	});
+	t.compare("parse_float vs string_to_value", stream, parsed);
+
+	t.time("parse_int", numbers.size(), [&numbers]() {
+		int					total = 0;
+		for (auto& n : numbers) {
+			int				v = 0;
+			ds::parse_int(n, v);
+			total += v;
+		}
+		keep(total);
+	});
+
+	t.time("parseVector", 1, []() {
+		keep(ds::parseVector("1920, 1080, 0"));
+	});
+	t.time("parseRect", 1, []() {
+		keep(ds::parseRect("40, 40, 1920, 1080"));
+	});
+}
+
+void benchmarkReplace(Timer& t) {
+	std::string				text;
+	for (size_t i = 0, count = t.scaled(1000); i < count; ++i) text += "a &lt;b&gt; &amp; &quot;c&quot; ";
+
+	const double			separate = t.time("replace, 4 tokens one at a time", 1, [&text]() {
+		std::string			s = text;
+		ds::replace(s, "&lt;", "<");
+		ds::replace(s, "&gt;", ">");
+		ds::replace(s, "&quot;", "\"");
+		ds::replace(s, "&amp;", "&");
+		keep(s);
+	});
+	const std::vector<std::pair<std::string, std::string>>	tokens = { { "&lt;", "<" }, { "&gt;", ">" }, { "&quot;", "\"" }, { "&amp;", "&" } };
+	const double			onePass = t.time("replace_all, 4 tokens in one pass", 1, [&text, &tokens]() {
+		keep(ds::replace_all(text, tokens));
+	});
+	t.compare("replace_all vs replace", separate, onePass);
+
+	t.time("find_count", 1, [&text]() {
+		keep(ds::find_count(text, "&;"));
+	});
+	t.time("find_delimiter, to the end", 1, [&text]() {
+		keep(ds::find_delimiter(text, "not there"));
+	});
+}
+
+}
+
+void benchmarkStringUtil(Timer& t) {
+	benchmarkSplit(t);
+	benchmarkNumbers(t);
+	benchmarkReplace(t);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,77 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cinder/TriMesh.h>
+#include <ds/ui/drawing/stroke_tessellator.h>
+
+namespace benchmarks {
+
+namespace {
+
+typedef ds::ui::StrokeSample	Sample;
+
+/// Five fingers drawing waves at the same time, their samples interleaved the way touch events arrive
+std::vector<Sample> fingers(const size_t samplesPerFinger) {
+	std::vector<Sample>		samples;
+	for (size_t i = 0; i < samplesPerFinger; ++i) {
+		for (int finger = 0; finger < 5; ++finger) {
+			int				flags = Sample::kNone;
+			if (i == 0) flags |= Sample::kBegin;
+			if (i + 1 == samplesPerFinger) flags |= Sample::kEnd;
+			const float		x = static_cast<float>(i) * 6.0f;
+			const float		y = 200.0f + static_cast<float>(finger) * 150.0f + 60.0f * sinf(static_cast<float>(i) * 0.05f + static_cast<float>(finger));
+			samples.push_back(Sample(finger, ci::vec2(x, y), flags));
+		}
+	}
+	return samples;
+}
+
+}
+
+void benchmarkStrokes(Timer& t) {
+	const std::vector<Sample>	samples = fingers(t.scaled(400));
+	ds::ui::StrokeTessellator	tessellator;
+	std::vector<ci::vec2>	stamps;
+
+	t.time("tessellate, per sample", samples.size(), [&samples, &tessellator, &stamps]() {
+		stamps.clear();
+		for (auto& sample : samples) tessellator.addSample(sample, stamps);
+		keep(stamps.size());
+	});
+	t.report("stamps per sample", static_cast<double>(stamps.size()) / static_cast<double>(samples.size()), "stamps");
+
+	t.time("buildQuadMesh, per stamp", stamps.size(), [&stamps]() {
+		ci::TriMesh			mesh(ci::TriMesh::Format().positions(2).texCoords0(2));
+		ds::ui::StrokeTessellator::buildQuadMesh(stamps, ci::vec2(24.0f, 24.0f), mesh);
+		keep(mesh.getNumTriangles());
+	});
+	t.time("buildCircleMesh, 16 segments, per stamp", stamps.size(), [&stamps]() {
+		ci::TriMesh			mesh(ci::TriMesh::Format().positions(2));
+		ds::ui::StrokeTessellator::buildCircleMesh(stamps, 12.0f, 16, mesh);
+		keep(mesh.getNumTriangles());
+	});
+
+	std::string				bytes;
+	t.time("StrokeCodec::encode, per sample", samples.size(), [&samples, &bytes]() {
+		ds::ui::StrokeCodec::encode(samples, bytes);
+		keep(bytes.size());
+	});
+	std::vector<Sample>		decoded;
+	t.time("StrokeCodec::decode, per sample", samples.size(), [&bytes, &decoded]() {
+		decoded.clear();
+		ds::ui::StrokeCodec::decode(bytes, decoded);
+		keep(decoded.size());
+	});
+
+	// What replication sends now, against an id and a float pair per sample
+	const double			perSample = static_cast<double>(bytes.size()) / static_cast<double>(samples.size());
+	t.report("encoded size", perSample, "bytes/sample");
+	t.report("encoded size vs 16 byte samples", 16.0 / perSample, "x smaller");
+}
+
+} // namespace benchmarks
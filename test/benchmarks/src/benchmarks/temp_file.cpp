@@ -0,0 +1,26 @@
+#include "stdafx.h"
+
+#include "benchmarks/temp_file.h"
+
+#include <fstream>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+
+namespace benchmarks {
+
+TempFile::TempFile(const std::string& fileName, const std::string& contents)
+		: mPath(Poco::Path(Poco::Path::temp(), fileName).toString())
+		, mValid(false) {
+	std::ofstream				out(mPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	out << contents;
+	mValid = out.good();
+}
+
+TempFile::~TempFile() {
+	try {
+		Poco::File(mPath).remove();
+	} catch (std::exception&) {
+	}
+}
+
+} // namespace benchmarks
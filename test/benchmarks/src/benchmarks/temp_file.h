@@ -0,0 +1,32 @@
+#ifndef _BENCHMARKS_BENCHMARKS_TEMP_FILE_H_
+#define _BENCHMARKS_BENCHMARKS_TEMP_FILE_H_
+
+#include <string>
+
+namespace benchmarks {
+
+/**
+ * \class TempFile
+ * A file written to the temp folder for as long as this exists, like a generated layout for the
+ * xml importer to load.
+ */
+class TempFile {
+public:
+	TempFile(const std::string& fileName, const std::string& contents);
+	/// Deletes the file
+	~TempFile();
+
+	bool						isValid() const { return mValid; }
+	const std::string&			getPath() const { return mPath; }
+
+private:
+	TempFile(const TempFile&) = delete;
+	TempFile&					operator=(const TempFile&) = delete;
+
+	const std::string			mPath;
+	bool						mValid;
+};
+
+} // namespace benchmarks
+
+#endif // !_BENCHMARKS_BENCHMARKS_TEMP_FILE_H_
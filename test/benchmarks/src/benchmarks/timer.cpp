@@ -0,0 +1,67 @@
+#include "stdafx.h"
+
+#include "benchmarks/timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace benchmarks {
+
+namespace {
+
+const void* volatile		KEPT = nullptr;
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+void keep(const void* p) {
+	KEPT = p;
+}
+
+Timer::Timer(const std::string& suite, const double scale, const double minMs)
+		: mSuite(suite)
+		, mScale(scale)
+		, mMinMs(minMs) {
+}
+
+size_t Timer::scaled(const size_t n) const {
+	return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(n) * mScale));
+}
+
+double Timer::time(const std::string& name, const size_t operations, const std::function<void()>& fn) {
+	fn();
+
+	size_t					runs = 0;
+	double					elapsedMs = 0.0;
+	const auto				start = std::chrono::steady_clock::now();
+	while (elapsedMs < mMinMs || runs < 3) {
+		fn();
+		++runs;
+		elapsedMs = ms_since(start);
+	}
+
+	const double			ops = static_cast<double>(runs) * static_cast<double>(std::max<size_t>(1, operations));
+	const double			ns = elapsedMs * 1000000.0 / ops;
+	report(name, ns, "ns/op");
+	return ns;
+}
+
+void Timer::report(const std::string& name, const double value, const std::string& unit) {
+	std::stringstream		ss;
+	ss << "benchmarks: " << mSuite << "/" << name << ": " << value << " " << unit;
+	if (unit == "ns/op" && value > 0.0) ss << ", " << static_cast<long long>(1000000000.0 / value) << " ops/s";
+	std::cout << ss.str() << std::endl;
+	DS_LOG_INFO(ss.str());
+}
+
+void Timer::compare(const std::string& name, const double beforeNs, const double afterNs) {
+	if (afterNs <= 0.0) return;
+	report(name, beforeNs / afterNs, "x faster");
+}
+
+} // namespace benchmarks
@@ -0,0 +1,49 @@
+#ifndef _BENCHMARKS_BENCHMARKS_TIMER_H_
+#define _BENCHMARKS_BENCHMARKS_TIMER_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace benchmarks {
+
+/**
+ * \class Timer
+ * Times a piece of work for one suite and prints a line per result, like
+ * "benchmarks: string_util/split: 123.4 ns/op, 8100000 ops/s".
+ */
+class Timer {
+public:
+	/// scale multiplies the sizes suites ask for with scaled(). Each measurement repeats until at least minMs has passed.
+	Timer(const std::string& suite, const double scale, const double minMs);
+
+	/// n times the scale, and at least 1
+	size_t					scaled(const size_t n) const;
+
+	/// Runs fn once to warm up, then repeats it until minMs has passed. fn does operations of whatever's
+	/// being measured each call. Prints and returns the nanoseconds per operation.
+	double					time(const std::string& name, const size_t operations, const std::function<void()>& fn);
+
+	/// Prints a result that was measured some other way
+	void					report(const std::string& name, const double value, const std::string& unit);
+
+	/// Prints how many times faster the second time is than the first
+	void					compare(const std::string& name, const double beforeNs, const double afterNs);
+
+	const std::string&		getSuite() const { return mSuite; }
+
+private:
+	const std::string		mSuite;
+	const double			mScale;
+	const double			mMinMs;
+};
+
+/// Hands a result to the other translation unit, so the compiler can't drop the work that made it
+void						keep(const void*);
+
+template <typename T>
+void						keep(const T& value) { keep(static_cast<const void*>(&value)); }
+
+} // namespace benchmarks
+
+#endif // !_BENCHMARKS_BENCHMARKS_TIMER_H_
@@ -0,0 +1,134 @@
+#include "stdafx.h"
+
+#include "benchmarks/benchmarks.h"
+#include "benchmarks/timer.h"
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <cinder/Easing.h>
+#include <cinder/Timeline.h>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/sprite/sprite.h>
+#include <ds/ui/tween/batch_tweener.h>
+#include <ds/ui/tween/tweenline.h>
+
+namespace benchmarks {
+
+namespace {
+
+typedef std::function<void(ds::ui::Sprite&, const size_t index, const std::function<void(void)>& finished)>	Starter;
+
+/// Each sprite tweens position, scale and opacity
+const size_t				TWEENS_PER_SPRITE = 3;
+const float					DURATION = 0.5f;
+/// Gives up on an animation that never finishes
+const int					MAX_FRAMES = 600;
+
+struct Animation {
+	Animation() : mStartNs(0.0), mFrameMs(0.0), mFrames(0) {}
+	/// Per tween started
+	double					mStartNs;
+	/// Per frame, the whole engine update plus stepping the timeline
+	double					mFrameMs;
+	int						mFrames;
+};
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// One engine update, then the cinder timeline stepped by the same amount of engine time, which is what the
+/// app loop does between updates
+double run_frame(ds::Engine& e) {
+	const auto				start = std::chrono::steady_clock::now();
+	const double			before = e.getElapsedTimeSeconds();
+	e.update();
+	e.getTweenline().getTimeline().step(static_cast<float>(e.getElapsedTimeSeconds() - before));
+	return ms_since(start);
+}
+
+/// A grid of tiles all transitioning at once, staggered a little, like an attract loop changing over
+Animation animate(ds::Engine& e, const std::vector<ds::ui::Sprite*>& sprites, const Starter& start) {
+	for (size_t i = 0; i < sprites.size(); ++i) {
+		sprites[i]->setPosition(static_cast<float>(i % 50) * 38.0f, static_cast<float>(i / 50) * 26.0f);
+		sprites[i]->setScale(1.0f);
+		sprites[i]->setOpacity(1.0f);
+	}
+
+	Animation				ans;
+	size_t					finished = 0;
+	const auto				started = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < sprites.size(); ++i) start(*sprites[i], i, [&finished]() { ++finished; });
+	ans.mStartNs = ms_since(started) * 1000000.0 / static_cast<double>(sprites.size() * TWEENS_PER_SPRITE);
+
+	while (finished < sprites.size() && ans.mFrames < MAX_FRAMES) {
+		ans.mFrameMs += run_frame(e);
+		++ans.mFrames;
+	}
+	if (ans.mFrames > 0) ans.mFrameMs /= static_cast<double>(ans.mFrames);
+	return ans;
+}
+
+/// The best of a few runs, since each one is a whole animation rather than something Timer can repeat
+Animation best_of(ds::Engine& e, const std::vector<ds::ui::Sprite*>& sprites, const Starter& start, const int runs) {
+	Animation				best;
+	for (int i = 0; i < runs; ++i) {
+		const Animation		a = animate(e, sprites, start);
+		if (i == 0 || a.mFrameMs < best.mFrameMs) best.mFrameMs = a.mFrameMs;
+		if (i == 0 || a.mStartNs < best.mStartNs) best.mStartNs = a.mStartNs;
+		best.mFrames = a.mFrames;
+	}
+	return best;
+}
+
+}
+
+void benchmarkTweens(Timer& t, ds::Engine& engine) {
+	ds::ui::Sprite*			holder = new ds::ui::Sprite(engine);
+	engine.getRootSprite().addChildPtr(holder);
+	std::vector<ds::ui::Sprite*>	sprites;
+	for (size_t i = 0, count = t.scaled(2000); i < count; ++i) {
+		ds::ui::Sprite*		s = new ds::ui::Sprite(engine, 32.0f, 24.0f);
+		holder->addChildPtr(s);
+		sprites.push_back(s);
+	}
+
+	// What the frame costs without any tweens, so it can be taken out
+	double					idleMs = 0.0;
+	for (int i = 0; i < 30; ++i) idleMs += run_frame(engine);
+	idleMs /= 30.0;
+	t.report("engine update, " + std::to_string(sprites.size()) + " sprites, no tweens", idleMs, "ms/frame");
+
+	const int				runs = 3;
+	const Animation			timeline = best_of(engine, sprites, [](ds::ui::Sprite& s, const size_t i, const std::function<void(void)>& finished) {
+		const float			delay = static_cast<float>(i % 20) * 0.01f;
+		s.tweenPosition(s.getPosition() + ci::vec3(0.0f, 400.0f, 0.0f), DURATION, delay, ci::easeOutQuad, finished);
+		s.tweenScale(ci::vec3(0.5f, 0.5f, 1.0f), DURATION, delay, ci::easeOutQuad);
+		s.tweenOpacity(0.0f, DURATION, delay, ci::easeInOutSine);
+	}, runs);
+
+	ds::ui::BatchTweener&	batch = engine.getBatchTweener();
+	const Animation			batched = best_of(engine, sprites, [&batch](ds::ui::Sprite& s, const size_t i, const std::function<void(void)>& finished) {
+		const float			delay = static_cast<float>(i % 20) * 0.01f;
+		batch.tweenPosition(s, s.getPosition() + ci::vec3(0.0f, 400.0f, 0.0f), DURATION, delay, ci::easeOutQuad, finished);
+		batch.tweenScale(s, ci::vec3(0.5f, 0.5f, 1.0f), DURATION, delay, ci::easeOutQuad);
+		batch.tweenOpacity(s, 0.0f, DURATION, delay, ci::easeInOutSine);
+	}, runs);
+
+	const double			perTween = 1000000.0 / static_cast<double>(sprites.size() * TWEENS_PER_SPRITE);
+	t.report("Timeline, start", timeline.mStartNs, "ns/tween");
+	t.report("BatchTweener, start", batched.mStartNs, "ns/tween");
+	t.compare("BatchTweener vs Timeline, start", timeline.mStartNs, batched.mStartNs);
+	t.report("Timeline, update", (timeline.mFrameMs - idleMs) * perTween, "ns/tween/frame");
+	t.report("BatchTweener, update", (batched.mFrameMs - idleMs) * perTween, "ns/tween/frame");
+	t.report("Timeline, whole frame", timeline.mFrameMs, "ms/frame");
+	t.report("BatchTweener, whole frame", batched.mFrameMs, "ms/frame");
+	t.compare("BatchTweener vs Timeline, tween cost per frame", timeline.mFrameMs - idleMs, batched.mFrameMs - idleMs);
+	t.report("Timeline, frames to finish", timeline.mFrames, "frames");
+	t.report("BatchTweener, frames to finish", batched.mFrames, "frames");
+
+	holder->release();
+}
+
+} // namespace benchmarks
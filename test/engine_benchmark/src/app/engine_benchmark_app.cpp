@@ -0,0 +1,240 @@
+#include "stdafx.h"
+
+#include "engine_benchmark_app.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <Poco/Path.h>
+#include <ds/app/engine/engine.h>
+#include <ds/app/environment.h>
+#include <ds/debug/frame_profiler.h>
+#include <ds/debug/logger.h>
+#include <ds/ui/sprite/text.h>
+
+#include <cinder/app/RendererGl.h>
+
+namespace downstream {
+
+namespace {
+
+const float					GRID_SPACING = 12.0f;
+const float					MOVE_DISTANCE = 20.0f;
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+const char* mode_name(const int mode) {
+	if(mode == ds::ui::SpriteEngine::CLIENT_MODE) return "client";
+	if(mode == ds::ui::SpriteEngine::SERVER_MODE) return "server";
+	if(mode == ds::ui::SpriteEngine::CLIENTSERVER_MODE) return "clientserver";
+	return "standalone";
+}
+
+}
+
+engine_benchmark_app::engine_benchmark_app()
+	: ds::App()
+	, mSpriteCount(mEngine.getAppSettings().getInt("benchmark:sprites", 0, 2000))
+	, mTextCount(mEngine.getAppSettings().getInt("benchmark:texts", 0, 200))
+	, mMovingPercent(mEngine.getAppSettings().getInt("benchmark:moving_percent", 0, 25))
+	, mWarmupFrames(mEngine.getAppSettings().getInt("benchmark:warmup_frames", 0, 60))
+	, mFrames(mEngine.getAppSettings().getInt("benchmark:frames", 0, 600))
+	, mSpawnClient(mEngine.getAppSettings().getBool("benchmark:spawn_client", 0, true))
+	, mTimeoutSeconds(mEngine.getAppSettings().getInt("benchmark:timeout_seconds", 0, 120))
+	, mFrame(0)
+	, mUpdateMs(0.0)
+	, mSerializeMs(0.0)
+	, mBytes(0.0)
+	, mStarted(std::chrono::steady_clock::now())
+	, mSpawnedClient(false)
+	, mDone(false)
+{
+}
+
+void engine_benchmark_app::setupServer(){
+	mMoving.clear();
+	mMovingFrom.clear();
+	mMovingTexts.clear();
+
+	ds::ui::Sprite& rootSprite = mEngine.getRootSprite();
+	const int columns = std::max(1, static_cast<int>(mEngine.getWorldWidth() / GRID_SPACING));
+
+	// Every nth sprite moves, so the moving ones are spread through the scene
+	const int moveEvery = mMovingPercent > 0 ? std::max(1, 100 / mMovingPercent) : 0;
+	for(int i = 0; i < mSpriteCount; ++i){
+		ds::ui::Sprite* sp = new ds::ui::Sprite(mEngine, GRID_SPACING - 2.0f, GRID_SPACING - 2.0f);
+		sp->setTransparent(false);
+		sp->setColor(ci::Color(static_cast<float>(i % 7) / 7.0f, 0.5f, 0.5f));
+		sp->setPosition(static_cast<float>(i % columns) * GRID_SPACING, static_cast<float>(i / columns) * GRID_SPACING);
+		rootSprite.addChildPtr(sp);
+		if(moveEvery > 0 && i % moveEvery == 0){
+			mMoving.push_back(sp);
+			mMovingFrom.push_back(sp->getPosition());
+		}
+	}
+
+	for(int i = 0; i < mTextCount; ++i){
+		ds::ui::Text* text = new ds::ui::Text(mEngine);
+		text->setTextStyle("Sans", 14.0, ci::Color::white());
+		text->setText("Text " + std::to_string(i));
+		text->setPosition(static_cast<float>(i % 10) * 100.0f, static_cast<float>(i / 10) * 20.0f);
+		rootSprite.addChildPtr(text);
+		if(moveEvery > 0 && i % moveEvery == 0) mMovingTexts.push_back(text);
+	}
+}
+
+void engine_benchmark_app::moveSprites(){
+	// Deterministic, so every run does the same work
+	const float phase = static_cast<float>(mFrame) * 0.1f;
+	for(size_t i = 0; i < mMoving.size(); ++i){
+		const ci::vec3& from = mMovingFrom[i];
+		mMoving[i]->setPosition(from.x + MOVE_DISTANCE * std::sin(phase + static_cast<float>(i)), from.y);
+	}
+	for(size_t i = 0; i < mMovingTexts.size(); ++i){
+		mMovingTexts[i]->setText("Frame " + std::to_string(mFrame + static_cast<int>(i)));
+	}
+}
+
+void engine_benchmark_app::update(){
+	if(mDone){
+		ds::App::update();
+		return;
+	}
+	if(ms_since(mStarted) > mTimeoutSeconds * 1000.0){
+		giveUp("timed out after " + std::to_string(static_cast<int>(mTimeoutSeconds)) + " seconds");
+		return;
+	}
+	if(mSpawnClient && !mSpawnedClient && mEngine.getMode() == ds::ui::SpriteEngine::SERVER_MODE){
+		spawnClient();
+		if(mDone) return;
+	}
+	if(mFrame >= mWarmupFrames + mFrames){
+		serveClient();
+		return;
+	}
+
+	const bool client = mEngine.getMode() == ds::ui::SpriteEngine::CLIENT_MODE;
+	const bool timing = mFrame >= mWarmupFrames;
+	if(!client) moveSprites();
+
+	const auto start = std::chrono::steady_clock::now();
+	ds::App::update();
+	const double updateMs = ms_since(start);
+
+	double bytes = 0.0;
+	double serializeMs = 0.0;
+	if(mEngine.getMode() == ds::ui::SpriteEngine::STANDALONE_MODE){
+		// Nothing else serializes a standalone scene, so this sees the same changes a server would send
+		const auto serializeStart = std::chrono::steady_clock::now();
+		mBuffer.clear();
+		mEngine.getRootSprite().writeTo(mBuffer);
+		serializeMs = ms_since(serializeStart);
+		bytes = static_cast<double>(mBuffer.size());
+	} else {
+		bytes = static_cast<double>(client ? mEngine.getBytesRecieved() : mEngine.getBytesSent());
+	}
+
+	// A client doesn't count frames until the server's world starts arriving
+	if(client && mFrame == 0 && bytes <= 0.0) return;
+
+	++mFrame;
+	if(!timing) return;
+
+	mUpdateMs += updateMs;
+	mSerializeMs += serializeMs;
+	mBytes += bytes;
+
+	if(mFrame == mWarmupFrames + mFrames){
+		report();
+		if(!mClient){
+			mDone = true;
+			quit();
+		}
+	}
+}
+
+void engine_benchmark_app::spawnClient(){
+	mSpawnedClient = true;
+
+	// The first parameter is how this copy was run, which ctest gives as a full path
+	const std::vector<std::string> params = ds::Environment::getCommandLineParams();
+	if(params.empty()){
+		giveUp("couldn't find its own executable to launch the client");
+		return;
+	}
+
+	try {
+		Poco::Path exe(params.front());
+		exe.makeAbsolute();
+		Poco::Process::Args args;
+		args.push_back("app_settings=engine_client.xml");
+		// No pipes, so the client writes to the same console, and ctest sees its report too
+		mClient.reset(new Poco::ProcessHandle(Poco::Process::launch(exe.toString(), args, Poco::Path::current())));
+	} catch(const std::exception& ex){
+		giveUp(std::string("couldn't launch the client: ") + ex.what());
+	}
+}
+
+void engine_benchmark_app::serveClient(){
+	if(mClient && Poco::Process::isRunning(*mClient)){
+		moveSprites();
+		++mFrame;
+		ds::App::update();
+		return;
+	}
+
+	if(mClient){
+		const int code = mClient->wait();
+		mClient.reset();
+		std::cout << "engine_benchmark: client exited with " << code << std::endl;
+	}
+	mDone = true;
+	quit();
+}
+
+void engine_benchmark_app::giveUp(const std::string& why){
+	const std::string msg = std::string("engine_benchmark: ") + mode_name(mEngine.getMode()) + " gave up, " + why;
+	std::cout << msg << std::endl;
+	DS_LOG_WARNING(msg);
+
+	if(mClient){
+		if(Poco::Process::isRunning(*mClient)) Poco::Process::kill(*mClient);
+		mClient.reset();
+	}
+	mDone = true;
+	quit();
+}
+
+void engine_benchmark_app::report(){
+	const int mode = mEngine.getMode();
+	const double frames = static_cast<double>(mFrames);
+
+	std::stringstream ss;
+	ss << "engine_benchmark: " << mode_name(mode) << ", " << mSpriteCount << " sprites, " << mTextCount << " texts, "
+		<< mMovingPercent << "% moving, " << mFrames << " frames" << std::endl;
+	ss << "  update:    " << mUpdateMs / frames << " ms/frame" << std::endl;
+	if(mode == ds::ui::SpriteEngine::STANDALONE_MODE){
+		ss << "  serialize: " << mSerializeMs / frames << " ms/frame, " << mBytes / frames << " bytes/frame" << std::endl;
+	} else if(mode == ds::ui::SpriteEngine::CLIENT_MODE){
+		ss << "  received:  " << mBytes / frames << " bytes/frame, applied during the update" << std::endl;
+	} else {
+		ss << "  sent:      " << mBytes / frames << " bytes/frame" << std::endl;
+	}
+
+	// Where the update went, from the engine's own timers. These are smoothed over the last few frames.
+	for(auto& timing : ds::FrameProfiler::getPhaseTimings()){
+		ss << "  " << std::string(timing.mDepth * 2, ' ') << timing.mName << ": " << timing.mAverageMs << " ms" << std::endl;
+	}
+
+	std::cout << ss.str();
+	DS_LOG_INFO(ss.str());
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::engine_benchmark_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
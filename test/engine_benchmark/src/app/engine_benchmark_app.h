@@ -0,0 +1,76 @@
+#ifndef _ENGINE_BENCHMARK_APP_H_
+#define _ENGINE_BENCHMARK_APP_H_
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <Poco/Process.h>
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+#include <ds/data/data_buffer.h>
+
+namespace ds {
+namespace ui {
+class Sprite;
+class Text;
+}
+}
+
+namespace downstream {
+
+/**
+ * \class engine_benchmark_app
+ * Builds a synthetic scene from settings/app_settings.xml, moves part of it every frame, times the updates,
+ * prints the averages and quits. Runs headless (see settings/engine.xml), so the numbers don't depend on a GPU.
+ * Standalone, it also serializes the scene each frame the way a server would, to time that and count the bytes.
+ * For the real network path, run one copy as a server and another as a client: the server reports the bytes it sent,
+ * and the client's update time is mostly receiving and applying them.
+ * Run with app_settings=engine_server.xml, the server launches the client itself as a second process, so ctest gets
+ * both over loopback in one unattended run. It can't be one process: Cinder makes exactly one App per process, and
+ * ds::App, its Engine and the services it registers are all built around being that one app.
+ */
+class engine_benchmark_app : public ds::App {
+public:
+	engine_benchmark_app();
+
+	virtual void					setupServer() override;
+	virtual void					update() override;
+
+private:
+	void							moveSprites();
+	void							report();
+	/// Launches another copy of this executable as the client
+	void							spawnClient();
+	/// After the server's own frames, keeps the scene moving until the client it launched is done
+	void							serveClient();
+	/// Prints why and quits, stopping the client first if there is one
+	void							giveUp(const std::string& why);
+
+	const int						mSpriteCount;
+	const int						mTextCount;
+	const int						mMovingPercent;
+	const int						mWarmupFrames;
+	const int						mFrames;
+	const bool						mSpawnClient;
+	const double					mTimeoutSeconds;
+
+	std::vector<ds::ui::Sprite*>	mMoving;
+	/// Where each moving sprite started, which it moves back and forth from
+	std::vector<ci::vec3>			mMovingFrom;
+	std::vector<ds::ui::Text*>		mMovingTexts;
+	/// Frames run so far, warmup included
+	int								mFrame;
+	double							mUpdateMs;
+	double							mSerializeMs;
+	double							mBytes;
+	ds::DataBuffer					mBuffer;
+
+	std::chrono::steady_clock::time_point	mStarted;
+	bool							mSpawnedClient;
+	std::unique_ptr<Poco::ProcessHandle>	mClient;
+	bool							mDone;
+};
+
+} // !namespace downstream
+
+#endif // !_ENGINE_BENCHMARK_APP_H_
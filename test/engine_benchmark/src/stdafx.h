@@ -0,0 +1,24 @@
+#pragma once
+
+// Cinder
+#include <cinder/Cinder.h>
+#include <cinder/Color.h>
+#include <cinder/Rect.h>
+#include <cinder/Vector.h>
+#include <cinder/Function.h>
+#include <cinder/app/App.h>
+#include <cinder/Xml.h>
+
+// ds_cinder
+#include <ds/app/app.h>
+#include <ds/app/environment.h>
+#include <ds/app/engine/engine.h>
+#include <ds/app/engine/engine_settings.h>
+#include <ds/debug/logger.h>
+#include <ds/ui/sprite/sprite.h>
+#include <ds/ui/sprite/sprite_engine.h>
+
+// Std C++ Library
+#include <string>
+#include <functional>
+#include <vector>
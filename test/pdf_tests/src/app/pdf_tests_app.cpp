@@ -0,0 +1,53 @@
+#include "stdafx.h"
+
+#include "pdf_tests_app.h"
+
+#include <ds/app/engine/engine.h>
+#include <ds/app/environment.h>
+#include <ds/debug/logger.h>
+
+#include <cinder/app/RendererGl.h>
+
+#include "tests/page_flip_harness.h"
+#include "tests/pdf_tests.h"
+
+namespace downstream {
+
+pdf_tests_app::pdf_tests_app()
+	: ds::App()
+	, mRan(false)
+	, mFile(ds::Environment::expand(mEngine.getAppSettings().getString("pdf_tests:file", 0, "%APP%/../../example/pdf/data/multi_pages.pdf")))
+	, mPasses(mEngine.getAppSettings().getInt("pdf_tests:passes", 0, 5))
+{
+}
+
+pdf_tests_app::~pdf_tests_app(){
+}
+
+void pdf_tests_app::update(){
+	ds::App::update();
+
+	if(!mRan){
+		mRan = true;
+		pdf_tests::testTiler(mFile);
+		pdf_tests::benchmarkRenderPool(mFile, mPasses);
+
+		// No prefetching against the player's default of 3 pages ahead
+		mPageFlips.reset(new pdf_tests::PageFlipHarness(mEngine, mFile, { 0, 3 }));
+		return;
+	}
+
+	// The player renders as the engine updates, so the harness takes a step each frame
+	if(!mPageFlips || mPageFlips->update()) return;
+	mPageFlips.reset();
+
+	// Prints "No errors detected." or the number of failures, which ctest checks for
+	const int failures = boost::report_errors();
+	if(failures > 0) DS_LOG_WARNING("PDF tests: " << failures << " failed");
+	quit();
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::pdf_tests_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
@@ -0,0 +1,38 @@
+#ifndef _PDF_TESTS_APP_H_
+#define _PDF_TESTS_APP_H_
+
+#include <memory>
+#include <string>
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+
+namespace pdf_tests {
+class PageFlipHarness;
+}
+
+namespace downstream {
+
+/**
+ * \class pdf_tests_app
+ * Runs the PDF tests and measurements once the engine is up, then steps the page flip harness
+ * a frame at a time, prints the results and quits.
+ * Runs headless (see settings/engine.xml). settings/app_settings.xml picks the document and how many passes to time.
+ */
+class pdf_tests_app : public ds::App {
+public:
+	pdf_tests_app();
+	~pdf_tests_app();
+
+	virtual void		update() override;
+
+private:
+	/// The suites run on the first update, after the engine has finished setting up
+	bool				mRan;
+	const std::string	mFile;
+	const int			mPasses;
+	std::unique_ptr<pdf_tests::PageFlipHarness>	mPageFlips;
+};
+
+} // !namespace downstream
+
+#endif // !_PDF_TESTS_APP_H_
@@ -0,0 +1,167 @@
+#include "stdafx.h"
+
+#include "tests/page_flip_harness.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/media/player/pdf_player.h>
+
+namespace pdf_tests {
+
+/**
+ * \class FlipPlayer
+ * Lets the harness see which of the player's pages have a texture.
+ */
+class FlipPlayer : public ds::ui::PDFPlayer {
+public:
+	FlipPlayer(ds::ui::SpriteEngine& eng)
+		: ds::ui::PDFPlayer(eng, false)
+	{
+	}
+
+	bool isShowing(const int pageNum) {
+		auto findy = mPages.find(pageNum);
+		return findy != mPages.end() && findy->second->visible() && findy->second->getTextureRef();
+	}
+
+	/// Every page in the render window around the current one has been rendered
+	bool isWindowRendered() {
+		const int firstPage = std::max(1, mCurrentPage - mRenderBehindPages);
+		const int lastPage = std::min(mNumPages, mCurrentPage + mRenderAheadPages);
+		for(int i = firstPage; i <= lastPage; ++i) {
+			auto findy = mPages.find(i);
+			if(findy == mPages.end() || !findy->second->getTextureRef()) return false;
+		}
+		return true;
+	}
+};
+
+namespace {
+
+/// Long enough for any page of a sane document on a slow machine
+const std::chrono::seconds		FLIP_TIMEOUT(10);
+/// Someone reading the page wouldn't flip sooner than this, whether or not the window has finished
+const std::chrono::seconds		READ_TIMEOUT(3);
+
+void report(const std::string& line) {
+	std::cout << "pdf_tests: " << line << std::endl;
+	DS_LOG_INFO("pdf_tests: " << line);
+}
+
+}
+
+PageFlipHarness::PageFlipHarness(ds::Engine& eng, const std::string& file, const std::vector<int>& renderAheadPages)
+	: mEngine(eng)
+	, mFile(file)
+	, mRenderAheadPages(renderAheadPages)
+	, mRun(0)
+	, mPlayer(nullptr)
+	, mState(kDone)
+	, mStateFrames(0)
+{
+	if(!mRenderAheadPages.empty()) startRun();
+}
+
+PageFlipHarness::~PageFlipHarness() {
+	if(mPlayer) mPlayer->release();
+}
+
+bool PageFlipHarness::update() {
+	if(mState == kDone) return false;
+
+	++mStateFrames;
+	const auto elapsed = Clock::now() - mStateStart;
+
+	if(mState == kLoading) {
+		if(mPlayer->isShowing(1)) {
+			mState = kReading;
+			mStateStart = Clock::now();
+			mStateFrames = 0;
+		} else if(elapsed > FLIP_TIMEOUT) {
+			BOOST_ERROR("The first page of the PDF never showed");
+			finishRun();
+		}
+
+	} else if(mState == kReading) {
+		if(mPlayer->isWindowRendered() || elapsed > READ_TIMEOUT) flip();
+
+	} else if(mState == kFlipping) {
+		if(!checkShowing() && elapsed > FLIP_TIMEOUT) {
+			BOOST_ERROR("A page never showed after flipping to it");
+			finishRun();
+		}
+	}
+
+	return mState != kDone;
+}
+
+void PageFlipHarness::startRun() {
+	mFlipMs.clear();
+	mFlipFrames.clear();
+
+	mPlayer = new FlipPlayer(mEngine);
+	mPlayer->setRenderAheadPages(mRenderAheadPages[mRun]);
+	mEngine.getRootSprite().addChildPtr(mPlayer);
+	mPlayer->setMedia(mFile);
+	BOOST_TEST(mPlayer->getPageCount() > 1);
+
+	mState = kLoading;
+	mStateStart = Clock::now();
+	mStateFrames = 0;
+}
+
+void PageFlipHarness::flip() {
+	mPlayer->goToNextPage();
+	mState = kFlipping;
+	mStateStart = Clock::now();
+	mStateFrames = 0;
+
+	// A prefetched page shows straight away, in the same frame
+	checkShowing();
+}
+
+bool PageFlipHarness::checkShowing() {
+	if(!mPlayer->isShowing(mPlayer->getPageNum())) return false;
+
+	mFlipMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - mStateStart).count());
+	mFlipFrames.push_back(mStateFrames);
+
+	if(mPlayer->getPageNum() >= mPlayer->getPageCount()) {
+		finishRun();
+	} else {
+		mState = kReading;
+		mStateStart = Clock::now();
+		mStateFrames = 0;
+	}
+	return true;
+}
+
+void PageFlipHarness::finishRun() {
+	const int ahead = mRenderAheadPages[mRun];
+
+	if(!mFlipMs.empty()) {
+		std::vector<double> sorted = mFlipMs;
+		std::sort(sorted.begin(), sorted.end());
+		const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+		const double frames = static_cast<double>(std::accumulate(mFlipFrames.begin(), mFlipFrames.end(), size_t(0))) / static_cast<double>(mFlipFrames.size());
+		const size_t instant = static_cast<size_t>(std::count(mFlipFrames.begin(), mFlipFrames.end(), size_t(0)));
+
+		std::stringstream ss;
+		ss << "page flip, " << ahead << " pages ahead: " << mean << " ms mean, " << sorted[sorted.size() / 2] << " ms median, "
+			<< sorted.back() << " ms worst, " << frames << " frames mean, " << instant << " of " << sorted.size() << " flips in the same frame";
+		if(!mRunMs.empty() && mean > 0.0) ss << " (" << mRunMs.front() / mean << "x faster than " << mRenderAheadPages.front() << " ahead)";
+		report(ss.str());
+		mRunMs.push_back(mean);
+	}
+
+	mPlayer->release();
+	mPlayer = nullptr;
+	mState = kDone;
+
+	if(++mRun < mRenderAheadPages.size()) startRun();
+}
+
+} // namespace pdf_tests
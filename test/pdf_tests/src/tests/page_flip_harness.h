@@ -0,0 +1,60 @@
+#ifndef _PDF_TESTS_TESTS_PAGE_FLIP_HARNESS_H_
+#define _PDF_TESTS_TESTS_PAGE_FLIP_HARNESS_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ds {
+class Engine;
+}
+
+namespace pdf_tests {
+
+class FlipPlayer;
+
+/**
+ * \class PageFlipHarness
+ * Flips a PDFPlayer through every page of a document, once for each render-ahead setting, and prints how long
+ * each flip took to show the new page, in milliseconds and frames. Between flips it waits until the player's
+ * render window has finished, like someone reading the page, so prefetched pages have had their chance.
+ * The player renders from the engine's update, so this runs a step per frame instead of all at once.
+ */
+class PageFlipHarness {
+public:
+	PageFlipHarness(ds::Engine&, const std::string& file, const std::vector<int>& renderAheadPages);
+	~PageFlipHarness();
+
+	/// Call once a frame, after the engine has updated. Returns false once every run is done and reported.
+	bool							update();
+
+private:
+	enum State { kLoading, kReading, kFlipping, kDone };
+
+	void							startRun();
+	void							finishRun();
+	void							flip();
+	/// Records the flip if the new page is showing
+	bool							checkShowing();
+
+	typedef std::chrono::steady_clock	Clock;
+
+	ds::Engine&						mEngine;
+	const std::string				mFile;
+	const std::vector<int>			mRenderAheadPages;
+	size_t							mRun;
+	FlipPlayer*						mPlayer;
+	State							mState;
+
+	Clock::time_point				mStateStart;
+	size_t							mStateFrames;
+	/// Per flip of the current run
+	std::vector<double>				mFlipMs;
+	std::vector<size_t>				mFlipFrames;
+	/// Average flip time of each finished run
+	std::vector<double>				mRunMs;
+};
+
+} // namespace pdf_tests
+
+#endif // !_PDF_TESTS_TESTS_PAGE_FLIP_HARNESS_H_
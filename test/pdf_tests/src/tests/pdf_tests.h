@@ -0,0 +1,18 @@
+#ifndef _PDF_TESTS_TESTS_PDF_TESTS_H_
+#define _PDF_TESTS_TESTS_PDF_TESTS_H_
+
+#include <string>
+
+namespace pdf_tests {
+
+/// Suites check with BOOST_TEST and friends, and print measurements as "pdf_tests: ..." lines.
+/// file is a multi page PDF, the example's multi_pages.pdf by default.
+
+/// Pages per second through a RenderPool with 1, 2, 4 and all the hardware threads, cold and with the pages parsed
+void			benchmarkRenderPool(const std::string& file, const int passes);
+/// The tile pyramid math, then tiles rendered through a pool: what gets drawn, eviction and failures
+void			testTiler(const std::string& file);
+
+} // namespace pdf_tests
+
+#endif // !_PDF_TESTS_TESTS_PDF_TESTS_H_
@@ -0,0 +1,91 @@
+#include "stdafx.h"
+
+#include "tests/pdf_tests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <private/pdf_render_pool.h>
+
+namespace pdf_tests {
+
+namespace {
+
+typedef ds::pdf::RenderPool	Pool;
+
+/// About the scale a letter page fills a 1080 pixel tall screen at
+const float					RENDER_SCALE = 1.5f;
+
+/// Queues every page and waits for all of them. Returns how many rendered.
+int render_all(Pool& pool, const std::string& file, const int pageCount) {
+	std::vector<Pool::RequestRef>	requests;
+	for (int page = 1; page <= pageCount; ++page) {
+		requests.push_back(pool.render(file, page, RENDER_SCALE, Pool::kPriorityVisible));
+	}
+
+	// waitFor() is for worker-side code, the main thread polls like the sprites do
+	int						rendered = 0;
+	for (auto& request : requests) {
+		while (!request->isDone()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		if (request->mSuccess && !request->mPixels.empty()) ++rendered;
+	}
+	return rendered;
+}
+
+double seconds_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string& line) {
+	std::cout << "pdf_tests: " << line << std::endl;
+	DS_LOG_INFO("pdf_tests: " << line);
+}
+
+}
+
+void benchmarkRenderPool(const std::string& file, const int passes) {
+	std::vector<int>		threadCounts = { 1, 2, 4, static_cast<int>(std::thread::hardware_concurrency()) };
+	std::sort(threadCounts.begin(), threadCounts.end());
+	threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+	threadCounts.erase(std::remove(threadCounts.begin(), threadCounts.end(), 0), threadCounts.end());
+
+	double					singleThread = 0.0;
+	for (const int threads : threadCounts) {
+		Pool				pool;
+		pool.start(threads);
+
+		int					width = 0, height = 0, pageCount = 0;
+		BOOST_TEST(pool.examine(file, width, height, pageCount));
+		BOOST_TEST(pageCount > 1);
+		if (pageCount < 1) return;
+
+		// Cold: the document's open, but every page still has to be parsed
+		pool.clearCache();
+		auto				start = std::chrono::steady_clock::now();
+		BOOST_TEST_EQ(render_all(pool, file, pageCount), pageCount);
+		const double		coldSeconds = seconds_since(start);
+
+		// Warm: the pages are parsed, so this is rasterizing, like flipping back through an open document
+		start = std::chrono::steady_clock::now();
+		int					rendered = 0;
+		for (int pass = 0; pass < passes; ++pass) rendered += render_all(pool, file, pageCount);
+		const double		warmSeconds = seconds_since(start);
+		BOOST_TEST_EQ(rendered, pageCount * passes);
+
+		const double		pagesPerSecond = static_cast<double>(rendered) / std::max(warmSeconds, 1e-6);
+		if (threads == 1) singleThread = pagesPerSecond;
+		const Pool::Stats	stats = pool.getStats();
+
+		std::stringstream	ss;
+		ss << "render pool, " << threads << " threads: " << pagesPerSecond << " pages/s";
+		if (singleThread > 0.0) ss << " (" << pagesPerSecond / singleThread << "x one thread)";
+		ss << ", first pass " << static_cast<double>(pageCount) / std::max(coldSeconds, 1e-6) << " pages/s"
+			<< ", " << stats.mRasterSeconds * 1000.0 / std::max<size_t>(1, stats.mPagesRendered) << " ms rasterizing per page";
+		report(ss.str());
+	}
+}
+
+} // namespace pdf_tests
@@ -0,0 +1,163 @@
+#include "stdafx.h"
+
+#include "tests/pdf_tests.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <private/pdf_render_pool.h>
+#include <private/pdf_tiler.h>
+
+namespace pdf_tests {
+
+namespace {
+
+typedef ds::pdf::PdfTiler	Tiler;
+typedef std::vector<Tiler::TileKey>	Keys;
+
+/// US letter, in points
+const ci::ivec2				LETTER(612, 792);
+
+size_t tile_count(const int level, const ci::ivec2& pageSize, const ci::Rectf& area) {
+	Keys					keys;
+	Tiler::tilesForArea(1, level, pageSize, area, keys);
+	return keys.size();
+}
+
+bool same_rect(const ci::Rectf& a, const ci::Rectf& b) {
+	return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+/// Updates until the draw list has count tiles or a few seconds pass. Returns whether it got there.
+bool update_until(Tiler& tiler, const ci::ivec2& pageSize, const ci::Rectf& area, const float zoom, const size_t count) {
+	const auto				start = std::chrono::steady_clock::now();
+	while (std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+		tiler.update(1, pageSize, area, zoom);
+		if (tiler.getDrawList().size() >= count) return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+void testPyramid() {
+	BOOST_TEST_EQ(Tiler::levelForZoom(1.0f), 0);
+	BOOST_TEST_EQ(Tiler::levelForZoom(1.5f), 1);
+	// Exactly a power of two doesn't round up a level
+	BOOST_TEST_EQ(Tiler::levelForZoom(2.0f), 1);
+	BOOST_TEST_EQ(Tiler::levelForZoom(0.25f), -2);
+	BOOST_TEST_EQ(Tiler::levelForZoom(0.3f), -1);
+	BOOST_TEST_EQ(Tiler::levelForZoom(0.0f), 0);
+	BOOST_TEST_EQ(Tiler::levelForZoom(-1.0f), 0);
+	BOOST_TEST_EQ(Tiler::levelForZoom(1000.0f), static_cast<int>(Tiler::kMaxLevel));
+	BOOST_TEST_EQ(Tiler::levelForZoom(0.001f), static_cast<int>(Tiler::kMinLevel));
+
+	BOOST_TEST_EQ(Tiler::levelScale(0), 1.0f);
+	BOOST_TEST_EQ(Tiler::levelScale(-1), 0.5f);
+	BOOST_TEST_EQ(Tiler::levelScale(3), 8.0f);
+
+	// The whole page: 612x792 is 3x4 tiles, and 1224x1584 is 5x7
+	const ci::Rectf			page(0.0f, 0.0f, 612.0f, 792.0f);
+	BOOST_TEST_EQ(tile_count(0, LETTER, page), 12u);
+	BOOST_TEST_EQ(tile_count(1, LETTER, page), 35u);
+	BOOST_TEST_EQ(tile_count(-2, LETTER, page), 1u);
+
+	// Only what intersects the area, and nothing past the page
+	BOOST_TEST_EQ(tile_count(0, LETTER, ci::Rectf(300.0f, 300.0f, 310.0f, 310.0f)), 1u);
+	BOOST_TEST_EQ(tile_count(0, LETTER, ci::Rectf(0.0f, 0.0f, 512.0f, 256.0f)), 2u);
+	BOOST_TEST_EQ(tile_count(0, LETTER, ci::Rectf(-100.0f, -100.0f, 2000.0f, 2000.0f)), 12u);
+	BOOST_TEST_EQ(tile_count(0, LETTER, ci::Rectf(10.0f, 10.0f, 10.0f, 20.0f)), 0u);
+	BOOST_TEST_EQ(tile_count(0, ci::ivec2(0, 0), page), 0u);
+
+	Keys					keys;
+	Tiler::tilesForArea(1, 0, LETTER, ci::Rectf(300.0f, 300.0f, 310.0f, 310.0f), keys);
+	BOOST_TEST(keys.size() == 1 && keys[0] == Tiler::TileKey(1, 0, 1, 1));
+
+	// Tiles on the right and bottom edges are clipped to the page
+	BOOST_TEST(Tiler::tileArea(Tiler::TileKey(1, 0, 0, 0), LETTER) == ci::Area(0, 0, 256, 256));
+	BOOST_TEST(Tiler::tileArea(Tiler::TileKey(1, 0, 2, 0), LETTER) == ci::Area(512, 0, 612, 256));
+	BOOST_TEST(Tiler::tileArea(Tiler::TileKey(1, 0, 2, 3), LETTER) == ci::Area(512, 768, 612, 792));
+	BOOST_TEST(Tiler::tileArea(Tiler::TileKey(1, -2, 0, 0), LETTER) == ci::Area(0, 0, 153, 198));
+}
+
+void testRendering(const std::string& file) {
+	// One worker, so requests finish in the order they were queued
+	ds::pdf::RenderPool		pool;
+	pool.start(1);
+
+	int						width = 0, height = 0, pageCount = 0;
+	BOOST_TEST(pool.examine(file, width, height, pageCount));
+	const ci::ivec2			pageSize(width, height);
+	const ci::Rectf			page(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+
+	Tiler					tiler(pool);
+	tiler.update(1, pageSize, page, 1.0f);
+	BOOST_TEST(tiler.getDrawList().empty());
+	BOOST_TEST_EQ(tiler.getBytes(), 0u);
+
+	// Zoom 1 draws level 0 over the coarse level two below it
+	tiler.setFileName(file);
+	const size_t			count = tile_count(-2, pageSize, page) + tile_count(0, pageSize, page);
+	BOOST_TEST(update_until(tiler, pageSize, page, 1.0f, count));
+	BOOST_TEST_EQ(tiler.getDrawList().size(), count);
+	BOOST_TEST(tiler.getRenderedPageSize() == pageSize);
+	BOOST_TEST_EQ(tiler.getRenderedPageNum(), 1);
+
+	int						lastLevel = Tiler::kMinLevel;
+	size_t					bytes = 0;
+	for (auto& tile : tiler.getDrawList()) {
+		BOOST_TEST(tile->mKey.mLevel >= lastLevel);
+		lastLevel = tile->mKey.mLevel;
+
+		const ci::Area		area = Tiler::tileArea(tile->mKey, pageSize);
+		BOOST_TEST_EQ(tile->mPixels.mW, area.getWidth());
+		BOOST_TEST_EQ(tile->mPixels.mH, area.getHeight());
+		const float			scale = Tiler::levelScale(tile->mKey.mLevel);
+		BOOST_TEST(same_rect(tile->mPageRect, ci::Rectf(area.x1 / scale, area.y1 / scale, area.x2 / scale, area.y2 / scale)));
+		bytes += tile->mBytes;
+	}
+	BOOST_TEST_EQ(tiler.getBytes(), bytes);
+
+	// Over the budget, only the tiles in view stay
+	const ci::Rectf			corner(0.0f, 0.0f, 1.0f, 1.0f);
+	tiler.setMaxBytes(1);
+	tiler.update(1, pageSize, corner, 1.0f);
+	BOOST_TEST_EQ(tiler.getDrawList().size(), 2u);
+	bytes = 0;
+	for (auto& tile : tiler.getDrawList()) bytes += tile->mBytes;
+	BOOST_TEST_EQ(tiler.getBytes(), bytes);
+
+	tiler.clearPage(1);
+	BOOST_TEST_EQ(tiler.getBytes(), 0u);
+	BOOST_TEST(tiler.getDrawList().empty());
+
+	// Zoom 2 is level 1 over level -1
+	tiler.setMaxBytes(64 * 1024 * 1024);
+	BOOST_TEST(update_until(tiler, pageSize, corner, 2.0f, 2));
+	BOOST_TEST_EQ(tiler.getDrawList().front()->mKey.mLevel, -1);
+	BOOST_TEST_EQ(tiler.getDrawList().back()->mKey.mLevel, 1);
+
+	// A missing file fails quietly. The probe is queued after the tiles at a lower priority, so
+	// once it's done so are they.
+	const std::string		missing = file + ".missing.pdf";
+	tiler.setFileName(missing);
+	BOOST_TEST_EQ(tiler.getBytes(), 0u);
+	tiler.update(1, pageSize, page, 1.0f);
+	auto					probe = pool.render(missing, 1, 1.0f, ds::pdf::RenderPool::kPriorityPrefetch);
+	while (!probe->isDone()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	BOOST_TEST(!probe->mSuccess);
+	for (int i = 0; i < 3; ++i) tiler.update(1, pageSize, page, 1.0f);
+	BOOST_TEST(tiler.getDrawList().empty());
+	BOOST_TEST_EQ(tiler.getBytes(), 0u);
+
+	tiler.clear();
+	pool.stop();
+}
+
+}
+
+void testTiler(const std::string& file) {
+	testPyramid();
+	testRendering(file);
+}
+
+} // namespace pdf_tests
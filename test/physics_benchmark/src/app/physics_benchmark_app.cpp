@@ -0,0 +1,38 @@
+#include "stdafx.h"
+
+#include "physics_benchmark_app.h"
+
+#include <iostream>
+#include <ds/app/engine/engine.h>
+#include <ds/debug/logger.h>
+
+#include <cinder/app/RendererGl.h>
+
+#include "benchmarks/physics_benchmark.h"
+
+namespace downstream {
+
+physics_benchmark_app::physics_benchmark_app()
+	: ds::App()
+	, mRan(false)
+	, mBodies(mEngine.getAppSettings().getInt("physics_benchmark:bodies", 0, 3000))
+	, mFrames(mEngine.getAppSettings().getInt("physics_benchmark:frames", 0, 300))
+{
+}
+
+void physics_benchmark_app::update(){
+	ds::App::update();
+	if(mRan) return;
+	mRan = true;
+
+	physics_benchmark::benchmarkStepping(mEngine, mBodies, mFrames);
+
+	// ctest looks for this, so a run that crashes or hangs fails
+	std::cout << "physics_benchmark: done" << std::endl;
+	quit();
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::physics_benchmark_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
@@ -0,0 +1,30 @@
+#ifndef _PHYSICS_BENCHMARK_APP_H_
+#define _PHYSICS_BENCHMARK_APP_H_
+
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+
+namespace downstream {
+
+/**
+ * \class physics_benchmark_app
+ * Runs the physics stepping benchmark once the engine is up, prints the results and quits.
+ * Runs headless (see settings/engine.xml). settings/app_settings.xml sets the number of bodies and frames,
+ * settings/physics.xml and the files read over it set up each stepping mode.
+ */
+class physics_benchmark_app : public ds::App {
+public:
+	physics_benchmark_app();
+
+	virtual void		update() override;
+
+private:
+	/// The benchmark runs on the first update, after the engine has finished setting up
+	bool				mRan;
+	const int			mBodies;
+	const int			mFrames;
+};
+
+} // !namespace downstream
+
+#endif // !_PHYSICS_BENCHMARK_APP_H_
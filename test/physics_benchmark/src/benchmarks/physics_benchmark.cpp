@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include "benchmarks/physics_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <ds/physics/body_builder.h>
+#include <ds/physics/sprite_body.h>
+#include <ds/physics/sprite_world.h>
+#include <private/service.h>
+#include <private/world.h>
+
+namespace physics_benchmark {
+
+namespace {
+
+struct Mode {
+	const char*				mName;
+	/// Read over physics.xml for this mode's world
+	const char*				mSettingsFile;
+	/// The steps run on the world's step thread, so the main thread only waits for them (if at all) and moves sprites
+	bool					mThreaded;
+};
+
+const Mode					MODES[] = {
+	{ "one step per update", "", false },
+	{ "accumulated", "physics_accumulate.xml", false },
+	{ "threaded", "physics_threaded.xml", true }
+};
+
+/// Updates before timing starts, so the step thread is running and the first contacts are sorted out
+const int					SETTLE_FRAMES = 10;
+const float					RADIUS = 6.0f;
+/// Box2D units a second, about 250 pixels a second at the world's scale
+const float					MAX_SPEED = 5.0f;
+
+struct Scene {
+	std::vector<ds::ui::Sprite*>	mSprites;
+	std::vector<std::unique_ptr<ds::physics::SpriteBody>>	mBodies;
+};
+
+/// Circles on a jittered grid covering the world, every other one moving. Seeded, so every mode starts from the same scene.
+void add_bodies(ds::Engine& e, ds::ui::Sprite& holder, const int worldId, const int count, Scene& out) {
+	std::mt19937							random(33);
+	std::uniform_real_distribution<float>	jitter(-0.25f, 0.25f), speed(-MAX_SPEED, MAX_SPEED);
+
+	const float				width = e.getWorldWidth(), height = e.getWorldHeight();
+	const int				columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count) * width / height))));
+	const int				rows = (count + columns - 1) / columns;
+	const float				cellW = width / static_cast<float>(columns), cellH = height / static_cast<float>(rows);
+
+	for (int i = 0; i < count; ++i) {
+		ds::ui::Sprite*		sprite = new ds::ui::Sprite(e, RADIUS * 2.0f, RADIUS * 2.0f);
+		holder.addChildPtr(sprite);
+		sprite->setCenter(0.5f, 0.5f);
+
+		std::unique_ptr<ds::physics::SpriteBody>	body(new ds::physics::SpriteBody(*sprite, worldId));
+		ds::physics::BodyBuilderCircle	builder(*body);
+		builder.mRadius = RADIUS;
+		builder.mDensity = 1.0f;
+		builder.mFriction = 0.0f;
+		builder.mRestitution = 1.0f;
+		body->create(builder);
+
+		const float			x = (static_cast<float>(i % columns) + 0.5f + jitter(random)) * cellW;
+		const float			y = (static_cast<float>(i / columns) + 0.5f + jitter(random)) * cellH;
+		body->setPosition(ci::vec3(x, y, 0.0f));
+		if (i % 2 == 0) body->setLinearVelocity(speed(random), speed(random));
+
+		out.mSprites.push_back(sprite);
+		out.mBodies.push_back(std::move(body));
+	}
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string& line) {
+	std::cout << "physics_benchmark: " << line << std::endl;
+	DS_LOG_INFO("physics_benchmark: " << line);
+}
+
+}
+
+void benchmarkStepping(ds::Engine& e, const int bodies, const int frames) {
+	double					firstMainThreadMs = 0.0;
+	int						worldId = 0;
+	for (auto& mode : MODES) {
+		// The world keeps a reference to its sprite, so the holder stays for the rest of the run
+		ds::ui::Sprite*		holder = new ds::ui::Sprite(e, e.getWorldWidth(), e.getWorldHeight());
+		e.getRootSprite().addChildPtr(holder);
+		const ds::physics::SpriteWorld	spriteWorld(*holder, ++worldId, mode.mSettingsFile);
+		ds::physics::World&	world = e.getService<ds::physics::Service>(ds::physics::SERVICE_NAME).getWorld(worldId);
+
+		Scene				scene;
+		add_bodies(e, *holder, worldId, bodies, scene);
+		for (int i = 0; i < SETTLE_FRAMES; ++i) e.update();
+
+		double				updateMs = 0.0, worstUpdateMs = 0.0, stepMs = 0.0, mainThreadMs = 0.0;
+		size_t				moved = 0;
+		std::vector<ci::vec3>	positions(scene.mSprites.size());
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < positions.size(); ++i) positions[i] = scene.mSprites[i]->getPosition();
+
+			const auto		start = std::chrono::steady_clock::now();
+			e.update();
+			const double	ms = ms_since(start);
+			updateMs += ms;
+			worstUpdateMs = std::max(worstUpdateMs, ms);
+
+			stepMs += world.getLastStepMs();
+			mainThreadMs += world.getLastSyncMs() + (mode.mThreaded ? 0.0 : world.getLastStepMs());
+
+			for (size_t i = 0; i < positions.size(); ++i) {
+				if (scene.mSprites[i]->getPosition() != positions[i]) ++moved;
+			}
+		}
+
+		const double		n = static_cast<double>(std::max(1, frames));
+		std::stringstream	ss;
+		ss << mode.mName << ": " << bodies << " bodies, step " << stepMs / n << " ms, physics on the main thread " << mainThreadMs / n
+			<< " ms, engine update " << updateMs / n << " ms (worst " << worstUpdateMs << " ms), sprites moved per update "
+			<< static_cast<double>(moved) / n;
+		report(ss.str());
+		if (firstMainThreadMs <= 0.0) {
+			firstMainThreadMs = mainThreadMs;
+		} else if (mainThreadMs > 0.0) {
+			std::stringstream	cmp;
+			cmp << mode.mName << ": " << firstMainThreadMs / mainThreadMs << "x less main thread time than " << MODES[0].mName;
+			report(cmp.str());
+		}
+
+		scene.mBodies.clear();
+		for (auto sprite : scene.mSprites) sprite->release();
+	}
+}
+
+} // namespace physics_benchmark
@@ -0,0 +1,17 @@
+#ifndef _PHYSICS_BENCHMARK_BENCHMARKS_PHYSICS_BENCHMARK_H_
+#define _PHYSICS_BENCHMARK_BENCHMARKS_PHYSICS_BENCHMARK_H_
+
+namespace ds {
+class Engine;
+}
+
+namespace physics_benchmark {
+
+/// Makes a world for each stepping mode (one step per update, accumulated, threaded), fills it with bodies
+/// bouncing around the world bounds, and runs frames whole engine updates. Prints "physics_benchmark: ..." lines
+/// with the step time, the main thread's share of the physics and the engine update time for each mode.
+void			benchmarkStepping(ds::Engine&, const int bodies, const int frames);
+
+} // namespace physics_benchmark
+
+#endif // !_PHYSICS_BENCHMARK_BENCHMARKS_PHYSICS_BENCHMARK_H_
@@ -0,0 +1,45 @@
+#include "stdafx.h"
+
+#include "unit_tests_app.h"
+
+#include <ds/app/engine/engine.h>
+#include <ds/debug/logger.h>
+
+#include <cinder/app/RendererGl.h>
+
+#include "tests/unit_tests.h"
+
+namespace downstream {
+
+unit_tests_app::unit_tests_app()
+	: ds::App()
+	, mRan(false)
+{
+}
+
+void unit_tests_app::update(){
+	ds::App::update();
+	if(mRan) return;
+	mRan = true;
+
+	unit_tests::testKeyValueStore();
+	unit_tests::testMarkdown();
+	unit_tests::testStringUtil();
+	unit_tests::testImageProbe();
+	unit_tests::testExifParser();
+	unit_tests::testStrokeTessellator();
+	unit_tests::testAutoUpdateList(mEngine);
+	unit_tests::testScheduledUpdates(mEngine);
+	unit_tests::testLayouts(mEngine);
+	unit_tests::testSmartLayout(mEngine);
+
+	// Prints "No errors detected." or the number of failures, which ctest checks for
+	const int failures = boost::report_errors();
+	if(failures > 0) DS_LOG_WARNING("Unit tests: " << failures << " failed");
+	quit();
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::unit_tests_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
@@ -0,0 +1,27 @@
+#ifndef _UNIT_TESTS_APP_H_
+#define _UNIT_TESTS_APP_H_
+
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+
+namespace downstream {
+
+/**
+ * \class unit_tests_app
+ * Runs every test suite once the engine is up, prints the results and quits.
+ * Runs headless (see settings/engine.xml), so it can go in an automated build.
+ */
+class unit_tests_app : public ds::App {
+public:
+	unit_tests_app();
+
+	virtual void		update() override;
+
+private:
+	/// The suites run on the first update, after the engine has finished setting up
+	bool				mRan;
+};
+
+} // !namespace downstream
+
+#endif // !_UNIT_TESTS_APP_H_
@@ -0,0 +1,204 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <ds/app/app_defs.h>
+#include <ds/app/auto_update.h>
+#include <ds/app/auto_update_list.h>
+#include <ds/params/update_params.h>
+#include <ds/ui/sprite/sprite_engine.h>
+
+namespace unit_tests {
+
+namespace {
+
+const float				FRAME_TIME = 1.0f / 60.0f;
+
+/// Drives the engine's server list directly, one simulated frame at a time.
+/// Time carries on from the engine clock so clients the engine already has aren't thrown off.
+class Frames {
+public:
+	Frames(ds::ui::SpriteEngine& e)
+			: mList(e.getAutoUpdateList(ds::AutoUpdateType::SERVER))
+			, mNow(e.getElapsedTimeSeconds()) {
+	}
+
+	void				run(const int count = 1) {
+		for (int i = 0; i < count; ++i) {
+			mNow += FRAME_TIME;
+			ds::UpdateParams	p;
+			p.setDeltaTime(FRAME_TIME);
+			p.setElapsedTime(static_cast<float>(mNow));
+			mList.update(p);
+		}
+	}
+
+private:
+	ds::AutoUpdateList&	mList;
+	double				mNow;
+};
+
+class Client : public ds::AutoUpdate {
+public:
+	Client(ds::ui::SpriteEngine& e, const int id, std::vector<int>& order)
+			: ds::AutoUpdate(e)
+			, mId(id)
+			, mOrder(order)
+			, mRuns(0)
+			, mLastDelta(0.0f) {
+	}
+
+	int					mId;
+	std::vector<int>&	mOrder;
+	int					mRuns;
+	float				mLastDelta;
+	/// Called from update, to change the list while it's running
+	std::function<void()>
+						mOnUpdate;
+
+protected:
+	virtual void		update(const ds::UpdateParams& p) override {
+		++mRuns;
+		mLastDelta = p.getDeltaTime();
+		mOrder.push_back(mId);
+		// A copy, so the client can delete itself
+		auto			onUpdate = mOnUpdate;
+		if (onUpdate) onUpdate();
+	}
+};
+
+bool contains(const std::vector<int>& v, const int id) {
+	return std::find(v.begin(), v.end(), id) != v.end();
+}
+
+void testEveryFrame(ds::ui::SpriteEngine& e) {
+	std::vector<int>		order;
+	Frames					frames(e);
+	Client					a(e, 1, order);
+	// Added clients wait for the start of the next update, then run every frame
+	frames.run(10);
+	BOOST_TEST_EQ(a.mRuns, 10);
+	BOOST_TEST_EQ(a.mLastDelta, FRAME_TIME);
+}
+
+void testInterval(ds::ui::SpriteEngine& e) {
+	std::vector<int>		order;
+	Frames					frames(e);
+	Client					a(e, 1, order), b(e, 2, order), c(e, 3, order);
+	a.setUpdateInterval(3);
+	b.setUpdateInterval(3);
+	c.setUpdateInterval(3);
+	frames.run(30);
+	BOOST_TEST_EQ(a.mRuns, 10);
+	BOOST_TEST_EQ(b.mRuns, 10);
+	BOOST_TEST_EQ(c.mRuns, 10);
+
+	// Each runs once in any three frames in a row
+	for (int i = 0; i < 3; ++i) {
+		order.clear();
+		frames.run(3);
+		BOOST_TEST_EQ(std::count(order.begin(), order.end(), 1), 1);
+		BOOST_TEST_EQ(std::count(order.begin(), order.end(), 2), 1);
+		BOOST_TEST_EQ(std::count(order.begin(), order.end(), 3), 1);
+	}
+	// And see the time since they last ran
+	BOOST_TEST(std::abs(a.mLastDelta - FRAME_TIME * 3.0f) < 0.001f);
+
+	a.setUpdateInterval(1);
+	a.mRuns = 0;
+	frames.run(5);
+	BOOST_TEST_EQ(a.mRuns, 5);
+}
+
+void testRate(ds::ui::SpriteEngine& e) {
+	std::vector<int>		order;
+	Frames					frames(e);
+	Client					a(e, 1, order);
+	a.setUpdateRate(10.0f);
+	frames.run(120);
+	// Two seconds at 10 a second, give or take the first phase
+	BOOST_TEST(a.mRuns >= 19 && a.mRuns <= 21);
+	BOOST_TEST(std::abs(a.mLastDelta - 0.1f) < FRAME_TIME + 0.001f);
+
+	// Faster than the frame rate runs once a frame, without catching up
+	Client					b(e, 2, order);
+	b.setUpdateRate(1000.0f);
+	frames.run(10);
+	BOOST_TEST(b.mRuns >= 9 && b.mRuns <= 10);
+
+	a.setUpdateRate(0.0f);
+	a.mRuns = 0;
+	frames.run(10);
+	BOOST_TEST_EQ(a.mRuns, 10);
+}
+
+void testGroups(ds::ui::SpriteEngine& e) {
+	std::vector<int>		order;
+	Frames					frames(e);
+	Client					a(e, 1, order), b(e, 2, order), c(e, 3, order), d(e, 4, order);
+	a.setUpdateGroup(1);
+	c.setUpdateGroup(-1);
+	frames.run();
+	const std::vector<int>	expected = { 3, 2, 4, 1 };
+	BOOST_TEST(order == expected);
+
+	// Changing a group takes effect on the next update
+	order.clear();
+	a.setUpdateGroup(-2);
+	frames.run();
+	BOOST_TEST(!order.empty() && order.front() == 1);
+}
+
+void testRemoveDuringUpdate(ds::ui::SpriteEngine& e) {
+	std::vector<int>		order;
+	Frames					frames(e);
+	std::unique_ptr<Client>	a(new Client(e, 1, order)), b(new Client(e, 2, order)), c(new Client(e, 3, order));
+	frames.run();
+
+	// A client removed by an earlier one doesn't run
+	a->mOnUpdate = [&b]() { b.reset(); };
+	order.clear();
+	frames.run();
+	BOOST_TEST(!b);
+	BOOST_TEST(contains(order, 1));
+	BOOST_TEST(!contains(order, 2));
+	BOOST_TEST(contains(order, 3));
+
+	// Nor does one that removes itself, after that
+	c->mOnUpdate = [&c]() { c.reset(); };
+	frames.run();
+	BOOST_TEST(!c);
+	order.clear();
+	frames.run();
+	BOOST_TEST(!contains(order, 3));
+	BOOST_TEST(contains(order, 1));
+
+	// One added during an update starts on the next one
+	std::unique_ptr<Client>	added;
+	a->mOnUpdate = [&]() { if (!added) added.reset(new Client(e, 4, order)); };
+	order.clear();
+	frames.run();
+	BOOST_TEST(added);
+	BOOST_TEST(!contains(order, 4));
+	a->mOnUpdate = nullptr;
+	order.clear();
+	frames.run();
+	BOOST_TEST(contains(order, 4));
+}
+
+}
+
+void testAutoUpdateList(ds::ui::SpriteEngine& e) {
+	testEveryFrame(e);
+	testInterval(e);
+	testRate(e);
+	testGroups(e);
+	testRemoveDuringUpdate(e);
+}
+
+} // namespace unit_tests
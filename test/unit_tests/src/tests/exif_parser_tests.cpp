@@ -0,0 +1,265 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+#include "tests/test_bytes.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ds/util/exif_parser.h>
+
+namespace unit_tests {
+
+namespace {
+
+typedef ds::ExifParser		Exif;
+
+/// A camera-ish TIFF block: an image table pointing at EXIF and GPS tables
+Bytes tiff(const bool littleEndian) {
+	TiffWriter				w(littleEndian);
+
+	std::vector<TiffWriter::Field>	exif = {
+		w.rationals(Exif::TAG_EXPOSURE_TIME, { { 1, 250 } }),
+		w.rationals(Exif::TAG_F_NUMBER, { { 28, 10 } }),
+		w.shortField(Exif::TAG_ISO_SPEED, 400),
+		w.longField(Exif::TAG_PIXEL_WIDTH, 4000),
+		w.shortField(Exif::TAG_PIXEL_HEIGHT, 3000),
+	};
+	std::vector<TiffWriter::Field>	gps = {
+		w.ascii(Exif::TAG_GPS_LATITUDE_REF, "S"),
+		w.rationals(Exif::TAG_GPS_LATITUDE, { { 10, 1 }, { 30, 1 }, { 0, 1 } }),
+		w.ascii(Exif::TAG_GPS_LONGITUDE_REF, "E"),
+		w.rationals(Exif::TAG_GPS_LONGITUDE, { { 20, 1 }, { 15, 1 }, { 36, 1 } }),
+	};
+	std::vector<TiffWriter::Field>	image = {
+		w.longField(Exif::TAG_IMAGE_WIDTH, 640),
+		w.shortField(Exif::TAG_IMAGE_HEIGHT, 480),
+		w.ascii(Exif::TAG_MAKE, "Downstream"),
+		w.ascii(Exif::TAG_MODEL, "X"),
+		w.shortField(Exif::TAG_ORIENTATION, 6),
+		w.longField(Exif::TAG_EXIF_IFD, 0),
+		w.longField(Exif::TAG_GPS_IFD, 0),
+	};
+	// The tables go one after another, so the pointers are known before anything's written
+	const size_t			exifAt = 8 + TiffWriter::ifdSize(image);
+	const size_t			gpsAt = exifAt + TiffWriter::ifdSize(exif);
+	image[5].mValue = w.u32(static_cast<uint32_t>(exifAt));
+	image[6].mValue = w.u32(static_cast<uint32_t>(gpsAt));
+
+	Bytes					b;
+	w.writeHeader(b);
+	w.writeIfd(b, image);
+	w.writeIfd(b, exif);
+	w.writeIfd(b, gps);
+	return b;
+}
+
+/// The same block as a jpeg's APP1 segment, after a JFIF segment and some fill bytes
+Bytes jpeg(const Bytes& tiffBlock) {
+	Bytes					b = { 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10 };
+	const char				jfif[] = "JFIF\0\x01\x01\0\0\x01\0\x01\0\0";
+	b.insert(b.end(), jfif, jfif + 14);
+
+	const size_t			length = tiffBlock.size() + 8;
+	b.insert(b.end(), { 0xFF, 0xFF, 0xE1, static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length) });
+	b.insert(b.end(), { 'E', 'x', 'i', 'f', 0, 0 });
+	b.insert(b.end(), tiffBlock.begin(), tiffBlock.end());
+	b.insert(b.end(), { 0xFF, 0xDA, 0x00, 0x02, 0xFF, 0xD9 });
+	return b;
+}
+
+bool open(Exif& p, const Bytes& b) {
+	return p.open(b.empty() ? nullptr : b.data(), b.size());
+}
+
+void checkTags(const Exif& p) {
+	BOOST_TEST_EQ(p.getTagCount(), 16u);
+	BOOST_TEST_EQ(p.getText(Exif::IFD_IMAGE, Exif::TAG_MAKE), "Downstream");
+	BOOST_TEST_EQ(p.getOrientation(), 6);
+	BOOST_TEST_EQ(p.getText(Exif::IFD_EXIF, Exif::TAG_EXPOSURE_TIME), "0.004");
+	BOOST_TEST_EQ(p.getText(Exif::IFD_EXIF, Exif::TAG_ISO_SPEED), "400");
+	BOOST_TEST_EQ(p.getText(Exif::IFD_GPS, Exif::TAG_GPS_LATITUDE), "10 30 0");
+	BOOST_TEST_EQ(p.getText(Exif::IFD_IMAGE, Exif::TAG_COPYRIGHT), "");
+
+	int64_t					iso = 0;
+	BOOST_TEST(p.getInt(Exif::IFD_EXIF, Exif::TAG_ISO_SPEED, iso));
+	BOOST_TEST_EQ(iso, 400);
+	// Not a whole number, and not a second value
+	BOOST_TEST(!p.getInt(Exif::IFD_EXIF, Exif::TAG_F_NUMBER, iso));
+	BOOST_TEST(!p.getInt(Exif::IFD_EXIF, Exif::TAG_ISO_SPEED, iso, 1));
+
+	double					fNumber = 0.0;
+	BOOST_TEST(p.getDouble(Exif::IFD_EXIF, Exif::TAG_F_NUMBER, fNumber));
+	BOOST_TEST(std::abs(fNumber - 2.8) < 0.0001);
+
+	// The EXIF table's size comes before the image table's
+	int						width = 0, height = 0;
+	BOOST_TEST(p.getImageSize(width, height));
+	BOOST_TEST_EQ(width, 4000);
+	BOOST_TEST_EQ(height, 3000);
+
+	double					latitude = 0.0, longitude = 0.0;
+	BOOST_TEST(p.getLatitude(latitude));
+	BOOST_TEST(p.getLongitude(longitude));
+	BOOST_TEST(std::abs(latitude + 10.5) < 0.0001);
+	BOOST_TEST(std::abs(longitude - 20.26) < 0.0001);
+
+	// Same tag number, different table
+	BOOST_TEST(p.hasTag(Exif::IFD_GPS, Exif::TAG_GPS_LATITUDE));
+	BOOST_TEST(!p.hasTag(Exif::IFD_IMAGE, Exif::TAG_GPS_LATITUDE));
+}
+
+void testValid() {
+	for (const bool littleEndian : { true, false }) {
+		const Bytes			block = tiff(littleEndian);
+		Exif				p;
+		BOOST_TEST(open(p, block));
+		checkTags(p);
+
+		// The parser reads from the data it was given, so it has to outlive the checks
+		const Bytes			wrapped = jpeg(block);
+		BOOST_TEST(open(p, wrapped));
+		checkTags(p);
+
+		Bytes				exifBlock = { 'E', 'x', 'i', 'f', 0, 0 };
+		exifBlock.insert(exifBlock.end(), block.begin(), block.end());
+		BOOST_TEST(open(p, exifBlock));
+		checkTags(p);
+
+		p.close();
+		BOOST_TEST(!p.isOpen());
+		BOOST_TEST_EQ(p.getTagCount(), 0u);
+		BOOST_TEST_EQ(p.getOrientation(), 1);
+	}
+}
+
+void testMalformed() {
+	Exif					p;
+	BOOST_TEST(!p.open(nullptr, 100));
+	BOOST_TEST(!open(p, Bytes()));
+	BOOST_TEST(!open(p, Bytes(100, 0)));
+	BOOST_TEST(!open(p, Bytes(100, 0xFF)));
+
+	// A jpeg without EXIF, and one whose segment runs past the end
+	BOOST_TEST(!open(p, Bytes({ 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 0x00, 0x00, 0xFF, 0xDA, 0x00, 0x02 })));
+	BOOST_TEST(!open(p, Bytes({ 0xFF, 0xD8, 0xFF, 0xE1, 0xFF, 0xFF, 'E', 'x', 'i', 'f', 0, 0 })));
+
+	// A failed open doesn't leave the last file's tags behind
+	BOOST_TEST(open(p, tiff(true)));
+	BOOST_TEST(!open(p, Bytes(16, 0)));
+	BOOST_TEST(!p.isOpen());
+	BOOST_TEST_EQ(p.getTagCount(), 0u);
+
+	TiffWriter				w(true);
+	Bytes					b = tiff(true);
+	// The image table pointing past the end opens, with nothing in it
+	Bytes					lost = b;
+	const Bytes				far = w.u32(0xFFFFFFF0u);
+	std::copy(far.begin(), far.end(), lost.begin() + 4);
+	BOOST_TEST(open(p, lost));
+	BOOST_TEST_EQ(p.getTagCount(), 0u);
+	int						width = 0, height = 0;
+	BOOST_TEST(!p.getImageSize(width, height));
+
+	// The EXIF table pointing back at the image table reads it as the EXIF table, once, without going round again
+	Bytes					loop = b;
+	const size_t			exifPointer = 8 + 2 + 5 * 12 + 8;
+	const Bytes				back = w.u32(8);
+	std::copy(back.begin(), back.end(), loop.begin() + exifPointer);
+	BOOST_TEST(open(p, loop));
+	BOOST_TEST_EQ(p.getTagCount(), 18u);
+
+	// A string whose count runs off the end is dropped, not read
+	Bytes					runaway = b;
+	const size_t			makeCount = 8 + 2 + 2 * 12 + 4;
+	const Bytes				huge = w.u32(0x7FFFFFFFu);
+	std::copy(huge.begin(), huge.end(), runaway.begin() + makeCount);
+	BOOST_TEST(open(p, runaway));
+	BOOST_TEST(!p.hasTag(Exif::IFD_IMAGE, Exif::TAG_MAKE));
+	BOOST_TEST_EQ(p.getText(Exif::IFD_IMAGE, Exif::TAG_MAKE), "");
+	BOOST_TEST_EQ(p.getOrientation(), 6);
+}
+
+/// Any getter on any tag, so a bad entry that got indexed gets read
+void readEverything(const Exif& p) {
+	for (const Exif::Ifd ifd : { Exif::IFD_IMAGE, Exif::IFD_EXIF, Exif::IFD_GPS }) {
+		for (unsigned tag = 0; tag < 0x10000; tag += (tag < 0x120 ? 1 : 97)) {
+			const uint16_t	t = static_cast<uint16_t>(tag);
+			std::string		s;
+			int64_t			i = 0;
+			double			d = 0.0;
+			p.getString(ifd, t, s);
+			p.getInt(ifd, t, i, 2);
+			p.getDouble(ifd, t, d, 1);
+			p.getText(ifd, t);
+		}
+	}
+	int						width = 0, height = 0;
+	double					degrees = 0.0;
+	if (p.getImageSize(width, height)) BOOST_TEST(width > 0 && height > 0);
+	p.getLatitude(degrees);
+	p.getLongitude(degrees);
+	const int				orientation = p.getOrientation();
+	BOOST_TEST(orientation >= 1 && orientation <= 8);
+}
+
+/// Every cut short copy opens or not without reading past the end, and keeps only tags that fit
+void testTruncated() {
+	const Bytes				b = jpeg(tiff(false));
+	for (size_t size = 0; size < b.size(); ++size) {
+		// An exact size copy, so reading past the end lands outside it
+		const Bytes			cut(b.begin(), b.begin() + size);
+		Exif				p;
+		if (open(p, cut)) readEverything(p);
+	}
+
+	const Bytes				block = tiff(true);
+	for (size_t size = 0; size < block.size(); ++size) {
+		const Bytes			cut(block.begin(), block.begin() + size);
+		Exif				p;
+		if (!open(p, cut)) continue;
+		BOOST_TEST(p.getTagCount() <= 16u);
+		readEverything(p);
+	}
+}
+
+/// Random changes to the valid blocks, seeded so a failure happens the same way every run
+void testFuzzed() {
+	SeededRandom			random(54321);
+
+	const Bytes				seeds[] = { tiff(true), tiff(false), jpeg(tiff(true)) };
+	TiffWriter				w(true);
+	for (int i = 0; i < 3000; ++i) {
+		Bytes				b = seeds[i % 3];
+		const uint32_t		changes = 1 + random.next() % 6;
+		for (uint32_t c = 0; c < changes && !b.empty(); ++c) {
+			const size_t	at = random.next() % b.size();
+			switch (random.next() % 4) {
+			case 0: b[at] = static_cast<unsigned char>(random.next()); break;
+			// Offsets and counts that are just past, or far past, the end
+			case 1: {
+				const Bytes	v = w.u32(random.next() % 2 ? static_cast<uint32_t>(b.size() - random.next() % 8) : 0xFFFFFFFFu - random.next() % 16);
+				for (size_t k = 0; k < v.size() && at + k < b.size(); ++k) b[at + k] = v[k];
+				break;
+			}
+			case 2: b.resize(at); break;
+			default: b[at] = 0xFF; break;
+			}
+		}
+
+		Exif				p;
+		if (open(p, b)) readEverything(p);
+	}
+}
+
+}
+
+void testExifParser() {
+	testValid();
+	testMalformed();
+	testTruncated();
+	testFuzzed();
+}
+
+} // namespace unit_tests
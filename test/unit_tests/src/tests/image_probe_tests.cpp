@@ -0,0 +1,218 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+#include "tests/test_bytes.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ds/util/image_probe.h>
+
+namespace unit_tests {
+
+namespace {
+
+struct Header {
+	Bytes					mBytes;
+	ds::ImageProbe::Format	mFormat;
+	int						mWidth;
+	int						mHeight;
+	int						mOrientation;
+};
+
+/// A TIFF header and one IFD with the width, height and orientation
+Bytes tiff(const bool littleEndian, const int width, const int height, const int orientation) {
+	const TiffWriter		w(littleEndian);
+	Bytes					b;
+	w.writeHeader(b);
+	w.writeIfd(b, { w.longField(256, width), w.shortField(257, height), w.shortField(274, orientation) });
+	return b;
+}
+
+Bytes jpeg(const int width, const int height, const int orientation) {
+	Bytes					b = { 0xFF, 0xD8 };
+	// JFIF
+	b.insert(b.end(), { 0xFF, 0xE0 });
+	put_16(b, 16, false);
+	put(b, std::string("JFIF\0", 5));
+	b.insert(b.end(), { 1, 1, 0, 0, 1, 0, 1, 0, 0 });
+	// EXIF, after some fill bytes
+	const Bytes				exif = tiff(false, 0, 0, orientation);
+	b.insert(b.end(), { 0xFF, 0xFF, 0xE1 });
+	put_16(b, static_cast<unsigned>(exif.size() + 8), false);
+	put(b, std::string("Exif\0\0", 6));
+	b.insert(b.end(), exif.begin(), exif.end());
+	// SOF2
+	b.insert(b.end(), { 0xFF, 0xC2 });
+	put_16(b, 17, false);
+	b.push_back(8);
+	put_16(b, height, false);
+	put_16(b, width, false);
+	b.insert(b.end(), { 3, 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1 });
+	b.insert(b.end(), { 0xFF, 0xD9 });
+	return b;
+}
+
+Bytes png(const uint32_t width, const uint32_t height) {
+	Bytes					b;
+	put(b, "\x89PNG\r\n\x1a\n");
+	put_32(b, 13, false);
+	put(b, "IHDR");
+	put_32(b, width, false);
+	put_32(b, height, false);
+	b.insert(b.end(), { 8, 6, 0, 0, 0 });
+	return b;
+}
+
+Bytes gif(const int width, const int height) {
+	Bytes					b;
+	put(b, "GIF89a");
+	put_16(b, width, true);
+	put_16(b, height, true);
+	b.insert(b.end(), { 0, 0, 0 });
+	return b;
+}
+
+Bytes bmp(const int32_t width, const int32_t height) {
+	Bytes					b;
+	put(b, "BM");
+	put_32(b, 0, true);
+	put_32(b, 0, true);
+	put_32(b, 54, true);
+	put_32(b, 40, true);
+	put_32(b, static_cast<uint32_t>(width), true);
+	put_32(b, static_cast<uint32_t>(height), true);
+	put_16(b, 1, true);
+	put_16(b, 24, true);
+	b.resize(54, 0);
+	return b;
+}
+
+/// Extended (VP8X) webp, which stores 24 bit sizes
+Bytes webp(const int width, const int height) {
+	Bytes					b;
+	put(b, "RIFF");
+	put_32(b, 22, true);
+	put(b, "WEBPVP8X");
+	put_32(b, 10, true);
+	put_32(b, 0, true);
+	b.insert(b.end(), { static_cast<unsigned char>(width - 1), static_cast<unsigned char>((width - 1) >> 8), static_cast<unsigned char>((width - 1) >> 16) });
+	b.insert(b.end(), { static_cast<unsigned char>(height - 1), static_cast<unsigned char>((height - 1) >> 8), static_cast<unsigned char>((height - 1) >> 16) });
+	return b;
+}
+
+std::vector<Header> headers() {
+	return {
+		{ jpeg(640, 480, 6), ds::ImageProbe::FORMAT_JPEG, 640, 480, 6 },
+		{ png(1920, 1080), ds::ImageProbe::FORMAT_PNG, 1920, 1080, 1 },
+		{ gif(300, 200), ds::ImageProbe::FORMAT_GIF, 300, 200, 1 },
+		{ bmp(64, 32), ds::ImageProbe::FORMAT_BMP, 64, 32, 1 },
+		{ bmp(64, -32), ds::ImageProbe::FORMAT_BMP, 64, 32, 1 },
+		{ webp(70000, 3), ds::ImageProbe::FORMAT_WEBP, 70000, 3, 1 },
+		{ tiff(true, 100, 50, 8), ds::ImageProbe::FORMAT_TIFF, 100, 50, 8 },
+		{ tiff(false, 100, 50, 3), ds::ImageProbe::FORMAT_TIFF, 100, 50, 3 },
+	};
+}
+
+bool probe(ds::ImageProbe& p, const Bytes& b) {
+	return p.probe(b.empty() ? reinterpret_cast<const unsigned char*>("") : b.data(), b.size());
+}
+
+void testValid() {
+	for (auto& h : headers()) {
+		ds::ImageProbe		p;
+		BOOST_TEST(probe(p, h.mBytes));
+		BOOST_TEST_EQ(p.mFormat, h.mFormat);
+		BOOST_TEST_EQ(p.mWidth, h.mWidth);
+		BOOST_TEST_EQ(p.mHeight, h.mHeight);
+		BOOST_TEST_EQ(p.mOrientation, h.mOrientation);
+	}
+
+	ds::ImageProbe			p;
+	probe(p, jpeg(640, 480, 6));
+	BOOST_TEST(p.isTransposed());
+}
+
+void testMalformed() {
+	ds::ImageProbe			p;
+	BOOST_TEST(!p.probe(nullptr, 16));
+	BOOST_TEST(!probe(p, Bytes()));
+	BOOST_TEST_EQ(p.mFormat, ds::ImageProbe::FORMAT_UNKNOWN);
+	BOOST_TEST(!probe(p, Bytes(64, 0)));
+	BOOST_TEST(!probe(p, Bytes(64, 0xFF)));
+
+	// Sizes that can't be real
+	BOOST_TEST(!probe(p, png(0, 10)));
+	BOOST_TEST(!probe(p, png(0x80000000u, 10)));
+	BOOST_TEST(!probe(p, png(1 << 21, 10)));
+	BOOST_TEST(!probe(p, bmp(-5, 10)));
+	BOOST_TEST(!probe(p, bmp(5, INT32_MIN)));
+	BOOST_TEST(!probe(p, gif(0, 0)));
+
+	// A jpeg with no frame header before the image data
+	Bytes					noFrame = { 0xFF, 0xD8, 0xFF, 0xDA, 0x00, 0x02, 0xFF, 0xD9 };
+	BOOST_TEST(!probe(p, noFrame));
+	BOOST_TEST_EQ(p.mFormat, ds::ImageProbe::FORMAT_JPEG);
+
+	// A segment length that points way past the end
+	Bytes					runaway = { 0xFF, 0xD8, 0xFF, 0xE0, 0xFF, 0xFF };
+	BOOST_TEST(!probe(p, runaway));
+
+	// A tiff whose IFD loops back on itself, or is past the end
+	Bytes					loop = tiff(true, 100, 50, 1);
+	loop[4] = 0xFF;
+	loop[5] = 0xFF;
+	BOOST_TEST(!probe(p, loop));
+}
+
+/// Every cut short copy either fails, or only finds what the whole header has
+void testTruncated() {
+	for (auto& h : headers()) {
+		for (size_t size = 0; size < h.mBytes.size(); ++size) {
+			ds::ImageProbe	p;
+			const Bytes		cut(h.mBytes.begin(), h.mBytes.begin() + size);
+			if (probe(p, cut)) {
+				BOOST_TEST_EQ(p.mWidth, h.mWidth);
+				BOOST_TEST_EQ(p.mHeight, h.mHeight);
+			} else {
+				BOOST_TEST(p.mFormat == ds::ImageProbe::FORMAT_UNKNOWN || p.mFormat == h.mFormat);
+			}
+		}
+	}
+}
+
+/// Random bytes written over the valid headers never read out of bounds or find impossible sizes.
+/// Seeded, so a failure happens the same way every run.
+void testFuzzed() {
+	SeededRandom			random(12345);
+
+	for (auto& h : headers()) {
+		for (int i = 0; i < 2000; ++i) {
+			Bytes			b = h.mBytes;
+			const uint32_t	changes = 1 + random.next() % 4;
+			for (uint32_t c = 0; c < changes; ++c) {
+				b[random.next() % b.size()] = static_cast<unsigned char>(random.next());
+			}
+			if (random.next() % 4 == 0) b.resize(random.next() % b.size());
+
+			ds::ImageProbe	p;
+			if (probe(p, b)) {
+				BOOST_TEST(p.mFormat != ds::ImageProbe::FORMAT_UNKNOWN);
+				BOOST_TEST(p.mWidth > 0 && p.mWidth <= (1 << 20));
+				BOOST_TEST(p.mHeight > 0 && p.mHeight <= (1 << 20));
+				BOOST_TEST(p.mOrientation >= 1 && p.mOrientation <= 8);
+			}
+		}
+	}
+}
+
+}
+
+void testImageProbe() {
+	testValid();
+	testMalformed();
+	testTruncated();
+	testFuzzed();
+}
+
+} // namespace unit_tests
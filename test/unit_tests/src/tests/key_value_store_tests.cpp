@@ -0,0 +1,108 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <stdexcept>
+#include <ds/data/key_value_store.h>
+
+namespace unit_tests {
+
+namespace {
+
+void testMissing() {
+	const ds::KeyValueStore		store;
+	BOOST_TEST(store.empty());
+	BOOST_TEST_EQ(store.getInt("kvs_missing"), 0);
+	BOOST_TEST_EQ(store.getInt("kvs_missing", 0, 5), 5);
+	BOOST_TEST_EQ(store.getString("kvs_missing"), "");
+	BOOST_TEST_EQ(store.getString("kvs_missing", 0, "default"), "default");
+	BOOST_TEST_EQ(store.getFloat("kvs_missing", 0, 2.5f), 2.5f);
+	BOOST_TEST_THROWS(store.getFloat("kvs_missing"), std::invalid_argument);
+	BOOST_TEST_THROWS(store.getColorA("kvs_missing"), std::invalid_argument);
+
+	float						f = 1.0f;
+	BOOST_TEST(!store.tryGetFloat("kvs_missing", f));
+	BOOST_TEST_EQ(f, 1.0f);
+}
+
+void testNotFound() {
+	// A stored 0 or empty string reads as notFound, tryGet tells them apart
+	ds::KeyValueStore			store;
+	store.setInt("kvs_int", 0);
+	BOOST_TEST_EQ(store.getInt("kvs_int", 0, 5), 5);
+	std::int32_t				i = -1;
+	BOOST_TEST(store.tryGetInt("kvs_int", i));
+	BOOST_TEST_EQ(i, 0);
+
+	store.setString("kvs_string", "");
+	BOOST_TEST_EQ(store.getString("kvs_string", 0, "default"), "default");
+	std::string					s = "x";
+	BOOST_TEST(store.tryGetString("kvs_string", s));
+	BOOST_TEST(s.empty());
+
+	store.setInt("kvs_int", 7);
+	BOOST_TEST_EQ(store.getInt("kvs_int", 0, 5), 7);
+	store.setString("kvs_string", "hi");
+	BOOST_TEST_EQ(store.getString("kvs_string", 0, "default"), "hi");
+}
+
+void testTypes() {
+	// One key holds a value of each type at once
+	ds::KeyValueStore			store;
+	store.setInt("kvs_shared", 3);
+	store.setFloat("kvs_shared", 1.5f);
+	store.setString("kvs_shared", "three");
+	store.setColorA("kvs_shared", ci::ColorA(1.0f, 0.5f, 0.25f, 1.0f));
+	BOOST_TEST(!store.empty());
+	BOOST_TEST_EQ(store.getInt("kvs_shared"), 3);
+	BOOST_TEST_EQ(store.getFloat("kvs_shared"), 1.5f);
+	BOOST_TEST_EQ(store.getString("kvs_shared"), "three");
+	BOOST_TEST(store.getColorA("kvs_shared") == ci::ColorA(1.0f, 0.5f, 0.25f, 1.0f));
+
+	// Setting again replaces the value of that type only
+	store.setInt("kvs_shared", 4);
+	BOOST_TEST_EQ(store.getInt("kvs_shared"), 4);
+	BOOST_TEST_EQ(store.getString("kvs_shared"), "three");
+}
+
+void testKeyIds() {
+	const ds::KeyValueStore::KeyId	id = ds::KeyValueStore::getKeyId("kvs_id");
+	BOOST_TEST(id != 0);
+	BOOST_TEST_EQ(ds::KeyValueStore::getKeyId("kvs_id"), id);
+	BOOST_TEST(ds::KeyValueStore::getKeyId("kvs_other_id") != id);
+
+	ds::KeyValueStore			store;
+	store.setString("kvs_id", "by id");
+	std::string					s;
+	BOOST_TEST(store.tryGetString(id, s));
+	BOOST_TEST_EQ(s, "by id");
+	std::int32_t				i = 0;
+	BOOST_TEST(!store.tryGetInt(id, i));
+}
+
+void testCopy() {
+	ds::KeyValueStore			store;
+	store.setInt("kvs_copy", 1);
+	ds::KeyValueStore			copy(store);
+	copy.setInt("kvs_copy", 2);
+	BOOST_TEST_EQ(store.getInt("kvs_copy"), 1);
+	BOOST_TEST_EQ(copy.getInt("kvs_copy"), 2);
+
+	ds::KeyValueStore			assigned;
+	assigned = copy;
+	BOOST_TEST_EQ(assigned.getInt("kvs_copy"), 2);
+	assigned = ds::KeyValueStore();
+	BOOST_TEST(assigned.empty());
+}
+
+}
+
+void testKeyValueStore() {
+	testMissing();
+	testNotFound();
+	testTypes();
+	testKeyIds();
+	testCopy();
+}
+
+} // namespace unit_tests
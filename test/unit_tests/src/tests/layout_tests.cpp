@@ -0,0 +1,214 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <ds/app/engine/engine.h>
+#include <ds/ui/layout/layout_sprite.h>
+#include <ds/ui/sprite/sprite.h>
+
+namespace unit_tests {
+
+namespace {
+
+typedef ds::ui::LayoutSprite	Layout;
+
+/// Counts the layouts that actually run, as opposed to the callback, which skipped layouts still call
+class CountingLayout : public Layout {
+public:
+	CountingLayout(ds::ui::SpriteEngine& e)
+			: Layout(e)
+			, mRuns(0)
+			, mCallbacks(0) {
+		setLayoutUpdatedFunction([this]() { ++mCallbacks; });
+	}
+
+	int						mRuns;
+	int						mCallbacks;
+
+protected:
+	virtual void			runFlowLayout(const bool vertical, const bool wrap) override {
+		++mRuns;
+		Layout::runFlowLayout(vertical, wrap);
+	}
+};
+
+ds::ui::Sprite* addBox(ds::ui::Sprite& parent, const float w, const float h, const int sizeType = Layout::kFixedSize) {
+	ds::ui::Sprite*		sp = new ds::ui::Sprite(parent.getEngine(), w, h);
+	sp->mLayoutUserType = sizeType;
+	parent.addChildPtr(sp);
+	return sp;
+}
+
+void checkBox(const ds::ui::Sprite& sp, const float x, const float y, const float w, const float h) {
+	BOOST_TEST_EQ(sp.getPosition().x, x);
+	BOOST_TEST_EQ(sp.getPosition().y, y);
+	BOOST_TEST_EQ(sp.getWidth(), w);
+	BOOST_TEST_EQ(sp.getHeight(), h);
+}
+
+void testVFlow(ds::ui::SpriteEngine& e) {
+	Layout				layout(e);
+	layout.setSize(200.0f, 0.0f);
+	layout.setLayoutType(Layout::kLayoutVFlow);
+	layout.setShrinkToChildren(Layout::kShrinkHeight);
+	layout.setSpacing(10.0f);
+
+	auto				fixed = addBox(layout, 50.0f, 20.0f);
+	fixed->mLayoutTPad = 5.0f;
+	fixed->mLayoutBPad = 5.0f;
+	fixed->mLayoutLPad = 3.0f;
+	auto				flex = addBox(layout, 10.0f, 30.0f, Layout::kFlexSize);
+	auto				right = addBox(layout, 40.0f, 10.0f);
+	right->mLayoutHAlign = Layout::kRight;
+	right->mLayoutRPad = 4.0f;
+
+	layout.runLayout();
+	checkBox(layout, 0.0f, 0.0f, 200.0f, 90.0f);
+	checkBox(*fixed, 3.0f, 5.0f, 50.0f, 20.0f);
+	checkBox(*flex, 0.0f, 40.0f, 200.0f, 30.0f);
+	checkBox(*right, 156.0f, 80.0f, 40.0f, 10.0f);
+}
+
+void testHFlow(ds::ui::SpriteEngine& e) {
+	Layout				layout(e);
+	layout.setSize(300.0f, 50.0f);
+	layout.setLayoutType(Layout::kLayoutHFlow);
+
+	auto				middle = addBox(layout, 100.0f, 20.0f);
+	middle->mLayoutVAlign = Layout::kMiddle;
+	auto				stretch = addBox(layout, 0.0f, 0.0f, Layout::kStretchSize);
+	auto				padded = addBox(layout, 0.0f, 0.0f, Layout::kStretchSize);
+	padded->mLayoutLPad = 10.0f;
+
+	// Stretches split what's left evenly, padding included
+	layout.runLayout();
+	checkBox(layout, 0.0f, 0.0f, 300.0f, 50.0f);
+	checkBox(*middle, 0.0f, 15.0f, 100.0f, 20.0f);
+	checkBox(*stretch, 100.0f, 0.0f, 100.0f, 50.0f);
+	checkBox(*padded, 210.0f, 0.0f, 90.0f, 50.0f);
+}
+
+void testAlignAndFill(ds::ui::SpriteEngine& e) {
+	Layout				centered(e);
+	centered.setSize(100.0f, 100.0f);
+	centered.setOverallAlignment(Layout::kMiddle);
+	auto				box = addBox(centered, 20.0f, 20.0f);
+	centered.runLayout();
+	checkBox(*box, 0.0f, 40.0f, 20.0f, 20.0f);
+
+	// Fills are left out of the flow, then sized to the whole layout
+	Layout				filled(e);
+	filled.setSize(100.0f, 0.0f);
+	filled.setShrinkToChildren(Layout::kShrinkHeight);
+	auto				fill = addBox(filled, 0.0f, 0.0f, Layout::kFillSize);
+	fill->mLayoutTPad = fill->mLayoutBPad = fill->mLayoutLPad = fill->mLayoutRPad = 2.0f;
+	auto				content = addBox(filled, 50.0f, 40.0f);
+	filled.runLayout();
+	checkBox(filled, 0.0f, 0.0f, 100.0f, 40.0f);
+	checkBox(*fill, 2.0f, 2.0f, 96.0f, 36.0f);
+	checkBox(*content, 0.0f, 0.0f, 50.0f, 40.0f);
+}
+
+void testSizeAndWrap(ds::ui::SpriteEngine& e) {
+	// Size layouts only size, and leave positions alone
+	Layout				sized(e);
+	sized.setSize(120.0f, 80.0f);
+	sized.setLayoutType(Layout::kLayoutSize);
+	auto				stretch = addBox(sized, 0.0f, 0.0f, Layout::kStretchSize);
+	stretch->mLayoutLPad = 10.0f;
+	stretch->setPosition(5.0f, 5.0f);
+	sized.runLayout();
+	checkBox(*stretch, 5.0f, 5.0f, 110.0f, 80.0f);
+
+	Layout				wrapped(e);
+	wrapped.setSize(100.0f, 10.0f);
+	wrapped.setLayoutType(Layout::kLayoutHWrap);
+	auto				a = addBox(wrapped, 40.0f, 10.0f);
+	auto				b = addBox(wrapped, 40.0f, 10.0f);
+	auto				c = addBox(wrapped, 40.0f, 10.0f);
+	wrapped.runLayout();
+	checkBox(*a, 0.0f, 0.0f, 40.0f, 10.0f);
+	checkBox(*b, 40.0f, 0.0f, 40.0f, 10.0f);
+	checkBox(*c, 0.0f, 10.0f, 40.0f, 10.0f);
+	checkBox(wrapped, 0.0f, 0.0f, 100.0f, 20.0f);
+}
+
+void testSkipping(ds::ui::SpriteEngine& e) {
+	CountingLayout		outer(e);
+	outer.setSize(200.0f, 200.0f);
+	CountingLayout*		middle = new CountingLayout(e);
+	middle->setShrinkToChildren(Layout::kShrinkBoth);
+	outer.addChildPtr(middle);
+	CountingLayout*		inner = new CountingLayout(e);
+	inner->setShrinkToChildren(Layout::kShrinkBoth);
+	middle->addChildPtr(inner);
+	auto				box = addBox(*inner, 30.0f, 30.0f);
+
+	outer.runLayout();
+	BOOST_TEST_EQ(middle->mRuns, 1);
+	BOOST_TEST_EQ(inner->mRuns, 1);
+	checkBox(*middle, 0.0f, 0.0f, 30.0f, 30.0f);
+
+	// Nothing changed: nested layouts are skipped, but still hear about the pass
+	outer.runLayout();
+	BOOST_TEST_EQ(outer.mRuns, 2);
+	BOOST_TEST_EQ(middle->mRuns, 1);
+	BOOST_TEST_EQ(inner->mRuns, 1);
+	BOOST_TEST_EQ(middle->mCallbacks, 2);
+	BOOST_TEST_EQ(inner->mCallbacks, 2);
+
+	// A change deep down runs everything above it
+	box->setSize(40.0f, 50.0f);
+	outer.runLayout();
+	BOOST_TEST_EQ(middle->mRuns, 2);
+	BOOST_TEST_EQ(inner->mRuns, 2);
+	checkBox(*middle, 0.0f, 0.0f, 40.0f, 50.0f);
+
+	// So does a setting
+	inner->setSpacing(5.0f);
+	outer.runLayout();
+	BOOST_TEST_EQ(inner->mRuns, 3);
+}
+
+void testInvalidate(ds::Engine& e) {
+	CountingLayout*		outer = new CountingLayout(e);
+	outer->setSize(200.0f, 200.0f);
+	CountingLayout*		inner = new CountingLayout(e);
+	outer->addChildPtr(inner);
+	addBox(*inner, 30.0f, 30.0f);
+	e.getRootSprite().addChildPtr(outer);
+	outer->runLayout();
+	BOOST_TEST_EQ(inner->mRuns, 1);
+
+	// Several invalidates run the layout once, on the next update, and only that layout
+	inner->invalidateLayout();
+	inner->invalidateLayout();
+	BOOST_TEST_EQ(inner->mRuns, 1);
+	e.update();
+	e.update();
+	BOOST_TEST_EQ(inner->mRuns, 2);
+	BOOST_TEST_EQ(outer->mRuns, 1);
+
+	// The layout it's in won't skip it next time
+	inner->invalidateLayout();
+	outer->runLayout();
+	BOOST_TEST_EQ(inner->mRuns, 3);
+	// Which covers the pending run, too
+	e.update();
+	BOOST_TEST_EQ(inner->mRuns, 3);
+
+	outer->release();
+}
+
+}
+
+void testLayouts(ds::Engine& e) {
+	testVFlow(e);
+	testHFlow(e);
+	testAlignAndFill(e);
+	testSizeAndWrap(e);
+	testSkipping(e);
+	testInvalidate(e);
+}
+
+} // namespace unit_tests
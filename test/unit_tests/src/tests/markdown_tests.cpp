@@ -0,0 +1,139 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <string>
+#include <vector>
+#include <ds/util/markdown_to_pango.h>
+
+namespace unit_tests {
+
+namespace {
+
+/// Matches the cache size markdown_to_pango() starts with
+const size_t			DEFAULT_CACHE_BYTES = 4 * 1024 * 1024;
+
+struct Golden {
+	const char*			mMarkdown;
+	const char*			mMarkup;
+};
+
+/// Output of the converter before the cache and incremental conversion went in
+const Golden			GOLDENS[] = {
+	{ "",
+		"" },
+	{ "Plain text.",
+		"Plain text.\n\n\n" },
+	{ "# Title\n\nSome *em* and **bold** text.",
+		"<span weight='heavy' size='xx-large'>Title</span>\n\nSome <span style='oblique'>em</span> and <span weight='bold'>bold</span> text.\n\n\n" },
+	{ "* one\n* two\n\n1. first\n2. second",
+		"\xe2\x80\xa2 one\n\xe2\x80\xa2 two\n\n1. first\n2. second\n\n\n" },
+	{ "`code` & <tag> ~~gone~~",
+		"<span font='Consolas'>code</span> &amp; &lt;tag&gt; <span strikethrough='true'>gone</span>\n\n\n" },
+	{ "> quoted\n\n    indented code",
+		"    <span font='Palatino Italic'> quoted</span>\n\n\t<span font='Consolas' >indented code\n</span>\n\n" },
+};
+
+const std::string		DOCUMENT =
+	"# Heading\n"
+	"\n"
+	"A paragraph with *emphasis*, **bold** and `code`.\n"
+	"It carries on & has <angles>.\n"
+	"\n"
+	"* first item\n"
+	"* second item\n"
+	"  * nested item\n"
+	"\n"
+	"1. one\n"
+	"2. two\n"
+	"\n"
+	"> a quote\n"
+	"\n"
+	"    indented code\n"
+	"\n"
+	"```\n"
+	"fenced code\n"
+	"```\n"
+	"\n"
+	"Last line";
+
+void testGoldens() {
+	for (auto& golden : GOLDENS) {
+		BOOST_TEST_EQ(ds::ui::markdown_to_pango(std::string(golden.mMarkdown)), golden.mMarkup);
+		// And again, from the cache
+		BOOST_TEST_EQ(ds::ui::markdown_to_pango(std::string(golden.mMarkdown)), golden.mMarkup);
+		ds::ui::MarkdownToPango		converter;
+		BOOST_TEST_EQ(converter.convert(golden.mMarkdown), golden.mMarkup);
+	}
+	BOOST_TEST(ds::ui::markdown_to_pango(std::wstring(L"Plain text.")) == L"Plain text.\n\n\n");
+}
+
+void testCache() {
+	ds::ui::set_markdown_to_pango_cache_size(0);
+	const std::string			uncached = ds::ui::markdown_to_pango(DOCUMENT);
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES);
+	BOOST_TEST_EQ(ds::ui::markdown_to_pango(DOCUMENT), uncached);
+	BOOST_TEST_EQ(ds::ui::markdown_to_pango(DOCUMENT), uncached);
+
+	// Too small to hold anything still converts
+	ds::ui::set_markdown_to_pango_cache_size(16);
+	BOOST_TEST_EQ(ds::ui::markdown_to_pango(DOCUMENT), uncached);
+	ds::ui::clear_markdown_to_pango_cache();
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES);
+	BOOST_TEST_EQ(ds::ui::markdown_to_pango(DOCUMENT), uncached);
+}
+
+/// Every step of an edit converts the same incrementally as it does from scratch
+void checkEdits(const std::vector<std::string>& steps) {
+	ds::ui::MarkdownToPango		converter;
+	for (auto& step : steps) {
+		BOOST_TEST_EQ(converter.convert(step), ds::ui::markdown_to_pango(step));
+	}
+}
+
+void testIncremental() {
+	ds::ui::set_markdown_to_pango_cache_size(0);
+
+	std::vector<std::string>	steps;
+	// Typing the document
+	for (size_t i = 0; i <= DOCUMENT.size(); ++i) steps.push_back(DOCUMENT.substr(0, i));
+	// Deleting it from the end
+	for (size_t i = DOCUMENT.size(); i > 0; --i) steps.push_back(DOCUMENT.substr(0, i - 1));
+	checkEdits(steps);
+
+	// Typing and deleting in the middle, which can join and split blocks
+	steps.clear();
+	std::string					doc = DOCUMENT;
+	for (size_t at = 0; at < DOCUMENT.size(); at += 7) {
+		for (const char c : std::string("\n* x\n\n")) {
+			doc.insert(at, 1, c);
+			steps.push_back(doc);
+		}
+		doc.erase(at, 6);
+		steps.push_back(doc);
+		doc.erase(at, 1);
+		steps.push_back(doc);
+		doc = DOCUMENT;
+		steps.push_back(doc);
+	}
+	checkEdits(steps);
+
+	// Starting over gives the same as a new converter
+	ds::ui::MarkdownToPango		converter;
+	converter.convert(DOCUMENT);
+	converter.clear();
+	BOOST_TEST_EQ(converter.convert("Plain text."), "Plain text.\n\n\n");
+
+	ds::ui::clear_markdown_to_pango_cache();
+	ds::ui::set_markdown_to_pango_cache_size(DEFAULT_CACHE_BYTES);
+}
+
+}
+
+void testMarkdown() {
+	testGoldens();
+	testCache();
+	testIncremental();
+}
+
+} // namespace unit_tests
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <ds/content/content_model.h>
+#include <ds/ui/layout/smart_layout.h>
+
+namespace unit_tests {
+
+namespace {
+
+/// Counts the times its own layout runs
+class CountingSmartLayout : public ds::ui::SmartLayout {
+public:
+	CountingSmartLayout(ds::ui::SpriteEngine& e)
+			: ds::ui::SmartLayout(e, "model_binding.xml")
+			, mRuns(0) {
+	}
+
+	int						mRuns;
+
+protected:
+	virtual void			runFlowLayout(const bool vertical, const bool wrap) override {
+		++mRuns;
+		ds::ui::SmartLayout::runFlowLayout(vertical, wrap);
+	}
+};
+
+ds::model::ContentModelRef makeModel(const std::string& boxSize, const std::string& detailSize, const std::string& badge) {
+	ds::model::ContentModelRef	model("item");
+	model.setProperty("box_size", boxSize);
+	model.setProperty("box_opacity", std::string("0.5"));
+	model.setProperty("badge", badge);
+	ds::model::ContentModelRef	details("details");
+	details.setProperty("detail_size", detailSize);
+	model.addChild(details);
+	return model;
+}
+
+}
+
+void testSmartLayout(ds::ui::SpriteEngine& e) {
+	CountingSmartLayout			layout(e);
+	int							callbacks = 0;
+	layout.setContentUpdatedCallback([&callbacks]() { ++callbacks; });
+
+	auto						root = layout.getSprite("root_layout");
+	auto						box = layout.getSprite("box");
+	auto						badge = layout.getSprite("badge");
+	auto						details = layout.getSprite("details");
+	BOOST_TEST(root && box && badge && details);
+	if (!root || !box || !badge || !details) return;
+
+	auto						model = makeModel("60, 30", "25, 15", "");
+	const int					runs = layout.mRuns;
+	layout.setContentModel(model);
+	BOOST_TEST_EQ(box->getWidth(), 60.0f);
+	BOOST_TEST_EQ(box->getHeight(), 30.0f);
+	BOOST_TEST_EQ(box->getOpacity(), 0.5f);
+	BOOST_TEST(!badge->visible());
+	BOOST_TEST_EQ(details->getWidth(), 25.0f);
+	// The nested layouts flow around the new sizes
+	BOOST_TEST_EQ(root->getHeight(), 55.0f);
+	BOOST_TEST_EQ(details->getPosition().y, 40.0f);
+	BOOST_TEST_EQ(layout.mRuns, runs + 1);
+	BOOST_TEST_EQ(callbacks, 1);
+
+	// Setting the same model again re-applies it over anything the app changed since, and runs the layout again
+	box->setSize(5.0f, 5.0f);
+	layout.setContentModel(model);
+	BOOST_TEST_EQ(box->getWidth(), 60.0f);
+	BOOST_TEST_EQ(box->getHeight(), 30.0f);
+	BOOST_TEST_EQ(root->getHeight(), 55.0f);
+	BOOST_TEST_EQ(layout.mRuns, runs + 2);
+	BOOST_TEST_EQ(callbacks, 2);
+
+	layout.setContentModel(model);
+	BOOST_TEST_EQ(layout.mRuns, runs + 3);
+	BOOST_TEST_EQ(callbacks, 3);
+
+	// A new model reflows from what changed
+	auto						other = makeModel("60, 30", "40, 20", "new");
+	layout.setContentModel(other);
+	BOOST_TEST(badge->visible());
+	BOOST_TEST_EQ(details->getWidth(), 40.0f);
+	BOOST_TEST_EQ(root->getHeight(), 60.0f);
+	BOOST_TEST_EQ(callbacks, 4);
+}
+
+} // namespace unit_tests
@@ -0,0 +1,173 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+
+#include <functional>
+#include <vector>
+#include <cinder/app/App.h>
+#include <ds/app/engine/engine.h>
+#include <ds/ui/sprite/sprite.h>
+#include <ds/ui/touch/touch_event.h>
+
+namespace unit_tests {
+
+namespace {
+
+/// Counts its server updates
+class Counter : public ds::ui::Sprite {
+public:
+	Counter(ds::ui::SpriteEngine& e, const float w = 0.0f, const float h = 0.0f)
+			: ds::ui::Sprite(e, w, h)
+			, mUpdates(0) {
+	}
+
+	int						mUpdates;
+	std::function<void()>	mOnUpdate;
+
+protected:
+	virtual void			onUpdateServer(const ds::UpdateParams&) override {
+		++mUpdates;
+		if (mOnUpdate) mOnUpdate();
+	}
+};
+
+void runFrames(ds::Engine& e, const int count) {
+	for (int i = 0; i < count; ++i) e.update();
+}
+
+/// One finger, already in world space
+ds::ui::TouchEvent touchAt(ds::Engine& e, const ci::vec2& pos) {
+	std::vector<ci::app::TouchEvent::Touch>	touches;
+	touches.push_back(ci::app::TouchEvent::Touch(pos, pos, 1, e.getElapsedTimeSeconds(), nullptr));
+	return ds::ui::TouchEvent(ci::app::getWindow(), touches, true);
+}
+
+void testListing(ds::Engine& e, ds::ui::Sprite& holder) {
+	const size_t	baseline = e.getUpdateListSize();
+	Counter*		quiet = new Counter(e);
+	Counter*		busy = new Counter(e);
+	busy->setNeedsUpdate(true);
+	holder.addChildPtr(quiet);
+	holder.addChildPtr(busy);
+
+	// Once settled, only the sprite that asked for updates is on the list
+	runFrames(e, 3);
+	quiet->mUpdates = 0;
+	busy->mUpdates = 0;
+	runFrames(e, 5);
+	BOOST_TEST_EQ(quiet->mUpdates, 0);
+	BOOST_TEST_EQ(busy->mUpdates, 5);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline + 1);
+
+	// A request is one more update, and so is any change
+	quiet->requestUpdate();
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline + 2);
+	runFrames(e, 3);
+	BOOST_TEST_EQ(quiet->mUpdates, 1);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline + 1);
+	quiet->setPosition(10.0f, 10.0f);
+	runFrames(e, 3);
+	BOOST_TEST_EQ(quiet->mUpdates, 2);
+
+	busy->setNeedsUpdate(false);
+	runFrames(e, 2);
+	busy->mUpdates = 0;
+	runFrames(e, 3);
+	BOOST_TEST_EQ(busy->mUpdates, 0);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline);
+
+	quiet->release();
+	busy->release();
+}
+
+void testRemoveDuringUpdate(ds::Engine& e, ds::ui::Sprite& holder) {
+	const size_t	baseline = e.getUpdateListSize();
+	// Listed sprites update in the order they were made, so the victim comes after the one removing it
+	Counter*		remover = new Counter(e);
+	Counter*		victim = new Counter(e);
+	Counter*		after = new Counter(e);
+	for (auto it : { remover, victim, after }) {
+		it->setNeedsUpdate(true);
+		holder.addChildPtr(it);
+	}
+	runFrames(e, 2);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline + 3);
+
+	const int		afterUpdates = after->mUpdates;
+	remover->mOnUpdate = [&victim]() {
+		if (!victim) return;
+		victim->release();
+		victim = nullptr;
+	};
+	runFrames(e, 1);
+	BOOST_TEST(!victim);
+	BOOST_TEST_EQ(after->mUpdates, afterUpdates + 1);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline + 2);
+	runFrames(e, 1);
+	BOOST_TEST_EQ(after->mUpdates, afterUpdates + 2);
+
+	remover->release();
+	after->release();
+	runFrames(e, 1);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline);
+}
+
+void testTouches(ds::Engine& e, ds::ui::Sprite& holder) {
+	Counter*		touched = new Counter(e, 100.0f, 100.0f);
+	touched->setPosition(100.0f, 100.0f);
+	touched->enable(true);
+	touched->enableMultiTouch(ds::ui::MULTITOUCH_INFO_ONLY);
+	holder.addChildPtr(touched);
+	runFrames(e, 3);
+	touched->mUpdates = 0;
+
+	// Stays on the list while it's held, even if the touch doesn't move
+	e.injectTouchesBegin(touchAt(e, ci::vec2(150.0f, 150.0f)));
+	runFrames(e, 5);
+	BOOST_TEST(touched->hasTouches());
+	BOOST_TEST(touched->mUpdates >= 4);
+
+	e.injectTouchesEnded(touchAt(e, ci::vec2(150.0f, 150.0f)));
+	runFrames(e, 3);
+	BOOST_TEST(!touched->hasTouches());
+	touched->mUpdates = 0;
+	runFrames(e, 3);
+	BOOST_TEST_EQ(touched->mUpdates, 0);
+
+	touched->release();
+}
+
+void testUnscheduled(ds::Engine& e, ds::ui::Sprite& holder) {
+	const size_t	baseline = e.getUpdateListSize();
+	Counter*		quiet = new Counter(e);
+	holder.addChildPtr(quiet);
+	runFrames(e, 3);
+	quiet->mUpdates = 0;
+	runFrames(e, 3);
+	BOOST_TEST_EQ(quiet->mUpdates, 0);
+
+	// Turning scheduling off goes back to visiting every sprite every frame
+	holder.setScheduledUpdates(false);
+	runFrames(e, 3);
+	BOOST_TEST_EQ(quiet->mUpdates, 3);
+	BOOST_TEST_EQ(e.getUpdateListSize(), baseline);
+
+	quiet->release();
+}
+
+}
+
+void testScheduledUpdates(ds::Engine& e) {
+	ds::ui::Sprite*		holder = new ds::ui::Sprite(e);
+	e.getRootSprite().addChildPtr(holder);
+	holder->setScheduledUpdates(true);
+
+	testListing(e, *holder);
+	testRemoveDuringUpdate(e, *holder);
+	testTouches(e, *holder);
+	testUnscheduled(e, *holder);
+
+	holder->release();
+}
+
+} // namespace unit_tests
@@ -0,0 +1,256 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+#include "tests/test_bytes.h"
+
+#include <climits>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ds/util/string_util.h>
+
+namespace unit_tests {
+
+namespace {
+
+typedef std::vector<std::string>	Strings;
+
+/// The implementations split, find_count, replace and tokenize had before they moved onto the string views.
+/// The views have to give back exactly what these did.
+Strings previous_split(const std::string& str, const std::string& delimiters, const bool dropEmpty) {
+	std::size_t				pos;
+	std::size_t				lastPos = 0;
+	Strings					splitWords;
+	while (true) {
+		pos = str.find(delimiters, lastPos);
+		if (pos == std::string::npos) {
+			pos = str.length();
+			if (pos != lastPos || !dropEmpty) splitWords.push_back(std::string(str.data() + lastPos, pos - lastPos));
+			break;
+		} else if (pos != lastPos || !dropEmpty) {
+			std::string		tstr = std::string(str.data() + lastPos, pos - lastPos);
+			if (!tstr.empty() || !dropEmpty) splitWords.push_back(tstr);
+			lastPos = pos + delimiters.size();
+			continue;
+		}
+		lastPos = pos + 1;
+	}
+	return splitWords;
+}
+
+int previous_find_count(const std::string& str, const std::string& token) {
+	std::size_t				lastPos = 0;
+	int						count = 0;
+	while (true) {
+		const std::size_t	pos = str.find_first_of(token, lastPos);
+		if (pos == std::string::npos) break;
+		++count;
+		lastPos = pos + 1;
+	}
+	return count;
+}
+
+std::string previous_replace(const std::string& tStr, const std::string& oldToken, const std::string& newToken) {
+	std::size_t				lastPos = 0;
+	std::string				str;
+	while (true) {
+		const std::size_t	pos = tStr.find(oldToken, lastPos);
+		if (pos == std::string::npos) {
+			if (tStr.length() != lastPos) str += std::string(tStr.data() + lastPos, tStr.length() - lastPos);
+			break;
+		}
+		str += std::string(tStr.data() + lastPos, pos - lastPos);
+		str += newToken;
+		lastPos = pos + oldToken.size();
+	}
+	return str;
+}
+
+Strings previous_tokenize(const std::string& input, const char delim) {
+	Strings					tokens;
+	std::istringstream		lineBuf(input);
+	while (lineBuf.good()) {
+		std::string			out;
+		getline(lineBuf, out, delim);
+		tokens.push_back(out);
+	}
+	return tokens;
+}
+
+Strings split_views(const std::string& str, const std::string& delimiter, const bool dropEmpty) {
+	Strings					pieces;
+	ds::split_each(str, delimiter, dropEmpty, [&pieces](const boost::string_ref& piece) {
+		pieces.push_back(piece.to_string());
+		return true;
+	});
+	return pieces;
+}
+
+Strings tokenize_strings(const std::string& input, const char delim) {
+	Strings					tokens;
+	ds::tokenize(input, delim, [&tokens](const std::string& token) { tokens.push_back(token); });
+	return tokens;
+}
+
+/// A short string made of the characters in alphabet, so delimiters and numbers turn up often
+std::string random_string(SeededRandom& random, const std::string& alphabet, const size_t maxLength) {
+	std::string				s(random.next() % (maxLength + 1), ' ');
+	for (auto& c : s) c = alphabet[random.next() % alphabet.size()];
+	return s;
+}
+
+void testSplit() {
+	// An empty delimiter used to loop forever. Now it gives back the whole string
+	BOOST_TEST(ds::split("a,b", "") == Strings({ "a,b" }));
+	BOOST_TEST(ds::split("", "") == Strings({ "" }));
+	BOOST_TEST(ds::split("", "", true).empty());
+	BOOST_TEST(split_views("a,b", "", false) == Strings({ "a,b" }));
+
+	BOOST_TEST(ds::split("a::b::::c", "::") == Strings({ "a", "b", "", "c" }));
+	BOOST_TEST(ds::split("::a::", "::") == Strings({ "", "a", "" }));
+	BOOST_TEST(ds::split("::a::", "::", true) == Strings({ ":a" }));
+	// When dropping empties, a delimiter at the start of a piece only skips one character, as it always has
+	BOOST_TEST(ds::split("a::b::::c", "::", true) == Strings({ "a", "b", ":c" }));
+	BOOST_TEST(ds::split("a, b, c", ", ") == Strings({ "a", "b", "c" }));
+	BOOST_TEST(ds::split("a,,b", ",", true) == Strings({ "a", "b" }));
+
+	// Fixed capacity output stops at the capacity and points into the original
+	const std::string		str = "1, 2, 3, 4";
+	boost::string_ref		pieces[3];
+	BOOST_TEST_EQ(ds::split_into(str, ", ", pieces, 3), 3u);
+	BOOST_TEST_EQ(pieces[2], "3");
+	BOOST_TEST(pieces[0].data() == str.data());
+	BOOST_TEST_EQ(ds::split_into(str, ", ", pieces, 0), 0u);
+
+	// The callback can stop early
+	int						calls = 0;
+	ds::split_each(str, ", ", false, [&calls](const boost::string_ref&) { return ++calls < 2; });
+	BOOST_TEST_EQ(calls, 2);
+}
+
+void testNumbers() {
+	int						i = 7;
+	float					f = 7.0f;
+	double					d = 7.0;
+
+	// Leading whitespace is skipped, trailing anything is a failure that leaves the value alone
+	BOOST_TEST(ds::parse_int(" \t42", i));
+	BOOST_TEST_EQ(i, 42);
+	BOOST_TEST(!ds::parse_int("42 ", i));
+	BOOST_TEST(!ds::parse_int("42abc", i));
+	BOOST_TEST(!ds::parse_int("", i));
+	BOOST_TEST(!ds::parse_int("-", i));
+	BOOST_TEST(!ds::parse_int("1e3", i));
+	BOOST_TEST(!ds::parse_int("4.0", i));
+	BOOST_TEST_EQ(i, 42);
+	BOOST_TEST(ds::parse_int("-2147483648", i));
+	BOOST_TEST_EQ(i, INT_MIN);
+
+	// Overflow fails
+	BOOST_TEST(!ds::parse_int("2147483648", i));
+	BOOST_TEST(!ds::parse_int("99999999999999999999999", i));
+	BOOST_TEST(!ds::parse_float("1e39", f));
+	BOOST_TEST(!ds::parse_float("-1e39", f));
+	BOOST_TEST(!ds::parse_double("1e309", d));
+	BOOST_TEST_EQ(f, 7.0f);
+	BOOST_TEST_EQ(d, 7.0);
+
+	// Underflow gives (nearly) zero
+	BOOST_TEST(ds::parse_float("1e-50", f));
+	BOOST_TEST(std::abs(f) < 1e-37f);
+	BOOST_TEST(ds::parse_double("-1e-400", d));
+	BOOST_TEST(std::abs(d) < 1e-300);
+
+	BOOST_TEST(ds::parse_double("1.5e3", d));
+	BOOST_TEST_EQ(d, 1500.0);
+	BOOST_TEST(ds::parse_double("2E+2", d));
+	BOOST_TEST_EQ(d, 200.0);
+	BOOST_TEST(ds::parse_float(".5", f));
+	BOOST_TEST_EQ(f, 0.5f);
+	BOOST_TEST(!ds::parse_double("1e", d));
+	BOOST_TEST(!ds::parse_double("1e+", d));
+	BOOST_TEST(!ds::parse_double(".", d));
+	BOOST_TEST(!ds::parse_double("0x10", d));
+	BOOST_TEST(!ds::parse_double("inf", d));
+
+	BOOST_TEST_EQ(ds::string_to_int("12"), 12);
+	BOOST_TEST_EQ(ds::string_to_int("12px"), 0);
+	BOOST_TEST_EQ(ds::string_to_float(" 0.25"), 0.25f);
+	BOOST_TEST(ds::parseVector("400, 300, 2") == ci::vec3(400.0f, 300.0f, 2.0f));
+	BOOST_TEST(ds::parseVector("400") == ci::vec3(400.0f, 0.0f, 0.0f));
+	BOOST_TEST(ds::parseRect("1, 2, 30, 40") == ci::Rectf(1.0f, 2.0f, 31.0f, 42.0f));
+}
+
+void testReplace() {
+	// At each spot the first listed token that matches wins, whatever its length
+	BOOST_TEST_EQ(ds::replace_all("aab", { { "ab", "X" }, { "a", "Y" } }), "YX");
+	BOOST_TEST_EQ(ds::replace_all("aab", { { "a", "Y" }, { "ab", "X" } }), "YYb");
+	// Replacements aren't searched again, and empty tokens are ignored
+	BOOST_TEST_EQ(ds::replace_all("aa", { { "a", "aa" } }), "aaaa");
+	BOOST_TEST_EQ(ds::replace_all("abc", { { "", "X" }, { "b", "" } }), "ac");
+	BOOST_TEST_EQ(ds::replace_all("", { { "a", "b" } }), "");
+	BOOST_TEST_EQ(ds::replace_all("&lt;b&gt;", { { "&lt;", "<" }, { "&gt;", ">" } }), "<b>");
+
+	std::string				s = "a.b.c";
+	ds::replace(s, "", "X");
+	BOOST_TEST_EQ(s, "a.b.c");
+	ds::replace(s, ".", "::");
+	BOOST_TEST_EQ(s, "a::b::c");
+}
+
+/// Random strings through the old and new versions of every rewritten function. Seeded, so a failure
+/// happens the same way every run.
+void testEquivalence() {
+	SeededRandom			random(4242);
+	const char*				delimiters[] = { ",", ", ", "::", "a", "ab", "aa", "\n" };
+	const char*				sets[] = { "", ",", ", ", "ab:", "\n" };
+
+	for (int n = 0; n < 20000; ++n) {
+		const std::string	str = random_string(random, "ab,: \n", 16);
+		const std::string	delimiter = delimiters[random.next() % (sizeof(delimiters) / sizeof(delimiters[0]))];
+		for (const bool dropEmpty : { false, true }) {
+			BOOST_TEST(ds::split(str, delimiter, dropEmpty) == previous_split(str, delimiter, dropEmpty));
+			BOOST_TEST(split_views(str, delimiter, dropEmpty) == previous_split(str, delimiter, dropEmpty));
+		}
+
+		const std::string	set = sets[random.next() % (sizeof(sets) / sizeof(sets[0]))];
+		BOOST_TEST_EQ(ds::find_count(str, set), previous_find_count(str, set));
+		BOOST_TEST_EQ(ds::count_any_of(str, set), static_cast<size_t>(previous_find_count(str, set)));
+
+		std::string			replaced = str;
+		ds::replace(replaced, delimiter, "<>");
+		BOOST_TEST_EQ(replaced, previous_replace(str, delimiter, "<>"));
+		BOOST_TEST_EQ(ds::replace_all(str, { { delimiter, "<>" } }), replaced);
+
+		BOOST_TEST(tokenize_strings(str, '\n') == previous_tokenize(str, '\n'));
+		BOOST_TEST(tokenize_strings(str, ',') == previous_tokenize(str, ','));
+	}
+
+	// Numbers against the stream parsing string_to_value() does
+	for (int n = 0; n < 20000; ++n) {
+		std::string			str = random_string(random, " +-0123456789.eE", 10);
+		if (n % 10 == 0) str += std::string(random.next() % 40, '9');
+
+		int					i = 0, previousI = 0;
+		float				f = 0.0f, previousF = 0.0f;
+		double				d = 0.0, previousD = 0.0;
+		BOOST_TEST_EQ(ds::parse_int(str, i), ds::string_to_value(str, previousI));
+		BOOST_TEST_EQ(i, previousI);
+		BOOST_TEST_EQ(ds::parse_float(str, f), ds::string_to_value(str, previousF));
+		BOOST_TEST(f == previousF || std::abs(f - previousF) <= std::abs(previousF) * 1e-6f);
+		BOOST_TEST_EQ(ds::parse_double(str, d), ds::string_to_value(str, previousD));
+		BOOST_TEST(d == previousD || std::abs(d - previousD) <= std::abs(previousD) * 1e-12);
+	}
+}
+
+}
+
+void testStringUtil() {
+	testSplit();
+	testNumbers();
+	testReplace();
+	testEquivalence();
+}
+
+} // namespace unit_tests
@@ -0,0 +1,255 @@
+#include "stdafx.h"
+
+#include "tests/unit_tests.h"
+#include "tests/test_bytes.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cinder/TriMesh.h>
+#include <ds/ui/drawing/stroke_tessellator.h>
+
+namespace unit_tests {
+
+namespace {
+
+typedef ds::ui::StrokeTessellator	Tessellator;
+typedef ds::ui::StrokeSample		Sample;
+typedef std::vector<ci::vec2>		Stamps;
+
+bool same_point(const ci::vec2& a, const ci::vec2& b, const float tolerance = 1e-3f) {
+	return glm::distance(a, b) <= tolerance;
+}
+
+/// Feeds a whole stroke through the tessellator
+Stamps draw(Tessellator& tessellator, const int strokeId, const std::vector<ci::vec2>& points) {
+	Stamps					stamps;
+	for (size_t i = 0; i < points.size(); ++i) {
+		int					flags = Sample::kNone;
+		if (i == 0) flags |= Sample::kBegin;
+		if (i + 1 == points.size()) flags |= Sample::kEnd;
+		tessellator.addSample(Sample(strokeId, points[i], flags), stamps);
+	}
+	return stamps;
+}
+
+/// Every stamp after the first is one spacing along from the one before, give or take the corners the curve cuts
+bool evenly_spaced(const Stamps& stamps, const float spacing, const float tolerance) {
+	for (size_t i = 2; i < stamps.size(); ++i) {
+		if (std::abs(glm::distance(stamps[i - 1], stamps[i]) - spacing) > tolerance) return false;
+	}
+	return true;
+}
+
+void testLines() {
+	Tessellator				tessellator;
+	BOOST_TEST_EQ(tessellator.getBrushSize(), 24.0f);
+	BOOST_TEST_EQ(tessellator.getSpacing(), 0.125f);
+
+	// 24 * 0.125 is a stamp every 3 pixels, starting with one at the start
+	Stamps					stamps;
+	tessellator.addLine(ci::vec2(0.0f, 0.0f), ci::vec2(30.0f, 0.0f), stamps);
+	BOOST_TEST_EQ(stamps.size(), 11u);
+	BOOST_TEST(evenly_spaced(stamps, 3.0f, 1e-3f));
+	BOOST_TEST(same_point(stamps.back(), ci::vec2(30.0f, 0.0f)));
+
+	stamps.clear();
+	tessellator.addLine(ci::vec2(5.0f, 5.0f), ci::vec2(5.0f, 5.0f), stamps);
+	BOOST_TEST_EQ(stamps.size(), 1u);
+
+	// Spacing follows the brush size, and never gets under a pixel
+	tessellator.setBrushSize(80.0f);
+	stamps.clear();
+	tessellator.addLine(ci::vec2(0.0f, 0.0f), ci::vec2(0.0f, 100.0f), stamps);
+	BOOST_TEST_EQ(stamps.size(), 11u);
+
+	tessellator.setBrushSize(2.0f);
+	tessellator.setSpacing(0.0f);
+	BOOST_TEST_EQ(tessellator.getSpacing(), 0.01f);
+	stamps.clear();
+	tessellator.addLine(ci::vec2(0.0f, 0.0f), ci::vec2(10.0f, 0.0f), stamps);
+	BOOST_TEST_EQ(stamps.size(), 11u);
+}
+
+void testStrokes() {
+	Tessellator				tessellator;
+
+	// A tap is one dot
+	Stamps					stamps;
+	tessellator.addSample(Sample(1, ci::vec2(7.0f, 8.0f), Sample::kBegin | Sample::kEnd), stamps);
+	BOOST_TEST_EQ(stamps.size(), 1u);
+	BOOST_TEST(same_point(stamps[0], ci::vec2(7.0f, 8.0f)));
+	BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 0u);
+
+	// Samples on a line stay on it, evenly spaced, with the first dot at the start
+	const std::vector<ci::vec2>	line = { { 0.0f, 0.0f }, { 10.0f, 0.0f }, { 20.0f, 0.0f }, { 30.0f, 0.0f }, { 40.0f, 0.0f } };
+	stamps = draw(tessellator, 1, line);
+	BOOST_TEST_EQ(stamps.size(), 14u);
+	BOOST_TEST(evenly_spaced(stamps, 3.0f, 1e-2f));
+	bool					onLine = true;
+	for (auto& stamp : stamps) onLine = onLine && std::abs(stamp.y) < 1e-3f && stamp.x >= 0.0f && stamp.x <= 40.0f;
+	BOOST_TEST(onLine);
+
+	// Drawing runs a sample behind: the segment to the newest sample waits for the one after it
+	stamps.clear();
+	tessellator.addSample(Sample(2, line[0], Sample::kBegin), stamps);
+	tessellator.addSample(Sample(2, line[1], Sample::kNone), stamps);
+	BOOST_TEST_EQ(stamps.size(), 1u);
+	tessellator.addSample(Sample(2, line[2], Sample::kNone), stamps);
+	BOOST_TEST_EQ(stamps.size(), 4u);
+	BOOST_TEST(stamps.back().x <= 10.0f);
+	BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 1u);
+
+	// Samples that barely moved are skipped
+	const size_t			before = stamps.size();
+	tessellator.addSample(Sample(2, line[2] + ci::vec2(0.2f, 0.0f), Sample::kNone), stamps);
+	BOOST_TEST_EQ(stamps.size(), before);
+
+	tessellator.clear();
+	BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 0u);
+
+	// Around a circle the curve stays on the circle and the stamps stay evenly spaced
+	std::vector<ci::vec2>	circle;
+	for (int degrees = 0; degrees <= 350; degrees += 10) {
+		const float			radians = static_cast<float>(degrees) * 3.14159265f / 180.0f;
+		circle.push_back(ci::vec2(200.0f + 100.0f * cosf(radians), 200.0f + 100.0f * sinf(radians)));
+	}
+	stamps = draw(tessellator, 3, circle);
+	BOOST_TEST(stamps.size() > 150u);
+	bool					onCircle = true;
+	for (auto& stamp : stamps) onCircle = onCircle && std::abs(glm::distance(stamp, ci::vec2(200.0f, 200.0f)) - 100.0f) < 1.0f;
+	BOOST_TEST(onCircle);
+	BOOST_TEST(evenly_spaced(stamps, 3.0f, 0.05f));
+
+	// Strokes drawn at the same time come out the same as each drawn alone
+	std::vector<ci::vec2>	wave;
+	for (int i = 0; i < 30; ++i) wave.push_back(ci::vec2(static_cast<float>(i) * 12.0f, 40.0f * sinf(static_cast<float>(i) * 0.4f)));
+	const Stamps			alone = draw(tessellator, 4, wave);
+
+	Stamps					first, second;
+	for (size_t i = 0; i < wave.size(); ++i) {
+		int					flags = Sample::kNone;
+		if (i == 0) flags |= Sample::kBegin;
+		if (i + 1 == wave.size()) flags |= Sample::kEnd;
+		tessellator.addSample(Sample(5, wave[i], flags), first);
+		tessellator.addSample(Sample(6, wave[i] + ci::vec2(0.0f, 500.0f), flags), second);
+		if (i > 0 && i + 1 < wave.size()) BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 2u);
+	}
+	BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 0u);
+	BOOST_TEST_EQ(first.size(), alone.size());
+	BOOST_TEST_EQ(second.size(), alone.size());
+	bool					same = first.size() == alone.size() && second.size() == alone.size();
+	for (size_t i = 0; same && i < alone.size(); ++i) {
+		same = same_point(first[i], alone[i]) && same_point(second[i], alone[i] + ci::vec2(0.0f, 500.0f), 1e-2f);
+	}
+	BOOST_TEST(same);
+
+	// A sample for a stroke that never began starts one
+	stamps.clear();
+	tessellator.addSample(Sample(7, ci::vec2(1.0f, 1.0f), Sample::kNone), stamps);
+	BOOST_TEST_EQ(stamps.size(), 1u);
+	BOOST_TEST_EQ(tessellator.getActiveStrokeCount(), 1u);
+}
+
+void testMeshes() {
+	const Stamps			stamps = { { 0.0f, 0.0f }, { 100.0f, 50.0f }, { -20.0f, 10.0f } };
+
+	ci::TriMesh				quads(ci::TriMesh::Format().positions(2).texCoords0(2));
+	Tessellator::buildQuadMesh(stamps, ci::vec2(10.0f, 20.0f), quads);
+	BOOST_TEST_EQ(quads.getNumVertices(), 12u);
+	BOOST_TEST_EQ(quads.getNumTriangles(), 6u);
+	const ci::vec2*			positions = quads.getPositions<2>();
+	BOOST_TEST(same_point(positions[4], ci::vec2(95.0f, 40.0f)));
+	BOOST_TEST(same_point(positions[6], ci::vec2(105.0f, 60.0f)));
+
+	// Appending to a mesh carries on from its vertices, so one mesh can hold every stroke of a frame
+	Tessellator::buildQuadMesh(stamps, ci::vec2(10.0f, 20.0f), quads);
+	BOOST_TEST_EQ(quads.getNumVertices(), 24u);
+	BOOST_TEST_EQ(quads.getIndices()[18], 12u);
+	BOOST_TEST_EQ(quads.getIndices().back(), 23u);
+
+	ci::TriMesh				circles(ci::TriMesh::Format().positions(2));
+	Tessellator::buildCircleMesh(stamps, 5.0f, 8, circles);
+	BOOST_TEST_EQ(circles.getNumVertices(), 27u);
+	BOOST_TEST_EQ(circles.getNumTriangles(), 24u);
+	positions = circles.getPositions<2>();
+	bool					onRadius = true;
+	for (int i = 1; i <= 8; ++i) onRadius = onRadius && std::abs(glm::distance(positions[9], positions[9 + i]) - 5.0f) < 1e-3f;
+	BOOST_TEST(onRadius);
+
+	// Fewer than 3 segments isn't a circle
+	ci::TriMesh				triangles(ci::TriMesh::Format().positions(2));
+	Tessellator::buildCircleMesh(stamps, 5.0f, 1, triangles);
+	BOOST_TEST_EQ(triangles.getNumTriangles(), 9u);
+}
+
+void testCodec() {
+	std::string				bytes;
+	std::vector<Sample>		decoded;
+	ds::ui::StrokeCodec::encode(std::vector<Sample>(), bytes);
+	BOOST_TEST(ds::ui::StrokeCodec::decode(bytes, decoded));
+	BOOST_TEST(decoded.empty());
+
+	// One stroke of small moves: the first sample is absolute with its id, the rest are 5 byte deltas
+	std::vector<Sample>		stroke;
+	for (int i = 0; i < 100; ++i) stroke.push_back(Sample(42, ci::vec2(100.0f + i * 2.5f, 300.0f - i * 1.25f), i == 0 ? Sample::kBegin : Sample::kNone));
+	stroke.back().mFlags = Sample::kEnd;
+	ds::ui::StrokeCodec::encode(stroke, bytes);
+	BOOST_TEST_EQ(bytes.size(), 4u + 13u + 99u * 5u);
+	BOOST_TEST(ds::ui::StrokeCodec::decode(bytes, decoded));
+	BOOST_TEST_EQ(decoded.size(), stroke.size());
+	bool					same = decoded.size() == stroke.size();
+	for (size_t i = 0; same && i < stroke.size(); ++i) {
+		same = decoded[i].mStrokeId == 42 && decoded[i].mFlags == stroke[i].mFlags && same_point(decoded[i].mPoint, stroke[i].mPoint);
+	}
+	BOOST_TEST(same);
+
+	// Cut short anywhere, decoding fails but keeps what came before
+	bool					failed = true;
+	for (size_t length = 0; length < bytes.size(); ++length) {
+		decoded.clear();
+		failed = failed && !ds::ui::StrokeCodec::decode(bytes.substr(0, length), decoded) && decoded.size() < stroke.size();
+	}
+	BOOST_TEST(failed);
+
+	// A delta for a stroke the packet never introduced
+	std::string				orphan("\x01\x00\x00\x00\x03\x01\x00\x01\x00", 9);
+	decoded.clear();
+	BOOST_TEST(!ds::ui::StrokeCodec::decode(orphan, decoded));
+
+	// More strokes than slots, big jumps and negative points, quantized to a quarter pixel
+	SeededRandom			random(3030);
+	std::vector<Sample>		samples;
+	std::vector<ci::vec2>	last(40, ci::vec2(0.0f, 0.0f));
+	for (int i = 0; i < 5000; ++i) {
+		const int			id = static_cast<int>(random.next() % 40) - 5;
+		ci::vec2&			point = last[id + 5];
+		if (random.next() % 20 == 0) {
+			point = ci::vec2(static_cast<float>(random.next() % 40000) - 20000.0f, static_cast<float>(random.next() % 40000) - 20000.0f);
+		} else {
+			point += ci::vec2(static_cast<float>(random.next() % 400) / 4.0f - 50.0f, static_cast<float>(random.next() % 400) / 4.0f - 50.0f);
+		}
+		samples.push_back(Sample(id, point, static_cast<int>(random.next() % 4)));
+	}
+	ds::ui::StrokeCodec::encode(samples, bytes);
+	decoded.clear();
+	BOOST_TEST(ds::ui::StrokeCodec::decode(bytes, decoded));
+	BOOST_TEST_EQ(decoded.size(), samples.size());
+	same = decoded.size() == samples.size();
+	for (size_t i = 0; same && i < samples.size(); ++i) {
+		same = decoded[i].mStrokeId == samples[i].mStrokeId && decoded[i].mFlags == samples[i].mFlags && same_point(decoded[i].mPoint, samples[i].mPoint);
+	}
+	BOOST_TEST(same);
+	BOOST_TEST(bytes.size() < samples.size() * 16u);
+}
+
+}
+
+void testStrokeTessellator() {
+	testLines();
+	testStrokes();
+	testMeshes();
+	testCodec();
+}
+
+} // namespace unit_tests
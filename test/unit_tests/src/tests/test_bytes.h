@@ -0,0 +1,151 @@
+#ifndef _UNIT_TESTS_TESTS_TEST_BYTES_H_
+#define _UNIT_TESTS_TESTS_TEST_BYTES_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace unit_tests {
+
+/// Helpers for the suites that build binary files in memory and then break them
+typedef std::vector<unsigned char>	Bytes;
+
+inline void put(Bytes& b, const std::string& s) {
+	b.insert(b.end(), s.begin(), s.end());
+}
+
+inline void put(Bytes& b, const Bytes& more) {
+	b.insert(b.end(), more.begin(), more.end());
+}
+
+inline void put_16(Bytes& b, const unsigned v, const bool littleEndian) {
+	if (littleEndian) b.insert(b.end(), { static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8) });
+	else b.insert(b.end(), { static_cast<unsigned char>(v >> 8), static_cast<unsigned char>(v) });
+}
+
+inline void put_32(Bytes& b, const uint32_t v, const bool littleEndian) {
+	if (littleEndian) {
+		put_16(b, v & 0xFFFF, true);
+		put_16(b, v >> 16, true);
+	} else {
+		put_16(b, v >> 16, false);
+		put_16(b, v & 0xFFFF, false);
+	}
+}
+
+/// The same numbers every run, so a fuzzed failure happens the same way again
+class SeededRandom {
+public:
+	explicit SeededRandom(const uint32_t seed)
+			: mSeed(seed) {
+	}
+
+	uint32_t				next() {
+		mSeed = mSeed * 1664525u + 1013904223u;
+		return mSeed >> 8;
+	}
+
+private:
+	uint32_t				mSeed;
+};
+
+/// Writes TIFF headers and IFDs in either byte order
+class TiffWriter {
+public:
+	static const uint16_t	ASCII = 2;
+	static const uint16_t	SHORT = 3;
+	static const uint16_t	LONG = 4;
+	static const uint16_t	RATIONAL = 5;
+
+	struct Field {
+		uint16_t			mTag;
+		uint16_t			mType;
+		uint32_t			mCount;
+		Bytes				mValue;
+	};
+
+	explicit TiffWriter(const bool littleEndian)
+			: mLittleEndian(littleEndian) {
+	}
+
+	Bytes					u16(const unsigned v) const {
+		Bytes				b;
+		put_16(b, v, mLittleEndian);
+		return b;
+	}
+
+	Bytes					u32(const uint32_t v) const {
+		Bytes				b;
+		put_32(b, v, mLittleEndian);
+		return b;
+	}
+
+	Field					ascii(const uint16_t tag, const std::string& s) const {
+		return { tag, ASCII, static_cast<uint32_t>(s.size() + 1), Bytes(s.c_str(), s.c_str() + s.size() + 1) };
+	}
+
+	Field					shortField(const uint16_t tag, const unsigned v) const {
+		return { tag, SHORT, 1, u16(v) };
+	}
+
+	Field					longField(const uint16_t tag, const uint32_t v) const {
+		return { tag, LONG, 1, u32(v) };
+	}
+
+	Field					rationals(const uint16_t tag, const std::vector<std::pair<uint32_t, uint32_t>>& values) const {
+		Field				f = { tag, RATIONAL, static_cast<uint32_t>(values.size()), Bytes() };
+		for (auto& v : values) {
+			put_32(f.mValue, v.first, mLittleEndian);
+			put_32(f.mValue, v.second, mLittleEndian);
+		}
+		return f;
+	}
+
+	/// The byte order mark, 42, and the first IFD right after at offset 8
+	void					writeHeader(Bytes& out) const {
+		put(out, mLittleEndian ? "II" : "MM");
+		put_16(out, 42, mLittleEndian);
+		put_32(out, 8, mLittleEndian);
+	}
+
+	/// Bytes an IFD and the values that don't fit in it take up
+	static size_t			ifdSize(const std::vector<Field>& fields) {
+		size_t				size = 2 + fields.size() * 12 + 4;
+		for (auto& f : fields) {
+			if (f.mValue.size() > 4) size += (f.mValue.size() + 1) & ~size_t(1);
+		}
+		return size;
+	}
+
+	/// Appends an IFD that starts at out.size(), with its big values right after it
+	void					writeIfd(Bytes& out, const std::vector<Field>& fields) const {
+		const size_t		start = out.size();
+		size_t				data = start + 2 + fields.size() * 12 + 4;
+		Bytes				values;
+		put_16(out, static_cast<unsigned>(fields.size()), mLittleEndian);
+		for (auto& f : fields) {
+			put_16(out, f.mTag, mLittleEndian);
+			put_16(out, f.mType, mLittleEndian);
+			put_32(out, f.mCount, mLittleEndian);
+			if (f.mValue.size() <= 4) {
+				Bytes		inline_value = f.mValue;
+				inline_value.resize(4, 0);
+				put(out, inline_value);
+			} else {
+				put_32(out, static_cast<uint32_t>(data + values.size()), mLittleEndian);
+				put(values, f.mValue);
+				if (values.size() % 2) values.push_back(0);
+			}
+		}
+		put_32(out, 0, mLittleEndian);
+		put(out, values);
+	}
+
+private:
+	bool					mLittleEndian;
+};
+
+} // namespace unit_tests
+
+#endif // !_UNIT_TESTS_TESTS_TEST_BYTES_H_
@@ -0,0 +1,35 @@
+#ifndef _UNIT_TESTS_TESTS_UNIT_TESTS_H_
+#define _UNIT_TESTS_TESTS_UNIT_TESTS_H_
+
+namespace ds {
+class Engine;
+namespace ui {
+class SpriteEngine;
+}
+}
+
+namespace unit_tests {
+
+/// Each suite checks with BOOST_TEST and friends; the app reports the total once they've all run.
+void			testKeyValueStore();
+void			testMarkdown();
+/// Splitting, tokenizing, number parsing and replacing, checked against the implementations they replaced
+void			testStringUtil();
+/// In-memory headers for every format, then the same cut short and fuzzed
+void			testImageProbe();
+/// TIFF, jpeg and bare EXIF blocks written in both byte orders, then broken
+void			testExifParser();
+/// Stamp spacing and smoothing, the meshes, and the sample codec round tripped through thousands of random samples
+void			testStrokeTessellator();
+/// Drives the engine's server AutoUpdateList directly
+void			testAutoUpdateList(ds::ui::SpriteEngine&);
+/// Runs whole engine frames, so these add sprites to the root and take them away again
+void			testScheduledUpdates(ds::Engine&);
+/// Golden positions and sizes, plus when nested layouts run or are skipped
+void			testLayouts(ds::Engine&);
+/// Loads data/layouts/model_binding.xml
+void			testSmartLayout(ds::ui::SpriteEngine&);
+
+} // namespace unit_tests
+
+#endif // !_UNIT_TESTS_TESTS_UNIT_TESTS_H_
@@ -0,0 +1,52 @@
+#include "stdafx.h"
+
+#include "video_tests_app.h"
+
+#include <ds/app/engine/engine.h>
+#include <ds/debug/logger.h>
+
+#include <cinder/app/RendererGl.h>
+
+#include <gst/gst.h>
+#include <gstreamer/gstreamer_env_check.h>
+
+#include "tests/video_tests.h"
+
+namespace downstream {
+
+video_tests_app::video_tests_app()
+	: ds::App()
+	, mRan(false)
+	, mFrames(mEngine.getAppSettings().getInt("video_tests:frames", 0, 240))
+{
+}
+
+void video_tests_app::update(){
+	ds::App::update();
+	if(mRan) return;
+	mRan = true;
+
+	// The video service only starts GStreamer when a GstVideo is linked in, which nothing here needs.
+	// This is how it starts it, and doing it twice is harmless.
+#ifdef _WIN32
+	ds::gstreamer::EnvCheck::addGStreamerBinPath();
+#endif
+	GError* error = nullptr;
+	if(gst_init_check(nullptr, nullptr, &error)){
+		video_tests::testFrameBuffer();
+		video_tests::testVideoTestSrc(mFrames);
+	} else {
+		BOOST_ERROR("GStreamer didn't initialize");
+		if(error) DS_LOG_WARNING("Video tests: " << error->message);
+	}
+
+	// Prints "No errors detected." or the number of failures, which ctest checks for
+	const int failures = boost::report_errors();
+	if(failures > 0) DS_LOG_WARNING("Video tests: " << failures << " failed");
+	quit();
+}
+
+} // namespace downstream
+
+// This line tells Cinder to actually create the application
+CINDER_APP(downstream::video_tests_app, ci::app::RendererGl(ci::app::RendererGl::Options()))
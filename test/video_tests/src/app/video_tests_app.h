@@ -0,0 +1,28 @@
+#ifndef _VIDEO_TESTS_APP_H_
+#define _VIDEO_TESTS_APP_H_
+
+#include <cinder/app/App.h>
+#include <ds/app/app.h>
+
+namespace downstream {
+
+/**
+ * \class video_tests_app
+ * Runs the video tests once the engine is up, prints the results and quits.
+ * Runs headless (see settings/engine.xml), and only needs GStreamer's own test source, not any video files.
+ */
+class video_tests_app : public ds::App {
+public:
+	video_tests_app();
+
+	virtual void		update() override;
+
+private:
+	/// The suites run on the first update, after the engine has finished setting up
+	bool				mRan;
+	const int			mFrames;
+};
+
+} // !namespace downstream
+
+#endif // !_VIDEO_TESTS_APP_H_
@@ -0,0 +1,173 @@
+#include "stdafx.h"
+
+#include "tests/video_tests.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <gstreamer/video_frame_buffer.h>
+
+namespace video_tests {
+
+namespace {
+
+typedef gstwrapper::VideoFrameBuffer	FrameBuffer;
+
+/// A sample whose buffer is size bytes of value
+GstSample* make_sample(const size_t size, const unsigned char value) {
+	GstBuffer*				buffer = gst_buffer_new_allocate(nullptr, size, nullptr);
+	gst_buffer_memset(buffer, 0, value, size);
+	GstSample*				sample = gst_sample_new(buffer, nullptr, nullptr, nullptr);
+	gst_buffer_unref(buffer);
+	return sample;
+}
+
+int refs(GstSample* sample) {
+	return GST_MINI_OBJECT_REFCOUNT_VALUE(sample);
+}
+
+/// The first byte of the front frame, or -1 if there isn't one
+int front_value(FrameBuffer& frames) {
+	size_t					size = 0;
+	const unsigned char*	data = frames.mapFront(size);
+	return (data && size > 0) ? data[0] : -1;
+}
+
+void testHandoff() {
+	const size_t			size = 64;
+	GstSample*				samples[5];
+	for (int i = 0; i < 5; ++i) samples[i] = make_sample(size, static_cast<unsigned char>(i));
+
+	{
+		FrameBuffer			frames;
+		size_t				mapped = 7;
+		BOOST_TEST(!frames.hasNewFrame());
+		BOOST_TEST(!frames.acquire());
+		BOOST_TEST(frames.mapFront(mapped) == nullptr);
+		BOOST_TEST_EQ(mapped, 0u);
+		BOOST_TEST(frames.getFrontSample() == nullptr);
+
+		frames.publish(nullptr, false);
+		BOOST_TEST(!frames.hasNewFrame());
+
+		// A published frame is held, not copied
+		frames.publish(samples[0], false);
+		BOOST_TEST(frames.hasNewFrame());
+		BOOST_TEST_EQ(refs(samples[0]), 2);
+		BOOST_TEST(frames.acquire());
+		BOOST_TEST(!frames.hasNewFrame());
+		BOOST_TEST(frames.getFrontSample() == samples[0]);
+		BOOST_TEST(frames.mapFront(mapped) != nullptr);
+		BOOST_TEST_EQ(mapped, size);
+		BOOST_TEST_EQ(front_value(frames), 0);
+
+		// Nothing new keeps the same front frame, still mapped
+		BOOST_TEST(!frames.acquire());
+		BOOST_TEST_EQ(front_value(frames), 0);
+
+		// Two frames before the reader gets to them: the first is dropped and let go right away
+		frames.publish(samples[1], false);
+		frames.publish(samples[2], false);
+		BOOST_TEST_EQ(refs(samples[1]), 1);
+		BOOST_TEST(frames.acquire());
+		BOOST_TEST_EQ(front_value(frames), 2);
+		BOOST_TEST_EQ(refs(samples[0]), 1);
+		BOOST_TEST_EQ(refs(samples[2]), 2);
+
+		frames.publish(samples[3], true);
+		frames.publish(samples[4], false);
+		FrameBuffer::Stats	stats = frames.getStats();
+		BOOST_TEST_EQ(stats.mReceived, 5u);
+		BOOST_TEST_EQ(stats.mDisplayed, 2u);
+		BOOST_TEST_EQ(stats.mDropped, 2u);
+		BOOST_TEST_EQ(stats.mLate, 1u);
+
+		// Never more than the front frame and the newest one
+		int					held = 0;
+		for (auto sample : samples) held += refs(sample) - 1;
+		BOOST_TEST_EQ(held, 2);
+
+		frames.clear();
+		BOOST_TEST(frames.getFrontSample() == nullptr);
+		BOOST_TEST(!frames.acquire());
+		for (auto sample : samples) BOOST_TEST_EQ(refs(sample), 1);
+
+		frames.resetStats();
+		stats = frames.getStats();
+		BOOST_TEST_EQ(stats.mReceived + stats.mDisplayed + stats.mDropped + stats.mLate, 0u);
+
+		// Still works after a clear, and lets go of everything when it's destroyed
+		frames.publish(samples[0], false);
+		BOOST_TEST(frames.acquire());
+		frames.publish(samples[1], false);
+		BOOST_TEST_EQ(front_value(frames), 0);
+	}
+	for (auto sample : samples) {
+		BOOST_TEST_EQ(refs(sample), 1);
+		gst_sample_unref(sample);
+	}
+}
+
+/// A writer publishing fresh frames as fast as it can against a reader that maps every frame it gets. Each frame
+/// starts with its number and is filled with the low byte of it, so a frame freed or reused while the reader had
+/// it mapped shows up torn (or under a memory checker), and frames going backwards show up in the numbers.
+void testThreads() {
+	const size_t			size = 16 * 1024;
+	const uint32_t			published = 20000;
+
+	FrameBuffer				frames;
+	std::atomic<bool>		writing(true);
+	std::thread				writer([&frames, &writing, size, published]() {
+		for (uint32_t i = 0; i < published; ++i) {
+			GstSample*		sample = make_sample(size, static_cast<unsigned char>(i & 0xff));
+			gst_buffer_fill(gst_sample_get_buffer(sample), 0, &i, sizeof(i));
+			frames.publish(sample, false);
+			gst_sample_unref(sample);
+		}
+		writing = false;
+	});
+
+	int						torn = 0;
+	int						backwards = 0;
+	int64_t					last = -1;
+	uint64_t				read = 0;
+	while (writing || frames.hasNewFrame()) {
+		if (!frames.acquire()) {
+			std::this_thread::yield();
+			continue;
+		}
+		++read;
+
+		size_t				mapped = 0;
+		const unsigned char* data = frames.mapFront(mapped);
+		if (!data || mapped != size) {
+			++torn;
+			continue;
+		}
+		uint32_t			number = 0;
+		memcpy(&number, data, sizeof(number));
+		const unsigned char	fill = static_cast<unsigned char>(number & 0xff);
+		if (data[size / 2] != fill || data[size - 1] != fill) ++torn;
+		if (static_cast<int64_t>(number) <= last) ++backwards;
+		last = number;
+	}
+	writer.join();
+
+	const FrameBuffer::Stats	stats = frames.getStats();
+	BOOST_TEST_EQ(torn, 0);
+	BOOST_TEST_EQ(backwards, 0);
+	// The reader always ends up with the last frame
+	BOOST_TEST_EQ(last, static_cast<int64_t>(published) - 1);
+	BOOST_TEST_EQ(stats.mReceived, static_cast<uint64_t>(published));
+	BOOST_TEST_EQ(stats.mDisplayed, read);
+	BOOST_TEST_EQ(stats.mDisplayed + stats.mDropped, stats.mReceived);
+}
+
+}
+
+void testFrameBuffer() {
+	testHandoff();
+	testThreads();
+}
+
+} // namespace video_tests
@@ -0,0 +1,93 @@
+#include "stdafx.h"
+
+#include "tests/video_tests.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <gstreamer/gstreamer_wrapper.h>
+
+namespace video_tests {
+
+namespace {
+
+typedef gstwrapper::GStreamerWrapper	Wrapper;
+typedef std::chrono::steady_clock		Clock;
+
+const int					WIDTH = 320;
+const int					HEIGHT = 240;
+const int					FRAME_RATE = 120;
+/// videotestsrc's solid-color is ARGB, which comes out as these bytes in BGRA
+const unsigned char			BGRA[4] = { 0x99, 0x66, 0x33, 0xff };
+
+void report(const std::string& line) {
+	std::cout << "video_tests: " << line << std::endl;
+	DS_LOG_INFO("video_tests: " << line);
+}
+
+bool is_test_color(const unsigned char* pixel) {
+	return pixel[0] == BGRA[0] && pixel[1] == BGRA[1] && pixel[2] == BGRA[2] && pixel[3] == BGRA[3];
+}
+
+/// Plays videotestsrc until frames have reached the sink, reading a frame every readEveryMs (0 reads every one).
+void play(const std::string& name, const int frames, const int readEveryMs) {
+	std::stringstream		pipeline;
+	pipeline << "videotestsrc pattern=solid-color foreground-color=0xff336699"
+		<< " ! video/x-raw,format=BGRA,width=" << WIDTH << ",height=" << HEIGHT << ",framerate=" << FRAME_RATE << "/1"
+		<< " ! appsink name=appsink0";
+
+	Wrapper					wrapper;
+	BOOST_TEST(wrapper.parseLaunch(pipeline.str(), WIDTH, HEIGHT, Wrapper::kColorSpaceTransparent));
+	wrapper.play();
+
+	const auto				start = Clock::now();
+	const auto				timeout = start + std::chrono::seconds(10 + frames / FRAME_RATE);
+	auto					lastRead = start;
+	int						read = 0;
+	int						wrongPixels = 0;
+	while (wrapper.getFrameStats().mReceived < static_cast<uint64_t>(frames) && Clock::now() < timeout) {
+		wrapper.update();
+
+		const auto			now = Clock::now();
+		if (wrapper.isNewVideoFrame() && now - lastRead >= std::chrono::milliseconds(readEveryMs)) {
+			lastRead = now;
+			const unsigned char* pixels = wrapper.getVideo();
+			if (!pixels || !is_test_color(pixels) || !is_test_color(pixels + (WIDTH * HEIGHT - 1) * 4)) ++wrongPixels;
+			++read;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const double			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	const gstwrapper::VideoFrameStats	stats = wrapper.getFrameStats();
+	wrapper.stop();
+	wrapper.close();
+
+	BOOST_TEST(stats.mReceived >= static_cast<uint64_t>(frames));
+	BOOST_TEST(read > 0);
+	BOOST_TEST_EQ(wrongPixels, 0);
+	BOOST_TEST(stats.mDisplayed + stats.mDropped <= stats.mReceived);
+
+	if (readEveryMs > 0) {
+		// The reader is slower than the stream, so most frames have to be dropped rather than hold the stream up
+		BOOST_TEST(stats.mDropped > 0);
+		BOOST_TEST(stats.mDisplayed < stats.mReceived);
+	}
+
+	std::stringstream		ss;
+	ss << "videotestsrc, " << name << ": " << stats.mReceived << " frames in " << seconds << "s ("
+		<< static_cast<double>(stats.mReceived) / seconds << " fps), " << stats.mDisplayed << " displayed, "
+		<< stats.mDropped << " dropped, " << stats.mLate << " late";
+	report(ss.str());
+}
+
+}
+
+void testVideoTestSrc(const int frames) {
+	play("reading every frame", frames, 0);
+	// A tenth of the frame rate, like a render thread stuck behind something slow
+	play("reading every 80ms", frames, 80);
+}
+
+} // namespace video_tests
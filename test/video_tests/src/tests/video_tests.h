@@ -0,0 +1,16 @@
+#ifndef _VIDEO_TESTS_TESTS_VIDEO_TESTS_H_
+#define _VIDEO_TESTS_TESTS_VIDEO_TESTS_H_
+
+namespace video_tests {
+
+/// Suites check with BOOST_TEST and friends, and print measurements as "video_tests: ..." lines.
+/// None of them need a video file or a window: frames come from made up samples or videotestsrc.
+
+/// The triple buffer with samples made by hand: handoff, drops, lateness, references, and a writer and reader thread racing
+void			testFrameBuffer();
+/// videotestsrc through GStreamerWrapper::parseLaunch(), read every frame and then read slowly
+void			testVideoTestSrc(const int frames);
+
+} // namespace video_tests
+
+#endif // !_VIDEO_TESTS_TESTS_VIDEO_TESTS_H_